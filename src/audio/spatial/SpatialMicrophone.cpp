@@ -8,6 +8,8 @@
     <p>created 09.12.2014</p>
 */
 
+#include <algorithm>
+
 #include "SpatialMicrophone.h"
 #include "audio/tool/AudioBuffer.h"
 #include "audio/tool/Delay.h"
@@ -20,6 +22,15 @@ namespace AUDIO {
 SpatialMicrophone::SpatialMicrophone(AudioBuffer * b, uint sampleRate, uint channel)
     : p_signal_             (b),
       p_transform_          (b->blockSize()),
+      p_posX_               (b->blockSize()),
+      p_posY_               (b->blockSize()),
+      p_posZ_               (b->blockSize()),
+      p_dirX_               (b->blockSize()),
+      p_dirY_               (b->blockSize()),
+      p_dirZ_               (b->blockSize()),
+      p_dist_               (b->blockSize()),
+      p_gain_               (b->blockSize()),
+      p_delayPos_           (b->blockSize()),
       p_sampleRate_         (sampleRate),
       p_channel_            (channel),
       p_sampleRateInv_      (1.f / std::max(uint(1), sampleRate))
@@ -43,94 +54,133 @@ void SpatialMicrophone::spatialize(const QList<SpatialSoundSource*>& sources)
     // clear accumulation buffer
     p_signal_->writeNullBlock();
 
+    if (sources.isEmpty())
+        return;
+
+    // position and direction are the same for all sources
+    updateTrack_();
+
     // sample each sound source
     for (auto s : sources)
         spatialize_(s);
 }
 
+void SpatialMicrophone::updateTrack_()
+{
+    // matrix * Vec4(0,0,0,1)
+    p_transform_.getColumn(3, &p_posX_[0], &p_posY_[0], &p_posZ_[0]);
+
+    // get direction of microphone
+    // (suppose microphone originally points at <0,0,-1>)
+    p_transform_.getColumn(2, &p_dirX_[0], &p_dirY_[0], &p_dirZ_[0]);
+
+    // a constant block is only normalized once
+    const uint num = p_transform_.isConstant() ? 1 : bufferSize();
+
+    for (uint i=0; i<num; ++i)
+    {
+        // negate and normalize
+        const F32
+                mx = p_dirX_[i],
+                my = p_dirY_[i],
+                mz = p_dirZ_[i],
+                micDirMag = -std::sqrt(mx*mx + my*my + mz*mz);
+        p_dirX_[i] = mx / micDirMag;
+        p_dirY_[i] = my / micDirMag;
+        p_dirZ_[i] = mz / micDirMag;
+    }
+    if (num < bufferSize())
+    {
+        for (auto v : { &p_dirX_, &p_dirY_, &p_dirZ_ })
+            std::fill(v->begin() + 1, v->end(), (*v)[0]);
+    }
+}
+
 void SpatialMicrophone::spatialize_(SpatialSoundSource * snd)
 {
     MO_ASSERT(snd->bufferSize() == bufferSize(), "unmatched buffer size"
               << snd->bufferSize() << "/" << bufferSize());
 
     const F32 EPSILON = 1e-20,
-            dist_fac = 1.f / std::max(0.00001f, p_maxDist_ - p_minDist_);
+            dist_fac = 1.f / std::max(0.00001f, p_maxDist_ - p_minDist_),
+            sampleRate = p_sampleRate_;
+    const uint size = bufferSize();
+
+    const F32
+            * sx = snd->positionX(),
+            * sy = snd->positionY(),
+            * sz = snd->positionZ(),
+            * mx = &p_posX_[0],
+            * my = &p_posY_[0],
+            * mz = &p_posZ_[0],
+            * ux = &p_dirX_[0],
+            * uy = &p_dirY_[0],
+            * uz = &p_dirZ_[0];
+    F32 * dist = &p_dist_[0],
+        * gain = &p_gain_[0],
+        * delayPos = &p_delayPos_[0];
+
+    // -- distance, amplitude and delay for the whole block --
+    // (branch-free so the compiler can vectorize it)
+
+    for (uint i=0; i<size; ++i)
+    {
+        // direction towards sound
+        const F32
+                dx = sx[i] - mx[i],
+                dy = sy[i] - my[i],
+                dz = sz[i] - mz[i],
+        // distance to sound
+                d = std::sqrt(dx*dx + dy*dy + dz*dz),
+                dinv = 1.f / std::max(d, EPSILON),
+        // direction factor
+                micDot = 0.5f + 0.5f * (dx * dinv * ux[i]
+                                      + dy * dinv * uy[i]
+                                      + dz * dinv * uz[i]);
+
+        dist[i] = d;
+        gain[i] = micDot;
+        // delaytime from distance
+        delayPos[i] = F32(size - i) + d / 330.f * sampleRate;
+    }
+
+    // amplitude from direction and distance
+    for (uint i=0; i<size; ++i)
+        gain[i] = std::pow(gain[i], p_dirExp_)
+                    / (1.f + p_distFade_ * dist[i]) * p_amp_;
+
+    // -- read from delay lines --
 
     // add-write here
     F32 * buffer = p_signal_->writePointer();
+    const AudioDelay
+            * delay = snd->delay(),
+            * delayDist = (p_enableDist_ && snd->isDistanceSound())
+                            ? snd->delayDist() : 0;
 
-    F32 delayReadPos = bufferSize();
-
-    for (uint i=0; i<bufferSize(); ++i, --delayReadPos)
+    for (uint i=0; i<size; ++i)
     {
-        // get transformation and position for mic/snd for each sample
-        const Mat4&
-                matrixMic = transformationBuffer()->transformation(i),
-                matrixSnd = snd->transformationBuffer()->transformation(i);
-        const Vec4
-                posMic = matrixMic * Vec4(0,0,0,1),
-                posSnd = matrixSnd * Vec4(0,0,0,1);
-
-        // direction towards sound
-        F32 dx = posSnd.x - posMic.x,
-            dy = posSnd.y - posMic.y,
-            dz = posSnd.z - posMic.z;
+        // mic and sound are at same position?
+        if (dist[i] < EPSILON)
+        {
+            buffer[i] += snd->signal()->read(i);
+            continue;
+        }
 
-        // distance to sound
-        const F32 dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+        // read delayed sample from snd
+        F32 sam = delay->read(delayPos[i]);
 
-        // mic and sound are at same position?
-        if (dist < EPSILON)
-            *buffer++ += snd->signal()->read(i);
-        else
+        // mix with distance-sound
+        if (delayDist)
         {
-            // amplitude from distance
-            const F32 ampDist = 1.f / (1.f + p_distFade_ * dist);
-
-            // delaytime from distance
-            const F32 delaySam = dist / 330.f * p_sampleRate_;
-
-            // read delayed sample from snd
-#if (1)
-            F32 sam = snd->delay()->read(delayReadPos + delaySam);
-#else
-            F32 sam = snd->signal()->read(i);
-#endif
-            // mix with distance-sound
-            if (p_enableDist_ && snd->isDistanceSound())
-            {
-                F32 dmix = std::max(0.f, std::min(1.f,
-                                (dist - p_minDist_) * dist_fac ));
-
-                sam += dmix * (snd->delayDist()->read(delayReadPos + delaySam) - sam);
-            }
-
-
-            // normalize direction
-            dx /= dist;
-            dy /= dist;
-            dz /= dist;
-
-            // get direction of microphone
-            // (suppose microphone originally points at <0,0,-1>)
-            Vec4 micDir = matrixMic * Vec4(0,0,-1, 0);
-            F32 mx = micDir[0], my = micDir[1], mz = micDir[2];
-
-            // normalize
-            const F32 micDirMag = std::sqrt(mx*mx + my*my + mz*mz);
-            mx /= micDirMag;
-            my /= micDirMag;
-            mz /= micDirMag;
-
-            // direction factor
-            const F32 micDot = 0.5f + 0.5f * (dx * mx + dy * my + dz * mz);
-
-            // amplitude from direction
-            const F32 ampDir = std::pow(micDot, p_dirExp_);
-
-            // add to microphone sample buffer
-            *buffer++ += sam * ampDist * ampDir * p_amp_;
+            const F32 dmix = std::max(0.f, std::min(1.f,
+                                    (dist[i] - p_minDist_) * dist_fac ));
+
+            sam += dmix * (delayDist->read(delayPos[i]) - sam);
         }
+
+        // add to microphone sample buffer
+        buffer[i] += sam * gain[i];
     }
 }
 
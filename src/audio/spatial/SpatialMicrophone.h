@@ -55,14 +55,25 @@ public:
 
     // -------------- spatialization -----------------
 
+    /** Records all @p soundSources into signal().
+        SpatialSoundSource::updatePositions() must have been called for
+        the current block.
+        Different microphones can be spatialized in parallel. */
     void spatialize(const QList<SpatialSoundSource*>& soundSources);
 
 private:
 
+    /** Extracts position and normalized direction per sample */
+    void updateTrack_();
     void spatialize_(SpatialSoundSource*);
 
     AudioBuffer * p_signal_;
     TransformationBuffer p_transform_;
+    /** Structure-of-arrays block data, bufferSize() each */
+    std::vector<F32>
+        p_posX_, p_posY_, p_posZ_,
+        p_dirX_, p_dirY_, p_dirZ_,
+        p_dist_, p_gain_, p_delayPos_;
     uint p_sampleRate_, p_channel_;
     F32 p_sampleRateInv_,
         p_amp_, p_dirExp_, p_distFade_,
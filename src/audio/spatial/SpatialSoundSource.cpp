@@ -8,6 +8,8 @@
     <p>created 08.12.2014</p>
 */
 
+#include <algorithm>
+
 #include "SpatialSoundSource.h"
 #include "audio/tool/AudioBuffer.h"
 #include "audio/tool/Delay.h"
@@ -21,10 +23,19 @@ SpatialSoundSource::SpatialSoundSource(AudioBuffer * b, AudioDelay * d)
     , p_delay_              (d)
     , p_delayDist_          (nullptr)
     , p_transform_          (b->blockSize())
+    , p_posX_               (b->blockSize())
+    , p_posY_               (b->blockSize())
+    , p_posZ_               (b->blockSize())
     , p_isDistSound_        (false)
 {
 }
 
+void SpatialSoundSource::updatePositions()
+{
+    // the translation column equals matrix * Vec4(0,0,0,1)
+    p_transform_.getColumn(3, &p_posX_[0], &p_posY_[0], &p_posZ_[0]);
+}
+
 uint SpatialSoundSource::bufferSize() const
 {
     return p_signal_->blockSize();
@@ -47,6 +47,16 @@ public:
     TransformationBuffer * transformationBuffer() { return &p_transform_; }
     const TransformationBuffer * transformationBuffer() const { return &p_transform_; }
 
+    /** Position track of the current block (bufferSize() values per axis).
+        Valid after updatePositions() */
+    const F32 * positionX() const { return &p_posX_[0]; }
+    const F32 * positionY() const { return &p_posY_[0]; }
+    const F32 * positionZ() const { return &p_posZ_[0]; }
+
+    /** Extracts the positions from the transformationBuffer().
+        Call once per block after the transformations are calculated. */
+    void updatePositions();
+
     // -------- distance sounds --------
 
     bool isDistanceSound() const { return p_isDistSound_; }
@@ -68,6 +78,7 @@ private:
     AudioBuffer * p_signal_, * p_signalDist_;
     AudioDelay * p_delay_, * p_delayDist_;
     TransformationBuffer p_transform_;
+    std::vector<F32> p_posX_, p_posY_, p_posZ_;
     bool p_isDistSound_;
 };
 
@@ -18,6 +18,7 @@
  */
 
 #include <vector>
+#include <algorithm>
 
 #include "BandlimitWavetableGenerator.h"
 #include "FixedFilter.h"
@@ -193,19 +194,26 @@ void BandlimitWavetableGenerator::Private::generateEquationTable()
     // prepare an equation
     PPP_NAMESPACE::Parser equ;
 
-    PPP_NAMESPACE::Float vx, vxr;
+    PPP_NAMESPACE::Float vx = 0, vxr = 0;
     equ.variables().add("x", &vx, "");
     equ.variables().add("xr", &vxr, "");
 
-    equ.parse(equation.toStdString());
+    if (!equ.parse(equation.toStdString()))
+    {
+        std::fill(table.begin(), table.end(), 0.);
+        return;
+    }
 
     // generate it
+    std::vector<PPP_NAMESPACE::Float> ax(hz), axr(hz);
     for (uint i=0; i<hz; ++i)
     {
-        vx = Double(i) / hz;
-        vxr = vx * TWO_PI;
-        table[i] = equ.eval();
+        ax[i] = Double(i) / hz;
+        axr[i] = ax[i] * TWO_PI;
     }
+    equ.setBatchVariable("x", &ax[0]);
+    equ.setBatchVariable("xr", &axr[0]);
+    equ.evalBatch(&table[0], hz);
 
 }
 
@@ -13,13 +13,17 @@
 #include "ConvolveBuffer.h"
 #include "AudioBuffer.h"
 #include "ResampleBuffer.h"
+#include "PartitionedConvolver.h"
 #include "math/OouraFft.h"
 #include "math/Convolution.h"
 #include "types/int.h"
 #include "io/error.h"
 #include "io/log.h"
 
-#define MO_SPLIT_METHOD
+/* non-uniform partitions with background tail processing */
+#define MO_PARTITIONED_METHOD
+/* uniform partitions of the dsp block size */
+//#define MO_SPLIT_METHOD
 
 namespace MO {
 namespace AUDIO {
@@ -44,7 +48,13 @@ struct ConvolveBuffer::Private
 
     ConvolveBuffer* p;
 
-#ifdef MO_SPLIT_METHOD
+#if defined(MO_PARTITIONED_METHOD)
+    void process(const AudioBuffer *in, AudioBuffer *out);
+    std::vector<F32>
+            kernel;
+    PartitionedConvolver convolver;
+    size_t curBlockSize;
+#elif defined(MO_SPLIT_METHOD)
     void process(const AudioBuffer *in, AudioBuffer *out);
     std::vector<F32>
             kernel,
@@ -106,7 +116,43 @@ void ConvolveBuffer::process(const AudioBuffer *in, AudioBuffer *out)
     p_->process(in, out);
 }
 
-#ifdef MO_SPLIT_METHOD
+#if defined(MO_PARTITIONED_METHOD)
+
+void ConvolveBuffer::Private::prepareComplexKernel(size_t blockSize)
+{
+    convolver.init(blockSize, kernel.data(), kernel.size());
+
+    MO_PRINT("ConvolveBuffer: kernel=" << kernel.size()
+             << "; dspblock=" << blockSize
+             << "; head=" << convolver.blockSize()
+             << "; tail=" << convolver.tailBlockSize());
+
+    // get global amp
+    kernelSum = 0.0001f;
+    for (size_t i=0; i<kernel.size(); ++i)
+        kernelSum += std::abs(kernel[i]);
+
+    amplitude = 1.f / kernelSum;
+
+    // acknowledge
+    curBlockSize = blockSize;
+    kernelChanged = false;
+}
+
+void ConvolveBuffer::Private::process(const AudioBuffer *in, AudioBuffer *out)
+{
+    MO_ASSERT(in->blockSize() == out->blockSize(), "blocksize mismatch "
+              << in->blockSize() << "/" << out->blockSize());
+
+    // update kernel partitions if necessary
+    if (kernelChanged
+        || in->blockSize() != curBlockSize)
+        prepareComplexKernel(in->blockSize());
+
+    convolver.process(in->readPointer(), out->writePointer(), in->blockSize());
+}
+
+#elif defined(MO_SPLIT_METHOD)
 
 void ConvolveBuffer::Private::prepareComplexKernel(size_t blockSize)
 {
@@ -12,6 +12,7 @@
 #define MOSRC_AUDIO_TOOL_ENVELOPEGENERATOR_H
 
 #include <cmath>
+#include <algorithm>
 
 #include "types/int.h"
 
@@ -84,6 +85,12 @@ public:
         @p stride is the number of samples to forward in @p output for each sample. */
     void process(F * output, uint blockSize, uint stride = 1);
 
+    /** Writes the current value into @p output and forwards the envelope
+        for each of @p blockSize samples, the same as calling value() and next().
+        Stops after the sample on which the envelope became inactive.
+        Returns the number of samples written. */
+    uint processUntilStop(F * output, uint blockSize);
+
     // __________ PRIVATE ____________
 
 private:
@@ -184,6 +191,77 @@ void EnvelopeGenerator<F>::process(F * output, uint count, uint stride)
 }
 
 
+template <typename F>
+uint EnvelopeGenerator<F>::processUntilStop(F * output, uint count)
+{
+    if (!active_)
+    {
+        if (count)
+            *output = value_;
+        return std::min(count, uint(1));
+    }
+
+    // same as next() but with the state switch outside of the loops
+    uint i = 0;
+    while (i < count)
+    {
+        switch (state_)
+        {
+            case ENV_ATTACK:
+                while (i < count)
+                {
+                    output[i++] = value_;
+                    value_ += attack_c_ * (F(1) - value_);
+                    if (value_ >= F(0.999))
+                    {
+                        state_ = ENV_DECAY;
+                        break;
+                    }
+                }
+            break;
+
+            case ENV_DECAY:
+                while (i < count)
+                {
+                    output[i++] = value_;
+                    value_ += decay_c_ * (sustain_ - value_);
+                    if (std::abs(value_ - sustain_) < F(0.001))
+                    {
+                        if (sustain_ > 0)
+                            state_ = ENV_SUSTAIN;
+                        else
+                        {
+                            stop();
+                            return i;
+                        }
+                        break;
+                    }
+                }
+            break;
+
+            case ENV_RELEASE:
+                while (i < count)
+                {
+                    output[i++] = value_;
+                    value_ -= release_c_ * value_;
+                    if (value_ <= 0.0001)
+                    {
+                        stop();
+                        return i;
+                    }
+                }
+            break;
+
+            case ENV_SUSTAIN:
+                for (; i < count; ++i)
+                    output[i] = value_;
+            break;
+        }
+    }
+
+    return count;
+}
+
 
 } // namespace AUDIO
 } // namespace MO
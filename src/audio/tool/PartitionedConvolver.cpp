@@ -0,0 +1,388 @@
+/** @file partitionedconvolver.cpp
+
+    @brief Non-uniform partitioned convolution with background tail processing
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include "PartitionedConvolver.h"
+#include "audio/3rd/KlangFalter/FFTConvolver.h"
+#include "math/denormals.h"
+#include "io/CurrentThread.h"
+#include "io/log_audio.h"
+
+namespace MO {
+namespace AUDIO {
+
+namespace {
+
+/** One background tail block of a PartitionedConvolver */
+struct TailJob
+{
+    ::fftconvolver::FFTConvolver * convolver;
+    const F32 * input;
+    F32 * output;
+    size_t num;
+    // guarded by TailPool mutex
+    bool isPending;
+    TailJob * next;
+};
+
+/** Worker threads shared by all PartitionedConvolvers.
+    Jobs are queued in an intrusive list, so submit() does not allocate. */
+class TailPool
+{
+public:
+
+    static TailPool& instance()
+    {
+        static TailPool pool;
+        return pool;
+    }
+
+    ~TailPool() { stop_(); }
+
+    /** Starts the workers with the first user */
+    void addUser()
+    {
+        std::lock_guard<std::mutex> lock(usersMutex_);
+        if (numUsers_++ == 0)
+            start_();
+    }
+
+    /** Stops the workers when the last user is gone.
+        The user must not have a pending job. */
+    void removeUser()
+    {
+        std::lock_guard<std::mutex> lock(usersMutex_);
+        if (--numUsers_ == 0)
+            stop_();
+    }
+
+    void submit(TailJob * job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job->isPending = true;
+            job->next = nullptr;
+            if (last_)
+                last_->next = job;
+            else
+                first_ = job;
+            last_ = job;
+        }
+        workCond_.notify_one();
+    }
+
+    /** Blocks until @p job is processed */
+    void wait(TailJob * job)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCond_.wait(lock, [job](){ return !job->isPending; });
+    }
+
+private:
+
+    TailPool() : first_(nullptr), last_(nullptr), numUsers_(0), doStop_(false) { }
+
+    void start_()
+    {
+        doStop_ = false;
+        const uint num = std::max(1u, std::thread::hardware_concurrency() / 2);
+        for (uint i=0; i<num; ++i)
+            threads_.push_back(std::thread([this](){ threadLoop_(); }));
+    }
+
+    void stop_()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            doStop_ = true;
+        }
+        workCond_.notify_all();
+        for (auto & t : threads_)
+            t.join();
+        threads_.clear();
+    }
+
+    void threadLoop_()
+    {
+        setCurrentThreadName("CONVOLVE");
+        // same as audio thread
+        MATH::setDenormals(false);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            workCond_.wait(lock, [this](){ return doStop_ || first_; });
+            if (doStop_)
+                return;
+
+            TailJob * job = first_;
+            first_ = job->next;
+            if (!first_)
+                last_ = nullptr;
+
+            lock.unlock();
+            job->convolver->process(job->input, job->output, job->num);
+            lock.lock();
+
+            job->isPending = false;
+            doneCond_.notify_all();
+        }
+    }
+
+    std::mutex usersMutex_, mutex_;
+    std::condition_variable workCond_, doneCond_;
+    std::vector<std::thread> threads_;
+    // guarded by mutex_
+    TailJob * first_, * last_;
+    // guarded by usersMutex_
+    size_t numUsers_;
+    bool doStop_;
+};
+
+} // namespace
+
+
+struct PartitionedConvolver::Private
+{
+    Private()
+        : blockSize     (0)
+        , tailBlockSize (0)
+        , kernelSize    (0)
+        , tailInputFill (0)
+        , precalcPos    (0)
+        , isPoolUser    (false)
+    {
+        job.convolver = &tail;
+        job.isPending = false;
+        job.next = nullptr;
+    }
+
+    void joinPool();
+    void leavePool();
+    void waitForTail();
+    void startTail();
+
+    /** Adds the samples of @p src to @p dst */
+    static void sum(F32 * dst, const F32 * src, size_t num)
+    {
+        for (size_t i=0; i<num; ++i)
+            dst[i] += src[i];
+    }
+
+    ::fftconvolver::FFTConvolver
+        head,
+        tail0,
+        tail;
+
+    size_t blockSize, tailBlockSize, kernelSize;
+
+    std::vector<F32>
+        tailInput,
+        tailOutput0,
+        tailPrecalc0,
+        tailOutput,
+        tailPrecalc,
+        backgroundInput;
+    size_t tailInputFill, precalcPos;
+
+    TailJob job;
+    bool isPoolUser;
+};
+
+
+PartitionedConvolver::PartitionedConvolver()
+    : p_    (new Private())
+{
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    reset();
+    delete p_;
+}
+
+size_t PartitionedConvolver::blockSize() const { return p_->blockSize; }
+size_t PartitionedConvolver::tailBlockSize() const { return p_->tailBlockSize; }
+size_t PartitionedConvolver::kernelSize() const { return p_->kernelSize; }
+
+void PartitionedConvolver::reset()
+{
+    p_->leavePool();
+
+    p_->head.reset();
+    p_->tail0.reset();
+    p_->tail.reset();
+    p_->tailInput.clear();
+    p_->tailOutput0.clear();
+    p_->tailPrecalc0.clear();
+    p_->tailOutput.clear();
+    p_->tailPrecalc.clear();
+    p_->backgroundInput.clear();
+    p_->tailInputFill = 0;
+    p_->precalcPos = 0;
+    p_->blockSize = 0;
+    p_->tailBlockSize = 0;
+    p_->kernelSize = 0;
+}
+
+void PartitionedConvolver::init(size_t blockSize, const F32 * kernel, size_t num,
+                                size_t tailBlockSize)
+{
+    reset();
+
+    if (blockSize == 0)
+        return;
+
+    // ignore silence at the end of the kernel
+    while (num > 0 && std::abs(kernel[num-1]) < 0.000001f)
+        --num;
+
+    const size_t headBlockSize = ::fftconvolver::NextPowerOf2(blockSize);
+    if (tailBlockSize == 0)
+        tailBlockSize = std::max(headBlockSize * 32, size_t(4096));
+    // must be a multiple of the head partitions
+    tailBlockSize = ::fftconvolver::NextPowerOf2(
+                std::max(tailBlockSize, headBlockSize * 2));
+
+    p_->blockSize = headBlockSize;
+    p_->tailBlockSize = tailBlockSize;
+    p_->kernelSize = num;
+
+    MO_DEBUG_AUDIO("PartitionedConvolver::init(" << blockSize << ", " << num
+                   << ") head=" << headBlockSize << " tail=" << tailBlockSize);
+
+    // head [0, T)
+    p_->head.init(headBlockSize, kernel, std::min(num, tailBlockSize));
+
+    // first tail part [T, 2T)
+    if (num > tailBlockSize)
+    {
+        p_->tail0.init(headBlockSize, kernel + tailBlockSize,
+                       std::min(num - tailBlockSize, tailBlockSize));
+        p_->tailOutput0.resize(tailBlockSize, 0.f);
+        p_->tailPrecalc0.resize(tailBlockSize, 0.f);
+    }
+
+    // remaining tail [2T, end)
+    if (num > 2 * tailBlockSize)
+    {
+        p_->tail.init(tailBlockSize, kernel + 2 * tailBlockSize,
+                      num - 2 * tailBlockSize);
+        p_->tailOutput.resize(tailBlockSize, 0.f);
+        p_->tailPrecalc.resize(tailBlockSize, 0.f);
+        p_->backgroundInput.resize(tailBlockSize, 0.f);
+        p_->joinPool();
+    }
+
+    if (num > tailBlockSize)
+        p_->tailInput.resize(tailBlockSize, 0.f);
+}
+
+void PartitionedConvolver::process(const F32 * input, F32 * output, size_t num)
+{
+    p_->head.process(input, output, num);
+
+    if (p_->tailInput.empty())
+        return;
+
+    const size_t
+            headSize = p_->blockSize,
+            tailSize = p_->tailBlockSize;
+
+    size_t processed = 0;
+    while (processed < num)
+    {
+        const size_t processing = std::min(num - processed,
+                                           headSize - (p_->tailInputFill % headSize));
+
+        // add previously calculated tail
+        if (!p_->tailPrecalc0.empty())
+            Private::sum(output + processed,
+                         &p_->tailPrecalc0[p_->precalcPos], processing);
+        if (!p_->tailPrecalc.empty())
+            Private::sum(output + processed,
+                         &p_->tailPrecalc[p_->precalcPos], processing);
+        p_->precalcPos += processing;
+
+        // collect input for the tail
+        memcpy(&p_->tailInput[p_->tailInputFill], input + processed,
+               processing * sizeof(F32));
+        p_->tailInputFill += processing;
+
+        // first tail part, one head partition at a time
+        if (!p_->tailPrecalc0.empty() && p_->tailInputFill % headSize == 0)
+        {
+            const size_t offset = p_->tailInputFill - headSize;
+            p_->tail0.process(&p_->tailInput[offset], &p_->tailOutput0[offset],
+                              headSize);
+            if (p_->tailInputFill == tailSize)
+                p_->tailOutput0.swap(p_->tailPrecalc0);
+        }
+
+        // remaining tail, one tail partition at a time in background
+        if (!p_->tailPrecalc.empty() && p_->tailInputFill == tailSize)
+        {
+            p_->waitForTail();
+            p_->tailOutput.swap(p_->tailPrecalc);
+            memcpy(&p_->backgroundInput[0], &p_->tailInput[0],
+                   tailSize * sizeof(F32));
+            p_->startTail();
+        }
+
+        if (p_->tailInputFill == tailSize)
+        {
+            p_->tailInputFill = 0;
+            p_->precalcPos = 0;
+        }
+
+        processed += processing;
+    }
+}
+
+
+void PartitionedConvolver::Private::joinPool()
+{
+    TailPool::instance().addUser();
+    isPoolUser = true;
+}
+
+void PartitionedConvolver::Private::leavePool()
+{
+    if (!isPoolUser)
+        return;
+
+    waitForTail();
+    TailPool::instance().removeUser();
+    isPoolUser = false;
+}
+
+void PartitionedConvolver::Private::waitForTail()
+{
+    TailPool::instance().wait(&job);
+}
+
+void PartitionedConvolver::Private::startTail()
+{
+    job.input = backgroundInput.data();
+    job.output = tailOutput.data();
+    job.num = tailBlockSize;
+    TailPool::instance().submit(&job);
+}
+
+
+} // namespace AUDIO
+} // namespace MO
@@ -0,0 +1,78 @@
+/** @file partitionedconvolver.h
+
+    @brief Non-uniform partitioned convolution with background tail processing
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_AUDIO_TOOL_PARTITIONEDCONVOLVER_H
+#define MOSRC_AUDIO_TOOL_PARTITIONEDCONVOLVER_H
+
+#include <cstddef>
+
+#include "types/float.h"
+
+namespace MO {
+namespace AUDIO {
+
+/** Zero-latency convolution for long kernels.
+
+    The kernel is split into three parts:
+    - the head [0, T) is convolved with partitions of the block size
+    - the first tail part [T, 2T) is convolved with partitions of the block size
+      and delayed by T samples
+    - the remaining tail [2T, end) is convolved with partitions of size T
+      on a background thread and delayed by 2T samples
+
+    T is the tail block size. The background tail blocks of all
+    convolvers are processed by one shared pool of worker threads.
+    A tail block has T samples of time to finish and is synchronized
+    with process() once every T samples.
+    */
+class PartitionedConvolver
+{
+public:
+    PartitionedConvolver();
+    ~PartitionedConvolver();
+
+    // ------------- getter ---------------
+
+    /** The head partition size */
+    size_t blockSize() const;
+    /** The tail partition size */
+    size_t tailBlockSize() const;
+    /** Size of the kernel without trailing silence */
+    size_t kernelSize() const;
+
+    // ------------- setter ---------------
+
+    /** Initializes the convolver with a kernel.
+        @p blockSize is the number of samples usually passed to process().
+        @p tailBlockSize is the partition size for the tail,
+        0 selects a value depending on @p blockSize.
+        Not realtime-safe, allocates memory and may start the worker threads. */
+    void init(size_t blockSize, const F32 * kernel, size_t num,
+              size_t tailBlockSize = 0);
+
+    /** Discards the kernel and waits for a pending background tail block */
+    void reset();
+
+    // ----------- processing -------------
+
+    /** Convolves @p num input samples into @p output.
+        Any @p num is supported, although it's most efficient
+        when equal to blockSize(). */
+    void process(const F32 * input, F32 * output, size_t num);
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace AUDIO
+} // namespace MO
+
+#endif // MOSRC_AUDIO_TOOL_PARTITIONEDCONVOLVER_H
@@ -9,6 +9,9 @@
 */
 
 #include <vector>
+#include <cmath>
+#include <cstring>
+#include <mutex>
 
 #include <sndfile.h>
 
@@ -16,15 +19,23 @@
 #include "SoundFileManager.h"
 #include "audio/Configuration.h"
 #include "audio/tool/AudioBuffer.h"
-#include "audio/tool/SoundFileIStream.h"
+#include "audio/tool/SoundFileStreamer.h"
 #include "math/interpol.h"
 #include "math/functions.h"
+#include "math/MinMaxPyramid.h"
 #include "io/error.h"
 #include "io/log_snd.h"
 
 namespace MO {
 namespace AUDIO {
 
+namespace {
+
+    /** Frames of the scratch buffer for reading from a stream */
+    const size_t streamBufFrames = 4096;
+
+} // namespace
+
 
 class SoundFile::Private
 {
@@ -42,7 +53,7 @@ public:
 
     ~Private()
     {
-        delete stream;
+        SoundFileStreamer::closeStream(stream);
     }
 
     bool ok, writeable, isStream;
@@ -55,9 +66,25 @@ public:
     /** 16 for uint16_t, 32 for float */
     uint bitSize;
 
-    SoundFileIStream * stream;
+    SoundFileStreamer::Stream * stream;
+    /** Scratch buffer for reading from stream,
+        streamBufFrames * channels, sized in p_openStream_() */
+    std::vector<F32> streamBuf;
 
     std::vector<unsigned char> data;
+
+    /** Raw sample value, no checks */
+    Double sample(size_t frame, uint channel) const
+    {
+        const size_t i = frame * channels + channel;
+        return bitSize == 16
+                ? Double(*((const int16_t*)&data[i << 1])) / 32768.
+                : Double(*((const F32*)&data[i << 2]));
+    }
+
+    /** One min/max cache per channel, guarded by minMaxMutex */
+    std::vector<MATH::MinMaxPyramid<Double>> minMax;
+    std::mutex minMaxMutex;
 };
 
 
@@ -143,6 +170,17 @@ uint SoundFile::lengthSamples() const
     return p_->lenSam;
 }
 
+uint64_t SoundFile::numUnderruns() const
+{
+    return p_->stream ? p_->stream->numUnderruns() : 0;
+}
+
+void SoundFile::prefetch(Double time)
+{
+    if (p_->stream && time >= 0.)
+        p_->stream->prefetch(time * sampleRate());
+}
+
 std::vector<F32> SoundFile::getSamples(uint channel, uint len) const
 {
     if (!isOk() || numberChannels() == 0)
@@ -206,24 +244,57 @@ void SoundFile::getResampled(
             invSrThis = 1. / std::max((uint)1, sampleRate());
     size_t i, num = std::min((int)numberChannels(), channels.size());
 
-    // read from stream
+    // read from prefetch stream
     if (isStream())
     {
-        size_t bsize = channels.front()->blockSize();
-        F32 buf[bsize * numberChannels()];
-
-        p_->stream->seek(frame);
-        p_->stream->read(buf, bsize);
-
-        for (i=0; i<num; ++i)
+        const size_t
+                bsize = channels.front()->blockSize(),
+                nc = numberChannels();
+        // source frames per output sample
+        const Double step = Double(sampleRate()) * invSr * pitch;
+        // output samples per chunk, so that the source frames
+        // (span + 2 interpolation frames) fit into streamBuf
+        const size_t chunk = std::abs(step) < 1e-9
+                ? bsize
+                : std::max(size_t(1), size_t(Double(streamBufFrames - 3)
+                                             / std::abs(step)) + 1);
+        F32 * buf = &p_->streamBuf[0];
+
+        for (size_t j0=0; j0<bsize; j0 += chunk)
         {
-            if (!channels[i])
-                continue;
-
-            // XXX no resampling
-            for (size_t j=0; j<bsize; ++j)
+            const size_t n = std::min(chunk, bsize - j0);
+            const Double
+                    pos0 = Double(frame) + Double(j0) * step,
+                    pos1 = pos0 + Double(n - 1) * step;
+
+            // range of needed source frames
+            const long
+                    first = long(std::floor(std::min(pos0, pos1))),
+                    last = long(std::floor(std::max(pos0, pos1))) + 1;
+            const size_t numSrc = last - first + 1;
+
+            // frames before start of file
+            const size_t skip = first < 0 ? std::min(size_t(-first), numSrc) : 0;
+            memset(buf, 0, skip * nc * sizeof(F32));
+            if (skip < numSrc)
+                p_->stream->read(buf + skip * nc, first + skip, numSrc - skip);
+
+            // linear interpolation
+            const Double offset = pos0 - Double(first);
+            for (i=0; i<num; ++i)
             {
-                channels[i]->write(j, buf[j*numberChannels() + i] * amp);
+                if (!channels[i])
+                    continue;
+
+                for (size_t j=0; j<n; ++j)
+                {
+                    const Double t = offset + Double(j) * step;
+                    const size_t k = t;
+                    const F32 f = t - k,
+                              v0 = buf[k * nc + i],
+                              v1 = buf[(k + 1) * nc + i];
+                    channels[i]->write(j0 + j, (v0 + f * (v1 - v0)) * amp);
+                }
             }
         }
 
@@ -258,10 +329,8 @@ Double SoundFile::value(Double time, uint channel, bool interpol) const
 
     if (isStream())
     {
-        /** @todo super hacky inefficient  */
         F32 buf[numberChannels()];
-        p_->stream->seek(frame);
-        p_->stream->read(buf, 1);
+        p_->stream->read(buf, frame, 1);
         return buf[channel];
     }
 
@@ -335,10 +404,8 @@ Double SoundFile::value(size_t frame, uint channel) const
     // read from stream
     if (isStream())
     {
-        /** @todo super hacky inefficient  */
         F32 buf[numberChannels()];
-        p_->stream->seek(frame);
-        p_->stream->read(buf, 1);
+        p_->stream->read(buf, frame, 1);
         return buf[channel];
     }
 
@@ -362,6 +429,51 @@ Double SoundFile::value(size_t frame, uint channel) const
 
 
 
+bool SoundFile::getMinMax(uint channel, Double start, Double end,
+                          Double& mi, Double& ma) const
+{
+    if (!p_->ok || isStream() || channel >= numberChannels()
+        || (p_->bitSize != 16 && p_->bitSize != 32))
+        return false;
+
+    if (end < start)
+        std::swap(start, end);
+
+    const long int
+            len = p_->lenSam,
+            f0 = std::floor(start * sampleRate()),
+            f1 = std::ceil(end * sampleRate());
+
+    // silence outside of file
+    bool hasZero = f0 < 0 || f1 >= len;
+    if (len == 0 || f1 < 0 || f0 >= len)
+    {
+        mi = ma = 0.;
+        return true;
+    }
+
+    auto value = [=](size_t i) { return p_->sample(i, channel); };
+
+    std::lock_guard<std::mutex> lock(p_->minMaxMutex);
+
+    if (p_->minMax.size() != p_->channels)
+        p_->minMax.resize(p_->channels);
+
+    // build/extend lazily
+    auto& pyr = p_->minMax[channel];
+    if (pyr.size() != size_t(len))
+        pyr.append(len, value);
+
+    pyr.getMinMax(std::max(0l, f0), std::min(len - 1, f1), value, mi, ma);
+    if (hasZero)
+    {
+        mi = std::min(mi, 0.);
+        ma = std::max(ma, 0.);
+    }
+    return true;
+}
+
+
 void SoundFile::appendDeviceData(const F32 *buf, size_t numSamples)
 {
     if (!isWriteable())
@@ -408,6 +520,7 @@ void SoundFile::p_create_(uint channels, uint sr, int bitSize)
     p_->lenSam = 0;
     p_->lenSec = 0;
     p_->data.clear();
+    p_->minMax.clear();
     p_->writeable = true;
     p_->ok = true;
 }
@@ -445,6 +558,7 @@ void SoundFile::p_loadFile_(const QString & fn)
     p_->sr = info.samplerate;
     p_->lenSam = info.frames;
     p_->lenSec = (Double)info.frames / info.samplerate;
+    p_->minMax.clear();
 
 
 #if 0
@@ -483,9 +597,10 @@ void SoundFile::p_openStream_(const QString& fn)
     p_->ok = false;
     p_->filename = fn;
 
-    if (!p_->stream)
-        p_->stream = new SoundFileIStream();
-    p_->stream->open(fn);
+    SoundFileStreamer::closeStream(p_->stream);
+    p_->stream = 0;
+    p_->stream = SoundFileStreamer::openStream(fn);
+    p_->streamBuf.resize(streamBufFrames * p_->stream->numChannels());
 
     p_->ok = true;
     p_->channels = p_->stream->numChannels();
@@ -11,6 +11,8 @@
 #ifndef MOSRC_AUDIO_TOOL_SOUNDFILE_H
 #define MOSRC_AUDIO_TOOL_SOUNDFILE_H
 
+#include <cinttypes>
+
 #include <QString>
 #include <QList>
 
@@ -52,6 +54,10 @@ public:
         of a file-in-memory. */
     bool isStream() const;
 
+    /** Returns the number of reads that could not be served
+        from the prefetch buffer, for streams only. */
+    uint64_t numUnderruns() const;
+
     /** Returns the filename of the sound file */
     const QString& filename() const;
 
@@ -71,6 +77,15 @@ public:
     Double value(Double time, uint channel = 0, bool interpol = true) const;
     Double value(size_t frame, uint channel) const;
 
+    /** Returns the smallest and largest sample value of @p channel
+        between @p start and @p end (in seconds).
+        Times outside the file count as zero.
+        The values are cached per channel in a MATH::MinMaxPyramid,
+        which is built on first use and extended when data is appended.
+        Returns false for streams or errors. */
+    bool getMinMax(uint channel, Double start, Double end,
+                   Double& minimum, Double& maximum) const;
+
     /** Returns one channel as consecutive data */
     std::vector<F32> getSamples(uint channel = 0, uint lengthSamples = 0) const;
 
@@ -85,6 +100,10 @@ public:
 
     // --------- setter ---------------
 
+    /** For streams, starts reading ahead from @p time (in seconds).
+        Call this some time before jumping to a new position. */
+    void prefetch(Double time);
+
     void appendDeviceData(const F32 * buf, size_t numSamples);
 
     /** Calls AUDIO::SoundFileManager::releaseSoundFile(this) */
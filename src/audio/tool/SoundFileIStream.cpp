@@ -204,7 +204,7 @@ size_t SoundFileIStream::Private::read(F32 *buffer, size_t numSamples)
     if (len < numSamples)
     {
         const size_t
-                s = (numSamples - len) * parent->numChannels(),
+                s = len * parent->numChannels(),
                 e = numSamples * parent->numChannels();
         for (size_t i = s; i < e; ++i)
             buffer[i] = F32(0);
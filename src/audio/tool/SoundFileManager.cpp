@@ -31,7 +31,26 @@ public:
         int count;
     };
 
+    /** Decreases the count of @p key in @p map, deletes the file when zero.
+        Returns false if not found. */
+    template <class Map, class Key>
+    static bool release(Map& map, const Key& key)
+    {
+        auto i = map.find(key);
+        if (i == map.end())
+            return false;
+        if (!--i.value().count)
+        {
+            delete i.value().sf;
+            map.erase(i);
+        }
+        return true;
+    }
+
+    /** Memory files, shared per filename */
     QMap<QString, File> soundFiles_;
+    /** Streams, one per getSoundFile() call */
+    QMap<SoundFile*, File> streams_;
 
     QReadWriteLock lock;
 };
@@ -51,6 +70,8 @@ SoundFileManager::~SoundFileManager()
 
     for (auto s : p_->soundFiles_)
         delete s.sf;
+    for (auto s : p_->streams_)
+        delete s.sf;
     delete p_;
 }
 
@@ -65,13 +86,17 @@ SoundFileManager * SoundFileManager::p_getInstance_()
 SoundFile * SoundFileManager::getSoundFile(const QString &filename_, bool loadToMemory)
 {
     QString filename = IO::fileManager().localFilename(filename_),
-            key = filename + (loadToMemory ? "_mem" : "_stream");
+            key = filename + "_mem";
 
     MO_DEBUG_SND("SoundFileManager::getSoundFile('"
                  << filename_ << "', " << loadToMemory);
 
     auto sfm = p_getInstance_();
 
+    // a stream has only one read position, so don't share
+    if (!loadToMemory)
+        return p_openStream_(filename);
+
     {
         QReadLocker lock(&sfm->p_->lock);
 
@@ -96,10 +121,7 @@ SoundFile * SoundFileManager::getSoundFile(const QString &filename_, bool loadTo
     // try to load
     try
     {
-        if (loadToMemory)
-            sf->p_loadFile_(filename);
-        else
-            sf->p_openStream_(filename);
+        sf->p_loadFile_(filename);
     }
     catch (Exception & e)
     {
@@ -114,6 +136,33 @@ SoundFile * SoundFileManager::getSoundFile(const QString &filename_, bool loadTo
     return sf;
 }
 
+SoundFile * SoundFileManager::p_openStream_(const QString &filename)
+{
+    // open outside of lock
+    SoundFile * sf = new SoundFile();
+    try
+    {
+        sf->p_openStream_(filename);
+    }
+    catch (Exception & e)
+    {
+        MO_IO_WARNING(READ, "opening soundfile stream failed: \n"
+                      << e.what());
+
+        sf->p_setError_( QObject::tr("Failed to open soundfile, %1").arg(e.what()) );
+    }
+
+    auto sfm = p_getInstance_();
+
+    QWriteLocker lock(&sfm->p_->lock);
+    Private::File file;
+    file.sf = sf;
+    file.count = 1;
+    sfm->p_->streams_.insert(sf, file);
+
+    return sf;
+}
+
 SoundFile * SoundFileManager::createSoundFile(uint channels, uint samplerate)
 {
     SoundFile * sf = new SoundFile();
@@ -138,45 +187,36 @@ void SoundFileManager::releaseSoundFile(SoundFile * sf)
 {
     MO_DEBUG_SND("SoundFileManager::releaseSoundFile(" << sf << ")");
 
-    QString key = sf->filename() + (sf->isStream() ? "_stream" : "_mem");
-
     auto sfm = p_getInstance_();
 
     QWriteLocker lock(&sfm->p_->lock);
 
-    auto i = sfm->p_->soundFiles_.find(key);
-
-    // check for existence
-    // (unlikely this would fail)
-    if (i == sfm->p_->soundFiles_.end())
-    {
-        MO_WARNING("SoundFileManager::releaseSoundFile() called for unknown SoundFile\n"
-                   "'" << sf->filename() << "'");
+    // count down and destroy if not needed anymore
+    if (Private::release(sfm->p_->streams_, sf)
+     || Private::release(sfm->p_->soundFiles_, sf->filename() + "_mem"))
         return;
-    }
-
-    // count down
-    i.value().count--;
 
-    // destroy if not needed anymore
-    if (!i.value().count)
-    {
-        delete i.value().sf;
-        sfm->p_->soundFiles_.erase(i);
-    }
+    // (unlikely this would fail)
+    MO_WARNING("SoundFileManager::releaseSoundFile() called for unknown SoundFile\n"
+               "'" << sf->filename() << "'");
 }
 
 void SoundFileManager::addReference(SoundFile * sf)
 {
     MO_DEBUG_SND("SoundFileManager::addReference(" << sf << ")");
 
-    QString key = sf->filename() + (sf->isStream() ? "_stream" : "_mem");
-
     auto sfm = p_getInstance_();
 
     QWriteLocker lock(&sfm->p_->lock);
 
-    auto i = sfm->p_->soundFiles_.find(key);
+    auto s = sfm->p_->streams_.find(sf);
+    if (s != sfm->p_->streams_.end())
+    {
+        ++s.value().count;
+        return;
+    }
+
+    auto i = sfm->p_->soundFiles_.find(sf->filename() + "_mem");
 
     // check for existence
     // (unlikely this would fail)
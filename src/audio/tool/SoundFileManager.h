@@ -31,7 +31,10 @@ public:
         When finished with it, call releaseSoundFile()!
         This function always returns a SoundFile class.
         If loading has failed, SoundFile::isOk() will be false.
-        The error string is *currently* just printed to the console. */
+        The error string is *currently* just printed to the console.
+        Files loaded to memory are shared between callers.
+        Streams are not, every call returns a new stream with
+        its own read position. */
     static SoundFile * getSoundFile(const QString& filename, bool loadToMemory = true);
 
     /** Creates a new instance for memory-based recording */
@@ -47,6 +50,7 @@ public:
 private:
 
     static SoundFileManager * p_getInstance_();
+    static SoundFile * p_openStream_(const QString& filename);
     static SoundFileManager * p_instance_;
 
     class Private;
@@ -0,0 +1,609 @@
+/** @file soundfilestreamer.cpp
+
+    @brief Background prefetch streaming of sound files
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "SoundFileStreamer.h"
+#include "SoundFileIStream.h"
+#include "audio/Configuration.h"
+#include "io/CurrentThread.h"
+#include "io/log_snd.h"
+
+namespace MO {
+namespace AUDIO {
+
+namespace {
+
+    /** Next power of two >= @p x */
+    size_t nextPowerOfTwo(size_t x)
+    {
+        size_t n = 1;
+        while (n < x)
+            n <<= 1;
+        return n;
+    }
+
+    /** Guards creation and deletion of the instance,
+        streams might be opened from different loader threads */
+    std::mutex instanceMutex;
+
+} // namespace
+
+
+struct SoundFileStreamer::Private
+{
+    Private()
+        : prefetchSeconds   (2.)
+        , sampleRate        (44100)
+        , bufferSize        (256)
+        , closedUnderruns   (0)
+        , hasWork           (false)
+        , doStop            (false)
+    { }
+
+    void startThread();
+    void stopThread();
+    void threadLoop();
+    /** Wakes up the I/O thread, callable from any thread */
+    void wake();
+    /** Performs pending seeks and fills the most urgent stream of @p work.
+        Called without the mutex.
+        Returns true if there might be more work. */
+    bool service(const std::vector<Stream*>& work);
+
+    Double prefetchSeconds;
+    uint sampleRate, bufferSize;
+    uint64_t closedUnderruns;
+
+    // guarded by mutex
+    std::vector<Stream*> streams;
+    /** Streams from closeStream(), deleted by the I/O thread
+        after the pass that might still read them. Guarded by mutex */
+    std::vector<Stream*> closed;
+
+    std::thread thread;
+    /** Guards the stream list and settings, never held during file access */
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::atomic<bool> hasWork;
+    // guarded by mutex
+    bool doStop;
+};
+
+
+// ################################ Stream #######################################
+
+/* Single-producer/single-consumer ring buffer.
+
+   The consumer (read(), prefetch()) owns readPos, reqPos and reqEpoch.
+   The producer (the I/O thread) owns servedEpoch, bufStart and writePos.
+
+   Ring slots are indexed by absolute file frame & mask.
+   The valid frames are [max(bufStart, readPos - keepBack), writePos).
+   The producer never writes beyond readPos - keepBack + capacity,
+   so the valid frames are not overwritten while the consumer copies them.
+
+   To seek, the consumer sets reqPos and increments reqEpoch and does not
+   touch the ring until the producer has set servedEpoch to the same value. */
+struct SoundFileStreamer::Stream::Private
+{
+    Private()
+        : sr            (0)
+        , channels      (0)
+        , length        (0)
+        , capacity      (0)
+        , mask          (0)
+        , keepBack      (0)
+        , readPos       (0)
+        , reqPos        (0)
+        , reqEpoch      (1)
+        , servedEpoch   (0)
+        , bufStart      (0)
+        , writePos      (0)
+        , underruns     (0)
+        , underrunFrames(0)
+        , seeks         (0)
+    {
+        busy.clear();
+    }
+
+    /** Consumer side, returns true if @p frame is readable */
+    bool isBuffered(size_t frame) const;
+    /** Consumer side */
+    void requestSeek(size_t frame);
+
+    /** Producer side, seeks if requested.
+        Returns true if a seek was performed. */
+    bool serviceSeek();
+    /** Producer side, reads up to @p maxFrames into the ring.
+        Returns the number of frames read. */
+    size_t serviceFill(size_t maxFrames);
+    /** Producer side, seconds of audio buffered ahead of the read position,
+        or a negative value if the buffer is full */
+    Double bufferedSeconds() const;
+    /** Producer side, the last frame that may be written + 1 */
+    size_t fillLimit() const;
+
+    SoundFileIStream file;
+    QString filename;
+    uint sr, channels;
+    size_t length, capacity, mask, keepBack;
+
+    std::vector<F32> ring;
+
+    // consumer
+    std::atomic_flag busy;
+    std::atomic<uint64_t> readPos, reqPos;
+    std::atomic<uint32_t> reqEpoch;
+
+    // producer
+    std::atomic<uint32_t> servedEpoch;
+    std::atomic<uint64_t> bufStart, writePos;
+
+    // statistics
+    std::atomic<uint64_t> underruns, underrunFrames, seeks;
+};
+
+
+SoundFileStreamer::Stream::Stream()
+    : p_    (new Private())
+{
+}
+
+SoundFileStreamer::Stream::~Stream()
+{
+    delete p_;
+}
+
+const QString& SoundFileStreamer::Stream::filename() const { return p_->filename; }
+uint SoundFileStreamer::Stream::sampleRate() const { return p_->sr; }
+uint SoundFileStreamer::Stream::numChannels() const { return p_->channels; }
+size_t SoundFileStreamer::Stream::lengthSamples() const { return p_->length; }
+size_t SoundFileStreamer::Stream::bufferFrames() const { return p_->capacity; }
+
+Double SoundFileStreamer::Stream::lengthSeconds() const
+{
+    return p_->sr ? Double(p_->length) / p_->sr : 0.;
+}
+
+uint64_t SoundFileStreamer::Stream::numUnderruns() const { return p_->underruns; }
+uint64_t SoundFileStreamer::Stream::numUnderrunFrames() const { return p_->underrunFrames; }
+uint64_t SoundFileStreamer::Stream::numSeeks() const { return p_->seeks; }
+
+
+bool SoundFileStreamer::Stream::Private::isBuffered(size_t frame) const
+{
+    if (servedEpoch.load(std::memory_order_acquire)
+            != reqEpoch.load(std::memory_order_relaxed))
+        return false;
+
+    const uint64_t
+            rp = readPos.load(std::memory_order_relaxed),
+            lo = std::max(bufStart.load(std::memory_order_relaxed),
+                          rp > keepBack ? rp - keepBack : uint64_t(0));
+    return frame >= lo && frame <= writePos.load(std::memory_order_acquire);
+}
+
+void SoundFileStreamer::Stream::Private::requestSeek(size_t frame)
+{
+    readPos.store(frame, std::memory_order_relaxed);
+    reqPos.store(frame, std::memory_order_relaxed);
+    reqEpoch.store(reqEpoch.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    ++seeks;
+    SoundFileStreamer::p_wake_();
+}
+
+size_t SoundFileStreamer::Stream::read(F32 *buffer, size_t frame, size_t num)
+{
+    const size_t nc = p_->channels;
+
+    // frames within file
+    const size_t avail = frame < p_->length
+            ? std::min(num, p_->length - frame) : 0;
+
+    size_t got = 0;
+    if (avail && !p_->busy.test_and_set(std::memory_order_acquire))
+    {
+        const uint32_t epoch = p_->reqEpoch.load(std::memory_order_relaxed);
+
+        if (p_->isBuffered(frame))
+        {
+            got = std::min(avail,
+                    size_t(p_->writePos.load(std::memory_order_acquire) - frame));
+
+            // copy from ring
+            size_t pos = frame & p_->mask,
+                   n1 = std::min(got, p_->capacity - pos);
+            memcpy(buffer, &p_->ring[pos * nc], n1 * nc * sizeof(F32));
+            if (n1 < got)
+                memcpy(buffer + n1 * nc, &p_->ring[0], (got - n1) * nc * sizeof(F32));
+
+            if (frame > p_->readPos.load(std::memory_order_relaxed))
+                p_->readPos.store(frame, std::memory_order_release);
+
+            // tell I/O thread when buffer runs low
+            if (p_->writePos.load(std::memory_order_relaxed) - frame < p_->capacity / 2
+                    && p_->writePos.load(std::memory_order_relaxed) < p_->length)
+                SoundFileStreamer::p_wake_();
+        }
+        // a seek is pending, re-request if the position moved too far
+        else if (p_->servedEpoch.load(std::memory_order_acquire) != epoch)
+        {
+            const uint64_t req = p_->reqPos.load(std::memory_order_relaxed);
+            if (frame < req || frame > req + p_->keepBack)
+                p_->requestSeek(frame);
+        }
+        // outside of the prefetched range
+        else
+            p_->requestSeek(frame);
+
+        p_->busy.clear(std::memory_order_release);
+    }
+
+    if (got < avail)
+    {
+        ++p_->underruns;
+        p_->underrunFrames += avail - got;
+    }
+
+    // zero the rest
+    if (got < num)
+        memset(buffer + got * nc, 0, (num - got) * nc * sizeof(F32));
+
+    return got;
+}
+
+void SoundFileStreamer::Stream::prefetch(size_t frame)
+{
+    if (frame >= p_->length)
+        return;
+
+    if (p_->busy.test_and_set(std::memory_order_acquire))
+        return;
+
+    const uint32_t epoch = p_->reqEpoch.load(std::memory_order_relaxed);
+
+    if (p_->servedEpoch.load(std::memory_order_acquire) != epoch)
+    {
+        if (p_->reqPos.load(std::memory_order_relaxed) != frame)
+            p_->requestSeek(frame);
+    }
+    else if (!p_->isBuffered(frame))
+        p_->requestSeek(frame);
+
+    p_->busy.clear(std::memory_order_release);
+}
+
+
+bool SoundFileStreamer::Stream::Private::serviceSeek()
+{
+    const uint32_t epoch = reqEpoch.load(std::memory_order_acquire);
+    if (epoch == servedEpoch.load(std::memory_order_relaxed))
+        return false;
+
+    const size_t pos = reqPos.load(std::memory_order_relaxed);
+    file.seek(pos);
+
+    bufStart.store(pos, std::memory_order_relaxed);
+    writePos.store(pos, std::memory_order_relaxed);
+    servedEpoch.store(epoch, std::memory_order_release);
+
+    // read the first block right away
+    serviceFill(capacity / 4);
+    return true;
+}
+
+size_t SoundFileStreamer::Stream::Private::fillLimit() const
+{
+    const uint64_t rp = std::max(readPos.load(std::memory_order_acquire),
+                                 bufStart.load(std::memory_order_relaxed));
+    return std::min(uint64_t(length), rp + capacity - keepBack);
+}
+
+Double SoundFileStreamer::Stream::Private::bufferedSeconds() const
+{
+    const uint64_t
+            w = writePos.load(std::memory_order_relaxed),
+            rp = readPos.load(std::memory_order_relaxed);
+    if (w >= fillLimit())
+        return -1.;
+    return w > rp ? Double(w - rp) / sr : 0.;
+}
+
+size_t SoundFileStreamer::Stream::Private::serviceFill(size_t maxFrames)
+{
+    // don't write data for an outdated position
+    if (reqEpoch.load(std::memory_order_acquire)
+            != servedEpoch.load(std::memory_order_relaxed))
+        return 0;
+
+    const uint64_t w = writePos.load(std::memory_order_relaxed),
+                   limit = fillLimit();
+    if (w >= limit)
+        return 0;
+
+    // contiguous part of ring
+    const size_t
+            pos = w & mask,
+            num = std::min(size_t(limit - w),
+                           std::min(maxFrames, capacity - pos));
+
+    const size_t got = file.read(&ring[pos * channels], num);
+
+    writePos.store(w + got, std::memory_order_release);
+    return got;
+}
+
+
+
+
+// ################################ Streamer #####################################
+
+SoundFileStreamer * SoundFileStreamer::p_instance_ = 0;
+
+SoundFileStreamer::SoundFileStreamer()
+    : p_    (new Private())
+{
+    MO_DEBUG_SND("SoundFileStreamer::SoundFileStreamer()");
+}
+
+SoundFileStreamer::~SoundFileStreamer()
+{
+    MO_DEBUG_SND("SoundFileStreamer::~SoundFileStreamer()");
+
+    p_->stopThread();
+    for (auto s : p_->closed)
+        delete s;
+    // the remaining streams are deleted by closeStream()
+    if (!p_->streams.empty())
+        MO_WARNING("SoundFileStreamer: " << p_->streams.size()
+                   << " streams still open at shutdown");
+    delete p_;
+}
+
+SoundFileStreamer * SoundFileStreamer::p_getInstance_()
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!p_instance_)
+        p_instance_ = new SoundFileStreamer();
+    return p_instance_;
+}
+
+void SoundFileStreamer::shutDown()
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    delete p_instance_;
+    p_instance_ = 0;
+}
+
+void SoundFileStreamer::p_wake_()
+{
+    if (p_instance_)
+        p_instance_->p_->wake();
+}
+
+void SoundFileStreamer::setConfiguration(const Configuration& conf)
+{
+    auto sfs = p_getInstance_();
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+    sfs->p_->sampleRate = conf.sampleRate();
+    sfs->p_->bufferSize = conf.bufferSize();
+}
+
+void SoundFileStreamer::setPrefetchSeconds(Double seconds)
+{
+    auto sfs = p_getInstance_();
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+    sfs->p_->prefetchSeconds = std::max(Double(0), seconds);
+}
+
+SoundFileStreamer::Stream * SoundFileStreamer::openStream(const QString &filename)
+{
+    MO_DEBUG_SND("SoundFileStreamer::openStream('" << filename << "')");
+
+    auto sfs = p_getInstance_();
+
+    Stream * s = new Stream();
+    Stream::Private * sp = s->p_;
+    try
+    {
+        sp->file.open(filename);
+    }
+    catch (...)
+    {
+        delete s;
+        throw;
+    }
+
+    sp->filename = filename;
+    sp->sr = sp->file.sampleRate();
+    sp->channels = sp->file.numChannels();
+    sp->length = sp->file.lengthSamples();
+
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+
+    // size of ring from audio configuration:
+    // at least prefetchSeconds and a number of dsp blocks
+    const Double srRatio = Double(sp->sr) / std::max(uint(1), sfs->p_->sampleRate);
+    size_t frames = std::max(size_t(sfs->p_->prefetchSeconds * sp->sr),
+                             size_t(16 * sfs->p_->bufferSize * srRatio));
+    // don't need more than the file
+    frames = std::min(frames, sp->length + 1);
+    sp->capacity = nextPowerOfTwo(std::max(frames, size_t(4096)));
+    sp->mask = sp->capacity - 1;
+    sp->keepBack = sp->capacity / 8;
+    sp->ring.resize(sp->capacity * sp->channels);
+
+    MO_DEBUG_SND("SoundFileStreamer::openStream() " << sp->capacity
+                 << " frames prefetch buffer");
+
+    sfs->p_->streams.push_back(s);
+    if (!sfs->p_->thread.joinable())
+        sfs->p_->startThread();
+
+    // initial prefetch
+    sfs->p_->hasWork = true;
+    sfs->p_->cond.notify_all();
+
+    return s;
+}
+
+void SoundFileStreamer::closeStream(Stream * s)
+{
+    if (!s)
+        return;
+
+    MO_DEBUG_SND("SoundFileStreamer::closeStream('" << s->filename() << "')");
+
+    // after shutDown()
+    auto sfs = p_instance_;
+    if (!sfs)
+    {
+        delete s;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+
+    auto i = std::find(sfs->p_->streams.begin(), sfs->p_->streams.end(), s);
+    if (i != sfs->p_->streams.end())
+        sfs->p_->streams.erase(i);
+
+    sfs->p_->closedUnderruns += s->numUnderruns();
+
+    // the current pass of the I/O thread might still read from s
+    if (sfs->p_->thread.joinable())
+    {
+        sfs->p_->closed.push_back(s);
+        sfs->p_->hasWork = true;
+        sfs->p_->cond.notify_all();
+    }
+    else
+        delete s;
+}
+
+uint64_t SoundFileStreamer::numUnderruns()
+{
+    auto sfs = p_getInstance_();
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+
+    uint64_t n = sfs->p_->closedUnderruns;
+    for (auto s : sfs->p_->streams)
+        n += s->numUnderruns();
+    return n;
+}
+
+size_t SoundFileStreamer::numStreams()
+{
+    auto sfs = p_getInstance_();
+    std::lock_guard<std::mutex> lock(sfs->p_->mutex);
+    return sfs->p_->streams.size();
+}
+
+
+void SoundFileStreamer::Private::startThread()
+{
+    doStop = false;
+    thread = std::thread([this](){ threadLoop(); });
+}
+
+void SoundFileStreamer::Private::stopThread()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        doStop = true;
+    }
+    cond.notify_all();
+    thread.join();
+}
+
+void SoundFileStreamer::Private::wake()
+{
+    // Not taking the mutex here, to stay lock-free for the audio thread.
+    // A missed notification is caught by the timeout in threadLoop().
+    if (!hasWork.exchange(true))
+        cond.notify_one();
+}
+
+void SoundFileStreamer::Private::threadLoop()
+{
+    setCurrentThreadName("SNDSTREAM");
+
+    std::vector<Stream*> work, closedWork;
+    bool busy = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!doStop)
+    {
+        if (!busy)
+            cond.wait_for(lock, std::chrono::milliseconds(10),
+                          [this](){ return doStop || hasWork; });
+        if (doStop)
+            break;
+
+        hasWork = false;
+        work = streams;
+        // closed since the last pass, not part of any pass anymore
+        closedWork.swap(closed);
+
+        // do the file access without the mutex,
+        // closed streams are only deleted here
+        lock.unlock();
+
+        for (auto s : closedWork)
+            delete s;
+        closedWork.clear();
+
+        busy = service(work);
+
+        lock.lock();
+    }
+}
+
+bool SoundFileStreamer::Private::service(const std::vector<Stream*>& work)
+{
+    // seeks first, they are audible
+    bool didSeek = false;
+    for (auto s : work)
+        didSeek |= s->p_->serviceSeek();
+
+    // fill the stream with the least buffered audio
+    Stream::Private * urgent = 0;
+    Double minSec = 0.;
+    for (auto s : work)
+    {
+        const Double sec = s->p_->bufferedSeconds();
+        if (sec >= 0. && (!urgent || sec < minSec))
+        {
+            urgent = s->p_;
+            minSec = sec;
+        }
+    }
+
+    if (urgent && urgent->serviceFill(std::max(size_t(4096), urgent->capacity / 8)))
+        return true;
+
+    return didSeek;
+}
+
+
+} // namespace AUDIO
+} // namespace MO
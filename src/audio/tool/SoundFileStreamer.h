@@ -0,0 +1,135 @@
+/** @file soundfilestreamer.h
+
+    @brief Background prefetch streaming of sound files
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_AUDIO_TOOL_SOUNDFILESTREAMER_H
+#define MOSRC_AUDIO_TOOL_SOUNDFILESTREAMER_H
+
+#include <cinttypes>
+
+#include <QString>
+
+#include "types/float.h"
+
+namespace MO {
+namespace AUDIO {
+
+class Configuration;
+
+/** Singleton engine that streams sound files from disk
+    through a dedicated I/O thread.
+
+    Each opened Stream has a prefetch ring buffer that the I/O thread
+    keeps filled ahead of the current read position.
+    Reading from a Stream never touches the disk and never blocks,
+    so it is safe to call from the audio thread.
+    If the requested frames are not in the buffer, silence is returned,
+    an underrun is counted and the I/O thread seeks to the new position.
+    A Stream follows a single read position, so every consumer
+    needs its own Stream.
+    */
+class SoundFileStreamer
+{
+    SoundFileStreamer();
+    ~SoundFileStreamer();
+
+public:
+
+    /** Handle to one prefetched file */
+    class Stream
+    {
+        friend class SoundFileStreamer;
+        Stream();
+        ~Stream();
+    public:
+
+        // ------------ getter ------------
+
+        const QString& filename() const;
+        uint sampleRate() const;
+        uint numChannels() const;
+        size_t lengthSamples() const;
+        Double lengthSeconds() const;
+
+        /** Size of the prefetch buffer in frames */
+        size_t bufferFrames() const;
+
+        /** Number of read() calls that could not be fully served
+            from the prefetch buffer */
+        uint64_t numUnderruns() const;
+        /** Number of frames that were returned as silence */
+        uint64_t numUnderrunFrames() const;
+        /** Number of seeks requested from the I/O thread */
+        uint64_t numSeeks() const;
+
+        // ------------ reading -----------
+
+        /** Reads @p num interleaved frames starting at @p frame into @p buffer.
+            @p buffer needs space for @p num * numChannels() floats.
+            Frames that are not prefetched yet, or lie outside the file,
+            are set to zero.
+            Lock-free and wait-free. Meant for one consumer only,
+            if called from two threads at the same time,
+            the second call returns silence.
+            Returns the number of frames read from the buffer. */
+        size_t read(F32 * buffer, size_t frame, size_t num);
+
+        /** Tells the I/O thread to start reading ahead from @p frame,
+            e.g. before jumping to a new playback position. Lock-free. */
+        void prefetch(size_t frame);
+
+    private:
+        struct Private;
+        Private * p_;
+    };
+
+    // ----------- engine -------------
+
+    /** Sizes the prefetch buffers of subsequently opened streams
+        to the sample rate and buffer size of @p conf. */
+    static void setConfiguration(const Configuration& conf);
+
+    /** Sets the minimum read-ahead time in seconds.
+        Applies to subsequently opened streams. Default is 2 seconds. */
+    static void setPrefetchSeconds(Double seconds);
+
+    /** Opens the file and starts prefetching from the beginning.
+        @throws IoException on errors */
+    static Stream * openStream(const QString& filename);
+
+    /** Stops prefetching and deletes the stream.
+        Does not wait for the I/O thread, the stream is deleted
+        by the I/O thread after its current pass. */
+    static void closeStream(Stream * stream);
+
+    /** Number of underruns in all streams, including closed ones */
+    static uint64_t numUnderruns();
+
+    /** Number of currently open streams */
+    static size_t numStreams();
+
+    /** Stops the I/O thread and deletes the engine.
+        Open streams stop prefetching but can still be closed. */
+    static void shutDown();
+
+private:
+
+    static SoundFileStreamer * p_getInstance_();
+    /** Wakes up the I/O thread if the engine exists */
+    static void p_wake_();
+    static SoundFileStreamer * p_instance_;
+
+    struct Private;
+    Private * p_;
+};
+
+} // namespace AUDIO
+} // namespace MO
+
+#endif // MOSRC_AUDIO_TOOL_SOUNDFILESTREAMER_H
@@ -133,6 +133,18 @@ void SynthVoice::setUserData(void *data) { p_->data = data; }
 
 // ------------------------------------ synth private ------------------------------------
 
+namespace {
+
+    /** Number of samples between filter coefficient updates
+        when the filter envelope is used */
+    const uint filterEnvelopeBlockSize = 8;
+
+    /** Size of the scratch buffers, voices are rendered in chunks
+        of this size. Must be a multiple of filterEnvelopeBlockSize. */
+    const uint renderBlockSize = 256;
+
+} // namespace
+
 class Synth::Private
 {
 public:
@@ -163,7 +175,9 @@ public:
           waveform      (Waveform::T_SINE),
           filterType    (MultiFilter::T_BYPASS),
           cbStart_      (0),
-          cbEnd_        (0)
+          cbEnd_        (0),
+          bufOsc        (renderBlockSize),
+          bufEnv        (renderBlockSize)
     {
         setNumVoices(4);
     }
@@ -204,6 +218,26 @@ public:
     /** Multichannel output */
     void process(F32 ** output, uint bufferLength);
 
+    /** Starts the voice if it is cued and its start sample is within the buffer.
+        Returns the first sample to render, or @p bufferLength if the voice
+        is not active.
+        A stolen voice that is still active is not rendered before its
+        start sample, so the tail of its previous note is dropped.
+        The multi-channel path always did this, the old per-sample mono
+        loop played the tail until the start sample. */
+    uint startVoice(SynthVoice * voice, uint bufferLength);
+    /** Renders @p num samples of an active voice into @p output.
+        In @p mono mode, the voice is added to @p output and the envelope is
+        applied after the filter, otherwise @p output is overwritten and the
+        envelope is applied before the filter.
+        Returns the number of samples rendered, which is less than @p num
+        when the envelope has ended. */
+    uint renderVoice(SynthVoice::Private * v, F32 * output, uint num, bool mono);
+    /** renderVoice() for at most renderBlockSize samples */
+    uint renderVoiceChunk(SynthVoice::Private * v, F32 * output, uint num, bool mono);
+    /** Filters the block, with filter envelope at control-rate */
+    void filterVoice(SynthVoice::Private * v, F32 * buffer, uint num);
+
     Synth * synth;
 
     std::vector<SynthVoice*> voices;
@@ -225,9 +259,14 @@ public:
 
     std::function<void(SynthVoice*)>
         cbStart_, cbEnd_;
+
+    // scratch buffers for one voice, renderBlockSize each
+    std::vector<F32> bufOsc;
+    std::vector<Double> bufEnv;
 };
 
 
+
 SynthVoice * Synth::Private::noteOn(uint startSample, Double freq, int note, Float velocity,
                                     uint numCombinedUnison, void * userData)
 {
@@ -418,183 +457,175 @@ void Synth::Private::panic()
     }
 }
 
-void Synth::Private::process(F32 *output, uint bufferLength)
+uint Synth::Private::startVoice(SynthVoice * voice, uint bufferLength)
 {
-    memset(output, 0, sizeof(F32) * bufferLength);
+    SynthVoice::Private * v = voice->p_;
 
-    // for each sample
-    for (uint sample = 0; sample < bufferLength; ++sample, ++output)
+    if (v->cued)
     {
-        // for each voice
-        for (SynthVoice * i : voices)
-        {
-            SynthVoice::Private * v = i->p_;
+        v->cued = false;
 
-            // start cued voice
-            if (v->cued && v->startSample == sample)
-            {
-                v->env.trigger();
-                if (v->fenvAmt)
-                    v->fenv.trigger();
-                v->active = true;
-                v->cued = false;
-                if (cbStart_)
-                    cbStart_(i);
-            }
+        // if startsample is out of range
+        // don't check again
+        if (v->startSample >= bufferLength)
+            return bufferLength;
 
-            if (!v->active)
-                continue;
+        MO_DEBUG_SYNTH("start cued voice " << v->index << " s=" << v->startSample);
 
-            // count number of samples alive
-            ++(v->lifetime);
+        v->env.trigger();
+        if (v->fenvAmt)
+            v->fenv.trigger();
+        v->active = true;
+        // send callback
+        if (cbStart_)
+            cbStart_(voice);
 
-            F32 s = 0.0;
-            for (uint j = 0; j<v->phase.size(); ++j)
-            {
-                // advance phase counter
-                v->phase[j] += v->freq_c[j];
-                // get sample
-                s += Waveform::waveform(v->phase[j], v->waveform, v->pw);
-            }
+        return v->startSample;
+    }
 
-            // filter
-            if (v->filter.type() != MultiFilter::T_BYPASS)
-                v->filter.process(&s, &s, 1);
+    return v->active ? 0 : bufferLength;
+}
 
-            // put into buffer
-            *output += s * volume * v->velo * v->env.value();
+uint Synth::Private::renderVoice(SynthVoice::Private * v, F32 * output, uint num, bool mono)
+{
+    uint pos = 0;
+    while (pos < num)
+    {
+        const uint n = std::min(renderBlockSize, num - pos),
+                   rendered = renderVoiceChunk(v, output + pos, n, mono);
+        pos += rendered;
+        // envelope ended
+        if (rendered < n)
+            break;
+    }
+    return pos;
+}
 
-            // process envelope
-            v->env.next();
-            // check for end of envelope
-            if (!v->env.active())
-            {
-                v->active = false;
-                if (cbEnd_)
-                    cbEnd_(i);
-                continue;
-            }
+uint Synth::Private::renderVoiceChunk(SynthVoice::Private * v, F32 * output, uint num, bool mono)
+{
+    F32 * osc = &bufOsc[0];
+    Double * env = &bufEnv[0];
 
-            // process filter envelope
-            if (v->filter.type() != MultiFilter::T_BYPASS && v->fenvAmt != 0)
-            {
-                v->filter.setFrequency(v->filterFreq + v->fenvAmt * v->fenv.next());
-                v->filter.updateCoefficients();
-            }
-        }
+    // envelope first, it determines the end of the voice
+    num = v->env.processUntilStop(env, num);
+
+    // oscillators
+    memset(osc, 0, sizeof(F32) * num);
+    for (uint j = 0; j<v->phase.size(); ++j)
+        Waveform::addWaveform(osc, num, v->phase[j], v->freq_c[j], v->waveform, v->pw);
+
+    if (mono)
+    {
+        filterVoice(v, osc, num);
+
+        for (uint i=0; i<num; ++i)
+            output[i] += osc[i] * volume * v->velo * env[i];
+    }
+    else
+    {
+        for (uint i=0; i<num; ++i)
+            osc[i] *= env[i];
+
+        filterVoice(v, osc, num);
+
+        for (uint i=0; i<num; ++i)
+            output[i] = osc[i] * volume * v->velo;
     }
+
+    return num;
 }
 
-void Synth::Private::process(F32 ** outputs, uint bufferLength)
+void Synth::Private::filterVoice(SynthVoice::Private * v, F32 * buffer, uint num)
 {
-    // for each voice
-    for (uint voicenum = 0; voicenum < voices.size(); ++voicenum)
+    if (v->filter.type() == MultiFilter::T_BYPASS)
+        return;
+
+    if (v->fenvAmt == 0)
     {
-        F32 * output = outputs[voicenum];
-        if (!output)
-            continue;
+        v->filter.process(buffer, buffer, num);
+        return;
+    }
 
-        SynthVoice::Private * v = voices[voicenum]->p_;
+    // process filter envelope
+    for (uint pos = 0; pos < num; pos += filterEnvelopeBlockSize)
+    {
+        const uint n = std::min(filterEnvelopeBlockSize, num - pos);
+        v->filter.process(buffer + pos, buffer + pos, n);
 
-        // if voice is inactive (and won't become active)
-        if (!v->active && !v->cued)
-        {
-            //MO_DEBUG_SYNTH("unused " << v->index);
+        Double f = 0.;
+        for (uint i=0; i<n; ++i)
+            f = v->fenv.next();
+        v->filter.setFrequency(v->filterFreq + v->fenvAmt * f);
+        v->filter.updateCoefficients();
+    }
+}
+
+void Synth::Private::process(F32 *output, uint bufferLength)
+{
+    memset(output, 0, sizeof(F32) * bufferLength);
 
-            // clear output buffer
-            memset(output, 0, sizeof(F32) * bufferLength);
+    // for each voice
+    for (SynthVoice * i : voices)
+    {
+        SynthVoice::Private * v = i->p_;
 
+        const uint start = startVoice(i, bufferLength);
+        if (start >= bufferLength)
             continue;
-        }
 
-        // where to start rendering
-        uint start = 0;
+        const uint num = renderVoice(v, output + start, bufferLength - start, true);
 
-        // start voice?
-        if (v->cued)
-        {
-            if (v->startSample < bufferLength)
-            {
-                MO_DEBUG_SYNTH("start cued voice " << v->index << " s=" << v->startSample);
-
-                // start at specified start-sample
-                start = v->startSample;
-                v->env.trigger();
-                if (v->fenvAmt)
-                    v->fenv.trigger();
-                v->active = true;
-                v->cued = false;
-                // send callback
-                if (cbStart_)
-                    cbStart_(voices[voicenum]);
-
-                // clear first part of buffer
-                memset(output, 0, sizeof(F32) * start);
-                output += start;
-            }
-            else
-            {
-                // if startsample is out of range
-                // don't check again
-                v->cued = false;
-                continue;
-            }
-        }
-
-        //MO_DEBUG("process " << v->index << " " << start << "-" << bufferLength);
+        // count number of samples alive
+        v->lifetime += num;
 
-        // for each sample
-        for (uint sample = start; sample < bufferLength; ++sample, ++output)
+        // check for end of envelope
+        if (num < bufferLength - start)
         {
-            // get oscillator sample
-            F32 s = 0.0;
-            for (uint j = 0; j<v->phase.size(); ++j)
-            {
-                // advance phase counter
-                v->phase[j] += v->freq_c[j];
-                // get sample
-                s += Waveform::waveform(v->phase[j], v->waveform, v->pw);
-            }
+            MO_DEBUG_SYNTH("voice end " << v->index << " s=" << (start + num - 1));
 
-            // envelope before filter
-            s *= v->env.value();
+            v->active = false;
+            if (cbEnd_)
+                cbEnd_(i);
+        }
+    }
+}
 
-            // filter
-            // TODO: For non-enveloped filters,
-            //       we could process the whole buffer at once
-            if (v->filter.type() != MultiFilter::T_BYPASS)
-                v->filter.process(&s, &s, 1);
+void Synth::Private::process(F32 ** outputs, uint bufferLength)
+{
+    // for each voice
+    for (uint voicenum = 0; voicenum < voices.size(); ++voicenum)
+    {
+        F32 * output = outputs[voicenum];
+        if (!output)
+            continue;
 
-            // put into buffer
-            *output = s * volume * v->velo;
+        SynthVoice::Private * v = voices[voicenum]->p_;
 
-            // process envelope
-            v->env.next();
-            // check for end of envelope
-            if (!v->env.active())
-            {
-                MO_DEBUG_SYNTH("voice end " << v->index << " s=" << sample);
-
-                v->active = false;
-                // clear rest of buffer
-                if (sample < bufferLength - 1)
-                    memset(output+1, 0, sizeof(F32) * (bufferLength - sample - 1));
-                // send callback
-                if (cbEnd_)
-                    cbEnd_(voices[voicenum]);
-                break;
-            }
+        // where to start rendering
+        const uint start = startVoice(voices[voicenum], bufferLength);
 
-            // process filter envelope
-            if (v->filter.type() != MultiFilter::T_BYPASS && v->fenvAmt != 0)
-            {
-                v->filter.setFrequency(v->filterFreq + v->fenvAmt * v->fenv.next());
-                v->filter.updateCoefficients();
-            }
-        }
+        // clear first part of buffer (or all for inactive voices)
+        memset(output, 0, sizeof(F32) * start);
+        if (start >= bufferLength)
+            continue;
+
+        const uint num = renderVoice(v, output + start, bufferLength - start, false);
 
         // count number of samples alive
         v->lifetime += bufferLength - start;
+
+        // check for end of envelope
+        if (num < bufferLength - start)
+        {
+            MO_DEBUG_SYNTH("voice end " << v->index << " s=" << (start + num - 1));
+
+            v->active = false;
+            // clear rest of buffer
+            memset(output + start + num, 0, sizeof(F32) * (bufferLength - start - num));
+            // send callback
+            if (cbEnd_)
+                cbEnd_(voices[voicenum]);
+        }
     }
 }
 
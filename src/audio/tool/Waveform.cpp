@@ -284,6 +284,60 @@ Double Waveform::waveform(Double t, Type type, Double pw, Double sm)
 
 
 
+void Waveform::addWaveform(F32 * output, uint num,
+                           Double& phase, Double inc, Type type, Double pw)
+{
+    // one loop per type, keeps the switch out of the sample loop
+    #define MO__WAVE_LOOP(expr__) \
+        for (uint i=0; i<num; ++i) \
+        { \
+            const Double t = phase += inc; \
+            output[i] += (expr__); \
+        }
+
+    switch (type)
+    {
+        case T_SINE:
+            MO__WAVE_LOOP( std::sin( t * TWO_PI ) );
+        break;
+
+        case T_COSINE:
+            MO__WAVE_LOOP( std::cos( t * TWO_PI ) );
+        break;
+
+        case T_RAMP:
+            MO__WAVE_LOOP( MATH::moduloSigned( t, 1.0 ) );
+        break;
+
+        case T_SAW_RISE:
+            MO__WAVE_LOOP( -1.0 + 2.0 * MATH::moduloSigned( t, 1.0 ) );
+        break;
+
+        case T_SAW_DECAY:
+            MO__WAVE_LOOP( 1.0 - 2.0 * MATH::moduloSigned( t, 1.0 ) );
+        break;
+
+        case T_TRIANGLE:
+            for (uint i=0; i<num; ++i)
+            {
+                const Double p = MATH::moduloSigned(phase += inc, 1.0);
+                output[i] += (p<pw)? p * 2.0/pw - 1.0 : (1.0-p) * 2.0/(1.0-pw) - 1.0;
+            }
+        break;
+
+        case T_SQUARE:
+            MO__WAVE_LOOP( (MATH::moduloSigned( t, 1.0 ) >= pw) ? -1.0 : 1.0 );
+        break;
+
+        default:
+            MO__WAVE_LOOP( waveform(t, type, pw) );
+        break;
+    }
+
+    #undef MO__WAVE_LOOP
+}
+
+
 Double Waveform::spectralWave(
                         Double time,
                         Double numPartials,
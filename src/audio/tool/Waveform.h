@@ -92,6 +92,15 @@ class Waveform
         @see supportsPulseWidth(), supportsSmooth() */
     static Double waveform(Double time, Type type, Double pulseWidth, Double smooth);
 
+    /** Adds @p num samples of the waveform to @p output.
+        For each sample, @p phase is advanced by @p phaseInc before
+        the waveform is evaluated, the same as calling
+        waveform(phase += phaseInc, type, pulseWidth) for each sample.
+        @note pulseWidth must be between minPulseWidth() and maxPulseWidth() ! */
+    static void addWaveform(F32 * output, uint num,
+                            Double& phase, Double phaseInc,
+                            Type type, Double pulseWidth);
+
     /** Generic additive sine wave function */
     static Double spectralWave(Double time,
                                Double numPartials,
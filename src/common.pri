@@ -23,6 +23,7 @@ HEADERS += \
     src/math/funcparser/parser.h \
     src/math/funcparser/parser_defines.h \
     src/math/funcparser/parser_program.h \
+    src/math/funcparser/parser_batch.h \
     src/tool/enumnames.h \
     src/io/memory.h \
     src/types/int.h \
@@ -101,6 +102,7 @@ HEADERS += \
     $$PWD/audio/tool/ButterworthFilter.h \
     $$PWD/audio/tool/ChebychevFilter.h \
     $$PWD/audio/tool/ConvolveBuffer.h \
+    $$PWD/audio/tool/PartitionedConvolver.h \
     $$PWD/audio/tool/Delay.h \
     $$PWD/audio/tool/DumbFile.h \
     $$PWD/audio/tool/EnvelopeFollower.h \
@@ -118,6 +120,7 @@ HEADERS += \
     $$PWD/audio/tool/SoundFile.h \
     $$PWD/audio/tool/SoundFileIStream.h \
     $$PWD/audio/tool/SoundFileManager.h \
+    $$PWD/audio/tool/SoundFileStreamer.h \
     $$PWD/audio/tool/Synth.h \
     $$PWD/audio/tool/Waveform.h \
     $$PWD/audio/tool/Wavetable.h \
@@ -138,11 +141,13 @@ HEADERS += \
     $$PWD/geom/BuiltinLineFont.h \
     $$PWD/geom/FreeCamera.h \
     $$PWD/geom/Geometry.h \
+    $$PWD/geom/GeometryBvh.h \
     $$PWD/geom/GeometryCreator.h \
     $$PWD/geom/GeometryFactory.h \
     $$PWD/geom/GeometryFactorySettings.h \
     $$PWD/geom/GeometryModifier.h \
     $$PWD/geom/GeometryModifierAngelscript.h \
+    $$PWD/geom/GeometryModifierCache.h \
     $$PWD/geom/GeometryModifierChain.h \
     $$PWD/geom/GeometryModifierConvertlines.h \
     $$PWD/geom/GeometryModifierCreate.h \
@@ -193,6 +198,7 @@ HEADERS += \
     $$PWD/gl/Shader.h \
     $$PWD/gl/ShaderSource.h \
     $$PWD/gl/Texture.h \
+    $$PWD/gl/TextureLoader.h \
     $$PWD/gl/TextureRenderer.h \
     $$PWD/gl/VertexArrayObject.h \
     $$PWD/gl/Window.h \
@@ -233,11 +239,14 @@ HEADERS += \
     $$PWD/math/Fft.h \
     $$PWD/math/OouraFft.h \
     $$PWD/math/FftWindow.h \
+    $$PWD/math/Frustum.h \
     $$PWD/math/InterpolationType.h \
     $$PWD/math/KalisetEvolution.h \
+    $$PWD/math/MinMaxPyramid.h \
     $$PWD/math/NoisePerlin.h \
     $$PWD/math/Polygon.h \
     $$PWD/math/Timeline1d.h \
+    $$PWD/math/Timeline1dCompiled.h \
     $$PWD/math/TimelinePoint.h \
     $$PWD/math/TimelineNd.h \
     $$PWD/math/TransformationBuffer.h \
@@ -250,13 +259,21 @@ HEADERS += \
     $$PWD/model/Python34Model.h \
     $$PWD/model/QObjectTreeModel.h \
     $$PWD/network/ClientState.h \
+    $$PWD/network/ClockSync.h \
     $$PWD/network/EventCom.h \
+    $$PWD/network/FileManifest.h \
+    $$PWD/network/FileServer.h \
+    $$PWD/network/FileTransfer.h \
     $$PWD/network/NetEvent.h \
     $$PWD/network/NetworkManager.h \
     $$PWD/network/OscInput.h \
     $$PWD/network/OscInputs.h \
+    $$PWD/network/SceneDelta.h \
+    $$PWD/network/SceneDeltaRecorder.h \
     $$PWD/network/TcpServer.h \
     $$PWD/network/UdpAudioConnection.h \
+    $$PWD/network/UdpAudioFrame.h \
+    $$PWD/network/UdpAudioJitterBuffer.h \
     $$PWD/network/UdpConnection.h \
     $$PWD/projection/CameraSettings.h \
     $$PWD/projection/DomeSettings.h \
@@ -299,6 +316,7 @@ HEADERS += \
     $$PWD/python/mo3.h \
     $$PWD/python/py_mo_helper.h \
     $$PWD/video/ffm/VideoStream.h \
+    $$PWD/video/ffm/VideoEncoder.h \
     $$PWD/gl/VideoTextureBuffer.h \
     $$PWD/video/DecoderThread.h \
     $$PWD/video/AudioFrame.h \
@@ -361,6 +379,7 @@ SOURCES += \
     $$PWD/audio/tool/ButterworthFilter.cpp \
     $$PWD/audio/tool/ChebychevFilter.cpp \
     $$PWD/audio/tool/ConvolveBuffer.cpp \
+    $$PWD/audio/tool/PartitionedConvolver.cpp \
     $$PWD/audio/tool/DumbFile.cpp \
     $$PWD/audio/tool/EnvelopeFollower.cpp \
     $$PWD/audio/tool/Filter24.cpp \
@@ -371,6 +390,7 @@ SOURCES += \
     $$PWD/audio/tool/SoundFile.cpp \
     $$PWD/audio/tool/SoundFileIStream.cpp \
     $$PWD/audio/tool/SoundFileManager.cpp \
+    $$PWD/audio/tool/SoundFileStreamer.cpp \
     $$PWD/audio/tool/Synth.cpp \
     $$PWD/audio/tool/Waveform.cpp \
     $$PWD/audio/tool/WavetableGenerator.cpp \
@@ -390,11 +410,13 @@ SOURCES += \
     $$PWD/geom/BuiltinLineFont.cpp \
     $$PWD/geom/FreeCamera.cpp \
     $$PWD/geom/Geometry.cpp \
+    $$PWD/geom/GeometryBvh.cpp \
     $$PWD/geom/GeometryCreator.cpp \
     $$PWD/geom/GeometryFactory.cpp \
     $$PWD/geom/GeometryFactorySettings.cpp \
     $$PWD/geom/GeometryModifier.cpp \
     $$PWD/geom/GeometryModifierAngelscript.cpp \
+    $$PWD/geom/GeometryModifierCache.cpp \
     $$PWD/geom/GeometryModifierChain.cpp \
     $$PWD/geom/GeometryModifierConvertLines.cpp \
     $$PWD/geom/GeometryModifierCreate.cpp \
@@ -444,6 +466,7 @@ SOURCES += \
     $$PWD/gl/Shader.cpp \
     $$PWD/gl/ShaderSource.cpp \
     $$PWD/gl/Texture.cpp \
+    $$PWD/gl/TextureLoader.cpp \
     $$PWD/gl/TextureRenderer.cpp \
     $$PWD/gl/VertexArrayObject.cpp \
     $$PWD/gl/Window.cpp \
@@ -480,12 +503,15 @@ SOURCES += \
     $$PWD/math/CubemapMatrix.cpp \
     $$PWD/math/Fft.cpp \
     $$PWD/math/OouraFft.cpp \
+    $$PWD/math/Frustum.cpp \
     $$PWD/math/KalisetEvolution.cpp \
     $$PWD/math/NoisePerlin.cpp \
     $$PWD/math/Polygon.cpp \
     $$PWD/math/Timeline1d.cpp \
+    $$PWD/math/Timeline1dCompiled.cpp \
     $$PWD/math/TimelinePoint.cpp \
     $$PWD/math/TimelineNd.cpp \
+    $$PWD/math/TransformationBuffer.cpp \
     $$PWD/model/CsgTreeModel.cpp \
     $$PWD/model/EvolutionMimeData.cpp \
     $$PWD/model/jsonTreeModel.cpp \
@@ -495,13 +521,21 @@ SOURCES += \
     $$PWD/model/Python34Model.cpp \
     $$PWD/model/QObjectTreeModel.cpp \
     $$PWD/network/ClientState.cpp \
+    $$PWD/network/ClockSync.cpp \
     $$PWD/network/EventCom.cpp \
+    $$PWD/network/FileManifest.cpp \
+    $$PWD/network/FileServer.cpp \
+    $$PWD/network/FileTransfer.cpp \
     $$PWD/network/NetEvent.cpp \
     $$PWD/network/NetworkManager.cpp \
     $$PWD/network/OscInput.cpp \
     $$PWD/network/OscInputs.cpp \
+    $$PWD/network/SceneDelta.cpp \
+    $$PWD/network/SceneDeltaRecorder.cpp \
     $$PWD/network/TcpServer.cpp \
     $$PWD/network/UdpAudioConnection.cpp \
+    $$PWD/network/UdpAudioFrame.cpp \
+    $$PWD/network/UdpAudioJitterBuffer.cpp \
     $$PWD/network/UdpConnection.cpp \
     $$PWD/projection/CameraSettings.cpp \
     $$PWD/projection/DomeSettings.cpp \
@@ -526,6 +560,7 @@ SOURCES += \
     $$PWD/types/Refcounted.cpp \
     $$PWD/video/VideoStreamReader.cpp \
     $$PWD/video/ffm/VideoStream.cpp \
+    $$PWD/video/ffm/VideoEncoder.cpp \
     $$PWD/mainCommandLine.cpp \
     $$PWD/math/Fraction.cpp \
     $$PWD/tool/ProgressInfo.cpp \
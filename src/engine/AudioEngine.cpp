@@ -16,7 +16,9 @@
 #include "audio/Configuration.h"
 #include "audio/tool/AudioBuffer.h"
 #include "audio/tool/EnvelopeFollower.h"
+#include "audio/tool/SoundFileStreamer.h"
 #include "io/time.h"
+#include "io/Settings.h"
 #include "io/error.h"
 #include "io/log.h"
 
@@ -36,7 +38,7 @@ public:
           isPathPrepared(false)
     { }
 
-    void setup();
+    void setup(bool assignBuffers);
 
     AudioEngine * engine;
     Scene * scene;
@@ -105,21 +107,26 @@ void AudioEngine::seek(SamplePos pos)
     p_->curSample = pos;
 }
 
-void AudioEngine::setScene(Scene * s, const AUDIO::Configuration & conf, uint thread)
+void AudioEngine::setScene(Scene * s, const AUDIO::Configuration & conf, uint thread,
+                           bool assignBuffers)
 {
     MO_ASSERT(s, "null assignment");
     p_->isPathPrepared = false;
     p_->conf = conf;
     p_->scene = s;
+    AUDIO::SoundFileStreamer::setConfiguration(conf);
     p_->threadIdx = thread;
-    p_->setup();
+    p_->setup(assignBuffers);
 }
 
-void AudioEngine::Private::setup()
+void AudioEngine::Private::setup(bool assignBuffers)
 {
     MO_DEBUG("AudioEngine::setup()");
 
-    path.createPath(scene, conf, threadIdx);
+    path.setNumberDspThreads(settings()->value("Audio/dspThreads").toInt());
+    path.setTransformationDecimation(
+                settings()->value("Audio/transformDecimation").toInt());
+    path.createPath(scene, conf, threadIdx, assignBuffers);
 
     // setup envelope followers
     envs.resize(path.audioOutputs().size());
@@ -53,10 +53,16 @@ signals:
 public slots:
 
     /** Creates the dsp path for the given scene.
-        @p thread is the thread-index for which to query Parameters in the scene. */
-    void setScene(Scene *, const AUDIO::Configuration&, uint thread);
-
-    /** Currently used for creating the udp objects for clients */
+        @p thread is the thread-index for which to query Parameters in the scene.
+        If @p assignBuffers is false, the AudioObjects are not touched until
+        prepareUdp(), see ObjectDspPath::createPath(). */
+    void setScene(Scene *, const AUDIO::Configuration&, uint thread,
+                  bool assignBuffers = true);
+
+    /** Assigns the buffers that have been deferred by setScene()
+        and creates the udp objects for clients.
+        Called before processing, from the thread that created the path,
+        while no other path of the scene is processed. */
     void prepareUdp();
 
     /** Seeks to a certain position in the scene */
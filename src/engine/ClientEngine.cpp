@@ -10,6 +10,7 @@
 
 #include <QTcpSocket>
 #include <QUrl>
+#include <QTimer>
 
 #include "ClientEngine.h"
 #include "ClientEngineCommandLine.h"
@@ -22,6 +23,8 @@
 //#include "network/NetworkManager.h"
 #include "network/NetEvent.h"
 #include "network/Client.h"
+#include "network/ClockSync.h"
+#include "network/SceneDelta.h"
 #include "projection/ProjectionSystemSettings.h"
 #include "gui/InfoWindow.h"
 #include "gl/Manager.h"
@@ -35,6 +38,7 @@
 #include "io/version.h"
 #include "io/memory.h"
 #include "io/CurrentTime.h"
+#include "io/time.h"
 #include "io/Application.h"
 #include "io/error.h"
 #include "io/log.h"
@@ -55,6 +59,9 @@ ClientEngine & clientEngine()
 
 double ClientEngine::curTime() const
 {
+    if (clockSync_->hasSceneTime())
+        return clockSync_->sceneTime(systemTime());
+
     return CurrentTime::time();
 }
 
@@ -65,8 +72,13 @@ ClientEngine::ClientEngine(QObject *parent) :
     glWindow_   (0),
     infoWindow_ (0),
     client_     (0),
+    clockSync_  (new ClockSync()),
+    syncTimer_  (new QTimer(this)),
+    numSyncs_   (0),
     scene_      (0),
     nextScene_  (0),
+    sceneVersion_(0),
+    isSceneRequested_(false),
     audioEngine_(0),
     audioConfig_(44100, 256, 0, 2),
     cl_         (new ClientEngineCommandLine(this)),
@@ -76,6 +88,9 @@ ClientEngine::ClientEngine(QObject *parent) :
 
     connect(&NetworkLogger::instance(), SIGNAL(textAdded(int, QString)),
             this, SLOT(onNetLog_(int, QString)));
+
+    syncTimer_->setSingleShot(false);
+    connect(syncTimer_, SIGNAL(timeout()), this, SLOT(sendClockSync_()));
 }
 
 ClientEngine::~ClientEngine()
@@ -85,6 +100,8 @@ ClientEngine::~ClientEngine()
     if (nextScene_)
         nextScene_->releaseRef("ClientEngine destructor");
 
+    delete clockSync_;
+
 //    if (scene_)
 //        scene_->kill();
 }
@@ -96,6 +113,11 @@ bool ClientEngine::isRunning() const
     return client_ && client_->isRunning();
 }
 
+QHostAddress ClientEngine::serverAddress() const
+{
+    return client_ ? client_->serverAddress() : QHostAddress();
+}
+
 int ClientEngine::run(int argc, char ** argv, int skip)
 {
     // stats
@@ -204,6 +226,10 @@ void ClientEngine::startNetwork_()
 
     connect(&IO::fileManager(), SIGNAL(finished()),
             this, SLOT(onFilesNotReady_()));
+
+    // report transfer progress to server
+    connect(&IO::clientFiles(), SIGNAL(transferProgress()),
+            this, SLOT(sendState_()));
 }
 
 void ClientEngine::onNetLog_(int level, const QString &text)
@@ -309,6 +335,32 @@ void ClientEngine::onConnected_()
 {
     MO_NETLOG(DEBUG, "ClientEngine connected :D");
     IO::clientFiles().updateCache();
+
+    // start clock synchronisation with a few quick round-trips
+    clockSync_->reset();
+    numSyncs_ = 0;
+    syncTimer_->start(100);
+}
+
+void ClientEngine::sendClockSync_()
+{
+    if (!isRunning())
+    {
+        syncTimer_->stop();
+        return;
+    }
+
+    auto e = new NetEventClockSync();
+    e->setClientSendTime(systemTime());
+    client_->sendEvent(e);
+
+    ++numSyncs_;
+    if (numSyncs_ == 8)
+        syncTimer_->start(1000);
+
+    // report sync quality every few seconds
+    if (numSyncs_ % 5 == 0)
+        sendState_();
 }
 
 void ClientEngine::onNetEvent_(AbstractNetEvent * event)
@@ -418,9 +470,19 @@ void ClientEngine::onNetEvent_(AbstractNetEvent * event)
         return;
     }
 
+    if (NetEventClockSync * e = netevent_cast<NetEventClockSync>(event))
+    {
+        clockSync_->addRoundTrip(e->clientSendTime(), e->serverReceiveTime(),
+                                 e->serverSendTime(), systemTime());
+        return;
+    }
+
     if (NetEventTime * e = netevent_cast<NetEventTime>(event))
     {
+        clockSync_->addSceneTime(e->time(), e->serverTime(), e->isPlaying(),
+                                 systemTime());
         CurrentTime::setTime(e->time());
+        // the render thread follows curTime() on its own while playing
         render_();
         return;
     }
@@ -429,13 +491,23 @@ void ClientEngine::onNetEvent_(AbstractNetEvent * event)
     {
         Scene * scene = e->getScene();
         if (scene)
+        {
+            sceneVersion_ = e->version();
+            isSceneRequested_ = false;
             onSceneReceived_(scene);
+        }
         else
             MO_NETLOG(ERROR, "received invalid Scene object");
         // XXX Need to reflect this in ClientState
         return;
     }
 
+    if (NetEventSceneDelta * e = netevent_cast<NetEventSceneDelta>(event))
+    {
+        applySceneDelta_(e);
+        return;
+    }
+
     if (NetEventAudioConfig * e = netevent_cast<NetEventAudioConfig>(event))
     {
         setAudioConfig(e->config());
@@ -541,6 +613,8 @@ bool ClientEngine::loadSceneFile_(const QString &fn)
             return false;
         }
         setSceneObject(scene);
+        // edits from the server can not be applied to this one
+        sceneVersion_ = 0;
         return true;
     }
     catch (const Exception& e)
@@ -626,6 +700,58 @@ void ClientEngine::onSceneReceived_(Scene * scene)
     }
 }
 
+void ClientEngine::applySceneDelta_(NetEventSceneDelta * e)
+{
+    // the requested scene will contain these edits
+    if (isSceneRequested_)
+        return;
+
+    // a scene waiting for its files is edited as well
+    Scene * scene = nextScene_ ? nextScene_ : scene_;
+
+    if (scene && sceneVersion_ && e->baseVersion() == sceneVersion_)
+    {
+        SceneDelta delta;
+        QString error;
+        IO::FileList files;
+        if (e->getDelta(delta) && delta.apply(scene, &error, &files))
+        {
+            sceneVersion_ = e->version();
+
+            if (scene == scene_)
+            {
+                if (delta.isStructural() && audioEngine_)
+                {
+                    audioEngine_->setScene(scene_, audioConfig_, MO_AUDIO_THREAD);
+                    audioEngine_->prepareUdp();
+                }
+                render_();
+            }
+
+            if (!files.isEmpty())
+            {
+                IO::fileManager().addFilenames(files);
+                IO::fileManager().acquireFiles();
+            }
+            return;
+        }
+
+        MO_NETLOG(WARNING, "could not apply scene edits v" << e->baseVersion()
+                  << "->" << e->version() << ": " << error);
+    }
+    else
+        MO_NETLOG(EVENT, "scene version mismatch, have v" << sceneVersion_
+                  << ", received edits for v" << e->baseVersion());
+
+    // fall back to the whole scene
+    sceneVersion_ = 0;
+    isSceneRequested_ = true;
+
+    auto r = new NetEventRequest();
+    r->setRequest(NetEventRequest::GET_SCENE);
+    sendEvent(r);
+}
+
 void ClientEngine::onFilesReady_()
 {
     isFilesReady_ = true;
@@ -673,15 +799,24 @@ void ClientEngine::sendState_()
     state.state_.isPlayback_ = scene_ && glManager_ && glManager_->isAnimating();
     state.state_.isFilesReady_ = isFilesReady_;
     state.state_.cacheSize_ = IO::clientFiles().cacheSize();
+    state.state_.filesPending_ = IO::clientFiles().numPendingFiles();
+    state.state_.transferBytes_ = IO::clientFiles().transferBytes();
+    state.state_.transferTotal_ = IO::clientFiles().transferTotal();
+    state.state_.transferRate_ = IO::clientFiles().transferRate();
     state.state_.memory_ = Memory::allocated();
     state.state_.outputSize_ = scene_ ? scene_->outputSize() : QSize();
+    state.state_.clockOffset_ = clockSync_->offset();
+    state.state_.clockDrift_ = clockSync_->drift();
+    state.state_.roundTrip_ = clockSync_->roundTrip();
+    state.state_.frameSkew_ = clockSync_->frameSkew();
+    state.state_.maxFrameSkew_ = clockSync_->maxFrameSkew();
     client_->sendEvent(state);
 }
 
 void ClientEngine::render_()
 {
-    if (glWindow_ && scene_)//YYY && !scene_->isPlayback())
-        glWindow_->renderLater();
+    if (glManager_ && scene_ && !glManager_->isAnimating())
+        glManager_->render();
 }
 
 } // namespace MO
@@ -12,6 +12,9 @@
 #define MOSRC_ENGINE_CLIENT_H
 
 #include <QObject>
+#include <QHostAddress>
+
+class QTimer;
 
 #include "gl/opengl_fwd.h"
 #include "network/network_fwd.h"
@@ -37,6 +40,9 @@ ClientEngine & clientEngine();
     The client engine basically creates an GL::Manager and GL::Window,
     a network Client and connects all the signals.
 
+    The GL::Manager renders on its own timer. The scene time for each
+    frame is predicted by a ClockSync from the server's time events
+    and regular round-trip measurements.
  */
 class ClientEngine : public QObject
 {
@@ -47,9 +53,13 @@ public:
 
     bool isRunning() const;
 
+    /** Address of the connected server */
+    QHostAddress serverAddress() const;
+
     /** Runs the complete client event loop */
     int run(int argc, char ** argv, int skip);
 
+    /** Returns the predicted server scene time */
     Double curTime() const;
 
 signals:
@@ -83,6 +93,9 @@ private slots:
     /** Renders the scene if not running */
     void render_();
 
+    /** Sends a NetEventClockSync to server */
+    void sendClockSync_();
+
 
 private:
 
@@ -95,14 +108,22 @@ private:
     void setPlayback_(bool play);
     void setClientIndex_(int index);
     void setNextScene_();
+    /** Applies the edits or requests the whole scene */
+    void applySceneDelta_(NetEventSceneDelta*);
 
     GL::Manager * glManager_;
     GL::Window * glWindow_;
     GUI::InfoWindow * infoWindow_;
 
     Client * client_;
+    ClockSync * clockSync_;
+    QTimer * syncTimer_;
+    int numSyncs_;
 
     Scene * scene_, * nextScene_;
+    /** Version of the last scene or edits received, 0 for unknown */
+    quint32 sceneVersion_;
+    bool isSceneRequested_;
     AudioEngine * audioEngine_;
     AUDIO::Configuration audioConfig_;
 
@@ -8,9 +8,18 @@
     <p>created 3/27/2015</p>
 */
 
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <cstdint>
+
 #include <sndfile.h>
 
 #include <QDir>
+#include <QFile>
+#include <QBuffer>
 #include <QImage>
 #include <QImageWriter>
 #include <QTime>
@@ -25,6 +34,7 @@
 #include "gl/SceneRenderer.h"
 #include "gl/compatibility.h"
 #include "gl/FrameBufferObject.h"
+#include "gl/BufferObject.h"
 #include "gl/Texture.h"
 #include "projection/ProjectionSystemSettings.h"
 #include "tool/stringmanip.h"
@@ -32,6 +42,7 @@
 #include "audio/tool/AudioBuffer.h"
 #include "audio/tool/SoundFile.h"
 #include "audio/tool/SoundFileManager.h"
+#include "video/ffm/VideoEncoder.h"
 #include "io/FileManager.h"
 #include "io/DiskRenderSettings.h"
 #include "io/CurrentThread.h"
@@ -59,24 +70,91 @@ struct DiskRenderer::Private
         , pleaseStop    (false)
         , curSample     (0)
         , curFrame      (0)
+        , readbackPos   (0)
+        , readbackWidth (0)
+        , readbackHeight(0)
+        , previewRequested(false)
+#ifdef MO_ENABLE_FFMPEG
+        , encoder       (0)
+        , encoderStop   (false)
+        , encoderFailed (false)
+#endif
         , progress      (0)
         , stat_image_thread_overhead    (0.)
-    { }
+    { resetStats(); }
+
+    /** One pixel buffer of the asynchronous readback ring */
+    struct ReadbackSlot
+    {
+        enum State
+        {
+            S_FREE,
+            /** transfer from gpu is pending */
+            S_READING,
+            /** mapped and in the writer threads */
+            S_ENCODING,
+            /** released by writer thread, needs unmap */
+            S_DONE
+        };
+
+        ReadbackSlot()
+            : pbo       ("diskrenderer_readback")
+            , state     (S_FREE)
+            , frame     (0)
+            , fence     (0)
+            , data      (0)
+        { }
+
+        GL::BufferObject pbo;
+        std::atomic<State> state;
+        size_t frame;
+        gl::GLsync fence;
+        uchar * data;
+    };
 
     void addError(const QString& e) { if (!errorStr.isEmpty()) errorStr += '\n'; errorStr += e; }
     bool loadScene(const QString&);
     bool initScene();
     bool releaseScene();
     bool renderFrame();
-    bool writeImage();
+    /** Starts the transfer of the current frame and passes
+        previously transferred frames to writeImage() */
+    bool readbackImage();
+    void initReadback(uint width, uint height);
+    void releaseReadback();
+    /** Maps transferred frames in order and passes them to writeImage().
+        If @p all is false, only frames that are already transferred are passed. */
+    void dispatchReadbacks(bool all);
+    void dispatchSlot(ReadbackSlot*);
+    /** Makes the slot available for a new transfer, waits for the writer thread */
+    void recycleSlot(ReadbackSlot*);
+    /** Waits until all frames in the ring are written */
+    void finishReadback();
     bool openAudioFile(); //! creates a 32bit float wav for writing
     bool closeAudioFile();
     bool renderAudioFrame();
     bool writeAudioFrame(); //! writes into the open file
     void renderAll();
     bool prepareDir(const QString& dir_or_filename);
-    bool writeImage(const QImage&);
+    /** Encodes and stores the mapped pixel buffer in a writer thread */
+    bool writeImage(ReadbackSlot*);
     void normalizeAndSplitAudio();
+    void resetStats();
+    void addStat(Double& stat, size_t& count, Double time);
+#ifdef MO_ENABLE_FFMPEG
+    bool openVideoFile();
+    /** Encodes the remaining jobs and closes the video file */
+    void closeVideoFile();
+    void startEncoderThread();
+    /** Stops the thread after all queued jobs are processed */
+    void stopEncoderThread();
+    void encoderLoop();
+    /** Queues the mapped pixel buffer for the encoder thread */
+    void encodeImage(ReadbackSlot*);
+    /** Queues a copy of the current audio output block */
+    void encodeAudio();
+    void releaseSlot(ReadbackSlot*);
+#endif
 
     DiskRenderer * thread;
     ThreadPool * threadPool;
@@ -91,15 +169,46 @@ struct DiskRenderer::Private
     //AUDIO::SoundFile * soundFile;
     SNDFILE * sndFile;
     QString errorStr;
-    QImage tempImage;
 
     volatile bool pleaseStop;
     size_t curSample, curFrame;
 
+    std::vector<ReadbackSlot*> readback;
+    size_t readbackPos;
+    uint readbackWidth, readbackHeight;
+    std::mutex slotMutex;
+    std::condition_variable slotCond;
+    /** Set to receive a newImage() signal from the next written image */
+    std::atomic<bool> previewRequested;
+
+#ifdef MO_ENABLE_FFMPEG
+    /** Work for the encoder thread, either a frame or a block of audio */
+    struct EncoderJob
+    {
+        ReadbackSlot * slot;
+        std::vector<F32> audio;
+    };
+
+    FFM::VideoEncoder * encoder;
+    std::thread encoderThread;
+    std::deque<EncoderJob> encoderJobs;
+    std::mutex encoderMutex;
+    std::condition_variable encoderCond;
+    // guarded by encoderMutex
+    bool encoderStop;
+    // only touched by encoder thread
+    bool encoderFailed;
+#endif
+
     // render info
     QTime startTime;
     Double progress,
         stat_image_thread_overhead; // seconds
+
+    // accumulated seconds, guarded by statMutex
+    std::mutex statMutex;
+    Double stat_readback, stat_encode, stat_write;
+    size_t stat_num_readback, stat_num_encode, stat_num_write;
 };
 
 
@@ -219,6 +328,7 @@ bool DiskRenderer::Private::initScene()
 
     progress = 0;
     stat_image_thread_overhead = 0.;
+    resetStats();
 
     /** that's very loosely the startup routine for preparing a scene.
         @todo misses FrontItems */
@@ -307,6 +417,15 @@ bool DiskRenderer::Private::initScene()
         bufOut = new AUDIO::AudioBuffer(conf.bufferSize() * conf.numChannelsOut(), 1);
     }
 
+#ifdef MO_ENABLE_FFMPEG
+    // --- setup video file ---
+    if (rendSet.imageEnable() && rendSet.videoEnable())
+    {
+        if (!openVideoFile())
+            return false;
+    }
+#endif
+
     return true;
 }
 
@@ -315,6 +434,24 @@ bool DiskRenderer::Private::releaseScene()
     if (threadPool)
         threadPool->stop();
 
+#ifdef MO_ENABLE_FFMPEG
+    // on errors, the encoder may still be running
+    stopEncoderThread();
+    delete encoder; encoder = 0;
+#endif
+
+    // release pixel buffers (writer threads are stopped)
+    if (renderer && !readback.empty())
+    {
+        try
+        {
+            renderer->context()->makeCurrent();
+            releaseReadback();
+        }
+        catch (const Exception& e)
+            { MO_WARNING("DiskRenderer::releaseScene() ERROR:\n" << e.what()); }
+    }
+
     // release gl resources
     if (scene)
     {
@@ -427,6 +564,11 @@ bool DiskRenderer::Private::writeAudioFrame()
     if (!audio)
         return true;
 
+#ifdef MO_ENABLE_FFMPEG
+    if (encoder)
+        encodeAudio();
+#endif
+
     if (!sndFile)
     {
         if (!openAudioFile())
@@ -445,7 +587,7 @@ bool DiskRenderer::Private::writeAudioFrame()
     return true;
 }
 
-bool DiskRenderer::Private::writeImage()
+bool DiskRenderer::Private::readbackImage()
 {
     if (!scene)
         return false;
@@ -453,20 +595,39 @@ bool DiskRenderer::Private::writeImage()
     auto fbo = scene->fboMaster(MO_GFX_THREAD);
     if (!fbo || !fbo->colorTexture())
         return false;
+    auto tex = fbo->colorTexture();
 
     try
     {
+        TimeMessure tm;
+
         renderer->context()->makeCurrent();
-        gl::glFinish();
 
-        fbo->colorTexture()->bind();
-        tempImage = fbo->colorTexture()->toQImage();
-        if (tempImage.isNull())
-            return false;
+        if (readback.empty()
+            || readbackWidth != tex->width() || readbackHeight != tex->height())
+            initReadback(tex->width(), tex->height());
 
-        gl::glFinish();
+        ReadbackSlot * slot = readback[readbackPos];
+        recycleSlot(slot);
 
-        return writeImage(tempImage);
+        // start transfer into the pixel buffer
+        tex->bind();
+        slot->pbo.bind();
+        MO_CHECK_GL_THROW( gl::glGetTexImage(tex->target(), 0,
+                                             gl::GL_BGRA, gl::GL_UNSIGNED_BYTE, 0) );
+        slot->pbo.unbind();
+        slot->fence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE,
+                                      gl::UnusedMask::GL_NONE_BIT);
+        slot->frame = curFrame;
+        slot->state = ReadbackSlot::S_READING;
+        readbackPos = (readbackPos + 1) % readback.size();
+
+        // pass finished transfers to the writer threads
+        dispatchReadbacks(false);
+
+        addStat(stat_readback, stat_num_readback, tm.time());
+
+        return true;
     }
     catch (const Exception& e)
     {
@@ -476,6 +637,136 @@ bool DiskRenderer::Private::writeImage()
     }
 }
 
+void DiskRenderer::Private::initReadback(uint width, uint height)
+{
+    finishReadback();
+    releaseReadback();
+
+    const size_t num = std::max(size_t(1), rendSet.imageNumReadback());
+    MO_DEBUG("DiskRenderer::initReadback(" << width << ", " << height
+             << ") " << num << " buffers");
+
+    for (size_t i=0; i<num; ++i)
+    {
+        auto slot = new ReadbackSlot();
+        readback.push_back(slot);
+        slot->pbo.create(gl::GL_PIXEL_PACK_BUFFER, gl::GL_STREAM_READ);
+        slot->pbo.bind();
+        slot->pbo.upload(0, gl::GLsizeiptr(width) * height * 4);
+        slot->pbo.unbind();
+    }
+
+    readbackWidth = width;
+    readbackHeight = height;
+    readbackPos = 0;
+}
+
+void DiskRenderer::Private::releaseReadback()
+{
+    for (auto slot : readback)
+    {
+        if (slot->data)
+        {
+            slot->pbo.bind();
+            slot->pbo.unmap();
+            slot->pbo.unbind();
+        }
+        if (slot->fence)
+            gl::glDeleteSync(slot->fence);
+        if (slot->pbo.isOk())
+            slot->pbo.release();
+        delete slot;
+    }
+    readback.clear();
+    readbackPos = 0;
+}
+
+void DiskRenderer::Private::dispatchReadbacks(bool all)
+{
+    // oldest first
+    for (size_t i=0; i<readback.size(); ++i)
+    {
+        ReadbackSlot * slot = readback[(readbackPos + i) % readback.size()];
+        if (slot->state != ReadbackSlot::S_READING)
+            continue;
+
+        if (!all)
+        {
+            const gl::GLenum r = gl::glClientWaitSync(
+                        slot->fence, gl::GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            // keep order of frames
+            if (r != gl::GL_ALREADY_SIGNALED && r != gl::GL_CONDITION_SATISFIED)
+                return;
+        }
+
+        dispatchSlot(slot);
+    }
+}
+
+void DiskRenderer::Private::dispatchSlot(ReadbackSlot * slot)
+{
+    gl::glDeleteSync(slot->fence);
+    slot->fence = 0;
+
+    // blocks if transfer is not finished
+    slot->pbo.bind();
+    slot->data = static_cast<uchar*>(slot->pbo.map(gl::GL_READ_WRITE));
+    slot->pbo.unbind();
+    if (!slot->data)
+    {
+        slot->state = ReadbackSlot::S_FREE;
+        MO_GL_ERROR("Could not map pixel buffer for frame " << slot->frame);
+    }
+
+    slot->state = ReadbackSlot::S_ENCODING;
+    writeImage(slot);
+}
+
+void DiskRenderer::Private::recycleSlot(ReadbackSlot * slot)
+{
+    if (slot->state == ReadbackSlot::S_READING)
+        dispatchSlot(slot);
+
+    {
+        std::unique_lock<std::mutex> lock(slotMutex);
+        slotCond.wait(lock, [slot]()
+        {
+            return slot->state != ReadbackSlot::S_ENCODING;
+        });
+    }
+
+    if (slot->state == ReadbackSlot::S_DONE)
+    {
+        slot->pbo.bind();
+        slot->pbo.unmap();
+        slot->pbo.unbind();
+        slot->data = 0;
+        slot->state = ReadbackSlot::S_FREE;
+    }
+}
+
+void DiskRenderer::Private::finishReadback()
+{
+    dispatchReadbacks(true);
+    // oldest first
+    for (size_t i=0; i<readback.size(); ++i)
+        recycleSlot(readback[(readbackPos + i) % readback.size()]);
+}
+
+void DiskRenderer::Private::resetStats()
+{
+    std::lock_guard<std::mutex> lock(statMutex);
+    stat_readback = stat_encode = stat_write = 0.;
+    stat_num_readback = stat_num_encode = stat_num_write = 0;
+}
+
+void DiskRenderer::Private::addStat(Double& stat, size_t& count, Double time)
+{
+    std::lock_guard<std::mutex> lock(statMutex);
+    stat += time;
+    ++count;
+}
+
 
 void DiskRenderer::Private::renderAll()
 {
@@ -506,7 +797,7 @@ void DiskRenderer::Private::renderAll()
         if (renderer)
         {
             renderFrame();
-            writeImage();
+            readbackImage();
         }
 
         // emit progress every ms..
@@ -515,12 +806,23 @@ void DiskRenderer::Private::renderAll()
             //MO_DEBUG("rendering frame " << f << "/" << rendSet.lengthFrame());
             progress = f * 100.f / rendSet.lengthFrame();
             emit thread->progress(progress);
-            if (!tempImage.isNull())
-                emit thread->newImage(tempImage);
+            previewRequested = true;
             time.start();
         }
     }
 
+    // wait for remaining images
+    if (renderer && !readback.empty())
+    {
+        renderer->context()->makeCurrent();
+        finishReadback();
+    }
+
+#ifdef MO_ENABLE_FFMPEG
+    if (encoder)
+        closeVideoFile();
+#endif
+
     if (sndFile)
         closeAudioFile();
 }
@@ -548,7 +850,15 @@ QString DiskRenderer::progressString() const
         if (spd <= .5)
             s << " (" << int(1. / spd) << "fps)";
 
-        s               << "; store average " << p_->threadPool->averageWorkTime() << "s";
+        {
+            std::lock_guard<std::mutex> lock(p_->statMutex);
+            s           << "\nimage average : readback "
+                        << p_->stat_readback / std::max(size_t(1), p_->stat_num_readback) << "s"
+                        << "; encode "
+                        << p_->stat_encode / std::max(size_t(1), p_->stat_num_encode) << "s"
+                        << "; write "
+                        << p_->stat_write / std::max(size_t(1), p_->stat_num_write) << "s";
+        }
         if (p_->stat_image_thread_overhead > 0.001)
         {
             s           << "; overhead " << time_to_string_short(p_->stat_image_thread_overhead);
@@ -596,14 +906,27 @@ bool DiskRenderer::Private::prepareDir(const QString& dir1)
     return true;
 }
 
-bool DiskRenderer::Private::writeImage(const QImage& img)
+bool DiskRenderer::Private::writeImage(ReadbackSlot * slot)
 {
+#ifdef MO_ENABLE_FFMPEG
+    if (encoder)
+    {
+        encodeImage(slot);
+        return true;
+    }
+#endif
+
     TimeMessure tm;
 
-    QString fn = rendSet.makeImageFilename(curFrame);
+    const size_t frame = slot->frame;
+    const uint width = readbackWidth, height = readbackHeight;
+    const QString fn = rendSet.makeImageFilename(frame);
 
     if (!prepareDir(fn))
+    {
+        slot->state = ReadbackSlot::S_DONE;
         return false;
+    }
 
     // only allow x images in parallel
     if (rendSet.imageNumQue() > 0)
@@ -611,24 +934,72 @@ bool DiskRenderer::Private::writeImage(const QImage& img)
         threadPool->block(rendSet.imageNumQue() - 1);
     }
 
-    threadPool->addWork([this, fn, img]()
+    threadPool->addWork([this, slot, fn, frame, width, height]()
     {
-        QImageWriter w(fn, rendSet.imageFormatExt().toUtf8());
-        w.setQuality(rendSet.imageQuality());
-        w.setCompression(rendSet.imageCompression());
-        /** @todo expose description in gui */
-        w.setDescription(QString("%1: frame %2").arg(versionString()).arg(curFrame));
+        TimeMessure tm;
 
-        /*if (!w.canWrite())
+        // flip vertically and make opaque, right in the mapped buffer
+        auto pix = reinterpret_cast<uint32_t*>(slot->data);
+        for (uint y=0; y<(height+1)/2; ++y)
         {
-            addError(tr("Can not store the image, settings are wrong?"));
-            pleaseStop = true;
+            uint32_t * row1 = pix + y * width,
+                     * row2 = pix + (height - 1 - y) * width;
+            for (uint x=0; x<width; ++x)
+            {
+                const uint32_t p = row1[x] | 0xff000000;
+                row1[x] = row2[x] | 0xff000000;
+                row2[x] = p;
+            }
         }
-        else*/
-        if (!w.write(img))
+        const QImage img(slot->data, width, height, width * 4, QImage::Format_RGB32);
+
+        // encode
+        QByteArray encoded;
+        QString error;
+        bool ok;
+        {
+            QBuffer buffer(&encoded);
+            buffer.open(QIODevice::WriteOnly);
+            QImageWriter w(&buffer, rendSet.imageFormatExt().toUtf8());
+            w.setQuality(rendSet.imageQuality());
+            w.setCompression(rendSet.imageCompression());
+            /** @todo expose description in gui */
+            w.setDescription(QString("%1: frame %2").arg(versionString()).arg(frame));
+            ok = w.write(img);
+            if (!ok)
+                error = w.errorString();
+        }
+
+        if (ok && previewRequested.exchange(false))
+            emit thread->newImage(img.copy());
+
+        // give pixel buffer back to render thread
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slot->state = ReadbackSlot::S_DONE;
+        }
+        slotCond.notify_all();
+
+        addStat(stat_encode, stat_num_encode, tm.time());
+
+        // write
+        if (ok)
+        {
+            tm.start();
+            QFile f(fn);
+            if (!f.open(QIODevice::WriteOnly)
+                || f.write(encoded) != encoded.size())
+            {
+                ok = false;
+                error = f.errorString();
+            }
+            addStat(stat_write, stat_num_write, tm.time());
+        }
+
+        if (!ok)
         {
             /** @todo get error signals from image write thread */
-            addError(tr("Could not write image '%1'\n%2").arg(fn).arg(w.errorString()));
+            addError(tr("Could not write image '%1'\n%2").arg(fn).arg(error));
             pleaseStop = true;
         }
     });
@@ -638,6 +1009,173 @@ bool DiskRenderer::Private::writeImage(const QImage& img)
     return true;
 }
 
+#ifdef MO_ENABLE_FFMPEG
+
+bool DiskRenderer::Private::openVideoFile()
+{
+    const QString fn = rendSet.makeVideoFilename();
+    if (!prepareDir(fn))
+        return false;
+
+    encoder = new FFM::VideoEncoder();
+    encoder->setVideoFormat(rendSet.imageWidth(), rendSet.imageHeight(),
+                            rendSet.imageFps());
+    encoder->setVideoCodec(rendSet.videoCodec().toStdString());
+    encoder->setVideoBitRate(int64_t(rendSet.videoBitrate()) * 1000);
+    encoder->setThreadCount(rendSet.videoNumThreads());
+    if (audio)
+    {
+        encoder->setAudioFormat(rendSet.audioConfig().sampleRate(),
+                                rendSet.audioConfig().numChannelsOut());
+        encoder->setAudioCodec(rendSet.videoAudioCodec().toStdString());
+    }
+
+    try
+    {
+        encoder->openFile(fn.toStdString());
+    }
+    catch (const Exception& e)
+    {
+        addError(tr("Could not open video file '%1'\n%2").arg(fn).arg(e.what()));
+        delete encoder; encoder = 0;
+        return false;
+    }
+
+    startEncoderThread();
+    return true;
+}
+
+void DiskRenderer::Private::closeVideoFile()
+{
+    stopEncoderThread();
+
+    TimeMessure tm;
+    encoder->close();
+    addStat(stat_write, stat_num_write, tm.time());
+}
+
+void DiskRenderer::Private::startEncoderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        encoderStop = false;
+    }
+    encoderFailed = false;
+    encoderThread = std::thread([this](){ encoderLoop(); });
+}
+
+void DiskRenderer::Private::stopEncoderThread()
+{
+    if (!encoderThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        encoderStop = true;
+    }
+    encoderCond.notify_all();
+    encoderThread.join();
+}
+
+void DiskRenderer::Private::encodeImage(ReadbackSlot * slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        encoderJobs.push_back(EncoderJob());
+        encoderJobs.back().slot = slot;
+    }
+    encoderCond.notify_all();
+}
+
+void DiskRenderer::Private::encodeAudio()
+{
+    const size_t num = rendSet.audioConfig().bufferSize()
+                     * rendSet.audioConfig().numChannelsOut();
+    const F32 * src = bufOut->readPointer();
+    {
+        std::lock_guard<std::mutex> lock(encoderMutex);
+        encoderJobs.push_back(EncoderJob());
+        encoderJobs.back().slot = 0;
+        encoderJobs.back().audio.assign(src, src + num);
+    }
+    encoderCond.notify_all();
+}
+
+void DiskRenderer::Private::releaseSlot(ReadbackSlot * slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        slot->state = ReadbackSlot::S_DONE;
+    }
+    slotCond.notify_all();
+}
+
+void DiskRenderer::Private::encoderLoop()
+{
+    setCurrentThreadName("ENCODE");
+
+    std::unique_lock<std::mutex> lock(encoderMutex);
+    while (true)
+    {
+        encoderCond.wait(lock, [this](){ return encoderStop || !encoderJobs.empty(); });
+        // finish all jobs before stopping
+        if (encoderJobs.empty())
+            return;
+
+        EncoderJob job;
+        job.slot = encoderJobs.front().slot;
+        job.audio.swap(encoderJobs.front().audio);
+        encoderJobs.pop_front();
+        lock.unlock();
+
+        // after an error, only give the pixel buffers back
+        if (!encoderFailed)
+        {
+            try
+            {
+                TimeMessure tm;
+
+                if (job.slot)
+                {
+                    if (readbackWidth != uint(encoder->width())
+                        || readbackHeight != uint(encoder->height()))
+                        MO_ERROR("Frame size " << readbackWidth << "x" << readbackHeight
+                                 << " does not match video size "
+                                 << encoder->width() << "x" << encoder->height());
+
+                    // opengl image is upside-down
+                    encoder->addVideoFrame(job.slot->data, true);
+
+                    if (previewRequested.exchange(false))
+                        emit thread->newImage(
+                            QImage(job.slot->data, readbackWidth, readbackHeight,
+                                   readbackWidth * 4, QImage::Format_RGB32).mirrored());
+
+                    addStat(stat_encode, stat_num_encode, tm.time());
+                }
+                else
+                    encoder->addAudio(&job.audio[0], job.audio.size()
+                                      / rendSet.audioConfig().numChannelsOut());
+            }
+            catch (const Exception& e)
+            {
+                /** @todo get error signals from encoder thread */
+                addError(tr("Could not encode video '%1'\n%2")
+                         .arg(rendSet.makeVideoFilename()).arg(e.what()));
+                encoderFailed = true;
+                pleaseStop = true;
+            }
+        }
+
+        if (job.slot)
+            releaseSlot(job.slot);
+
+        lock.lock();
+    }
+}
+
+#endif // #ifdef MO_ENABLE_FFMPEG
+
 void DiskRenderer::Private::normalizeAndSplitAudio()
 {
     QString fn = rendSet.makeAudioFilename();
@@ -12,15 +12,13 @@
     // to switch to non-working gfx-time-between-audio-blocks solution test */
 
 #include <tuple>
-#ifdef MO_BUFFER_TRICK
-#   include <atomic>
-#endif
+#include <cmath>
+#include <atomic>
+#include <array>
 
 #include <QThread>
 #include <QMessageBox>
-#include <QReadWriteLock>
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QSemaphore>
 
 #include "LiveAudioEngine.h"
 #include "object/Scene.h"
@@ -38,6 +36,57 @@
 namespace MO {
 
 
+// ################################## timing statistics ########################################
+
+/** Lock-free histogram collector for one writer and any number of readers */
+class TimingCollector
+{
+public:
+    enum { NUM_BINS = 50 };
+
+    TimingCollector(Double binWidth) : binWidth_(binWidth) { reset(); }
+
+    void reset()
+    {
+        for (auto& b : bins_)
+            b = 0;
+        count_ = 0;
+        sumU_ = 0;
+        maxU_ = 0;
+    }
+
+    /** Adds a measurement in seconds */
+    void add(Double sec)
+    {
+        const Double ms = std::max(0., sec * 1000.);
+        const uint bin = std::min(uint(NUM_BINS - 1), uint(ms / binWidth_));
+        ++bins_[bin];
+        const uint64_t u = ms * 1000.;
+        sumU_ += u;
+        if (u > maxU_)
+            maxU_ = u;
+        ++count_;
+    }
+
+    LiveAudioEngine::TimingHistogram histogram() const
+    {
+        LiveAudioEngine::TimingHistogram h;
+        h.binWidth = binWidth_;
+        for (auto& b : bins_)
+            h.counts.push_back(b);
+        h.numMeasurements = count_;
+        h.average = h.numMeasurements ? Double(sumU_) / 1000. / h.numMeasurements : 0.;
+        h.maximum = Double(maxU_) / 1000.;
+        return h;
+    }
+
+private:
+    Double binWidth_;
+    std::array<std::atomic<uint>, NUM_BINS> bins_;
+    std::atomic<uint64_t> count_, sumU_, maxU_;
+};
+
+
 
 
 // ################################## LiveAudioEngine::Private ########################################
@@ -56,23 +105,34 @@ public:
           curSample     (0),
 #endif
           engine        (new AudioEngine()),
+          nextEngine    (0),
           isPause       (false),
-          engineChanged (false),
           startTime     (0.),
           timeOffset    (0.),
+          lastCallbackTime(-1.),
           audioDevice   (0),
           defaultConf   (AUDIO::AudioDevice::defaultConfiguration()),
-          audioOutThread(0)
+          audioOutThread(0),
+          blockLatency  (0.1),
+          callbackJitter(0.1)
     { }
 
     ~Private()
     {
         delete audioDevice;
-        delete engine;
+        deleteRetiredEngines();
+        delete engine.load();
     }
 
     /** Recreates the AudioEngine dsp path */
     void updateScene();
+    /** Deletes the pending engine and all engines retired by the audio thread.
+        Must be called from the thread that calls setScene(). */
+    void deleteRetiredEngines();
+    /** Called in audio thread at block boundaries.
+        Activates a new engine from setScene(), if present.
+        Returns true if an engine has been swapped. */
+    bool swapEngine();
     void audioCallback(const F32 *, F32 *, const AUDIO::AudioDevice::StreamTime&);
 
 #ifdef MO_BUFFER_TRICK
@@ -88,10 +148,20 @@ public:
 #endif
 
     LiveAudioEngine * parent;
-    AudioEngine * engine;
-    bool isPause, engineChanged;
+    /// Engine used by the audio thread, only swapped in the audio thread
+    std::atomic<AudioEngine*> engine,
+    /// Engine published by setScene() during playback
+                            nextEngine;
+    /// Engines that have been replaced in audio thread,
+    /// consumed and deleted by deleteRetiredEngines()
+    LocklessQueue<AudioEngine*> retiredEngines;
+    /// Released by audio thread after engine swap
+    QSemaphore swapSemaphore;
+    /// Released by the device callback for each consumed block
+    QSemaphore blockRequest;
+    bool isPause;
     //Double lastBufferTime;
-    Double startTime, timeOffset;
+    Double startTime, timeOffset, lastCallbackTime;
 
     AUDIO::AudioDevice * audioDevice;
     AUDIO::Configuration defaultConf;
@@ -102,8 +172,36 @@ public:
     AudioEngineOutThread * audioOutThread;
     LocklessQueue<const F32*> audioInQueue;
     LocklessQueue<const F32*> audioOutQueue;
+
+    TimingCollector blockLatency, callbackJitter;
 };
 
+void LiveAudioEngine::Private::deleteRetiredEngines()
+{
+    delete nextEngine.exchange(0);
+
+    AudioEngine * eng;
+    while (retiredEngines.consume(eng))
+        delete eng;
+}
+
+bool LiveAudioEngine::Private::swapEngine()
+{
+    AudioEngine * next = nextEngine.exchange(0);
+    if (!next)
+        return false;
+
+    AudioEngine * old = engine;
+    // continue at current position
+    next->seek(old->pos());
+    engine = next;
+
+    // deletion happens in the gui thread
+    retiredEngines.produce(old);
+    swapSemaphore.release();
+    return true;
+}
+
 
 
 
@@ -124,7 +222,7 @@ public:
 
     }
 
-    void stop() { stop_ = true; wait(); }
+    void stop() { stop_ = true; engine_->p_->blockRequest.release(); wait(); }
 
     void run()
     {
@@ -142,56 +240,66 @@ public:
 
         auto live = engine_->p_;
 
-        // length of a buffer in microseconds
-        unsigned long bufferTimeU =
-            1000000 * bufferSize * engine_->config().sampleRateInv();
+        // length of a buffer in milliseconds
+        int bufferTimeMs = std::max(1, int(1000 * bufferSize
+                                           * engine_->config().sampleRateInv()));
+        TimeMessure tm;
 
         while (!stop_)
         {
-            // calc buffers for next system-out callback
-            if (live->audioOutQueue.count() < numAhead && !engine_->isPause())
-            {
-                const F32 * inputFromDevice;
-                if (!live->audioInQueue.consume(inputFromDevice))
-                    inputFromDevice = 0;
+            const bool needBlock = live->audioOutQueue.count() < numAhead
+                                    && !engine_->isPause();
 
+            const F32 * inputFromDevice = 0;
+            if (needBlock && !live->audioInQueue.consume(inputFromDevice))
+                inputFromDevice = 0;
+
+            {
+                // protects parameters, timelines and modulators against
+                // edits in the gui thread. setScene() publishes a new path
+                // under the write lock, so the swap and the first block
+                // of the new path happen in the same locked section.
+                ScopedSceneLockRead lock(engine_->scene());
+
+                // pick up a new dsp path from setScene()
+                if (live->swapEngine())
                 {
-                    ScopedSceneLockRead lock(engine_->scene());
+                    // update local settings
+                    bufferSize = engine_->config().bufferSize(),
+                    numChannelsOut = engine_->config().numChannelsOut(),
+                    bufferSizeChan = bufferSize * numChannelsOut,
+                    bufferTimeMs = std::max(1, int(1000 *
+                            bufferSize * engine_->config().sampleRateInv()));
+
+                    if (bufferForDevice.blockSize() != bufferSizeChan)
+                        bufferForDevice.setSize(bufferSizeChan, numAhead);
+                }
 
+                if (needBlock)
+                {
                     // calculate an audio block
-                    live->engine->processForDevice(
+                    tm.start();
+                    live->engine.load()->processForDevice(
                                 inputFromDevice,
                                 bufferForDevice.writePointer());
-
-                    // check for engine swap
-                    if (live->engineChanged)
-                    {
-                        live->engineChanged = false;
-
-                        // update local settings
-                        bufferSize = engine_->config().bufferSize(),
-                        numChannelsOut = engine_->config().numChannelsOut(),
-                        bufferSizeChan = bufferSize * numChannelsOut,
-                        bufferTimeU = 1000000 *
-                                bufferSize * engine_->config().sampleRateInv();
-
-                        bufferForDevice.setSize(bufferSizeChan, numAhead);
-                        continue; //< dont send an invalid bufferForDevice
-                    }
-
+                    live->blockLatency.add(tm.time());
                 }
+            }
 
+            if (needBlock)
+            {
                 // publish
                 bufferForDevice.nextBlock();
                 live->audioOutQueue.produce(
                             bufferForDevice.readPointer());
-
             }
             else
-                usleep(bufferTimeU);
+                // wait for the device to consume a block
+                // (with timeout to check for stop, pause and swap)
+                live->blockRequest.tryAcquire(1, 2 * bufferTimeMs);
         }
 
-        live->engine->sendCloseThread();
+        live->engine.load()->sendCloseThread();
 
         MO_DEBUG("AudioOutThread::run() finished");
     }
@@ -236,29 +344,29 @@ LiveAudioEngine::~LiveAudioEngine()
 
 Scene * LiveAudioEngine::scene() const
 {
-    return p_->engine->scene();
+    return p_->engine.load()->scene();
 }
 
 uint LiveAudioEngine::thread() const
 {
-    return p_->engine->thread();
+    return p_->engine.load()->thread();
 }
 
 const AUDIO::Configuration& LiveAudioEngine::config() const
 {
-    return p_->engine->config();
+    return p_->engine.load()->config();
 }
 
 SamplePos LiveAudioEngine::pos() const
 {
-    return p_->engine->pos();
+    return p_->engine.load()->pos();
 }
 
 Double LiveAudioEngine::second() const
 {
     // XXX See below
     //if (!isPlayback() || isPause())
-        return p_->engine->second();
+        return p_->engine.load()->second();
 
     /** @todo find best solution for gfx time between audo dsp-blocks.
         Naive approach was to store the systemtime when the buffer is send
@@ -279,7 +387,7 @@ Double LiveAudioEngine::second() const
            + applicationTime() - bt.time;
 #else
 
-    Double audioTime = p_->engine->second(),
+    Double audioTime = p_->engine.load()->second(),
            time = applicationTime() - p_->startTime;
     // slowly adjust to audio time
     p_->timeOffset += 0.0001 * (audioTime - (time + p_->timeOffset));
@@ -290,24 +398,24 @@ Double LiveAudioEngine::second() const
 
 const F32 * LiveAudioEngine::outputEnvelope() const
 {
-    return p_->engine->outputEnvelope();
+    return p_->engine.load()->outputEnvelope();
 }
 
 
 void LiveAudioEngine::seek(SamplePos pos)
 {
-    p_->engine->seek(pos);
+    p_->engine.load()->seek(pos);
 #ifdef MO_BUFFER_TRICK
     p_->curSample = pos;
 #else
     if (isPlayback())
-        p_->startTime = applicationTime() - (p_->engine->second() + p_->timeOffset);
+        p_->startTime = applicationTime() - (p_->engine.load()->second() + p_->timeOffset);
 #endif
 }
 
 void LiveAudioEngine::seek(Double time)
 {
-    seek( SamplePos(time * p_->engine->config().sampleRate()) );
+    seek( SamplePos(time * p_->engine.load()->config().sampleRate()) );
 }
 
 void LiveAudioEngine::setScene(Scene * s, uint thread)
@@ -338,28 +446,51 @@ void LiveAudioEngine::setScene(Scene * s, uint thread)
     p_->nextEngine = eng;
 #else
 
+    p_->deleteRetiredEngines();
+
     // dont care for threads
     if (!isPlayback())
     {
         MO_DEBUG("LiveAudioEngine::setScene(" << s << ", " << thread << ") non-playback");
         // simply reassign
-        p_->engine->setScene(s, p_->defaultConf, thread);
+        p_->engine.load()->setScene(s, p_->defaultConf, thread);
         return;
     }
 
     // update the same scene?
     if (scene() && s == scene())
     {
-        ScopedSceneLockWrite lock(scene());
-
         MO_DEBUG("LiveAudioEngine::setScene(" << s << ", " << thread << ") thread-safe swap");
 
-        p_->engine->setScene(scene(), config(), thread);
-        p_->engineChanged = true;
-        /*if (!p_->nextEngine)
-            p_->nextEngine = new AudioEngine();
-        p_->nextEngine->setScene(scene(), config(), thread);
-        delete p_->engine;*/
+        // build the new dsp path while the audio thread continues
+        // with the current one. The path only reads the scene.
+        auto eng = new AudioEngine();
+        {
+            ScopedSceneLockRead lock(scene());
+            eng->setScene(scene(), config(), thread, false);
+        }
+
+        {
+            // The audio thread is between blocks while the write lock is held.
+            // The AudioObjects get their new buffers and channels here
+            // and the audio thread only swaps to the prepared path.
+            ScopedSceneLockWrite lock(scene());
+            eng->prepareUdp();
+
+            // publish
+            p_->swapSemaphore.tryAcquire(p_->swapSemaphore.available());
+            delete p_->nextEngine.exchange(eng);
+        }
+        p_->blockRequest.release();
+
+        // Wait until the audio thread uses the new path.
+        // Deleted objects are only kept alive until the next render
+        // so the old path must not be used after returning.
+        if (!p_->swapSemaphore.tryAcquire(1, 1000))
+            MO_WARNING("LiveAudioEngine::setScene() audio thread did not "
+                       "pick up the new dsp path");
+
+        p_->deleteRetiredEngines();
     }
     else
     {
@@ -372,11 +503,12 @@ void LiveAudioEngine::setScene(Scene * s, uint thread)
 void LiveAudioEngine::Private::updateScene()
 {
     MO_DEBUG("LiveAudioEngine::Private::updateScene() "
-             "engine->scene() == " << engine->scene()
+             "engine->scene() == " << engine.load()->scene()
              << " playback == " << parent->isPlayback());
 
-    if (engine->scene() && engine->config() != defaultConf)
-        engine->setScene(engine->scene(), defaultConf, engine->thread());
+    AudioEngine * eng = engine;
+    if (eng->scene() && eng->config() != defaultConf)
+        eng->setScene(eng->scene(), defaultConf, eng->thread());
 }
 
 bool LiveAudioEngine::isAudioConfigured() const
@@ -453,8 +585,13 @@ bool LiveAudioEngine::start()
         if (!initAudioDevice())
             return false;
 
+    // assign buffers and udp streams before the audio thread runs the path
+    p_->engine.load()->prepareUdp();
+
     // init communication stuff
     p_->audioOutQueue.reset();
+    p_->blockRequest.tryAcquire(p_->blockRequest.available());
+    p_->lastCallbackTime = -1.;
 
 #ifdef MO_BUFFER_TRICK
     Private::BufferTime bt;
@@ -477,7 +614,7 @@ bool LiveAudioEngine::start()
     // start device
     try
     {
-        p_->timeOffset = p_->engine->second();
+        p_->timeOffset = p_->engine.load()->second();
         p_->audioDevice->start();
         p_->startTime = applicationTime();
     }
@@ -506,6 +643,8 @@ void LiveAudioEngine::stop()
     }
 
     p_->audioDevice->stop();
+
+    p_->deleteRetiredEngines();
 }
 
 void LiveAudioEngine::pause(bool enable)
@@ -513,6 +652,22 @@ void LiveAudioEngine::pause(bool enable)
     p_->isPause = enable;
 }
 
+LiveAudioEngine::TimingHistogram LiveAudioEngine::blockLatencyHistogram() const
+{
+    return p_->blockLatency.histogram();
+}
+
+LiveAudioEngine::TimingHistogram LiveAudioEngine::callbackJitterHistogram() const
+{
+    return p_->callbackJitter.histogram();
+}
+
+void LiveAudioEngine::resetTimingStatistics()
+{
+    p_->blockLatency.reset();
+    p_->callbackJitter.reset();
+}
+
 
 void LiveAudioEngine::Private::audioCallback(
         const F32 * in, F32 * out, const AUDIO::AudioDevice::StreamTime &
@@ -523,10 +678,19 @@ void LiveAudioEngine::Private::audioCallback(
 {
 #ifdef MO_BUFFER_TRICK
     lastBuffer = BufferTime(curSample, applicationTime() + st.outputTime);
-    curSample += engine->config().bufferSize();
+    curSample += engine.load()->config().bufferSize();
     //MO_PRINT("audio callback " << st.inputTime << " " << st.currentTime << " " << st.outputTime);
 #endif
 
+    // deviation from regular callback interval
+    const Double
+            now = systemTime(),
+            bufferTime = engine.load()->config().bufferSize()
+                        * engine.load()->config().sampleRateInv();
+    if (lastCallbackTime >= 0.)
+        callbackJitter.add(std::abs(now - lastCallbackTime - bufferTime));
+    lastCallbackTime = now;
+
     // get input
     audioInQueue.produce(in);
 
@@ -534,19 +698,23 @@ void LiveAudioEngine::Private::audioCallback(
 
     // get output from AudioOutThread
     const F32 * buf;
+    const AUDIO::Configuration& conf = engine.load()->config();
     if (audioOutQueue.consume(buf))
     {
-        memcpy(out, buf, engine->config().bufferSize()
-                            * engine->config().numChannelsOut()
+        memcpy(out, buf, conf.bufferSize()
+                            * conf.numChannelsOut()
                             * sizeof(F32));
     }
     else
     {
-        memset(out, 0, engine->config().bufferSize()
-                            * engine->config().numChannelsOut()
+        memset(out, 0, conf.bufferSize()
+                            * conf.numChannelsOut()
                             * sizeof(F32));
         //MO_WARNING("audio-out buffer underrun");
     }
+
+    // wake up audio-out thread
+    blockRequest.release();
 }
 
 
@@ -11,6 +11,9 @@
 #ifndef MOSRC_ENGINE_LIVEAUDIOENGINE_H
 #define MOSRC_ENGINE_LIVEAUDIOENGINE_H
 
+#include <vector>
+#include <cstdint>
+
 #include <QObject>
 
 #include "types/float.h"
@@ -28,6 +31,19 @@ class LiveAudioEngine : public QObject
     friend class AudioEngineOutThread;
 
 public:
+
+    /** Snapshot of a timing histogram, all values in milliseconds */
+    struct TimingHistogram
+    {
+        /** Width of one bin */
+        Double binWidth;
+        /** Number of measurements per bin,
+            the last bin also contains all larger values */
+        std::vector<uint> counts;
+        Double average, maximum;
+        uint64_t numMeasurements;
+    };
+
     explicit LiveAudioEngine(QObject *parent = 0);
     ~LiveAudioEngine();
 
@@ -54,6 +70,13 @@ public:
     bool isPlayback() const;
     bool isPause() const;
 
+    /** Time needed to calculate one dsp block in the audio thread */
+    TimingHistogram blockLatencyHistogram() const;
+
+    /** Deviation of the audio device callback interval
+        from the length of one dsp block */
+    TimingHistogram callbackJitterHistogram() const;
+
 signals:
 
 public slots:
@@ -85,6 +108,9 @@ public slots:
     /** Puts the audio thread on idle */
     void pause(bool enable);
 
+    /** Clears the block latency and callback jitter histograms */
+    void resetTimingStatistics();
+
 private:
 
     class Private;
@@ -9,16 +9,22 @@
 */
 
 #include <QTcpSocket>
+#include <QTimer>
 
 #include "ServerEngine.h"
 #include "network/TcpServer.h"
+#include "network/FileServer.h"
 #include "network/NetEvent.h"
 #include "network/netlog.h"
 #include "network/EventCom.h"
 #include "network/UdpAudioConnection.h"
+#include "network/SceneDelta.h"
+#include "network/SceneDeltaRecorder.h"
 #include "io/Application.h"
 #include "io/Settings.h"
 #include "io/FileManager.h"
+#include "io/CurrentTime.h"
+#include "io/time.h"
 #include "tool/deleter.h"
 
 namespace MO {
@@ -43,8 +49,12 @@ struct ClientInfo::Private
 ServerEngine::ServerEngine(QObject *parent)
     : QObject       (parent),
       server_       (new TcpServer(this)),
+      fileServer_   (new FileServer(this)),
       eventCom_     (new EventCom(this)),
-      audioOut_     (0)
+      audioOut_     (0),
+      timeTimer_    (new QTimer(this)),
+      deltaRecorder_(new SceneDeltaRecorder(this)),
+      isScenePlaying_(false)
 {
     MO_NETLOG(CTOR, "ServerEngine::ServerEngine(" << parent << ")");
 
@@ -59,10 +69,21 @@ ServerEngine::ServerEngine(QObject *parent)
 
     connect(eventCom_, SIGNAL(eventReceived(AbstractNetEvent*)),
             this, SLOT(onEventCom_(AbstractNetEvent*)));
+
+    connect(fileServer_, SIGNAL(manifestReady(QString,MO::FileManifest)),
+            this, SLOT(onManifestReady_(QString,MO::FileManifest)));
+
+    // regular scene time updates for the clients' ClockSync
+    timeTimer_->setInterval(100);
+    timeTimer_->setSingleShot(false);
+    connect(timeTimer_, SIGNAL(timeout()), this, SLOT(onTimeTimer_()));
+
+    connect(deltaRecorder_, SIGNAL(deltaReady()), this, SLOT(sendSceneDelta_()));
 }
 
 ServerEngine::~ServerEngine()
 {
+    dropPendingFileInfos_(0);
     for (auto &i : clients_)
         delete i.p_;
 }
@@ -79,7 +100,12 @@ int ServerEngine::numClients() const
 
 bool ServerEngine::open()
 {
-    return server_->open();
+    if (!server_->open())
+        return false;
+
+    // clients fall back to NetEventFile without it
+    fileServer_->open();
+    return true;
 }
 #if 0
 UdpAudioConnection * ServerEngine::getAudioOutStream()
@@ -98,6 +124,8 @@ void ServerEngine::close()
 {
     sendClose_();
     server_->close();
+    fileServer_->close();
+    dropPendingFileInfos_(0);
 
     for (auto &i : clients_)
         delete i.p_;
@@ -167,9 +195,43 @@ void ServerEngine::onTcpDisconnected_(QTcpSocket * s)
         clients_.removeAt(i);
     }
 
+    dropPendingFileInfos_(s);
+
     emit numberClientsChanged(clients_.size());
 }
 
+void ServerEngine::dropPendingFileInfos_(QTcpSocket * s)
+{
+    for (auto it = pendingFileInfos_.begin(); it != pendingFileInfos_.end(); )
+    {
+        if (!s || it.value().first == s)
+        {
+            delete it.value().second;
+            it = pendingFileInfos_.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void ServerEngine::onManifestReady_(const QString &fn, const FileManifest &m)
+{
+    const auto pending = pendingFileInfos_.values(fn);
+    pendingFileInfos_.remove(fn);
+
+    for (auto p : pending)
+    {
+        const int idx = clientForTcp_(p.first);
+        if (idx < 0)
+        {
+            delete p.second;
+            continue;
+        }
+        p.second->setManifest(m);
+        sendEvent(clients_[idx], p.second);
+    }
+}
+
 void ServerEngine::onTcpError_(QTcpSocket * )
 {
     //if (s->error() == QAbstractSocket::RemoteHostClosedError)
@@ -201,6 +263,24 @@ bool ServerEngine::sendEvent(ClientInfo& client, AbstractNetEvent * e)
     return eventCom_->sendEvent(client.tcpSocket, e);
 }
 
+bool ServerEngine::sendTime(Double time)
+{
+    if (!numClients())
+        return false;
+
+    auto e = new NetEventTime();
+    e->setTime(time);
+    e->setServerTime(systemTime());
+    e->setPlaying(isScenePlaying_);
+
+    return sendEvent(e);
+}
+
+void ServerEngine::onTimeTimer_()
+{
+    sendTime(CurrentTime::time());
+}
+
 void ServerEngine::sendProjectionSettings()
 {
     auto event = new NetEventRequest;
@@ -282,6 +362,16 @@ void ServerEngine::onEvent_(ClientInfo & client, AbstractNetEvent * event)
         return;
     }
 
+    if (NetEventClockSync * sync = netevent_cast<NetEventClockSync>(event))
+    {
+        const Double receiveTime = systemTime();
+        auto r = sync->createResponse<NetEventClockSync>();
+        r->setClientSendTime(sync->clientSendTime());
+        r->setServerTimes(receiveTime, systemTime());
+        sendEvent(client, r);
+        return;
+    }
+
     if (NetEventLog * log = netevent_cast<NetEventLog>(event))
     {
         emit clientMessage(client, log->level(), log->message());
@@ -303,14 +393,36 @@ void ServerEngine::onEvent_(ClientInfo & client, AbstractNetEvent * event)
             auto f = req->createResponse<NetEventFileInfo>();
             /** @note We load the local file but keep the absolute real filename
                 as identifier for the file. */
-            f->setFilename( IO::FileManager().localFilename(req->data().toString()) );
+            const QString fn = IO::FileManager().localFilename(req->data().toString());
+            f->setFilename(fn);
             f->getFileTime();
+            FileManifest m;
+            if (f->isPresent() && fileServer_->isListening())
+                m = fileServer_->manifest(fn);
             f->setFilename(req->data().toString());
 
+            // answer when the file is hashed
+            if (!m.isValid() && fileServer_->isHashing(fn))
+            {
+                pendingFileInfos_.insert(fn, qMakePair(client.tcpSocket, f));
+                return;
+            }
+
+            f->setManifest(m);
             sendEvent(client, f);
             return;
         }
 
+        if (req->request() == NetEventRequest::GET_SCENE)
+        {
+            MO_NETLOG(EVENT, "client " << client.index << " requested the scene");
+            // other clients get the pending edits as usual
+            sendSceneDelta_();
+            if (auto e = createSceneEvent_(deltaRecorder_->scene()))
+                sendEvent(client, e);
+            return;
+        }
+
         if (req->request() == NetEventRequest::GET_SERVER_FILE)
         {
             auto f = req->createResponse<NetEventFile>();
@@ -408,34 +520,83 @@ void ServerEngine::sendClose_()
     sendEvent(e);
 }
 
-bool ServerEngine::sendScene(Scene *scene)
+NetEventScene * ServerEngine::createSceneEvent_(Scene * scene)
 {
-    if (!numClients())
-        return false;
+    if (!scene)
+        return 0;
 
     auto e = new NetEventScene();
     if (!e->setScene(scene))
     {
         MO_NETLOG(ERROR, "Could not serialize scene");
-        return false;
+        delete e;
+        return 0;
     }
+    e->setVersion(deltaRecorder_->beginSnapshot(scene));
+
+    return e;
+}
+
+bool ServerEngine::sendScene(Scene *scene)
+{
+    if (!numClients())
+        return false;
+
+    sendSceneDelta_();
+
+    auto e = createSceneEvent_(scene);
+    if (!e)
+        return false;
 
     return sendEvent(e);
 }
 
+void ServerEngine::setObjectEditor(ObjectEditor * editor)
+{
+    deltaRecorder_->setObjectEditor(editor);
+}
+
+void ServerEngine::sendSceneDelta_()
+{
+    SceneDelta delta;
+    quint32 baseVersion, version;
+    if (!deltaRecorder_->takeDelta(delta, &baseVersion, &version))
+        return;
+
+    // clients will ask for the scene when they see the next version
+    if (!numClients())
+        return;
+
+    auto e = new NetEventSceneDelta();
+    e->setVersions(baseVersion, version);
+    e->setDelta(delta);
+
+    MO_NETLOG(EVENT_V2, "sending " << delta.numOperations() << " edits, v"
+              << baseVersion << "->" << version);
+
+    sendEvent(e);
+}
+
 bool ServerEngine::setScenePlaying(bool enabled)
 {
+    isScenePlaying_ = enabled;
+    if (enabled)
+        timeTimer_->start();
+    else
+        timeTimer_->stop();
+
     if (!numClients())
         return false;
 
+    // start/stop timestamp
+    sendTime(CurrentTime::time());
+
     auto r = new NetEventRequest();
     if (enabled)
         r->setRequest(NetEventRequest::START_RENDER);
     else
         r->setRequest(NetEventRequest::STOP_RENDER);
 
-    /** @todo send start/stop timestamp */
-
     return sendEvent(r);
 }
 
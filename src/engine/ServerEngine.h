@@ -12,6 +12,8 @@
 #define MOSRC_ENGINE_SERVERENGINE_H
 
 #include <QObject>
+#include <QMultiMap>
+#include <QPair>
 
 #include "network/network_fwd.h"
 #include "io/systeminfo.h"
@@ -19,11 +21,13 @@
 #include "projection/ProjectionSystemSettings.h"
 
 class QTcpSocket;
+class QTimer;
 
 namespace MO {
 namespace AUDIO { class Configuration; }
 
 class Scene;
+class ObjectEditor;
 
 /** Returns a singleton instance of the server */
 ServerEngine & serverEngine();
@@ -65,10 +69,19 @@ public:
 
     int numClients() const;
 
+    /** The scene is playing, as set by setScenePlaying() */
+    bool isScenePlaying() const { return isScenePlaying_; }
+
     const ClientInfo& clientInfo(int index) const { return clients_[index]; }
 
+    /** Returns the recorder of the edits that are replicated to clients */
+    SceneDeltaRecorder * sceneDeltaRecorder() const { return deltaRecorder_; }
+
     /** Returns the one tcp server */
     TcpServer * tcpServer() const { return server_; }
+
+    /** Returns the server for chunked file transfers */
+    FileServer * fileServer() const { return fileServer_; }
 #if 0
     /** Returns the audio stream object for sending audio buffers to clients */
     UdpAudioConnection * getAudioOutStream();
@@ -94,6 +107,10 @@ public:
         Ownership is taken. */
     bool sendEvent(ClientInfo&, AbstractNetEvent*);
 
+    /** Sends a NetEventTime with the scene time @p time
+        and the current server clock to all clients */
+    bool sendTime(Double time);
+
 signals:
 
     /** Emitted whenever a client connects or disconnects */
@@ -129,7 +146,13 @@ public slots:
     /** Send the scene to all clients */
     bool sendScene(Scene * scene);
 
-    /** Start and stop playback */
+    /** Replicates the edits of @p editor to the clients.
+        Every edit is sent as a NetEventSceneDelta, clients that can not
+        apply it request the whole scene, see sendScene(). */
+    void setObjectEditor(ObjectEditor * editor);
+
+    /** Start and stop playback.
+        While playing, the scene time is sent to clients regularily. */
     bool setScenePlaying(bool enabled);
 
     /** Sends off the audio config (mainly buffersize) to clients */
@@ -138,11 +161,16 @@ public slots:
 private slots:
 
     void onTcpConnected_(QTcpSocket*);
+    void onTimeTimer_();
+    /** Sends pending edits as NetEventSceneDelta to all clients */
+    void sendSceneDelta_();
     void onTcpDisconnected_(QTcpSocket*);
     void onTcpError_(QTcpSocket*);
     void onTcpData_(QTcpSocket*);
     void onEventCom_(AbstractNetEvent*);
     void onEvent_(ClientInfo& , AbstractNetEvent*);
+    /** Answers the file info requests that waited for the hash */
+    void onManifestReady_(const QString& localFilename, const MO::FileManifest&);
 
 private:
 
@@ -153,12 +181,23 @@ private:
     void getClientIndex_(ClientInfo&);
     void sendProjectionSettings_(ClientInfo&);
     void sendClose_();
+    /** Creates a NetEventScene of the current version, or NULL */
+    NetEventScene * createSceneEvent_(Scene * scene);
+    /** Deletes the waiting file infos of @p s, or all if NULL */
+    void dropPendingFileInfos_(QTcpSocket * s);
 
     QList<ClientInfo> clients_;
 
     TcpServer * server_;
+    FileServer * fileServer_;
     EventCom * eventCom_;
     UdpAudioConnection * audioOut_;
+    QTimer * timeTimer_;
+    SceneDeltaRecorder * deltaRecorder_;
+    /** File info responses waiting for FileServer::manifestReady(),
+        by local filename */
+    QMultiMap<QString, QPair<QTcpSocket*, NetEventFileInfo*>> pendingFileInfos_;
+    bool isScenePlaying_;
 };
 
 } // namespace MO
@@ -10,6 +10,8 @@
 
 #include <random>
 #include <atomic>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -17,6 +19,7 @@
 #include <QTextStream>
 
 #include "Geometry.h"
+#include "GeometryBvh.h"
 #include "gl/ShaderSource.h"
 #include "gl/Shader.h"
 #include "gl/VertexArrayObject.h"
@@ -108,9 +111,13 @@ struct Geometry::Private
     Private(Geometry* p)
         : p     (p)
         , geomHash   (geom_hash_++)
-
+        , bvhHash    (geomHash - 1)
     { }
 
+    /** Returns the hierarchy for the current triangles,
+        or NULL if the geometry is too small to benefit */
+    const GeometryBvh * getBvh();
+
     void clearPrimitiveHash()
     {
         pointMap.clear();
@@ -236,8 +243,28 @@ struct Geometry::Private
     bool doSharedVertices;
 
     int geomHash;
+
+    // lazily built for ray queries, valid if bvhHash == geomHash
+    GeometryBvh bvh;
+    int bvhHash;
+    std::mutex bvhMutex;
 };
 
+const GeometryBvh * Geometry::Private::getBvh()
+{
+    // linear search is faster than building
+    if (p->numTriangles() < 32)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(bvhMutex);
+    if (bvhHash != geomHash)
+    {
+        bvh.build(*p);
+        bvhHash = geomHash;
+    }
+    return &bvh;
+}
+
 
 
 
@@ -607,10 +634,12 @@ void Geometry::getExtent(Vec3 * minimum, Vec3 * maximum) const
     }
 }
 
-bool Geometry::intersects_any(const Vec3 &ray_origin, const Vec3 &ray_direction, Vec3 *pos) const
+bool Geometry::intersects_any(const Vec3 &ray_origin, const Vec3 &ray_direction, Vec3 *outpos) const
 {
-    // XXX todo: Test against bounding-box first!
+    if (auto bvh = p_->getBvh())
+        return bvh->intersects(ray_origin, ray_direction, outpos, nullptr, true);
 
+    Vec3 pos;
     for (uint i=0; i<numTriangles(); ++i)
     {
         const Vec3 t0 = getVertex(triIndex_[i * numTriangleIndexComponents()]),
@@ -618,8 +647,12 @@ bool Geometry::intersects_any(const Vec3 &ray_origin, const Vec3 &ray_direction,
                    t2 = getVertex(triIndex_[i * numTriangleIndexComponents() + 2]);
 
         if (MATH::intersect_ray_triangle(ray_origin, ray_direction,
-                                         t0, t1, t2, pos))
+                                         t0, t1, t2, &pos))
+        {
+            if (outpos)
+                *outpos = pos;
             return true;
+        }
     }
 
     return false;
@@ -629,8 +662,18 @@ bool Geometry::intersects(
         const Vec3 &ray_origin, const Vec3 &ray_direction,
         Vec3* outpos, IndexType* triIndex) const
 {
-    // XXX todo: Test against bounding-box first!
+    if (auto bvh = p_->getBvh())
+        return bvh->intersects(ray_origin, ray_direction, outpos, triIndex,
+                               // no need to look further, outpos is not used
+                               !outpos && !triIndex);
 
+    return intersects_linear(ray_origin, ray_direction, outpos, triIndex);
+}
+
+bool Geometry::intersects_linear(
+        const Vec3 &ray_origin, const Vec3 &ray_direction,
+        Vec3* outpos, IndexType* triIndex) const
+{
     Float closest = -1;
     Vec3 pos;
 
@@ -663,6 +706,59 @@ bool Geometry::intersects(
     return closest >= 0;
 }
 
+size_t Geometry::intersects_many(
+        size_t num, const Vec3* ray_origins, const Vec3* ray_directions,
+        bool* hit, Vec3* pos, IndexType* triIndex, uint numThreads) const
+{
+    // build once before threads start,
+    // the rays then query it without the bvh lock
+    const GeometryBvh * bvh = p_->getBvh();
+    // no need to look further, outpos is not used
+    const bool anyHit = !pos && !triIndex;
+
+    auto work = [=](size_t begin, size_t end)
+    {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            Vec3 * outpos = pos ? &pos[i] : nullptr;
+            IndexType * outtri = triIndex ? &triIndex[i] : nullptr;
+            hit[i] = bvh
+                ? bvh->intersects(ray_origins[i], ray_directions[i],
+                                  outpos, outtri, anyHit)
+                : intersects_linear(ray_origins[i], ray_directions[i],
+                                    outpos, outtri);
+            count += hit[i];
+        }
+        return count;
+    };
+
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    // not worth a thread for few rays
+    numThreads = std::min(size_t(numThreads), std::max(size_t(1), num / 256));
+    if (numThreads <= 1)
+        return work(0, num);
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> counts(numThreads, 0);
+    for (uint t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            counts[t] = work(num * t / numThreads, num * (t + 1) / numThreads);
+        }));
+    }
+
+    size_t count = 0;
+    for (uint t = 0; t < numThreads; ++t)
+    {
+        threads[t].join();
+        count += counts[t];
+    }
+    return count;
+}
+
 
 
 void Geometry::setSharedVertices(bool enable, VertexType threshold)
@@ -1630,15 +1726,23 @@ bool Geometry::transformWithEquation(const QString& equationX,
 {
     setChanged();
 
-    Double vx, vy, vz, vindex;
+    // the equations are evaluated for blocks of vertices at once
+    const uint blockSize = 4096;
+    std::vector<Double>
+            vx(blockSize), vy(blockSize), vz(blockSize), vindex(blockSize),
+            res[3] = { std::vector<Double>(blockSize),
+                       std::vector<Double>(blockSize),
+                       std::vector<Double>(blockSize) };
+    // scalar storage, replaced by the arrays in evalBatch()
+    Double scalar[4] = { 0 };
 
     std::vector<PPP_NAMESPACE::Parser> equ(3);
     for (uint i=0; i<3; ++i)
     {
-        equ[i].variables().add("x", &vx, "");
-        equ[i].variables().add("y", &vy, "");
-        equ[i].variables().add("z", &vz, "");
-        equ[i].variables().add("i", &vindex, "");
+        equ[i].variables().add("x", &scalar[0], "");
+        equ[i].variables().add("y", &scalar[1], "");
+        equ[i].variables().add("z", &scalar[2], "");
+        equ[i].variables().add("i", &scalar[3], "");
 
         for (auto j=0; j<constantNames.size(); ++j)
             equ[i].variables().add(constantNames[j].toStdString(), constantValues[j], "");
@@ -1651,24 +1755,44 @@ bool Geometry::transformWithEquation(const QString& equationX,
     if (!equ[2].parse(equationZ.toStdString()))
         return false;
 
-    for (uint i=0; i<numVertices(); ++i)
+    const bool doEval[3] = { equationX != "x", equationY != "y", equationZ != "z" };
+
+    for (uint i=0; i<3; ++i)
+    {
+        equ[i].setBatchVariable("x", &vx[0]);
+        equ[i].setBatchVariable("y", &vy[0]);
+        equ[i].setBatchVariable("z", &vz[0]);
+        equ[i].setBatchVariable("i", &vindex[0]);
+    }
+
+    const uint numComp = numVertexComponents();
+    for (uint start=0; start<numVertices(); start += blockSize)
     {
+        const uint num = std::min(blockSize, numVertices() - start);
+
         // copy input variables
-        VertexType * v = &vertex_[i * numVertexComponents()];
-        vx = v[0];
-        vy = v[1];
-        vz = v[2];
-        vindex = i;
+        for (uint i=0; i<num; ++i)
+        {
+            const VertexType * v = &vertex_[(start + i) * numComp];
+            vx[i] = v[0];
+            vy[i] = v[1];
+            vz[i] = v[2];
+            vindex[i] = start + i;
+        }
+
+        for (uint e=0; e<3; ++e)
+            if (doEval[e])
+                equ[e].evalBatch(&res[e][0], num);
 
         // assign result from equation
-        if (equationX != "x")
-            v[0] = equ[0].eval();
-        if (equationY != "y")
-            v[1] = equ[1].eval();
-        if (equationZ != "z")
-            v[2] = equ[2].eval();
+        for (uint e=0; e<3; ++e)
+        if (doEval[e])
+        {
+            for (uint i=0; i<num; ++i)
+                vertex_[(start + i) * numComp + e] = res[e][i];
+        }
 
-        progress_ = (i * 100) / numVertices();
+        progress_ = ((start + num) * 100) / numVertices();
     }
 
     return true;
@@ -1681,21 +1805,28 @@ bool Geometry::transformWithEquation(const QString& equation,
 {
     setChanged();
 
-    Double vx, vy, vz, vindex, vs, vt,
-            red,green,blue,alpha,bright;
+    // the equation is evaluated for blocks of vertices at once
+    const uint blockSize = 4096;
+    std::vector<Double>
+            vx(blockSize), vy(blockSize), vz(blockSize), vindex(blockSize),
+            vs(blockSize), vt(blockSize),
+            red(blockSize), green(blockSize), blue(blockSize),
+            alpha(blockSize), bright(blockSize);
+    // scalar storage, replaced by the arrays in evalBatch()
+    Double scalar[11] = { 0 };
 
     PPP_NAMESPACE::Parser equ;
-    equ.variables().add("x", &vx, "");
-    equ.variables().add("y", &vy, "");
-    equ.variables().add("z", &vz, "");
-    equ.variables().add("i", &vindex, "");
-    equ.variables().add("s", &vs, "");
-    equ.variables().add("t", &vt, "");
-    equ.variables().add("red", &red, "");
-    equ.variables().add("green", &green, "");
-    equ.variables().add("blue", &blue, "");
-    equ.variables().add("alpha", &alpha, "");
-    equ.variables().add("bright", &bright, "");
+    equ.variables().add("x", &scalar[0], "");
+    equ.variables().add("y", &scalar[1], "");
+    equ.variables().add("z", &scalar[2], "");
+    equ.variables().add("i", &scalar[3], "");
+    equ.variables().add("s", &scalar[4], "");
+    equ.variables().add("t", &scalar[5], "");
+    equ.variables().add("red", &scalar[6], "");
+    equ.variables().add("green", &scalar[7], "");
+    equ.variables().add("blue", &scalar[8], "");
+    equ.variables().add("alpha", &scalar[9], "");
+    equ.variables().add("bright", &scalar[10], "");
 
     for (auto j=0; j<constantNames.size(); ++j)
         equ.variables().add(constantNames[j].toStdString(), constantValues[j], "");
@@ -1703,39 +1834,63 @@ bool Geometry::transformWithEquation(const QString& equation,
     if (!equ.parse(equation.toStdString()))
         return false;
 
-    for (uint i=0; i<numVertices(); ++i)
+    equ.setBatchVariable("x", &vx[0]);
+    equ.setBatchVariable("y", &vy[0]);
+    equ.setBatchVariable("z", &vz[0]);
+    equ.setBatchVariable("i", &vindex[0]);
+    equ.setBatchVariable("s", &vs[0]);
+    equ.setBatchVariable("t", &vt[0]);
+    equ.setBatchVariable("red", &red[0]);
+    equ.setBatchVariable("green", &green[0]);
+    equ.setBatchVariable("blue", &blue[0]);
+    equ.setBatchVariable("alpha", &alpha[0]);
+    equ.setBatchVariable("bright", &bright[0]);
+
+    for (uint start=0; start<numVertices(); start += blockSize)
     {
+        const uint num = std::min(blockSize, numVertices() - start);
+
         // copy input variables
-        VertexType * v = &vertex_[i * numVertexComponents()];
-        vx = v[0];
-        vy = v[1];
-        vz = v[2];
-        vindex = i;
-        TextureCoordType * t = &texcoord_[i * numTextureCoordComponents()];
-        vs = t[0];
-        vt = t[1];
-        vindex = i;
-        ColorType * c = &color_[i * numColorComponents()];
-        red = c[0];
-        green = c[1];
-        blue = c[2];
-        alpha = c[3];
-        bright = 1;
-
-        equ.eval();
+        for (uint i=0; i<num; ++i)
+        {
+            const uint k = start + i;
+            const VertexType * v = &vertex_[k * numVertexComponents()];
+            vx[i] = v[0];
+            vy[i] = v[1];
+            vz[i] = v[2];
+            vindex[i] = k;
+            const TextureCoordType * t = &texcoord_[k * numTextureCoordComponents()];
+            vs[i] = t[0];
+            vt[i] = t[1];
+            const ColorType * c = &color_[k * numColorComponents()];
+            red[i] = c[0];
+            green[i] = c[1];
+            blue[i] = c[2];
+            alpha[i] = c[3];
+            bright[i] = 1;
+        }
+
+        equ.evalBatch(0, num);
 
         // assign result from equation
-        v[0] = vx;
-        v[1] = vy;
-        v[2] = vz;
-        t[0] = vs;
-        t[1] = vt;
-        c[0] = std::max(0.0, std::min(1.0, red * bright ));
-        c[1] = std::max(0.0, std::min(1.0, green * bright ));
-        c[2] = std::max(0.0, std::min(1.0, blue * bright ));
-        c[3] = std::max(0.0, std::min(1.0, alpha ));
+        for (uint i=0; i<num; ++i)
+        {
+            const uint k = start + i;
+            VertexType * v = &vertex_[k * numVertexComponents()];
+            v[0] = vx[i];
+            v[1] = vy[i];
+            v[2] = vz[i];
+            TextureCoordType * t = &texcoord_[k * numTextureCoordComponents()];
+            t[0] = vs[i];
+            t[1] = vt[i];
+            ColorType * c = &color_[k * numColorComponents()];
+            c[0] = std::max(0.0, std::min(1.0, red[i] * bright[i] ));
+            c[1] = std::max(0.0, std::min(1.0, green[i] * bright[i] ));
+            c[2] = std::max(0.0, std::min(1.0, blue[i] * bright[i] ));
+            c[3] = std::max(0.0, std::min(1.0, alpha[i] ));
+        }
 
-        progress_ = (i * 100) / numVertices();
+        progress_ = ((start + num) * 100) / numVertices();
     }
 
     return true;
@@ -195,7 +195,7 @@ public:
 
     /** Returns true when the ray intersects with a triangle of the geometry.
         If @p pos is given, it will be set to the intersection position.
-        @note Not terribly efficient */
+        The first call after a change builds a bounding volume hierarchy. */
     bool intersects_any(const Vec3& ray_origin, const Vec3& ray_direction,
                         Vec3 * pos = 0) const;
 
@@ -204,10 +204,26 @@ public:
         If @p pos is given, it will be set to the intersection position.
         if @p triIndex is given, it will be set to the index of the intersecting
         triangle.
-        @note Not terribly efficient */
+        The first call after a change builds a bounding volume hierarchy. */
     bool intersects(const Vec3& ray_origin, const Vec3& ray_direction,
                     Vec3 * pos = nullptr, IndexType* triIndex = nullptr) const;
 
+    /** Closest intersection for @p num rays at once.
+        @p hit receives true or false for each ray, @p pos and @p triIndex
+        are optional arrays like in intersects().
+        @p numThreads is the number of threads to use, 0 for all cores.
+        Returns the number of rays that hit the geometry. */
+    size_t intersects_many(size_t num,
+                           const Vec3* ray_origins, const Vec3* ray_directions,
+                           bool* hit, Vec3* pos = nullptr,
+                           IndexType* triIndex = nullptr,
+                           uint numThreads = 0) const;
+
+    /** Same as intersects() but tests every triangle without
+        acceleration structure. Used for small geometries and for testing. */
+    bool intersects_linear(const Vec3& ray_origin, const Vec3& ray_direction,
+                           Vec3 * pos = nullptr, IndexType* triIndex = nullptr) const;
+
     /** Creates some JavaScript code snippet defining some arrays. */
     QString toJavaScriptArray(const QString& baseName,
                               bool withNormals = true,
@@ -232,7 +248,8 @@ public:
         change the Geometry. */
     void setChanged();
 
-    /** Returns a pointer to numVertices() * 3 coordinates */
+    /** Returns a pointer to numVertices() * 3 coordinates.
+        Call setChanged() after modifying the positions. */
     VertexType * vertices() { return &vertex_[0]; }
     /** Returns a pointer to numVertices() * 3 coordinates */
     NormalType * normals() { return &normal_[0]; }
@@ -0,0 +1,411 @@
+/** @file geometrybvh.cpp
+
+    @brief Bounding volume hierarchy for ray queries on Geometry triangles
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include "GeometryBvh.h"
+#include "Geometry.h"
+#include "math/intersection.h"
+
+namespace MO {
+namespace GEOM {
+
+namespace {
+
+    /** Number of bins for evaluating split planes */
+    const uint32_t numBins = 16;
+    /** Maximum triangles in a leaf if splitting is not cheaper */
+    const uint32_t maxLeafSize = 8;
+    /** Deeper nodes become leafs, the traversal stack relies on it */
+    const uint32_t maxDepth = 60;
+
+    Float surfaceArea(const Vec3& bmin, const Vec3& bmax)
+    {
+        const Vec3 d = bmax - bmin;
+        return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    /** Slab test, returns entry distance in units of the ray direction */
+    bool intersectBox(const GeometryBvh::Node& n,
+                      const Vec3& ro, const Vec3& invDir, Float& tnear)
+    {
+        Float t1 = (n.bmin.x - ro.x) * invDir.x,
+              t2 = (n.bmax.x - ro.x) * invDir.x,
+              tmin = std::min(t1, t2),
+              tmax = std::max(t1, t2);
+
+        t1 = (n.bmin.y - ro.y) * invDir.y;
+        t2 = (n.bmax.y - ro.y) * invDir.y;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+
+        t1 = (n.bmin.z - ro.z) * invDir.z;
+        t2 = (n.bmax.z - ro.z) * invDir.z;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+
+        tnear = std::max(tmin, Float(0));
+        return tmax >= tnear;
+    }
+
+} // namespace
+
+
+struct GeometryBvh::Build
+{
+    struct Task
+    {
+        uint32_t node, begin, end, depth;
+    };
+
+    struct Bin
+    {
+        Bin()
+            : bmin  (std::numeric_limits<Float>::max())
+            , bmax  (-std::numeric_limits<Float>::max())
+            , count (0)
+        { }
+
+        void grow(const Vec3& mi, const Vec3& ma)
+        {
+            bmin = glm::min(bmin, mi);
+            bmax = glm::max(bmax, ma);
+        }
+
+        Vec3 bmin, bmax;
+        uint32_t count;
+    };
+
+    Build(GeometryBvh * bvh) : bvh(bvh) { }
+
+    void run(const Geometry& geom);
+    /** Sets the bounds of the node and returns the centroid bounds */
+    void calcBounds(const Task& t, Vec3& cmin, Vec3& cmax);
+    /** Finds the best split plane, returns false if a leaf is cheaper */
+    bool findSplit(const Task& t, const Vec3& cmin, const Vec3& cmax,
+                   int& axis, uint32_t& split);
+
+    GeometryBvh * bvh;
+    std::vector<Vec3> triMin, triMax, center;
+    std::vector<uint32_t> order;
+    Float padding;
+};
+
+
+GeometryBvh::GeometryBvh()
+    : depth_    (0)
+{
+}
+
+void GeometryBvh::clear()
+{
+    nodes_.clear();
+    triIndex_.clear();
+    corners_.clear();
+    depth_ = 0;
+}
+
+size_t GeometryBvh::memory() const
+{
+    return nodes_.capacity() * sizeof(Node)
+         + triIndex_.capacity() * sizeof(uint32_t)
+         + corners_.capacity() * sizeof(Vec3);
+}
+
+void GeometryBvh::build(const Geometry& geom)
+{
+    clear();
+
+    if (geom.numTriangles() == 0)
+        return;
+
+    Build b(this);
+    b.run(geom);
+}
+
+void GeometryBvh::Build::run(const Geometry& geom)
+{
+    const uint32_t num = geom.numTriangles();
+
+    // bounds and centroids of each triangle
+    triMin.resize(num);
+    triMax.resize(num);
+    center.resize(num);
+    order.resize(num);
+    Vec3 gmin(std::numeric_limits<Float>::max()),
+         gmax(-std::numeric_limits<Float>::max());
+    for (uint32_t i=0; i<num; ++i)
+    {
+        const Vec3 t0 = Vec3(geom.triangle(i, 0)[0], geom.triangle(i, 0)[1], geom.triangle(i, 0)[2]),
+                   t1 = Vec3(geom.triangle(i, 1)[0], geom.triangle(i, 1)[1], geom.triangle(i, 1)[2]),
+                   t2 = Vec3(geom.triangle(i, 2)[0], geom.triangle(i, 2)[1], geom.triangle(i, 2)[2]);
+        triMin[i] = glm::min(t0, glm::min(t1, t2));
+        triMax[i] = glm::max(t0, glm::max(t1, t2));
+        center[i] = (triMin[i] + triMax[i]) * Float(.5);
+        order[i] = i;
+        gmin = glm::min(gmin, triMin[i]);
+        gmax = glm::max(gmax, triMax[i]);
+    }
+
+    // boxes are slightly enlarged to not miss flat boxes due to rounding
+    const Vec3 ext = gmax - gmin;
+    padding = std::max(Float(1e-6) * std::max(ext.x, std::max(ext.y, ext.z)),
+                       Float(1e-12));
+
+    bvh->nodes_.reserve(num * 2);
+    bvh->nodes_.push_back(Node());
+
+    std::vector<Task> stack;
+    stack.push_back({ 0, 0, num, 0 });
+
+    while (!stack.empty())
+    {
+        const Task t = stack.back();
+        stack.pop_back();
+
+        bvh->depth_ = std::max(bvh->depth_, size_t(t.depth));
+
+        Vec3 cmin, cmax;
+        calcBounds(t, cmin, cmax);
+
+        int axis;
+        uint32_t split;
+        uint32_t mid = t.begin;
+        if (t.depth < maxDepth && findSplit(t, cmin, cmax, axis, split))
+        {
+            const Float scale = Float(numBins) / (cmax[axis] - cmin[axis]);
+            mid = std::partition(&order[t.begin], &order[0] + t.end,
+                                 [=](uint32_t i)
+            {
+                uint32_t b = (center[i][axis] - cmin[axis]) * scale;
+                return std::min(b, numBins - 1) < split;
+            }) - &order[0];
+        }
+
+        // leaf
+        if (mid == t.begin || mid == t.end)
+        {
+            bvh->nodes_[t.node].first = t.begin;
+            bvh->nodes_[t.node].count = t.end - t.begin;
+            continue;
+        }
+
+        // inner node
+        const uint32_t left = bvh->nodes_.size();
+        bvh->nodes_.push_back(Node());
+        bvh->nodes_.push_back(Node());
+        bvh->nodes_[t.node].first = left;
+        bvh->nodes_[t.node].count = 0;
+
+        stack.push_back({ left + 1, mid, t.end, t.depth + 1 });
+        stack.push_back({ left, t.begin, mid, t.depth + 1 });
+    }
+
+    // copy triangles in leaf order
+    bvh->triIndex_ = order;
+    bvh->corners_.resize(num * 3);
+    for (uint32_t i=0; i<num; ++i)
+    for (int j=0; j<3; ++j)
+    {
+        auto v = geom.triangle(order[i], j);
+        bvh->corners_[i * 3 + j] = Vec3(v[0], v[1], v[2]);
+    }
+}
+
+void GeometryBvh::Build::calcBounds(const Task& t, Vec3& cmin, Vec3& cmax)
+{
+    Vec3 bmin(std::numeric_limits<Float>::max()),
+         bmax(-std::numeric_limits<Float>::max());
+    cmin = bmin;
+    cmax = bmax;
+    for (uint32_t i = t.begin; i < t.end; ++i)
+    {
+        const uint32_t k = order[i];
+        bmin = glm::min(bmin, triMin[k]);
+        bmax = glm::max(bmax, triMax[k]);
+        cmin = glm::min(cmin, center[k]);
+        cmax = glm::max(cmax, center[k]);
+    }
+
+    Node & n = bvh->nodes_[t.node];
+    n.bmin = bmin - Vec3(padding);
+    n.bmax = bmax + Vec3(padding);
+}
+
+bool GeometryBvh::Build::findSplit(
+        const Task& t, const Vec3& cmin, const Vec3& cmax, int& axis, uint32_t& split)
+{
+    const uint32_t count = t.end - t.begin;
+    if (count <= 2)
+        return false;
+
+    const Node & n = bvh->nodes_[t.node];
+    const Float leafCost = count * surfaceArea(n.bmin, n.bmax);
+    Float bestCost = std::numeric_limits<Float>::max();
+    axis = -1;
+
+    for (int a=0; a<3; ++a)
+    {
+        const Float extent = cmax[a] - cmin[a];
+        if (extent <= Float(0))
+            continue;
+
+        // sort centroids into bins
+        Bin bins[numBins];
+        const Float scale = Float(numBins) / extent;
+        for (uint32_t i = t.begin; i < t.end; ++i)
+        {
+            const uint32_t k = order[i];
+            uint32_t b = (center[k][a] - cmin[a]) * scale;
+            b = std::min(b, numBins - 1);
+            bins[b].grow(triMin[k], triMax[k]);
+            ++bins[b].count;
+        }
+
+        // sweep from right to get the costs of the right sides
+        Float rightArea[numBins];
+        uint32_t rightCount[numBins];
+        Bin acc;
+        for (uint32_t i = numBins - 1; i > 0; --i)
+        {
+            acc.count += bins[i].count;
+            if (bins[i].count)
+                acc.grow(bins[i].bmin, bins[i].bmax);
+            rightArea[i] = acc.count ? surfaceArea(acc.bmin, acc.bmax) : Float(0);
+            rightCount[i] = acc.count;
+        }
+
+        // sweep from left and evaluate split between bin i-1 and i
+        acc = Bin();
+        for (uint32_t i = 1; i < numBins; ++i)
+        {
+            acc.count += bins[i-1].count;
+            if (bins[i-1].count)
+                acc.grow(bins[i-1].bmin, bins[i-1].bmax);
+            if (!acc.count || !rightCount[i])
+                continue;
+
+            const Float cost = acc.count * surfaceArea(acc.bmin, acc.bmax)
+                             + rightCount[i] * rightArea[i];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                axis = a;
+                split = i;
+            }
+        }
+    }
+
+    if (axis < 0)
+        return false;
+
+    return bestCost < leafCost || count > maxLeafSize;
+}
+
+
+bool GeometryBvh::intersects(const Vec3& ro, const Vec3& rd,
+                             Vec3 * outpos, uint32_t * outTri, bool any) const
+{
+    if (nodes_.empty())
+        return false;
+
+    // avoid infinities in the slab test
+    const Float tiny = Float(1e-30);
+    const Vec3 invDir(
+            Float(1) / (std::abs(rd.x) > tiny ? rd.x : tiny),
+            Float(1) / (std::abs(rd.y) > tiny ? rd.y : tiny),
+            Float(1) / (std::abs(rd.z) > tiny ? rd.z : tiny));
+    const Float rdLength = glm::length(rd);
+
+    Float closest = -1, tnear;
+    uint32_t closestTri = 0;
+    Vec3 pos, closestPos;
+
+    if (!intersectBox(nodes_[0], ro, invDir, tnear))
+        return false;
+
+    uint32_t stack[maxDepth + 4];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp)
+    {
+        const Node & n = nodes_[stack[--sp]];
+
+        if (n.isLeaf())
+        {
+            for (uint32_t i = n.first; i < n.first + n.count; ++i)
+            {
+                if (!MATH::intersect_ray_triangle(ro, rd,
+                            corners_[i*3], corners_[i*3+1], corners_[i*3+2], &pos))
+                    continue;
+
+                const Float dist = glm::distance(ro, pos);
+                // ties are resolved like the linear search
+                if (closest < 0 || dist < closest
+                    || (dist == closest && triIndex_[i] < closestTri))
+                {
+                    closest = dist;
+                    closestTri = triIndex_[i];
+                    closestPos = pos;
+                    if (any)
+                        break;
+                }
+            }
+            if (any && closest >= 0)
+                break;
+            continue;
+        }
+
+        // visit closer child first
+        const Node & l = nodes_[n.first],
+                   & r = nodes_[n.first + 1];
+        Float tl, tr;
+        bool hl = intersectBox(l, ro, invDir, tl),
+             hr = intersectBox(r, ro, invDir, tr);
+        if (closest >= 0)
+        {
+            hl = hl && tl * rdLength <= closest;
+            hr = hr && tr * rdLength <= closest;
+        }
+
+        if (hl && hr)
+        {
+            if (tl <= tr)
+            {
+                stack[sp++] = n.first + 1;
+                stack[sp++] = n.first;
+            }
+            else
+            {
+                stack[sp++] = n.first;
+                stack[sp++] = n.first + 1;
+            }
+        }
+        else if (hl)
+            stack[sp++] = n.first;
+        else if (hr)
+            stack[sp++] = n.first + 1;
+    }
+
+    if (closest < 0)
+        return false;
+
+    if (outpos)
+        *outpos = closestPos;
+    if (outTri)
+        *outTri = closestTri;
+    return true;
+}
+
+
+} // namespace GEOM
+} // namespace MO
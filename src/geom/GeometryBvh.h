@@ -0,0 +1,95 @@
+/** @file geometrybvh.h
+
+    @brief Bounding volume hierarchy for ray queries on Geometry triangles
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_GEOM_GEOMETRYBVH_H
+#define MOSRC_GEOM_GEOMETRYBVH_H
+
+#include <vector>
+#include <cinttypes>
+
+#include "types/vector.h"
+
+namespace MO {
+namespace GEOM {
+
+class Geometry;
+
+/** A bounding volume hierarchy over the triangles of a Geometry.
+
+    Built with the surface area heuristic from binned centroids
+    and stored as a flat array of nodes.
+    Children of an inner node are always stored next to each other.
+
+    The triangle corners are copied in leaf order, so the hierarchy
+    stays valid while the Geometry is unchanged but does not need it
+    for queries. Queries are const and thread-safe.
+    */
+class GeometryBvh
+{
+public:
+
+    struct Node
+    {
+        Vec3 bmin;
+        /** Leaf: first triangle in leaf order, inner: index of left child */
+        uint32_t first;
+        Vec3 bmax;
+        /** Number of triangles, 0 for inner nodes */
+        uint32_t count;
+
+        bool isLeaf() const { return count != 0; }
+    };
+
+    GeometryBvh();
+
+    // ----------- getter --------------
+
+    bool isEmpty() const { return nodes_.empty(); }
+    size_t numNodes() const { return nodes_.size(); }
+    size_t numTriangles() const { return triIndex_.size(); }
+    /** Depth of the deepest leaf */
+    size_t depth() const { return depth_; }
+    size_t memory() const;
+
+    // ------------ build --------------
+
+    /** Creates the hierarchy for all triangles in @p geom */
+    void build(const Geometry& geom);
+
+    void clear();
+
+    // ----------- queries -------------
+
+    /** Returns the closest intersection of the ray with a triangle.
+        If @p pos is given, it will be set to the intersection position.
+        If @p triIndex is given, it will be set to the index of the
+        triangle in the Geometry.
+        If @p any is true, the first found intersection is returned
+        which is not necessarily the closest. */
+    bool intersects(const Vec3& ray_origin, const Vec3& ray_direction,
+                    Vec3 * pos = nullptr, uint32_t * triIndex = nullptr,
+                    bool any = false) const;
+
+private:
+
+    struct Build;
+
+    std::vector<Node> nodes_;
+    /** Index of triangle in Geometry, in leaf order */
+    std::vector<uint32_t> triIndex_;
+    /** Three corners per triangle, in leaf order */
+    std::vector<Vec3> corners_;
+    size_t depth_;
+};
+
+} // namespace GEOM
+} // namespace MO
+
+#endif // MOSRC_GEOM_GEOMETRYBVH_H
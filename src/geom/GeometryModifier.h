@@ -94,6 +94,12 @@ public:
     /** Applies the modifications */
     virtual void execute(Geometry * g) = 0;
 
+    /** Return false when the result does not only depend on the
+        properties and the input geometry (e.g. for scripts).
+        GeometryModifierChain will not cache the result of this
+        and all following modifiers then. */
+    virtual bool isCacheable() const { return true; }
+
 protected:
 
     /** Call this in execute to update the progress that this
@@ -0,0 +1,197 @@
+/** @file geometrymodifiercache.cpp
+
+    @brief Shared cache of intermediate GeometryModifierChain results
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <list>
+#include <algorithm>
+#include <unordered_map>
+#include <mutex>
+
+#include "GeometryModifierCache.h"
+#include "Geometry.h"
+#include "io/log_geom.h"
+
+namespace MO {
+namespace GEOM {
+
+class GeometryModifierCache::Private
+{
+public:
+    struct Entry
+    {
+        Geometry * geom;
+        size_t memory;
+        /** position in lru list */
+        std::list<uint64_t>::iterator lru;
+    };
+
+    Private()
+        : maxMemory (size_t(256) << 20)
+        , memory    (0)
+    { }
+
+    /** Drops least recently used entries until memory <= @p bytes */
+    void shrink(size_t bytes);
+    void remove(std::unordered_map<uint64_t, Entry>::iterator i);
+
+    std::unordered_map<uint64_t, Entry> entries;
+    /** most recently used first */
+    std::list<uint64_t> lru;
+    size_t maxMemory, memory;
+    std::mutex mutex;
+};
+
+
+GeometryModifierCache::GeometryModifierCache()
+    : p_    (new Private())
+{
+    MO_DEBUG_GEOM("GeometryModifierCache::GeometryModifierCache()");
+}
+
+GeometryModifierCache::~GeometryModifierCache()
+{
+    MO_DEBUG_GEOM("GeometryModifierCache::~GeometryModifierCache()");
+
+    p_->shrink(0);
+    delete p_;
+}
+
+GeometryModifierCache * GeometryModifierCache::p_getInstance_()
+{
+    static GeometryModifierCache * instance = new GeometryModifierCache();
+    return instance;
+}
+
+size_t GeometryModifierCache::maxMemory()
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    return c->p_->maxMemory;
+}
+
+size_t GeometryModifierCache::memory()
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    return c->p_->memory;
+}
+
+size_t GeometryModifierCache::count()
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    return c->p_->entries.size();
+}
+
+void GeometryModifierCache::setMaxMemory(size_t bytes)
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    c->p_->maxMemory = bytes;
+    c->p_->shrink(bytes);
+}
+
+void GeometryModifierCache::clear()
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    c->p_->shrink(0);
+}
+
+bool GeometryModifierCache::contains(uint64_t key)
+{
+    auto c = p_getInstance_();
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+    return c->p_->entries.find(key) != c->p_->entries.end();
+}
+
+bool GeometryModifierCache::restore(uint64_t key, Geometry * g)
+{
+    auto c = p_getInstance_();
+    Geometry * geom;
+    {
+        std::lock_guard<std::mutex> lock(c->p_->mutex);
+
+        auto i = c->p_->entries.find(key);
+        if (i == c->p_->entries.end())
+            return false;
+
+        // move to front
+        c->p_->lru.splice(c->p_->lru.begin(), c->p_->lru, i->second.lru);
+
+        geom = i->second.geom;
+        geom->addRef("GeometryModifierCache restore");
+    }
+
+    // copy outside of lock
+    g->copyFrom(*geom);
+    geom->releaseRef("GeometryModifierCache restore finish");
+
+    MO_DEBUG_GEOM("GeometryModifierCache::restore(" << key << ")");
+    return true;
+}
+
+void GeometryModifierCache::store(uint64_t key, const Geometry& g)
+{
+    // count some overhead for empty geometries
+    const size_t mem = std::max(size_t(1024), size_t(g.memory()));
+
+    auto c = p_getInstance_();
+    {
+        std::lock_guard<std::mutex> lock(c->p_->mutex);
+        if (mem > c->p_->maxMemory
+            || c->p_->entries.find(key) != c->p_->entries.end())
+            return;
+    }
+
+    // copy outside of lock
+    auto geom = new Geometry(g);
+
+    std::lock_guard<std::mutex> lock(c->p_->mutex);
+
+    // stored by other thread meanwhile?
+    if (c->p_->entries.find(key) != c->p_->entries.end()
+        || mem > c->p_->maxMemory)
+    {
+        geom->releaseRef("GeometryModifierCache store duplicate");
+        return;
+    }
+
+    c->p_->shrink(c->p_->maxMemory - mem);
+
+    c->p_->lru.push_front(key);
+    Private::Entry e;
+    e.geom = geom;
+    e.memory = mem;
+    e.lru = c->p_->lru.begin();
+    c->p_->entries.insert(std::make_pair(key, e));
+    c->p_->memory += mem;
+
+    MO_DEBUG_GEOM("GeometryModifierCache::store(" << key << ") "
+                  << mem << " bytes, total " << c->p_->memory);
+}
+
+void GeometryModifierCache::Private::remove(
+        std::unordered_map<uint64_t, Entry>::iterator i)
+{
+    memory -= i->second.memory;
+    lru.erase(i->second.lru);
+    i->second.geom->releaseRef("GeometryModifierCache remove");
+    entries.erase(i);
+}
+
+void GeometryModifierCache::Private::shrink(size_t bytes)
+{
+    while (memory > bytes && !lru.empty())
+        remove(entries.find(lru.back()));
+}
+
+
+} // namespace GEOM
+} // namespace MO
@@ -0,0 +1,79 @@
+/** @file geometrymodifiercache.h
+
+    @brief Shared cache of intermediate GeometryModifierChain results
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_GEOM_GEOMETRYMODIFIERCACHE_H
+#define MOSRC_GEOM_GEOMETRYMODIFIERCACHE_H
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace MO {
+namespace GEOM {
+
+class Geometry;
+
+/** Singleton least-recently-used cache of Geometry copies.
+
+    GeometryModifierChain::execute() stores the Geometry after each
+    modifier, keyed by a hash of all settings up to that modifier,
+    and resumes from the longest cached prefix.
+    The cache is shared by all chains and threads and limited by maxMemory().
+    */
+class GeometryModifierCache
+{
+    GeometryModifierCache();
+    ~GeometryModifierCache();
+
+public:
+
+    // ------------ getter -------------
+
+    /** Memory limit in bytes */
+    static size_t maxMemory();
+
+    /** Currently used memory in bytes */
+    static size_t memory();
+
+    /** Number of cached geometries */
+    static size_t count();
+
+    // ------------ setter -------------
+
+    /** Sets the memory limit in bytes, a value of 0 disables the cache */
+    static void setMaxMemory(size_t bytes);
+
+    /** Releases all cached geometries */
+    static void clear();
+
+    // ------------- cache -------------
+
+    /** Copies the geometry stored for @p key into @p g.
+        Returns false if there is none. */
+    static bool restore(uint64_t key, Geometry * g);
+
+    /** Stores a copy of @p g for @p key.
+        Least recently used entries are dropped to stay below maxMemory(). */
+    static void store(uint64_t key, const Geometry& g);
+
+    /** Returns true if a geometry is stored for @p key */
+    static bool contains(uint64_t key);
+
+private:
+
+    static GeometryModifierCache * p_getInstance_();
+
+    class Private;
+    Private * p_;
+};
+
+} // namespace GEOM
+} // namespace MO
+
+#endif // MOSRC_GEOM_GEOMETRYMODIFIERCACHE_H
@@ -8,11 +8,18 @@
     <p>created 8/14/2014</p>
 */
 
+#include <QFileInfo>
+#include <QDateTime>
+
 #include "GeometryModifierChain.h"
 #include "io/DataStream.h"
+#include "io/FileManager.h"
 #include "io/error.h"
 #include "io/log_geom.h"
+#include "math/hash.h"
+#include "Geometry.h"
 #include "GeometryModifier.h"
+#include "GeometryModifierCache.h"
 #include "GeometryModifierCreate.h"
 
 namespace MO {
@@ -274,20 +281,76 @@ bool GeometryModifierChain::deleteModifier(GeometryModifier *g)
     return true;
 }
 
+std::vector<uint64_t> GeometryModifierChain::cacheKeys() const
+{
+    std::vector<uint64_t> keys;
+
+    uint64_t key = MATH::getHashFnv64(0, 0);
+    for (auto m : modifiers_)
+    {
+        // script results can not be reproduced from settings
+        if (!m->isCacheable())
+            break;
+
+        if (m->isEnabled())
+        {
+            QByteArray data;
+            {
+                IO::DataStream io(&data, QIODevice::WriteOnly);
+                io << m->className();
+                m->serialize(io);
+
+                // changes to imported files
+                if (auto mc = dynamic_cast<GeometryModifierCreate*>(m))
+                if (mc->isFile())
+                {
+                    QFileInfo inf(IO::fileManager().localFilename(mc->filename()));
+                    io << inf.absoluteFilePath() << (qint64)inf.size()
+                       << (qint64)inf.lastModified().toMSecsSinceEpoch();
+                }
+            }
+            key = MATH::getHashFnv64(data.constData(), data.size(), key);
+        }
+        keys.push_back(key);
+    }
+
+    return keys;
+}
+
 void GeometryModifierChain::execute(Geometry *g, Object * o) const
 {
     doStop_ = false;
     curMod_ = 0;
 
-    for (auto m : modifiers_)
+    // resume from longest cached prefix
+    // (only when building from scratch)
+    std::vector<uint64_t> keys;
+    size_t start = 0;
+    if (!g->numVertices() && GeometryModifierCache::maxMemory() > 0)
+    {
+        keys = cacheKeys();
+        for (size_t i = keys.size(); i > 0; --i)
+        if (GeometryModifierCache::restore(keys[i-1], g))
+        {
+            MO_DEBUG_GEOM("GeometryModifierChain::execute() resuming at modifier " << i);
+            start = i;
+            break;
+        }
+    }
+
+    for (size_t i = start; i < size_t(modifiers_.size()); ++i)
     {
         if (doStop_)
             break;
 
+        auto m = modifiers_[i];
         if (m->isEnabled())
         {
             curMod_ = m;
             m->executeBase(g, o);
+
+            if (i < keys.size() && !doStop_)
+                GeometryModifierCache::store(keys[i], *g);
         }
     }
 }
@@ -11,6 +11,9 @@
 #ifndef MOSRC_GEOM_GEOMETRYMODIFIERCHAIN_H
 #define MOSRC_GEOM_GEOMETRYMODIFIERCHAIN_H
 
+#include <vector>
+#include <cinttypes>
+
 #include <QList>
 #include <QMap>
 #include "io/filetypes.h"
@@ -105,9 +108,16 @@ public:
     // ----------- execution --------------
 
     /** Execute the whole chain.
-        If an object is given, it is made available to scripts */
+        If an object is given, it is made available to scripts.
+        When @p g is empty, the results of unchanged leading modifiers
+        are taken from the GeometryModifierCache and each new result is stored there. */
     void execute(Geometry * g, Object* o = 0) const;
 
+    /** Returns a hash for each modifier of all settings up to and including
+        that modifier. The list ends before the first modifier
+        that is not GeometryModifier::isCacheable(). */
+    std::vector<uint64_t> cacheKeys() const;
+
     /** Will stop execution as soon as possible when called asynchronously to execute() */
     void stop();
 
@@ -25,6 +25,9 @@ public:
 
     MO_GEOMETRYMODIFIER_CONSTRUCTOR(GeometryModifierPython34)
 
+    /** Scripts can access anything */
+    virtual bool isCacheable() const Q_DECL_OVERRIDE { return false; }
+
     // ------------- getter ------------------
 
     // ------------ setter -------------------
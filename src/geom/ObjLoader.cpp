@@ -19,16 +19,26 @@
 */
 
 
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDir>
 #include <QMutexLocker>
 
 #include "ObjLoader.h"
+#include "io/DataStream.h"
 #include "io/log_io.h"
 #include "io/log_geom.h"
 #include "io/error.h"
+#include "math/hash.h"
 #include "Geometry.h"
 
 /** Writes the textstream to the internal log.
@@ -57,9 +67,18 @@ namespace GEOM {
 std::map<QString, ObjLoader*> ObjLoader::instances_;
 QMutex ObjLoader::instanceMutex_;
 
+namespace {
+
+    std::atomic<bool> cacheEnabled_(true);
+    std::atomic<qint64> cacheMinimumSize_(qint64(4) << 20);
+    std::atomic<unsigned int> numberThreads_(0);
+
+} // namespace
+
 ObjLoader::ObjLoader()
     :   progress_   (0),
-        isLoading_  (false)
+        isLoading_  (false),
+        fromCache_  (false)
 {
 }
 
@@ -69,29 +88,78 @@ void ObjLoader::clear()
 
     material_.clear();
     materialUse_.clear();
+    materialLibs_.clear();
 
     triangle_.clear();
+    line_.clear();
     vertex_.clear();
     normal_.clear();
     texCoord_.clear();
 }
 
+void ObjLoader::setCacheEnabled(bool enable) { cacheEnabled_ = enable; }
+bool ObjLoader::isCacheEnabled() { return cacheEnabled_; }
+void ObjLoader::setCacheMinimumSize(qint64 bytes) { cacheMinimumSize_ = bytes; }
+qint64 ObjLoader::cacheMinimumSize() { return cacheMinimumSize_; }
+void ObjLoader::setNumberThreads(unsigned int num) { numberThreads_ = num; }
+
+unsigned int ObjLoader::numberThreads()
+{
+    if (numberThreads_)
+        return numberThreads_;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+QString ObjLoader::cacheFilename(const QString &filename)
+{
+    return filename + ".mocache";
+}
+
 void ObjLoader::loadFile(const QString &filename)
 {
     MO_DEBUG_GEOM("ObjLoader::loadFile(" << filename << ")");
 
+    fromCache_ = false;
+
     QFile f(filename);
     if (!f.open(QIODevice::ReadOnly))
         MO_IO_ERROR(READ, "Could not load .obj file '" << filename <<"'\n"
                     << f.errorString());
 
-    const QByteArray a = f.readAll();
+    const bool useCache = isCacheEnabled() && f.size() >= cacheMinimumSize();
+    if (useCache && loadCache_(filename))
+    {
+        fromCache_ = true;
+        return;
+    }
 
     filename_ = filename;
 
-    loadFromMemory(a);
+    // parse directly on the mapped file
+    if (uchar * data = f.size() > 0 ? f.map(0, f.size()) : 0)
+    {
+        try
+        {
+            loadFromMemory(reinterpret_cast<const char*>(data), f.size());
+        }
+        catch (...)
+        {
+            f.unmap(data);
+            throw;
+        }
+        f.unmap(data);
+    }
+    else
+    {
+        const QByteArray a = f.readAll();
+        filename_ = filename;
+        loadFromMemory(a);
+    }
 
     filename_ = "";
+
+    if (useCache)
+        saveCache_(filename);
 }
 
 
@@ -169,23 +237,6 @@ namespace {
         return default_;
     }
 
-    int expectInt(const QString& s, int& x)
-    {
-        if (!skipWS(s, x))
-            MO_IO_ERROR(PARSE, "expected index, found end of line");
-
-        if (s.at(x).isNumber() || s.at(x) == '-')
-        {
-            int x2 = x;
-            ++x;
-            while (x < s.length() && s.at(x).isNumber())
-                    ++x;
-            return s.mid(x2, x - x2).toInt();
-        }
-        MO_IO_ERROR(PARSE, "expected index, found '"
-                    << s.right(s.length() - x) << "'");
-    }
-
     QString expectName(const QString& s, int& x)
     {
         if (!skipWS(s, x))
@@ -203,22 +254,6 @@ namespace {
                     << s.right(s.length() - x) << "'");
     }
 
-    /** Returns empty string if nothing found */
-    QString readName(const QString& s, int& x)
-    {
-        if (!skipWS(s, x)) return QString();
-
-        if (!s.at(x).isSpace())
-        {
-            int x2 = x;
-            ++x;
-            while (x < s.length() && !(s.at(x).isSpace()))
-                    ++x;
-            return s.mid(x2, x - x2);
-        }
-        return QString();
-    }
-
     /** Also handles material names that include spaces.
         @note Name must end with .mtl */
     QString readMaterialName(const QString& s, int& x, bool expect)
@@ -252,126 +287,547 @@ namespace {
         return QString();
     }
 
-    void expectChar(const QString& s, int& x, QChar c)
-    {
-        while (x < s.length() && s.at(x).isSpace()) ++x;
 
-        if (x == s.length())
-            MO_IO_ERROR(PARSE, "expected '" << c << "', found end of line");
 
-        if (s.at(x) != c)
-            MO_IO_ERROR(PARSE, "expected '" << c << "', found '"
-                        << s.right(s.length() - x) << "'");
-        ++x;
-    }
+    // ----------------- .obj parser -------------------
 
-    /** Returns vertex, texcoord and normal indices in i1, i2 and i3.
-        If texcoord or normal indices are not present, 0 is returned for each.
-        Indices might also be negative, meaning relative! */
-    void expectFaceVertex(const QString& s, int& x, int& i1, int& i2, int &i3)
+    /** Parse result of a range of lines of an .obj file */
+    struct ObjChunk
+    {
+        /** A statement that is evaluated after parsing */
+        struct Statement
+        {
+            /** Number of triangle and line vertices before the statement */
+            size_t triangle, line;
+            /** line number in chunk */
+            size_t lineNr;
+            QByteArray arg;
+        };
+
+        ObjChunk()
+            : begin(0), end(0), numLines(0)
+            , hasError(false), errorLine(0), errorColumn(0)
+        { }
+
+        const char * begin, * end;
+
+        std::vector<ObjLoader::Float> vertex, texCoord, normal;
+        /** Relative indices are resolved to the start of the chunk */
+        std::vector<ObjLoader::Vertex> triangle, line;
+        /** Position of each vertex with relative indices in triangle and line,
+            shifted left by 3 and combined with a mask of the
+            relative components (1 = vertex, 2 = texcoord, 4 = normal) */
+        std::vector<size_t> relTriangle, relLine;
+
+        std::vector<Statement> useMaterial, materialLib;
+        size_t numLines;
+
+        bool hasError;
+        std::string error;
+        size_t errorLine, errorColumn;
+    };
+
+    /** Parses the raw bytes of an ObjChunk */
+    class ObjParser
     {
-        i1 = expectInt(s, x);
+    public:
+        typedef ObjLoader::Float Float;
+        typedef ObjLoader::UInt UInt;
+        typedef ObjLoader::Vertex Vertex;
 
-        // statement ended?
-        if (x == s.length() || s.at(x) != '/')
+        explicit ObjParser(ObjChunk& c) : c_(c), p_(0), e_(0), line_(0) { }
+
+        /** Parses the whole chunk. Errors are stored in the ObjChunk.
+            @p bytesDone and @p progress are updated regularily */
+        void parse(std::atomic<size_t>& bytesDone, size_t bytesTotal,
+                   volatile int& progress)
         {
-            i2 = i3 = 0;
-            return;
+            const char * p = c_.begin;
+            size_t bytes = 0;
+            try
+            {
+                while (p < c_.end)
+                {
+                    auto e = static_cast<const char*>(memchr(p, '\n', c_.end - p));
+                    if (!e)
+                        e = c_.end;
+
+                    ++c_.numLines;
+                    line_ = p_ = p;
+                    e_ = e;
+                    parseLine_();
+
+                    bytes += e - p + 1;
+                    if (bytes >= (1 << 20))
+                    {
+                        progress = int(((bytesDone += bytes) * 100) / bytesTotal);
+                        bytes = 0;
+                    }
+                    p = e + 1;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                c_.hasError = true;
+                c_.error = e.what();
+                c_.errorLine = c_.numLines;
+                c_.errorColumn = p_ - line_;
+            }
+            bytesDone += bytes;
         }
-        else ++x;
 
-        if (s.at(x).isNumber())
-            i2 = expectInt(s, x);
-        else
-            i2 = 0;
+    private:
 
-        // statement ended?
-        if (x == s.length() || s.at(x) != '/')
+        struct ParseError : public std::exception
         {
-            i3 = 0;
-            return;
+            ParseError(const std::string& text) : text(text) { }
+            ~ParseError() throw() { }
+            const char * what() const throw() { return text.c_str(); }
+            std::string text;
+        };
+
+        static bool isWS_(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+        static bool isDigit_(char c) { return c >= '0' && c <= '9'; }
+
+        /** skips whitespace, returns true when line is not ended */
+        bool skipWS_()
+        {
+            while (p_ < e_ && isWS_(*p_))
+                ++p_;
+            return p_ < e_;
         }
-        else ++x;
 
-        if (s.at(x).isNumber())
-            i3 = expectInt(s, x);
-        else
-            i3 = 0;
-    }
+        /** Rest of line for error messages */
+        std::string rest_() const
+        {
+            const char * e = e_;
+            while (e > p_ && isWS_(e[-1]))
+                --e;
+            return std::string(p_, e - p_);
+        }
 
-} // namespace anonymous
+        /** Skips @p word and returns true when it is at the current position */
+        bool keyword_(const char * word, size_t len)
+        {
+            if (size_t(e_ - p_) > len && !memcmp(p_, word, len) && isWS_(p_[len]))
+            {
+                p_ += len;
+                return true;
+            }
+            return false;
+        }
 
+        static double pow10_(int e)
+        {
+            static const double tab[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+                1e21, 1e22 };
+            if (e >= 0 && e <= 22)
+                return tab[e];
+            return std::pow(10., e);
+        }
 
-bool ObjLoader::readFaceVertex_(const QString & s, int &x, Vertex & vertex, bool expect) const
-{
-    int v, t, n;
-    if (expect)
-        expectFaceVertex(s, x, v, t, n);
-    else
+        /** Reads a float, returns false and leaves position untouched
+            if there is none or it's not followed by whitespace */
+        bool readNumber_(Float& f)
+        {
+            const char * start = p_;
+            bool neg = false;
+            if (p_ < e_ && (*p_ == '-' || *p_ == '+'))
+                neg = *p_++ == '-';
+
+            uint64_t mant = 0;
+            int exp = 0, numDigits = 0;
+            bool any = false;
+            for (; p_ < e_ && isDigit_(*p_); ++p_, any = true)
+            {
+                if (numDigits < 19)
+                {
+                    mant = mant * 10 + (*p_ - '0');
+                    if (mant)
+                        ++numDigits;
+                }
+                else
+                    ++exp;
+            }
+            if (p_ < e_ && *p_ == '.')
+            {
+                for (++p_; p_ < e_ && isDigit_(*p_); ++p_, any = true)
+                {
+                    if (numDigits < 19)
+                    {
+                        mant = mant * 10 + (*p_ - '0');
+                        if (mant)
+                            ++numDigits;
+                        --exp;
+                    }
+                }
+            }
+            if (!any)
+            {
+                p_ = start;
+                return false;
+            }
+
+            if (p_ < e_ && (*p_ == 'e' || *p_ == 'E'))
+            {
+                ++p_;
+                bool eneg = false;
+                if (p_ < e_ && (*p_ == '-' || *p_ == '+'))
+                    eneg = *p_++ == '-';
+                int e = 0;
+                for (; p_ < e_ && isDigit_(*p_); ++p_)
+                    e = std::min(e * 10 + (*p_ - '0'), 100000);
+                exp += eneg ? -e : e;
+            }
+
+            if (p_ < e_ && !isWS_(*p_))
+            {
+                p_ = start;
+                return false;
+            }
+
+            double v = double(mant);
+            if (exp < 0 && exp >= -22)
+                v /= pow10_(-exp);
+            else if (exp)
+                v *= pow10_(exp);
+            f = Float(neg ? -v : v);
+            return true;
+        }
+
+        Float expectFloat_()
+        {
+            if (!skipWS_())
+                throw ParseError("expected float, found end of line");
+            Float f;
+            if (!readNumber_(f))
+                throw ParseError("expected float, found '" + rest_() + "'");
+            return f;
+        }
+
+        /** Trys to read a float, returns @p def when there was none */
+        Float readFloat_(Float def)
+        {
+            Float f;
+            if (!skipWS_() || !readNumber_(f))
+                return def;
+            return f;
+        }
+
+        long expectInt_()
+        {
+            bool neg = false;
+            if (p_ < e_ && *p_ == '-')
+            {
+                neg = true;
+                ++p_;
+            }
+            if (!(p_ < e_ && isDigit_(*p_)))
+                throw ParseError("expected index, found '" + rest_() + "'");
+            long i = 0;
+            for (; p_ < e_ && isDigit_(*p_); ++p_)
+                i = i * 10 + (*p_ - '0');
+            return neg ? -i : i;
+        }
+
+        /** Returns the index, negative indices are resolved relative to @p count */
+        static UInt resolve_(long index, size_t count, int& rel, int bit)
+        {
+            if (index >= 0)
+                return UInt(index);
+            rel |= bit;
+            return UInt(long(count) + index + 1);
+        }
+
+        /** Reads v, v/t, v/t/n or v//n */
+        bool readFaceVertex_(Vertex& v, int& rel, bool expect)
+        {
+            if (!skipWS_())
+            {
+                if (expect)
+                    throw ParseError("expected index, found end of line");
+                return false;
+            }
+            if (!(isDigit_(*p_) || *p_ == '-'))
+            {
+                if (expect)
+                    throw ParseError("expected index, found '" + rest_() + "'");
+                return false;
+            }
+
+            long vi = expectInt_(), ti = 0, ni = 0;
+            if (p_ < e_ && *p_ == '/')
+            {
+                ++p_;
+                if (p_ < e_ && (isDigit_(*p_) || *p_ == '-'))
+                    ti = expectInt_();
+                if (p_ < e_ && *p_ == '/')
+                {
+                    ++p_;
+                    if (p_ < e_ && (isDigit_(*p_) || *p_ == '-'))
+                        ni = expectInt_();
+                }
+            }
+
+            rel = 0;
+            v.v = resolve_(vi, c_.vertex.size() / ObjLoader::vertexComponents, rel, 1);
+            v.t = resolve_(ti, c_.texCoord.size() / ObjLoader::texCoordComponents, rel, 2);
+            v.n = resolve_(ni, c_.normal.size() / ObjLoader::normalComponents, rel, 4);
+            v.mat = 0;
+            return true;
+        }
+
+        void addPolyVertex_(std::vector<Vertex>& list, std::vector<size_t>& rel, size_t k)
+        {
+            if (polyRel_[k])
+                rel.push_back((list.size() << 3) | polyRel_[k]);
+            list.push_back(poly_[k]);
+        }
+
+        void addStatement_(std::vector<ObjChunk::Statement>& list, const char * end)
+        {
+            ObjChunk::Statement s;
+            s.triangle = c_.triangle.size();
+            s.line = c_.line.size();
+            s.lineNr = c_.numLines;
+            s.arg = QByteArray(p_, end - p_);
+            list.push_back(s);
+        }
+
+        void parseLine_()
+        {
+            if (!skipWS_() || *p_ == '#')
+                return;
+
+            // vertex data
+            if (keyword_("v", 1))
+            {
+                c_.vertex.push_back( expectFloat_() );
+                c_.vertex.push_back( expectFloat_() );
+                c_.vertex.push_back( expectFloat_() );
+                c_.vertex.push_back( readFloat_(1.f) );
+            }
+            // face data
+            else if (keyword_("f", 1))
+            {
+                poly_.clear();
+                polyRel_.clear();
+                Vertex v;
+                int rel;
+                while (readFaceVertex_(v, rel, poly_.size() < 2))
+                {
+                    poly_.push_back(v);
+                    polyRel_.push_back(rel);
+                }
+
+                // store line
+                if (poly_.size() == 2)
+                {
+                    addPolyVertex_(c_.line, c_.relLine, 0);
+                    addPolyVertex_(c_.line, c_.relLine, 1);
+                }
+                // or triangle fan
+                else
+                for (size_t i = 2; i < poly_.size(); ++i)
+                {
+                    addPolyVertex_(c_.triangle, c_.relTriangle, 0);
+                    addPolyVertex_(c_.triangle, c_.relTriangle, i - 1);
+                    addPolyVertex_(c_.triangle, c_.relTriangle, i);
+                }
+            }
+            // normal data
+            else if (keyword_("vn", 2))
+            {
+                c_.normal.push_back( expectFloat_() );
+                c_.normal.push_back( expectFloat_() );
+                c_.normal.push_back( expectFloat_() );
+            }
+            // texcoord data
+            else if (keyword_("vt", 2))
+            {
+                c_.texCoord.push_back( expectFloat_() );
+                c_.texCoord.push_back( expectFloat_() );
+                c_.texCoord.push_back( readFloat_(0.f) );
+            }
+            // use material
+            else if (keyword_("usemtl", 6))
+            {
+                if (!skipWS_())
+                    throw ParseError("expected identifier, found end of line");
+                const char * e = p_;
+                while (e < e_ && !isWS_(*e))
+                    ++e;
+                addStatement_(c_.useMaterial, e);
+            }
+            // material library
+            else if (keyword_("mtllib", 6))
+            {
+                const char * e = e_;
+                while (e > p_ && isWS_(e[-1]))
+                    --e;
+                addStatement_(c_.materialLib, e);
+            }
+        }
+
+        ObjChunk& c_;
+        /** current position, line end and line start */
+        const char * p_, * e_, * line_;
+        std::vector<Vertex> poly_;
+        std::vector<int> polyRel_;
+    };
+
+
+
+    // --------------- binary cache ---------------------
+
+    const char cacheMagic[8] = { 'M', 'O', 'O', 'B', 'J', 'B', 'C', 0 };
+    const uint32_t cacheVersion = 1;
+    const uint64_t cacheAlign = 64;
+
+    /** Header of the binary cache file.
+        All arrays start at a multiple of cacheAlign bytes. */
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version, byteOrder;
+        /** size, modification time and hash of the .obj file */
+        uint64_t fileSize;
+        int64_t fileTime;
+        uint64_t fileHash;
+        /** number of floats in vertex, texcoord and normal array
+            and number of CacheVertex in triangle and line array */
+        uint64_t numVertex, numTexCoord, numNormal, numTriangle, numLine;
+        uint64_t offsetVertex, offsetTexCoord, offsetNormal,
+                 offsetTriangle, offsetLine,
+        /** material section (written by IO::DataStream) */
+                 offsetMaterial, sizeMaterial,
+                 totalSize;
+    };
+
+    /** ObjLoader::Vertex with index of material (0 for none) */
+    struct CacheVertex
     {
-        // skip ws and see if number follows
-        if (!(skipWS(s, x) &&
-              (s.at(x).isNumber() || s.at(x) == '-')))
+        uint32_t v, t, n, mat;
+    };
+
+    uint64_t alignCache(uint64_t x) { return (x + cacheAlign - 1) / cacheAlign * cacheAlign; }
+
+    /** Sets @p bytes to @p num * @p elementSize,
+        returns false on overflow */
+    bool cacheBytes(uint64_t num, uint64_t elementSize, uint64_t& bytes)
+    {
+        if (num > std::numeric_limits<uint64_t>::max() / elementSize)
             return false;
+        bytes = num * elementSize;
+        return true;
+    }
 
-        expectFaceVertex(s, x, v, t, n);
+    /** Gets size, time and hash of the first and last megabyte of the file */
+    bool getCacheKey(const QString& filename, CacheHeader& h)
+    {
+        QFile f(filename);
+        if (!f.open(QIODevice::ReadOnly))
+            return false;
+
+        h.fileSize = f.size();
+        h.fileTime = QFileInfo(filename).lastModified().toMSecsSinceEpoch();
+
+        const qint64 part = qint64(1) << 20;
+        QByteArray a = f.read(part);
+        h.fileHash = MATH::getHashFnv64(a.constData(), a.size(), h.fileSize);
+        if (f.size() > part)
+        {
+            f.seek(std::max(part, f.size() - part));
+            a = f.read(part);
+            h.fileHash = MATH::getHashFnv64(a.constData(), a.size(), h.fileHash);
+        }
+        return true;
+    }
+
+    qint64 fileTime(const QFileInfo& inf)
+    {
+        return inf.lastModified().toMSecsSinceEpoch();
     }
 
-    // adjust indices
-    vertex.v = (v < 0)? (vertex_.size() / vertexComponents - v) : v;
-    vertex.t = (t < 0)? (normal_.size() / normalComponents - t) : t;
-    vertex.n = (n < 0)? (texCoord_.size() / texCoordComponents - n) : n;
+} // namespace anonymous
+
 
-    return true;
-}
 
 void ObjLoader::loadFromMemory(const QByteArray &bytes)
 {
-    isLoading_ = true;
+    loadFromMemory(bytes.constData(), bytes.size());
+}
 
-    QTextStream stream(bytes);
+void ObjLoader::loadFromMemory(const char * data, size_t len)
+{
+    isLoading_ = true;
+    progress_ = 0;
 
     // current line and column
-    int line = 0, x = 0;
+    size_t line = 0, x = 0;
 
     clear();
 
-    Material * curMaterial = 0;
-
-    qint64 position = 0;
     try
     {
-        while (!stream.atEnd())
+        // split into chunks at line ends
+        const size_t minChunkSize = 1 << 20;
+        const size_t numChunks = std::max(size_t(1),
+                    std::min(size_t(numberThreads()), len / minChunkSize));
+
+        std::vector<ObjChunk> chunks(numChunks);
+        const char * pos = data, * end = data + len;
+        for (size_t i = 0; i < numChunks; ++i)
         {
-            const QString s = stream.readLine();
-            if (s.isNull())
-                break;
-
-            position += s.size();
-            progress_ = (position * 100) / bytes.size();
-
-            line++;
-            x = 0;
-
-            // skip beginning whitespace
-            if (!skipWS(s, x))
-                continue;
+            chunks[i].begin = pos;
+            if (i + 1 < numChunks)
+            {
+                pos = std::max(pos, data + len / numChunks * (i + 1));
+                auto e = static_cast<const char*>(memchr(pos, '\n', end - pos));
+                pos = e ? e + 1 : end;
+            }
+            else
+                pos = end;
+            chunks[i].end = pos;
+        }
 
-            // skip comments and empty lines
-            if (s.isEmpty() || s.at(x) == '#')
-                continue;
+        // parse
+        std::atomic<size_t> bytesDone(0);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < numChunks; ++i)
+            threads.push_back(std::thread([&, i]()
+            {
+                ObjParser(chunks[i]).parse(bytesDone, len, progress_);
+            }));
+        ObjParser(chunks[0]).parse(bytesDone, len, progress_);
+        for (auto& t : threads)
+            t.join();
+
+        // check errors and load material libs
+        for (auto& c : chunks)
+        {
+            if (c.hasError)
+            {
+                line += c.errorLine;
+                x = c.errorColumn;
+                MO_IO_ERROR(PARSE, c.error);
+            }
 
-            // load material library
-            if (s.startsWith("mtllib "))
+            for (const auto& s : c.materialLib)
             {
+                const size_t lineNr = line + s.lineNr;
                 if (filename_.isEmpty())
                 {
-                    MO_OBJ_LOG_LN("ignoring material lib statement when "
-                                  "loading from memory.");
+                    MO_OBJ_LOG("[" << lineNr << ":0] ignoring material lib statement "
+                               "when loading from memory.");
                     continue;
                 }
-                x += 6;
-                QString name = readMaterialName(s, x, true);
+
+                const QString arg = QString::fromUtf8(s.arg);
+                int y = 0;
+                QString name = readMaterialName(arg, y, true);
 
 /*  Note: The original spec (www.martinreddy.net/gfx/3d/OBJ.spec)
     allows for multiple names but that breaks .obj files
@@ -389,109 +845,121 @@ void ObjLoader::loadFromMemory(const QByteArray &bytes)
                     // load library
                     path += name;
                     if (loadMaterialLib_(path))
-                        MO_OBJ_LOG_LN("loaded material lib '" << path << "'");
+                        MO_OBJ_LOG("[" << lineNr << ":0] loaded material lib '" << path << "'");
 
                     // check for additional file arguments
-                    name = readMaterialName(s, x, false);
+                    name = readMaterialName(arg, y, false);
                 }
             }
 
-            // use material
-            if (s.startsWith("usemtl "))
-            {
-                x += 6;
-                QString name = expectName(s, x);
-                if (!material_.contains(name))
-                {
-                    MO_OBJ_LOG_LN("Material '" << name << "' not defined");
-                    continue;
-                }
-                curMaterial = &material_[name];
-            }
-
-            // vertex data
-            if (s.startsWith("v "))
-            {
-                x += 2;
-                vertex_.push_back( expectDouble(s, x) );
-                vertex_.push_back( expectDouble(s, x) );
-                vertex_.push_back( expectDouble(s, x) );
-                vertex_.push_back( readDouble(s, x, 1.0) );
-
-                continue;
-            }
-
-            // normal data
-            if (s.startsWith("vn "))
-            {
-                x += 3;
-                normal_.push_back( expectDouble(s, x) );
-                normal_.push_back( expectDouble(s, x) );
-                normal_.push_back( expectDouble(s, x) );
+            line += c.numLines;
+        }
 
-                continue;
-            }
+        // merge chunks
+        size_t numV = 0, numT = 0, numN = 0, numTri = 0, numLine = 0;
+        for (const auto& c : chunks)
+        {
+            numV += c.vertex.size();
+            numT += c.texCoord.size();
+            numN += c.normal.size();
+            numTri += c.triangle.size();
+            numLine += c.line.size();
+        }
+        vertex_.reserve(numV);
+        texCoord_.reserve(numT);
+        normal_.reserve(numN);
+        triangle_.reserve(numTri);
+        line_.reserve(numLine);
+
+        line = 0;
+        x = 0;
+        Material * curMaterial = 0;
+        for (auto& c : chunks)
+        {
+            const UInt
+                    baseV = vertex_.size() / vertexComponents,
+                    baseT = texCoord_.size() / texCoordComponents,
+                    baseN = normal_.size() / normalComponents;
 
-            // textcoord data
-            if (s.startsWith("vt "))
+            // resolve relative indices
+            for (int k = 0; k < 2; ++k)
             {
-                x += 3;
-                texCoord_.push_back( expectDouble(s, x) );
-                texCoord_.push_back( expectDouble(s, x) );
-                texCoord_.push_back( readDouble(s, x, 0.0) );
-
-                continue;
+                auto& list = k ? c.line : c.triangle;
+                for (auto r : k ? c.relLine : c.relTriangle)
+                {
+                    Vertex& v = list[r >> 3];
+                    if (r & 1) v.v += baseV;
+                    if (r & 2) v.t += baseT;
+                    if (r & 4) v.n += baseN;
+                }
             }
 
-            // face data
-            if (s.startsWith("f "))
+            const size_t
+                    triStart = triangle_.size(),
+                    lineStart = line_.size();
+            vertex_.insert(vertex_.end(), c.vertex.begin(), c.vertex.end());
+            texCoord_.insert(texCoord_.end(), c.texCoord.begin(), c.texCoord.end());
+            normal_.insert(normal_.end(), c.normal.begin(), c.normal.end());
+            triangle_.insert(triangle_.end(), c.triangle.begin(), c.triangle.end());
+            line_.insert(line_.end(), c.line.begin(), c.line.end());
+
+            // assign materials
+            size_t tri = 0, lin = 0;
+            for (size_t i = 0; i <= c.useMaterial.size(); ++i)
             {
-                x += 2;
-                Vertex v1, v2, v3, v4;
-
-                // XXX
-                // parsing could be speed-up here,
-                // noting that a statement like
-                // f 1/1/1 2/2/2 3//3
-                // is illegal
-                // so once the check has been performed
-                // for the first vertex, the others
-                // could be read without checks
-
-                readFaceVertex_(s, x, v1, true);
-                readFaceVertex_(s, x, v2, true);
-                v1.mat = v2.mat = curMaterial;
-
-                // no 3rd vertex? (store line)
-                if (!readFaceVertex_(s, x, v3, false))
+                const bool last = i == c.useMaterial.size();
+                const size_t
+                        triEnd = last ? c.triangle.size() : c.useMaterial[i].triangle,
+                        linEnd = last ? c.line.size() : c.useMaterial[i].line;
+                if (curMaterial)
                 {
-                    line_.push_back(v1);
-                    line_.push_back(v2);
-                    continue;
+                    for (; tri < triEnd; ++tri)
+                        triangle_[triStart + tri].mat = curMaterial;
+                    for (; lin < linEnd; ++lin)
+                        line_[lineStart + lin].mat = curMaterial;
                 }
-                v3.mat = curMaterial;
+                tri = triEnd;
+                lin = linEnd;
+                if (last)
+                    break;
 
-                // no 4th vertex? (store triangle)
-                if (!readFaceVertex_(s, x, v4, false))
+                const QString name = QString::fromUtf8(c.useMaterial[i].arg);
+                if (!material_.contains(name))
                 {
-                    triangle_.push_back(v1);
-                    triangle_.push_back(v2);
-                    triangle_.push_back(v3);
+                    MO_OBJ_LOG("[" << (line + c.useMaterial[i].lineNr)
+                               << ":0] Material '" << name << "' not defined");
                     continue;
                 }
-                v4.mat = curMaterial;
+                curMaterial = &material_[name];
+            }
+
+            line += c.numLines;
 
-                // else store quad
-                //MO_OBJ_LOG_LN("add quad " << v1.v << ", " << v2.v << ", " << v3.v << ", " << v4.v
-                //              << " with material " << (v1.mat? v1.mat->name : "-"));
-                triangle_.push_back(v1);
-                triangle_.push_back(v2);
-                triangle_.push_back(v3);
-                triangle_.push_back(v1);
-                triangle_.push_back(v3);
-                triangle_.push_back(v4);
+            // free memory early
+            c = ObjChunk();
+        }
+
+        // check indices
+        line = 0;
+        const size_t
+                maxV = numVertices(),
+                maxT = numTexCoords(),
+                maxN = numNormals();
+        for (int k = 0; k < 2; ++k)
+        {
+            const auto& list = k ? line_ : triangle_;
+            for (size_t i = 0; i < list.size(); ++i)
+            {
+                const Vertex& v = list[i];
+                if (v.v < 1 || v.v > maxV || v.t > maxT || v.n > maxN)
+                    MO_IO_ERROR(PARSE, "index out of range in "
+                                << (k ? "line " : "triangle ")
+                                << (i / (k ? 2 : 3) + 1) << ": "
+                                << v.v << "/" << v.t << "/" << v.n);
             }
         }
+
+        progress_ = 100;
     }
     // on parsing error
     catch (Exception & e)
@@ -503,7 +971,8 @@ void ObjLoader::loadFromMemory(const QByteArray &bytes)
         else
             e << " in memory";
 
-        e << "\nat " << line << ":" << (x + 1);
+        if (line)
+            e << "\nat " << line << ":" << (x + 1);
 
         MO_OBJ_LOG("ERROR: " << e.what());
 
@@ -539,6 +1008,274 @@ void ObjLoader::loadFromMemory(const QByteArray &bytes)
 }
 
 
+
+bool ObjLoader::loadCache_(const QString &filename)
+{
+    const QString cacheName = cacheFilename(filename);
+
+    QFile f(cacheName);
+    if (!f.exists() || !f.open(QIODevice::ReadOnly))
+        return false;
+    if (f.size() < qint64(sizeof(CacheHeader)))
+        return false;
+
+    CacheHeader key;
+    if (!getCacheKey(filename, key))
+        return false;
+
+    // map or read the file
+    QByteArray buffer;
+    const char * data = reinterpret_cast<const char*>(f.map(0, f.size()));
+    const bool mapped = data != 0;
+    if (!mapped)
+    {
+        buffer = f.readAll();
+        data = buffer.constData();
+    }
+
+    bool ok = false;
+    try
+    {
+        CacheHeader h;
+        memcpy(&h, data, sizeof(h));
+
+        // all sizes in 64 bit, checked for overflow
+        const uint64_t size = f.size();
+        auto inRange = [=](uint64_t offset, uint64_t num, uint64_t elementSize)
+        {
+            uint64_t bytes;
+            return cacheBytes(num, elementSize, bytes)
+                && offset % cacheAlign == 0 && offset <= size && bytes <= size - offset;
+        };
+
+        if (memcmp(h.magic, cacheMagic, sizeof(cacheMagic))
+            || h.version != cacheVersion
+            || h.byteOrder != 0x01020304
+            || h.fileSize != key.fileSize
+            || h.fileTime != key.fileTime
+            || h.fileHash != key.fileHash
+            || h.totalSize != size
+            || !inRange(h.offsetVertex, h.numVertex, sizeof(Float))
+            || !inRange(h.offsetTexCoord, h.numTexCoord, sizeof(Float))
+            || !inRange(h.offsetNormal, h.numNormal, sizeof(Float))
+            || !inRange(h.offsetTriangle, h.numTriangle, sizeof(CacheVertex))
+            || !inRange(h.offsetLine, h.numLine, sizeof(CacheVertex))
+            || !inRange(h.offsetMaterial, h.sizeMaterial, 1)
+            // whole primitives only
+            || h.numVertex % vertexComponents
+            || h.numTexCoord % texCoordComponents
+            || h.numNormal % normalComponents
+            || h.numTriangle % 3
+            || h.numLine % 2)
+            throw 0;
+
+        const uint64_t
+                maxV = h.numVertex / vertexComponents,
+                maxT = h.numTexCoord / texCoordComponents,
+                maxN = h.numNormal / normalComponents;
+
+        clear();
+
+        // materials
+        std::vector<Material*> mats;
+        {
+            const QByteArray bytes = QByteArray::fromRawData(
+                        data + h.offsetMaterial, h.sizeMaterial);
+            IO::DataStream io(bytes);
+            io.readHeader("objcachemtl", 1);
+
+            // check libraries for changes
+            quint32 num;
+            io >> num;
+            for (quint32 i = 0; i < num; ++i)
+            {
+                QString path;
+                qint64 size, time;
+                io >> path >> size >> time;
+                if (io.status() != QDataStream::Ok)
+                    throw 0;
+                QFileInfo inf(path);
+                if (!inf.exists() || inf.size() != size || fileTime(inf) != time)
+                    throw 0;
+                materialLibs_ << path;
+            }
+
+            io >> num;
+            for (quint32 i = 0; i < num; ++i)
+            {
+                QString name;
+                io >> name;
+                Material& m = material_[name];
+                m.name = name;
+                io >> m.a_r >> m.a_g >> m.a_b
+                   >> m.d_r >> m.d_g >> m.d_b
+                   >> m.s_r >> m.s_g >> m.s_b
+                   >> m.alpha;
+                if (io.status() != QDataStream::Ok)
+                    throw 0;
+                mats.push_back(&m);
+            }
+        }
+
+        // arrays
+        auto floats = [=](uint64_t offset)
+            { return reinterpret_cast<const Float*>(data + offset); };
+        vertex_.assign(floats(h.offsetVertex), floats(h.offsetVertex) + h.numVertex);
+        texCoord_.assign(floats(h.offsetTexCoord), floats(h.offsetTexCoord) + h.numTexCoord);
+        normal_.assign(floats(h.offsetNormal), floats(h.offsetNormal) + h.numNormal);
+
+        for (int k = 0; k < 2; ++k)
+        {
+            auto& list = k ? line_ : triangle_;
+            const auto src = reinterpret_cast<const CacheVertex*>(
+                        data + (k ? h.offsetLine : h.offsetTriangle));
+            const size_t num = k ? h.numLine : h.numTriangle;
+            list.resize(num);
+            for (size_t i = 0; i < num; ++i)
+            {
+                // same index check as after parsing
+                const CacheVertex& c = src[i];
+                if (c.v < 1 || c.v > maxV || c.t > maxT || c.n > maxN
+                    || c.mat > mats.size())
+                    throw 0;
+
+                Vertex& v = list[i];
+                v.v = c.v;
+                v.t = c.t;
+                v.n = c.n;
+                v.mat = c.mat ? mats[c.mat - 1] : 0;
+            }
+        }
+
+        ok = true;
+        progress_ = 100;
+        MO_OBJ_LOG("loaded binary cache '" << cacheName << "'");
+    }
+    catch (...)
+    {
+        clear();
+        MO_DEBUG_GEOM("ObjLoader: cache '" << cacheName << "' is outdated or invalid");
+    }
+
+    if (mapped)
+        f.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+
+    return ok;
+}
+
+bool ObjLoader::saveCache_(const QString &filename)
+{
+    const QString cacheName = cacheFilename(filename);
+
+    CacheHeader h;
+    memset(&h, 0, sizeof(h));
+    if (!getCacheKey(filename, h))
+        return false;
+
+    // material section
+    QByteArray matBytes;
+    QMap<const Material*, uint32_t> matIndex;
+    {
+        IO::DataStream io(&matBytes, QIODevice::WriteOnly);
+        io.writeHeader("objcachemtl", 1);
+
+        io << quint32(materialLibs_.size());
+        for (const QString& path : materialLibs_)
+        {
+            QFileInfo inf(path);
+            io << inf.absoluteFilePath() << qint64(inf.size()) << fileTime(inf);
+        }
+
+        io << quint32(material_.size());
+        for (auto i = material_.begin(); i != material_.end(); ++i)
+        {
+            const Material& m = i.value();
+            matIndex.insert(&m, matIndex.size() + 1);
+            io << i.key()
+               << m.a_r << m.a_g << m.a_b
+               << m.d_r << m.d_g << m.d_b
+               << m.s_r << m.s_g << m.s_b
+               << m.alpha;
+        }
+    }
+
+    // layout
+    memcpy(h.magic, cacheMagic, sizeof(cacheMagic));
+    h.version = cacheVersion;
+    h.byteOrder = 0x01020304;
+    h.numVertex = vertex_.size();
+    h.numTexCoord = texCoord_.size();
+    h.numNormal = normal_.size();
+    h.numTriangle = triangle_.size();
+    h.numLine = line_.size();
+    h.offsetVertex = alignCache(sizeof(CacheHeader));
+    h.offsetTexCoord = alignCache(h.offsetVertex + h.numVertex * sizeof(Float));
+    h.offsetNormal = alignCache(h.offsetTexCoord + h.numTexCoord * sizeof(Float));
+    h.offsetTriangle = alignCache(h.offsetNormal + h.numNormal * sizeof(Float));
+    h.offsetLine = alignCache(h.offsetTriangle + h.numTriangle * sizeof(CacheVertex));
+    h.offsetMaterial = alignCache(h.offsetLine + h.numLine * sizeof(CacheVertex));
+    h.sizeMaterial = matBytes.size();
+    h.totalSize = h.offsetMaterial + h.sizeMaterial;
+
+    // write to temporary file and rename at the end
+    QSaveFile f(cacheName);
+    if (!f.open(QIODevice::WriteOnly))
+    {
+        MO_OBJ_LOG("Could not write binary cache '" << cacheName << "'\n"
+                   << f.errorString());
+        return false;
+    }
+
+    bool ok = true;
+    auto write = [&](uint64_t offset, const void * data, uint64_t bytes)
+    {
+        static const char zeros[cacheAlign] = { 0 };
+        if (uint64_t(f.pos()) < offset)
+            ok &= f.write(zeros, offset - f.pos()) >= 0;
+        if (bytes)
+            ok &= f.write(static_cast<const char*>(data), bytes) == qint64(bytes);
+    };
+
+    write(0, &h, sizeof(h));
+    write(h.offsetVertex, vertex_.data(), h.numVertex * sizeof(Float));
+    write(h.offsetTexCoord, texCoord_.data(), h.numTexCoord * sizeof(Float));
+    write(h.offsetNormal, normal_.data(), h.numNormal * sizeof(Float));
+    for (int k = 0; k < 2 && ok; ++k)
+    {
+        const auto& list = k ? line_ : triangle_;
+        write(k ? h.offsetLine : h.offsetTriangle, 0, 0);
+
+        // convert in blocks
+        std::vector<CacheVertex> block;
+        for (size_t i = 0; i < list.size() && ok; i += block.size())
+        {
+            block.resize(std::min(size_t(1 << 16), list.size() - i));
+            for (size_t j = 0; j < block.size(); ++j)
+            {
+                const Vertex& v = list[i + j];
+                block[j].v = v.v;
+                block[j].t = v.t;
+                block[j].n = v.n;
+                block[j].mat = v.mat ? matIndex.value(v.mat) : 0;
+            }
+            write(f.pos(), block.data(), block.size() * sizeof(CacheVertex));
+        }
+    }
+    write(h.offsetMaterial, matBytes.constData(), matBytes.size());
+
+    if (!ok || !f.commit())
+    {
+        MO_OBJ_LOG("Could not write binary cache '" << cacheName << "'\n"
+                   << f.errorString());
+        return false;
+    }
+
+    MO_OBJ_LOG("wrote binary cache '" << cacheName << "'");
+    return true;
+}
+
+
+
 void ObjLoader::initMaterial_(Material & m) const
 {
     m.alpha = 1.0;
@@ -558,6 +1295,8 @@ bool ObjLoader::loadMaterialLib_(const QString &filename)
         return false;
     }
 
+    materialLibs_ << filename;
+
     const QByteArray a = f.readAll();
     QTextStream stream(a);
 
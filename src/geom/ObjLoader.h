@@ -12,11 +12,13 @@
 #define MOSRC_GEOM_OBJLOADER_H
 
 #include <vector>
+#include <cstddef>
 
 #include <QMap>
 #include <QMutex>
 
 #include <QString>
+#include <QStringList>
 #include <QByteArray>
 
 namespace MO {
@@ -24,6 +26,16 @@ namespace GEOM {
 
 class Geometry;
 
+/** Loader for Wavefront .obj files and .mtl material libraries.
+
+    The .obj text is parsed in chunks on multiple threads,
+    directly on the memory-mapped file.
+
+    loadFile() also writes a binary cache next to the file
+    (see cacheFilename()) which is used on later loads
+    as long as size, modification time and hash of the .obj file
+    and the material libraries are unchanged.
+    */
 class ObjLoader
 {
 public:
@@ -56,6 +68,7 @@ public:
     void clear();
 
     /** Loads the file into internal data.
+        Reads or writes the binary cache if enabled.
         @throws IoException on file or parsing errors. */
     void loadFile(const QString& filename);
 
@@ -64,6 +77,11 @@ public:
         @note library files will not be loaded if loadFile() was not used. */
     void loadFromMemory(const QByteArray& a);
 
+    /** Loads @p len bytes of text content into internal data.
+        @throws IoExpection on parsing errors.
+        @note library files will not be loaded if loadFile() was not used. */
+    void loadFromMemory(const char * data, size_t len);
+
     // -------------- getter ------------------
 
     /** Returns whether the ObjLoader contains valid vertex data */
@@ -82,6 +100,34 @@ public:
     /** Returns the progress during loading [0,100] */
     int progress() const { return progress_; }
 
+    /** Returns true when the last loadFile() used the binary cache */
+    bool isLoadedFromCache() const { return fromCache_; }
+
+    /** Number of vertices, texture coordinates and normals */
+    size_t numVertices() const { return vertex_.size() / vertexComponents; }
+    size_t numTexCoords() const { return texCoord_.size() / texCoordComponents; }
+    size_t numNormals() const { return normal_.size() / normalComponents; }
+    /** Number of triangles and lines */
+    size_t numTriangles() const { return triangle_.size() / 3; }
+    size_t numLines() const { return line_.size() / 2; }
+
+    // ----------- settings -------------------
+
+    /** Enables reading and writing of the binary cache, default is true */
+    static void setCacheEnabled(bool enable);
+    static bool isCacheEnabled();
+
+    /** Files smaller than @p bytes are not cached, default is 4mb */
+    static void setCacheMinimumSize(qint64 bytes);
+    static qint64 cacheMinimumSize();
+
+    /** Number of parser threads, 0 uses the number of cores (default) */
+    static void setNumberThreads(unsigned int num);
+    static unsigned int numberThreads();
+
+    /** Returns the name of the binary cache file for the .obj @p filename */
+    static QString cacheFilename(const QString& filename);
+
     // ----- buffer singleton access ----------
 
     /** Loads the data into the Geometry container.
@@ -92,7 +138,10 @@ public:
 
 private:
 
-    bool readFaceVertex_(const QString&, int& x, Vertex&, bool expect) const;
+    /** Reads the binary cache for @p filename, returns success */
+    bool loadCache_(const QString& filename);
+    /** Writes the binary cache for @p filename, returns success */
+    bool saveCache_(const QString& filename);
 
     bool loadMaterialLib_(const QString& filename);
 
@@ -103,6 +152,7 @@ private:
 
     volatile int progress_;
     volatile bool isLoading_;
+    bool fromCache_;
 
     std::vector<Float>
         vertex_, texCoord_, normal_;
@@ -111,6 +161,8 @@ private:
 
     QMap<QString, Material> material_;
     QMap<UInt, QString> materialUse_;
+    /** all loaded .mtl files */
+    QStringList materialLibs_;
 
     static std::map<QString, ObjLoader*> instances_;
     static QMutex instanceMutex_;
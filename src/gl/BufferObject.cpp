@@ -92,6 +92,26 @@ void BufferObject::upload(const void* ptr)
     MO_CHECK_GL_THROW( glBufferData(p_target_, p_size_, ptr, p_storage_) );
 }
 
+void * BufferObject::map(GLenum access)
+{
+    if (!isOk())
+        MO_GL_ERROR( "BufferObject::map() on uninitialized buffer object");
+
+    void * ptr;
+    MO_CHECK_GL_THROW( ptr = glMapBuffer(p_target_, access) );
+    return ptr;
+}
+
+bool BufferObject::unmap()
+{
+    if (!isOk())
+        MO_GL_ERROR( "BufferObject::unmap() on uninitialized buffer object");
+
+    GLboolean r;
+    MO_CHECK_GL_THROW( r = glUnmapBuffer(p_target_) );
+    return r == GL_TRUE;
+}
+
 
 
 } // namespace GL
@@ -65,6 +65,19 @@ public:
         @throws GlException */
     void upload(const void* ptr, gl::GLenum storageType);
 
+    /** Maps the buffer contents into client memory.
+        @p access is one of GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE.
+        Buffer must be bound. The pointer stays valid until unmap(),
+        also after unbinding.
+        @throws GlException */
+    void * map(gl::GLenum access);
+
+    /** Releases the mapping of map().
+        Buffer must be bound.
+        Returns false if the contents got corrupted in the meantime.
+        @throws GlException */
+    bool unmap();
+
 private:
 
     gl::GLuint p_handle_;
@@ -456,8 +456,14 @@ void Manager::Private::renderLoop()
         {
             headerUpdateTime = time;
             if (doAnimate)
-                window->setTitle(QString("%1 fps").arg(messuredFps)
-                                 .toStdString().c_str());
+            {
+                QString title = QString("%1 fps").arg(messuredFps);
+                if (scene && (scene->debugRenderOptions() & Scene::DD_BOUNDING_VOLUMES))
+                    title += QString(", %1 drawn, %2 culled")
+                            .arg(scene->numRenderedObjects())
+                            .arg(scene->numCulledObjects());
+                window->setTitle(title.toStdString().c_str());
+            }
             else
                 window->setTitle("stopped");
         }
@@ -17,6 +17,7 @@
 #include "object/Microphone.h"
 #include "object/visual/Camera.h"
 #include "object/visual/LightSource.h"
+#include "object/visual/ObjectGl.h"
 #include "gl/Drawable.h"
 #include "gl/ShaderSource.h"
 #include "gl/RenderSettings.h"
@@ -51,12 +52,15 @@ struct SceneDebugRenderer::Private
         , drawMicrophone    (nullptr)
         , drawLightSourceCone   (nullptr)
         , drawLightSourceSphere(nullptr)
+        , drawBounds        (nullptr)
+        , drawBoundsCulled  (nullptr)
     { }
 
     void updateTree();
     void initGl();
     void releaseGl();
     GL::Drawable* createConeDrawable(const QString& name);
+    GL::Drawable* createBoxDrawable(const QString& name, Float r, Float g, Float b);
     void addCoordinates(GEOM::Geometry*) const;
     void render(const RenderSettings & rs, const RenderTime& time, int options);
 
@@ -88,6 +92,7 @@ struct SceneDebugRenderer::Private
     Scene * scene;
     QList<Camera*> cameras;
     QList<LightSource*> lightSources;
+    QList<ObjectGl*> glObjects;
     QList<std::shared_ptr<Micro>> microphones;
     QList<std::shared_ptr<Sound>> sounds;
 
@@ -98,7 +103,9 @@ struct SceneDebugRenderer::Private
         * drawAudioSource,
         * drawMicrophone,
         * drawLightSourceCone,
-        * drawLightSourceSphere;
+        * drawLightSourceSphere,
+        * drawBounds,
+        * drawBoundsCulled;
 };
 
 
@@ -118,6 +125,8 @@ SceneDebugRenderer::~SceneDebugRenderer()
     delete p_->drawCamera;
     delete p_->drawMicrophone;
     delete p_->drawLightSourceCone;
+    delete p_->drawBounds;
+    delete p_->drawBoundsCulled;
 
     delete p_;
 }
@@ -155,6 +164,7 @@ void SceneDebugRenderer::Private::updateTree()
 {
     cameras = scene->findChildObjects<Camera>(QString(), true);
     lightSources = scene->findChildObjects<LightSource>(QString(), true);
+    glObjects = scene->findChildObjects<ObjectGl>(QString(), true);
     microphones.clear();
     sounds.clear();
 
@@ -271,6 +281,11 @@ void SceneDebugRenderer::Private::initGl()
 
     drawMicrophone = createConeDrawable("scene_debug_microphone");
 
+    // --- setup bounding box drawables ----
+
+    drawBounds = createBoxDrawable("scene_debug_bounds", 0.3, 1, 0.3);
+    drawBoundsCulled = createBoxDrawable("scene_debug_bounds_culled", 1, 0.3, 0.3);
+
     glReady = true;
 }
 
@@ -354,6 +369,41 @@ GL::Drawable* SceneDebugRenderer::Private::createConeDrawable(const QString& nam
     return draw;
 }
 
+/** Unit cube wire-frame from (0,0,0) to (1,1,1) */
+GL::Drawable* SceneDebugRenderer::Private::createBoxDrawable(
+        const QString& name, Float r, Float g, Float b)
+{
+    GL::ShaderSource src;
+    src.loadDefaultSource();
+
+    auto geom = new GEOM::Geometry();
+    geom->setColor(r, g, b, 1);
+
+    GEOM::Geometry::IndexType idx[8];
+    for (int i=0; i<8; ++i)
+        idx[i] = geom->addVertexAlways(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+
+    // connect corners that differ in one bit
+    for (int i=0; i<8; ++i)
+    for (int bit=1; bit<8; bit <<= 1)
+        if (!(i & bit))
+            geom->addLine(idx[i], idx[i | bit]);
+
+    auto draw = new GL::Drawable(name);
+    draw->setGeometry(geom);
+    draw->setShaderSource(src);
+    try
+    {
+        draw->createOpenGl();
+    }
+    catch (...)
+    {
+        delete draw;
+        throw;
+    }
+    return draw;
+}
+
 void SceneDebugRenderer::Private::releaseGl()
 {
     glReady = false;
@@ -397,6 +447,22 @@ void SceneDebugRenderer::Private::releaseGl()
         delete drawLightSourceSphere;
         drawLightSourceSphere = 0;
     }
+
+    if (drawBounds)
+    {
+        if (drawBounds->isReady())
+            drawBounds->releaseOpenGl();
+        delete drawBounds;
+        drawBounds = 0;
+    }
+
+    if (drawBoundsCulled)
+    {
+        if (drawBoundsCulled->isReady())
+            drawBoundsCulled->releaseOpenGl();
+        delete drawBoundsCulled;
+        drawBoundsCulled = 0;
+    }
 }
 
 void SceneDebugRenderer::Private::render(
@@ -418,6 +484,18 @@ void SceneDebugRenderer::Private::render(
         drawCamera->renderShader(proj, cubeView * trans, view * trans, trans);
     }
 
+    if (options & Scene::DD_BOUNDING_VOLUMES)
+    for (ObjectGl * o : glObjects)
+    {
+        if (!o->hasBoundingVolume() || !o->active(time))
+            continue;
+        const Mat4 trans = glm::scale(
+                    glm::translate(Mat4(1.), o->boundingMinimum()),
+                    o->boundingMaximum() - o->boundingMinimum());
+        auto draw = o->isCulled() ? drawBoundsCulled : drawBounds;
+        draw->renderShader(proj, cubeView * trans, view * trans, trans);
+    }
+
     if (options & Scene::DD_LIGHT_SOURCES)
     {
         GL::LightSettings set;
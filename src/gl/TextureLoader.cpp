@@ -0,0 +1,686 @@
+/** @file textureloader.cpp
+
+    @brief Asynchronous image decoding and time-sliced texture upload
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include <QImage>
+
+#include "TextureLoader.h"
+#include "Texture.h"
+#include "io/ImageReader.h"
+#include "io/CurrentThread.h"
+#include "io/time.h"
+#include "io/error.h"
+#include "io/log_texture.h"
+
+using namespace gl;
+
+namespace MO {
+namespace GL {
+
+namespace {
+
+    // same formats as Texture::createFromImage()
+#if QT_VERSION >= 0x050200
+    const GLenum inputFormat = GL_RGBA;
+    const QImage::Format imageFormat = QImage::Format_RGBA8888;
+#else
+    const GLenum inputFormat = GL_RGB;
+    const QImage::Format imageFormat = QImage::Format_RGB888;
+#endif
+
+    /** Bytes per upload chunk */
+    const int chunkBytes = 1 << 18;
+
+    /** Fraction of stagingTimeout after which waiting workers
+        look for images to evict */
+    const Double evictCheckRatio = 0.25;
+
+} // namespace
+
+
+struct TextureLoader::Private
+{
+    Private()
+        : maxStaging    (size_t(256) << 20)
+        , numThreads    (2)
+        , budget        (0.004)
+        , timeout       (2.)
+        , decoding      (0)
+        , staging       (0)
+        , loaded        (0)
+        , evicted       (0)
+        , doStop        (false)
+        , uploadTime    (0.)
+    { }
+
+    void startThreads();
+    void stopThreads();
+    void threadLoop();
+
+    /** Decodes the image outside of the lock and stores the result.
+        @p lock must be locked and is locked again on return.
+        Returns false if the image was released meanwhile. It is deleted,
+        or moved to cancelled if it owns a texture. */
+    bool decode(Image * img, std::unique_lock<std::mutex>& lock);
+
+    /** Removes the staged bytes of a finished or released image.
+        Must be called with locked mutex. */
+    void unstage(Image * img);
+
+    /** Releases the textures and deletes the images
+        that were released while decoding. OpenGL thread only. */
+    void releaseCancelled();
+
+    /** Releases the texture and deletes the image. OpenGL thread only. */
+    static void deleteImage(Image * img);
+
+    /** Drops the decoded data of images that were not uploaded
+        within the timeout. Must be called with locked mutex.
+        Returns true if anything was evicted. */
+    bool evictStale();
+
+    size_t maxStaging;
+    uint numThreads;
+    Double budget, timeout;
+
+    // guarded by mutex
+    std::deque<Image*> queue;
+    /** decoded images, in order of decoding */
+    std::vector<Image*> staged;
+    /** released while decoding, with a texture to release */
+    std::vector<Image*> cancelled;
+    size_t decoding, staging;
+    uint64_t loaded, evicted;
+    bool doStop;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    /** wakes up the workers */
+    std::condition_variable cond;
+    /** signals finished decodes */
+    std::condition_variable decodedCond;
+
+    /** Time spent uploading in the current frame, OpenGL thread only */
+    Double uploadTime;
+};
+
+
+// ################################ Image #######################################
+
+struct TextureLoader::Image::Private
+{
+    enum State
+    {
+        S_QUEUED,
+        S_DECODING,
+        S_DECODED,
+        /** decoded data was dropped, upload() queues it again */
+        S_EVICTED,
+        S_READY,
+        S_ERROR
+    };
+
+    Private()
+        : format    (GL_RGBA)
+        , mipmaps   (0)
+        , state     (S_QUEUED)
+        , cancelled (false)
+        , bytes     (0)
+        , lastUse   (0.)
+        , width     (0)
+        , height    (0)
+        , tex       (0)
+        , row       (0)
+    { }
+
+    /** Sets the error state and releases the staged image.
+        Must be called with locked loader mutex. */
+    void setError(const QString& e)
+    {
+        error = e;
+        image = QImage();
+        state.store(S_ERROR, std::memory_order_release);
+    }
+
+    QString filename;
+    GLenum format;
+    uint mipmaps;
+
+    // written with locked loader mutex
+    std::atomic<int> state;
+    bool cancelled;
+    QImage image;
+    size_t bytes;
+    /** systemTime() of decoding or last call to upload() */
+    Double lastUse;
+    uint width, height;
+    QString error;
+
+    // OpenGL thread only
+    Texture * tex;
+    int row;
+};
+
+TextureLoader::Image::Image()
+    : p_    (new Private())
+{
+}
+
+TextureLoader::Image::~Image()
+{
+    delete p_;
+}
+
+const QString& TextureLoader::Image::filename() const { return p_->filename; }
+
+bool TextureLoader::Image::isDecoded() const
+{
+    const int s = p_->state.load(std::memory_order_acquire);
+    return s == Private::S_DECODED || s == Private::S_READY;
+}
+
+bool TextureLoader::Image::isReady() const
+{
+    return p_->state.load(std::memory_order_acquire) == Private::S_READY;
+}
+
+bool TextureLoader::Image::hasError() const
+{
+    return p_->state.load(std::memory_order_acquire) == Private::S_ERROR;
+}
+
+QString TextureLoader::Image::errorString() const
+{
+    return hasError() ? p_->error : QString();
+}
+
+uint TextureLoader::Image::width() const { return isDecoded() ? p_->width : 0; }
+uint TextureLoader::Image::height() const { return isDecoded() ? p_->height : 0; }
+
+Texture * TextureLoader::Image::texture() const
+{
+    return isReady() ? p_->tex : 0;
+}
+
+bool TextureLoader::Image::upload(bool wait)
+{
+    auto lp = TextureLoader::p_getInstance_()->p_;
+
+    int state = p_->state.load(std::memory_order_acquire);
+    if (state == Private::S_READY)
+        return true;
+    if (state == Private::S_ERROR)
+        return false;
+    if (!wait && state != Private::S_DECODED && state != Private::S_EVICTED)
+        return false;
+
+    // shared copy of the staged image,
+    // stays valid if the workers evict it meanwhile
+    QImage image;
+    {
+        std::unique_lock<std::mutex> lock(lp->mutex);
+
+        // decode again
+        if (p_->state == Private::S_EVICTED)
+        {
+            MO_DEBUG_IMG("TextureLoader::Image::upload('" << p_->filename
+                         << "') requeue evicted image");
+            p_->state = Private::S_QUEUED;
+            lp->queue.push_back(this);
+            lp->cond.notify_one();
+            if (!wait)
+                return false;
+        }
+
+        if (p_->state != Private::S_DECODED)
+        {
+            // decode right here instead of waiting in the queue
+            if (p_->state == Private::S_QUEUED)
+            {
+                auto i = std::find(lp->queue.begin(), lp->queue.end(), this);
+                if (i != lp->queue.end())
+                    lp->queue.erase(i);
+                lp->decode(this, lock);
+            }
+            // wait for the worker
+            else
+                lp->decodedCond.wait(lock, [this]()
+                {
+                    const int s = p_->state;
+                    return s == Private::S_DECODED || s == Private::S_ERROR;
+                });
+
+            if (p_->state == Private::S_ERROR)
+                return false;
+        }
+
+        image = p_->image;
+        p_->lastUse = systemTime();
+    }
+
+    MO_DEBUG_IMG("TextureLoader::Image::upload('" << p_->filename
+                 << "') row " << p_->row << "/" << p_->height);
+
+    try
+    {
+        if (!p_->tex)
+        {
+            // storage without data
+            p_->tex = new Texture(p_->width, p_->height,
+                                  p_->format, inputFormat, GL_UNSIGNED_BYTE, 0);
+            p_->tex->create();
+            p_->row = 0;
+        }
+
+        p_->tex->bind();
+
+        // upload a chunk of rows at a time
+        // (the image is already mirrored by the worker)
+        const int
+                h = p_->height,
+                rows = std::max(1, chunkBytes / image.bytesPerLine());
+        while (p_->row < h)
+        {
+            if (!wait && lp->uploadTime >= lp->budget)
+                return false;
+
+            TimeMessure tm;
+            const int num = std::min(rows, h - p_->row);
+            MO_CHECK_GL_THROW(
+                glTexSubImage2D(p_->tex->target(), 0,
+                                0, p_->row, p_->width, num,
+                                inputFormat, GL_UNSIGNED_BYTE,
+                                image.constScanLine(p_->row))
+                        );
+            p_->row += num;
+            lp->uploadTime += tm.time();
+        }
+
+        if (p_->mipmaps > 0)
+            p_->tex->createMipmaps(p_->mipmaps);
+    }
+    catch (Exception& e)
+    {
+        if (p_->tex)
+        {
+            if (p_->tex->isHandle())
+                p_->tex->release();
+            delete p_->tex;
+            p_->tex = 0;
+        }
+        e << "\non uploading image '" << p_->filename << "'";
+
+        std::lock_guard<std::mutex> lock(lp->mutex);
+        lp->unstage(this);
+        p_->setError(e.what());
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(lp->mutex);
+    lp->unstage(this);
+    p_->image = QImage();
+    ++lp->loaded;
+    p_->state.store(Private::S_READY, std::memory_order_release);
+
+    return true;
+}
+
+
+// ############################## TextureLoader ###################################
+
+TextureLoader::TextureLoader()
+    : p_    (new Private())
+{
+    MO_DEBUG_TEX("TextureLoader::TextureLoader()");
+}
+
+TextureLoader::~TextureLoader()
+{
+    MO_DEBUG_TEX("TextureLoader::~TextureLoader()");
+
+    p_->stopThreads();
+    for (auto i : p_->queue)
+        delete i;
+    for (auto i : p_->cancelled)
+        delete i;
+    delete p_;
+}
+
+TextureLoader * TextureLoader::p_getInstance_()
+{
+    static TextureLoader * instance = new TextureLoader();
+    return instance;
+}
+
+size_t TextureLoader::maxStagingBytes()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->maxStaging;
+}
+
+void TextureLoader::setMaxStagingBytes(size_t bytes)
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    tl->p_->maxStaging = bytes;
+    tl->p_->cond.notify_all();
+}
+
+Double TextureLoader::stagingTimeout()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->timeout;
+}
+
+void TextureLoader::setStagingTimeout(Double seconds)
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    tl->p_->timeout = std::max(Double(0), seconds);
+    tl->p_->cond.notify_all();
+}
+
+uint TextureLoader::numberThreads()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->numThreads;
+}
+
+void TextureLoader::setNumberThreads(uint num)
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    tl->p_->numThreads = num;
+}
+
+Double TextureLoader::uploadBudget()
+{
+    return p_getInstance_()->p_->budget;
+}
+
+void TextureLoader::setUploadBudget(Double seconds)
+{
+    p_getInstance_()->p_->budget = std::max(Double(0), seconds);
+}
+
+void TextureLoader::beginFrame()
+{
+    auto tl = p_getInstance_();
+    tl->p_->uploadTime = 0.;
+    tl->p_->releaseCancelled();
+}
+
+size_t TextureLoader::queueDepth()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->queue.size() + tl->p_->decoding;
+}
+
+size_t TextureLoader::bytesInFlight()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->staging;
+}
+
+uint64_t TextureLoader::numLoaded()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->loaded;
+}
+
+uint64_t TextureLoader::numEvicted()
+{
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    return tl->p_->evicted;
+}
+
+TextureLoader::Image * TextureLoader::load(
+        const QString &filename, GLenum gpu_format, uint mipmap_levels)
+{
+    MO_DEBUG_TEX("TextureLoader::load('" << filename << "')");
+
+    auto img = new Image();
+    img->p_->filename = filename;
+    img->p_->format = gpu_format;
+    img->p_->mipmaps = mipmap_levels;
+
+    auto tl = p_getInstance_();
+    std::lock_guard<std::mutex> lock(tl->p_->mutex);
+    tl->p_->startThreads();
+    tl->p_->queue.push_back(img);
+    tl->p_->cond.notify_one();
+
+    return img;
+}
+
+void TextureLoader::release(Image * img)
+{
+    if (!img)
+        return;
+
+    MO_DEBUG_TEX("TextureLoader::release('" << img->filename() << "')");
+
+    auto tl = p_getInstance_();
+    {
+        std::lock_guard<std::mutex> lock(tl->p_->mutex);
+
+        // worker deletes it when finished
+        if (img->p_->state == Image::Private::S_DECODING)
+        {
+            img->p_->cancelled = true;
+            return;
+        }
+
+        auto i = std::find(tl->p_->queue.begin(), tl->p_->queue.end(), img);
+        if (i != tl->p_->queue.end())
+            tl->p_->queue.erase(i);
+
+        tl->p_->unstage(img);
+    }
+
+    Private::deleteImage(img);
+}
+
+void TextureLoader::Private::deleteImage(Image * img)
+{
+    if (auto tex = img->p_->tex)
+    {
+        if (tex->isHandle())
+            tex->release();
+        delete tex;
+    }
+    delete img;
+}
+
+void TextureLoader::Private::releaseCancelled()
+{
+    std::vector<Image*> imgs;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled.empty())
+            return;
+        imgs.swap(cancelled);
+    }
+    for (auto i : imgs)
+        deleteImage(i);
+}
+
+void TextureLoader::Private::unstage(Image * img)
+{
+    auto i = std::find(staged.begin(), staged.end(), img);
+    if (i != staged.end())
+        staged.erase(i);
+
+    staging -= img->p_->bytes;
+    img->p_->bytes = 0;
+    // room for more
+    cond.notify_all();
+}
+
+bool TextureLoader::Private::evictStale()
+{
+    const Double now = systemTime();
+    bool didEvict = false;
+    for (auto i = staged.begin(); i != staged.end(); )
+    {
+        auto ip = (*i)->p_;
+        if (now - ip->lastUse < timeout)
+        {
+            ++i;
+            continue;
+        }
+
+        MO_DEBUG_TEX("TextureLoader: evicting '" << ip->filename << "'");
+
+        staging -= ip->bytes;
+        ip->bytes = 0;
+        ip->image = QImage();
+        ip->state.store(Image::Private::S_EVICTED, std::memory_order_release);
+        ++evicted;
+        didEvict = true;
+        i = staged.erase(i);
+    }
+    return didEvict;
+}
+
+void TextureLoader::Private::startThreads()
+{
+    if (!threads.empty())
+        return;
+
+    uint num = numThreads;
+    if (num == 0)
+        num = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    num = std::max(1u, num);
+
+    MO_DEBUG_TEX("TextureLoader: starting " << num << " threads");
+
+    doStop = false;
+    for (uint i = 0; i < num; ++i)
+        threads.push_back(std::thread([this](){ threadLoop(); }));
+}
+
+void TextureLoader::Private::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        doStop = true;
+        cond.notify_all();
+    }
+    for (auto& t : threads)
+        t.join();
+    threads.clear();
+}
+
+void TextureLoader::Private::threadLoop()
+{
+    setCurrentThreadName("TEXLOAD");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        // wait for work and room in the staging cache
+        // (a single image is always allowed)
+        auto canWork = [this]()
+        {
+            return doStop
+                || (!queue.empty() && (staging < maxStaging || staging == 0));
+        };
+        while (!canWork())
+        {
+            // staging cache is full of images nobody uploads
+            if (!queue.empty() && evictStale())
+                continue;
+            cond.wait_for(lock, std::chrono::milliseconds(
+                              std::max(1, int(timeout * evictCheckRatio * 1000.))));
+        }
+        if (doStop)
+            return;
+
+        Image * img = queue.front();
+        queue.pop_front();
+        decode(img, lock);
+    }
+}
+
+bool TextureLoader::Private::decode(Image * img, std::unique_lock<std::mutex>& lock)
+{
+    auto ip = img->p_;
+    ip->state = Image::Private::S_DECODING;
+    ++decoding;
+    const QString filename = ip->filename;
+
+    lock.unlock();
+
+    ImageReader reader;
+    reader.setFilename(filename);
+    QImage qimg = reader.read();
+    QString error;
+    if (qimg.isNull())
+        error = QString("Could not load image file\n'%1'\n'%2'")
+                .arg(filename).arg(reader.errorString());
+    else
+    {
+        // upload format, upside-down for OpenGL
+        if (qimg.format() != imageFormat)
+            qimg = qimg.convertToFormat(imageFormat);
+        qimg = qimg.mirrored(false, true);
+    }
+
+    lock.lock();
+    --decoding;
+
+    if (ip->cancelled)
+    {
+        // a requeued evicted image may own a texture,
+        // which is released on the OpenGL thread
+        if (ip->tex)
+            cancelled.push_back(img);
+        else
+            delete img;
+        return false;
+    }
+
+    if (qimg.isNull())
+        ip->setError(error);
+    else
+    {
+        ip->width = qimg.width();
+        ip->height = qimg.height();
+        ip->bytes = qimg.byteCount();
+        ip->image = qimg;
+        ip->lastUse = systemTime();
+        staging += ip->bytes;
+        staged.push_back(img);
+        ip->state.store(Image::Private::S_DECODED, std::memory_order_release);
+    }
+
+    decodedCond.notify_all();
+    return true;
+}
+
+
+} // namespace GL
+} // namespace MO
@@ -0,0 +1,159 @@
+/** @file textureloader.h
+
+    @brief Asynchronous image decoding and time-sliced texture upload
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_GL_TEXTURELOADER_H
+#define MOSRC_GL_TEXTURELOADER_H
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <QString>
+
+#include "gl/opengl.h"
+#include "types/float.h"
+
+namespace MO {
+namespace GL {
+
+class Texture;
+
+/** Singleton service that loads image files into textures
+    without blocking the OpenGL thread.
+
+    Images are decoded by ImageReader on worker threads into a staging
+    cache, which is limited to maxStagingBytes().
+    The OpenGL thread calls Image::upload() every frame, which creates the
+    texture and uploads the image in chunks of rows until the per-frame
+    uploadBudget() is used up. Mip-maps are created after the last chunk.
+
+    Decoded images for which upload() is not called within
+    stagingTimeout() seconds, e.g. of objects that are currently not
+    rendered, are evicted from the staging cache when it is full,
+    so they can not block the other images.
+    The next call to upload() queues them for decoding again.
+
+    Until Image::isReady() returns true, users should display a placeholder.
+    */
+class TextureLoader
+{
+    TextureLoader();
+    ~TextureLoader();
+
+public:
+
+    /** Handle to one requested image */
+    class Image
+    {
+        friend class TextureLoader;
+        Image();
+        ~Image();
+    public:
+
+        // ------------ getter ------------
+
+        const QString& filename() const;
+
+        /** The image is decoded, width() and height() are valid */
+        bool isDecoded() const;
+
+        /** The texture is completely uploaded */
+        bool isReady() const;
+
+        /** Decoding or uploading failed, see errorString() */
+        bool hasError() const;
+        QString errorString() const;
+
+        /** Image size, or 0 before isDecoded() */
+        uint width() const;
+        uint height() const;
+
+        /** The texture, or NULL until isReady() */
+        Texture * texture() const;
+
+        // ------------ upload ------------
+
+        /** Continues uploading within the frame's time budget.
+            If @p wait is true, blocks until the image is decoded
+            and uploads it completely.
+            Must be called from the OpenGL thread. Returns isReady().
+            @throws GlException on OpenGL errors */
+        bool upload(bool wait = false);
+
+    private:
+        struct Private;
+        Private * p_;
+    };
+
+    // ----------- settings -----------
+
+    /** Limit of decoded but not yet uploaded bytes.
+        Workers pause decoding while the staging cache is full.
+        Default is 256mb */
+    static size_t maxStagingBytes();
+    static void setMaxStagingBytes(size_t bytes);
+
+    /** Seconds after which a decoded image that is not uploaded
+        may be evicted from a full staging cache. Default is 2 */
+    static Double stagingTimeout();
+    static void setStagingTimeout(Double seconds);
+
+    /** Number of decoding threads, must be set before the first load().
+        0 means one less than the number of cores. Default is 2. */
+    static uint numberThreads();
+    static void setNumberThreads(uint num);
+
+    /** Maximum time in seconds spent in Image::upload() per frame.
+        Default is 0.004 */
+    static Double uploadBudget();
+    static void setUploadBudget(Double seconds);
+
+    // ----------- loading ------------
+
+    /** Queues the file for decoding and returns a handle.
+        Never blocks, errors are reported through Image::hasError(). */
+    static Image * load(const QString& filename, gl::GLenum gpu_format,
+                        uint mipmap_levels = 0);
+
+    /** Cancels decoding and deletes the handle.
+        If the texture was created, this must be called from
+        the OpenGL thread. */
+    static void release(Image * image);
+
+    /** Starts a new upload time slice and releases the textures
+        of images that were released while decoding.
+        Called once per frame by Scene::renderScene() */
+    static void beginFrame();
+
+    // ---------- statistics ----------
+
+    /** Number of images waiting for or being decoded */
+    static size_t queueDepth();
+
+    /** Number of decoded bytes that are not uploaded yet */
+    static size_t bytesInFlight();
+
+    /** Number of images that were decoded and uploaded completely */
+    static uint64_t numLoaded();
+
+    /** Number of times decoded images were evicted from the staging cache */
+    static uint64_t numEvicted();
+
+private:
+
+    static TextureLoader * p_getInstance_();
+
+    struct Private;
+    Private * p_;
+};
+
+} // namespace GL
+} // namespace MO
+
+#endif // MOSRC_GL_TEXTURELOADER_H
@@ -106,12 +106,15 @@ struct RenderDialog::Private
     QWidget
             * groupImage,
             * groupAudio,
-            * groupAudioSplit;
+            * groupAudioSplit,
+            * groupVideo;
     FilenameInput
             * editDir;
     QLineEdit
             * editImageName,
-            * editAudioName;
+            * editAudioName,
+            * editVideoName,
+            * editVideoCodec;
     SpinBox
             * spinImageNum,
             * spinImageNumWidth,
@@ -121,6 +124,9 @@ struct RenderDialog::Private
             * spinImageQuality,
             * spinImageThreads,
             * spinImageQues,
+            * spinImageReadback,
+            * spinVideoBitrate,
+            * spinVideoThreads,
             * spinAudioNum,
             * spinAudioNumWidth,
             * spinAudioChannels,
@@ -137,7 +143,8 @@ struct RenderDialog::Private
             * checkImageComp,
             * checkAudio,
             * checkAudioSplit,
-            * checkAudioNorm;
+            * checkAudioNorm,
+            * checkVideo;
     QLabel
             * labelTime,
             * labelImageName,
@@ -384,6 +391,74 @@ void RenderDialog::Private::createWidgets()
                     connect(spinImageQues, SIGNAL(valueChanged(int)),
                             diag, SLOT(p_onWidget_()));
 
+                    // readback buffers
+                    spinImageReadback = new SpinBox(diag);
+                    spinImageReadback->setLabel(tr("readback buffers"));
+                    spinImageReadback->setStatusTip(
+                        tr("Number of frames that are transferred from the graphics card "
+                           "and stored in parallel"));
+                    spinImageReadback->setRange(1, 64);
+                    spinImageReadback->setValue(rendSet.imageNumReadback());
+                    lv->addWidget(spinImageReadback);
+                    connect(spinImageReadback, SIGNAL(valueChanged(int)),
+                            diag, SLOT(p_onWidget_()));
+
+                    // ---- video ----
+
+                    checkVideo = new QCheckBox(tr("encode video file"), diag);
+                    checkVideo->setStatusTip(
+                        tr("Encodes images and audio directly into one video file "
+                           "instead of writing single images"));
+                    checkVideo->setChecked(rendSet.videoEnable());
+                    lv->addWidget(checkVideo);
+                    connect(checkVideo, SIGNAL(stateChanged(int)),
+                            diag, SLOT(p_onWidget_()));
+#ifndef MO_ENABLE_FFMPEG
+                    checkVideo->setVisible(false);
+#endif
+
+                    groupVideo = new QWidget(diag);
+                    lv->addWidget(groupVideo);
+                    auto lv1 = new QVBoxLayout(groupVideo);
+                    lv1->setMargin(0);
+
+                        // filename
+                        editVideoName = new QLineEdit(diag);
+                        editVideoName->setStatusTip(
+                            tr("Video filename, the container format is "
+                               "derived from the extension"));
+                        editVideoName->setText(rendSet.videoFilename());
+                        lv1->addWidget(editVideoName);
+                        connect(editVideoName, SIGNAL(textChanged(QString)),
+                                diag, SLOT(p_onWidget_()));
+
+                        // codec
+                        editVideoCodec = new QLineEdit(diag);
+                        editVideoCodec->setStatusTip(
+                            tr("ffmpeg name of the video codec, e.g. libx264 or mpeg4"));
+                        editVideoCodec->setText(rendSet.videoCodec());
+                        lv1->addWidget(editVideoCodec);
+                        connect(editVideoCodec, SIGNAL(textChanged(QString)),
+                                diag, SLOT(p_onWidget_()));
+
+                        // bitrate
+                        spinVideoBitrate = new SpinBox(diag);
+                        spinVideoBitrate->setLabel(tr("bitrate [kbit/s]"));
+                        spinVideoBitrate->setRange(0, 1000000);
+                        spinVideoBitrate->setValue(rendSet.videoBitrate());
+                        lv1->addWidget(spinVideoBitrate);
+                        connect(spinVideoBitrate, SIGNAL(valueChanged(int)),
+                                diag, SLOT(p_onWidget_()));
+
+                        // threads
+                        spinVideoThreads = new SpinBox(diag);
+                        spinVideoThreads->setLabel(tr("encoder threads (0 = auto)"));
+                        spinVideoThreads->setRange(0, 256);
+                        spinVideoThreads->setValue(rendSet.videoNumThreads());
+                        lv1->addWidget(spinVideoThreads);
+                        connect(spinVideoThreads, SIGNAL(valueChanged(int)),
+                                diag, SLOT(p_onWidget_()));
+
                     // que size label
                     labelQueSize = new QLabel(diag);
                     labelQueSize->setAlignment(Qt::AlignRight);
@@ -560,6 +635,12 @@ void RenderDialog::Private::updateFromWidgets()
     rendSet.setImageCompression(checkImageComp->isChecked());
     rendSet.setImageNumThreads(spinImageThreads->value());
     rendSet.setImageNumQue(spinImageQues->value());
+    rendSet.setImageNumReadback(spinImageReadback->value());
+    rendSet.setVideoEnable(checkVideo->isChecked());
+    rendSet.setVideoFilename(editVideoName->text());
+    rendSet.setVideoCodec(editVideoCodec->text());
+    rendSet.setVideoBitrate(spinVideoBitrate->value());
+    rendSet.setVideoNumThreads(spinVideoThreads->value());
 
     // ----------- audio -----------
 
@@ -611,6 +692,12 @@ void RenderDialog::Private::updateFromSettings()
     checkImageComp->setChecked(rendSet.imageCompression());
     spinImageThreads->setValue(rendSet.imageNumThreads());
     spinImageQues->setValue(rendSet.imageNumQue());
+    spinImageReadback->setValue(rendSet.imageNumReadback());
+    checkVideo->setChecked(rendSet.videoEnable());
+    editVideoName->setText(rendSet.videoFilename());
+    editVideoCodec->setText(rendSet.videoCodec());
+    spinVideoBitrate->setValue(rendSet.videoBitrate());
+    spinVideoThreads->setValue(rendSet.videoNumThreads());
 
     // -- audio --
 
@@ -677,7 +764,8 @@ void RenderDialog::Private::updateInfoLabels()
 
     labelQueSize->setText(tr("max image memory: %1")
                           .arg(byte_to_string(rendSet.imageSizeBytes()
-                                              * (rendSet.imageNumQue() + rendSet.imageNumThreads()))));
+                                              * (rendSet.imageNumQue() + rendSet.imageNumThreads()
+                                                 + rendSet.imageNumReadback()))));
 }
 
 void RenderDialog::Private::updateActivity()
@@ -685,6 +773,11 @@ void RenderDialog::Private::updateActivity()
     groupImage->setEnabled(rendSet.imageEnable());
     groupAudio->setEnabled(rendSet.audioEnable());
     groupAudioSplit->setEnabled(rendSet.audioSplitEnable());
+#ifdef MO_ENABLE_FFMPEG
+    groupVideo->setVisible(rendSet.videoEnable());
+#else
+    groupVideo->setVisible(false);
+#endif
     butGo->setEnabled( rendSet.imageEnable()
                        || rendSet.audioEnable()
                        || rendSet.audioSplitEnable() );
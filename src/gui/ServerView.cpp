@@ -177,7 +177,17 @@ QWidget * ServerView::createClientWidget_(int index, const ClientInfo & inf)
             << " files ready " << (inf.state.isFilesReady() ? tr("YES") : tr("no"))
             << " playing " << (inf.state.isPlayback() ? tr("YES") : tr("no"))
             << "\nmemory use " << byte_to_string(inf.state.memory())
-            << ", file cache " << byte_to_string(inf.state.cacheSize());
+            << ", file cache " << byte_to_string(inf.state.cacheSize())
+            << "\nclock offset " << inf.state.clockOffset() * 1000. << "ms"
+            << ", drift " << inf.state.clockDrift() * 1000000. << "ppm"
+            << ", round-trip " << inf.state.roundTrip() * 1000. << "ms"
+            << "\nframe skew " << inf.state.frameSkew() * 1000. << "ms"
+            << " (max " << inf.state.maxFrameSkew() * 1000. << "ms)";
+        if (inf.state.filesPending())
+            str << "\ntransferring " << inf.state.filesPending() << " files, "
+                << byte_to_string(inf.state.transferBytes()) << " / "
+                << byte_to_string(inf.state.transferTotal()) << " at "
+                << byte_to_string((unsigned long)inf.state.transferRate()) << "/s";
 
         auto label = new QLabel(labelText, w);
         lv->addWidget(label);
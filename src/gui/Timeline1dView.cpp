@@ -192,8 +192,8 @@ void Timeline1DView::fitSelectionToView(bool fitX, bool fitY, int marginInPixels
     bool f = true;
     for (auto h : selectHashSet_)
     {
-        auto pointIt = tl_->getData().lower_bound(h);
-        if (pointIt != tl_->getData().end())
+        auto pointIt = points_().lower_bound(h);
+        if (pointIt != points_().end())
         {
             if (f)
             {
@@ -366,7 +366,7 @@ void Timeline1DView::updateAroundPoint_(const MATH::Timeline1d::Point &p)
     auto first = tl_->find(p.t),
          last = first;
 
-    if (first == tl_->getData().end())
+    if (first == points_().end())
         return;
 
     // determine number of neighbour points
@@ -384,10 +384,10 @@ void Timeline1DView::updateAroundPoint_(const MATH::Timeline1d::Point &p)
 
     // expand left
     int i=0;
-    while ((i++)<expand_left && first != tl_->getData().begin())
+    while ((i++)<expand_left && first != points_().begin())
         --first;
 
-    if (i>expand_left && first != tl_->getData().end())
+    if (i>expand_left && first != points_().end())
         x1 = time2screen(first->second.t) - handleRadiusSelected_ - 1;
 
     // expand right
@@ -396,11 +396,11 @@ void Timeline1DView::updateAroundPoint_(const MATH::Timeline1d::Point &p)
     {
         auto next = last;
         ++next;
-        if (next == tl_->getData().end())
+        if (next == points_().end())
             break;
         last = next;
     }
-    if (i>expand_right && last != tl_->getData().end())
+    if (i>expand_right && last != points_().end())
         x2 = time2screen(last->second.t) + handleRadiusSelected_ + 1;
 
     // wow, not clear if this is actually more efficient in any case
@@ -457,7 +457,7 @@ void Timeline1DView::paintEvent(QPaintEvent * e)
 
     Double ylim1 = screen2value(0),
            ylim0 = screen2value(height()-1);
-    for (auto it = it0; it != it1 && it != tl_->getData().end(); ++it)
+    for (auto it = it0; it != it1 && it != points_().end(); ++it)
     {
         const MATH::Timeline1d::Point& po = it->second;
 
@@ -565,8 +565,8 @@ void Timeline1DView::clearHover_()
     // remove old flag
     if (wasHash != hoverHash_)
     {
-        auto it1 = tl_->getData().lower_bound(wasHash);
-        if (it1 != tl_->getData().end())
+        auto it1 = points_().lower_bound(wasHash);
+        if (it1 != points_().end())
             updateHandles_(it1->second);
     }
 }
@@ -589,11 +589,11 @@ void Timeline1DView::setHover_(const MATH::Timeline1d::Point & p, bool setDeriv)
     if ((isHover_() || isDerivativeHover_()) && tl_)
     {
         // remove old flag
-        auto it1 = tl_->getData().lower_bound(hoverHash_);
-        if (it1 != tl_->getData().end())
+        auto it1 = points_().lower_bound(hoverHash_);
+        if (it1 != points_().end())
             updateHandles_(it1->second);
-        it1 = tl_->getData().lower_bound(derivativeHoverHash_);
-        if (it1 != tl_->getData().end())
+        it1 = points_().lower_bound(derivativeHoverHash_);
+        if (it1 != points_().end())
             updateHandles_(it1->second);
     }
 
@@ -643,8 +643,8 @@ void Timeline1DView::clearSelect_()
     // remove old flags
     for (auto &i : selectHashSet_)
     {
-        auto it1 = tl_->getData().lower_bound(i);
-        if (it1 != tl_->getData().end())
+        auto it1 = points_().lower_bound(i);
+        if (it1 != points_().end())
             updateHandles_(it1->second);
     }
     selectHashSet_.clear();
@@ -681,7 +681,7 @@ void Timeline1DView::addSelect_(const QRect &rect, bool do_swap)
 
     auto it = tl_->first(xmin);
 
-    for (; it != tl_->getData().end(); ++it)
+    for (; it != points_().end(); ++it)
     {
         if (it->second.t > xmax)
             break;
@@ -886,8 +886,8 @@ void Timeline1DView::mouseMoveEvent(QMouseEvent * e)
                    ylim0 = screen2value(height()-1);
             for (const auto& h : selectHashSet_)
             {
-                auto it1 = tl_->getData().lower_bound(h);
-                if (it1 != tl_->getData().end())
+                auto it1 = points_().lower_bound(h);
+                if (it1 != points_().end())
                 {
                     const MATH::Timeline1d::Point& po = it1->second;
                     if (po.val < ylim0 || po.val > ylim1)
@@ -915,8 +915,8 @@ void Timeline1DView::mouseMoveEvent(QMouseEvent * e)
             derivativeHoverHash_ = MATH::Timeline1d::InvalidHash;
             if (oldDerivativeHoverHash != MATH::Timeline1d::InvalidHash)
             {
-                auto it1 = tl_->getData().lower_bound(oldDerivativeHoverHash);
-                if (it1 != tl_->getData().end())
+                auto it1 = points_().lower_bound(oldDerivativeHoverHash);
+                if (it1 != points_().end())
                     updateHandles_(it1->second);
             }
             setCursor(Qt::ArrowCursor);
@@ -931,7 +931,7 @@ void Timeline1DView::mouseMoveEvent(QMouseEvent * e)
         auto it = tl_->first(x-rx),
              last = tl_->next_after(x+rx);
         // iterate over all of them
-        for (; it != tl_->getData().end() && it != last; ++it)
+        for (; it != points_().end() && it != last; ++it)
         {
             // hover a handle?
             if (x >= it->second.t - rx
@@ -971,10 +971,10 @@ void Timeline1DView::mouseMoveEvent(QMouseEvent * e)
     if (options_ & O_AddRemovePoints)
     {
         auto it = tl_->closest(x);
-        if (it != tl_->getData().end())
+        if (it != points_().end())
         {
             // get the point left of mouse
-            if (it->second.t > x && it != tl_->getData().begin())
+            if (it->second.t > x && it != points_().begin())
                 --it;
 
             if (it->second.t <= x)
@@ -1350,6 +1350,9 @@ void Timeline1DView::moveSelected_(Double dx, Double dy)
                 updateDerivatives_(p.it);
         }
 
+        // values were changed through stored iterators
+        tl_->setChanged();
+
         return;
     }
 
@@ -1376,6 +1379,7 @@ void Timeline1DView::moveSelected_(Double dx, Double dy)
             if (it2 == p.it)
             {
                 p.it->second.val = limitY_( p.oldp.val + dy );
+                tl_->setChanged();
                 //p.it->second.d1 = p.oldp.d1;
                 updateAroundPoint_(p.it->second);
             }
@@ -251,6 +251,12 @@ protected:
     /** Limits the value to the screen when moving/zooming is disabled. */
     Double limitY_(Double value) const;
 
+    /** Read-only access to the points of the timeline.
+        Unlike Timeline1d::getData(), this does not invalidate the
+        caches of the timeline, so use it for painting and hovering. */
+    const MATH::Timeline1d::TpList& points_() const
+        { return static_cast<const MATH::Timeline1d*>(tl_)->getData(); }
+
     // ____________ MEMBER _____________
 
     MATH::Timeline1d * tl_;
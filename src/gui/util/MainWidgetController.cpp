@@ -351,6 +351,8 @@ void MainWidgetController::createObjects_()
         serverView_ = new ServerView(window_);
         connect(serverView_, SIGNAL(sendScene()),
                 this, SLOT(sendSceneToClients_()));
+        // replicate edits to clients
+        serverEngine().setObjectEditor(objectEditor_);
     }
 #endif
 
@@ -575,6 +577,11 @@ void MainWidgetController::createMainMenu(QMenuBar * menuBar)
             a->setShortcut(Qt::ALT + Qt::SHIFT + Qt::Key_4);
             connect(a, SIGNAL(triggered()), this, SLOT(updateDebugRender_()));
 
+            sub->addAction(a = aDrawBoundingVolumes_ = new QAction(tr("Show bounding volumes"), sub));
+            a->setCheckable(true);
+            a->setShortcut(Qt::ALT + Qt::SHIFT + Qt::Key_5);
+            connect(a, SIGNAL(triggered()), this, SLOT(updateDebugRender_()));
+
         m->addSeparator();
 
 
@@ -1898,6 +1905,7 @@ void MainWidgetController::updateDebugRender_()
         | (Scene::DD_CAMERAS * aDrawCameras_->isChecked())
         | (Scene::DD_LIGHT_SOURCES * aDrawLightSources_->isChecked())
         | (Scene::DD_MICROPHONES * aDrawMicrophones_->isChecked())
+        | (Scene::DD_BOUNDING_VOLUMES * aDrawBoundingVolumes_->isChecked())
                 );
 }
 
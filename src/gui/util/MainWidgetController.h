@@ -306,6 +306,7 @@ private:
             * aDrawAudioSources_,
             * aDrawCameras_,
             * aDrawMicrophones_,
+            * aDrawBoundingVolumes_,
             * aResolutionOutput_,
             * aResolutionCustom_,
             * aResolutionPredefined_,
@@ -11,6 +11,7 @@
 //#include <QDebug>
 
 #include <QMap>
+#include <QSet>
 #include <QFileInfo>
 #include <QDateTime>
 #include <QDir>
@@ -18,6 +19,8 @@
 #include "ClientFiles.h"
 #include "engine/ClientEngine.h"
 #include "network/NetEvent.h"
+#include "network/NetworkManager.h"
+#include "network/FileTransfer.h"
 #include "network/netlog.h"
 #include "io/XmlStream.h"
 #include "io/Settings.h"
@@ -37,6 +40,7 @@ public:
 
     Private(ClientFiles * cf)
         : cf(cf)
+        , transfer(new FileTransfer(cf))
         , saveCachePending(false)
         , cacheSizeChanged(true)
     { }
@@ -50,6 +54,12 @@ public:
                 serverTime,
         /** Set to serverTime on transfer */
                 clientTime;
+        /** Content hash of the server file, empty for servers
+            without FileServer */
+        QByteArray serverHash,
+        /** Content hash of the cached file */
+                clientHash;
+        FileManifest manifest;
         bool    serverPresent,
                 clientPresent,
         /** Server has submitted file time (serverTime) ? */
@@ -69,11 +79,22 @@ public:
     bool checkAllReady();
     /** Returns a list of all filenames in the cache directory */
     QStringList getCacheFiles();
+    /** Returns the name of the file in the cache directory */
+    static QString localFilename(const QString& serverFilename);
+    /** The cached file matches the server file */
+    static bool isUpToDate(const FileInfo&);
+    /** Gets the server file through a copy, the FileTransfer or NetEventFile */
+    void transferFile(FileInfo&);
+    /** Sets the flags for a received file and emits the signals */
+    void fileReceived(FileInfo&);
 
     ClientFiles * cf;
+    FileTransfer * transfer;
 
     /** serverFilename, FileInfo */
     QMap<QString, FileInfo> files;
+    /** serverFilenames requested by fetchFile() */
+    QSet<QString> fetching;
 
     bool saveCachePending,
         cacheSizeChanged;
@@ -105,6 +126,13 @@ ClientFiles::ClientFiles(QObject *parent)
         MO_NETLOG(ERROR, "ClientFiles is unable to access/create filecache directory '"
                   << cachedir << "'");
 
+    connect(p_->transfer, SIGNAL(fileFinished(QString,QString)),
+            this, SLOT(onTransferFinished_(QString,QString)));
+    connect(p_->transfer, SIGNAL(fileFailed(QString)),
+            this, SLOT(onTransferFailed_(QString)));
+    connect(p_->transfer, SIGNAL(progress()),
+            this, SIGNAL(transferProgress()));
+
     p_->loadCache();
 }
 
@@ -132,25 +160,20 @@ void ClientFiles::fetchFile(const QString &serverFilename)
             MO_NETLOG(DEBUG, "ClientFiles: in cache but not present: '" << serverFilename << "'")
         else
         {
-            // matches server-time?
-            if (!(it.value().timeUpdated
-                  && it.value().clientTime == it.value().serverTime))
-            {
-                MO_NETLOG(DEBUG, "ClientFiles: in cache but outdated: '" << serverFilename << "'");
-                p_->requestFileTime(it.value().serverFilename);
-            }
-            else
+            // matches server content?
+            if (Private::isUpToDate(it.value()))
             {
                 MO_NETLOG(DEBUG, "ClientFiles::fileReady(" << serverFilename << ")");
                 emit fileReady(serverFilename, it.value().clientFilename);
+                return;
             }
-            return;
+            MO_NETLOG(DEBUG, "ClientFiles: in cache but outdated: '" << serverFilename << "'");
         }
-
     }
 
-    // not there at all?
-    p_->requestFile(serverFilename);
+    // the answer tells if and how to get the file
+    p_->fetching.insert(serverFilename);
+    p_->requestFileTime(serverFilename);
 }
 
 
@@ -160,49 +183,67 @@ void ClientFiles::receiveFileInfo(NetEventFileInfo * e)
 
     auto it = p_->files.find(e->filename());
 
-    // update existing cache info
-    if (it != p_->files.end())
-    {
-        MO_NETLOG(DEBUG, "ClientFiles: updating cache for '" << e->filename() << "'");
+    const bool isFetched = p_->fetching.contains(e->filename());
 
-//        const QString datetime_format = "yyyy.MM.dd-hh:mm:ss.zzz";
-//        qDebug() << "----------------" << e->time().toString();
-//        qDebug() << "----------++++++" << e->time().toString(datetime_format);
-
-        it.value().serverTime = e->time();
-        it.value().serverPresent = e->isPresent();
-        it.value().timeUpdated = true;
-
-        saveCache();
+    // new entries are only of interest when requested
+    if (it == p_->files.end())
+    {
+        if (!isFetched)
+            return;
 
-        // if file time has changed, request the whole file
-        if (it.value().clientTime < it.value().serverTime)
-            p_->requestFile(it.value().serverFilename);
-        else
-        {
-            MO_NETLOG(DEBUG, "ClientFiles: file is UP-TO-DATE '" << e->filename() << "'");
-            // done?
-            if (p_->checkAllReady())
-            {
-                MO_NETLOG(DEBUG, "READY----------------------");
-                emit allFilesReady();
-            }
-        }
-        return;
+        Private::FileInfo f;
+        f.serverFilename = e->filename();
+        f.clientFilename = Private::localFilename(f.serverFilename);
+        f.clientPresent = false;
+        f.transferRequested = false;
+        it = p_->files.insert(f.serverFilename, f);
     }
+    else
+        MO_NETLOG(DEBUG, "ClientFiles: updating cache for '" << e->filename() << "'");
 
-    // create new entry
-    Private::FileInfo f;
-    f.serverFilename = e->filename();
+    Private::FileInfo& f = it.value();
     f.serverTime = e->time();
     f.serverPresent = e->isPresent();
-    f.clientPresent = false;
+    f.manifest = e->manifest();
+    f.serverHash = f.manifest.hash();
     f.timeUpdated = true;
     // clear flag, once the info is there
     f.infoRequested = false;
-    p_->files.insert(f.serverFilename, f);
 
     saveCache();
+
+    if (!f.serverPresent)
+    {
+        MO_NETLOG(WARNING, "ClientFiles: file not present on server '"
+                  << e->filename() << "'");
+        if (isFetched)
+        {
+            p_->fetching.remove(f.serverFilename);
+            emit fileNotReady(f.serverFilename);
+        }
+        return;
+    }
+
+    if (!Private::isUpToDate(f))
+    {
+        p_->transferFile(f);
+        return;
+    }
+
+    MO_NETLOG(DEBUG, "ClientFiles: file is UP-TO-DATE '" << e->filename() << "'");
+
+    if (isFetched)
+    {
+        p_->fetching.remove(f.serverFilename);
+        emit fileReady(f.serverFilename, f.clientFilename);
+    }
+
+    // done?
+    if (p_->checkAllReady())
+    {
+        MO_NETLOG(DEBUG, "READY----------------------");
+        emit allFilesReady();
+    }
 }
 
 void ClientFiles::receiveFile(NetEventFile * e)
@@ -225,34 +266,129 @@ void ClientFiles::receiveFile(NetEventFile * e)
     // clear flag, once the file is there
     f->transferRequested = false;
 
-    // construct a local filename
-    f->clientFilename = f->serverFilename;
-    f->clientFilename.replace("/","_");
-    f->clientFilename.replace("\\","_");
-    f->clientFilename.replace(":","_");
-    f->clientFilename.insert(0,
-            settings()->getValue("Directory/filecache").toString()
-            + QDir::separator());
-
-    f->clientTime = f->serverTime;
+    f->clientFilename = Private::localFilename(f->serverFilename);
     f->timeUpdated = true;
     f->clientPresent = f->serverPresent &&
                         e->saveFile(f->clientFilename);
 
-    p_->cacheSizeChanged = true;
-
-    saveCache();
-
     if (!f->clientPresent)
+    {
+        p_->cacheSizeChanged = true;
+        saveCache();
+        p_->fetching.remove(f->serverFilename);
         emit fileNotReady(f->serverFilename);
+    }
     else
     {
-        emit fileReady(f->serverFilename, f->clientFilename);
+        // servers without FileServer don't send a hash
+        if (f->serverHash.isEmpty())
+            f->serverHash = FileManifest::hashData(e->data());
+        p_->fileReceived(*f);
+    }
+}
+
+void ClientFiles::onTransferFinished_(const QString &serverFilename, const QString &)
+{
+    auto it = p_->files.find(serverFilename);
+    if (it != p_->files.end())
+        p_->fileReceived(it.value());
+}
+
+void ClientFiles::onTransferFailed_(const QString &serverFilename)
+{
+    MO_NETLOG(WARNING, "ClientFiles: transfer of '" << serverFilename
+              << "' failed, requesting whole file");
+
+    // try the event connection
+    auto it = p_->files.find(serverFilename);
+    if (it != p_->files.end())
+        it.value().transferRequested = false;
+    p_->requestFile(serverFilename);
+}
+
+int ClientFiles::numPendingFiles() const { return p_->transfer->numPendingFiles(); }
+qint64 ClientFiles::transferBytes() const { return p_->transfer->bytesDone(); }
+qint64 ClientFiles::transferTotal() const { return p_->transfer->bytesTotal(); }
+double ClientFiles::transferRate() const { return p_->transfer->bytesPerSecond(); }
+
+QString ClientFiles::Private::localFilename(const QString &serverFilename)
+{
+    QString fn = serverFilename;
+    fn.replace("/","_");
+    fn.replace("\\","_");
+    fn.replace(":","_");
+    fn.insert(0, settings()->getValue("Directory/filecache").toString()
+                 + QDir::separator());
+    return fn;
+}
+
+bool ClientFiles::Private::isUpToDate(const FileInfo & f)
+{
+    if (!(f.serverPresent && f.clientPresent && f.timeUpdated))
+        return false;
+    // compare content if known
+    if (!f.serverHash.isEmpty())
+        return f.clientHash == f.serverHash;
+    return f.clientTime == f.serverTime;
+}
+
+void ClientFiles::Private::transferFile(FileInfo & f)
+{
+    // server without FileServer
+    if (!f.manifest.isValid())
+    {
+        requestFile(f.serverFilename);
+        return;
+    }
+
+    if (f.transferRequested)
+        return;
+
+    if (f.clientFilename.isEmpty())
+        f.clientFilename = localFilename(f.serverFilename);
+
+    // same content cached under another name?
+    for (const FileInfo& o : files)
+    {
+        if (&o == &f || !o.clientPresent || o.clientHash != f.serverHash
+            || QFileInfo(o.clientFilename).size() != f.manifest.size())
+            continue;
+
+        MO_NETLOG(DEBUG, "ClientFiles: copying '" << o.clientFilename
+                  << "' for '" << f.serverFilename << "'");
 
-        // done?
-        if (p_->checkAllReady())
-            emit allFilesReady();
+        QFile::remove(f.clientFilename);
+        if (QFile::copy(o.clientFilename, f.clientFilename))
+        {
+            fileReceived(f);
+            return;
+        }
     }
+
+    f.transferRequested = true;
+    transfer->setServerAddress(clientEngine().serverAddress(),
+                               NetworkManager::defaultFileTcpPort());
+    // an old version is searched for unchanged chunks
+    transfer->download(f.serverFilename, f.manifest, f.clientFilename,
+                       f.clientPresent ? f.clientFilename : QString());
+}
+
+void ClientFiles::Private::fileReceived(FileInfo & f)
+{
+    f.clientPresent = true;
+    f.clientHash = f.serverHash;
+    f.clientTime = f.serverTime;
+    f.transferRequested = false;
+
+    cacheSizeChanged = true;
+    cf->saveCache();
+
+    fetching.remove(f.serverFilename);
+    emit cf->fileReady(f.serverFilename, f.clientFilename);
+
+    // done?
+    if (checkAllReady())
+        emit cf->allFilesReady();
 }
 
 QStringList ClientFiles::Private::getCacheFiles()
@@ -284,6 +420,7 @@ quint64 ClientFiles::cacheSize() const
 void ClientFiles::clearCache()
 {
     p_->cacheSizeChanged = true;
+    p_->transfer->cancel();
 
     auto fns = p_->getCacheFiles();
     for (const auto & fn : fns)
@@ -339,6 +476,7 @@ void ClientFiles::Private::saveCache()
             xml.write("time", f.serverTime);
             xml.write("local-name", f.clientFilename);
             xml.write("local-time", f.clientTime);
+            xml.write("hash", QString::fromLatin1(f.clientHash.toHex()));
             xml.endSection();
         }
 
@@ -378,9 +516,12 @@ void ClientFiles::Private::loadCache()
                 f.serverTime = xml.expectDateTime("time");
                 f.clientFilename = xml.expectString("local-name");
                 f.clientTime = xml.expectDateTime("local-time");
+                f.clientHash = QByteArray::fromHex(xml.readString("hash").toLatin1());
                 f.serverPresent = false;
                 f.clientPresent = false;
                 f.timeUpdated = false;
+                f.infoRequested = false;
+                f.transferRequested = false;
 
                 files.insert(f.serverFilename, f);
             }
@@ -439,8 +580,11 @@ void ClientFiles::Private::requestFileTime(const QString& serverFilename)
 
     // if sending failed
     if (!clientEngine().sendEvent(event))
+    {
         // we definitely won't get a file
+        fetching.remove(serverFilename);
         emit cf->fileNotReady(serverFilename);
+    }
     else
     {
         // flag as requested
@@ -494,9 +638,7 @@ bool ClientFiles::Private::checkAllReady()
 #endif
 
     for (const FileInfo& f : files)
-        if (!(f.serverPresent && f.clientPresent
-              && f.timeUpdated
-              && f.clientTime == f.serverTime))
+        if (!isUpToDate(f))
             return false;
 //    MO_DEBUG("YES...............");
     return true;
@@ -34,6 +34,18 @@ public:
     /** Returns the size of all files in the cache directory */
     quint64 cacheSize() const;
 
+    // --------- transfer state -----------
+
+    /** Number of files that are queued or in transfer */
+    int numPendingFiles() const;
+
+    /** Bytes of the current transfers that are present */
+    qint64 transferBytes() const;
+    /** Bytes of all current transfers */
+    qint64 transferTotal() const;
+    /** Current download speed in bytes per second */
+    double transferRate() const;
+
 signals:
 
     /** Emitted when a particular file was received */
@@ -45,6 +57,9 @@ signals:
     /** Emitted when all files in the cache are up-to-date with the server files */
     void allFilesReady();
 
+    /** Emitted at most twice a second while files are transferred */
+    void transferProgress();
+
 public slots:
 
     /** Deletes the whole cache directory. */
@@ -60,7 +75,9 @@ public slots:
     void saveCacheNow();
 
     /** Looks out for the given file.
-        First the cache is checked and if necessary the server is querried for the file.
+        First the cache is checked and if necessary the server is querried for the
+        content hash of the file. Files with changed content are fetched through
+        the FileTransfer, or copied when another cached file has the same content.
         fileReady() or fileNotReady() will be emitted. */
     void fetchFile(const QString& serverFilename);
 
@@ -69,6 +86,11 @@ public slots:
     /** Called by ClientEngine upon event from server */
     void receiveFile(NetEventFile *);
 
+private slots:
+
+    void onTransferFinished_(const QString& serverFilename, const QString& clientFilename);
+    void onTransferFailed_(const QString& serverFilename);
+
 private:
 
     class Private;
@@ -10,7 +10,6 @@
 
 #include "CurrentTime.h"
 #include "ApplicationTime.h"
-#include "network/NetEvent.h"
 #include "engine/ServerEngine.h"
 #include "engine/LiveAudioEngine.h"
 #include "io/Application.h"
@@ -47,11 +46,7 @@ void CurrentTime::setTime(Double time)
 
 #ifndef MO_DISABLE_SERVER
     if (isServer() && serverEngine().isRunning())
-    {
-        auto e = new NetEventTime();
-        e->setTime(time);
-        serverEngine().sendEvent(e);
-    }
+        serverEngine().sendTime(time);
 #endif
 }
 
@@ -51,6 +51,7 @@ void DiskRenderSettings::p_setDefault_()
     p_image_comp_ = 1;
     p_image_threads_ = QThread::idealThreadCount();
     p_image_ques_ = 16;
+    p_image_readback_ = 4;
 
     p_audio_enable_ = true;
     p_audio_split_enable_ = true;
@@ -64,9 +65,16 @@ void DiskRenderSettings::p_setDefault_()
     for (AudioFormat & f : p_audio_formats_)
         if (f.ext == "wav")
             { p_audio_format_idx_ = f.index; }
+
+    p_video_enable_ = false;
+    p_video_filename_ = "video.mp4";
+    p_video_codec_ = "libx264";
+    p_video_audio_codec_ = "aac";
+    p_video_bitrate_ = 16000;
+    p_video_threads_ = 0;
 }
 
-/** @todo serialize/deserialize DiskRenderSettings */
+/** @todo serialize/deserialize audio settings */
 void DiskRenderSettings::serialize(IO::XmlStream& io) const
 {
     io.createSection("disk-render-settings");
@@ -88,6 +96,14 @@ void DiskRenderSettings::serialize(IO::XmlStream& io) const
         io.write("image-compression", p_image_comp_);
         io.write("image-threads", p_image_threads_);
         io.write("image-que", p_image_ques_);
+        io.write("image-readback", p_image_readback_);
+
+        io.write("video-enable", p_video_enable_);
+        io.write("video-name", p_video_filename_);
+        io.write("video-codec", p_video_codec_);
+        io.write("video-audio-codec", p_video_audio_codec_);
+        io.write("video-bitrate", p_video_bitrate_);
+        io.write("video-threads", p_video_threads_);
 
         //io.write("audio-", p_audio_conf_);
         //io.write("audio-", p_audio_pattern_);
@@ -104,7 +120,27 @@ void DiskRenderSettings::deserialize(IO::XmlStream & io)
 
     //const int ver = io.expectInt("version");
 
-
+    // missing keys keep their current value
+    p_directory_ = io.readString("directory", p_directory_);
+    p_image_pattern_ = io.readString("image-name", p_image_pattern_);
+    p_image_num_offset_ = io.readLUInt("image-num-offset", p_image_num_offset_);
+    p_image_num_width_ = io.readLUInt("image-num-width", p_image_num_width_);
+    p_image_w_ = io.readLUInt("image-width", p_image_w_);
+    p_image_h_ = io.readLUInt("image-height", p_image_h_);
+    p_image_fps_ = io.readLUInt("image-fps", p_image_fps_);
+    setImageFormat(io.readString("image-format", imageFormatId()));
+    p_image_quality_ = io.readLUInt("image-quality", p_image_quality_);
+    p_image_comp_ = io.readLUInt("image-compression", p_image_comp_);
+    p_image_threads_ = io.readLUInt("image-threads", p_image_threads_);
+    p_image_ques_ = io.readLUInt("image-que", p_image_ques_);
+    p_image_readback_ = io.readLUInt("image-readback", p_image_readback_);
+
+    p_video_enable_ = io.readBool("video-enable", p_video_enable_);
+    p_video_filename_ = io.readString("video-name", p_video_filename_);
+    p_video_codec_ = io.readString("video-codec", p_video_codec_);
+    p_video_audio_codec_ = io.readString("video-audio-codec", p_video_audio_codec_);
+    p_video_bitrate_ = io.readLUInt("video-bitrate", p_video_bitrate_);
+    p_video_threads_ = io.readLUInt("video-threads", p_video_threads_);
 }
 
 
@@ -249,6 +285,20 @@ QString DiskRenderSettings::makeAudioFilename(size_t channel) const
     return fn;
 }
 
+QString DiskRenderSettings::makeVideoFilename() const
+{
+    QString fn = p_video_filename_;
+
+    // prepend directory
+
+    if (p_directory_.isEmpty())
+        return fn;
+
+    if (!(p_directory_.endsWith('/') || p_directory_.endsWith('\\')))
+        fn.prepend(QDir::separator());
+    fn.prepend(p_directory_);
+    return fn;
+}
 
 
 void DiskRenderSettings::setImageFormat(size_t index)
@@ -354,6 +404,16 @@ IO::CommandLineParser * DiskRenderSettings::createCommandLineParser() const
                         + " " + ifmtstr,
                         imageFormats()[imageFormatIndex()].id);
 
+    cl->addParameter("video_file", "vf, video-file",
+                        QObject::tr("Encodes the output into a single video file "
+                                    "instead of images, "
+                                    "the format is derived from the extension"),
+                        videoFilename());
+
+    cl->addParameter("video_codec", "vc, video-codec",
+                        QObject::tr("The ffmpeg name of the video codec"),
+                        videoCodec());
+
     return cl;
 }
 
@@ -364,6 +424,15 @@ void DiskRenderSettings::applyCommandLine(IO::CommandLineParser * cl)
 
     if (cl->contains("image_fmt"))
         setImageFormat(cl->value("image_fmt").toString());
+
+    if (cl->contains("video_file"))
+    {
+        p_video_filename_ = cl->value("video_file").toString();
+        p_video_enable_ = true;
+    }
+
+    if (cl->contains("video_codec"))
+        p_video_codec_ = cl->value("video_codec").toString();
 }
 
 } // namespace MO
@@ -104,6 +104,8 @@ public:
     size_t imageCompression() const { return p_image_comp_; }
     size_t imageNumThreads() const { return p_image_threads_; }
     size_t imageNumQue() const { return p_image_ques_; }
+    /** Number of pixel buffers for asynchronous readback of frames */
+    size_t imageNumReadback() const { return p_image_readback_; }
     size_t imageSizeBytes() const;
 
     /** Enable audio rendering */
@@ -123,6 +125,19 @@ public:
     QString audioFormatExt() const;
     size_t audioBitsPerChannel() const { return p_audio_bpc_; }
 
+    /** Enable direct encoding into a video file */
+    bool videoEnable() const { return p_video_enable_; }
+    /** The video filename, format is derived from the extension */
+    const QString& videoFilename() const { return p_video_filename_; }
+    /** ffmpeg name of the video codec */
+    const QString& videoCodec() const { return p_video_codec_; }
+    /** ffmpeg name of the audio codec */
+    const QString& videoAudioCodec() const { return p_video_audio_codec_; }
+    /** Video bitrate in kbit/s */
+    size_t videoBitrate() const { return p_video_bitrate_; }
+    /** Number of encoder threads, 0 for auto */
+    size_t videoNumThreads() const { return p_video_threads_; }
+
     /** Returns the filename for the frame number according to settings */
     QString makeImageFilename(size_t frame) const;
 
@@ -132,6 +147,9 @@ public:
     /** Returns the filename for the audio file according to settings */
     QString makeAudioFilename(size_t channel) const;
 
+    /** Returns the filename for the encoded video file */
+    QString makeVideoFilename() const;
+
     // ------------- setter --------------------
 
     void setDirectory(const QString& dir) { p_directory_ = dir; }
@@ -157,6 +175,7 @@ public:
     void setImageCompression(size_t c) { p_image_comp_ = c; }
     void setImageNumThreads(size_t t) { p_image_threads_ = t; }
     void setImageNumQue(size_t q) { p_image_ques_ = q; }
+    void setImageNumReadback(size_t r) { p_image_readback_ = r; }
 
     void setAudioEnable(bool e) { p_audio_enable_ = e; }
     void setAudioSplitEnable(bool e) { p_audio_split_enable_ = e; }
@@ -171,6 +190,13 @@ public:
     void setAudioPatternWidth(size_t w) { p_audio_num_width_ = w; }
     void setAudioBitsPerChannel(size_t b) { p_audio_bpc_ = b; }
 
+    void setVideoEnable(bool e) { p_video_enable_ = e; }
+    void setVideoFilename(const QString& fn) { p_video_filename_ = fn; }
+    void setVideoCodec(const QString& name) { p_video_codec_ = name; }
+    void setVideoAudioCodec(const QString& name) { p_video_audio_codec_ = name; }
+    void setVideoBitrate(size_t kbit) { p_video_bitrate_ = kbit; }
+    void setVideoNumThreads(size_t t) { p_video_threads_ = t; }
+
     // ------------ conversion ----------------
 
     SamplePos frame2sample(size_t frame) const
@@ -187,12 +213,16 @@ private:
 
     QString p_directory_,
             p_image_pattern_,
-            p_audio_pattern_;
+            p_audio_pattern_,
+            p_video_filename_,
+            p_video_codec_,
+            p_video_audio_codec_;
 
     bool    p_image_enable_,
             p_audio_enable_,
             p_audio_split_enable_,
-            p_audio_norm_enable_;
+            p_audio_norm_enable_,
+            p_video_enable_;
 
     AUDIO::Configuration
             p_audio_conf_;
@@ -212,10 +242,13 @@ private:
             p_image_comp_,
             p_image_threads_,
             p_image_ques_,
+            p_image_readback_,
             p_audio_format_idx_,
             p_audio_num_offset_,
             p_audio_num_width_,
-            p_audio_bpc_;
+            p_audio_bpc_,
+            p_video_bitrate_,
+            p_video_threads_;
 };
 
 } // namespace MO
@@ -86,6 +86,7 @@ QString Settings::infoString() const
 #if !defined(MO_DISABLE_CLIENT) || !defined(MO_DISABLE_SERVER)
         << "\ntcp comm.  : " << getValue("Network/tcpport").toString()
         << "\nudp comm.  : " << getValue("Network/udpport").toString()
+        << "\nfile trans.: " << getValue("Network/fileport").toString()
         << "\nudp-audio  : " << settings()->udpAudioMulticastAddress() << ":"
                              << settings()->udpAudioMulticastPort()
 #endif
@@ -152,6 +153,11 @@ void Settings::createDefaultValues_()
     defaultValues_["Audio/buffersize"] = 128;
     defaultValues_["Audio/channelsIn"] = 2;
     defaultValues_["Audio/channelsOut"] = 2;
+    // threads for parallel dsp processing (0 = all cores)
+    defaultValues_["Audio/dspThreads"] = 1;
+    // distance in samples of calculated object transformations
+    // (1 = every sample, larger values interpolate in between)
+    defaultValues_["Audio/transformDecimation"] = 1;
 
     defaultValues_["MidiIn/api"] = "";
     defaultValues_["MidiIn/device"] = "";
@@ -170,8 +176,10 @@ void Settings::createDefaultValues_()
     defaultValues_["Network/name"] = "";
     defaultValues_["Network/tcpport"] = 50000;
     defaultValues_["Network/udpport"] = 50001;
+    defaultValues_["Network/fileport"] = 50002;
     defaultValues_["Network/udpAudioMulticastAddress"] = "239.255.43.21";
     defaultValues_["Network/udpAudioMulticastPort"] = 50005;
+    defaultValues_["Network/udpAudioCompression"] = 0;
 
     defaultValues_["Client/index"] = 0;
     defaultValues_["Client/serverAddress"] = "192.168.1.33";
@@ -486,6 +494,16 @@ void Settings::setUdpAudioMulticastPort(uint16_t p)
     setValue("Network/udpAudioMulticastPort", p);
 }
 
+int Settings::udpAudioCompression() const
+{
+    return getValue("Network/udpAudioCompression").toInt();
+}
+
+void Settings::setUdpAudioCompression(int c)
+{
+    setValue("Network/udpAudioCompression", c);
+}
+
 int Settings::clientIndex() const
 {
     return getValue("Client/index").toInt();
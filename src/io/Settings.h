@@ -80,6 +80,9 @@ public:
     void setUdpAudioMulticastAddress(const QString&);
     uint16_t udpAudioMulticastPort() const;
     void setUdpAudioMulticastPort(uint16_t);
+    /** UdpAudioFrame::Compression of streamed audio */
+    int udpAudioCompression() const;
+    void setUdpAudioCompression(int);
 
     /** Returns the index of the client */
     int clientIndex() const;
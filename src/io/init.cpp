@@ -16,6 +16,7 @@
 #include "io/error.h"
 #include "io/memory.h"
 #include "types/Refcounted_info.h"
+#include "audio/tool/SoundFileStreamer.h"
 
 #ifdef Q_OS_LINUX
 #   include <X11/Xlib.h>
@@ -51,6 +52,8 @@ void startOfProgram()
 
 void endOfProgram()
 {
+    MO::AUDIO::SoundFileStreamer::shutDown();
+
 #ifdef MO_ENABLE_PYTHON34
     MO::PYTHON34::finalizePython();
 #endif
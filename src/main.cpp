@@ -64,6 +64,20 @@ int renderToDisk()
 //#include "tests/Testglwindow.h"
 #include "tests/TestFloatMatrix.h"
 //#include "tests/TestFft.h"
+//#include "tests/TestConvolver.h"
+//#include "tests/TestGeometryBvh.h"
+//#include "tests/TestObjLoader.h"
+//#include "tests/TestSynth.h"
+//#include "tests/TestSceneIndex.h"
+//#include "tests/TestUdpAudio.h"
+//#include "tests/TestSceneDelta.h"
+//#include "tests/TestFileTransfer.h"
+//#include "tests/TestFrustum.h"
+//#include "tests/TestSpatial.h"
+//#include "tests/TestSoundFileStreamer.h"
+//#include "tests/TestClockSync.h"
+//#include "tests/TestBlockModulation.h"
+//#include "tests/TestDspPath.h"
 //#include "math/arithmeticarray.h"
 
 //#include "types/vector.h"
@@ -87,6 +101,16 @@ int main(int argc, char *argv[])
     //TestGlWindow t; return t.run();
     //MO::TestFloatMatrix t; return t.run();
     //MO::TestFft t; return t.run();
+    //MO::TestConvolver t; return t.run();
+    //MO::TestGeometryBvh t; return t.run();
+    //MO::TestObjLoader t; return t.run();
+    //MO::TestSynth t; return t.run();
+    //MO::TestUdpAudio t; return t.run();
+    //MO::TestFileTransfer t; return t.run();
+    //MO::TestFrustum t; return t.run();
+    //MO::TestSpatial t; return t.run();
+    //MO::TestSoundFileStreamer t; return t.run();
+    //MO::TestClockSync t; return t.run();
 
 #if (0)
     using namespace MO;
@@ -160,6 +184,10 @@ int main(int argc, char *argv[])
         // tests with QApplication
         //{ MO::TestHelpSystem test; return test.run(); }
         //{ MO::TestCommandLineParser test; return test.run(argc, argv, 1); }
+        //{ MO::TestSceneIndex test; return test.run(); }
+        //{ MO::TestSceneDelta test; return test.run(); }
+        //{ MO::TestBlockModulation test; return test.run(); }
+        //{ MO::TestDspPath test; return test.run(); }
 
         // ------ start program ---------
 
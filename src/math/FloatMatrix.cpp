@@ -28,7 +28,7 @@ QJsonObject FloatMatrixT<F>::toJson() const
     // dimensions
     main.insert("dims", JSON::toArray(p_dims_));
     // data
-    main.insert("data", JSON::toArray(p_data_));
+    main.insert("data", JSON::toArray(Vector(begin(), end())));
 
     return main;
 }
@@ -50,7 +50,11 @@ void FloatMatrixT<F>::fromJson(const QJsonObject& main)
                     << sum << " data points, got " << data.size());
 
     setDimensions(dims);
-    p_data_ = data;
+    if (data.size() == p_size_)
+    {
+        p_data_ = std::make_shared<Vector>(std::move(data));
+        p_start_ = 0;
+    }
 }
 
 template <typename F>
@@ -67,17 +71,17 @@ std::string FloatMatrixT<F>::layoutString() const
     }
     s << ")";
     if (p_dims_.size() > 1)
-        s << "=" << p_data_.size();
+        s << "=" << p_size_;
     return s.str();
 }
 
 template <typename F>
 std::string FloatMatrixT<F>::rangeString() const
 {
-    if (p_data_.empty())
+    if (!p_size_)
         return "0";
-    F mi = p_data_.front(), ma = mi;
-    for (const auto& f : p_data_)
+    F mi = *begin(), ma = mi;
+    for (const auto& f : *this)
         mi = std::min(mi, f), ma = std::max(ma, f);
     std::stringstream s;
     s << mi << " - " << ma;
@@ -110,9 +114,11 @@ template <typename T>
 FloatMatrixT<T> FloatMatrixT<F>::toType() const
 {
     FloatMatrixT<T> m(dimensions());
-    m.p_data_.clear();
-    for (const auto& f : p_data_)
-        m.p_data_.push_back(f);
+    if (!p_size_)
+        return m;
+    T* dst = m.data();
+    for (const auto& f : *this)
+        *dst++ = T(f);
     return m;
 }
 
@@ -123,7 +129,8 @@ void FloatMatrixT<F>::setDimensions(const std::vector<size_t>& dimensions)
     p_offs_.clear();
     if (p_dims_.empty())
     {
-        p_data_.clear();
+        p_data_.reset();
+        p_start_ = p_size_ = 0;
         return;
     }
     // clamp size to 1
@@ -137,7 +144,71 @@ void FloatMatrixT<F>::setDimensions(const std::vector<size_t>& dimensions)
         num *= d;
         p_offs_.push_back(num);
     }
-    p_data_.resize(num);
+
+    if (num == p_size_)
+        return;
+
+    // resize in place if not shared
+    if (p_data_ && p_data_.use_count() == 1 && p_start_ == 0)
+    {
+        p_data_->resize(num);
+        p_size_ = num;
+        return;
+    }
+
+    // new storage, keeping the previous values
+    auto data = std::make_shared<Vector>(num);
+    if (p_data_)
+        std::copy(p_ptr_(), p_ptr_() + std::min(num, p_size_), data->begin());
+    p_data_ = data;
+    p_start_ = 0;
+    p_size_ = num;
+}
+
+template <typename F>
+void FloatMatrixT<F>::p_copyData_()
+{
+    p_data_ = std::make_shared<Vector>(p_ptr_(), p_ptr_() + p_size_);
+    p_start_ = 0;
+}
+
+template <typename F>
+FloatMatrixT<F> FloatMatrixT<F>::subRange(size_t first, size_t count) const
+{
+    MO_ASSERT(!isEmpty(), "subRange() on empty matrix");
+    MO_ASSERT_LT(first, size(0), layoutString());
+    count = std::max(size_t(1), std::min(count, size(0) - first));
+
+    // same layout with shorter first dimension
+    const size_t stride = p_size_ / size(0);
+    FloatMatrixT<F> m;
+    m.p_dims_ = p_dims_;
+    m.p_dims_[0] = count;
+    m.p_offs_.push_back(0);
+    size_t num = 1;
+    for (auto d : m.p_dims_)
+        m.p_offs_.push_back(num *= d);
+    m.p_data_ = p_data_;
+    m.p_start_ = p_start_ + first * stride;
+    m.p_size_ = count * stride;
+    return m;
+}
+
+template <typename F>
+FloatMatrixT<F> FloatMatrixT<F>::slice(size_t index) const
+{
+    FloatMatrixT<F> m = subRange(index, 1);
+    // remove first dimension
+    if (m.p_dims_.size() > 1)
+    {
+        m.p_dims_.erase(m.p_dims_.begin());
+        m.p_offs_.clear();
+        m.p_offs_.push_back(0);
+        size_t num = 1;
+        for (auto d : m.p_dims_)
+            m.p_offs_.push_back(num *= d);
+    }
+    return m;
 }
 
 template <typename F>
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 //#include "types/float.h"
 #include "io/error_index.h"
@@ -25,11 +26,16 @@ class ProgressInfo;
 
 /** @brief Multi-dimensional float data container
 
-    @todo
-    Currently this is passed around by value between objects
-    to make it threadsafe. Not ideal, but a copy-on-write would
-    require lot's of lockings...
+    The data is reference-counted and copied on write,
+    so passing a matrix around by value does not copy the data.
+    Producers can hand out their matrix as an immutable snapshot,
+    the next write access of the producer copies the data if the snapshot
+    is still in use.
 
+    A FloatMatrixT must not be modified from two threads at the same time,
+    but copies of it can be used in other threads freely.
+
+    slice() and subRange() return views that share the data as well.
 */
 template <typename F>
 class FloatMatrixT
@@ -38,8 +44,9 @@ class FloatMatrixT
 public:
     typedef std::vector<F> Vector;
 
-    FloatMatrixT() { }
+    FloatMatrixT() : p_start_(0), p_size_(0) { }
     explicit FloatMatrixT(const std::vector<size_t>& dimensions)
+        : p_start_(0), p_size_(0)
         { setDimensions(dimensions); }
 
     // ---- io ----
@@ -63,7 +70,7 @@ public:
     /** Number of dimensions */
     size_t numDimensions() const { return p_dims_.size(); }
     /** Size of all data */
-    size_t size() const { return p_data_.size(); }
+    size_t size() const { return p_size_; }
     /** Size of one dimension */
     size_t size(size_t dimension) const
         { MO_ASSERT(dimension < p_dims_.size(),
@@ -78,6 +85,25 @@ public:
     FloatMatrixT<F> transposedXY() const;
     FloatMatrixT<F> rotatedRight() const;
 
+    /** Returns entry @p index of the first dimension
+        as a matrix with one dimension less. Shares the data. */
+    FloatMatrixT<F> slice(size_t index) const;
+
+    /** Returns @p count entries of the first dimension,
+        starting at @p first. Shares the data. */
+    FloatMatrixT<F> subRange(size_t first, size_t count) const;
+
+    /** Returns true if both matrices refer to the same shared data
+        and layout, which means they are equal without comparing values. */
+    bool isSameData(const FloatMatrixT<F>& o) const
+    {
+        return p_data_ == o.p_data_ && p_start_ == o.p_start_
+            && p_size_ == o.p_size_ && p_dims_ == o.p_dims_;
+    }
+
+    /** Number of matrices and views sharing the data */
+    long useCount() const { return p_data_.use_count(); }
+
     // --- read access ---
 
     /** Convert to matrix of different type */
@@ -87,14 +113,14 @@ public:
 
     size_t offset(size_t x) const
     {
-        MO_ASSERT(!p_data_.empty(), "");
-        MO_ASSERT_LT(x, p_data_.size(), layoutString());
+        MO_ASSERT(p_size_, "");
+        MO_ASSERT_LT(x, p_size_, layoutString());
         return x;
     }
 
     size_t offset(size_t y, size_t x) const
     {
-        MO_ASSERT(!p_data_.empty(), "");
+        MO_ASSERT(p_size_, "");
         MO_ASSERT_EQUAL(p_dims_.size(), size_t(2), layoutString());
         MO_ASSERT_LT(x, p_dims_[1], layoutString());
         MO_ASSERT_LT(y, p_dims_[0], layoutString());
@@ -103,7 +129,7 @@ public:
 
     size_t offset(size_t z, size_t y, size_t x) const
     {
-        MO_ASSERT(!p_data_.empty(), "");
+        MO_ASSERT(p_size_, "");
         MO_ASSERT_EQUAL(p_dims_.size(), size_t(3), layoutString());
         MO_ASSERT_LT(x, p_dims_[2], layoutString());
         MO_ASSERT_LT(y, p_dims_[1], layoutString());
@@ -113,7 +139,7 @@ public:
 
     size_t offset(size_t w, size_t z, size_t y, size_t x) const
     {
-        MO_ASSERT(!p_data_.empty(), "");
+        MO_ASSERT(p_size_, "");
         MO_ASSERT_EQUAL(p_dims_.size(), size_t(4), layoutString());
         MO_ASSERT_LT(x, p_dims_[3], layoutString());
         MO_ASSERT_LT(y, p_dims_[2], layoutString());
@@ -124,46 +150,48 @@ public:
 
     /** Read access to all data */
     const F* data() const
-        { MO_ASSERT(!p_data_.empty(), "");
-          return &p_data_[0]; }
+        { MO_ASSERT(p_size_, "");
+          return p_ptr_(); }
 
     const F* data(size_t x) const
-        { return &p_data_[offset(x)]; }
+        { return p_ptr_() + offset(x); }
 
     const F* data(size_t y, size_t x) const
-        { return &p_data_[offset(y, x)]; }
+        { return p_ptr_() + offset(y, x); }
 
     const F* data(size_t z, size_t y, size_t x) const
-        { return &p_data_[offset(z, y, x)]; }
+        { return p_ptr_() + offset(z, y, x); }
 
     const F* data(size_t w, size_t z, size_t y, size_t x) const
-        { return &p_data_[offset(w, z, y, x)]; }
+        { return p_ptr_() + offset(w, z, y, x); }
 
     /** Read single values */
     const F& operator()(size_t x) const
-        { return p_data_[offset(x)]; }
+        { return p_ptr_()[offset(x)]; }
 
     const F& operator()(size_t y, size_t x) const
-        { return p_data_[offset(y, x)]; }
+        { return p_ptr_()[offset(y, x)]; }
 
     const F& operator()(size_t z, size_t y, size_t x) const
-        { return p_data_[offset(z, y, x)]; }
+        { return p_ptr_()[offset(z, y, x)]; }
 
     const F& operator()(size_t w, size_t z, size_t y, size_t x) const
-        { return p_data_[offset(w, z, y, x)]; }
+        { return p_ptr_()[offset(w, z, y, x)]; }
 
     // --- std container ---
 
-    typename Vector::const_iterator begin() const { return p_data_.begin(); }
-    typename Vector::const_iterator end() const { return p_data_.end(); }
-    typename Vector::iterator begin() { return p_data_.begin(); }
-    typename Vector::iterator end() { return p_data_.end(); }
+    const F* begin() const { return p_ptr_(); }
+    const F* end() const { return p_ptr_() + p_size_; }
+    F* begin() { return p_wptr_(); }
+    F* end() { return p_wptr_() + p_size_; }
 
     // --- compare ---
 
     bool operator == (const FloatMatrixT<F>& o) const { return !(*this != o); }
     bool operator != (const FloatMatrixT<F>& o) const
     {
+        if (isSameData(o))
+            return false;
         if (o.numDimensions() != numDimensions())
             return true;
         for (size_t i=0; i<numDimensions(); ++i)
@@ -192,39 +220,44 @@ public:
     void clear()
     {
         p_dims_.clear();
-        p_data_.clear();
+        p_data_.reset();
+        p_start_ = p_size_ = 0;
         p_offs_.clear();
     }
 
+    /** Makes sure the data is not shared with other matrices.
+        Called implicitly by all write-access functions. */
+    void detach() { if (p_data_ && p_data_.use_count() > 1) p_copyData_(); }
+
     /** Write access to all data */
     F* data()
-        { MO_ASSERT(!p_data_.empty(), "");
-          return &p_data_[0]; }
+        { MO_ASSERT(p_size_, "");
+          return p_wptr_(); }
 
     F* data(size_t x)
-        { return &p_data_[offset(x)]; }
+        { return p_wptr_() + offset(x); }
 
     F* data(size_t y, size_t x)
-        { return &p_data_[offset(y, x)]; }
+        { return p_wptr_() + offset(y, x); }
 
     F* data(size_t z, size_t y, size_t x)
-        { return &p_data_[offset(z, y, x)]; }
+        { return p_wptr_() + offset(z, y, x); }
 
     F* data(size_t w, size_t z, size_t y, size_t x)
-        { return &p_data_[offset(w, z, y, x)]; }
+        { return p_wptr_() + offset(w, z, y, x); }
 
     /** Write access to single values */
     F& operator()(size_t x)
-        { return p_data_[offset(x)]; }
+        { return p_wptr_()[offset(x)]; }
 
     F& operator()(size_t y, size_t x)
-        { return p_data_[offset(y, x)]; }
+        { return p_wptr_()[offset(y, x)]; }
 
     F& operator()(size_t z, size_t y, size_t x)
-        { return p_data_[offset(z, y, x)]; }
+        { return p_wptr_()[offset(z, y, x)]; }
 
     F& operator()(size_t w, size_t z, size_t y, size_t x)
-        { return p_data_[offset(w, z, y, x)]; }
+        { return p_wptr_()[offset(w, z, y, x)]; }
 
     // ----- signed distance field -----
 
@@ -264,14 +297,24 @@ public:
             dims.push_back(s);
         }
         m.setDimensions(dims);
+        F* data = m.size() ? m.data() : nullptr;
         for (size_t i=0; i<m.size(); ++i)
-            io >> m.data()[i];
+            io >> data[i];
 
         return io;
     }
 private:
 
-    Vector p_data_;
+    const F* p_ptr_() const { return p_data_ ? p_data_->data() + p_start_ : nullptr; }
+    F* p_wptr_() { detach(); return p_data_ ? p_data_->data() + p_start_ : nullptr; }
+
+    /** Replaces the shared data with a copy of this matrix' range */
+    void p_copyData_();
+
+    /** Shared storage, possibly larger than this matrix for views */
+    std::shared_ptr<Vector> p_data_;
+    /** Range of this matrix in p_data_ */
+    size_t p_start_, p_size_;
     std::vector<size_t> p_dims_, p_offs_;
 };
 
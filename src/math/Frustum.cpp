@@ -0,0 +1,101 @@
+/** @file frustum.cpp
+
+    @brief View frustum planes for visibility tests
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <cmath>
+
+#include "Frustum.h"
+
+namespace MO {
+namespace MATH {
+
+Frustum::Frustum()
+{
+    // accepts everything
+    for (int i=0; i<6; ++i)
+        planes_[i] = Vec4(0, 0, 0, 1);
+}
+
+Frustum::Frustum(const Mat4 &projectionView)
+{
+    set(projectionView);
+}
+
+void Frustum::set(const Mat4 &m)
+{
+    // rows of the column-major matrix
+    Vec4 row[4];
+    for (int i=0; i<4; ++i)
+        row[i] = Vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    planes_[P_LEFT] =   row[3] + row[0];
+    planes_[P_RIGHT] =  row[3] - row[0];
+    planes_[P_BOTTOM] = row[3] + row[1];
+    planes_[P_TOP] =    row[3] - row[1];
+    planes_[P_NEAR] =   row[3] + row[2];
+    planes_[P_FAR] =    row[3] - row[2];
+
+    for (auto & p : planes_)
+    {
+        const Float len = glm::length(Vec3(p));
+        if (len > 0)
+            p /= len;
+    }
+}
+
+bool Frustum::contains(const Vec3 &v) const
+{
+    for (const auto & p : planes_)
+        if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0)
+            return false;
+    return true;
+}
+
+bool Frustum::intersectsSphere(const Vec3 &c, Float radius) const
+{
+    for (const auto & p : planes_)
+        if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -radius)
+            return false;
+    return true;
+}
+
+bool Frustum::intersectsBox(const Vec3 &mi, const Vec3 &ma) const
+{
+    for (const auto & p : planes_)
+    {
+        // corner farthest along the plane normal
+        const Vec3 v(p.x >= 0 ? ma.x : mi.x,
+                     p.y >= 0 ? ma.y : mi.y,
+                     p.z >= 0 ? ma.z : mi.z);
+        if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0)
+            return false;
+    }
+    return true;
+}
+
+void transform_box(const Mat4 &m, const Vec3 &mi, const Vec3 &ma,
+                   Vec3 *newMin, Vec3 *newMax)
+{
+    const Vec3 center = (mi + ma) * Float(0.5),
+               extent = (ma - mi) * Float(0.5);
+
+    Vec3 c(m[3]), e(0);
+    for (int j=0; j<3; ++j)
+    for (int i=0; i<3; ++i)
+    {
+        c[i] += m[j][i] * center[j];
+        e[i] += std::abs(m[j][i]) * extent[j];
+    }
+
+    *newMin = c - e;
+    *newMax = c + e;
+}
+
+} // namespace MATH
+} // namespace MO
@@ -0,0 +1,75 @@
+/** @file frustum.h
+
+    @brief View frustum planes for visibility tests
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_MATH_FRUSTUM_H
+#define MOSRC_MATH_FRUSTUM_H
+
+#include "types/vector.h"
+
+namespace MO {
+namespace MATH {
+
+/** The six planes of a view frustum.
+
+    The planes are extracted from a projection * view matrix,
+    so the tests happen in the space that the view matrix
+    transforms from, usually world space.
+    Each plane is stored as (normal, distance) with the
+    normal pointing inside.
+
+    The tests are conservative. Volumes that are close to an
+    edge of the frustum might be reported as intersecting
+    although they are outside.
+    */
+class Frustum
+{
+public:
+
+    enum Plane
+    {
+        P_LEFT, P_RIGHT, P_BOTTOM, P_TOP, P_NEAR, P_FAR
+    };
+
+    Frustum();
+    /** Extracts the planes from a projection * view matrix */
+    explicit Frustum(const Mat4& projectionView);
+
+    // ------------ getter -------------
+
+    const Vec4& plane(Plane p) const { return planes_[p]; }
+
+    /** Returns true if the axis-aligned box is at least partially inside */
+    bool intersectsBox(const Vec3& minimum, const Vec3& maximum) const;
+
+    /** Returns true if the sphere is at least partially inside */
+    bool intersectsSphere(const Vec3& center, Float radius) const;
+
+    /** Returns true if the point is inside */
+    bool contains(const Vec3& point) const;
+
+    // ------------ setter -------------
+
+    /** Extracts the planes from a projection * view matrix */
+    void set(const Mat4& projectionView);
+
+private:
+
+    Vec4 planes_[6];
+};
+
+/** Returns the world-space axis-aligned box containing
+    the box @p minimum, @p maximum transformed by @p trans */
+void transform_box(const Mat4& trans, const Vec3& minimum, const Vec3& maximum,
+                   Vec3 * newMinimum, Vec3 * newMaximum);
+
+} // namespace MATH
+} // namespace MO
+
+#endif // MOSRC_MATH_FRUSTUM_H
@@ -0,0 +1,249 @@
+/** @file minmaxpyramid.h
+
+    @brief Multi-resolution min/max cache for range queries
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_MATH_MINMAXPYRAMID_H
+#define MOSRC_MATH_MINMAXPYRAMID_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace MO {
+namespace MATH {
+
+/** Cache of minimum and maximum values over a sequence of values,
+    for exact range queries in O(blockSize + log n).
+
+    The pyramid does not store the values itself. Each function takes
+    a functor @p F with the signature <tt>T(size_t index)</tt> that
+    returns the value at a given index.
+
+    Level 0 holds min/max of each full block of blockSize() values,
+    each following level holds min/max of two entries of the level below.
+    Values after the last full block are read through the functor on demand.
+
+    @code
+    std::vector<float> data = ...;
+    auto get = [&](size_t i) { return data[i]; };
+
+    MinMaxPyramid<float> pyr;
+    pyr.build(data.size(), get);
+
+    float mi, ma;
+    pyr.getMinMax(100, 2000, get, mi, ma);
+
+    // after data[i] = x;
+    pyr.update(i, i, get);
+    // after data.push_back(x);
+    pyr.append(data.size(), get);
+    @endcode
+    */
+template <typename T>
+class MinMaxPyramid
+{
+public:
+
+    explicit MinMaxPyramid(size_t blockSize = 64)
+        : p_blockSize_  (std::max(size_t(1), blockSize))
+        , p_size_       (0)
+    { }
+
+    // ----------- getter -------------
+
+    /** Number of values in the cache */
+    size_t size() const { return p_size_; }
+
+    bool isEmpty() const { return p_size_ == 0; }
+
+    size_t blockSize() const { return p_blockSize_; }
+
+    /** Number of levels in the pyramid */
+    size_t numLevels() const { return p_levels_.size(); }
+
+    // ----------- setter -------------
+
+    /** Forgets all values */
+    void clear() { p_size_ = 0; p_levels_.clear(); }
+
+    /** Builds the whole pyramid for @p num values */
+    template <class F>
+    void build(size_t num, F value)
+    {
+        clear();
+        append(num, value);
+    }
+
+    /** Extends the pyramid to @p num values, where all values
+        below the previous size() are unchanged.
+        Only the newly completed blocks and their parents are calculated.
+        If @p num is smaller than size(), the pyramid is shrunk. */
+    template <class F>
+    void append(size_t num, F value)
+    {
+        const size_t
+                oldBlocks = p_size_ / p_blockSize_,
+                newBlocks = num / p_blockSize_;
+        p_size_ = num;
+        if (newBlocks < oldBlocks)
+        {
+            p_resize_(newBlocks);
+            return;
+        }
+        if (newBlocks == oldBlocks)
+            return;
+        p_resize_(newBlocks);
+        p_updateBlocks_(oldBlocks, newBlocks - 1, value);
+    }
+
+    /** Recalculates the values from index @p first to @p last (inclusive),
+        after they have been changed. */
+    template <class F>
+    void update(size_t first, size_t last, F value)
+    {
+        if (p_levels_.empty() || first > last)
+            return;
+        const size_t
+                numBlocks = p_levels_[0].size(),
+                b0 = first / p_blockSize_;
+        if (b0 >= numBlocks)
+            return;
+        const size_t b1 = std::min(numBlocks - 1, last / p_blockSize_);
+        p_updateBlocks_(b0, b1, value);
+    }
+
+    // ----------- query --------------
+
+    /** Returns the minimum and maximum of all values
+        from @p first to @p last (inclusive).
+        @p last is clamped to size() - 1.
+        Returns false and leaves @p minimal and @p maximal untouched
+        if the range is empty. */
+    template <class F>
+    bool getMinMax(size_t first, size_t last, F value, T& minimal, T& maximal) const
+    {
+        if (p_size_ == 0)
+            return false;
+        last = std::min(last, p_size_ - 1);
+        if (first > last)
+            return false;
+
+        // range of full blocks
+        const size_t
+                b0 = (first + p_blockSize_ - 1) / p_blockSize_,
+                b1 = (last + 1) / p_blockSize_;
+
+        // less than one full block
+        if (b0 >= b1)
+        {
+            minimal = maximal = value(first);
+            p_scan_(first + 1, last + 1, value, minimal, maximal);
+            return true;
+        }
+
+        // block range
+        size_t lo = b0, hi = b1 - 1;
+        minimal = p_levels_[0][lo].mi;
+        maximal = p_levels_[0][lo].ma;
+        for (size_t l = 0; l < p_levels_.size() && lo <= hi; ++l)
+        {
+            const auto& level = p_levels_[l];
+            if (lo & 1)
+                p_combine_(level[lo++], minimal, maximal);
+            if (lo > hi)
+                break;
+            if (!(hi & 1))
+            {
+                p_combine_(level[hi], minimal, maximal);
+                if (hi == 0)
+                    break;
+                --hi;
+            }
+            if (lo > hi)
+                break;
+            lo >>= 1;
+            hi >>= 1;
+        }
+
+        // raw values at the edges
+        p_scan_(first, b0 * p_blockSize_, value, minimal, maximal);
+        p_scan_(b1 * p_blockSize_, last + 1, value, minimal, maximal);
+        return true;
+    }
+
+private:
+
+    struct Entry { T mi, ma; };
+
+    static void p_combine_(const Entry& e, T& mi, T& ma)
+    {
+        mi = std::min(mi, e.mi);
+        ma = std::max(ma, e.ma);
+    }
+
+    template <class F>
+    static void p_scan_(size_t from, size_t to, F& value, T& mi, T& ma)
+    {
+        for (size_t i = from; i < to; ++i)
+        {
+            const T v = value(i);
+            mi = std::min(mi, v);
+            ma = std::max(ma, v);
+        }
+    }
+
+    /** Sets the number of full blocks and sizes all levels accordingly */
+    void p_resize_(size_t numBlocks)
+    {
+        size_t num = numBlocks, l = 0;
+        for (; num > 0; num >>= 1, ++l)
+        {
+            if (l >= p_levels_.size())
+                p_levels_.resize(l + 1);
+            p_levels_[l].resize(num);
+        }
+        p_levels_.resize(l);
+    }
+
+    /** Recalculates blocks @p b0 to @p b1 (inclusive) and all parents */
+    template <class F>
+    void p_updateBlocks_(size_t b0, size_t b1, F& value)
+    {
+        auto& blocks = p_levels_[0];
+        for (size_t b = b0; b <= b1; ++b)
+        {
+            const size_t s = b * p_blockSize_;
+            Entry& e = blocks[b];
+            e.mi = e.ma = value(s);
+            p_scan_(s + 1, s + p_blockSize_, value, e.mi, e.ma);
+        }
+
+        for (size_t l = 1; l < p_levels_.size(); ++l)
+        {
+            const auto& below = p_levels_[l - 1];
+            auto& level = p_levels_[l];
+            b0 >>= 1;
+            b1 = std::min(b1 >> 1, level.size() - 1);
+            for (size_t i = b0; i <= b1; ++i)
+            {
+                Entry& e = level[i];
+                e = below[i * 2];
+                p_combine_(below[i * 2 + 1], e.mi, e.ma);
+            }
+        }
+    }
+
+    size_t p_blockSize_, p_size_;
+    std::vector<std::vector<Entry>> p_levels_;
+};
+
+} // namespace MATH
+} // namespace MO
+
+#endif // MOSRC_MATH_MINMAXPYRAMID_H
@@ -9,12 +9,14 @@
 */
 
 #include <cmath> // for fabs()
+#include <algorithm>
 
 #include <QFile>
 
 #include "io/DataStream.h"
 #include "io/error.h"
 #include "math/Timeline1d.h"
+#include "math/Timeline1dCompiled.h"
 #include "math/interpol.h"
 
 namespace MO {
@@ -23,6 +25,9 @@ namespace MATH {
 
 Timeline1d::Timeline1d()
     : RefCounted("Timeline1d")
+    , cacheDirty_   (true)
+    , cachePyramid_ (16)
+    , revision_     (0)
 {
     // no current point
     cur_ = 0;
@@ -45,7 +50,10 @@ Timeline1d::Timeline1d(const Timeline1d &other)
         lowerLimit_(other.lowerLimit_),
         upperLimit_(other.upperLimit_),
         lmin_   (other.lmin_),
-        lmax_   (other.lmax_)
+        lmax_   (other.lmax_),
+        cacheDirty_ (true),
+        cachePyramid_(16),
+        revision_   (0)
 {
 
 }
@@ -58,6 +66,7 @@ const Timeline1d& Timeline1d::operator = (const Timeline1d& other)
     upperLimit_ = other.upperLimit_;
     lmin_ = other.lmin_;
     lmax_ = other.lmax_;
+    setChanged();
 
     return *this;
 }
@@ -386,6 +395,7 @@ Double Timeline1d::derivative(Double time, Double h) const
 void Timeline1d::clear()
 {
     data_.clear();
+    setChanged();
 }
 
 void Timeline1d::addTimeline(const Timeline1d& tl, Double timeOffset)
@@ -432,6 +442,7 @@ Timeline1d::Point* Timeline1d::add(Double time, Double value, TimelinePoint::Typ
     // insert as element
     cur_ = &data_[hash(time)];
     *cur_ = p;
+    setChanged();
 
     // automatically set the derivative
     if (p.isAutoDerivative())
@@ -485,6 +496,7 @@ void Timeline1d::remove(Double time)
     if (cur_==&i->second) cur_ = 0;
 
     data_.erase(i);
+    setChanged();
 }
 
 void Timeline1d::remove(TpHash hash)
@@ -497,6 +509,7 @@ void Timeline1d::remove(TpHash hash)
     if (cur_==&i->second) cur_ = 0;
 
     data_.erase(i);
+    setChanged();
 }
 
 void Timeline1d::remove(Double start, Double end)
@@ -513,6 +526,7 @@ void Timeline1d::remove(Double start, Double end)
         --e;
 
     data_.erase(s, e);
+    setChanged();
 }
 
 
@@ -549,6 +563,7 @@ void Timeline1d::setAutoDerivative(TpList::iterator &i)
     }
 
     i->second.d1 = (v1-v0)/(t1-t0);
+    setChanged();
 
     //qDebug() << "der" << v0 << v1 << i->second.t << i->second.d1;
 }
@@ -640,6 +655,7 @@ void Timeline1d::deserialize(IO::DataStream & stream)
         cur_ = &data_[hash(p.t)];
         *cur_ = p;
     }
+    setChanged();
 }
 
 
@@ -700,6 +716,7 @@ void Timeline1d::normalize(Double amp)
     {
         i->second.val = i->second.val / ma * amp;
     }
+    setChanged();
 }
 
 
@@ -726,40 +743,110 @@ Timeline1d::TpList::iterator Timeline1d::closest(Double t)
 }
 
 
-void Timeline1d::getMinMax(Double tStart, Double tEnd, Double& minimal, Double& maximal)
+void Timeline1d::setChanged()
 {
-    auto i = closest(tStart);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        cacheDirty_ = true;
+    }
+    ++revision_;
+}
+
+void Timeline1d::updateCache_() const
+{
+    if (!cacheDirty_)
+        return;
+
+    const size_t num = data_.size(),
+                 oldNum = std::min(cacheValues_.size(), cachePyramid_.size());
+
+    cacheTimes_.resize(num);
+    cacheValues_.resize(num);
 
+    // copy and remember the range of changed values
+    size_t k = 0, first = num, last = 0;
+    for (const auto& i : data_)
+    {
+        if (k >= oldNum || cacheValues_[k] != i.second.val)
+        {
+            first = std::min(first, k);
+            last = k;
+        }
+        cacheTimes_[k] = i.second.t;
+        cacheValues_[k] = i.second.val;
+        ++k;
+    }
+
+    const auto& values = cacheValues_;
+    auto get = [&](size_t i) { return values[i]; };
+
+    // new or removed blocks at the end
+    cachePyramid_.append(num, get);
+    // changed blocks within the previous size
+    if (first < oldNum)
+        cachePyramid_.update(first, std::min(last, oldNum - 1), get);
+
+    cacheDirty_ = false;
+}
+
+std::shared_ptr<const Timeline1dCompiled> Timeline1d::compiled() const
+{
+    auto c = std::atomic_load(&compiled_);
+    if (c && c->revision() == revision_)
+        return c;
+
+    std::lock_guard<std::mutex> lock(compiledMutex_);
+
+    // another thread might have compiled it meanwhile
+    c = std::atomic_load(&compiled_);
+    if (c && c->revision() == revision_)
+        return c;
+
+    c = std::make_shared<const Timeline1dCompiled>(*this);
+    std::atomic_store(&compiled_, c);
+    return c;
+}
+
+void Timeline1d::getMinMax(Double tStart, Double tEnd, Double& minimal, Double& maximal) const
+{
     // break early
-    if (i == data_.end())
+    if (data_.empty())
     {
         minimal = maximal = 0.0;
         return;
     }
 
-    minimal = maximal = limit_(i->second.val);
+    if (tEnd < tStart)
+        std::swap(tStart, tEnd);
 
-    auto last = closest(tEnd);
+    // curve at the edges of the range
+    minimal = maximal = get(tStart);
+    const Double v = get(tEnd);
+    minimal = std::min(minimal, v);
+    maximal = std::max(maximal, v);
 
-    // XXX may need some finetuning
-    if (last == data_.end())
-        return;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
 
-    if (i->second.t >= last->second.t)
-        return;
+    updateCache_();
 
-    // check each point
-    while (i != last)
-    {
-        ++i;
-        if (i == data_.end()) // safety
-            return;
+    // index range of points within [tStart, tEnd]
+    const size_t
+        first = std::lower_bound(cacheTimes_.begin(), cacheTimes_.end(), tStart)
+                    - cacheTimes_.begin(),
+        last = std::upper_bound(cacheTimes_.begin(), cacheTimes_.end(), tEnd)
+                    - cacheTimes_.begin();
+    if (first >= last)
+        return;
 
-        const Double v = limit_(i->second.val);
-        minimal = std::min(minimal, v);
-        maximal = std::max(maximal, v);
-    }
+    const auto& values = cacheValues_;
+    Double mi, ma;
+    if (!cachePyramid_.getMinMax(first, last - 1,
+                                 [&](size_t i) { return values[i]; }, mi, ma))
+        return;
 
+    // limits are monotonic
+    minimal = std::min(minimal, limit_(mi));
+    maximal = std::max(maximal, limit_(ma));
 }
 
 } // namespace MATH
@@ -14,17 +14,23 @@
 #include <list>
 #include <map>
 #include <vector>
+#include <mutex>
+#include <memory>
+#include <atomic>
 
 #include <QString>
 
 #include "types/float.h"
 #include "types/Refcounted.h"
 #include "TimelinePoint.h"
+#include "MinMaxPyramid.h"
 
 namespace MO {
 namespace IO { class DataStream; }
 namespace MATH {
 
+class Timeline1dCompiled;
+
 /**	a super-duper timeline component mapping seconds to values.
 
     <p>currently the hash value for the time component of a point is <b>(long int)(time * 4096)</b>.
@@ -118,6 +124,15 @@ public:
     /** Returns wheter the timeline has no points */
     bool empty() const { return data_.empty(); }
 
+    /** Counter that is increased on every change, see setChanged() */
+    uint64_t revision() const { return revision_; }
+
+    /** Returns a contiguous snapshot for fast evaluation.
+        The snapshot is recompiled on the first call after a change.
+        The returned object stays valid while the pointer is held,
+        even if the timeline changes meanwhile. Thread-safe. */
+    std::shared_ptr<const Timeline1dCompiled> compiled() const;
+
     /** get value at time (with limits) */
     Double get(Double time) const;
 
@@ -143,8 +158,10 @@ public:
         else return data_.rbegin()->second.t;
     }
 
-    /** return the reference on the data point structure */
-    TpList &getData() { return data_; }
+    /** return the reference on the data point structure.
+        The non-const version assumes that the points will be changed
+        and invalidates the min/max cache. */
+    TpList &getData() { setChanged(); return data_; }
     const TpList &getData() const { return data_; }
 
     /** returns the TpList::iterator for a point at time 't',
@@ -191,12 +208,21 @@ public:
     TpList::iterator closest(Double t);
 
     /** Returns the smallest and greatest values found within the given time range.
-        Any limit is applied. Only the que points are considered, any curve
-        exceeding the points is not considered. */
-    void getMinMax(Double tStart, Double tEnd, Double& minimal, Double& maximal);
+        Any limit is applied. The que points inside the range and the curve
+        values at @p tStart and @p tEnd are considered, any curve
+        exceeding the points is not considered.
+        The point values are cached in a MinMaxPyramid, so after the first
+        call, the query is O(log n). After changes, only the parts of the
+        pyramid that cover changed points are recalculated. */
+    void getMinMax(Double tStart, Double tEnd, Double& minimal, Double& maximal) const;
 
     // ---------- modify -------------
 
+    /** Invalidates the min/max cache and the compiled() snapshot.
+        Call this after changing points through a pointer or iterator
+        that was obtained before the last call to getMinMax() or compiled(). */
+    void setChanged();
+
     /** remove all points */
     void clear();
 
@@ -238,6 +264,7 @@ public:
     {
         lmin_ = lmin;
         lowerLimit_ = true;
+        setChanged();
     }
 
     /** set an upper limit for the output */
@@ -245,12 +272,18 @@ public:
     {
         lmax_ = lmax;
         upperLimit_ = true;
+        setChanged();
     }
 
     /** enable or disable lower limit */
-    void enableLowerLimit(bool doLimit) { lowerLimit_ = doLimit; }
+    void enableLowerLimit(bool doLimit) { lowerLimit_ = doLimit; setChanged(); }
     /** enable or disable upper limit */
-    void enableUpperLimit(bool doLimit) { upperLimit_ = doLimit; }
+    void enableUpperLimit(bool doLimit) { upperLimit_ = doLimit; setChanged(); }
+
+    bool hasLowerLimit() const { return lowerLimit_; }
+    bool hasUpperLimit() const { return upperLimit_; }
+    Double lowerLimit() const { return lmin_; }
+    Double upperLimit() const { return lmax_; }
 
     /** automatically set the derivative for point 'i' */
     void setAutoDerivative(TpList::iterator &i);
@@ -299,6 +332,25 @@ public:
     /** the upper limit for output */
         lmax_;
 
+    // ---- min/max cache ----
+
+    /** Guards the cache and the dirty flag */
+    mutable std::mutex cacheMutex_;
+    mutable bool cacheDirty_;
+    /** time and value of each point, in order */
+    mutable std::vector<Double> cacheTimes_, cacheValues_;
+    mutable MinMaxPyramid<Double> cachePyramid_;
+
+    /** Updates the cache if dirty, call with cacheMutex_ locked */
+    void updateCache_() const;
+
+    // ---- compiled snapshot ----
+
+    std::atomic<uint64_t> revision_;
+    mutable std::mutex compiledMutex_;
+    /** accessed with std::atomic_load/store */
+    mutable std::shared_ptr<const Timeline1dCompiled> compiled_;
+
     // ------------------- private functions -----------------------
 
     /** type of point at this location, or default. */
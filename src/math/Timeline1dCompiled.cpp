@@ -0,0 +1,249 @@
+/** @file timeline1dcompiled.cpp
+
+    @brief Contiguous read-only snapshot of a Timeline1d
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include "Timeline1dCompiled.h"
+
+namespace MO {
+namespace MATH {
+
+
+Timeline1dCompiled::Timeline1dCompiled()
+    : p_revision_       (0)
+    , p_lowerLimit_     (false)
+    , p_upperLimit_     (false)
+    , p_lmin_           (0.)
+    , p_lmax_           (0.)
+{
+}
+
+Timeline1dCompiled::Timeline1dCompiled(const Timeline1d& tl)
+    : Timeline1dCompiled()
+{
+    compile(tl);
+}
+
+void Timeline1dCompiled::compile(const Timeline1d& tl)
+{
+    p_revision_ = tl.revision();
+    p_lowerLimit_ = tl.hasLowerLimit();
+    p_upperLimit_ = tl.hasUpperLimit();
+    p_lmin_ = tl.lowerLimit();
+    p_lmax_ = tl.upperLimit();
+
+    // copy points
+    std::vector<const Timeline1d::Point*> pts;
+    pts.reserve(tl.size());
+    p_hashes_.clear();
+    p_hashes_.reserve(tl.size());
+    for (const auto& i : tl.getData())
+    {
+        p_hashes_.push_back(i.first);
+        pts.push_back(&i.second);
+    }
+
+    p_segments_.clear();
+    const size_t num = pts.size();
+    if (num == 0)
+        return;
+    p_segments_.resize(num + 1);
+
+    // before first and after last point
+    for (size_t k = 0; k < 2; ++k)
+    {
+        const Timeline1d::Point& p = *pts[k ? num - 1 : 0];
+        Segment& s = p_segments_[k ? num : 0];
+        for (auto& c : s.c)
+            c = 0.;
+        s.t = p.t;
+        s.scale = 1.;
+        s.c[0] = p.val;
+        if (p.type == TimelinePoint::CONSTANT_USER
+         || p.type == TimelinePoint::SYMMETRIC_USER)
+            s.c[1] = p.d1;
+    }
+
+    // see Timeline1d::getNoLimit() for the original formulas
+    for (size_t i = 0; i + 1 < num; ++i)
+    {
+        const Timeline1d::Point
+                &p1 = *pts[i],
+                &p2 = *pts[i + 1];
+        const Double
+                dt = p2.t - p1.t,
+                v1 = p1.val,
+                v2 = p2.val;
+
+        Segment& s = p_segments_[i + 1];
+        s.t = p1.t;
+        s.scale = 1. / dt;
+        Double * c = s.c;
+        for (size_t j = 0; j < 6; ++j)
+            c[j] = 0.;
+        c[0] = v1;
+
+        switch (p1.type)
+        {
+            default:
+            case TimelinePoint::CONSTANT:
+            break;
+
+            case TimelinePoint::CONSTANT_USER:
+                c[1] = p1.d1 * dt;
+            break;
+
+            case TimelinePoint::LINEAR:
+                c[1] = v2 - v1;
+            break;
+
+            case TimelinePoint::SMOOTH:
+                c[2] = 3. * (v2 - v1);
+                c[3] = -2. * (v2 - v1);
+            break;
+
+            case TimelinePoint::SYMMETRIC:
+            case TimelinePoint::SYMMETRIC_USER:
+            {
+                // (1-f) * (v1 + a*x) + f * (v2 - b*(1-x)), f = 3x^2 - 2x^3
+                const Double
+                        a = p1.d1 * dt,
+                        b = p2.d1 * dt,
+                        p = v2 - b - v1,
+                        q = b - a;
+                c[1] = a;
+                c[2] = 3. * p;
+                c[3] = 3. * q - 2. * p;
+                c[4] = -2. * q;
+            }
+            break;
+
+            case TimelinePoint::HERMITE:
+            case TimelinePoint::HERMITE_USER:
+                c[1] = p1.d1;
+                c[2] = -3. * (v1 - v2) - 2. * p1.d1 - p2.d1;
+                c[3] = 2. * (v1 - v2) + p1.d1 + p2.d1;
+            break;
+
+            case TimelinePoint::SPLINE4:
+            {
+                Double y0 = v1, y1 = v1, y2 = v2, y3 = v1;
+                if (num >= 3)
+                {
+                    y3 = i + 2 < num ? pts[i + 2]->val : y2;
+                    if (i > 0)
+                        y0 = pts[i - 1]->val;
+                }
+                c[1] = -0.5*y0 + 0.5*y2;
+                c[2] = y0 - 2.5*y1 + 2.0*y2 - 0.5*y3;
+                c[3] = -0.5*y0 + 1.5*y1 - 1.5*y2 + 0.5*y3;
+            }
+            break;
+
+            case TimelinePoint::SPLINE6:
+            {
+                // same neighbours as in Timeline1d::getNoLimit()
+                // and coefficients of MATH::interpol_6()
+                Double ym2 = v1, ym1 = v1, y = v1, y1 = v2, y2 = v1, y3 = v1;
+                if (i > 0)
+                {
+                    ym1 = pts[i - 1]->val;
+                    if (i > 1)
+                        ym2 = pts[i - 2]->val;
+                }
+                if (i + 2 < num)
+                {
+                    y2 = pts[i + 2]->val;
+                    if (i + 3 < num)
+                        y3 = pts[i + 3]->val;
+                }
+                const Double k = 0.04166666666;
+                c[1] = k * ((y1-ym1)*16.0 + (ym2-y2)*2.0);
+                c[2] = k * ((y1+ym1)*16.0 - ym2 - y*30.0 - y2);
+                c[3] = k * (y1*66.0 - y*70.0 - y2*33.0 + ym1*39.0 + y3*7.0 - ym2*9.0);
+                c[4] = k * (y*126.0 - y1*124.0 + y2*61.0 - ym1*64.0 - y3*12.0 + ym2*13.0);
+                c[5] = k * ((y1-y)*50.0 + (ym1-y2)*25.0 + (y3-ym2)*5.0);
+            }
+            break;
+        }
+    }
+}
+
+size_t Timeline1dCompiled::p_find_(Timeline1d::TpHash h) const
+{
+    // number of points <= hash
+    return std::upper_bound(p_hashes_.begin(), p_hashes_.end(), h)
+            - p_hashes_.begin();
+}
+
+size_t Timeline1dCompiled::p_find_(Timeline1d::TpHash h, size_t i) const
+{
+    const size_t num = p_hashes_.size();
+    if (i > num)
+        i = num;
+
+    // step a few segments, otherwise search
+    for (int k = 0; k < 4; ++k)
+    {
+        if (i < num && p_hashes_[i] <= h)
+            ++i;
+        else if (i > 0 && p_hashes_[i - 1] > h)
+            --i;
+        else
+            return i;
+    }
+    return p_find_(h);
+}
+
+Double Timeline1dCompiled::getNoLimit(Double time) const
+{
+    if (p_segments_.empty())
+        return 0.;
+    return p_segments_[p_find_(Timeline1d::hash(time))].value(time);
+}
+
+Double Timeline1dCompiled::getNoLimit(Double time, Cursor& cursor) const
+{
+    if (p_segments_.empty())
+        return 0.;
+    cursor.p_index_ = p_find_(Timeline1d::hash(time), cursor.p_index_);
+    return p_segments_[cursor.p_index_].value(time);
+}
+
+template <typename T>
+void Timeline1dCompiled::p_getBlock_(Double time, Double step, T * out, size_t num) const
+{
+    if (p_segments_.empty())
+    {
+        for (size_t i = 0; i < num; ++i)
+            out[i] = T(p_limit_(0.));
+        return;
+    }
+
+    size_t index = p_find_(Timeline1d::hash(time));
+    for (size_t i = 0; i < num; ++i)
+    {
+        const Double t = time + Double(i) * step;
+        index = p_find_(Timeline1d::hash(t), index);
+        out[i] = T(p_limit_(p_segments_[index].value(t)));
+    }
+}
+
+void Timeline1dCompiled::get(Double time, Double step, Double * out, size_t num) const
+{
+    p_getBlock_(time, step, out, num);
+}
+
+void Timeline1dCompiled::get(Double time, Double step, F32 * out, size_t num) const
+{
+    p_getBlock_(time, step, out, num);
+}
+
+
+} // namespace MATH
+} // namespace MO
@@ -0,0 +1,142 @@
+/** @file timeline1dcompiled.h
+
+    @brief Contiguous read-only snapshot of a Timeline1d
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_MATH_TIMELINE1DCOMPILED_H
+#define MOSRC_MATH_TIMELINE1DCOMPILED_H
+
+#include <cinttypes>
+#include <algorithm>
+#include <vector>
+
+#include "types/float.h"
+#include "Timeline1d.h"
+
+namespace MO {
+namespace MATH {
+
+/** Read-only snapshot of a Timeline1d for fast evaluation.
+
+    The points are stored in flat arrays and every segment between two
+    points is converted to a polynomial of degree 5 in the normalized
+    segment time, so evaluation is a search in a contiguous array
+    and a few multiply-adds, whatever the TimelinePoint::Type.
+
+    The results equal Timeline1d::get() up to floating point rounding.
+    The segment is selected by the point hashes, just like Timeline1d does.
+
+    Use Timeline1d::compiled() to get an automatically updated snapshot.
+    For sequential access, pass a Cursor to the getters, which makes
+    the lookup O(1) when the time changes monotonically.
+    */
+class Timeline1dCompiled
+{
+public:
+
+    /** Remembers the last segment for sequential lookups.
+        A Cursor can be used with any Timeline1dCompiled,
+        but one Cursor must not be shared between threads. */
+    class Cursor
+    {
+        friend class Timeline1dCompiled;
+    public:
+        Cursor() : p_index_(0) { }
+        void reset() { p_index_ = 0; }
+    private:
+        size_t p_index_;
+    };
+
+    // ------------ ctor --------------
+
+    /** Creates an empty timeline */
+    Timeline1dCompiled();
+
+    /** Creates a snapshot of the timeline */
+    explicit Timeline1dCompiled(const Timeline1d& tl);
+
+    /** Replaces the snapshot with the current state of @p tl */
+    void compile(const Timeline1d& tl);
+
+    // ----------- getter -------------
+
+    /** The Timeline1d::revision() this snapshot was compiled from */
+    uint64_t revision() const { return p_revision_; }
+
+    /** Number of points */
+    size_t size() const { return p_hashes_.size(); }
+
+    bool empty() const { return p_hashes_.empty(); }
+
+    // ------------ values ------------
+
+    /** Value at @p time (with limits) */
+    Double get(Double time) const { return p_limit_(getNoLimit(time)); }
+
+    /** Value at @p time (with limits), using and updating @p cursor */
+    Double get(Double time, Cursor& cursor) const
+        { return p_limit_(getNoLimit(time, cursor)); }
+
+    /** Value at @p time (without limits) */
+    Double getNoLimit(Double time) const;
+
+    /** Value at @p time (without limits), using and updating @p cursor */
+    Double getNoLimit(Double time, Cursor& cursor) const;
+
+    /** Writes @p num values (with limits) to @p out,
+        starting at @p time and advancing by @p step seconds. */
+    void get(Double time, Double step, Double * out, size_t num) const;
+    void get(Double time, Double step, F32 * out, size_t num) const;
+
+private:
+
+    /** Polynomial of one segment */
+    struct Segment
+    {
+        /** start time and reciprocal of segment length */
+        Double t, scale;
+        /** coefficients of x^0 to x^5 */
+        Double c[6];
+
+        Double value(Double time) const
+        {
+            const Double x = (time - t) * scale;
+            return c[0] + x * (c[1] + x * (c[2] + x * (c[3] + x * (c[4] + x * c[5]))));
+        }
+    };
+
+    /** Returns the segment index for @p hash */
+    size_t p_find_(Timeline1d::TpHash hash) const;
+    /** Returns the segment index for @p hash, starting at @p index */
+    size_t p_find_(Timeline1d::TpHash hash, size_t index) const;
+
+    template <typename T>
+    void p_getBlock_(Double time, Double step, T * out, size_t num) const;
+
+    Double p_limit_(Double val) const
+    {
+        if (p_lowerLimit_) val = std::max(p_lmin_, val);
+        if (p_upperLimit_) val = std::min(p_lmax_, val);
+        return val;
+    }
+
+    /** hash of each point */
+    std::vector<Timeline1d::TpHash> p_hashes_;
+    /** Segment i lies between point i-1 and i.
+        The first and last segments extrapolate the outer points. */
+    std::vector<Segment> p_segments_;
+
+    uint64_t p_revision_;
+    bool p_lowerLimit_, p_upperLimit_;
+    Double p_lmin_, p_lmax_;
+};
+
+} // namespace MATH
+} // namespace MO
+
+#endif // MOSRC_MATH_TIMELINE1DCOMPILED_H
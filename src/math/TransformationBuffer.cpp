@@ -0,0 +1,310 @@
+/** @file transformationbuffer.cpp
+
+    @brief
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <cmath>
+#include <cstring>
+
+#include "TransformationBuffer.h"
+
+namespace MO {
+
+namespace {
+
+    /** Shepperd's method, the columns must be orthonormal, returns x,y,z,w */
+    Vec4 rotationToQuaternion(const Vec3& c0, const Vec3& c1, const Vec3& c2)
+    {
+        const Float trace = c0.x + c1.y + c2.z;
+        Vec4 q;
+        if (trace > 0)
+        {
+            const Float s = std::sqrt(trace + 1) * 2;
+            q.w = Float(0.25) * s;
+            q.x = (c1.z - c2.y) / s;
+            q.y = (c2.x - c0.z) / s;
+            q.z = (c0.y - c1.x) / s;
+        }
+        else if (c0.x > c1.y && c0.x > c2.z)
+        {
+            const Float s = std::sqrt(1 + c0.x - c1.y - c2.z) * 2;
+            q.w = (c1.z - c2.y) / s;
+            q.x = Float(0.25) * s;
+            q.y = (c1.x + c0.y) / s;
+            q.z = (c2.x + c0.z) / s;
+        }
+        else if (c1.y > c2.z)
+        {
+            const Float s = std::sqrt(1 + c1.y - c0.x - c2.z) * 2;
+            q.w = (c2.x - c0.z) / s;
+            q.x = (c1.x + c0.y) / s;
+            q.y = Float(0.25) * s;
+            q.z = (c2.y + c1.z) / s;
+        }
+        else
+        {
+            const Float s = std::sqrt(1 + c2.z - c0.x - c1.y) * 2;
+            q.w = (c0.y - c1.x) / s;
+            q.x = (c2.x + c0.z) / s;
+            q.y = (c2.y + c1.z) / s;
+            q.z = Float(0.25) * s;
+        }
+        return q;
+    }
+
+    Vec3 normalizedColumn(const Mat4& m, int i, Float& len)
+    {
+        const Vec3 c(m[i]);
+        len = glm::length(c);
+        if (len > Float(0.0000001))
+            return c / len;
+        return Vec3(i == 0 ? 1 : 0, i == 1 ? 1 : 0, i == 2 ? 1 : 0);
+    }
+
+} // namespace
+
+
+TransformationBuffer::TransformationBuffer(uint bufferSize, uint decimation)
+    : p_size_   (0)
+    , p_dec_    (std::max(1u, decimation))
+    , p_const_  (false)
+{
+    resize(bufferSize);
+}
+
+uint TransformationBuffer::p_numKeys_(uint decimation) const
+{
+    if (p_size_ == 0)
+        return 0;
+    if (decimation <= 1)
+        return p_size_;
+    // every decimation'th sample plus the last one
+    return (p_size_ - 1 + decimation - 1) / decimation + 1;
+}
+
+void TransformationBuffer::resize(uint bufferSize)
+{
+    p_size_ = bufferSize;
+    p_m_.resize(p_numKeys_(p_dec_));
+    setIdentity();
+}
+
+void TransformationBuffer::setDecimation(uint decimation)
+{
+    decimation = std::max(1u, decimation);
+    if (decimation == p_dec_ && p_m_.size() == p_numKeys_(decimation))
+        return;
+    p_dec_ = decimation;
+    p_m_.resize(p_numKeys_(p_dec_));
+    setIdentity();
+}
+
+void TransformationBuffer::setIdentity()
+{
+    for (auto & m : p_m_)
+        m = Mat4(1);
+    updateKeys();
+}
+
+void TransformationBuffer::updateKeys()
+{
+    const size_t num = p_m_.size();
+
+    p_const_ = num > 0;
+    for (size_t i = 1; i < num; ++i)
+        if (p_m_[i] != p_m_[0])
+    {
+        p_const_ = false;
+        break;
+    }
+
+    if (p_const_ || p_dec_ <= 1)
+        return;
+
+    // decompose keys into position, scale and rotation
+    p_decomp_.resize(num);
+    p_static_.resize(num);
+    for (size_t i = 0; i < num; ++i)
+    {
+        const Mat4& m = p_m_[i];
+        Decomposed_& d = p_decomp_[i];
+
+        d.pos = Vec3(m[3]);
+        Vec3 c0 = normalizedColumn(m, 0, d.scale.x),
+             c1 = normalizedColumn(m, 1, d.scale.y),
+             c2 = normalizedColumn(m, 2, d.scale.z);
+        // keep rotation proper for mirrored matrices
+        if (glm::dot(glm::cross(c0, c1), c2) < 0)
+        {
+            c0 = -c0;
+            d.scale.x = -d.scale.x;
+        }
+        d.rot = rotationToQuaternion(c0, c1, c2);
+        // stay in one hemisphere so interpolation takes the short path
+        if (i > 0 && glm::dot(d.rot, p_decomp_[i-1].rot) < 0)
+            d.rot = -d.rot;
+
+        if (i > 0)
+            p_static_[i-1] = (p_m_[i-1] == m);
+    }
+    p_static_[num-1] = true;
+}
+
+Mat4 TransformationBuffer::p_interpolate_(SamplePos sample) const
+{
+    const uint k = sample / p_dec_;
+    if (p_static_[k])
+        return p_m_[k];
+
+    const SamplePos s0 = keySample(k);
+    if (sample == s0)
+        return p_m_[k];
+    const Float t = Float(sample - s0) / Float(keySample(k+1) - s0);
+
+    const Decomposed_
+            & a = p_decomp_[k],
+            & b = p_decomp_[k+1];
+
+    // normalized linear interpolation of rotation
+    Vec4 q = a.rot + t * (b.rot - a.rot);
+    q /= glm::length(q);
+    const Vec3
+            scale = a.scale + t * (b.scale - a.scale),
+            pos = a.pos + t * (b.pos - a.pos);
+
+    const Float
+            xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z,
+            xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z,
+            wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return Mat4(
+        Vec4(1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0) * scale.x,
+        Vec4(2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0) * scale.y,
+        Vec4(2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0) * scale.z,
+        Vec4(pos, 1));
+}
+
+void TransformationBuffer::getColumn(uint column, F32 * x, F32 * y, F32 * z) const
+{
+    if (p_m_.empty())
+        return;
+
+    if (p_const_)
+    {
+        const Vec4& c = p_m_[0][column];
+        std::fill(x, x + p_size_, c.x);
+        std::fill(y, y + p_size_, c.y);
+        std::fill(z, z + p_size_, c.z);
+        return;
+    }
+
+    if (p_dec_ <= 1)
+    {
+        for (uint i = 0; i < p_size_; ++i)
+        {
+            const Vec4& c = p_m_[i][column];
+            x[i] = c.x;
+            y[i] = c.y;
+            z[i] = c.z;
+        }
+        return;
+    }
+
+    // interpolate between each pair of keys
+    const uint num = p_m_.size();
+    for (uint k = 0; k + 1 < num; ++k)
+    {
+        const SamplePos s0 = keySample(k), s1 = keySample(k+1);
+        const Vec4
+                & a = p_m_[k][column],
+                d = p_m_[k+1][column] - a;
+        if (p_static_[k])
+        {
+            std::fill(x + s0, x + s1, a.x);
+            std::fill(y + s0, y + s1, a.y);
+            std::fill(z + s0, z + s1, a.z);
+            continue;
+        }
+        const Float step = Float(1) / Float(s1 - s0);
+        for (SamplePos s = s0; s < s1; ++s)
+        {
+            const Float t = Float(s - s0) * step;
+            x[s] = a.x + t * d.x;
+            y[s] = a.y + t * d.y;
+            z[s] = a.z + t * d.z;
+        }
+    }
+    // the last key
+    const Vec4& c = p_m_[num-1][column];
+    x[p_size_-1] = c.x;
+    y[p_size_-1] = c.y;
+    z[p_size_-1] = c.z;
+}
+
+void TransformationBuffer::p_expand_()
+{
+    if (p_dec_ <= 1 && !p_const_)
+        return;
+
+    if (p_const_)
+    {
+        const Mat4 m = p_m_[0];
+        p_m_.resize(p_size_);
+        for (auto & k : p_m_)
+            k = m;
+    }
+    else
+    {
+        std::vector<Mat4> full(p_size_);
+        for (uint i = 0; i < p_size_; ++i)
+            full[i] = p_interpolate_(i);
+        p_m_.swap(full);
+    }
+    p_dec_ = 1;
+    p_const_ = false;
+}
+
+void TransformationBuffer::setTransformation(const Mat4& t, uint sample)
+{
+    p_expand_();
+    p_m_[sample] = t;
+}
+
+void TransformationBuffer::setTransformations(const Mat4 * t)
+{
+    p_dec_ = 1;
+    p_const_ = false;
+    p_m_.resize(p_size_);
+    memcpy(&p_m_[0], t, p_size_ * sizeof(Mat4));
+}
+
+void TransformationBuffer::copy(
+        const TransformationBuffer * src, TransformationBuffer * dst)
+{
+    dst->p_size_ = src->p_size_;
+    dst->p_dec_ = src->p_dec_;
+    dst->p_const_ = src->p_const_;
+    dst->p_m_.resize(src->p_m_.size());
+
+    // only the first key is valid in constant mode
+    if (src->p_const_)
+    {
+        if (!dst->p_m_.empty())
+            dst->p_m_[0] = src->p_m_[0];
+        return;
+    }
+
+    dst->p_m_ = src->p_m_;
+    if (src->p_dec_ > 1)
+    {
+        dst->p_decomp_ = src->p_decomp_;
+        dst->p_static_ = src->p_static_;
+    }
+}
+
+} // namespace MO
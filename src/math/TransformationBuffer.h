@@ -12,50 +12,116 @@
 #define MOSRC_MATH_TRANSFORMATIONBUFFER_H
 
 #include <vector>
+#include <algorithm>
 
 #include "types/vector.h"
 
 namespace MO {
 
+/** A block of transformation matrices, one for each sample.
+
+    With a decimation > 1 the buffer works at control-rate:
+    Only every decimation()th sample (and the last sample)
+    is stored as a key and the matrices in between are
+    reconstructed by interpolating position, scale and rotation
+    (as quaternion) when read with transformation().
+    Shearing is not preserved between keys.
+
+    Blocks where all keys are equal are detected by updateKeys()
+    and stored only once.
+*/
 class TransformationBuffer
 {
 public:
-    TransformationBuffer(uint bufferSize)
-        :   p_m_   (bufferSize)
+    TransformationBuffer(uint bufferSize, uint decimation = 1);
+
+    // ---------------- getter ---------------------
+
+    /** Returns the transformation at the given sample */
+    Mat4 transformation(SamplePos sample) const
     {
-        setIdentity();
+        if (p_const_)
+            return p_m_[0];
+        if (p_dec_ <= 1)
+            return p_m_[sample];
+        return p_interpolate_(sample);
     }
 
-    // ---------------- getter ---------------------
+    /** Number of samples */
+    uint bufferSize() const { return p_size_; }
+
+    /** The distance of keys in samples, 1 for a full-rate buffer */
+    uint decimation() const { return p_dec_; }
+
+    /** Returns true when the whole block holds the same transformation */
+    bool isConstant() const { return p_const_; }
 
-    const Mat4& transformation(SamplePos sample) const { return p_m_[sample]; }
+    /** Number of stored matrices (without constant-detection) */
+    uint numKeys() const { return p_m_.size(); }
 
-    const Mat4 * transformations() const { return &p_m_[0]; }
+    /** The sample position of the key */
+    SamplePos keySample(uint key) const
+        { return std::min(SamplePos(key) * p_dec_, SamplePos(p_size_ - 1)); }
 
-    uint bufferSize() const { return p_m_.size(); }
+    const Mat4& key(uint key) const { return p_m_[key]; }
+
+    /** Writes the first three components of matrix column @p column
+        for each sample into @p x, @p y and @p z (bufferSize() values each).
+        For control-rate buffers the keys are read once and the column
+        is linearly interpolated in between, which is exact for
+        the translation column. */
+    void getColumn(uint column, F32 * x, F32 * y, F32 * z) const;
 
     // ---------------- setter ---------------------
 
-    void resize(uint bufferSize) { p_m_.resize(bufferSize); setIdentity(); }
+    void resize(uint bufferSize);
+
+    /** Sets the distance of keys in samples, 1 stores every sample. */
+    void setDecimation(uint decimation);
 
-    void setIdentity() { for (auto & m : p_m_) m = Mat4(1); }
+    void setIdentity();
 
-    Mat4& transformation(SamplePos sample) { return p_m_[sample]; }
+    /** Write access to a key. Call updateKeys() after changing keys. */
+    Mat4& key(uint key) { return p_m_[key]; }
 
-    void setTransformation(const Mat4& t, uint sample) { p_m_[sample] = t; }
+    /** Detects a constant block and prepares the interpolation.
+        Must be called after the keys have been changed through key(). */
+    void updateKeys();
 
-    void setTransformations(const Mat4 * t) { memcpy(&p_m_[0], t, bufferSize() * sizeof(Mat4)); }
+    /** Sets the transformation for a single sample.
+        A control-rate buffer is expanded to full-rate before
+        and stays full-rate until the next setDecimation().
+        Prefer writing the keys with key() and updateKeys(). */
+    void setTransformation(const Mat4& t, uint sample);
 
+    /** Sets all bufferSize() transformations. The buffer becomes full-rate. */
+    void setTransformations(const Mat4 * t);
 
     // ------------ static helper -------------------
 
-    static void copy(const TransformationBuffer * src, TransformationBuffer * dst)
-    {
-        memcpy(&dst->p_m_[0], &src->p_m_[0], dst->bufferSize() * sizeof(Mat4));
-    }
+    /** Copies the contents of @p src to @p dst.
+        @p dst will have the same size and decimation as @p src afterwards. */
+    static void copy(const TransformationBuffer * src, TransformationBuffer * dst);
 
 private:
+
+    /** Decomposed key for interpolation */
+    struct Decomposed_
+    {
+        Vec3 pos, scale;
+        Vec4 rot;
+    };
+
+    uint p_numKeys_(uint decimation) const;
+    void p_expand_();
+    Mat4 p_interpolate_(SamplePos sample) const;
+
     std::vector<Mat4> p_m_;
+    std::vector<Decomposed_> p_decomp_;
+    /** One flag per key, true if the next key is equal */
+    std::vector<unsigned char> p_static_;
+    uint p_size_, p_dec_;
+    bool p_const_;
 };
 
 } // namespace MO
@@ -12,6 +12,7 @@
 #include "math/constants.h"
 
 #include "grammar.parser.cpp"
+#include "parser_batch.h"
 
 #if 0
 #	define MF_DEBUG_(stream_arg__) std::cout << stream_arg__ << "\n";
@@ -416,6 +417,10 @@ struct Parser::Detail
 {
     /* YYPARSE_PARAM */
     ParseParam param;
+
+    BatchProgram batch;
+    /** variable pointer -> array for evalBatch() */
+    std::map<Float*, Float*> batchVars;
 };
 
 
@@ -454,6 +459,7 @@ bool Parser::parse(const std::string& str)
     d_->param.funcs = &funcs_;
 
     d_->param.prog->clear();
+    d_->batch.clear();
 
     ok_ = (yyparse( (void*)&d_->param ) == 0);
 
@@ -484,6 +490,9 @@ bool Parser::parse(const std::string& str)
     PPP_PROG_DEBUG( "--- after compilation:\n" << d_->param.prog->string() )
     PPP_PROG_DEBUG( d_->param.prog->num_visible_expr() << " functions" );
 
+    if (ok_ && !d_->batch.compile(d_->param.prog))
+        PPP_PROG_DEBUG( "no batch evaluation." );
+
     return ok_;
 }
 
@@ -503,6 +512,56 @@ Float Parser::eval()
 }
 
 
+bool Parser::setBatchVariable(const std::string& name, Float * values)
+{
+    Variable * v = var_.variable(name);
+    if (!v)
+        return false;
+
+    if (values)
+        d_->batchVars[v->value_ptr()] = values;
+    else
+        d_->batchVars.erase(v->value_ptr());
+    return true;
+}
+
+void Parser::clearBatchVariables()
+{
+    d_->batchVars.clear();
+}
+
+bool Parser::isBatchCompiled() const
+{
+    return ok_ && d_->batch.ok() && !d_->batch.isSequential(d_->batchVars);
+}
+
+void Parser::evalBatch(Float * result, size_t num)
+{
+    if (!ok_ || num == 0)
+        return;
+
+    if (isBatchCompiled())
+    {
+        d_->batch.eval(d_->batchVars, result, num);
+        return;
+    }
+
+    // scalar fallback
+    for (size_t i=0; i<num; ++i)
+    {
+        for (auto & b : d_->batchVars)
+            *b.first = b.second[i];
+
+        const Float r = eval();
+        if (result)
+            result[i] = r;
+
+        for (auto & b : d_->batchVars)
+            b.second[i] = *b.first;
+    }
+}
+
+
 std::string Parser::syntax() const
 {
     std::stringstream s;
@@ -307,6 +307,33 @@ namespace PPP_NAMESPACE {
         /** (re-)calculate and return result */
         Float eval();
 
+        // ------- batch run -----------
+
+        /** Binds an array to the variable @p name for evalBatch().
+            The array must hold at least the number of sets passed to evalBatch()
+            and receives the values of assignments to the variable.
+            NULL removes the binding. Returns false for unknown variables. */
+        bool setBatchVariable(const std::string& name, Float * values);
+
+        /** Removes all bindings from setBatchVariable() */
+        void clearBatchVariables();
+
+        /** Evaluates the equation @p num times, once for each index into
+            the bound variable arrays. If @p result is not NULL, it receives
+            the @p num results.
+            Unbound variables are constant for all sets and keep
+            the value of the last set if assigned.
+            Equations without conditions, user- and lambda-functions
+            run as flat bytecode on arrays, others fall back to eval().
+            Equations using rnd() also fall back, so the random sequence
+            is drawn in the same order as with repeated eval() calls.
+            noise() has no state and is batched. */
+        void evalBatch(Float * result, size_t num);
+
+        /** Returns true if evalBatch() can use the bytecode for the
+            current equation and bindings */
+        bool isBatchCompiled() const;
+
         // -------- info ---------------
 
         /** internal representation back to human readable */
@@ -0,0 +1,415 @@
+/**	@file
+
+	@brief Math Function Parser - flat bytecode for batch evaluation
+
+	@author def.gsus-
+	@version 2026/10/16 started
+*/
+#ifndef PARSER_BATCH_H_INCLUDED
+#define PARSER_BATCH_H_INCLUDED
+
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "parser_program.h"
+
+namespace PPP_NAMESPACE
+{
+
+    /** A compiled Program as a list of instructions on registers.
+        Each register is an array of values, one for each set of variables,
+        so every instruction is a tight loop over the sets.
+
+        Conditions, user functions, lambda functions and rnd() are not supported,
+        compile() returns false for such programs.
+        rnd() draws from a global sequence, the batch would call it
+        per instruction for all sets instead of per set. */
+    class BatchProgram
+    {
+        public:
+
+        /** Number of sets processed in one pass through the code */
+        static const size_t chunkSize = 256;
+
+        enum OpCode
+        {
+            O_GENERIC,
+            O_ASSIGN_VAR,
+            O_ASSIGN,
+            O_NEG,
+            O_ADD,
+            O_SUB,
+            O_MUL,
+            O_DIV,
+            O_POW,
+            O_MOD,
+            O_MIN,
+            O_MAX,
+            O_CLAMP,
+            O_MIX,
+            O_ABS,
+            O_FLOOR,
+            O_CEIL,
+            O_FRAC,
+            O_SQRT,
+            O_SIN,
+            O_COS,
+            O_TAN,
+            O_EXP,
+            O_LOG,
+            O_EQUAL,
+            O_NOT_EQUAL,
+            O_SMALLER,
+            O_SMALLER_EQUAL,
+            O_GREATER,
+            O_GREATER_EQUAL,
+            O_MAG_2,
+            O_MAG_3
+        };
+
+        enum RegisterType
+        {
+            /** result of an expression */
+            R_TEMP,
+            R_CONSTANT,
+            R_VARIABLE
+        };
+
+        struct Register
+        {
+            RegisterType type;
+            /** the scalar value */
+            Float * ptr;
+            /** index of first instruction reading/writing, or -1 */
+            int firstRead, firstWrite;
+        };
+
+        struct Instruction
+        {
+            OpCode op;
+            /** only for O_GENERIC */
+            FuncPtr func;
+            int numSrc, dst, src[4];
+        };
+
+        BatchProgram() : resultReg_(-1) { }
+
+        bool ok() const { return resultReg_ >= 0; }
+
+        void clear()
+        {
+            regs_.clear();
+            code_.clear();
+            regMap_.clear();
+            resultReg_ = -1;
+        }
+
+        /** Creates the bytecode from a compiled Program.
+            Returns false if the program can not be batched. */
+        bool compile(Program * prog)
+        {
+            clear();
+
+            if (!prog || prog->empty || !prog->sub.empty() || prog->expr.empty())
+                return false;
+
+            // classify inputs
+            for (Expression * e : prog->expr)
+            {
+                if (e->is_funcdef() || e->is_condition || e->is_conditional())
+                    return false;
+                for (int i=1; i<=e->num_params; ++i)
+                {
+                    if (e->type[i] == Expression::P_VARIABLE)
+                        getRegister_(e->var[i]->value_ptr(), R_VARIABLE);
+                    else if (e->type[i] == Expression::P_CONSTANT)
+                        getRegister_(&e->value[i], R_CONSTANT);
+                    else if (e->type[i] != Expression::P_EXPRESSION)
+                        return false;
+                }
+            }
+
+            // create instructions
+            for (Expression * e : prog->expr)
+            {
+                // NOPs are linked through
+                if (!e->func)
+                    continue;
+
+                if (e->func->is_lambda() || e->func->isTemp()
+                    || e->num_params > 4)
+                { clear(); return false; }
+
+                Instruction ins;
+                ins.func = e->func->func();
+                ins.op = getOpCode_(ins.func);
+                // the compound assignments accumulate over evaluations
+                // and rnd() must be drawn in the order of eval()
+                if (ins.op == O_GENERIC
+                    && (isAccumulating_(ins.func) || isStateful_(ins.func)))
+                { clear(); return false; }
+
+                ins.numSrc = e->num_params;
+                ins.dst = getRegister_(e->params[0], R_TEMP);
+                for (int i=0; i<ins.numSrc; ++i)
+                    ins.src[i] = getRegister_(e->params[i+1], R_TEMP);
+
+                const int idx = code_.size();
+                for (int i=0; i<ins.numSrc; ++i)
+                    if (!(ins.op == O_ASSIGN_VAR && i == 0))
+                        markRead_(ins.src[i], idx);
+                markWrite_(ins.dst, idx);
+                if (ins.op == O_ASSIGN_VAR)
+                    markWrite_(ins.src[0], idx);
+
+                code_.push_back(ins);
+            }
+
+            resultReg_ = getRegister_(prog->expr.back()->params[0], R_TEMP);
+            return true;
+        }
+
+        /** Returns true if the values depend on the previous evaluation,
+            e.g. an unbound variable is read before assigned. */
+        bool isSequential(const std::map<Float*, Float*>& bound) const
+        {
+            for (const Register& r : regs_)
+                if (r.type == R_VARIABLE && r.firstWrite >= 0
+                    && r.firstRead >= 0 && r.firstRead <= r.firstWrite
+                    && bound.find(r.ptr) == bound.end())
+                    return true;
+            return false;
+        }
+
+        /** Evaluates @p num sets. @p bound maps variable pointers to arrays.
+            Unbound variables use their current value for all sets and
+            receive the value of the last set if assigned. */
+        void eval(const std::map<Float*, Float*>& bound, Float * result, size_t num)
+        {
+            const size_t numRegs = regs_.size();
+            mem_.resize(numRegs * chunkSize);
+
+            // input arrays for each register (or NULL)
+            arrays_.assign(numRegs, 0);
+
+            // broadcast constants and unbound variables
+            for (size_t i=0; i<numRegs; ++i)
+            {
+                const Register& r = regs_[i];
+                if (r.type == R_TEMP)
+                    continue;
+                if (r.type == R_VARIABLE)
+                {
+                    auto b = bound.find(r.ptr);
+                    if (b != bound.end())
+                    {
+                        arrays_[i] = b->second;
+                        continue;
+                    }
+                }
+                std::fill(reg_(i), reg_(i) + chunkSize, *r.ptr);
+            }
+
+            for (size_t start = 0; start < num; start += chunkSize)
+            {
+                const size_t n = std::min(chunkSize, num - start);
+
+                // load bound variables
+                for (size_t i=0; i<numRegs; ++i)
+                    if (arrays_[i])
+                        std::copy(arrays_[i] + start, arrays_[i] + start + n, reg_(i));
+
+                for (const Instruction& ins : code_)
+                    exec_(ins, n);
+
+                // store assigned variables
+                for (size_t i=0; i<numRegs; ++i)
+                    if (arrays_[i] && regs_[i].firstWrite >= 0)
+                        std::copy(reg_(i), reg_(i) + n, arrays_[i] + start);
+
+                if (result)
+                    std::copy(reg_(resultReg_), reg_(resultReg_) + n, result + start);
+
+                // keep the last set in assigned scalar variables
+                if (start + n == num)
+                    for (size_t i=0; i<numRegs; ++i)
+                        if (!arrays_[i] && regs_[i].type == R_VARIABLE
+                            && regs_[i].firstWrite >= 0)
+                            *regs_[i].ptr = reg_(i)[n-1];
+            }
+        }
+
+        private:
+
+        Float * reg_(size_t i) { return &mem_[i * chunkSize]; }
+
+        int getRegister_(Float * ptr, RegisterType type)
+        {
+            auto i = regMap_.find(ptr);
+            if (i != regMap_.end())
+                return i->second;
+
+            Register r;
+            r.type = type;
+            r.ptr = ptr;
+            r.firstRead = r.firstWrite = -1;
+            regs_.push_back(r);
+            regMap_.insert(std::make_pair(ptr, int(regs_.size()) - 1));
+            return regs_.size() - 1;
+        }
+
+        void markRead_(int reg, int idx)
+        {
+            if (regs_[reg].firstRead < 0)
+                regs_[reg].firstRead = idx;
+        }
+
+        void markWrite_(int reg, int idx)
+        {
+            if (regs_[reg].firstWrite < 0)
+                regs_[reg].firstWrite = idx;
+        }
+
+        typedef void (*RawFunc)(Float**);
+
+        static RawFunc rawFunc_(const FuncPtr& f)
+        {
+            const RawFunc * r = f.template target<RawFunc>();
+            return r ? *r : 0;
+        }
+
+        static bool isAccumulating_(const FuncPtr& f)
+        {
+            const RawFunc r = rawFunc_(f);
+            return r == math_func<Float>::add_1
+                || r == math_func<Float>::sub_1
+                || r == math_func<Float>::mul_1
+                || r == math_func<Float>::div_1;
+        }
+
+        static bool isStateful_(const FuncPtr& f)
+        {
+            return rawFunc_(f) == math_func<Float>::rnd_0;
+        }
+
+        static OpCode getOpCode_(const FuncPtr& f)
+        {
+            const RawFunc r = rawFunc_(f);
+            if (!r) return O_GENERIC;
+            typedef math_func<Float> M;
+            if (r == M::assign_2) return O_ASSIGN_VAR;
+            if (r == M::assign_1) return O_ASSIGN;
+            if (r == M::neg_assign_1) return O_NEG;
+            if (r == M::add_2) return O_ADD;
+            if (r == M::sub_2) return O_SUB;
+            if (r == M::mul_2) return O_MUL;
+            if (r == M::div_2) return O_DIV;
+            if (r == M::pow_2) return O_POW;
+            if (r == M::mod_2) return O_MOD;
+            if (r == M::min_2) return O_MIN;
+            if (r == M::max_2) return O_MAX;
+            if (r == M::clamp_3) return O_CLAMP;
+            if (r == M::mix_3) return O_MIX;
+            if (r == M::abs_1) return O_ABS;
+            if (r == M::floor_1) return O_FLOOR;
+            if (r == M::ceil_1) return O_CEIL;
+            if (r == M::frac_1) return O_FRAC;
+            if (r == M::sqrt_1) return O_SQRT;
+            if (r == M::sin_1) return O_SIN;
+            if (r == M::cos_1) return O_COS;
+            if (r == M::tan_1) return O_TAN;
+            if (r == M::exp_1) return O_EXP;
+            if (r == M::log_1) return O_LOG;
+            if (r == M::equal_2) return O_EQUAL;
+            if (r == M::not_equal_2) return O_NOT_EQUAL;
+            if (r == M::smaller_2) return O_SMALLER;
+            if (r == M::smaller_equal_2) return O_SMALLER_EQUAL;
+            if (r == M::greater_2) return O_GREATER;
+            if (r == M::greater_equal_2) return O_GREATER_EQUAL;
+            if (r == M::mag_2) return O_MAG_2;
+            if (r == M::mag_3) return O_MAG_3;
+            return O_GENERIC;
+        }
+
+        void exec_(const Instruction& ins, size_t n)
+        {
+            Float * R = reg_(ins.dst);
+            const Float
+                * A = ins.numSrc > 0 ? reg_(ins.src[0]) : 0,
+                * B = ins.numSrc > 1 ? reg_(ins.src[1]) : 0,
+                * C = ins.numSrc > 2 ? reg_(ins.src[2]) : 0;
+
+            #define PPP_BATCH_LOOP(expr__) \
+                for (size_t i=0; i<n; ++i) R[i] = (expr__); break;
+
+            switch (ins.op)
+            {
+                case O_ASSIGN_VAR:
+                {
+                    Float * V = reg_(ins.src[0]);
+                    for (size_t i=0; i<n; ++i)
+                        R[i] = V[i] = B[i];
+                }
+                break;
+                case O_ASSIGN:        PPP_BATCH_LOOP( A[i] )
+                case O_NEG:           PPP_BATCH_LOOP( -A[i] )
+                case O_ADD:           PPP_BATCH_LOOP( A[i] + B[i] )
+                case O_SUB:           PPP_BATCH_LOOP( A[i] - B[i] )
+                case O_MUL:           PPP_BATCH_LOOP( A[i] * B[i] )
+                case O_DIV:           PPP_BATCH_LOOP( A[i] / B[i] )
+                case O_POW:           PPP_BATCH_LOOP( std::pow(A[i], B[i]) )
+                case O_MOD:           PPP_BATCH_LOOP( std::fmod(A[i], B[i]) )
+                case O_MIN:           PPP_BATCH_LOOP( std::min(A[i], B[i]) )
+                case O_MAX:           PPP_BATCH_LOOP( std::max(A[i], B[i]) )
+                case O_CLAMP:         PPP_BATCH_LOOP( std::min(std::max(A[i], B[i]), C[i]) )
+                case O_MIX:           PPP_BATCH_LOOP( A[i] + C[i] * (B[i] - A[i]) )
+                case O_ABS:           PPP_BATCH_LOOP( std::abs(A[i]) )
+                case O_FLOOR:         PPP_BATCH_LOOP( std::floor(A[i]) )
+                case O_CEIL:          PPP_BATCH_LOOP( std::ceil(A[i]) )
+                case O_FRAC:          PPP_BATCH_LOOP( A[i] - std::floor(A[i]) )
+                case O_SQRT:          PPP_BATCH_LOOP( std::sqrt(A[i]) )
+                case O_SIN:           PPP_BATCH_LOOP( std::sin(A[i]) )
+                case O_COS:           PPP_BATCH_LOOP( std::cos(A[i]) )
+                case O_TAN:           PPP_BATCH_LOOP( std::tan(A[i]) )
+                case O_EXP:           PPP_BATCH_LOOP( std::exp(A[i]) )
+                case O_LOG:           PPP_BATCH_LOOP( std::log(A[i]) )
+                case O_EQUAL:         PPP_BATCH_LOOP( Float(A[i] == B[i]) )
+                case O_NOT_EQUAL:     PPP_BATCH_LOOP( Float(A[i] != B[i]) )
+                case O_SMALLER:       PPP_BATCH_LOOP( Float(std::isless(A[i], B[i])) )
+                case O_SMALLER_EQUAL: PPP_BATCH_LOOP( Float(std::islessequal(A[i], B[i])) )
+                case O_GREATER:       PPP_BATCH_LOOP( Float(std::isgreater(A[i], B[i])) )
+                case O_GREATER_EQUAL: PPP_BATCH_LOOP( Float(std::isgreaterequal(A[i], B[i])) )
+                case O_MAG_2:         PPP_BATCH_LOOP( std::sqrt(A[i] * A[i] + B[i] * B[i]) )
+                case O_MAG_3:         PPP_BATCH_LOOP( std::sqrt(A[i] * A[i] + B[i] * B[i]
+                                                              + C[i] * C[i]) )
+
+                case O_GENERIC:
+                {
+                    // call the scalar function for each set
+                    Float * p[5];
+                    for (size_t i=0; i<n; ++i)
+                    {
+                        p[0] = R + i;
+                        for (int j=0; j<ins.numSrc; ++j)
+                            p[j+1] = reg_(ins.src[j]) + i;
+                        ins.func(p);
+                    }
+                }
+                break;
+            }
+
+            #undef PPP_BATCH_LOOP
+        }
+
+        std::vector<Register> regs_;
+        std::vector<Instruction> code_;
+        std::map<Float*, int> regMap_;
+        std::vector<Float> mem_;
+        std::vector<Float*> arrays_;
+        int resultReg_;
+    };
+
+} // namespace PPP_NAMESPACE
+
+#endif // PARSER_BATCH_H_INCLUDED
@@ -11,6 +11,9 @@
 #ifndef MOSRC_MATH_HASH_H
 #define MOSRC_MATH_HASH_H
 
+#include <cstddef>
+#include <cinttypes>
+
 namespace MO {
 namespace MATH {
 
@@ -109,6 +112,20 @@ I getHash(I x, I y, I z, I w)
             ^ (w * hash_traits<I>::prime4);
 }
 
+/** Returns the 64 bit FNV-1a hash of @p num bytes at @p data.
+    Pass a previous result as @p hash to continue hashing. */
+inline uint64_t getHashFnv64(const void * data, size_t num,
+                             uint64_t hash = 14695981039346656037ULL)
+{
+    auto p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < num; ++i)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 /** Struct for holding and comparing 3 values of T.
     As long as T provides operator == and < this will work */
 template <typename T>
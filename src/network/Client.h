@@ -34,6 +34,9 @@ public:
 
     bool isRunning() const;
 
+    /** The address of the server that is connected or pinged */
+    const QHostAddress& serverAddress() const { return address_; }
+
 signals:
 
     void connected();
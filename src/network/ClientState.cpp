@@ -15,23 +15,51 @@ namespace MO {
 
 void ClientState::serialize(IO::DataStream &io) const
 {
-    io.writeHeader("cs", 1);
+    io.writeHeader("cs", 3);
 
     io << index_ << desktop_
        << isPlayback_ << isInfoWindow_ << isRenderWindow_
        << isSceneReady_ << isFilesReady_
        << cacheSize_ << memory_ << outputSize_;
+
+    // v2
+    io << clockOffset_ << clockDrift_ << roundTrip_
+       << frameSkew_ << maxFrameSkew_;
+
+    // v3
+    io << qint32(filesPending_) << transferBytes_ << transferTotal_
+       << transferRate_;
 }
 
 void ClientState::deserialize(IO::DataStream &io)
 {
-    io.readHeader("cs", 1);
+    const auto ver = io.readHeader("cs", 3);
 
     io >> index_ >> desktop_
        >> isPlayback_ >> isInfoWindow_ >> isRenderWindow_
        >> isSceneReady_ >> isFilesReady_
        >> cacheSize_ >> memory_ >> outputSize_
             ;
+
+    if (ver >= 2)
+        io >> clockOffset_ >> clockDrift_ >> roundTrip_
+           >> frameSkew_ >> maxFrameSkew_;
+    else
+        clockOffset_ = clockDrift_ = roundTrip_
+                = frameSkew_ = maxFrameSkew_ = 0.;
+
+    if (ver >= 3)
+    {
+        qint32 pending;
+        io >> pending >> transferBytes_ >> transferTotal_ >> transferRate_;
+        filesPending_ = pending;
+    }
+    else
+    {
+        filesPending_ = 0;
+        transferBytes_ = transferTotal_ = 0;
+        transferRate_ = 0.;
+    }
 }
 
 
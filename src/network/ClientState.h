@@ -14,6 +14,8 @@
 #include <Qt>
 #include <QSize>
 
+#include "types/float.h"
+
 
 namespace MO {
 namespace IO { class DataStream; }
@@ -47,6 +49,30 @@ public:
     bool isSceneReady() const { return isSceneReady_; }
     bool isFilesReady() const { return isFilesReady_; }
 
+    // clock synchronisation, see ClockSync
+
+    /** Estimated server clock minus client clock in seconds */
+    Double clockOffset() const { return clockOffset_; }
+    /** Estimated clock drift in seconds per second */
+    Double clockDrift() const { return clockDrift_; }
+    /** Lowest measured round-trip time in seconds */
+    Double roundTrip() const { return roundTrip_; }
+    /** Mean absolute error of the predicted scene time in seconds */
+    Double frameSkew() const { return frameSkew_; }
+    /** Maximum absolute error of the predicted scene time in seconds */
+    Double maxFrameSkew() const { return maxFrameSkew_; }
+
+    // file transfers, see FileTransfer
+
+    /** Number of files queued or in transfer */
+    int filesPending() const { return filesPending_; }
+    /** Bytes of the current transfers that are present */
+    quint64 transferBytes() const { return transferBytes_; }
+    /** Bytes of all current transfers */
+    quint64 transferTotal() const { return transferTotal_; }
+    /** Current download speed in bytes per second */
+    Double transferRate() const { return transferRate_; }
+
 private:
 
     friend class ClientEngine;
@@ -56,9 +82,11 @@ private:
          isRenderWindow_,
          isSceneReady_,
          isFilesReady_;
-    int index_, desktop_;
+    int index_, desktop_, filesPending_;
     QSize outputSize_;
-    quint64 cacheSize_, memory_;
+    quint64 cacheSize_, memory_, transferBytes_, transferTotal_;
+    Double clockOffset_, clockDrift_, roundTrip_,
+           frameSkew_, maxFrameSkew_, transferRate_;
 };
 
 
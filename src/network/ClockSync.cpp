@@ -0,0 +1,337 @@
+/** @file clocksync.cpp
+
+    @brief Estimation of server clock and scene time on clients
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+
+#include "ClockSync.h"
+
+namespace MO {
+
+struct ClockSync::Private
+{
+    struct Sample
+    {
+        /** local time in the middle of the round-trip */
+        Double local,
+        /** server minus local clock */
+            offset,
+            rtt;
+    };
+
+    struct Anchor
+    {
+        Double server, scene;
+    };
+
+    Private()
+    {
+        reset();
+    }
+
+    void reset();
+    /** Fits offset and drift to the best samples */
+    void fitClock();
+    /** Fits the scene time line to the anchors */
+    void fitScene();
+
+    Double serverTime(Double local) const
+        { return local + offset + drift * (local - refLocal); }
+    Double sceneAtServer(Double server) const
+    {
+        if (!playing)
+            return lastScene;
+        return refScene + sceneRate * (server - refServer);
+    }
+
+    /** Number of round-trips used for estimation */
+    static const size_t maxSamples = 32;
+    /** Number of scene time events used for the rate estimation */
+    static const size_t maxAnchors = 32;
+    static const size_t maxSkews = 64;
+    /** Scene time differences larger than this are treated as seek */
+    static constexpr Double seekThreshold = 0.1;
+    /** Minimum span of samples to estimate drift and rate */
+    static constexpr Double minFitSpan = 2.;
+
+    std::deque<Sample> samples;
+    std::deque<Anchor> anchors;
+    std::deque<Double> skews;
+
+    bool hasRoundTrip, hasOffset, playing;
+    Double offset, drift, refLocal, rtt,
+           sceneRate, refScene, refServer, lastScene;
+
+    mutable bool hasLastOut;
+    mutable Double lastOut;
+
+    mutable std::mutex mutex;
+};
+
+ClockSync::ClockSync()
+    : p_    (new Private())
+{
+}
+
+ClockSync::~ClockSync()
+{
+    delete p_;
+}
+
+void ClockSync::Private::reset()
+{
+    samples.clear();
+    anchors.clear();
+    skews.clear();
+    hasRoundTrip = hasOffset = playing = hasLastOut = false;
+    offset = drift = refLocal = rtt = 0.;
+    sceneRate = 1.;
+    refScene = refServer = lastScene = lastOut = 0.;
+}
+
+void ClockSync::reset()
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    p_->reset();
+}
+
+bool ClockSync::isSynchronized() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->hasRoundTrip;
+}
+
+bool ClockSync::hasSceneTime() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return !p_->anchors.empty();
+}
+
+bool ClockSync::isPlaying() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->playing;
+}
+
+size_t ClockSync::numSamples() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->samples.size();
+}
+
+Double ClockSync::offset() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->offset;
+}
+
+Double ClockSync::drift() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->drift;
+}
+
+Double ClockSync::roundTrip() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->rtt;
+}
+
+Double ClockSync::frameSkew() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    if (p_->skews.empty())
+        return 0.;
+    Double sum = 0.;
+    for (auto s : p_->skews)
+        sum += s;
+    return sum / p_->skews.size();
+}
+
+Double ClockSync::maxFrameSkew() const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    Double m = 0.;
+    for (auto s : p_->skews)
+        m = std::max(m, s);
+    return m;
+}
+
+Double ClockSync::serverTime(Double localTime) const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+    return p_->serverTime(localTime);
+}
+
+Double ClockSync::sceneTime(Double localTime) const
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+
+    if (p_->anchors.empty())
+        return 0.;
+    if (!p_->playing)
+        return p_->lastScene;
+
+    Double t = p_->sceneAtServer(p_->serverTime(localTime));
+
+    // don't step back because of a new estimate
+    if (p_->hasLastOut && t < p_->lastOut
+            && p_->lastOut - t < Private::seekThreshold)
+        t = p_->lastOut;
+
+    p_->lastOut = t;
+    p_->hasLastOut = true;
+    return t;
+}
+
+void ClockSync::addRoundTrip(Double t0, Double t1, Double t2, Double t3)
+{
+    Private::Sample s;
+    s.local = (t0 + t3) / 2.;
+    s.offset = ((t1 - t0) + (t2 - t3)) / 2.;
+    s.rtt = std::max(Double(0), (t3 - t0) - (t2 - t1));
+
+    std::lock_guard<std::mutex> lock(p_->mutex);
+
+    p_->samples.push_back(s);
+    while (p_->samples.size() > Private::maxSamples)
+        p_->samples.pop_front();
+
+    p_->hasRoundTrip = p_->hasOffset = true;
+    p_->fitClock();
+}
+
+void ClockSync::Private::fitClock()
+{
+    if (samples.empty())
+        return;
+
+    // use the half with the lowest round-trip times,
+    // their offsets are least affected by queuing delays
+    std::vector<Sample> best(samples.begin(), samples.end());
+    std::sort(best.begin(), best.end(), [](const Sample& l, const Sample& r)
+    {
+        return l.rtt < r.rtt;
+    });
+    best.resize((best.size() + 1) / 2);
+
+    rtt = best.front().rtt;
+
+    Double ml = 0., mo = 0.,
+           minl = best.front().local, maxl = minl;
+    for (const Sample& s : best)
+    {
+        ml += s.local;
+        mo += s.offset;
+        minl = std::min(minl, s.local);
+        maxl = std::max(maxl, s.local);
+    }
+    ml /= best.size();
+    mo /= best.size();
+
+    // least-squares line through offsets
+    if (best.size() >= 3 && maxl - minl >= minFitSpan)
+    {
+        Double cov = 0., var = 0.;
+        for (const Sample& s : best)
+        {
+            cov += (s.local - ml) * (s.offset - mo);
+            var += (s.local - ml) * (s.local - ml);
+        }
+        if (var > 0.)
+            drift = std::max(Double(-1e-3), std::min(Double(1e-3), cov / var));
+    }
+
+    offset = mo;
+    refLocal = ml;
+}
+
+void ClockSync::addSceneTime(Double sceneTime, Double serverTime, bool playing,
+                             Double localTime)
+{
+    std::lock_guard<std::mutex> lock(p_->mutex);
+
+    // no round-trip yet, assume zero latency
+    if (!p_->hasOffset)
+    {
+        p_->offset = serverTime - localTime;
+        p_->refLocal = localTime;
+        p_->drift = 0.;
+        p_->hasOffset = true;
+    }
+
+    if (p_->playing && playing && !p_->anchors.empty())
+    {
+        const Double err = p_->sceneAtServer(serverTime) - sceneTime;
+        if (std::abs(err) > Private::seekThreshold)
+        {
+            p_->anchors.clear();
+            p_->hasLastOut = false;
+        }
+        else
+        {
+            p_->skews.push_back(std::abs(err));
+            while (p_->skews.size() > Private::maxSkews)
+                p_->skews.pop_front();
+        }
+    }
+    else
+    {
+        p_->anchors.clear();
+        p_->hasLastOut = false;
+    }
+
+    Private::Anchor a;
+    a.server = serverTime;
+    a.scene = sceneTime;
+    p_->anchors.push_back(a);
+    while (p_->anchors.size() > Private::maxAnchors)
+        p_->anchors.pop_front();
+
+    p_->playing = playing;
+    p_->lastScene = sceneTime;
+    p_->fitScene();
+}
+
+void ClockSync::Private::fitScene()
+{
+    Double ms = 0., mt = 0.;
+    for (const Anchor& a : anchors)
+    {
+        ms += a.server;
+        mt += a.scene;
+    }
+    ms /= anchors.size();
+    mt /= anchors.size();
+
+    // rate of the server's sample clock
+    sceneRate = 1.;
+    if (anchors.size() >= 3
+            && anchors.back().server - anchors.front().server >= minFitSpan)
+    {
+        Double cov = 0., var = 0.;
+        for (const Anchor& a : anchors)
+        {
+            cov += (a.server - ms) * (a.scene - mt);
+            var += (a.server - ms) * (a.server - ms);
+        }
+        if (var > 0.)
+            sceneRate = std::max(Double(0.98), std::min(Double(1.02), cov / var));
+    }
+
+    refServer = ms;
+    refScene = mt;
+}
+
+
+} // namespace MO
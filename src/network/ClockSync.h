@@ -0,0 +1,111 @@
+/** @file clocksync.h
+
+    @brief Estimation of server clock and scene time on clients
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_CLOCKSYNC_H
+#define MOSRC_NETWORK_CLOCKSYNC_H
+
+#include <cstddef>
+
+#include "types/float.h"
+
+namespace MO {
+
+/** Predicts the server's clock and scene time from the local clock.
+
+    The server clock is estimated NTP-style: each round-trip
+    (client send, server receive, server send, client receive)
+    yields an offset and a round-trip time. A line is fitted through the
+    offsets of the samples with the lowest round-trip times,
+    which gives the current offset and the drift between the two clocks.
+
+    The scene time is anchored by the scene times the server broadcasts
+    together with its clock. While playing, the rate of the server's
+    sample clock relative to the server clock is fitted as well,
+    so clients can render on their own timer at any moment.
+
+    All functions are thread-safe. Times are in seconds,
+    local times should come from systemTime().
+    */
+class ClockSync
+{
+public:
+    ClockSync();
+    ~ClockSync();
+
+    // ------------ getter -------------
+
+    /** At least one round-trip was measured */
+    bool isSynchronized() const;
+
+    /** A scene time was received */
+    bool hasSceneTime() const;
+
+    /** The server's scene is currently playing */
+    bool isPlaying() const;
+
+    /** Number of round-trips in the estimation window */
+    size_t numSamples() const;
+
+    /** Estimated server clock minus local clock */
+    Double offset() const;
+
+    /** Estimated drift of the server clock relative to the local clock
+        (seconds per second) */
+    Double drift() const;
+
+    /** Lowest round-trip time in the estimation window */
+    Double roundTrip() const;
+
+    /** Mean absolute difference between the predicted scene time
+        and the scene time received from the server */
+    Double frameSkew() const;
+
+    /** Maximum absolute difference between the predicted scene time
+        and the scene time received from the server,
+        over the last 64 scene time events */
+    Double maxFrameSkew() const;
+
+    // ----------- prediction ----------
+
+    /** Returns the predicted server clock at local time @p localTime */
+    Double serverTime(Double localTime) const;
+
+    /** Returns the predicted scene time at local time @p localTime.
+        While playing, the returned time never runs backwards
+        by less than a seek. */
+    Double sceneTime(Double localTime) const;
+
+    // ------------- input -------------
+
+    /** Forgets all measurements */
+    void reset();
+
+    /** Adds one round-trip measurement.
+        @p t0 local time when sending the request,
+        @p t1 server time when receiving it,
+        @p t2 server time when sending the response,
+        @p t3 local time when receiving the response */
+    void addRoundTrip(Double t0, Double t1, Double t2, Double t3);
+
+    /** Adds the scene time @p sceneTime that the server had at
+        server clock @p serverTime, received at local time @p localTime.
+        A jump in scene time (seek) restarts the rate estimation. */
+    void addSceneTime(Double sceneTime, Double serverTime, bool playing,
+                      Double localTime);
+
+private:
+
+    struct Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_CLOCKSYNC_H
@@ -0,0 +1,101 @@
+/** @file filemanifest.cpp
+
+    @brief Content hashes of a file and its chunks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <algorithm>
+
+#include <QFile>
+#include <QCryptographicHash>
+
+#include "FileManifest.h"
+#include "io/DataStream.h"
+#include "io/log.h"
+
+namespace MO {
+
+FileManifest::FileManifest()
+    : size_         (0)
+    , chunkSize_    (defaultChunkSize)
+{
+}
+
+void FileManifest::clear()
+{
+    hash_.clear();
+    chunkHashes_.clear();
+    size_ = 0;
+    chunkSize_ = defaultChunkSize;
+}
+
+int FileManifest::chunkBytes(int index) const
+{
+    if (index < 0 || index >= numChunks())
+        return 0;
+    return int(std::min(qint64(chunkSize_), size_ - chunkOffset(index)));
+}
+
+int FileManifest::findChunk(const QByteArray &hash) const
+{
+    for (int i=0; i<numChunks(); ++i)
+        if (chunkHash(i) == hash)
+            return i;
+    return -1;
+}
+
+QByteArray FileManifest::hashData(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+bool FileManifest::create(const QString &filename, int chunkSize)
+{
+    clear();
+
+    QFile f(filename);
+    if (!f.open(QFile::ReadOnly))
+        return false;
+
+    chunkSize_ = std::max(1, chunkSize);
+    size_ = f.size();
+
+    QCryptographicHash whole(QCryptographicHash::Sha1);
+    QByteArray chunk;
+    while (!(chunk = f.read(chunkSize_)).isEmpty())
+    {
+        whole.addData(chunk);
+        chunkHashes_.append(hashData(chunk));
+    }
+
+    if (f.error() != QFile::NoError)
+    {
+        MO_WARNING("FileManifest: error reading '" << filename << "': "
+                   << f.errorString());
+        clear();
+        return false;
+    }
+
+    hash_ = whole.result();
+    return true;
+}
+
+void FileManifest::serialize(IO::DataStream &io) const
+{
+    io.writeHeader("filemanifest", 1);
+    io << hash_ << chunkHashes_ << size_ << qint32(chunkSize_);
+}
+
+void FileManifest::deserialize(IO::DataStream &io)
+{
+    io.readHeader("filemanifest", 1);
+    qint32 cs;
+    io >> hash_ >> chunkHashes_ >> size_ >> cs;
+    chunkSize_ = std::max(1, int(cs));
+}
+
+} // namespace MO
@@ -0,0 +1,92 @@
+/** @file filemanifest.h
+
+    @brief Content hashes of a file and its chunks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_FILEMANIFEST_H
+#define MOSRC_NETWORK_FILEMANIFEST_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace MO {
+namespace IO { class DataStream; }
+
+/** Describes the content of a file for chunked transfer.
+
+    The file is split into chunks of chunkSize() bytes (the last one
+    may be shorter). Each chunk is identified by the SHA-1 hash of its
+    bytes and the whole file by the SHA-1 hash of its content,
+    so equal files and chunks can be found independent of
+    their names and modification times.
+    */
+class FileManifest
+{
+public:
+
+    /** Size of the SHA-1 hashes in bytes */
+    static const int hashSize = 20;
+
+    /** Default chunk size: 1 MiB */
+    static const int defaultChunkSize = 1 << 20;
+
+    FileManifest();
+
+    // ------------ getter -------------
+
+    /** A manifest was created or received */
+    bool isValid() const { return !hash_.isEmpty(); }
+
+    /** Hash of the whole content */
+    const QByteArray& hash() const { return hash_; }
+    /** Hash of the whole content as hex string */
+    QString hashString() const { return QString::fromLatin1(hash_.toHex()); }
+
+    qint64 size() const { return size_; }
+    int chunkSize() const { return chunkSize_; }
+    int numChunks() const { return chunkHashes_.size() / hashSize; }
+
+    qint64 chunkOffset(int index) const { return qint64(index) * chunkSize_; }
+    /** Number of bytes in the chunk */
+    int chunkBytes(int index) const;
+    QByteArray chunkHash(int index) const
+        { return chunkHashes_.mid(index * hashSize, hashSize); }
+
+    /** Returns the index of the chunk with the given hash, or -1 */
+    int findChunk(const QByteArray& hash) const;
+
+    bool operator == (const FileManifest& o) const
+        { return hash_ == o.hash_ && size_ == o.size_; }
+    bool operator != (const FileManifest& o) const { return !(*this == o); }
+
+    // ------------ setter -------------
+
+    void clear();
+
+    /** Reads the file and creates the hashes.
+        Returns false if the file can not be read. */
+    bool create(const QString& filename, int chunkSize = defaultChunkSize);
+
+    /** Returns the hash of some data */
+    static QByteArray hashData(const QByteArray& data);
+
+    // ------------- io ----------------
+
+    void serialize(IO::DataStream&) const;
+    void deserialize(IO::DataStream&);
+
+private:
+
+    QByteArray hash_, chunkHashes_;
+    qint64 size_;
+    int chunkSize_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_FILEMANIFEST_H
@@ -0,0 +1,490 @@
+/** @file fileserver.cpp
+
+    @brief Serves file chunks by content hash on a separate tcp port
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <cstring>
+#include <algorithm>
+
+#include <QMap>
+#include <QList>
+#include <QSet>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QtEndian>
+
+#include "FileServer.h"
+#include "NetworkManager.h"
+#include "netlog.h"
+
+namespace MO {
+
+class FileServer::Private
+{
+public:
+
+    Private(FileServer * p)
+        : p         (p)
+        , server    (new QTcpServer(p))
+        , hasher    (this)
+        , hashStop  (false)
+        , bytesSent (0)
+    { }
+
+    /** Socket buffer that is kept filled per connection */
+    static const qint64 highWater = 4 << 20;
+
+    struct Entry
+    {
+        QString filename;
+        QDateTime time;
+        qint64 size;
+        FileManifest manifest;
+    };
+
+    struct Request
+    {
+        QByteArray hash;
+        quint32 index, count;
+    };
+
+    struct Connection
+    {
+        QTcpSocket * socket;
+        QByteArray input;
+        QList<Request> queue;
+        QFile file;
+    };
+
+    /** Hashes the queued files */
+    class Hasher : public QThread
+    {
+    public:
+        Hasher(Private * p) : p(p) { }
+    protected:
+        void run() Q_DECL_OVERRIDE;
+        Private * p;
+    };
+
+    /** Queues the file for the hash thread */
+    void startHashing(const QString& filename, const QFileInfo& info);
+    /** Moves the finished hashes into entries, emits manifestReady() */
+    void takeHashed();
+
+    /** Returns the entry for the hash if the file is unchanged */
+    const Entry * entryForHash(const QByteArray& hash) const;
+    void onData(Connection * c);
+    /** Sends queued chunks until the socket buffer is full */
+    void pump(Connection * c);
+    QByteArray readChunk(Connection * c, const Entry * e, quint32 index);
+
+    FileServer * p;
+    QTcpServer * server;
+    QMap<QString, Entry> entries;
+    QMap<QByteArray, QString> hashes;
+    QMap<QTcpSocket*, Connection*> connections;
+
+    Hasher hasher;
+    /** Guards hashQueue, hashDone and hashStop */
+    QMutex hashMutex;
+    QWaitCondition hashCond;
+    QList<Entry> hashQueue, hashDone;
+    bool hashStop;
+    /** Files in hashQueue or being hashed */
+    QSet<QString> hashing;
+
+    qint64 bytesSent;
+};
+
+
+
+FileServer::FileServer(QObject *parent)
+    : QObject   (parent)
+    , p_        (new Private(this))
+{
+    MO_NETLOG(CTOR, "FileServer::FileServer(" << parent << ")");
+
+    connect(p_->server, SIGNAL(newConnection()), this, SLOT(onNewConnection_()));
+}
+
+FileServer::~FileServer()
+{
+    MO_NETLOG(CTOR, "FileServer::~FileServer()");
+
+    close();
+
+    {
+        QMutexLocker lock(&p_->hashMutex);
+        p_->hashStop = true;
+        p_->hashCond.wakeAll();
+    }
+    p_->hasher.wait();
+
+    delete p_;
+}
+
+bool FileServer::isListening() const { return p_->server->isListening(); }
+int FileServer::numConnections() const { return p_->connections.size(); }
+qint64 FileServer::bytesSent() const { return p_->bytesSent; }
+
+bool FileServer::open()
+{
+    if (isListening())
+        return true;
+
+    const int port = NetworkManager::defaultFileTcpPort();
+
+    if (!p_->server->listen(QHostAddress::Any, port))
+    {
+        MO_NETLOG(ERROR, "FileServer: failed to start on port " << port << ": "
+                  << p_->server->errorString());
+        return false;
+    }
+
+    MO_NETLOG(EVENT, "FileServer: started listening on port " << port);
+
+    p_->bytesSent = 0;
+    return true;
+}
+
+void FileServer::close()
+{
+    p_->server->close();
+
+    const auto cons = p_->connections;
+    p_->connections.clear();
+    for (auto c : cons)
+    {
+        c->socket->disconnect(this);
+        c->socket->abort();
+        c->socket->deleteLater();
+        delete c;
+    }
+}
+
+FileManifest FileServer::manifest(const QString &fn)
+{
+    // pick up finished hashes without waiting for onHashed_()
+    p_->takeHashed();
+
+    QFileInfo info(fn);
+    if (!info.exists())
+        return FileManifest();
+
+    auto it = p_->entries.find(fn);
+    if (it != p_->entries.end()
+        && it.value().time == info.lastModified()
+        && it.value().size == info.size())
+        return it.value().manifest;
+
+    p_->startHashing(fn, info);
+    return FileManifest();
+}
+
+bool FileServer::isHashing(const QString &fn) const
+{
+    return p_->hashing.contains(fn);
+}
+
+void FileServer::onHashed_()
+{
+    p_->takeHashed();
+}
+
+void FileServer::Private::startHashing(const QString &fn, const QFileInfo &info)
+{
+    if (hashing.contains(fn))
+        return;
+    hashing.insert(fn);
+
+    MO_NETLOG(DEBUG, "FileServer: hashing '" << fn << "'");
+
+    Entry e;
+    e.filename = fn;
+    e.time = info.lastModified();
+    e.size = info.size();
+
+    QMutexLocker lock(&hashMutex);
+    hashQueue.append(e);
+    hashCond.wakeOne();
+    if (!hasher.isRunning())
+        hasher.start(QThread::LowPriority);
+}
+
+void FileServer::Private::Hasher::run()
+{
+    while (true)
+    {
+        Entry e;
+        {
+            QMutexLocker lock(&p->hashMutex);
+            while (!p->hashStop && p->hashQueue.isEmpty())
+                p->hashCond.wait(&p->hashMutex);
+            if (p->hashStop)
+                return;
+            e = p->hashQueue.takeFirst();
+        }
+
+        if (!e.manifest.create(e.filename))
+            e.manifest = FileManifest();
+
+        {
+            QMutexLocker lock(&p->hashMutex);
+            p->hashDone.append(e);
+        }
+        QMetaObject::invokeMethod(p->p, "onHashed_", Qt::QueuedConnection);
+    }
+}
+
+void FileServer::Private::takeHashed()
+{
+    QList<Entry> done;
+    {
+        QMutexLocker lock(&hashMutex);
+        done.swap(hashDone);
+    }
+
+    for (const Entry& e : done)
+    {
+        hashing.remove(e.filename);
+
+        // changed while hashing
+        QFileInfo info(e.filename);
+        if (info.exists() && e.manifest.isValid()
+            && (info.lastModified() != e.time || info.size() != e.size))
+        {
+            startHashing(e.filename, info);
+            continue;
+        }
+
+        if (!e.manifest.isValid() || !info.exists())
+        {
+            MO_NETLOG(ERROR, "FileServer: could not read '" << e.filename << "'");
+            emit p->manifestReady(e.filename, FileManifest());
+            continue;
+        }
+
+        entries.insert(e.filename, e);
+        hashes.insert(e.manifest.hash(), e.filename);
+
+        emit p->manifestReady(e.filename, e.manifest);
+    }
+}
+
+const FileServer::Private::Entry * FileServer::Private::entryForHash(
+        const QByteArray &hash) const
+{
+    auto it = hashes.find(hash);
+    if (it == hashes.end())
+        return 0;
+
+    auto e = entries.find(it.value());
+    if (e == entries.end() || e.value().manifest.hash() != hash)
+        return 0;
+
+    QFileInfo info(e.value().filename);
+    if (info.lastModified() != e.value().time || info.size() != e.value().size)
+        return 0;
+
+    return &e.value();
+}
+
+
+// ------------------------------ protocol -------------------------------------
+
+namespace {
+
+    void appendUInt(QByteArray& a, quint32 v)
+    {
+        uchar buf[4];
+        qToBigEndian(v, buf);
+        a.append(reinterpret_cast<const char*>(buf), 4);
+    }
+
+    quint32 readUInt(const char * data)
+    {
+        return qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(data));
+    }
+
+    QByteArray createMessage(const char * magic, const QByteArray& hash,
+                             quint32 a, quint32 b)
+    {
+        QByteArray m(magic, 4);
+        m.append(hash.left(FileManifest::hashSize));
+        const int hashSize = FileManifest::hashSize;
+        m.append(QByteArray(hashSize - std::min(hashSize, hash.size()), 0));
+        appendUInt(m, a);
+        appendUInt(m, b);
+        return m;
+    }
+
+    bool parseMessage(const char * magic, const char * data,
+                      QByteArray& hash, quint32& a, quint32& b)
+    {
+        if (memcmp(magic, data, 4) != 0)
+            return false;
+        hash = QByteArray(data + 4, FileManifest::hashSize);
+        a = readUInt(data + 4 + FileManifest::hashSize);
+        b = readUInt(data + 8 + FileManifest::hashSize);
+        return true;
+    }
+
+} // namespace
+
+QByteArray FileServer::createRequest(
+        const QByteArray &hash, quint32 index, quint32 count)
+{
+    return createMessage("MOFR", hash, index, count);
+}
+
+bool FileServer::parseRequest(
+        const char *data, QByteArray &hash, quint32 &index, quint32 &count)
+{
+    return parseMessage("MOFR", data, hash, index, count);
+}
+
+QByteArray FileServer::createChunkHeader(
+        const QByteArray &hash, quint32 index, quint32 size)
+{
+    return createMessage("MOFC", hash, index, size);
+}
+
+bool FileServer::parseChunkHeader(
+        const char *data, QByteArray &hash, quint32 &index, quint32 &size)
+{
+    return parseMessage("MOFC", data, hash, index, size);
+}
+
+
+// ---------------------------- connections ------------------------------------
+
+void FileServer::onNewConnection_()
+{
+    while (QTcpSocket * socket = p_->server->nextPendingConnection())
+    {
+        MO_NETLOG(EVENT, "FileServer: new connection from "
+                  << socket->peerAddress().toString());
+
+        auto c = new Private::Connection;
+        c->socket = socket;
+        p_->connections.insert(socket, c);
+
+        connect(socket, &QTcpSocket::readyRead, this, [=]()
+        {
+            p_->onData(c);
+        });
+
+        connect(socket, &QTcpSocket::bytesWritten, this, [=]()
+        {
+            p_->pump(c);
+        });
+
+        connect(socket, &QTcpSocket::disconnected, this, [=]()
+        {
+            MO_NETLOG(EVENT, "FileServer: connection "
+                      << socket->peerAddress().toString() << " closed");
+            if (p_->connections.remove(socket))
+                delete c;
+            socket->deleteLater();
+        });
+    }
+}
+
+void FileServer::Private::onData(Connection * c)
+{
+    c->input.append(c->socket->readAll());
+
+    int pos = 0;
+    while (c->input.size() - pos >= requestSize)
+    {
+        Request r;
+        if (!parseRequest(c->input.constData() + pos, r.hash, r.index, r.count))
+        {
+            MO_NETLOG(ERROR, "FileServer: invalid request from "
+                      << c->socket->peerAddress().toString());
+            c->socket->abort();
+            return;
+        }
+        pos += requestSize;
+
+        MO_NETLOG(EVENT_V2, "FileServer: request " << r.hash.toHex()
+                  << " " << r.index << "+" << r.count);
+        if (r.count)
+            c->queue.append(r);
+    }
+    c->input.remove(0, pos);
+
+    pump(c);
+}
+
+QByteArray FileServer::Private::readChunk(
+        Connection *c, const Entry * e, quint32 index)
+{
+    if (!e || index >= quint32(e->manifest.numChunks()))
+        return QByteArray();
+
+    if (c->file.fileName() != e->filename || !c->file.isOpen())
+    {
+        c->file.close();
+        c->file.setFileName(e->filename);
+        if (!c->file.open(QFile::ReadOnly))
+        {
+            MO_NETLOG(ERROR, "FileServer: could not open '" << e->filename << "'");
+            return QByteArray();
+        }
+    }
+
+    if (!c->file.seek(e->manifest.chunkOffset(index)))
+        return QByteArray();
+
+    QByteArray data = c->file.read(e->manifest.chunkBytes(index));
+    if (data.size() != e->manifest.chunkBytes(index))
+        return QByteArray();
+    return data;
+}
+
+void FileServer::Private::pump(Connection *c)
+{
+    while (!c->queue.isEmpty() && c->socket->bytesToWrite() < highWater)
+    {
+        Request& r = c->queue.first();
+
+        const Entry * e = entryForHash(r.hash);
+        QByteArray data = readChunk(c, e, r.index);
+
+        if (data.isEmpty())
+        {
+            MO_NETLOG(WARNING, "FileServer: chunk " << r.index << " of "
+                      << r.hash.toHex() << " is not available");
+            c->socket->write(createChunkHeader(r.hash, r.index, unavailable));
+            c->queue.removeFirst();
+            continue;
+        }
+
+        c->socket->write(createChunkHeader(r.hash, r.index, data.size()));
+        c->socket->write(data);
+        bytesSent += data.size();
+
+        ++r.index;
+        if (--r.count == 0)
+            c->queue.removeFirst();
+    }
+
+    if (c->queue.isEmpty())
+        c->file.close();
+}
+
+
+} // namespace MO
@@ -0,0 +1,127 @@
+/** @file fileserver.h
+
+    @brief Serves file chunks by content hash on a separate tcp port
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_FILESERVER_H
+#define MOSRC_NETWORK_FILESERVER_H
+
+#include <QObject>
+#include <QByteArray>
+
+#include "FileManifest.h"
+
+class QTcpSocket;
+
+namespace MO {
+
+/** Tcp listener for chunked file transfers.
+
+    The file transfers run on their own port (Network/fileport)
+    so large files don't block the events on the control connection.
+
+    Files are made available through manifest(), which the ServerEngine
+    calls when answering NetEventRequest::GET_SERVER_FILE_TIME.
+    Files are hashed on a separate thread, the ServerEngine answers
+    once manifestReady() is emitted.
+    Clients then request chunks by the content hash of the file.
+
+    Protocol (all integers big endian):
+    @code
+    request:  "MOFR" hash[20] quint32 firstChunk quint32 numChunks
+    response: "MOFC" hash[20] quint32 chunk quint32 size data[size]
+    @endcode
+    One response is sent per requested chunk, in request order.
+    A size of unavailable means the file is gone or has changed.
+
+    Each connection has its own queue which is only filled up to a
+    few megabytes of socket buffer, so any number of clients is
+    served in parallel.
+    */
+class FileServer : public QObject
+{
+    Q_OBJECT
+public:
+
+    /** Bytes of a chunk request */
+    static const int requestSize = 32;
+    /** Bytes of the header in front of each chunk */
+    static const int chunkHeaderSize = 32;
+    /** Chunk size in header for missing files */
+    static const quint32 unavailable = 0xffffffff;
+
+    explicit FileServer(QObject *parent = 0);
+    ~FileServer();
+
+    // --------------- info ----------------
+
+    bool isListening() const;
+
+    /** Number of connected clients */
+    int numConnections() const;
+
+    /** Number of payload bytes sent since open() */
+    qint64 bytesSent() const;
+
+    /** Returns the manifest for a local file and makes the file
+        available for transfer.
+        The manifest is cached as long as time and size of the file
+        do not change. Otherwise the file is hashed on a separate thread,
+        an invalid manifest is returned and manifestReady() is emitted
+        when done. Also returns an invalid manifest if the file
+        does not exist. */
+    FileManifest manifest(const QString& localFilename);
+
+    /** The file is queued or being hashed */
+    bool isHashing(const QString& localFilename) const;
+
+    // ------------- protocol --------------
+
+    /** Returns a request for @p count chunks starting at @p index */
+    static QByteArray createRequest(const QByteArray& hash, quint32 index, quint32 count);
+
+    /** Reads a request, returns false if @p data is no request */
+    static bool parseRequest(const char * data, QByteArray& hash,
+                             quint32& index, quint32& count);
+
+    /** Returns the header for a chunk response */
+    static QByteArray createChunkHeader(const QByteArray& hash, quint32 index, quint32 size);
+
+    /** Reads a chunk header, returns false if @p data is no chunk header */
+    static bool parseChunkHeader(const char * data, QByteArray& hash,
+                                 quint32& index, quint32& size);
+
+signals:
+
+    /** A file requested with manifest() has been hashed.
+        @p manifest is invalid if the file could not be read. */
+    void manifestReady(const QString& localFilename,
+                       const MO::FileManifest& manifest);
+
+public slots:
+
+    /** Starts listening on the port from settings. Returns success. */
+    bool open();
+    /** Stops listening and closes all connections */
+    void close();
+
+private slots:
+
+    void onNewConnection_();
+    /** Takes the results of the hash thread */
+    void onHashed_();
+
+private:
+
+    class Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_FILESERVER_H
@@ -0,0 +1,538 @@
+/** @file filetransfer.cpp
+
+    @brief Chunked, resumable download of files from the FileServer
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <algorithm>
+
+#include <QMap>
+#include <QSet>
+#include <QFile>
+#include <QFileInfo>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+
+#include "FileTransfer.h"
+#include "FileServer.h"
+#include "netlog.h"
+
+namespace MO {
+
+class FileTransfer::Private
+{
+public:
+
+    Private(FileTransfer * p)
+        : p             (p)
+        , socket        (new QTcpSocket(p))
+        , port          (0)
+        , active        (false)
+        , errors        (0)
+        , haveHeader    (false)
+        , hdrIndex      (0)
+        , hdrSize       (0)
+        , bytesDone     (0)
+        , bytesTotal    (0)
+        , bytesReceived (0)
+        , rateBytes     (0)
+        , rate          (0.)
+    { }
+
+    /** Chunks with wrong hashes until a file is given up */
+    static const int maxErrors = 3;
+    /** Milliseconds between progress() signals */
+    static const int progressInterval = 500;
+
+    struct Job
+    {
+        QString serverFilename, localFilename, previousFilename;
+        FileManifest manifest;
+    };
+
+    /** Prepares the next job and requests its chunks */
+    void startNext();
+    void sendRequests();
+    void receiveChunk(const QByteArray& hash, quint32 index, const QByteArray& data);
+    void finishCurrent();
+    void failCurrent();
+    void failAll();
+    void updateProgress(bool force);
+
+    FileTransfer * p;
+    QTcpSocket * socket;
+    QHostAddress address;
+    int port;
+
+    QList<Job> queue;
+    /** First job in queue is prepared and in transfer */
+    bool active;
+    QList<int> todo;
+    QSet<int> inFlight;
+    int errors;
+    QFile part;
+
+    bool haveHeader;
+    QByteArray hdrHash;
+    quint32 hdrIndex, hdrSize;
+
+    qint64 bytesDone, bytesTotal, bytesReceived, rateBytes;
+    double rate;
+    QElapsedTimer rateTimer, progressTimer;
+};
+
+
+
+FileTransfer::FileTransfer(QObject *parent)
+    : QObject   (parent)
+    , p_        (new Private(this))
+{
+    connect(p_->socket, SIGNAL(connected()), this, SLOT(onConnected_()));
+    connect(p_->socket, SIGNAL(readyRead()), this, SLOT(onData_()));
+    connect(p_->socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            this, SLOT(onError_()));
+}
+
+FileTransfer::~FileTransfer()
+{
+    cancel();
+    delete p_;
+}
+
+int FileTransfer::numPendingFiles() const { return p_->queue.size(); }
+qint64 FileTransfer::bytesDone() const { return p_->bytesDone; }
+qint64 FileTransfer::bytesTotal() const { return p_->bytesTotal; }
+qint64 FileTransfer::bytesReceived() const { return p_->bytesReceived; }
+double FileTransfer::bytesPerSecond() const { return p_->rate; }
+
+QString FileTransfer::partFilename(const QString &localFilename)
+{
+    return localFilename + ".part";
+}
+
+void FileTransfer::setServerAddress(const QHostAddress &address, int port)
+{
+    if (address == p_->address && port == p_->port)
+        return;
+
+    p_->address = address;
+    p_->port = port;
+    // reconnect on next request
+    if (p_->socket->state() != QAbstractSocket::UnconnectedState)
+        p_->socket->abort();
+}
+
+void FileTransfer::download(const QString &serverFilename,
+                            const FileManifest &manifest,
+                            const QString &localFilename,
+                            const QString &previousFilename)
+{
+    for (const Private::Job& j : p_->queue)
+        if (j.serverFilename == serverFilename && j.manifest == manifest)
+            return;
+
+    MO_NETLOG(DEBUG, "FileTransfer::download('" << serverFilename << "', "
+              << manifest.hashString() << ")");
+
+    if (p_->queue.isEmpty())
+    {
+        p_->bytesDone = p_->bytesTotal = p_->bytesReceived = p_->rateBytes = 0;
+        p_->rate = 0.;
+        p_->rateTimer.start();
+        p_->progressTimer.start();
+    }
+
+    Private::Job j;
+    j.serverFilename = serverFilename;
+    j.manifest = manifest;
+    j.localFilename = localFilename;
+    j.previousFilename = previousFilename;
+    p_->queue.append(j);
+    p_->bytesTotal += manifest.size();
+
+    if (!p_->active)
+        p_->startNext();
+}
+
+void FileTransfer::cancel()
+{
+    p_->part.close();
+    p_->queue.clear();
+    p_->todo.clear();
+    p_->inFlight.clear();
+    p_->active = false;
+    p_->haveHeader = false;
+    p_->rate = 0.;
+    p_->socket->abort();
+}
+
+
+// ------------------------------ transfer -------------------------------------
+
+void FileTransfer::Private::startNext()
+{
+    while (!active && !queue.isEmpty())
+    {
+        const Job& j = queue.first();
+
+        qint64 reused = 0;
+        if (!prepareFile(j.manifest, partFilename(j.localFilename),
+                         j.previousFilename, todo, &reused))
+        {
+            MO_NETLOG(ERROR, "FileTransfer: could not write '"
+                      << partFilename(j.localFilename) << "'");
+            failCurrent();
+            continue;
+        }
+
+        bytesDone += reused;
+        errors = 0;
+        inFlight.clear();
+
+        MO_NETLOG(DEBUG, "FileTransfer: '" << j.serverFilename << "' needs "
+                  << todo.size() << " of " << j.manifest.numChunks() << " chunks");
+
+        if (todo.isEmpty())
+        {
+            active = true;
+            finishCurrent();
+            continue;
+        }
+
+        part.setFileName(partFilename(j.localFilename));
+        if (!part.open(QFile::ReadWrite))
+        {
+            failCurrent();
+            continue;
+        }
+
+        active = true;
+
+        if (socket->state() == QAbstractSocket::ConnectedState)
+            sendRequests();
+        else if (socket->state() == QAbstractSocket::UnconnectedState)
+        {
+            MO_NETLOG(DEBUG, "FileTransfer: connecting to "
+                      << address.toString() << ":" << port);
+            haveHeader = false;
+            socket->connectToHost(address, port);
+        }
+    }
+
+    if (queue.isEmpty())
+    {
+        rate = 0.;
+        updateProgress(true);
+    }
+}
+
+void FileTransfer::Private::sendRequests()
+{
+    if (!active)
+        return;
+
+    const QByteArray& hash = queue.first().manifest.hash();
+
+    while (!todo.isEmpty() && inFlight.size() < maxChunksInFlight)
+    {
+        // request consecutive chunks at once
+        const int first = todo.takeFirst();
+        int count = 1;
+        inFlight.insert(first);
+        while (!todo.isEmpty() && inFlight.size() < maxChunksInFlight
+               && todo.first() == first + count)
+        {
+            inFlight.insert(todo.takeFirst());
+            ++count;
+        }
+
+        socket->write(FileServer::createRequest(hash, first, count));
+    }
+}
+
+void FileTransfer::onConnected_()
+{
+    MO_NETLOG(EVENT, "FileTransfer: connected to "
+              << p_->address.toString() << ":" << p_->port);
+
+    // resend everything that was in flight on a previous connection
+    for (auto i : p_->inFlight)
+        p_->todo.append(i);
+    p_->inFlight.clear();
+    std::sort(p_->todo.begin(), p_->todo.end());
+
+    p_->sendRequests();
+}
+
+void FileTransfer::onError_()
+{
+    // server closes idle connections, that's fine
+    if (p_->queue.isEmpty())
+        return;
+
+    MO_NETLOG(ERROR, "FileTransfer: connection error: " << p_->socket->errorString());
+
+    p_->failAll();
+}
+
+void FileTransfer::onData_()
+{
+    QTcpSocket * s = p_->socket;
+
+    while (true)
+    {
+        if (!p_->haveHeader)
+        {
+            if (s->bytesAvailable() < FileServer::chunkHeaderSize)
+                return;
+
+            const QByteArray head = s->read(FileServer::chunkHeaderSize);
+            if (!FileServer::parseChunkHeader(head.constData(), p_->hdrHash,
+                                              p_->hdrIndex, p_->hdrSize))
+            {
+                MO_NETLOG(ERROR, "FileTransfer: invalid data from server");
+                s->abort();
+                p_->failAll();
+                return;
+            }
+
+            if (p_->hdrSize == FileServer::unavailable)
+            {
+                if (p_->active && p_->hdrHash == p_->queue.first().manifest.hash())
+                {
+                    MO_NETLOG(WARNING, "FileTransfer: '"
+                              << p_->queue.first().serverFilename
+                              << "' is not available on server");
+                    p_->failCurrent();
+                    p_->startNext();
+                }
+                continue;
+            }
+
+            p_->haveHeader = true;
+        }
+
+        if (s->bytesAvailable() < p_->hdrSize)
+            return;
+
+        p_->haveHeader = false;
+        p_->receiveChunk(p_->hdrHash, p_->hdrIndex, s->read(p_->hdrSize));
+    }
+}
+
+void FileTransfer::Private::receiveChunk(
+        const QByteArray &hash, quint32 index, const QByteArray &data)
+{
+    bytesReceived += data.size();
+
+    // answer to a failed or cancelled file
+    if (!active || hash != queue.first().manifest.hash()
+            || !inFlight.remove(index))
+        return;
+
+    const FileManifest& m = queue.first().manifest;
+
+    if (data.size() != m.chunkBytes(index)
+        || FileManifest::hashData(data) != m.chunkHash(index))
+    {
+        MO_NETLOG(WARNING, "FileTransfer: chunk " << index << " of '"
+                  << queue.first().serverFilename << "' is corrupt");
+        if (++errors > maxErrors)
+        {
+            failCurrent();
+            startNext();
+            return;
+        }
+        todo.prepend(index);
+        sendRequests();
+        return;
+    }
+
+    if (!part.seek(m.chunkOffset(index)) || part.write(data) != data.size())
+    {
+        MO_NETLOG(ERROR, "FileTransfer: could not write '" << part.fileName() << "'");
+        failCurrent();
+        startNext();
+        return;
+    }
+
+    bytesDone += data.size();
+    updateProgress(false);
+
+    if (todo.isEmpty() && inFlight.isEmpty())
+    {
+        finishCurrent();
+        startNext();
+    }
+    else
+        sendRequests();
+}
+
+void FileTransfer::Private::finishCurrent()
+{
+    part.close();
+
+    const Job j = queue.takeFirst();
+    active = false;
+    todo.clear();
+    inFlight.clear();
+
+    if (!finishFile(j.manifest, partFilename(j.localFilename), j.localFilename))
+    {
+        MO_NETLOG(ERROR, "FileTransfer: content of '" << j.serverFilename
+                  << "' does not match");
+        emit p->fileFailed(j.serverFilename);
+        return;
+    }
+
+    MO_NETLOG(DEBUG, "FileTransfer: received '" << j.serverFilename << "'");
+
+    updateProgress(true);
+    emit p->fileFinished(j.serverFilename, j.localFilename);
+}
+
+void FileTransfer::Private::failCurrent()
+{
+    // part file is kept for resume
+    part.close();
+
+    const Job j = queue.takeFirst();
+    bytesTotal -= j.manifest.size();
+    active = false;
+    todo.clear();
+    inFlight.clear();
+
+    emit p->fileFailed(j.serverFilename);
+}
+
+void FileTransfer::Private::failAll()
+{
+    part.close();
+
+    const auto jobs = queue;
+    queue.clear();
+    todo.clear();
+    inFlight.clear();
+    active = false;
+    haveHeader = false;
+    rate = 0.;
+
+    for (const Job& j : jobs)
+        emit p->fileFailed(j.serverFilename);
+
+    updateProgress(true);
+}
+
+void FileTransfer::Private::updateProgress(bool force)
+{
+    if (!force && progressTimer.elapsed() < progressInterval)
+        return;
+
+    const qint64 ms = rateTimer.elapsed();
+    if (ms > 0 && !queue.isEmpty())
+    {
+        rate = double(bytesReceived - rateBytes) * 1000. / ms;
+        rateBytes = bytesReceived;
+        rateTimer.start();
+    }
+
+    progressTimer.start();
+    emit p->progress();
+}
+
+
+// ----------------------------- file helpers ----------------------------------
+
+bool FileTransfer::prepareFile(const FileManifest &m,
+                               const QString &partFilename,
+                               const QString &previousFilename,
+                               QList<int> &missing, qint64 *bytesReused)
+{
+    missing.clear();
+    qint64 reused = 0;
+
+    QFile part(partFilename);
+    if (!part.open(QFile::ReadWrite))
+        return false;
+
+    // keep what is already there from an interrupted transfer
+    const qint64 existing = part.size();
+    if (!part.resize(m.size()))
+        return false;
+
+    QList<int> todo;
+    for (int i=0; i<m.numChunks(); ++i)
+    {
+        if (m.chunkOffset(i) + m.chunkBytes(i) <= existing
+            && part.seek(m.chunkOffset(i))
+            && FileManifest::hashData(part.read(m.chunkBytes(i))) == m.chunkHash(i))
+        {
+            reused += m.chunkBytes(i);
+            continue;
+        }
+        todo << i;
+    }
+
+    // find unchanged chunks in the previous version
+    QFile prev(previousFilename);
+    if (!todo.isEmpty() && !previousFilename.isEmpty()
+        && QFileInfo(previousFilename) != QFileInfo(partFilename)
+        && prev.open(QFile::ReadOnly))
+    {
+        QMap<QByteArray, qint64> offsets;
+        QByteArray data;
+        for (qint64 pos = 0; !(data = prev.read(m.chunkSize())).isEmpty();
+             pos += data.size())
+        {
+            const QByteArray hash = FileManifest::hashData(data);
+            if (!offsets.contains(hash))
+                offsets.insert(hash, pos);
+        }
+
+        for (auto i : todo)
+        {
+            auto it = offsets.find(m.chunkHash(i));
+            if (it != offsets.end() && prev.seek(it.value()))
+            {
+                data = prev.read(m.chunkBytes(i));
+                if (part.seek(m.chunkOffset(i)) && part.write(data) == data.size())
+                {
+                    reused += data.size();
+                    continue;
+                }
+            }
+            missing << i;
+        }
+    }
+    else
+        missing = todo;
+
+    if (bytesReused)
+        *bytesReused = reused;
+
+    return part.error() == QFile::NoError;
+}
+
+bool FileTransfer::finishFile(const FileManifest &manifest,
+                              const QString &partFilename,
+                              const QString &localFilename)
+{
+    FileManifest check;
+    if (!check.create(partFilename, manifest.chunkSize()) || check != manifest)
+    {
+        QFile::remove(partFilename);
+        return false;
+    }
+
+    if (QFile::exists(localFilename) && !QFile::remove(localFilename))
+        return false;
+
+    return QFile::rename(partFilename, localFilename);
+}
+
+
+} // namespace MO
@@ -0,0 +1,127 @@
+/** @file filetransfer.h
+
+    @brief Chunked, resumable download of files from the FileServer
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_FILETRANSFER_H
+#define MOSRC_NETWORK_FILETRANSFER_H
+
+#include <QObject>
+#include <QList>
+#include <QHostAddress>
+
+#include "FileManifest.h"
+
+namespace MO {
+
+/** Client side of the FileServer protocol.
+
+    Files are queued with download() and fetched one after another
+    over a single connection to the FileServer, with several chunk
+    requests in flight.
+
+    The data is written to a <i>filename.part</i> file. Chunks that
+    are already correct in the part file (a previously interrupted
+    transfer) or in the previous version of the file are not
+    requested again. Each received chunk and finally the whole file
+    is checked against the hashes in the manifest before the part
+    file replaces the destination.
+    */
+class FileTransfer : public QObject
+{
+    Q_OBJECT
+public:
+
+    /** Number of chunk requests that are sent ahead */
+    static const int maxChunksInFlight = 8;
+
+    explicit FileTransfer(QObject *parent = 0);
+    ~FileTransfer();
+
+    // --------------- info ----------------
+
+    /** Files queued or in transfer */
+    int numPendingFiles() const;
+
+    /** Bytes of the queued files that are present.
+        The counters restart when a file is queued after the
+        previous queue was finished. */
+    qint64 bytesDone() const;
+    /** Bytes of all queued files */
+    qint64 bytesTotal() const;
+    /** Bytes received from the server */
+    qint64 bytesReceived() const;
+    /** Current download speed in bytes per second */
+    double bytesPerSecond() const;
+
+    // -------------- setter ---------------
+
+    /** Sets the host of the FileServer */
+    void setServerAddress(const QHostAddress& address, int port);
+
+    /** Queues a file for download.
+        @p previousFilename can be an older version of the file
+        which is searched for unchanged chunks. */
+    void download(const QString& serverFilename, const FileManifest& manifest,
+                  const QString& localFilename,
+                  const QString& previousFilename = QString());
+
+    /** Stops all transfers, the part files are kept for resume */
+    void cancel();
+
+    // ------------ file helpers -----------
+
+    /** Name of the temporary file for a download */
+    static QString partFilename(const QString& localFilename);
+
+    /** Prepares the part file for a transfer and returns the
+        indices of the chunks that still need to be received.
+        Correct chunks already in the part file are kept, other
+        chunks are copied from @p previousFilename if a chunk
+        at a chunk boundary of that file has a matching hash.
+        @p bytesReused receives the number of bytes that don't
+        need a transfer. Returns false if the part file can not
+        be written. */
+    static bool prepareFile(const FileManifest& manifest,
+                            const QString& partFilename,
+                            const QString& previousFilename,
+                            QList<int>& missingChunks,
+                            qint64 * bytesReused = 0);
+
+    /** Checks the whole content hash of the part file and
+        renames it to @p localFilename. Returns success. */
+    static bool finishFile(const FileManifest& manifest,
+                           const QString& partFilename,
+                           const QString& localFilename);
+
+signals:
+
+    /** The file was received and verified */
+    void fileFinished(const QString& serverFilename, const QString& localFilename);
+
+    /** The file could not be received */
+    void fileFailed(const QString& serverFilename);
+
+    /** Emitted at most twice a second during transfers */
+    void progress();
+
+private slots:
+
+    void onConnected_();
+    void onData_();
+    void onError_();
+
+private:
+
+    class Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_FILETRANSFER_H
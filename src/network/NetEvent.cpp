@@ -17,6 +17,7 @@
 #include "io/DataStream.h"
 #include "io/error.h"
 #include "network/netlog.h"
+#include "network/SceneDelta.h"
 #include "io/systeminfo.h"
 #include "object/util/ObjectFactory.h"
 #include "object/Scene.h"
@@ -131,6 +132,7 @@ QString NetEventRequest::requestName(Request r)
         case GET_SERVER_FILE: return "GET_SERVER_FILE";
         case CLEAR_FILE_CACHE: return "CLEAR_FILE_CACHE";
         case CLOSE_CONNECTION: return "CLOSE_CONNECTION";
+        case GET_SCENE: return "GET_SCENE";
     }
     return "*UNKNOWN*";
 }
@@ -254,11 +256,13 @@ QString NetEventFileInfo::infoName() const
 void NetEventFileInfo::serialize(IO::DataStream &io) const
 {
     io << filename_ << time_ << present_;
+    manifest_.serialize(io);
 }
 
 void NetEventFileInfo::deserialize(IO::DataStream &io)
 {
     io >> filename_ >> time_ >> present_;
+    manifest_.deserialize(io);
 }
 
 void NetEventFileInfo::getFileTime()
@@ -337,22 +341,24 @@ bool NetEventFile::saveFile(const QString &fn) const
 MO_REGISTER_NETEVENT(NetEventScene)
 
 NetEventScene::NetEventScene()
+    : version_      (0)
 {
 }
 
 QString NetEventScene::infoName() const
 {
-    return AbstractNetEvent::infoName() + "(" + byte_to_string(data_.size()) + ")";
+    return AbstractNetEvent::infoName() + "(" + byte_to_string(data_.size())
+            + ", v" + QString::number(version_) + ")";
 }
 
 void NetEventScene::serialize(IO::DataStream &io) const
 {
-    io << data_;
+    io << data_ << version_;
 }
 
 void NetEventScene::deserialize(IO::DataStream &io)
 {
-    io >> data_;
+    io >> data_ >> version_;
 }
 
 bool NetEventScene::setScene(const Scene *scene)
@@ -392,6 +398,59 @@ Scene * NetEventScene::getScene() const
 
 
 
+MO_REGISTER_NETEVENT(NetEventSceneDelta)
+
+NetEventSceneDelta::NetEventSceneDelta()
+    : baseVersion_  (0)
+    , version_      (0)
+{
+}
+
+QString NetEventSceneDelta::infoName() const
+{
+    return AbstractNetEvent::infoName() + "(v" + QString::number(baseVersion_)
+            + "->" + QString::number(version_)
+            + ", " + byte_to_string(data_.size()) + ")";
+}
+
+void NetEventSceneDelta::serialize(IO::DataStream &io) const
+{
+    io << baseVersion_ << version_ << data_;
+}
+
+void NetEventSceneDelta::deserialize(IO::DataStream &io)
+{
+    io >> baseVersion_ >> version_ >> data_;
+}
+
+void NetEventSceneDelta::setDelta(const SceneDelta &delta)
+{
+    data_.clear();
+    IO::DataStream io(&data_, QIODevice::WriteOnly);
+    delta.serialize(io);
+}
+
+bool NetEventSceneDelta::getDelta(SceneDelta &delta) const
+{
+    IO::DataStream io(data_);
+    try
+    {
+        delta.deserialize(io);
+        return true;
+    }
+    catch (const Exception& e)
+    {
+        MO_NETLOG(ERROR, "Error on NetEventSceneDelta::getDelta()\n"
+                  << e.what());
+    }
+    return false;
+}
+
+
+
+
+
+
 
 MO_REGISTER_NETEVENT(NetEventClientState)
 
@@ -449,6 +508,9 @@ void NetEventAudioConfig::deserialize(IO::DataStream &io)
 MO_REGISTER_NETEVENT(NetEventTime)
 
 NetEventTime::NetEventTime()
+    : time_         (0.)
+    , serverTime_   (0.)
+    , isPlaying_    (false)
 {
 }
 
@@ -459,12 +521,57 @@ QString NetEventTime::infoName() const
 
 void NetEventTime::serialize(IO::DataStream &io) const
 {
-    io << time_;
+    // version 1 wrote only the scene time, without header
+    io.writeHeader("time", 2);
+
+    io << time_ << serverTime_ << isPlaying_;
 }
 
 void NetEventTime::deserialize(IO::DataStream &io)
 {
-    io >> time_;
+    // the first version wrote only the scene time, without header,
+    // as the last value in the packet
+    if (io.device() && io.device()->bytesAvailable() == qint64(sizeof(time_)))
+    {
+        io >> time_;
+        serverTime_ = 0.;
+        isPlaying_ = false;
+        return;
+    }
+
+    io.readHeader("time", 2);
+
+    io >> time_ >> serverTime_ >> isPlaying_;
+}
+
+
+
+
+
+
+MO_REGISTER_NETEVENT(NetEventClockSync)
+
+NetEventClockSync::NetEventClockSync()
+    : clientSendTime_       (0.)
+    , serverReceiveTime_    (0.)
+    , serverSendTime_       (0.)
+{
+}
+
+QString NetEventClockSync::infoName() const
+{
+    return AbstractNetEvent::infoName()
+            + "(" + QString::number(clientSendTime_) + ")";
+}
+
+void NetEventClockSync::serialize(IO::DataStream &io) const
+{
+    io << clientSendTime_ << serverReceiveTime_ << serverSendTime_;
+}
+
+void NetEventClockSync::deserialize(IO::DataStream &io)
+{
+    io >> clientSendTime_ >> serverReceiveTime_ >> serverSendTime_;
 }
 
 
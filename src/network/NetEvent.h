@@ -20,6 +20,7 @@
 
 #include "io/systeminfo.h"
 #include "ClientState.h"
+#include "FileManifest.h"
 #include "types/float.h"
 #include "audio/Configuration.h"
 #include "network/netlog.h"
@@ -30,6 +31,7 @@ class QAbstractSocket;
 namespace MO {
 
 class Scene;
+class SceneDelta;
 
 namespace IO { class DataStream; }
 
@@ -161,7 +163,10 @@ public:
         /** Signals the client to clear all it's file cache (e.g. delete all files in ./data/cache. */
         CLEAR_FILE_CACHE,
         /** The server sends this before stopping to listen. */
-        CLOSE_CONNECTION
+        CLOSE_CONNECTION,
+        /** Tells server to send a NetEventScene with the current version,
+            sent by clients that could not apply a NetEventSceneDelta */
+        GET_SCENE
     };
 
     static QString requestName(Request);
@@ -278,11 +283,16 @@ public:
     /** File was found? */
     bool isPresent() const { return present_; }
 
+    /** Content hashes for a transfer through the FileServer.
+        Invalid if the server can not provide the file that way. */
+    const FileManifest& manifest() const { return manifest_; }
+
     // --------- setter -------------------
 
     void setFilename(const QString& fn) { filename_ = fn; }
     void setTime(const QDateTime& t) { time_ = t; }
     void setPresent(bool p) { present_ = p; }
+    void setManifest(const FileManifest& m) { manifest_ = m; }
 
     /** Convenience function - sets all necessary data */
     void getFileTime();
@@ -292,6 +302,7 @@ private:
     QString filename_;
     QDateTime time_;
     bool present_;
+    FileManifest manifest_;
 };
 
 
@@ -353,15 +364,52 @@ public:
         On errors, NULL is returned. */
     Scene * getScene() const;
 
+    /** The version of the scene for following NetEventSceneDelta events */
+    quint32 version() const { return version_; }
+
     // --------- setter -------------------
 
     /** Serializes the scene object.
         Returns success. Throws nothing. */
     bool setScene(const Scene * scene);
 
+    void setVersion(quint32 v) { version_ = v; }
+
 private:
 
     QByteArray data_;
+    quint32 version_;
+};
+
+
+/** Sends the edits that turn version baseVersion() of the scene
+    into version version() */
+class NetEventSceneDelta : public AbstractNetEvent
+{
+public:
+    MO_NETEVENT_CONSTRUCTOR(NetEventSceneDelta)
+
+    // --------- getter -------------------
+
+    quint32 baseVersion() const { return baseVersion_; }
+    quint32 version() const { return version_; }
+
+    /** Deserializes the edits into @p delta.
+        Returns success. Throws nothing. */
+    bool getDelta(SceneDelta & delta) const;
+
+    // --------- setter -------------------
+
+    void setVersions(quint32 baseVersion, quint32 version)
+        { baseVersion_ = baseVersion; version_ = version; }
+
+    /** Serializes the edits. */
+    void setDelta(const SceneDelta & delta);
+
+private:
+
+    QByteArray data_;
+    quint32 baseVersion_, version_;
 };
 
 
@@ -403,7 +451,9 @@ private:
 };
 
 
-/** Sends the current scene time to clients. */
+/** Sends the current scene time to clients.
+    The server's systemTime() at sending and the playback state
+    let clients predict the scene time with ClockSync. */
 class NetEventTime : public AbstractNetEvent
 {
 public:
@@ -412,14 +462,45 @@ public:
     // --------- getter -------------------
 
     Double time() { return time_; }
+    Double serverTime() { return serverTime_; }
+    bool isPlaying() { return isPlaying_; }
 
     // --------- setter -------------------
 
     void setTime(Double t) { time_ = t; }
+    void setServerTime(Double t) { serverTime_ = t; }
+    void setPlaying(bool p) { isPlaying_ = p; }
+
+private:
+
+    Double time_, serverTime_;
+    bool isPlaying_;
+};
+
+
+/** Round-trip clock measurement.
+    The client sends its systemTime(), the server responds with the
+    same event and adds its systemTime() at receiving and sending. */
+class NetEventClockSync : public AbstractNetEvent
+{
+public:
+    MO_NETEVENT_CONSTRUCTOR(NetEventClockSync)
+
+    // --------- getter -------------------
+
+    Double clientSendTime() { return clientSendTime_; }
+    Double serverReceiveTime() { return serverReceiveTime_; }
+    Double serverSendTime() { return serverSendTime_; }
+
+    // --------- setter -------------------
+
+    void setClientSendTime(Double t) { clientSendTime_ = t; }
+    void setServerTimes(Double receive, Double send)
+        { serverReceiveTime_ = receive; serverSendTime_ = send; }
 
 private:
 
-    Double time_;
+    Double clientSendTime_, serverReceiveTime_, serverSendTime_;
 };
 
 
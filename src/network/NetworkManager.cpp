@@ -53,6 +53,11 @@ int NetworkManager::defaultTcpPort()
     return settings()->getValue("Network/tcpport").toInt();
 }
 
+int NetworkManager::defaultFileTcpPort()
+{
+    return settings()->getValue("Network/fileport").toInt();
+}
+
 
 QString NetworkManager::systemInfo() const
 {
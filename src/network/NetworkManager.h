@@ -44,6 +44,9 @@ public:
     /** Returns the udp port from settings */
     static int defaultTcpPort();
 
+    /** Returns the tcp port for file transfers from settings */
+    static int defaultFileTcpPort();
+
     /** Returns a list of all networks available */
     QString systemInfo() const;
 
@@ -0,0 +1,504 @@
+/** @file scenedelta.cpp
+
+    @brief List of edits to replicate a Scene incrementally
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <algorithm>
+
+#include <QHash>
+#include <QSet>
+
+#include "SceneDelta.h"
+#include "object/Scene.h"
+#include "object/param/Parameters.h"
+#include "object/param/Parameter.h"
+#include "object/util/ObjectFactory.h"
+#include "object/util/AudioObjectConnections.h"
+#include "object/util/SceneLock_p.h"
+#include "io/DataStream.h"
+#include "io/error.h"
+
+namespace MO {
+
+SceneDelta::SceneDelta()
+{
+}
+
+bool SceneDelta::isStructural() const
+{
+    for (const Operation& op : ops_)
+        if (op.type == OP_ADD || op.type == OP_DELETE || op.type == OP_MOVE
+                || op.type == OP_AUDIO_CONNECTIONS)
+            return true;
+    return false;
+}
+
+int SceneDelta::numBytes() const
+{
+    int bytes = 0;
+    for (const Operation& op : ops_)
+        bytes += 9 + (op.id.size() + op.target.size()) * 2 + op.data.size();
+    return bytes;
+}
+
+// ------------------------------ recording ------------------------------------
+
+void SceneDelta::append_(const Operation& op)
+{
+    if (op.type != OP_ADD && op.type != OP_DELETE)
+    {
+        for (int i = ops_.size() - 1; i >= 0; --i)
+        {
+            Operation& o = ops_[i];
+            if (o.type == op.type && o.id == op.id
+                && (op.type != OP_PARAMETER || o.target == op.target))
+            {
+                o = op;
+                return;
+            }
+            // don't merge across tree edits
+            if (o.type == OP_ADD || o.type == OP_DELETE || o.type == OP_MOVE)
+                break;
+        }
+    }
+
+    ops_.append(op);
+}
+
+void SceneDelta::addObject(const Object * o)
+{
+    MO_ASSERT(o->parentObject(), "SceneDelta::addObject(" << o << ") without parent");
+
+    Operation op;
+    op.type = OP_ADD;
+    op.id = o->idName();
+    op.target = o->parentObject()->idName();
+    op.index = o->parentObject()->childObjects().indexOf(const_cast<Object*>(o));
+
+    IO::DataStream io(&op.data, QIODevice::WriteOnly);
+    ObjectFactory::saveObject(io, o);
+
+    append_(op);
+}
+
+void SceneDelta::deleteObject(const Object * o)
+{
+    Operation op;
+    op.type = OP_DELETE;
+    op.id = o->idName();
+    op.index = -1;
+
+    append_(op);
+}
+
+void SceneDelta::moveObject(const Object * o)
+{
+    if (!o->parentObject())
+        return;
+
+    Operation op;
+    op.type = OP_MOVE;
+    op.id = o->idName();
+    op.target = o->parentObject()->idName();
+    op.index = o->parentObject()->childObjects().indexOf(const_cast<Object*>(o));
+
+    append_(op);
+}
+
+void SceneDelta::setObjectName(const Object * o)
+{
+    Operation op;
+    op.type = OP_NAME;
+    op.id = o->idName();
+    op.target = o->name();
+    op.index = -1;
+
+    append_(op);
+}
+
+void SceneDelta::setObjectData(const Object * o)
+{
+    Operation op;
+    op.type = OP_DATA;
+    op.id = o->idName();
+    op.index = -1;
+
+    IO::DataStream io(&op.data, QIODevice::WriteOnly);
+    o->serialize(io);
+
+    append_(op);
+}
+
+void SceneDelta::setParameter(const Parameter * p)
+{
+    Operation op;
+    op.type = OP_PARAMETER;
+    op.id = p->object()->idName();
+    op.target = p->idName();
+    op.index = -1;
+
+    IO::DataStream io(&op.data, QIODevice::WriteOnly);
+    p->serialize(io);
+
+    append_(op);
+}
+
+void SceneDelta::setAudioConnections(const Scene * s)
+{
+    Operation op;
+    op.type = OP_AUDIO_CONNECTIONS;
+    op.id = s->idName();
+    op.index = -1;
+
+    IO::DataStream io(&op.data, QIODevice::WriteOnly);
+    s->audioConnections()->serialize(io);
+
+    append_(op);
+}
+
+// --------------------------------- io ----------------------------------------
+
+void SceneDelta::serialize(IO::DataStream & io) const
+{
+    io.writeHeader("scenedelta", 1);
+
+    io << (qint32)ops_.size();
+    for (const Operation& op : ops_)
+        io << (quint8)op.type << op.id << op.target << (qint32)op.index << op.data;
+}
+
+void SceneDelta::deserialize(IO::DataStream & io)
+{
+    io.readHeader("scenedelta", 1);
+
+    ops_.clear();
+
+    qint32 num;
+    io >> num;
+    for (qint32 i = 0; i < num; ++i)
+    {
+        Operation op;
+        quint8 type;
+        qint32 index;
+        io >> type >> op.id >> op.target >> index >> op.data;
+        if (type > OP_AUDIO_CONNECTIONS)
+            MO_IO_ERROR(READ, "unknown operation " << type << " in SceneDelta");
+        op.type = OperationType(type);
+        op.index = index;
+        ops_.append(op);
+    }
+}
+
+// ------------------------------- applying ------------------------------------
+
+namespace {
+
+    /** The objects that exist at each step of a delta,
+        tracked without changing the scene */
+    class ObjectState
+    {
+    public:
+        ObjectState(Scene * scene) : scene_(scene) { }
+
+        Object * find(const QString& id) const
+        {
+            if (deleted_.contains(id))
+                return 0;
+            if (Object * o = added_.value(id, 0))
+                return o;
+            if (id == scene_->idName())
+                return scene_;
+            return scene_->findObjectById(id);
+        }
+
+        void add(Object * o)
+        {
+            for (auto c : tree_(o))
+            {
+                added_.insert(c->idName(), c);
+                deleted_.remove(c->idName());
+            }
+        }
+
+        /** Children are taken from the current tree,
+            moves within the delta are not followed */
+        void remove(Object * o)
+        {
+            for (auto c : tree_(o))
+            {
+                added_.remove(c->idName());
+                deleted_.insert(c->idName());
+            }
+        }
+
+    private:
+
+        static QList<Object*> tree_(Object * o)
+        {
+            auto list = o->findChildObjects<Object>(QString(), true);
+            list.prepend(o);
+            return list;
+        }
+
+        Scene * scene_;
+        QHash<QString, Object*> added_;
+        QSet<QString> deleted_;
+    };
+
+} // namespace
+
+Object * SceneDelta::findObject_(Scene * scene, const QString &id)
+{
+    if (id == scene->idName())
+        return scene;
+    return scene->findObjectById(id);
+}
+
+void SceneDelta::validate_(Scene * scene, QVector<Object*>& loaded,
+                           int& index) const
+{
+    ObjectState state(scene);
+
+    // objects of the same class, to test-read data and parameters
+    QHash<QString, Object*> scratch;
+    auto getScratch = [&](const Object * o)
+    {
+        Object * s = scratch.value(o->className(), 0);
+        if (!s)
+        {
+            s = ObjectFactory::createObject(o->className());
+            if (!s)
+                MO_IO_ERROR(READ, "could not create class '"
+                            << o->className() << "'");
+            scratch.insert(o->className(), s);
+        }
+        return s;
+    };
+
+    try
+    {
+        for (index = 0; index < ops_.size(); ++index)
+        {
+            const Operation& op = ops_[index];
+
+            if (op.type == OP_AUDIO_CONNECTIONS)
+            {
+                // only reads the ids, they are resolved when applying
+                AudioObjectConnections acon;
+                IO::DataStream io(op.data);
+                acon.deserialize(io);
+                continue;
+            }
+
+            if (op.type == OP_ADD)
+            {
+                Object * parent = state.find(op.target);
+                if (!parent)
+                    MO_IO_ERROR(READ, "parent '" << op.target << "' not found");
+                if (state.find(op.id))
+                    MO_IO_ERROR(READ, "object '" << op.id << "' already exists");
+
+                IO::DataStream io(op.data);
+                Object * o = ObjectFactory::loadObject(io);
+                if (!o)
+                    MO_IO_ERROR(READ, "could not create object '" << op.id << "'");
+                loaded[index] = o;
+
+                if (o->idName() != op.id)
+                    MO_IO_ERROR(READ, "object '" << op.id << "' was stored as '"
+                                << o->idName() << "'");
+                QString err;
+                if (!parent->isSaveToAdd(o, err))
+                    MO_IO_ERROR(READ, "can not add '" << op.id << "' to '"
+                                << op.target << "': " << err);
+
+                state.add(o);
+                continue;
+            }
+
+            Object * o = state.find(op.id);
+            if (!o)
+                MO_IO_ERROR(READ, "object '" << op.id << "' not found");
+
+            switch (op.type)
+            {
+                case OP_DELETE:
+                    if (o == scene)
+                        MO_IO_ERROR(READ, "can not delete the scene");
+                    state.remove(o);
+                break;
+
+                case OP_MOVE:
+                {
+                    Object * parent = state.find(op.target);
+                    if (!parent || o == scene
+                            || parent == o || parent->hasParentObject(o))
+                        MO_IO_ERROR(READ, "can not move '" << op.id
+                                    << "' to '" << op.target << "'");
+                }
+                break;
+
+                case OP_DATA:
+                {
+                    IO::DataStream io(op.data);
+                    getScratch(o)->deserialize(io);
+                }
+                break;
+
+                case OP_PARAMETER:
+                {
+                    if (!o->params()->findParameter(op.target))
+                        MO_IO_ERROR(READ, "parameter '" << op.target
+                                    << "' not found in '" << op.id << "'");
+                    // parameters created at runtime can only be checked by id
+                    if (Parameter * p = getScratch(o)->params()
+                                                ->findParameter(op.target))
+                    {
+                        IO::DataStream io(op.data);
+                        p->deserialize(io);
+                    }
+                }
+                break;
+
+                default: break;
+            }
+        }
+    }
+    catch (...)
+    {
+        for (auto s : scratch)
+            s->releaseRef("SceneDelta::validate_ failed");
+        throw;
+    }
+
+    for (auto s : scratch)
+        s->releaseRef("SceneDelta::validate_ finish");
+}
+
+bool SceneDelta::apply(Scene * scene, QString * error,
+                       IO::FileList * neededFiles) const
+{
+    QVector<Object*> loaded(ops_.size(), 0);
+
+    int i = 0;
+    try
+    {
+        validate_(scene, loaded, i);
+
+        for (i = 0; i < ops_.size(); ++i)
+        {
+            const Operation& op = ops_[i];
+
+            if (op.type == OP_AUDIO_CONNECTIONS)
+            {
+                AudioObjectConnections acon;
+                IO::DataStream io(op.data);
+                acon.deserialize(io, scene);
+
+                ScopedSceneLockWrite lock(scene);
+                scene->audioConnections()->swap(acon);
+                continue;
+            }
+
+            if (op.type == OP_ADD)
+            {
+                Object * parent = findObject_(scene, op.target);
+                Object * o = loaded[i];
+                if (!parent)
+                    MO_IO_ERROR(READ, "parent '" << op.target << "' not found");
+
+                scene->addObject(parent, o,
+                                 std::min(op.index, parent->childObjects().size()));
+                o->releaseRef("SceneDelta::apply finish add");
+                loaded[i] = 0;
+
+                if (neededFiles)
+                {
+                    o->getNeededFiles(*neededFiles);
+                    for (auto c : o->findChildObjects<Object>(QString(), true))
+                        c->getNeededFiles(*neededFiles);
+                }
+                continue;
+            }
+
+            Object * o = findObject_(scene, op.id);
+            if (!o)
+                MO_IO_ERROR(READ, "object '" << op.id << "' not found");
+
+            switch (op.type)
+            {
+                case OP_DELETE:
+                    scene->deleteObject(o);
+                break;
+
+                case OP_MOVE:
+                {
+                    Object * parent = findObject_(scene, op.target);
+                    if (!parent)
+                        MO_IO_ERROR(READ, "parent '" << op.target << "' not found");
+                    if (parent == o->parentObject())
+                        scene->setObjectIndex(o, op.index);
+                    else
+                        scene->moveObject(o, parent, op.index);
+                }
+                break;
+
+                case OP_NAME:
+                    o->setName(op.target);
+                    scene->updateWeakNameLinks();
+                break;
+
+                case OP_DATA:
+                {
+                    IO::DataStream io(op.data);
+                    ScopedSceneLockWrite lock(scene);
+                    o->deserialize(io);
+                }
+                break;
+
+                case OP_PARAMETER:
+                {
+                    Parameter * p = o->params()->findParameter(op.target);
+                    if (!p)
+                        MO_IO_ERROR(READ, "parameter '" << op.target
+                                    << "' not found in '" << op.id << "'");
+                    {
+                        IO::DataStream io(op.data);
+                        ScopedSceneLockWrite lock(scene);
+                        p->removeAllModulators();
+                        p->deserialize(io);
+                        p->collectModulators();
+                        o->onParameterChanged(p);
+                    }
+                    o->updateParameterVisibility();
+                    if (neededFiles)
+                        o->getNeededFiles(*neededFiles);
+                }
+                break;
+
+                default: break;
+            }
+        }
+    }
+    catch (const Exception& e)
+    {
+        for (auto o : loaded)
+            if (o)
+                o->releaseRef("SceneDelta::apply failed");
+
+        if (error)
+            *error = QString("operation %1 of %2: %3")
+                        .arg(i + 1).arg(ops_.size()).arg(e.what());
+        return false;
+    }
+
+    return true;
+}
+
+
+} // namespace MO
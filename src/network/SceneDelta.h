@@ -0,0 +1,135 @@
+/** @file scenedelta.h
+
+    @brief List of edits to replicate a Scene incrementally
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_SCENEDELTA_H
+#define MOSRC_NETWORK_SCENEDELTA_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "io/filetypes.h"
+
+namespace MO {
+namespace IO { class DataStream; }
+
+class Object;
+class Scene;
+class Parameter;
+
+/** A list of edits that transforms one state of a Scene into the next.
+
+    Objects are identified by their idName(), so the delta can be applied
+    to any copy of the scene it was recorded from, as long as the copy
+    is at the same state.
+
+    Repeated changes to the same parameter, object name or object data
+    are merged into one operation, as long as no tree edit lies between.
+    */
+class SceneDelta
+{
+public:
+
+    enum OperationType
+    {
+        /** Adds a serialized object tree to a parent */
+        OP_ADD,
+        OP_DELETE,
+        /** Moves an object to a parent and child index */
+        OP_MOVE,
+        OP_NAME,
+        /** Replaces a serialized Parameter, including its modulators */
+        OP_PARAMETER,
+        /** Replaces the object's own data, e.g. a sequence's timeline */
+        OP_DATA,
+        /** Replaces all audio connections of the scene */
+        OP_AUDIO_CONNECTIONS
+    };
+
+    SceneDelta();
+
+    // ------------ getter -------------
+
+    bool isEmpty() const { return ops_.isEmpty(); }
+
+    int numOperations() const { return ops_.size(); }
+
+    /** Returns true if the delta adds, deletes or moves objects
+        or changes the audio connections */
+    bool isStructural() const;
+
+    /** Approximate number of bytes when serialized */
+    int numBytes() const;
+
+    // ------------ recording ----------
+
+    void clear() { ops_.clear(); }
+
+    /** Records the object, which must be part of a scene,
+        at its current parent and index */
+    void addObject(const Object * o);
+    /** Records the deletion of the object (and all its children) */
+    void deleteObject(const Object * o);
+    /** Records the current parent and index of the object */
+    void moveObject(const Object * o);
+    void setObjectName(const Object * o);
+    void setObjectData(const Object * o);
+    void setParameter(const Parameter * p);
+    void setAudioConnections(const Scene * s);
+
+    // ------------- io ----------------
+
+    void serialize(IO::DataStream&) const;
+    void deserialize(IO::DataStream&);
+
+    // ----------- applying ------------
+
+    /** Applies all operations in order.
+        All operations are checked before the scene is changed.
+        If one can not be applied (which means the scene is not in the
+        state the delta was recorded from), the scene is left untouched,
+        false is returned and @p error is set.
+        The files needed by added and changed objects are added
+        to @p neededFiles if not NULL. */
+    bool apply(Scene * scene, QString * error = 0,
+               IO::FileList * neededFiles = 0) const;
+
+private:
+
+    struct Operation
+    {
+        OperationType type;
+        /** The object's idName */
+        QString id,
+        /** parent id, parameter id or name */
+            target;
+        int index;
+        QByteArray data;
+    };
+
+    /** Replaces a previous operation with the same target,
+        or appends @p op */
+    void append_(const Operation& op);
+
+    static Object * findObject_(Scene * scene, const QString& id);
+
+    /** Checks all operations against @p scene without changing it.
+        The objects of OP_ADD are loaded into @p loaded at the
+        operation's index. Throws on the first failing operation,
+        with @p index set to it. */
+    void validate_(Scene * scene, QVector<Object*>& loaded, int& index) const;
+
+    QList<Operation> ops_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_SCENEDELTA_H
@@ -0,0 +1,296 @@
+/** @file scenedeltarecorder.cpp
+
+    @brief Collects ObjectEditor edits into versioned SceneDeltas
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <QTimer>
+
+#include "SceneDeltaRecorder.h"
+#include "object/Scene.h"
+#include "object/control/Sequence.h"
+#include "object/param/Parameter.h"
+#include "object/param/Parameters.h"
+#include "object/util/ObjectEditor.h"
+#include "io/log.h"
+
+namespace MO {
+
+SceneDeltaRecorder::SceneDeltaRecorder(QObject *parent)
+    : QObject       (parent)
+    , editor_       (0)
+    , scene_        (0)
+    , version_      (1)
+    , flushInterval_(20)
+    , timer_        (new QTimer(this))
+{
+    timer_->setSingleShot(true);
+    connect(timer_, SIGNAL(timeout()), this, SIGNAL(deltaReady()));
+}
+
+Scene * SceneDeltaRecorder::scene() const
+{
+    return editor_ ? editor_->scene() : 0;
+}
+
+void SceneDeltaRecorder::setObjectEditor(ObjectEditor * e)
+{
+    if (editor_)
+        editor_->disconnect(this);
+
+    editor_ = e;
+    checkScene_(scene());
+
+    if (!editor_)
+        return;
+
+    connect(editor_, SIGNAL(objectAdded(MO::Object*)),
+            this, SLOT(onObjectAdded_(MO::Object*)));
+    connect(editor_, SIGNAL(objectsAdded(QList<MO::Object*>)),
+            this, SLOT(onObjectsAdded_(QList<MO::Object*>)));
+    connect(editor_, SIGNAL(objectAboutToDelete(const MO::Object*)),
+            this, SLOT(onObjectAboutToDelete_(const MO::Object*)));
+    connect(editor_, SIGNAL(objectsAboutToDelete(QList<MO::Object*>)),
+            this, SLOT(onObjectsAboutToDelete_(QList<MO::Object*>)));
+    connect(editor_, SIGNAL(objectMoved(MO::Object*,MO::Object*)),
+            this, SLOT(onObjectMoved_(MO::Object*,MO::Object*)));
+    connect(editor_, SIGNAL(objectChanged(MO::Object*)),
+            this, SLOT(onObjectChanged_(MO::Object*)));
+    connect(editor_, SIGNAL(objectNameChanged(MO::Object*)),
+            this, SLOT(onObjectNameChanged_(MO::Object*)));
+    connect(editor_, SIGNAL(parameterChanged(MO::Parameter*)),
+            this, SLOT(onParameterChanged_(MO::Parameter*)));
+    connect(editor_, SIGNAL(parametersChanged(MO::Object*)),
+            this, SLOT(onParametersChanged_(MO::Object*)));
+    connect(editor_, SIGNAL(sequenceChanged(MO::Sequence*)),
+            this, SLOT(onSequenceChanged_(MO::Sequence*)));
+    connect(editor_, SIGNAL(audioConnectionsChanged()),
+            this, SLOT(onAudioConnectionsChanged_()));
+}
+
+void SceneDeltaRecorder::checkScene_(Scene * s)
+{
+    if (s == scene_)
+        return;
+
+    MO_DEBUG("SceneDeltaRecorder: scene changed, dropping "
+             << delta_.numOperations() << " edits");
+
+    scene_ = s;
+    delta_.clear();
+    positions_.clear();
+    if (scene_)
+        storeTree_(scene_);
+    timer_->stop();
+    ++version_;
+}
+
+Scene * SceneDeltaRecorder::beginEdit_()
+{
+    checkScene_(scene());
+    return scene_;
+}
+
+bool SceneDeltaRecorder::isInScene_(const Object * o) const
+{
+    return o && (o == scene_ || o->sceneObject() == scene_);
+}
+
+void SceneDeltaRecorder::endEdit_()
+{
+    if (!delta_.isEmpty() && !timer_->isActive())
+        timer_->start(flushInterval_);
+}
+
+void SceneDeltaRecorder::storeTree_(const Object * root)
+{
+    storePositions_(root);
+    for (auto c : root->childObjects())
+        storeTree_(c);
+}
+
+void SceneDeltaRecorder::storePositions_(const Object * parent,
+                                         const QSet<const Object*>& without)
+{
+    if (!parent)
+        return;
+
+    int index = 0;
+    for (auto c : parent->childObjects())
+        if (!without.contains(c))
+        {
+            Position pos;
+            pos.parent = parent->idName();
+            pos.index = index++;
+            positions_.insert(c->idName(), pos);
+        }
+}
+
+void SceneDeltaRecorder::removeTree_(const Object * o)
+{
+    positions_.remove(o->idName());
+    for (auto c : o->childObjects())
+        removeTree_(c);
+}
+
+bool SceneDeltaRecorder::hasMoved_(const Object * o) const
+{
+    const Object * parent = o->parentObject();
+    if (!parent)
+        return false;
+
+    auto i = positions_.find(o->idName());
+    return i == positions_.end()
+        || i.value().parent != parent->idName()
+        || i.value().index != parent->childObjects().indexOf(
+                                                const_cast<Object*>(o));
+}
+
+bool SceneDeltaRecorder::takeDelta(SceneDelta &delta,
+                                   quint32 *baseVersion, quint32 *version)
+{
+    checkScene_(scene());
+    timer_->stop();
+
+    if (delta_.isEmpty())
+        return false;
+
+    delta = delta_;
+    delta_.clear();
+
+    if (baseVersion)
+        *baseVersion = version_;
+    ++version_;
+    if (version)
+        *version = version_;
+
+    return true;
+}
+
+quint32 SceneDeltaRecorder::beginSnapshot(Scene * scene)
+{
+    checkScene_(scene);
+    return version_;
+}
+
+// ------------------------------ editor signals -------------------------------
+
+void SceneDeltaRecorder::onObjectAdded_(Object * o)
+{
+    if (!beginEdit_() || !isInScene_(o))
+        return;
+    delta_.addObject(o);
+    storeTree_(o);
+    storePositions_(o->parentObject());
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectsAdded_(const QList<Object*>& list)
+{
+    if (!beginEdit_())
+        return;
+    for (auto o : list)
+        if (isInScene_(o))
+        {
+            delta_.addObject(o);
+            storeTree_(o);
+            storePositions_(o->parentObject());
+        }
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectAboutToDelete_(const Object * o)
+{
+    if (!beginEdit_() || !isInScene_(o))
+        return;
+    delta_.deleteObject(o);
+    removeTree_(o);
+    storePositions_(o->parentObject(), QSet<const Object*>() << o);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectsAboutToDelete_(const QList<Object*>& list)
+{
+    if (!beginEdit_())
+        return;
+    QSet<const Object*> deleted;
+    for (auto o : list)
+        if (isInScene_(o))
+        {
+            delta_.deleteObject(o);
+            removeTree_(o);
+            deleted << o;
+        }
+    for (auto o : deleted)
+        storePositions_(o->parentObject(), deleted);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectMoved_(Object * o, Object * oldParent)
+{
+    if (!beginEdit_() || !isInScene_(o))
+        return;
+    delta_.moveObject(o);
+    storePositions_(oldParent);
+    storePositions_(o->parentObject());
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectChanged_(Object * o)
+{
+    // emitted for changes of the child index among others,
+    // a move is only recorded if the position actually changed
+    if (!beginEdit_() || o == scene_ || !isInScene_(o) || !hasMoved_(o))
+        return;
+    delta_.moveObject(o);
+    storePositions_(o->parentObject());
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onObjectNameChanged_(Object * o)
+{
+    if (!beginEdit_() || !isInScene_(o))
+        return;
+    delta_.setObjectName(o);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onParameterChanged_(Parameter * p)
+{
+    if (!beginEdit_() || !isInScene_(p->object()))
+        return;
+    delta_.setParameter(p);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onParametersChanged_(Object * o)
+{
+    if (!beginEdit_() || !isInScene_(o))
+        return;
+    for (auto p : o->params()->parameters())
+        delta_.setParameter(p);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onSequenceChanged_(Sequence * s)
+{
+    if (!beginEdit_() || !isInScene_(s))
+        return;
+    delta_.setObjectData(s);
+    endEdit_();
+}
+
+void SceneDeltaRecorder::onAudioConnectionsChanged_()
+{
+    if (!beginEdit_())
+        return;
+    delta_.setAudioConnections(scene_);
+    endEdit_();
+}
+
+
+} // namespace MO
@@ -0,0 +1,139 @@
+/** @file scenedeltarecorder.h
+
+    @brief Collects ObjectEditor edits into versioned SceneDeltas
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_SCENEDELTARECORDER_H
+#define MOSRC_NETWORK_SCENEDELTARECORDER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QSet>
+
+#include "SceneDelta.h"
+
+class QTimer;
+
+namespace MO {
+
+class ObjectEditor;
+class Sequence;
+
+/** Listens to the signals of an ObjectEditor and records the edits.
+
+    Edits are collected for flushInterval() milliseconds, then deltaReady()
+    is emitted and takeDelta() returns them as one SceneDelta.
+    Every taken delta advances the version by one. A client at the
+    base version of a delta can apply it, any other client needs a
+    full snapshot of the scene at version().
+
+    When the edited scene is replaced, pending edits are dropped
+    and the version advances without a delta, so clients that
+    did not receive the new scene will ask for a snapshot.
+    */
+class SceneDeltaRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SceneDeltaRecorder(QObject * parent = 0);
+
+    // ------------ getter -------------
+
+    ObjectEditor * objectEditor() const { return editor_; }
+
+    /** The scene of the editor */
+    Scene * scene() const;
+
+    /** Version of the scene after the last taken delta.
+        Starts at 1, 0 is used by clients for an unknown version. */
+    quint32 version() const { return version_; }
+
+    /** There are edits waiting for takeDelta() */
+    bool hasDelta() const { return !delta_.isEmpty(); }
+
+    int flushInterval() const { return flushInterval_; }
+
+    // ------------ setter -------------
+
+    /** Starts recording the edits of @p editor */
+    void setObjectEditor(ObjectEditor * editor);
+
+    void setFlushInterval(int ms) { flushInterval_ = ms; }
+
+    /** Moves the pending edits into @p delta and advances the version.
+        Returns false if there were no edits. */
+    bool takeDelta(SceneDelta & delta, quint32 * baseVersion, quint32 * version);
+
+    /** Returns the version for a full snapshot of @p scene.
+        Pending edits must have been taken before, unless
+        @p scene is not the recorded scene. */
+    quint32 beginSnapshot(Scene * scene);
+
+signals:
+
+    /** Edits are waiting for takeDelta() */
+    void deltaReady();
+
+private slots:
+
+    void onObjectAdded_(MO::Object*);
+    void onObjectsAdded_(const QList<MO::Object*>&);
+    void onObjectAboutToDelete_(const MO::Object*);
+    void onObjectsAboutToDelete_(const QList<MO::Object*>&);
+    void onObjectMoved_(MO::Object*, MO::Object*);
+    void onObjectChanged_(MO::Object*);
+    void onObjectNameChanged_(MO::Object*);
+    void onParameterChanged_(MO::Parameter*);
+    void onParametersChanged_(MO::Object*);
+    void onSequenceChanged_(MO::Sequence*);
+    void onAudioConnectionsChanged_();
+
+private:
+
+    /** Drops everything recorded for another scene than @p scene */
+    void checkScene_(Scene * scene);
+    /** Checks for a scene switch and returns the scene, or NULL */
+    Scene * beginEdit_();
+    /** The object belongs to the recorded scene */
+    bool isInScene_(const Object * o) const;
+    /** Starts the flush timer */
+    void endEdit_();
+
+    /** Stores parent and index of all objects below @p root */
+    void storeTree_(const Object * root);
+    /** Stores parent and index of the children of @p parent,
+        as they will be after the objects in @p without are removed */
+    void storePositions_(const Object * parent,
+                         const QSet<const Object*>& without
+                            = QSet<const Object*>());
+    /** Forgets the positions of @p o and its children */
+    void removeTree_(const Object * o);
+    /** Returns true if parent or index of @p o differ
+        from the last recorded state */
+    bool hasMoved_(const Object * o) const;
+
+    struct Position
+    {
+        QString parent;
+        int index;
+    };
+
+    ObjectEditor * editor_;
+    Scene * scene_;
+    SceneDelta delta_;
+    /** Parent and index of each object id, as recorded so far */
+    QHash<QString, Position> positions_;
+    quint32 version_;
+    int flushInterval_;
+    QTimer * timer_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_SCENEDELTARECORDER_H
@@ -10,12 +10,15 @@
 
 #include <memory>
 #include <vector>
+#include <algorithm>
 
-#include <QDataStream>
 #include <QMap>
+#include <QHash>
+#include <QHostAddress>
 
 #include "UdpAudioConnection.h"
 #include "UdpConnection.h"
+#include "UdpAudioJitterBuffer.h"
 #include "audio/tool/AudioBuffer.h"
 #include "object/AudioObject.h"
 #include "network/netlog.h"
@@ -34,15 +37,30 @@ struct UdpAudioConnection::Private
         AUDIO::AudioBuffer * buf;
         uint channel;
         QString id;
+        uint32_t stream;
         SamplePos curPos;
+        UdpAudioJitterBuffer jitter;
+        /** A received block has to be pulled from jitter */
+        bool isReceived;
     };
 
 
     // ---------- ctor ----------
 
     Private(UdpAudioConnection * p)
-        : p   (p),
-          udp (new UdpConnection(p))
+        : p             (p),
+          udp           (new UdpConnection(p)),
+          frame         (1400, UdpAudioFrame::Compression(
+                                    settings()->udpAudioCompression())),
+          sequence      (0),
+          flushInterval (1),
+          flushCount    (0),
+          jitterDepth   (4),
+          hasSequence   (false),
+          lastSequence  (0),
+          numSent       (0),
+          numReceived   (0),
+          numLost       (0)
     {
     }
 
@@ -51,20 +69,32 @@ struct UdpAudioConnection::Private
         udp->close();
     }
 
-    static void constructPacket_(QByteArray&, Buffer* b);
-    void deconstructPacket_(const QByteArray& data);
+    bool sendFrame_();
+    void receiveFrame_(const QByteArray& data);
 
     void createBuffer(AUDIO::AudioBuffer * buf, AudioObject * obj, uint channel);
     Buffer * bufferFor(AUDIO::AudioBuffer * );
-    Buffer * bufferFor(const QString& id);
+    Buffer * bufferFor(uint32_t stream);
 
     std::vector<std::shared_ptr<Buffer>> bufferStore;
     QMap<AUDIO::AudioBuffer*, Buffer*> buffers;
-    QMap<QString, Buffer*> buffersId;
+    QHash<uint32_t, Buffer*> buffersStream;
 
     UdpAudioConnection * p;
     UdpConnection * udp;
 
+    // send
+    UdpAudioFrame frame;
+    uint32_t sequence;
+    uint flushInterval, flushCount;
+
+    // receive
+    uint jitterDepth;
+    bool hasSequence;
+    uint32_t lastSequence;
+    std::vector<F32> block;
+
+    uint64_t numSent, numReceived, numLost;
 };
 
 UdpAudioConnection::UdpAudioConnection(QObject *parent)
@@ -85,12 +115,53 @@ UdpAudioConnection::~UdpAudioConnection()
     delete p_;
 }
 
+size_t UdpAudioConnection::maxFrameBytes() const { return p_->frame.maxBytes(); }
+UdpAudioFrame::Compression UdpAudioConnection::compression() const { return p_->frame.compression(); }
+uint UdpAudioConnection::flushInterval() const { return p_->flushInterval; }
+uint UdpAudioConnection::jitterDepth() const { return p_->jitterDepth; }
+uint64_t UdpAudioConnection::numFramesSent() const { return p_->numSent; }
+uint64_t UdpAudioConnection::numFramesReceived() const { return p_->numReceived; }
+uint64_t UdpAudioConnection::numFramesLost() const { return p_->numLost; }
+
+uint64_t UdpAudioConnection::numBlocksConcealed() const
+{
+    uint64_t num = 0;
+    for (auto & b : p_->bufferStore)
+        num += b->jitter.numConcealed();
+    return num;
+}
+
+void UdpAudioConnection::setMaxFrameBytes(size_t bytes)
+{
+    p_->frame.setMaxBytes(bytes);
+}
+
+void UdpAudioConnection::setCompression(UdpAudioFrame::Compression c)
+{
+    p_->frame.setCompression(c);
+    if (p_->frame.isEmpty())
+        p_->frame.clear(p_->sequence);
+}
+
+void UdpAudioConnection::setFlushInterval(uint blocks)
+{
+    p_->flushInterval = std::max(1u, blocks);
+}
+
+void UdpAudioConnection::setJitterDepth(uint blocks)
+{
+    p_->jitterDepth = blocks;
+    for (auto & b : p_->bufferStore)
+        b->jitter.setDepth(blocks);
+}
 
 void UdpAudioConnection::clear()
 {
     p_->buffers.clear();
-    p_->buffersId.clear();
+    p_->buffersStream.clear();
     p_->bufferStore.clear();
+    p_->frame.clear(p_->sequence);
+    p_->hasSequence = false;
 }
 
 bool UdpAudioConnection::addBuffer(AUDIO::AudioBuffer *buffer, AudioObject *obj, uint channel)
@@ -120,6 +191,10 @@ bool UdpAudioConnection::openForRead()
 {
     MO_ASSERT(isClient(), "wrong request");
 
+    // local benchmarking
+    if (QHostAddress(settings()->udpAudioMulticastAddress()).isLoopback())
+        return p_->udp->open(settings()->udpAudioMulticastPort());
+
     return p_->udp->openMulticastRead(settings()->udpAudioMulticastAddress(),
                                       settings()->udpAudioMulticastPort());
 }
@@ -148,13 +223,49 @@ bool UdpAudioConnection::sendAudioBuffer(AUDIO::AudioBuffer * buf, SamplePos pos
     // update buffer info
     b->curPos = pos;
 
-    // repackage
-    QByteArray data;
-    Private::constructPacket_(data, b);
+    // pack into frames
+    const size_t blockSize = buf->blockSize();
+    const F32 * samples = buf->readPointer();
+    bool suc = true;
+    size_t offset = 0;
+    while (offset < blockSize)
+    {
+        const size_t num = p_->frame.addPart(b->stream, pos, blockSize, offset,
+                                             samples + offset, blockSize - offset);
+        offset += num;
+
+        if (offset < blockSize)
+        {
+            if (p_->frame.isEmpty())
+                return false;
+            suc &= p_->sendFrame_();
+        }
+    }
+
+    return suc;
+}
+
+bool UdpAudioConnection::flush()
+{
+    if (++p_->flushCount < p_->flushInterval)
+        return true;
+    p_->flushCount = 0;
+
+    if (p_->frame.isEmpty())
+        return true;
+
+    return p_->sendFrame_();
+}
 
+bool UdpAudioConnection::Private::sendFrame_()
+{
     // send off
-    return p_->udp->sendDatagram(data, QHostAddress(settings()->udpAudioMulticastAddress()),
-                                       settings()->udpAudioMulticastPort());
+    bool suc = udp->sendDatagram(frame.data(),
+                                 QHostAddress(settings()->udpAudioMulticastAddress()),
+                                 settings()->udpAudioMulticastPort());
+    ++numSent;
+    frame.clear(++sequence);
+    return suc;
 }
 #endif
 
@@ -162,8 +273,8 @@ void UdpAudioConnection::receive_()
 {
     MO_DEBUG_UDP("UdpAudioConnection::receive()");
 
-    QByteArray data = p_->udp->readData();
-    p_->deconstructPacket_(data);
+    while (p_->udp->isData())
+        p_->receiveFrame_(p_->udp->readData());
 }
 
 
@@ -172,68 +283,74 @@ void UdpAudioConnection::receive_()
 
 
 
-void UdpAudioConnection::Private::constructPacket_(QByteArray & data, Buffer * b)
+void UdpAudioConnection::Private::receiveFrame_(const QByteArray& data)
 {
-    QDataStream s(&data, QIODevice::WriteOnly);
-
-    s << "_audio_" << b->id << quint32(b->channel) << quint64(b->curPos) << quint32(b->buf->blockSize());
-    s.writeRawData((const char*)b->buf->readPointer(), b->buf->blockSizeBytes());
-}
+    uint32_t seq;
+    std::vector<Buffer*> received;
 
-void UdpAudioConnection::Private::deconstructPacket_(const QByteArray& data)
-{
-    if (data.startsWith("_audio_"))
+    bool valid = UdpAudioFrame::read(data, &seq,
+    // subscribed streams
+    [this](uint32_t stream)
     {
-        MO_NETLOG(WARNING, "UdpAudioConnection: received unknown data (" << data.size() << " bytes)");
-        return;
-    }
-
-    QDataStream s(data);
-
-    // reconstruct
-    QString idName;
-    quint32 channel;
-    quint64 pos;
-    quint32 blockSize;
-    // skip header
-    s >> idName;
-    // read stuff
-    s >> idName >> channel >> pos >> blockSize;
-
-    Buffer * b = bufferFor(idName);
-    if (!b)
+        return buffersStream.contains(stream);
+    },
+    // store parts
+    [&](const UdpAudioFrame::Part& part)
     {
-        MO_NETLOG(WARNING, "UdpAudioConnection: received unknown buffer '" << idName << "'");
-#ifndef NDEBUG
-        for (auto b : buffers)
-            MO_PRINT(b->id);
-#endif
+        Buffer * b = bufferFor(part.stream);
+        if (part.blockSize != b->buf->blockSize())
+        {
+            MO_NETLOG(WARNING, "UdpAudioConnection: blocksize mismatch, received "
+                      << part.blockSize << ", should be " << b->buf->blockSize());
+            return;
+        }
+
+        b->jitter.addPart(part.pos, part.offset, part.samples, part.count);
+        if (!b->isReceived)
+        {
+            b->isReceived = true;
+            received.push_back(b);
+        }
+    });
+
+    if (!valid)
+    {
+        MO_NETLOG(WARNING, "UdpAudioConnection: received unknown data (" << data.size() << " bytes)");
         return;
     }
 
-    if (blockSize != b->buf->blockSize())
+    // sequence statistics
+    ++numReceived;
+    if (hasSequence && seq != lastSequence + 1)
     {
-        MO_NETLOG(WARNING, "UdpAudioConnection: blocksize mismatch, received " << blockSize << ", should be " << b->buf->blockSize());
-        return;
+        // not reordered or restarted
+        const uint32_t gap = seq - lastSequence - 1;
+        if (gap < 0x10000)
+            numLost += gap;
     }
+    if (!hasSequence || int32_t(seq - lastSequence) > 0)
+        lastSequence = seq;
+    hasSequence = true;
 
-    if (channel != b->channel)
+    // forward complete blocks
+    for (Buffer * b : received)
     {
-        MO_NETLOG(WARNING, "UdpAudioConnection: channel mismatch, received " << channel << ", should be " << b->channel);
-        /*return; not really an error, is it?*/
+        b->isReceived = false;
+
+        block.resize(b->buf->blockSize());
+        SamplePos pos;
+        while (b->jitter.pull(&block[0], &pos))
+        {
+            b->buf->writeBlock(&block[0]);
+            b->buf->nextBlock();
+            // ZZZ
+            b->ao->clientFakeAudio(RenderTime(pos, b->ao->sampleRate(), b->buf->blockSize(), MO_AUDIO_THREAD));
+            b->curPos = pos;
+
+            MO_DEBUG_UDP("UdpAudioConnection: received buffer "
+                     << b->id << ", " << b->buf->blockSize() << ", " << pos);
+        }
     }
-
-    // read and forward pointer
-    s.readRawData((char *)b->buf->writePointer(), b->buf->blockSizeBytes());
-    b->buf->nextBlock();
-    // ZZZ
-    b->ao->clientFakeAudio(RenderTime(pos, b->ao->sampleRate(), b->buf->blockSize(), MO_AUDIO_THREAD));
-    b->curPos = pos;
-
-    MO_DEBUG_UDP("UdpAudioConnection: received buffer "
-             << idName << ", " << blockSize << ", " << channel << ", " << pos
-             //<< "\n" << b->buf->toAscii()
-             );
 }
 
 
@@ -249,9 +366,17 @@ void UdpAudioConnection::Private::createBuffer(AUDIO::AudioBuffer *buf, AudioObj
     b->channel = channel;
     b->curPos = 0;
     b->id = QString("%1_%2").arg(obj->idName()).arg(channel);
+    b->stream = UdpAudioFrame::streamId(b->id);
+    b->jitter.setBlockSize(buf->blockSize());
+    b->jitter.setDepth(jitterDepth);
+    b->isReceived = false;
+
+    if (buffersStream.contains(b->stream))
+        MO_NETLOG(WARNING, "UdpAudioConnection: stream id collision for '"
+                  << b->id << "' and '" << buffersStream[b->stream]->id << "'");
 
     buffers.insert(b->buf, b);
-    buffersId.insert(b->id, b);
+    buffersStream.insert(b->stream, b);
     bufferStore.push_back(shp);
 }
 
@@ -263,10 +388,9 @@ UdpAudioConnection::Private::bufferFor(AUDIO::AudioBuffer * ab)
 }
 
 UdpAudioConnection::Private::Buffer *
-UdpAudioConnection::Private::bufferFor(const QString& id)
+UdpAudioConnection::Private::bufferFor(uint32_t stream)
 {
-    auto i = buffersId.find(id);
-    return (i == buffersId.end()) ? 0 : i.value();
+    return buffersStream.value(stream, 0);
 }
 
 } // namespace MO
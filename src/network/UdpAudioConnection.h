@@ -14,6 +14,7 @@
 #include <QObject>
 
 #include "types/float.h"
+#include "network/UdpAudioFrame.h"
 
 namespace MO {
 namespace AUDIO { class AudioBuffer; }
@@ -21,7 +22,17 @@ namespace AUDIO { class AudioBuffer; }
 class AudioObject;
 class UdpConnection;
 
-/** Server and client in one class */
+/** Server and client in one class.
+
+    The server packs the blocks of all added buffers into UdpAudioFrame
+    datagrams, which are sent when full or on flush().
+    Clients subscribe to the buffers they need with addBuffer(),
+    parts of other streams are skipped without decoding.
+    Received blocks pass a UdpAudioJitterBuffer per buffer.
+
+    If the multicast address in Settings is a loopback address,
+    the client binds the port directly, e.g. for local benchmarks.
+    */
 class UdpAudioConnection : public QObject
 {
     Q_OBJECT
@@ -31,6 +42,35 @@ public:
 
     bool isOpen() const;
 
+    // ----------- settings ------------
+
+    /** Maximum size of a datagram, default is 1400 bytes */
+    size_t maxFrameBytes() const;
+    void setMaxFrameBytes(size_t bytes);
+
+    /** Sample format of sent frames, default is taken from Settings */
+    UdpAudioFrame::Compression compression() const;
+    void setCompression(UdpAudioFrame::Compression c);
+
+    /** Number of flush() calls after which a partial frame is sent,
+        to batch the blocks of few channels. Default is 1 */
+    uint flushInterval() const;
+    void setFlushInterval(uint blocks);
+
+    /** Number of newer blocks to wait for a missing block
+        before concealing it, default is 4 */
+    uint jitterDepth() const;
+    void setJitterDepth(uint blocks);
+
+    // ---------- statistics -----------
+
+    uint64_t numFramesSent() const;
+    uint64_t numFramesReceived() const;
+    /** Number of frames missing in the received sequence */
+    uint64_t numFramesLost() const;
+    /** Number of received blocks that were missing or incomplete */
+    uint64_t numBlocksConcealed() const;
+
 signals:
 
 public slots:
@@ -47,9 +87,14 @@ public slots:
     bool addBuffer(AUDIO::AudioBuffer * buffer, AudioObject * obj, uint channel);
 
 #ifndef MO_DISABLE_SERVER
-    /** Broadcasts the current sample block in @p buffer for the given global sample time @p pos.
+    /** Queues the current sample block in @p buffer for the given global sample time @p pos.
+        Full frames are broadcasted immediately.
         @note Buffer needs to be added with addBuffer(). */
     bool sendAudioBuffer(AUDIO::AudioBuffer * buffer, SamplePos pos);
+
+    /** Ends the current dsp block. Broadcasts the pending frame
+        every flushInterval() calls. */
+    bool flush();
 #endif
 
     /** Adds a connection to the list of receivers */
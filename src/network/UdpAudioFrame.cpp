@@ -0,0 +1,329 @@
+/** @file udpaudioframe.cpp
+
+    @brief Binary datagram format for streaming audio blocks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "UdpAudioFrame.h"
+#include "math/hash.h"
+
+namespace MO {
+
+namespace {
+
+    /** "MOA1" */
+    const uint32_t frameMagic = 0x31414f4d;
+
+    void set16(char * p, uint16_t v)
+    {
+        p[0] = char(v); p[1] = char(v >> 8);
+    }
+
+    void set32(char * p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = char(v >> (i * 8));
+    }
+
+    void set64(char * p, uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i)
+            p[i] = char(v >> (i * 8));
+    }
+
+    uint16_t get16(const uchar * p)
+    {
+        return uint16_t(p[0]) | (uint16_t(p[1]) << 8);
+    }
+
+    uint32_t get32(const uchar * p)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+            v |= uint32_t(p[i]) << (i * 8);
+        return v;
+    }
+
+    uint64_t get64(const uchar * p)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+            v |= uint64_t(p[i]) << (i * 8);
+        return v;
+    }
+
+    uint32_t floatBits(F32 f)
+    {
+        uint32_t u;
+        memcpy(&u, &f, 4);
+        return u;
+    }
+
+    F32 bitsFloat(uint32_t u)
+    {
+        F32 f;
+        memcpy(&f, &u, 4);
+        return f;
+    }
+
+    /** Appends up to @p count samples using at most @p maxBytes.
+        Returns the number of samples written */
+    size_t encode(QByteArray& d, UdpAudioFrame::Compression c,
+                  const F32 * s, size_t count, size_t maxBytes)
+    {
+        switch (c)
+        {
+            case UdpAudioFrame::C_NONE:
+            {
+                count = std::min(count, maxBytes / 4);
+                d.resize(d.size() + count * 4);
+                char * p = d.data() + d.size() - count * 4;
+                for (size_t i = 0; i < count; ++i, p += 4)
+                    set32(p, floatBits(s[i]));
+                return count;
+            }
+
+            case UdpAudioFrame::C_INT16:
+            {
+                count = std::min(count, maxBytes / 2);
+                d.resize(d.size() + count * 2);
+                char * p = d.data() + d.size() - count * 2;
+                for (size_t i = 0; i < count; ++i, p += 2)
+                {
+                    const F32 v = std::max(F32(-1), std::min(F32(1), s[i]));
+                    set16(p, uint16_t(int16_t(std::lround(v * 32767.f))));
+                }
+                return count;
+            }
+
+            case UdpAudioFrame::C_LOSSLESS:
+            {
+                // worst case is 5 bytes per sample
+                const int start = d.size();
+                d.resize(start + std::min(count * 5, maxBytes));
+                char * p = d.data() + start;
+                size_t bytes = 0, i = 0;
+                uint32_t prev = 0;
+                for (; i < count; ++i)
+                {
+                    const uint32_t bits = floatBits(s[i]),
+                                   x = bits ^ prev;
+                    prev = bits;
+
+                    // count zero bytes at both ends
+                    uint32_t tz = 0, n = 0;
+                    if (x)
+                    {
+                        while (!((x >> (tz * 8)) & 0xff))
+                            ++tz;
+                        n = 4 - tz;
+                        while (!((x >> ((tz + n - 1) * 8)) & 0xff))
+                            --n;
+                    }
+
+                    if (bytes + 1 + n > maxBytes)
+                        break;
+
+                    p[bytes++] = char((tz << 4) | n);
+                    for (uint32_t k = 0; k < n; ++k)
+                        p[bytes++] = char(x >> ((tz + k) * 8));
+                }
+                d.resize(start + bytes);
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    /** Decodes @p count samples from exactly @p bytes bytes */
+    bool decode(const uchar * p, size_t bytes, UdpAudioFrame::Compression c,
+                F32 * s, size_t count)
+    {
+        switch (c)
+        {
+            case UdpAudioFrame::C_NONE:
+                if (bytes != count * 4)
+                    return false;
+                for (size_t i = 0; i < count; ++i, p += 4)
+                    s[i] = bitsFloat(get32(p));
+                return true;
+
+            case UdpAudioFrame::C_INT16:
+                if (bytes != count * 2)
+                    return false;
+                for (size_t i = 0; i < count; ++i, p += 2)
+                    s[i] = F32(int16_t(get16(p))) / 32767.f;
+                return true;
+
+            case UdpAudioFrame::C_LOSSLESS:
+            {
+                const uchar * e = p + bytes;
+                uint32_t prev = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (p >= e)
+                        return false;
+                    const uint32_t tz = *p >> 4, n = *p & 0xf;
+                    ++p;
+                    if (tz + n > 4 || p + n > e)
+                        return false;
+                    uint32_t x = 0;
+                    for (uint32_t k = 0; k < n; ++k)
+                        x |= uint32_t(*p++) << ((tz + k) * 8);
+                    prev ^= x;
+                    s[i] = bitsFloat(prev);
+                }
+                return p == e;
+            }
+        }
+        return false;
+    }
+
+} // namespace
+
+
+uint32_t UdpAudioFrame::streamId(const QString& id)
+{
+    const QByteArray utf8 = id.toUtf8();
+    const uint64_t h = MATH::getHashFnv64(utf8.constData(), utf8.size());
+    return uint32_t(h ^ (h >> 32));
+}
+
+UdpAudioFrame::UdpAudioFrame(size_t maxBytes, Compression c)
+    : p_maxBytes_       (std::max(maxBytes, headerSize + partHeaderSize + 8))
+    , p_compression_    (c > C_LOSSLESS ? C_NONE : c)
+    , p_sequence_       (0)
+    , p_numParts_       (0)
+{
+    clear(0);
+}
+
+void UdpAudioFrame::setMaxBytes(size_t bytes)
+{
+    p_maxBytes_ = std::max(bytes, headerSize + partHeaderSize + 8);
+}
+
+void UdpAudioFrame::clear(uint32_t seq)
+{
+    p_sequence_ = seq;
+    p_numParts_ = 0;
+
+    p_data_.resize(headerSize);
+    char * p = p_data_.data();
+    set32(p, frameMagic);
+    set32(p + 4, seq);
+    set16(p + 8, 0);
+    p[10] = char(p_compression_);
+    p[11] = 0;
+}
+
+size_t UdpAudioFrame::addPart(uint32_t stream, SamplePos pos, size_t blockSize,
+                              size_t offset, const F32 *samples, size_t count)
+{
+    if (p_numParts_ >= 0xffff || blockSize > 0xffff
+            || size_t(p_data_.size()) + partHeaderSize >= p_maxBytes_)
+        return 0;
+
+    count = std::min(count, size_t(0xffff));
+
+    const int headerPos = p_data_.size();
+    p_data_.resize(headerPos + partHeaderSize);
+
+    // compression of this frame, see clear()
+    const Compression comp = Compression(p_data_.at(10));
+
+    const size_t num = encode(p_data_, comp, samples, count,
+                              p_maxBytes_ - p_data_.size());
+    if (num == 0)
+    {
+        p_data_.resize(headerPos);
+        return 0;
+    }
+
+    char * p = p_data_.data() + headerPos;
+    set32(p, stream);
+    set64(p + 4, pos);
+    set16(p + 12, blockSize);
+    set16(p + 14, offset);
+    set16(p + 16, num);
+    set16(p + 18, p_data_.size() - headerPos - partHeaderSize);
+
+    ++p_numParts_;
+    set16(p_data_.data() + 8, p_numParts_);
+
+    return num;
+}
+
+bool UdpAudioFrame::read(const QByteArray &data, uint32_t *sequence,
+                         std::function<bool (uint32_t)> accept,
+                         std::function<void (const Part &)> onPart)
+{
+    const size_t size = data.size();
+    const uchar * d = reinterpret_cast<const uchar*>(data.constData());
+
+    if (size < headerSize || get32(d) != frameMagic || d[10] > C_LOSSLESS)
+        return false;
+
+    const size_t numParts = get16(d + 8);
+    const Compression comp = Compression(d[10]);
+
+    // validate headers
+    std::vector<Part> parts(numParts);
+    std::vector<size_t> payloadPos(numParts), payloadBytes(numParts);
+    std::vector<uint8_t> accepted(numParts);
+    size_t pos = headerSize, numSamples = 0;
+    for (size_t i = 0; i < numParts; ++i)
+    {
+        if (pos + partHeaderSize > size)
+            return false;
+        Part& part = parts[i];
+        part.stream = get32(d + pos);
+        part.pos = get64(d + pos + 4);
+        part.blockSize = get16(d + pos + 12);
+        part.offset = get16(d + pos + 14);
+        part.count = get16(d + pos + 16);
+        payloadBytes[i] = get16(d + pos + 18);
+        payloadPos[i] = pos + partHeaderSize;
+        pos += partHeaderSize + payloadBytes[i];
+        if (pos > size || part.offset + part.count > part.blockSize)
+            return false;
+        accepted[i] = !accept || accept(part.stream);
+        if (accepted[i])
+            numSamples += part.count;
+    }
+
+    // decode
+    std::vector<F32> samples(numSamples);
+    numSamples = 0;
+    for (size_t i = 0; i < numParts; ++i)
+    {
+        if (!accepted[i])
+            continue;
+        if (!decode(d + payloadPos[i], payloadBytes[i], comp,
+                    samples.data() + numSamples, parts[i].count))
+            return false;
+        parts[i].samples = samples.data() + numSamples;
+        numSamples += parts[i].count;
+    }
+
+    if (sequence)
+        *sequence = get32(d + 4);
+
+    for (size_t i = 0; i < numParts; ++i)
+        if (accepted[i])
+            onPart(parts[i]);
+
+    return true;
+}
+
+
+} // namespace MO
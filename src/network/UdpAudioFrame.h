@@ -0,0 +1,127 @@
+/** @file udpaudioframe.h
+
+    @brief Binary datagram format for streaming audio blocks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_UDPAUDIOFRAME_H
+#define MOSRC_NETWORK_UDPAUDIOFRAME_H
+
+#include <cinttypes>
+#include <cstddef>
+#include <functional>
+
+#include <QByteArray>
+#include <QString>
+
+#include "types/float.h"
+
+namespace MO {
+
+/** One datagram holding parts of the sample blocks of many channels.
+
+    Layout (little endian):
+    @code
+    frame header, 12 bytes
+        uint32  magic "MOA1"
+        uint32  sequence number
+        uint16  number of parts
+        uint8   Compression
+        uint8   reserved
+    per part, 20 bytes + payload
+        uint32  stream id, see streamId()
+        uint64  sample position of the block
+        uint16  block size
+        uint16  offset of the first sample in the block
+        uint16  number of samples
+        uint16  payload bytes
+    @endcode
+
+    Blocks that do not fit into the remaining space are split into parts,
+    so a frame never exceeds maxBytes().
+    */
+class UdpAudioFrame
+{
+public:
+
+    enum Compression
+    {
+        /** 32 bit floats */
+        C_NONE,
+        /** 16 bit integers, clamped to [-1,1] */
+        C_INT16,
+        /** xor of consecutive float bits with zero bytes removed */
+        C_LOSSLESS
+    };
+
+    /** A part of a received block */
+    struct Part
+    {
+        uint32_t stream;
+        SamplePos pos;
+        uint blockSize, offset, count;
+        /** count() decoded samples */
+        const F32 * samples;
+    };
+
+    static const size_t headerSize = 12;
+    static const size_t partHeaderSize = 20;
+
+    /** Returns a 32 bit id for the stream identifier string */
+    static uint32_t streamId(const QString& id);
+
+    explicit UdpAudioFrame(size_t maxBytes = 1400, Compression c = C_NONE);
+
+    // ------------ getter -------------
+
+    size_t maxBytes() const { return p_maxBytes_; }
+    Compression compression() const { return p_compression_; }
+    uint32_t sequence() const { return p_sequence_; }
+    size_t numParts() const { return p_numParts_; }
+    bool isEmpty() const { return p_numParts_ == 0; }
+
+    /** The frame as it would be send */
+    const QByteArray& data() const { return p_data_; }
+
+    // ------------ setter -------------
+
+    void setMaxBytes(size_t bytes);
+    /** Takes effect with the next clear() */
+    void setCompression(Compression c)
+        { p_compression_ = c > C_LOSSLESS ? C_NONE : c; }
+
+    /** Starts a new frame with the sequence number @p seq */
+    void clear(uint32_t seq);
+
+    /** Adds the samples of the block at @p pos, starting at @p offset.
+        Returns the number of samples that fit into the frame,
+        which may be 0 if the frame is full. */
+    size_t addPart(uint32_t stream, SamplePos pos, size_t blockSize,
+                   size_t offset, const F32 * samples, size_t count);
+
+    // ------------ reading ------------
+
+    /** Decodes the frame in @p data and calls @p onPart for each part
+        of the streams for which @p accept returns true.
+        If @p accept is empty, all parts are decoded.
+        Returns false and calls nothing if the data is not a valid frame. */
+    static bool read(const QByteArray& data, uint32_t * sequence,
+                     std::function<bool(uint32_t stream)> accept,
+                     std::function<void(const Part&)> onPart);
+
+private:
+
+    size_t p_maxBytes_;
+    Compression p_compression_;
+    uint32_t p_sequence_;
+    size_t p_numParts_;
+    QByteArray p_data_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_UDPAUDIOFRAME_H
@@ -0,0 +1,147 @@
+/** @file udpaudiojitterbuffer.cpp
+
+    @brief Reordering and loss concealment for received audio blocks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <cstring>
+
+#include "UdpAudioJitterBuffer.h"
+
+namespace MO {
+
+namespace {
+
+    /** Blocks further away from the expected position start a new stream */
+    const size_t restartBlocks = 64;
+
+} // namespace
+
+
+UdpAudioJitterBuffer::UdpAudioJitterBuffer(size_t blockSize, size_t depth)
+    : p_blockSize_      (blockSize)
+    , p_depth_          (depth)
+    , p_numDelivered_   (0)
+    , p_numConcealed_   (0)
+    , p_numLate_        (0)
+{
+    clear();
+}
+
+void UdpAudioJitterBuffer::setBlockSize(size_t blockSize)
+{
+    p_blockSize_ = blockSize;
+    clear();
+}
+
+void UdpAudioJitterBuffer::clear()
+{
+    p_blocks_.clear();
+    p_started_ = false;
+    p_nextPos_ = 0;
+    p_last_.clear();
+    p_concealAmp_ = 1.f;
+}
+
+void UdpAudioJitterBuffer::addPart(
+        SamplePos pos, size_t offset, const F32 * samples, size_t count)
+{
+    if (p_blockSize_ == 0 || offset + count > p_blockSize_)
+        return;
+
+    if (p_started_ && pos < p_nextPos_)
+    {
+        // e.g. the server was restarted
+        if (p_nextPos_ - pos > restartBlocks * p_blockSize_)
+            clear();
+        else
+        {
+            ++p_numLate_;
+            return;
+        }
+    }
+
+    Block& b = p_blocks_[pos];
+    if (b.samples.empty())
+    {
+        b.samples.resize(p_blockSize_);
+        b.received.resize(p_blockSize_);
+        b.numReceived = 0;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        b.samples[offset + i] = samples[i];
+        if (!b.received[offset + i])
+        {
+            b.received[offset + i] = 1;
+            ++b.numReceived;
+        }
+    }
+}
+
+bool UdpAudioJitterBuffer::pull(F32 * out, SamplePos * pos)
+{
+    if (p_blocks_.empty())
+        return false;
+
+    const SamplePos
+            first = p_blocks_.begin()->first,
+            last = p_blocks_.rbegin()->first;
+
+    // start with the lowest block once depth() blocks have arrived
+    if (!p_started_)
+    {
+        if (last < first + p_depth_ * p_blockSize_)
+            return false;
+        p_nextPos_ = first;
+        p_started_ = true;
+    }
+    // skip large gaps, e.g. after seeking
+    else if (first > p_nextPos_ + restartBlocks * p_blockSize_)
+        p_nextPos_ = first;
+
+    auto i = p_blocks_.find(p_nextPos_);
+    if (i != p_blocks_.end() && i->second.numReceived == p_blockSize_)
+    {
+        memcpy(out, &i->second.samples[0], p_blockSize_ * sizeof(F32));
+        p_last_.swap(i->second.samples);
+        p_concealAmp_ = 1.f;
+        p_blocks_.erase(i);
+        ++p_numDelivered_;
+    }
+    // waited long enough?
+    else if (last >= p_nextPos_ + p_depth_ * p_blockSize_)
+    {
+        p_conceal_(i != p_blocks_.end() ? &i->second : nullptr, out);
+        if (i != p_blocks_.end())
+            p_blocks_.erase(i);
+        ++p_numConcealed_;
+    }
+    else
+        return false;
+
+    *pos = p_nextPos_;
+    p_nextPos_ += p_blockSize_;
+    return true;
+}
+
+void UdpAudioJitterBuffer::p_conceal_(Block * b, F32 * out)
+{
+    p_concealAmp_ *= .5f;
+
+    for (size_t k = 0; k < p_blockSize_; ++k)
+    {
+        if (b && b->received[k])
+            out[k] = b->samples[k];
+        else
+            out[k] = p_last_.empty() ? 0.f : p_last_[k] * p_concealAmp_;
+    }
+}
+
+
+} // namespace MO
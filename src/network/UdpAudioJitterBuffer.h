@@ -0,0 +1,95 @@
+/** @file udpaudiojitterbuffer.h
+
+    @brief Reordering and loss concealment for received audio blocks
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_NETWORK_UDPAUDIOJITTERBUFFER_H
+#define MOSRC_NETWORK_UDPAUDIOJITTERBUFFER_H
+
+#include <cstddef>
+#include <cinttypes>
+#include <map>
+#include <vector>
+
+#include "types/float.h"
+
+namespace MO {
+
+/** Collects the parts of the sample blocks of one stream
+    and delivers complete blocks in order of their sample position.
+
+    Delivery starts when blocks spanning depth() blocks have arrived.
+    A block that is still missing when depth() newer blocks have arrived
+    is concealed by repeating the last delivered block with decreasing
+    amplitude. Samples of a partially received block are used as they are.
+    */
+class UdpAudioJitterBuffer
+{
+public:
+    explicit UdpAudioJitterBuffer(size_t blockSize = 0, size_t depth = 4);
+
+    // ------------ getter -------------
+
+    size_t blockSize() const { return p_blockSize_; }
+
+    /** Maximum number of blocks to wait for a missing block */
+    size_t depth() const { return p_depth_; }
+
+    /** Number of blocks waiting */
+    size_t numWaiting() const { return p_blocks_.size(); }
+
+    /** Number of complete blocks delivered */
+    uint64_t numDelivered() const { return p_numDelivered_; }
+
+    /** Number of missing or incomplete blocks that were concealed */
+    uint64_t numConcealed() const { return p_numConcealed_; }
+
+    /** Number of parts received too late */
+    uint64_t numLate() const { return p_numLate_; }
+
+    // ------------ setter -------------
+
+    /** Sets the block size and clears the buffer */
+    void setBlockSize(size_t blockSize);
+    void setDepth(size_t depth) { p_depth_ = depth; }
+
+    /** Forgets all blocks, the next block starts a new stream */
+    void clear();
+
+    // ------------- io ----------------
+
+    /** Adds @p count samples of the block at @p pos, starting at @p offset */
+    void addPart(SamplePos pos, size_t offset, const F32 * samples, size_t count);
+
+    /** Writes the next block in order to @p out and its position to @p pos.
+        Returns false if the next block is not available yet. */
+    bool pull(F32 * out, SamplePos * pos);
+
+private:
+
+    struct Block
+    {
+        std::vector<F32> samples;
+        std::vector<uint8_t> received;
+        size_t numReceived;
+    };
+
+    void p_conceal_(Block * b, F32 * out);
+
+    size_t p_blockSize_, p_depth_;
+    std::map<SamplePos, Block> p_blocks_;
+    bool p_started_;
+    SamplePos p_nextPos_;
+    std::vector<F32> p_last_;
+    F32 p_concealAmp_;
+    uint64_t p_numDelivered_, p_numConcealed_, p_numLate_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_NETWORK_UDPAUDIOJITTERBUFFER_H
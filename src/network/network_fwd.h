@@ -19,6 +19,8 @@ namespace MO
     class NetEventSysInfo;
     class NetEventFileInfo;
     class NetEventFile;
+    class NetEventScene;
+    class NetEventSceneDelta;
     class NetworkManager;
     class EventCom;
     class TcpServer;
@@ -26,6 +28,12 @@ namespace MO
     class ClientInfo;
     class Client;
     class ClientEngine;
+    class ClockSync;
+    class FileManifest;
+    class FileServer;
+    class FileTransfer;
+    class SceneDelta;
+    class SceneDeltaRecorder;
     class UdpAudioConnection;
 
 } // namespace MO
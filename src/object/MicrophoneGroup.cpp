@@ -192,6 +192,10 @@ void MicrophoneGroup::calculateMicrophoneTransformation(
         mics[i]->setDirectionExponent(dirExp);
         mics[i]->setDistanceSound(useDist, minDist, maxDist);
 
+        // same key distance as the object
+        TransformationBuffer * tbuf = mics[i]->transformationBuffer();
+        tbuf->setDecimation(objectTransformation->decimation());
+
         // direction -> matrix
         Vec3 micdir = mic_vec[i];
         Mat4 micmat = compute_orthogonals4(micdir);
@@ -209,17 +213,18 @@ void MicrophoneGroup::calculateMicrophoneTransformation(
             micmat2[3].y = micdir.y * dis;
             micmat2[3].z = micdir.z * dis;
 #endif
-            for (uint j=0; j<mics[i]->transformationBuffer()->bufferSize(); ++j)
-                mics[i]->transformationBuffer()->setTransformation(
-                        objectTransformation->transformation(j) * micmat2
-                        , j);
+            // for each key of the object's transformation
+            for (uint j=0; j<tbuf->numKeys(); ++j)
+                tbuf->key(j) = objectTransformation->transformation(
+                                    tbuf->keySample(j)) * micmat2;
         }
         else
-        // for each sample
-        for (uint j=0; j<mics[i]->transformationBuffer()->bufferSize(); ++j)
+        // for each key
+        for (uint j=0; j<tbuf->numKeys(); ++j)
         {
+            const SamplePos sample = tbuf->keySample(j);
             RenderTime btime(time);
-            btime += Double(j) * sampleRateInv();
+            btime += Double(sample) * sampleRateInv();
 
             const Float dis = Float(paramMicDist_->value(btime));
             Mat4 micmat2 = micmat;
@@ -227,10 +232,10 @@ void MicrophoneGroup::calculateMicrophoneTransformation(
             micmat2[3].y = micdir.y * dis;
             micmat2[3].z = micdir.z * dis;
 
-            mics[i]->transformationBuffer()->setTransformation(
-                        objectTransformation->transformation(j) * micmat2
-                        , j);
+            tbuf->key(j) = objectTransformation->transformation(sample) * micmat2;
         }
+
+        tbuf->updateKeys();
     }
 }
 
@@ -171,7 +171,15 @@ bool ObjectPrivate::registerObject(Object * obj)
 
 void ObjectPrivate::setObjectId(Object * o, const QString& id)
 {
+    // keep the id index of the scene up-to-date
+    Scene * scene = o->parentObject() ? o->sceneObject() : 0;
+    if (scene)
+        scene->unindexObjects_(o, false);
+
     o->pobj_->idName = id;
+
+    if (scene)
+        scene->indexObjects_(o, false);
 }
 
 void ObjectPrivate::addObject(Object* parent, Object* newChild, int index)
@@ -906,6 +914,10 @@ void Object::setParentObject_(Object *parent, int index)
     // and add to child list
     pobj_->parentObject->pobj_->addChildObjectHelper(this, index);
 
+    // add branch to the id index
+    if (auto scene = sceneObject())
+        scene->indexObjects_(this);
+
     // signal this object
     this->onParentChanged();
 }
@@ -954,6 +966,11 @@ bool Object::p_takeChild_(Object *child)
 {
     if (pobj_->childObjects.removeOne(child))
     {
+        // remove branch from the id index
+        // while the entries still point to living objects
+        if (auto scene = sceneObject())
+            scene->unindexObjects_(child);
+
         return pobj_->childrenHaveChanged = true;
     }
     return false;
@@ -1091,6 +1108,10 @@ void Object::pobj_->p_makeUniqueIds_(QSet<QString> &existing)
 */
 Object * Object::findChildObject(const QString &id, bool recursive, Object * ignore) const
 {
+    // the scene keeps an index of all ids
+    if (recursive && !ignore && isScene())
+        return static_cast<const Scene*>(this)->findObjectById(id);
+
     for (auto o : pobj_->childObjects)
         if (o != ignore && o->idName() == id)
             return o;
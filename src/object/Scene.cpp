@@ -49,9 +49,11 @@
 #include "gl/FrameBufferObject.h"
 #include "gl/ScreenQuad.h"
 #include "gl/Texture.h"
+#include "gl/TextureLoader.h"
 #include "gl/RenderSettings.h"
 #include "gl/SceneDebugRenderer.h"
 #include "io/CurrentTime.h"
+#include "math/Frustum.h"
 #include "io/XmlStream.h"
 #include "tool/LocklessQueue.h"
 #include "projection/ProjectionSystemSettings.h"
@@ -84,6 +86,9 @@ Scene::Scene()
     , p_isShutDown_           (false)
     , p_fboFinal_             (0)
     , p_debugRenderOptions_   (0)
+    , p_frustumCulling_       (true)
+    , p_numCulled_            (0)
+    , p_numRendered_          (0)
     , p_freeCameraIndex_      (-1)
     , p_freeCameraMatrix_     (1.0)
     , p_projectionSettings_   (new ProjectionSystemSettings())
@@ -252,6 +257,11 @@ void Scene::findObjects_()
     p_allObjects_ = findChildObjects<Object>(QString(), true);
     p_allObjects_.prepend(this);
 
+    // the incremental updates in the tree functions miss objects
+    // that were added otherwise (e.g. when deserializing)
+    if (p_idIndex_.size() != p_allObjects_.size() - 1)
+        rebuildIdIndex_();
+
     // all cameras
     p_cameras_ = findChildObjects<Camera>(QString(), true);
 
@@ -650,6 +660,41 @@ void Scene::moveObject(Object *object, Object *newParent, int newIndex)
     render_();
 }
 
+Object * Scene::findObjectById(const QString &id) const
+{
+    return p_idIndex_.value(id, 0);
+}
+
+void Scene::indexObjects_(Object * root, bool recursive)
+{
+    p_idIndex_.insert(root->idName(), root);
+    if (recursive)
+        for (auto c : root->childObjects())
+            indexObjects_(c);
+}
+
+void Scene::unindexObjects_(Object * root, bool recursive)
+{
+    // compare pointers only, the entry might belong to another object
+    auto i = p_idIndex_.find(root->idName());
+    if (i != p_idIndex_.end() && i.value() == root)
+        p_idIndex_.erase(i);
+    if (recursive)
+        for (auto c : root->childObjects())
+            unindexObjects_(c);
+}
+
+void Scene::rebuildIdIndex_()
+{
+    MO_DEBUG_TREE("Scene::rebuildIdIndex_()");
+
+    p_idIndex_.clear();
+    p_idIndex_.reserve(p_allObjects_.size());
+    for (auto o : p_allObjects_)
+        if (o != this)
+            p_idIndex_.insert(o->idName(), o);
+}
+
 void Scene::tellObjectsAboutToDelete_(
         const QList<Object *>& toTell, const QList<Object *>& deleted)
 {
@@ -1103,6 +1148,9 @@ void Scene::renderScene(const RenderTime& time, bool paintToScreen)//, GL::Frame
     {
         // ---------- lazy resource managment -------------
 
+        // new time slice for texture uploads
+        GL::TextureLoader::beginFrame();
+
         // free deleted objects resources
         destroyDeletedObjects_(true);
 
@@ -1149,6 +1197,11 @@ void Scene::renderScene(const RenderTime& time, bool paintToScreen)//, GL::Frame
         // update lighting uniform-ready data
         updateLightSettings_(time);
 
+        // world-space bounding boxes
+        if (p_frustumCulling_)
+            for (auto o : p_glObjects_)
+                o->p_updateBoundingVolume_();
+
     }
     catch (Exception & e)
     {
@@ -1159,6 +1212,8 @@ void Scene::renderScene(const RenderTime& time, bool paintToScreen)//, GL::Frame
 
     // --- render ShaderObjects and TextureObjects ----
 
+    p_numCulled_ = p_numRendered_ = 0;
+
     if (!p_frameDrawers_.isEmpty())
     {
         GL::RenderSettings renderSet;
@@ -1223,6 +1278,9 @@ void Scene::renderScene(const RenderTime& time, bool paintToScreen)//, GL::Frame
 
                             camSpace.setCubeViewMatrix( camera->cameraViewMatrix(i) * viewm );
 
+                            const MATH::Frustum frustum(
+                                camSpace.projectionMatrix() * camSpace.cubeViewMatrix());
+
                             // render each opengl object per camera & per cube-face
                             for (ObjectGl * o : p_glObjectsPerCamera_[cindex])
                             if (!o->isShader() && !o->isTexture() // don't render shader objects per camera
@@ -1233,7 +1291,14 @@ void Scene::renderScene(const RenderTime& time, bool paintToScreen)//, GL::Frame
                                     && !(o->isUpdateRequest() || o->params()->haveInputsChanged(time)))
                                         continue;
 
+                                if (p_frustumCulling_ && !o->p_isInFrustum_(frustum))
+                                {
+                                    ++p_numCulled_;
+                                    continue;
+                                }
+
                                 o->p_renderGl_(renderSet, time);
+                                ++p_numRendered_;
                             }
 
                             // render debug objects
@@ -15,6 +15,7 @@
 
 #include <QTimer>
 #include <QSize>
+#include <QHash>
 
 #include "Object.h"
 #include "gl/opengl_fwd.h"
@@ -40,7 +41,8 @@ class ProjectionSystemSettings;
 */
 class Scene : public Object
 {
-    friend class Object; // for updateTree_()
+    friend class Object; // for updateTree_() and the id index
+    friend class ObjectPrivate; // for the id index
     friend class ScopedSceneLockRead;
     friend class ScopedSceneLockWrite;
     friend class AudioOutThread;
@@ -53,7 +55,8 @@ public:
         DD_AUDIO_SOURCES    = 1,
         DD_MICROPHONES      = 1<<1,
         DD_CAMERAS          = 1<<2,
-        DD_LIGHT_SOURCES    = 1<<3
+        DD_LIGHT_SOURCES    = 1<<3,
+        DD_BOUNDING_VOLUMES = 1<<4
     };
 
     struct Locator
@@ -203,6 +206,20 @@ public:
         { p_debugRenderOptions_ = options; render_(); }
     int debugRenderOptions() const { return p_debugRenderOptions_; }
 
+    // ----------- culling ---------------------
+
+    /** Enables skipping of objects whose bounding box
+        is outside the camera (or cube-face) frustum */
+    void setFrustumCulling(bool enable) { p_frustumCulling_ = enable; render_(); }
+    bool isFrustumCulling() const { return p_frustumCulling_; }
+
+    /** Number of object renders skipped by frustum culling in the last frame,
+        counted per camera and cube-face */
+    uint numCulledObjects() const { return p_numCulled_; }
+    /** Number of object renders in the last frame,
+        counted per camera and cube-face */
+    uint numRenderedObjects() const { return p_numRendered_; }
+
     // ----------- projection ------------------
 
     /** Sets the projection settings */
@@ -279,6 +296,12 @@ public:
 
     /** @} */
 
+    /** Returns the object with the given idName() anywhere below the scene,
+        or NULL. Uses an index that Object updates whenever a child is added,
+        removed or renamed, so this is O(1).
+        Object::findChildObject() redirects recursive scene searches here. */
+    Object * findObjectById(const QString& id) const;
+
     // ------------- runtime -------------------
 
     /** Sets the playing-flag, nothing else. */
@@ -349,6 +372,15 @@ private:
     /** Collects all special child objects */
     void findObjects_();
 
+    /** Adds @p root and all its children to the id index.
+        Called by Object when it's added to a parent in this scene. */
+    void indexObjects_(Object * root, bool recursive = true);
+    /** Removes @p root and all its children from the id index.
+        Called by Object when it's removed from a parent in this scene. */
+    void unindexObjects_(Object * root, bool recursive = true);
+    /** Creates the id index from scratch */
+    void rebuildIdIndex_();
+
     void updateChildrenChanged_();
     /** Tells all objects how much threads we got */
     void updateNumberThreads_();
@@ -437,6 +469,9 @@ private:
     std::vector<GL::SceneDebugRenderer*> p_debugRenderer_;
     int p_debugRenderOptions_;
 
+    bool p_frustumCulling_;
+    uint p_numCulled_, p_numRendered_;
+
     int p_freeCameraIndex_;
     Mat4 p_freeCameraMatrix_;
 
@@ -447,6 +482,8 @@ private:
 
     ClipController * p_clipController_;
     QList<Object*> p_allObjects_;
+    /** idName() to object, for all objects below the scene */
+    QHash<QString, Object*> p_idIndex_;
     QList<Object*> p_posObjects_;
     QList<Camera*> p_cameras_;
     QList<QList<ObjectGl*>> p_glObjectsPerCamera_;
@@ -454,7 +491,7 @@ private:
     QList<ShaderObject*> p_shaderObjects_;
     QList<LightSource*> p_lightSources_;
     QList<Object*> p_deletedObjects_, p_deletedParentObjects_;
-    QMap<QString, ModulatorObjectFloat*> p_uiModsFloat_;
+    QHash<QString, ModulatorObjectFloat*> p_uiModsFloat_;
 
     QMultiMap<Object*, Object*> p_dependMap_;
 
@@ -339,12 +339,17 @@ void Synthesizer::calculateSoundSourceTransformation(
 
     for (int i=0; i<snd.size(); ++i)
     {
-        for (uint j=0; j<rtime.bufferSize(); ++j)
+        // same key distance as the object
+        TransformationBuffer * tbuf = snd[i]->transformationBuffer();
+        tbuf->setDecimation(objectTransformation->decimation());
+
+        for (uint j=0; j<tbuf->numKeys(); ++j)
         {
             //Double time = sampleRateInv() * (rtime.sample() + j);
 
             // get object's transformation
-            const Mat4& trans = objectTransformation->transformation(j);
+            const Mat4 trans = objectTransformation->transformation(
+                                    tbuf->keySample(j));
 
             // get next audio transformation from fifo buffer
             if (!audioPosFifo_[i].empty()
@@ -361,8 +366,10 @@ void Synthesizer::calculateSoundSourceTransformation(
             // current audiosource transformation
             const Mat4 atrans = audioPos_[i];
 
-            snd[i]->transformationBuffer()->setTransformation(trans * atrans, j);
+            tbuf->key(j) = trans * atrans;
         }
+
+        tbuf->updateKeys();
     }
 }
 
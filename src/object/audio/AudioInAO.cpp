@@ -55,20 +55,36 @@ void AudioInAO::createParameters()
     params()->endParameterGroup();
 }
 
+void AudioInAO::setNumberThreads(uint num)
+{
+    AudioObject::setNumberThreads(num);
+    ampBuffer_.resize(num);
+}
+
+void AudioInAO::setAudioBuffers(uint thread, uint bufferSize,
+                                const QList<AUDIO::AudioBuffer*>&,
+                                const QList<AUDIO::AudioBuffer*>&)
+{
+    ampBuffer_[thread].resize(bufferSize);
+}
+
 void AudioInAO::processAudio(const RenderTime& time)
 {
     // simply copy inputs to outputs here and apply amplitude
 
-    if (paramAmp_->isModulated())
+    // (buffer is sized in setAudioBuffers(), never on the audio thread)
+    auto& ampBuf = ampBuffer_[time.thread()];
+    if (paramAmp_->isModulated() && ampBuf.size() >= time.bufferSize())
     {
+        // evaluate amplitude once per block for all channels
+        paramAmp_->getValuesBlock(time, &ampBuf[0], time.bufferSize());
+
+        const F32 * ampPtr = &ampBuf[0];
         AUDIO::AudioBuffer::process(audioInputs(time.thread()), audioOutputs(time.thread()),
         [=](uint, const AUDIO::AudioBuffer * in, AUDIO::AudioBuffer * out)
         {
             for (SamplePos i=0; i<time.bufferSize(); ++i)
-            {
-                F32 amp = paramAmp_->value(time + i);
-                out->write(i, amp * in->read(i));
-            }
+                out->write(i, ampPtr[i] * in->read(i));
         });
     }
     else
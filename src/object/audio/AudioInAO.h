@@ -22,17 +22,24 @@ public:
     MO_OBJECT_CONSTRUCTOR(AudioInAO)
 
     virtual void createParameters() Q_DECL_OVERRIDE;
+    virtual void setNumberThreads(uint num) Q_DECL_OVERRIDE;
 
     /** pull into public namespace */
     void setNumberAudioInputsOutputs(int num) { AudioObject::setNumberAudioInputsOutputs(num, num, false); }
 
 protected:
 
+    virtual void setAudioBuffers(uint thread, uint bufferSize,
+                                 const QList<AUDIO::AudioBuffer*>& inputs,
+                                 const QList<AUDIO::AudioBuffer*>& outputs) Q_DECL_OVERRIDE;
     virtual void processAudio(const RenderTime& time) Q_DECL_OVERRIDE;
 private:
 
     ParameterFloat
         * paramAmp_;
+
+    /** Per-thread block of modulated amplitudes */
+    std::vector<std::vector<F32>> ampBuffer_;
 };
 
 } // namespace MO
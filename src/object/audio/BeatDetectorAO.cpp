@@ -8,6 +8,8 @@
     <p>created 7/6/2016</p>
 */
 
+#include <algorithm>
+
 #include <QMutex>
 #include <QMutexLocker>
 
@@ -28,6 +30,28 @@ namespace MO {
 
 MO_REGISTER_OBJECT(BeatDetectorAO)
 
+namespace {
+
+    /** Returns @p matrix with dimensions @p dim and unshared data,
+        swapping with @p spare instead of copying the data
+        if a consumer still holds the last output. */
+    FloatMatrix& writableMatrix(FloatMatrix& matrix, FloatMatrix& spare,
+                                const std::vector<size_t>& dim)
+    {
+        if (matrix.useCount() > 1)
+        {
+            std::swap(matrix, spare);
+            // both in use, new storage
+            if (matrix.useCount() > 1)
+                matrix.clear();
+        }
+        if (!matrix.hasDimensions(dim))
+            matrix.setDimensions(dim);
+        return matrix;
+    }
+
+} // namespace
+
 class BeatDetectorAO::Private
 {
     public:
@@ -56,7 +80,11 @@ class BeatDetectorAO::Private
     FloatMatrix
             matrixBeat, matrixHistory,
             matrixConv, matrixSpeed, matrixSortedSpeed,
-            matrixCandis, matrixResponse;
+            matrixCandis, matrixResponse,
+    /** The previous outputs, reused when no consumer holds them anymore */
+            spareBeat, spareHistory,
+            spareConv, spareSpeed, spareSortedSpeed,
+            spareCandis, spareResponse;
 
     size_t initFftSize, initNumBins;
     QMutex matrixMutex;
@@ -283,7 +311,9 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
     beat.push(inputs[0]->readPointer(), inputs[0]->blockSize());
 
 
-    // copy to matrix output
+    // copy to matrix output,
+    // through raw pointers since the element accessors
+    // check for sharing on every call
     {
         QMutexLocker lock(&p_->matrixMutex);
         p_->hasMatrixChanged = true;
@@ -297,14 +327,13 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), 3 };
-                if (!p_->matrixBeat.hasDimensions(dim))
-                    p_->matrixBeat.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
+                Double * dst = writableMatrix(p_->matrixBeat, p_->spareBeat,
+                                              { beat.numBins(), 3 }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += 3)
                 {
-                    *p_->matrixBeat.data(i, 0) = beat.beat()[i];
-                    *p_->matrixBeat.data(i, 1) = beat.currentLevel()[i];
-                    *p_->matrixBeat.data(i, 2) = beat.averageLevel()[i];
+                    dst[0] = beat.beat()[i];
+                    dst[1] = beat.currentLevel()[i];
+                    dst[2] = beat.averageLevel()[i];
                 }
             }
             break;
@@ -319,12 +348,11 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), beat.numHistory() };
-                if (!p_->matrixHistory.hasDimensions(dim))
-                    p_->matrixHistory.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
-                    for (size_t j=0; j<beat.numHistory(); ++j)
-                        *p_->matrixHistory.data(i, j) = beat.beatHistory(i)[j];
+                const size_t w = beat.numHistory();
+                Double * dst = writableMatrix(p_->matrixHistory, p_->spareHistory,
+                                              { beat.numBins(), w }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += w)
+                    std::copy(beat.beatHistory(i), beat.beatHistory(i) + w, dst);
             }
             break;
         }
@@ -338,12 +366,11 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), beat.numHistory() };
-                if (!p_->matrixConv.hasDimensions(dim))
-                    p_->matrixConv.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
-                    for (size_t j=0; j<beat.numHistory(); ++j)
-                        *p_->matrixConv.data(i, j) = beat.convolution(i)[j];
+                const size_t w = beat.numHistory();
+                Double * dst = writableMatrix(p_->matrixConv, p_->spareConv,
+                                              { beat.numBins(), w }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += w)
+                    std::copy(beat.convolution(i), beat.convolution(i) + w, dst);
             }
             break;
         }
@@ -357,12 +384,11 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), beat.numFreqResponses() };
-                if (!p_->matrixResponse.hasDimensions(dim))
-                    p_->matrixResponse.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
-                    for (size_t j=0; j<beat.numFreqResponses(); ++j)
-                        *p_->matrixResponse.data(i, j) = beat.freqResponse(i)[j];
+                const size_t w = beat.numFreqResponses();
+                Double * dst = writableMatrix(p_->matrixResponse, p_->spareResponse,
+                                              { beat.numBins(), w }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += w)
+                    std::copy(beat.freqResponse(i), beat.freqResponse(i) + w, dst);
             }
             break;
         }
@@ -376,15 +402,14 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), 4 };
-                if (!p_->matrixSpeed.hasDimensions(dim))
-                    p_->matrixSpeed.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
+                Double * dst = writableMatrix(p_->matrixSpeed, p_->spareSpeed,
+                                              { beat.numBins(), 4 }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += 4)
                 {
-                    *p_->matrixSpeed.data(i, 0) = beat.beatsPerSecond(i);
-                    *p_->matrixSpeed.data(i, 1) = beat.lengthNormalized(i);
-                    *p_->matrixSpeed.data(i, 2) = beat.lengthBuffers(i);
-                    *p_->matrixSpeed.data(i, 3) = beat.matchCount(i);
+                    dst[0] = beat.beatsPerSecond(i);
+                    dst[1] = beat.lengthNormalized(i);
+                    dst[2] = beat.lengthBuffers(i);
+                    dst[3] = beat.matchCount(i);
                 }
             }
             break;
@@ -399,15 +424,15 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), 3 };
-                if (!p_->matrixSortedSpeed.hasDimensions(dim))
-                    p_->matrixSortedSpeed.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
+                Double * dst = writableMatrix(p_->matrixSortedSpeed,
+                                              p_->spareSortedSpeed,
+                                              { beat.numBins(), 3 }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += 3)
                 {
-                    *p_->matrixSortedSpeed.data(i, 0) = beat.sortedBeatsPerSecond(i);
-                    *p_->matrixSortedSpeed.data(i, 1) = beat.sortedLengthNormalized(i);
-                    *p_->matrixSortedSpeed.data(i, 2) = beat.sortedLengthBuffers(i);
-                    //*p_->matrixSortedSpeed.data(i, 3) = beat.sortedMatchCount(i);
+                    dst[0] = beat.sortedBeatsPerSecond(i);
+                    dst[1] = beat.sortedLengthNormalized(i);
+                    dst[2] = beat.sortedLengthBuffers(i);
+                    //dst[3] = beat.sortedMatchCount(i);
                 }
             }
             break;
@@ -422,12 +447,11 @@ void BeatDetectorAO::processAudio(const RenderTime& time)
 
             case 1:
             {
-                std::vector<size_t> dim = { beat.numBins(), beat.numHistory() };
-                if (!p_->matrixCandis.hasDimensions(dim))
-                    p_->matrixCandis.setDimensions(dim);
-                for (size_t i=0; i<beat.numBins(); ++i)
-                    for (size_t j=0; j<beat.numHistory(); ++j)
-                        *p_->matrixCandis.data(i, j) = beat.candidates(i)[j];
+                const size_t w = beat.numHistory();
+                Double * dst = writableMatrix(p_->matrixCandis, p_->spareCandis,
+                                              { beat.numBins(), w }).data();
+                for (size_t i=0; i<beat.numBins(); ++i, dst += w)
+                    std::copy(beat.candidates(i), beat.candidates(i) + w, dst);
             }
             break;
         }
@@ -8,9 +8,9 @@
     <p>created 03.05.2015</p>
 */
 
-#define MO_USE_KLANGFALTER_FOR_NOW
-
 #include <memory>
+#include <vector>
+#include <atomic>
 
 #include "ConvolveAO.h"
 #include "object/param/Parameters.h"
@@ -18,11 +18,7 @@
 #include "object/param/ParameterInt.h"
 #include "object/param/ParameterSelect.h"
 #include "object/param/ParameterFilename.h"
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-#   include "audio/3rd/KlangFalter/FFTConvolver.h"
-#else
-#   include "audio/tool/convolvebuffer.h"
-#endif
+#include "audio/tool/PartitionedConvolver.h"
 #include "audio/tool/MultiFilter.h"
 #include "audio/tool/SoundFileManager.h"
 #include "audio/tool/SoundFile.h"
@@ -30,6 +26,7 @@
 #include "audio/tool/Delay.h"
 #include "math/constants.h"
 #include "math/Convolution.h"
+#include "tool/LocklessQueue.h"
 #include "io/DataStream.h"
 
 
@@ -39,13 +36,43 @@ MO_REGISTER_OBJECT(ConvolveAO)
 
 struct ConvolveAO::Private
 {
-    Private(ConvolveAO * ao) : ao(ao)
+    Private(ConvolveAO * ao)
+        : ao            (ao),
+          kernel        (0),
+          nextKernel    (0),
+          blockSize     (0),
+          numChannels   (0),
+          delayCleared  (true)
     {
         filterHp.setType(AUDIO::MultiFilter::T_FIRST_ORDER_HIGH);
     }
 
+    ~Private()
+    {
+        deleteRetiredKernels();
+        delete nextKernel.exchange(0);
+        delete kernel;
+    }
+
+    /** The convolvers for all channels and their work buffers.
+        Everything the audio thread needs for one dsp path setting. */
+    struct Kernel
+    {
+        /** One convolver per channel */
+        std::vector<std::shared_ptr<AUDIO::PartitionedConvolver>> convolvers;
+        size_t blockSize;
+        AUDIO::AudioBuffer inbuf, outbuf;
+    };
+
     void updateFilter();
-    void initConvolver(size_t blockSize);
+    /** Loads the impulse response and publishes a new Kernel
+        for blockSize and numChannels. Never called from the audio thread. */
+    void prepareKernel();
+    /** Picks up a Kernel from prepareKernel() in the audio thread */
+    void swapKernel();
+    /** Deletes the kernels replaced by swapKernel(),
+        called with prepareKernel() */
+    void deleteRetiredKernels();
 
     ConvolveAO * ao;
 
@@ -66,16 +93,18 @@ struct ConvolveAO::Private
             * pPostProc,
             * pfType;
 
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-    ::fftconvolver::FFTConvolver convolver;
-#else
-    AUDIO::ConvolveBuffer convolver;
-#endif
-    AUDIO::AudioBuffer inbuf, outbuf, outbuf2;
+    /// Kernel used by the audio thread
+    Kernel * kernel;
+    /// Kernel published by prepareKernel()
+    std::atomic<Kernel*> nextKernel;
+    /// Kernels replaced in the audio thread
+    LocklessQueue<Kernel*> retiredKernels;
+    /// Settings of the dsp path, from setAudioBuffers()
+    std::atomic<size_t> blockSize, numChannels;
     AUDIO::Delay<F32, int> delay;
     AUDIO::MultiFilter filter, filterHp;
 
-    bool needUpdate, delayCleared;
+    bool delayCleared;
 };
 
 ConvolveAO::ConvolveAO()
@@ -188,7 +217,27 @@ void ConvolveAO::createParameters()
 void ConvolveAO::setSampleRate(uint samplerate)
 {
     AudioObject::setSampleRate(samplerate);
-    p_->needUpdate = true;
+    p_->prepareKernel();
+}
+
+void ConvolveAO::setAudioBuffers(uint thread, uint bufferSize,
+                                 const QList<AUDIO::AudioBuffer*>& inputs,
+                                 const QList<AUDIO::AudioBuffer*>& outputs)
+{
+    Q_UNUSED(thread);
+    Q_UNUSED(inputs);
+
+    // Called by the thread that builds the dsp path, see
+    // ObjectDspPath::preparePath(). The audio thread keeps using
+    // its current kernel until the new one is published.
+
+    // a replaced dsp path usually keeps the settings
+    if (p_->blockSize == bufferSize && p_->numChannels == (size_t)outputs.size())
+        return;
+
+    p_->blockSize = bufferSize;
+    p_->numChannels = outputs.size();
+    p_->prepareKernel();
 }
 
 void ConvolveAO::onParameterChanged(Parameter * p)
@@ -196,7 +245,7 @@ void ConvolveAO::onParameterChanged(Parameter * p)
     AudioObject::onParameterChanged(p);
 
     if (p == p_->pFile || p == p_->pChannel)
-        p_->needUpdate = true;
+        p_->prepareKernel();
 
     if (p == p_->pfType || p == p_->pfOrder)
         p_->updateFilter();
@@ -206,9 +255,8 @@ void ConvolveAO::onParametersLoaded()
 {
     AudioObject::onParametersLoaded();
 
-    p_->needUpdate = true;
     p_->updateFilter();
-    //p_->initConvolver();
+    p_->prepareKernel();
 }
 
 void ConvolveAO::Private::updateFilter()
@@ -239,56 +287,86 @@ void ConvolveAO::getNeededFiles(IO::FileList &files)
     files << IO::FileListEntry(p_->pFile->baseValue(), IO::FT_IMPULSE_RESPONSE);
 }
 
-void ConvolveAO::Private::initConvolver(size_t blockSize)
+void ConvolveAO::Private::prepareKernel()
 {
+    deleteRetiredKernels();
+
+    const size_t
+            bsize = blockSize,
+            nchan = numChannels;
+
+    // not connected to a dsp path yet
+    if (bsize == 0 || nchan == 0)
+        return;
+
     ao->clearError();
 
+    auto k = new Kernel;
+    k->blockSize = bsize;
+    k->inbuf.setSize(bsize);
+    k->outbuf.setSize(bsize);
+    k->convolvers.resize(nchan);
+    for (auto & c : k->convolvers)
+        c.reset(new AUDIO::PartitionedConvolver);
+
     // load IR file
     QString fn = pFile->baseValue();
-    if (fn.isEmpty())
-        return;
-
-    auto sf = AUDIO::SoundFileManager::getSoundFile(fn);
-    if (!sf->isOk())
+    if (!fn.isEmpty())
     {
+        auto sf = AUDIO::SoundFileManager::getSoundFile(fn);
+        if (!sf->isOk())
+            ao->setErrorMessage(QString("%1 not loaded").arg(fn));
+        else
+        {
+            auto sam = sf->getResampled(ao->sampleRate(),
+                        std::min(sf->numberChannels()-1, uint(pChannel->baseValue())));
+
+            // set kernel
+            for (auto & c : k->convolvers)
+                c->init(bsize, sam.data(), sam.size());
+        }
         sf->release();
-        ao->setErrorMessage(QString("%1 not loaded").arg(fn));
-        return;
     }
 
-    auto sam = sf->getResampled(ao->sampleRate(),
-                std::min(sf->numberChannels()-1, uint(pChannel->baseValue())));
-    sf->release();
+    // publish, an unused previous kernel is still ours
+    delete nextKernel.exchange(k);
+}
+
+void ConvolveAO::Private::swapKernel()
+{
+    Kernel * k = nextKernel.exchange(0);
+    if (!k)
+        return;
+
+    // deletion happens in prepareKernel()
+    if (kernel)
+        retiredKernels.produce(kernel);
+    kernel = k;
 
-    // set kernel
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-    convolver.init(blockSize, sam.data(), sam.size());
-#else
-    convolver.setKernel(sam.data(), sam.size());
-#endif
     delay.setNull();
     delayCleared = true;
 }
 
+void ConvolveAO::Private::deleteRetiredKernels()
+{
+    Kernel * k;
+    while (retiredKernels.consume(k))
+        delete k;
+}
+
 void ConvolveAO::processAudio(const RenderTime& time)
 {
-    // init convolution buffer
-    if (p_->needUpdate)
-    {
-        p_->needUpdate = false; // XXX not reentrant
-        p_->initConvolver(time.bufferSize());
-    }
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-    if (p_->convolver.blockSize() != time.bufferSize())
-        p_->initConvolver(time.bufferSize());
-#endif
+    p_->swapKernel();
 
-    // init output buffer
-    if (p_->outbuf.blockSize() != time.bufferSize())
+    // kernel not prepared for this dsp path
+    Private::Kernel * kernel = p_->kernel;
+    if (!kernel
+        || kernel->convolvers.size() != (size_t)audioOutputs(time.thread()).size()
+        || kernel->blockSize != time.bufferSize())
     {
-        // XXX not reentrant either
-        p_->outbuf.setSize(time.bufferSize());
-        p_->outbuf2.setSize(time.bufferSize());
+        AUDIO::AudioBuffer::bypass(audioInputs(time.thread()),
+                                   audioOutputs(time.thread()));
+        return;
     }
 
     bool doPp = p_->pPostProc->value(time);
@@ -309,9 +387,6 @@ void ConvolveAO::processAudio(const RenderTime& time)
         if (p_->delay.size() <= dtime)
             p_->delay.resize(dtime+1);
 
-        if (p_->inbuf.blockSize() != time.bufferSize())
-            p_->inbuf.setSize(time.bufferSize());
-
         p_->delayCleared = false;
 
         // update filter settings
@@ -345,49 +420,43 @@ void ConvolveAO::processAudio(const RenderTime& time)
     }
 
     AUDIO::AudioBuffer::process(audioInputs(time.thread()), audioOutputs(time.thread()),
-    [=](uint, const AUDIO::AudioBuffer * in, AUDIO::AudioBuffer * out)
+    [=](uint chan, const AUDIO::AudioBuffer * in, AUDIO::AudioBuffer * out)
     {
+        AUDIO::PartitionedConvolver * convolver = kernel->convolvers[chan].get();
+
         if (!doPp)
         {
             // convolve
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-            p_->convolver.process(in->readPointer(), p_->outbuf.writePointer(),
-                                  p_->outbuf.blockSize());
-#else
-            p_->convolver.process(in, &p_->outbuf);
-#endif
+            convolver->process(in->readPointer(), kernel->outbuf.writePointer(),
+                               kernel->outbuf.blockSize());
         }
         else
         {
             // get input
-            in->readBlock(p_->inbuf.writePointer());
+            in->readBlock(kernel->inbuf.writePointer());
             // mix delay feedback
             for (uint i = 0; i < time.bufferSize(); ++i)
-                p_->inbuf.writePointer()[i] +=
+                kernel->inbuf.writePointer()[i] +=
                     damt * p_->delay.read(dtime - i);
 
             // convolve
-#ifdef MO_USE_KLANGFALTER_FOR_NOW
-            p_->convolver.process(p_->inbuf.readPointer(), p_->outbuf.writePointer(),
-                                  p_->outbuf.blockSize());
-#else
-            p_->convolver.process(&p_->inbuf, &p_->outbuf);
-#endif
+            convolver->process(kernel->inbuf.readPointer(), kernel->outbuf.writePointer(),
+                               kernel->outbuf.blockSize());
 
             // filter
-            p_->filter.process(p_->outbuf.readPointer(),
-                               p_->inbuf.writePointer(), time.bufferSize());
-            p_->filterHp.process(p_->inbuf.readPointer(),
-                                 p_->outbuf.writePointer(), time.bufferSize());
+            p_->filter.process(kernel->outbuf.readPointer(),
+                               kernel->inbuf.writePointer(), time.bufferSize());
+            p_->filterHp.process(kernel->inbuf.readPointer(),
+                                 kernel->outbuf.writePointer(), time.bufferSize());
 
             // write convoluted signal to delay line
-            p_->delay.writeBlock(p_->outbuf.readPointer(), time.bufferSize());
+            p_->delay.writeBlock(kernel->outbuf.readPointer(), time.bufferSize());
 
         }
         // mix into output channel
         for (size_t i=0; i<time.bufferSize(); ++i)
             out->write(i, in->readPointer()[i] + wet * (
-                        amp * p_->outbuf.writePointer()[i] - in->readPointer()[i])
+                        amp * kernel->outbuf.writePointer()[i] - in->readPointer()[i])
                        );
     });
 
@@ -25,6 +25,9 @@ public:
     virtual void onParameterChanged(Parameter *) Q_DECL_OVERRIDE;
     virtual void updateParameterVisibility() Q_DECL_OVERRIDE;
     virtual void setSampleRate(uint samplerate) Q_DECL_OVERRIDE;
+    virtual void setAudioBuffers(uint thread, uint bufferSize,
+                                 const QList<AUDIO::AudioBuffer*>& inputs,
+                                 const QList<AUDIO::AudioBuffer*>& outputs) Q_DECL_OVERRIDE;
     virtual void getNeededFiles(IO::FileList &files) Q_DECL_OVERRIDE;
 protected:
 
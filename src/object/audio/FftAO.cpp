@@ -12,6 +12,8 @@
 
 //#define MO_USE_OOURA
 
+#include <algorithm>
+
 #include <QMutex>
 #include <QMutexLocker>
 
@@ -61,7 +63,16 @@ class FftAO::Private
 
     std::vector<AUDIO::ResampleBuffer<F32>> inbufs, outbufs;
     std::vector<AUDIO::FixedBlockDelay<F32>> delays;
-    FloatMatrix matrix;
+    /** The output, handed out as snapshot by valueFloatMatrix() */
+    FloatMatrix matrix,
+    /** The previous output, reused when no consumer holds it anymore */
+        spareMatrix;
+
+    /** Returns matrix with dimensions @p dim and unshared data,
+        swapping with spareMatrix instead of copying the data
+        if a consumer still holds the last output.
+        Call with locked matrixMutex. */
+    FloatMatrix& writableMatrix(const std::vector<size_t>& dim);
 
     size_t fftSize, delayInSamples;
     QMutex matrixMutex;
@@ -71,6 +82,20 @@ class FftAO::Private
     size_t ringWrite;
 };
 
+FloatMatrix& FftAO::Private::writableMatrix(const std::vector<size_t>& dim)
+{
+    if (matrix.useCount() > 1)
+    {
+        std::swap(matrix, spareMatrix);
+        // both in use, new storage
+        if (matrix.useCount() > 1)
+            matrix.clear();
+    }
+    if (!matrix.hasDimensions(dim))
+        matrix.setDimensions(dim);
+    return matrix;
+}
+
 FftAO::FftAO()
     : AudioObject   (),
       p_            (new Private())
@@ -314,29 +339,24 @@ void FftAO::processAudio(const RenderTime& time)
             case MM_OFF:
                 if (!p_->matrix.isEmpty())
                     p_->matrix.clear();
+                p_->spareMatrix.clear();
             break;
 
+            // write through raw pointers,
+            // the element accessors check for sharing on every call
             case MM_LINEAR:
             {
-                std::vector<size_t> dim = { p_->fftSize };
-                if (!p_->matrix.hasDimensions(dim))
-                    p_->matrix.setDimensions(dim);
-                for (size_t i=0; i<fft->size(); ++i)
-                    *p_->matrix.data(i) = outBuf[i];
+                Double * dst = p_->writableMatrix({ p_->fftSize }).data();
+                std::copy(outBuf, outBuf + p_->fftSize, dst);
             }
             break;
 
             case MM_SPLIT:
             {
-                size_t half = p_->fftSize/2;
-                std::vector<size_t> dim = { 2, half };
-                if (!p_->matrix.hasDimensions(dim))
-                    p_->matrix.setDimensions(dim);
-                for (size_t i=0; i<half; ++i)
-                {
-                    *p_->matrix.data(0, i) = outBuf[i];
-                    *p_->matrix.data(1, i) = outBuf[i+half];
-                }
+                const size_t half = p_->fftSize/2;
+                FloatMatrix& m = p_->writableMatrix({ 2, half });
+                std::copy(outBuf, outBuf + half, m.data(0, 0));
+                std::copy(outBuf + half, outBuf + p_->fftSize, m.data(1, 0));
             }
             break;
         }
@@ -8,6 +8,8 @@
     <p>created 7/4/2016</p>
 */
 
+#include <algorithm>
+
 #include <QMutex>
 #include <QMutexLocker>
 
@@ -41,11 +43,34 @@ class FloatMatrixAO::Private
         * paramSize;
 
     std::vector<AUDIO::ResampleBuffer<F32>> rebufs;
-    FloatMatrix matrix;
+    /** The output, handed out as snapshot by valueFloatMatrix() */
+    FloatMatrix matrix,
+    /** The previous output, reused when no consumer holds it anymore */
+        spareMatrix;
     bool hasMatrixChanged;
     QMutex matrixMutex;
+
+    /** Returns matrix with dimensions @p dim and unshared data,
+        swapping with spareMatrix instead of copying the data
+        if a consumer still holds the last output.
+        Call with locked matrixMutex. */
+    FloatMatrix& writableMatrix(const std::vector<size_t>& dim);
 };
 
+FloatMatrix& FloatMatrixAO::Private::writableMatrix(const std::vector<size_t>& dim)
+{
+    if (matrix.useCount() > 1)
+    {
+        std::swap(matrix, spareMatrix);
+        // both in use, new storage
+        if (matrix.useCount() > 1)
+            matrix.clear();
+    }
+    if (!matrix.hasDimensions(dim))
+        matrix.setDimensions(dim);
+    return matrix;
+}
+
 FloatMatrixAO::FloatMatrixAO()
     : AudioObject   (),
       p_            (new Private())
@@ -150,7 +175,8 @@ void FloatMatrixAO::setAudioBuffers(uint thread, uint bufferSize,
 
 void FloatMatrixAO::processAudio(const RenderTime& time)
 {
-    size_t width = p_->matrix.numDimensions() ? p_->matrix.size(0) : 0;
+    // the output matrix may be swapped or cleared, the size is the parameter
+    const size_t width = p_->paramSize->baseValue();
     if (width == 0)
         return;
 
@@ -172,11 +198,11 @@ void FloatMatrixAO::processAudio(const RenderTime& time)
 
         if (rebuf.hasBuffer())
         {
-            // copy to matrix output
+            // copy to matrix output through the raw pointer,
+            // the element accessors check for sharing on every call
             QMutexLocker lock(&p_->matrixMutex);
-            const F32* src = rebuf.buffer();
-            for (size_t i=0; i<width; ++i, ++src)
-                *p_->matrix.data(i) = *src;
+            std::copy(rebuf.buffer(), rebuf.buffer() + width,
+                      p_->writableMatrix({ width }).data());
             p_->hasMatrixChanged = true;
 
             rebuf.pop();
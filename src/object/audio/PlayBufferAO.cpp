@@ -59,7 +59,8 @@ class PlayBufferAO::Private
             * paramFile;
     ParameterSelect
             * paramRec,
-            * paramMode;
+            * paramMode,
+            * paramLoadMem;
 };
 
 PlayBufferAO::PlayBufferAO()
@@ -114,6 +115,12 @@ void PlayBufferAO::createParameters()
                                                       tr("The file to play from the buffer"),
                                                       IO::FT_SOUND,
                                                       "data/audio/speek/84macs.wav");
+    p_->paramLoadMem = params()->createBooleanParameter("playbuf_mem", tr("load to memory"),
+                                                        tr("When selected, the whole file will be loaded into memory, "
+                                                           "otherwise it gets streamed from disk"),
+                                                        tr("The file is streamed from disk"),
+                                                        tr("The file is completely loaded into memory"),
+                                                        true, true, false);
     p_->paramMode = params()->createSelectParameter("playbuf_mode", tr("buffer mode"),
                                                     tr("Selects the mode the buffer is used"),
                                                     {"buffer", "file"},
@@ -122,7 +129,8 @@ void PlayBufferAO::createParameters()
                                                     {Private::M_BUFFER, Private::M_FILE},
                                                     Private::M_BUFFER);
     params()->endParameterGroup();
-    p_->sndfile = AUDIO::SoundFileManager::getSoundFile(p_->paramFile->value());
+    p_->sndfile = AUDIO::SoundFileManager::getSoundFile(
+                p_->paramFile->value(), p_->paramLoadMem->baseValue());
 }
 
 void PlayBufferAO::onParameterChanged(Parameter *p)
@@ -131,12 +139,13 @@ void PlayBufferAO::onParameterChanged(Parameter *p)
     if(p==p_->paramSize) {
         p_->size = p_->paramSize->baseValue();
         p_->buffer.resize(p_->size * p_->ao->sampleRate());
-    } else if(p==p_->paramFile) {
+    } else if(p==p_->paramFile || p==p_->paramLoadMem) {
         if(p_->sndfile != NULL) {
             AUDIO::SoundFileManager::releaseSoundFile(p_->sndfile);
             p_->sndfile = NULL;
         }
-        p_->sndfile = AUDIO::SoundFileManager::getSoundFile(p_->paramFile->value());
+        p_->sndfile = AUDIO::SoundFileManager::getSoundFile(
+                p_->paramFile->value(), p_->paramLoadMem->baseValue());
     }
 }
 
@@ -150,7 +159,8 @@ void PlayBufferAO::onParametersLoaded()
         AUDIO::SoundFileManager::releaseSoundFile(p_->sndfile);
         p_->sndfile = NULL;
     }
-    p_->sndfile = AUDIO::SoundFileManager::getSoundFile(p_->paramFile->value());
+    p_->sndfile = AUDIO::SoundFileManager::getSoundFile(
+                p_->paramFile->value(), p_->paramLoadMem->baseValue());
     //while(!p_->sndfile->ok()) usleep(1);
 }
 
@@ -159,11 +169,13 @@ void PlayBufferAO::updateParameterVisibility()
     switch(p_->mode()) {
     case Private::M_BUFFER:
         p_->paramFile->setVisible(false);
+        p_->paramLoadMem->setVisible(false);
         p_->paramRec->setVisible(true);
         p_->paramSize->setVisible(true);
         break;
     case Private::M_FILE:
         p_->paramFile->setVisible(true);
+        p_->paramLoadMem->setVisible(true);
         p_->paramRec->setVisible(false);
         p_->paramSize->setVisible(false);
         break;
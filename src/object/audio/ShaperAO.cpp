@@ -20,6 +20,7 @@
 #include "math/constants.h"
 #include "math/functions.h"
 #include "math/Timeline1d.h"
+#include "math/Timeline1dCompiled.h"
 #include "math/funcparser/parser.h"
 #include "io/DataStream.h"
 #include "io/error.h"
@@ -273,7 +274,12 @@ void ShaperAO::processAudio(const RenderTime& time)
     {
         case ST_TANH:       MO__PROCESS(tanh); break;
         case ST_TANH_CHEAP: MO__PROCESS(MATH::fast_tanh); break;
-        case ST_CURVE:      MO__PROCESS(p_->paramCurve->timeline()->get); break;
+        case ST_CURVE:
+        {
+            auto curve = p_->paramCurve->timeline()->compiled();
+            MO__PROCESS(curve->get);
+        }
+        break;
         case ST_EQUATION:   MO__PROCESS(p_->equations[time.thread()][channel]); break;
     }
 
@@ -133,9 +133,6 @@ void WavePlayerAO::createParameters()
                 tr("The file is completely loaded into memory"),
                 true,
                 true, false);
-#ifdef MO_DISABLE_EXP
-        p_->paramLoadMem->setZombie(true);
-#endif
 
         p_->paramMode = params()->createSelectParameter("time_mode", tr("time mode"),
                                             tr("Selects the kind of timing to use"),
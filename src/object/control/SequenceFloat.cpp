@@ -9,6 +9,7 @@
 */
 
 #include <random>
+#include <cmath>
 
 #include "SequenceFloat.h"
 #include "object/param/Parameters.h"
@@ -24,6 +25,7 @@
 #include "audio/tool/SoundFile.h"
 #include "audio/tool/SoundFileManager.h"
 #include "math/Timeline1d.h"
+#include "math/Timeline1dCompiled.h"
 #include "math/funcparser/parser.h"
 #include "math/constants.h"
 #include "io/DataStream.h"
@@ -71,6 +73,45 @@ public:
         freq,
         phase,
         pw;
+
+    /** Per-sample arrays for Parser::evalBatch() in getValuesBlock() */
+    std::vector<Double>
+        batchTime,
+        batchRTime,
+        batchFade,
+        batchValue;
+};
+
+/** Scoped read access to the sound file handle of one thread.
+    The handle is marked in use, so releaseSoundFiles_()
+    does not release it while it is read. */
+class SequenceFloat::SoundFileUse
+{
+public:
+
+    SoundFileUse(const SequenceFloat * seq, uint thread)
+        : inUse_    (thread < seq->soundFileInUse_.size()
+                        ? &seq->soundFileInUse_[thread] : 0),
+          sf_       (0)
+    {
+        if (!inUse_)
+            return;
+        // mark before reading, the handle might be replaced in between
+        do
+        {
+            sf_ = seq->soundFile_[thread];
+            *inUse_ = sf_;
+        }
+        while (sf_ != seq->soundFile_[thread]);
+    }
+
+    ~SoundFileUse() { if (inUse_) *inUse_ = 0; }
+
+    AUDIO::SoundFile * get() const { return sf_; }
+
+private:
+    std::atomic<AUDIO::SoundFile*> * inUse_;
+    AUDIO::SoundFile * sf_;
 };
 
 
@@ -99,14 +140,18 @@ SequenceFloat::SequenceFloat()
 
         timeline_       (0),
         wavetable_      (0),
-        soundFile_      (0),
+        soundFileMem_   (false),
         equation_       (0),
 
         p_soundFile_    (0),
 
         cacheValue_     (0.0),
         cacheTime_      (-1.111),
-        phaseMult_      (1.0)
+        phaseMult_      (1.0),
+        rangeDirty_     (true),
+        rangeStart_     (0.),
+        rangeStep_      (0.),
+        rangeSize_      (0)
 
 {
     setName("SequenceFloat");
@@ -118,8 +163,10 @@ SequenceFloat::~SequenceFloat()
     if (timeline_)
         timeline_->releaseRef("SequenceFloat destroy");
     delete wavetable_;
-    if (soundFile_)
-        AUDIO::SoundFileManager::releaseSoundFile(soundFile_);
+    for (auto& sf : soundFile_)
+        if (auto f = sf.exchange(0))
+            retiredSoundFiles_.push_back(f);
+    releaseSoundFiles_(true);
 
     for (auto e : equation_)
         delete e;
@@ -225,9 +272,15 @@ void SequenceFloat::createParameters()
                   << tr("wavetable second [0,1]") << tr("radians of wavetable second [0,TWO_PI]"));
 
         p_soundFile_ = params()->createFilenameParameter("sndfilen", tr("filename"),
-                                                  tr("The filename of the audio file"
-                                                     " - Note that the file will be buffered in memory completely"),
+                                                  tr("The filename of the audio file"),
                                                   IO::FT_SOUND);
+        p_soundFileMem_ = params()->createBooleanParameter("sndfilemem", tr("load to memory"),
+                      tr("When selected, the whole file will be loaded into memory, "
+                         "otherwise it gets streamed from disk"),
+                      tr("The file is streamed from disk"),
+                      tr("The file is completely loaded into memory"),
+                      true, true, false);
+        p_soundFileMem_->setDefaultEvolvable(false);
         p_soundFileChannel_ = params()->createIntParameter("sndfilechan", tr("channel"),
                       tr("Selects which channel to play from the sound file"),
                       0, true, true);
@@ -504,6 +557,7 @@ void SequenceFloat::updateParameterVisibility()
     p_doPhaseDegree_->setVisible(freq);
     p_equationText_->setVisible(equ);
     p_soundFile_->setVisible(wave);
+    p_soundFileMem_->setVisible(wave);
     p_soundFileChannel_->setVisible(wave);
 
     p_wtFreqs_->setVisible(specwt);
@@ -591,6 +645,15 @@ void SequenceFloat::setNumberThreads(uint num)
     for (uint i=oldnum; i<num; ++i)
         equation_[i] = 0;
 
+    // reopen sound files per thread
+    for (auto& sf : soundFile_)
+        if (auto f = sf.exchange(0))
+            retiredSoundFiles_.push_back(f);
+    releaseSoundFiles_(true);
+    std::vector<std::atomic<AUDIO::SoundFile*>>(num).swap(soundFile_);
+    std::vector<std::atomic<AUDIO::SoundFile*>>(num).swap(soundFileInUse_);
+    soundFileName_.clear();
+
     // update/create equation objects
     updateValueObjects_();
 }
@@ -609,6 +672,7 @@ void SequenceFloat::setTimeline(const MATH::Timeline1d & tl)
 
     MO_ASSERT(timeline_, "");
     *timeline_ = tl;
+    invalidateValueRange_();
 }
 
 void SequenceFloat::addTimeline(const MATH::Timeline1d & tl, Double timeOffset, bool adjustLength)
@@ -618,6 +682,7 @@ void SequenceFloat::addTimeline(const MATH::Timeline1d & tl, Double timeOffset,
 
     MO_ASSERT(timeline_, "");
     timeline_->addTimeline(tl, timeOffset);
+    invalidateValueRange_();
 
     if (adjustLength)
     {
@@ -638,6 +703,7 @@ void SequenceFloat::overwriteTimeline(const MATH::Timeline1d & tl, Double timeOf
 
     MO_ASSERT(timeline_, "");
     timeline_->overwriteTimeline(tl, timeOffset);
+    invalidateValueRange_();
 
     if (adjustLength)
     {
@@ -701,26 +767,63 @@ void SequenceFloat::updateValueObjects_()
     }
 
     // update soundfile
-    if (sequenceType() == ST_SOUNDFILE && !p_soundFile_->value().isEmpty())
+    updateSoundFile_();
+
+    invalidateValueRange_();
+}
+
+void SequenceFloat::updateSoundFile_()
+{
+    const QString fn = sequenceType() == ST_SOUNDFILE
+            ? p_soundFile_->value() : QString();
+    const bool mem = p_soundFileMem_->baseValue();
+
+    // (re-)open only when the file changes,
+    // this is called for every parameter change
+    if (!soundFile_.empty()
+        && (fn != soundFileName_ || (!fn.isEmpty() && mem != soundFileMem_)))
     {
-        // remember previous for releasing
-        auto oldsf = soundFile_;
-        // get new
-        soundFile_ = AUDIO::SoundFileManager::getSoundFile(p_soundFile_->value());
-        setErrorMessage(soundFile_->errorString());
-        // update loop-length default value
-        if (soundFile_->isOk())
-            setDefaultLoopLength(soundFile_->lengthSeconds());
-        // release previous
-        if (oldsf)
-            oldsf->release();
+        for (auto& sf : soundFile_)
+        {
+            AUDIO::SoundFile * f = fn.isEmpty()
+                    ? 0 : AUDIO::SoundFileManager::getSoundFile(fn, mem);
+            // threads pick up the new handle on their next read
+            if (auto old = sf.exchange(f))
+                retiredSoundFiles_.push_back(old);
+        }
+        soundFileName_ = fn;
+        soundFileMem_ = mem;
+
+        if (auto sf = soundFile())
+        {
+            // update loop-length default value
+            if (sf->isOk())
+                setDefaultLoopLength(sf->lengthSeconds());
+        }
     }
-    else
+
+    if (auto sf = soundFile())
+        setErrorMessage(sf->errorString());
+
+    releaseSoundFiles_(false);
+}
+
+void SequenceFloat::releaseSoundFiles_(bool all)
+{
+    for (auto i = retiredSoundFiles_.begin(); i != retiredSoundFiles_.end(); )
     {
-        // get rid of soundfile
-        if (soundFile_)
-            soundFile_->release();
-        soundFile_ = 0;
+        bool inUse = false;
+        if (!all)
+            for (auto& u : soundFileInUse_)
+                inUse |= u == *i;
+
+        if (inUse)
+            ++i;
+        else
+        {
+            (*i)->release();
+            i = retiredSoundFiles_.erase(i);
+        }
     }
 }
 
@@ -868,6 +971,150 @@ Double SequenceFloat::valueFloat(uint chan, const RenderTime& gtime) const
 }
 
 
+void SequenceFloat::getValuesBlock(
+        uint chan, const RenderTime& gtime, F32* out, uint number) const
+{
+    if (chan != 0)
+    {
+        for (uint i=0; i<number; ++i)
+            out[i] = 0.f;
+        return;
+    }
+
+    const auto mode = (SequenceType)p_mode_->baseValue();
+    const bool useFreq = typeUsesFrequency() || p_useFreq_->baseValue();
+
+    // check if the block path can be used
+    // (all per-sample parameters must be constant)
+    bool isConst = p_loopOverlapMode_->baseValue() == LOT_OFF
+            && !p_offset_->isModulated()
+            && !p_amplitude_->isModulated()
+            && !(useFreq && (p_frequency_->isModulated()
+                             || p_phase_->isModulated()));
+    switch (mode)
+    {
+        case ST_CONSTANT:
+        case ST_TIMELINE:
+        case ST_SOUNDFILE:
+            isConst &= !(mode == ST_SOUNDFILE && p_soundFileChannel_->isModulated());
+        break;
+        case ST_OSCILLATOR:
+            isConst &= !(p_pulseWidth_->isModulated() || p_smooth_->isModulated());
+        break;
+        case ST_EQUATION:
+            // freq, phase and pw are equation variables in any case
+            isConst &= !(p_frequency_->isModulated() || p_phase_->isModulated()
+                         || p_pulseWidth_->isModulated())
+                    && equation_[gtime.thread()] != 0;
+        break;
+        case ST_EQUATION_WT:
+        case ST_ADD_WT:
+        case ST_OSCILLATOR_WT:
+        case ST_SPECTRAL_WT:
+            isConst &= wavetable_ != 0;
+        break;
+        default:
+            isConst = false;
+    }
+
+    if (!isConst)
+    {
+        ValueFloatInterface::getValuesBlock(chan, gtime, out, number);
+        return;
+    }
+
+    const RenderTime ptime(0., gtime.thread());
+    const Double
+            offset = p_offset_->value(ptime),
+            amp = p_amplitude_->value(ptime),
+            freq = useFreq ? p_frequency_->value(ptime) : 1.,
+            phase = useFreq ? p_phase_->value(ptime) * phaseMult_ : 0.;
+
+    const AUDIO::Waveform::Type oscType = (AUDIO::Waveform::Type)p_oscMode_->baseValue();
+    const Double
+            pw = AUDIO::Waveform::limitPulseWidth(p_pulseWidth_->value(ptime)),
+            smooth = p_smooth_->value(ptime);
+    const SoundFileUse sfUse(this, gtime.thread());
+    AUDIO::SoundFile * sf = sfUse.get();
+    const uint sfChannel = sf
+            ? std::min(sf->numberChannels(),
+                       (uint)p_soundFileChannel_->value(ptime))
+            : 0;
+
+    // flat timeline snapshot with sequential lookup
+    std::shared_ptr<const MATH::Timeline1dCompiled> tl;
+    MATH::Timeline1dCompiled::Cursor tlCursor;
+    if (mode == ST_TIMELINE && timeline_)
+        tl = timeline_->compiled();
+
+    // the equation collects the times and is evaluated after the loop
+    SeqEquation * equ = mode == ST_EQUATION ? equation_[gtime.thread()] : 0;
+    if (equ)
+    {
+        equ->batchTime.resize(number);
+        equ->batchRTime.resize(number);
+        equ->batchFade.resize(number);
+        equ->batchValue.resize(number);
+    }
+
+    for (uint i=0; i<number; ++i)
+    {
+        // same time translation as in valueFloat()
+        RenderTime ltime(gtime + SamplePos(i)), nlTime(ltime);
+        Double timeNoLoop;
+        getSequenceTime(ltime, timeNoLoop);
+        nlTime += (ltime.second() - timeNoLoop);
+        const Double fade = fade_(nlTime),
+                     t = ltime.second() * freq + phase;
+
+        Double v = offset;
+        switch (mode)
+        {
+            case ST_OSCILLATOR:
+                v += amp * AUDIO::Waveform::waveform(t, oscType, pw, smooth);
+            break;
+            case ST_EQUATION_WT:
+            case ST_ADD_WT:
+            case ST_OSCILLATOR_WT:
+            case ST_SPECTRAL_WT:
+                v += amp * wavetable_->value(t);
+            break;
+            case ST_SOUNDFILE:
+                v = sf ? v + amp * sf->value(t, sfChannel) : 0.;
+            break;
+            case ST_TIMELINE:
+                v += tl ? amp * tl->get(t, tlCursor) : 0.;
+            break;
+            case ST_EQUATION:
+                equ->batchTime[i] = t;
+                equ->batchRTime[i] = t * TWO_PI;
+                equ->batchFade[i] = fade;
+            break;
+            default: break;
+        }
+
+        out[i] = fade * v;
+    }
+
+    if (!equ || !number)
+        return;
+
+    equ->freq = p_frequency_->value(ptime);
+    equ->phase = p_phase_->value(ptime) * phaseMult_;
+    equ->pw = pw;
+    equ->equation->setBatchVariable("x", &equ->batchTime[0]);
+    equ->equation->setBatchVariable("xr", &equ->batchRTime[0]);
+    MO_EXTEND_EXCEPTION(
+        equ->equation->evalBatch(&equ->batchValue[0], number)
+        ,
+        "in (thread=" << gtime.thread() << ") block call from SequenceFloat '"
+                << name() << "' (" << idNamePath() << ")"
+    );
+
+    for (uint i=0; i<number; ++i)
+        out[i] = equ->batchFade[i] * (offset + amp * equ->batchValue[i]);
+}
+
 Double SequenceFloat::value_(const RenderTime & gtime) const
 {
     RenderTime time(gtime);
@@ -910,12 +1157,14 @@ Double SequenceFloat::value_(const RenderTime & gtime) const
                 * wavetable_->value(time.second());
 
         case ST_SOUNDFILE:
-            //MO_ASSERT(soundFile_, "SequenceFloat('" << idName() << "')::value() without soundfile");
-            if (soundFile_)
+        {
+            const SoundFileUse sf(this, gtime.thread());
+            if (sf.get())
             return p_offset_->value(gtime) + p_amplitude_->value(gtime)
-                * soundFile_->value(time.second(),
-                                    std::min(soundFile_->numberChannels(), (uint)p_soundFileChannel_->value(gtime)) );
+                * sf.get()->value(time.second(),
+                                  std::min(sf.get()->numberChannels(), (uint)p_soundFileChannel_->value(gtime)) );
             else return 0.;
+        }
 
         case ST_EQUATION:
             MO_ASSERT(equation_[time.thread()], "SequenceFloat('" << idName()
@@ -943,11 +1192,248 @@ Double SequenceFloat::value_(const RenderTime & gtime) const
 }
 
 
+bool SequenceFloat::isStatic_() const
+{
+    if (parentClip())
+        return false;
+    for (auto p : params()->parameters())
+        if (p->isModulated())
+            return false;
+    return true;
+}
+
+void SequenceFloat::invalidateValueRange_()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    rangeDirty_ = true;
+    lastMinMaxStart_.clear();
+    lastMinMaxLength_.clear();
+    lastMinValue_.clear();
+    lastMaxValue_.clear();
+}
+
+bool SequenceFloat::getValueRangeExact_(const AUDIO::SoundFile * sf,
+        Double gStart, Double gEnd, Double& mi, Double& ma) const
+{
+    const auto mode = sequenceType();
+
+    if (p_loopOverlapMode_->baseValue() != LOT_OFF
+        || p_fadeIn_->baseValue() > 0.
+        || p_fadeOut_->baseValue() > 0.)
+        return false;
+
+    if (mode == ST_CONSTANT)
+    {
+        mi = ma = p_offset_->baseValue();
+        return true;
+    }
+
+    if (!(mode == ST_TIMELINE && timeline_)
+        && !(mode == ST_SOUNDFILE && sf
+             && sf->isOk() && !sf->isStream()))
+        return false;
+
+    // local time range, same as Sequence::getSequenceTime()
+    const Double
+            l0 = (gStart - start()) * speed() + timeOffset(),
+            l1 = (gEnd - start()) * speed() + timeOffset();
+
+    // split into unlooped pieces
+    Double pieces[3][2];
+    int num = 0;
+    if (!looping())
+    {
+        pieces[0][0] = l0; pieces[0][1] = l1;
+        num = 1;
+    }
+    else
+    {
+        const Double
+                ls = loopStart(),
+                ll = std::max(loopLength(), minimumLength()),
+                le = ls + ll;
+        // before loop end
+        if (l0 <= le)
+        {
+            pieces[num][0] = l0; pieces[num][1] = std::min(l1, le);
+            ++num;
+        }
+        // wrapped part
+        if (l1 > le)
+        {
+            const Double a = std::max(l0, le);
+            if (l1 - a >= ll)
+            {
+                pieces[num][0] = ls; pieces[num][1] = le;
+                ++num;
+            }
+            else
+            {
+                const Double
+                        w0 = MATH::moduloSigned(a - ls, ll) + ls,
+                        w1 = MATH::moduloSigned(l1 - ls, ll) + ls;
+                if (w0 <= w1)
+                {
+                    pieces[num][0] = w0; pieces[num][1] = w1;
+                    ++num;
+                }
+                else
+                {
+                    pieces[num][0] = w0; pieces[num][1] = le;
+                    ++num;
+                    pieces[num][0] = ls; pieces[num][1] = w1;
+                    ++num;
+                }
+            }
+        }
+    }
+
+    const bool useFreq = p_useFreq_->baseValue();
+    const Double
+            freq = useFreq ? p_frequency_->baseValue() : 1.,
+            phase = useFreq ? p_phase_->baseValue() * phaseMult_ : 0.;
+    const uint sfChannel = sf
+            ? std::min(sf->numberChannels(),
+                       (uint)p_soundFileChannel_->baseValue())
+            : 0;
+
+    bool found = false;
+    for (int i=0; i<num; ++i)
+    {
+        Double t0 = pieces[i][0] * freq + phase,
+               t1 = pieces[i][1] * freq + phase,
+               vmi, vma;
+        if (t1 < t0)
+            std::swap(t0, t1);
+
+        if (mode == ST_TIMELINE)
+            timeline_->getMinMax(t0, t1, vmi, vma);
+        else if (!sf->getMinMax(sfChannel, t0, t1, vmi, vma))
+            return false;
+
+        mi = found ? std::min(mi, vmi) : vmi;
+        ma = found ? std::max(ma, vma) : vma;
+        found = true;
+    }
+    if (!found)
+        return false;
+
+    // offset and amplitude
+    const Double
+            offset = p_offset_->baseValue(),
+            amp = p_amplitude_->baseValue();
+    mi = offset + amp * mi;
+    ma = offset + amp * ma;
+    if (ma < mi)
+        std::swap(mi, ma);
+
+    return true;
+}
+
+bool SequenceFloat::getValueRangeSampled_(
+        uint thread, Double gStart, Double gEnd, Double& mi, Double& ma) const
+{
+    const Double s = start(), e = end();
+    if (!(e > s))
+        return false;
+
+    // new sampling grid
+    if (rangeDirty_)
+    {
+        rangeStart_ = s;
+        rangeSize_ = std::max(size_t(2), std::min(size_t(1) << 18,
+                                        size_t((e - s) * sampleRate())));
+        rangeStep_ = (e - s) / (rangeSize_ - 1);
+        rangeSamples_.clear();
+        rangePyramid_.clear();
+        rangeDirty_ = false;
+    }
+
+    gStart = std::max(gStart, rangeStart_);
+    gEnd = std::min(gEnd, e);
+    if (gStart > gEnd)
+        return false;
+
+    const size_t
+            i0 = std::min(rangeSize_ - 1,
+                          size_t((gStart - rangeStart_) / rangeStep_)),
+            i1 = std::min(rangeSize_ - 1,
+                          size_t(std::ceil((gEnd - rangeStart_) / rangeStep_)));
+
+    // evaluate up to the requested sample
+    const auto& samples = rangeSamples_;
+    auto value = [&](size_t i) { return samples[i]; };
+    if (rangeSamples_.size() <= i1)
+    {
+        size_t i = rangeSamples_.size();
+        rangeSamples_.resize(i1 + 1);
+        for (; i <= i1; ++i)
+            rangeSamples_[i] = valueFloat(0,
+                        RenderTime(rangeStart_ + i * rangeStep_, thread));
+        rangePyramid_.append(rangeSamples_.size(), value);
+    }
+
+    return rangePyramid_.getMinMax(i0, i1, value, mi, ma);
+}
+
 void SequenceFloat::getValueFloatRange(
         uint channel, const RenderTime& time, Double length,
         Double* minValue, Double* maxValue) const
 {
-    /** @todo need to check for changes of sequence content */
+    const auto mode = sequenceType();
+
+    // pyramid caches
+    if (channel == 0 && length > 0. && isStatic_())
+    {
+        const Double
+                t0 = time.second(),
+                t1 = t0 + length;
+        Double mi, ma;
+
+        const SoundFileUse sfUse(this, time.thread());
+        const AUDIO::SoundFile * sf = sfUse.get();
+
+        std::unique_lock<std::mutex> lock(cacheMutex_);
+
+        if (getValueRangeExact_(sf, t0, t1, mi, ma))
+        {
+            *minValue = mi;
+            *maxValue = ma;
+            return;
+        }
+
+        // the sampled output is only invalidated by parameter changes,
+        // so leave out edits to the timeline and streamed files
+        if (mode != ST_TIMELINE
+            && !(mode == ST_SOUNDFILE && sf && sf->isStream())
+            && getValueRangeSampled_(time.thread(), t0, t1, mi, ma))
+        {
+            lock.unlock();
+
+            // parts outside of the sampled range
+            Double vmi, vma;
+            if (t0 < start())
+            {
+                ValueFloatInterface::getValueFloatRange(
+                            channel, time, start() - t0, &vmi, &vma);
+                mi = std::min(mi, vmi);
+                ma = std::max(ma, vma);
+            }
+            if (t1 > end())
+            {
+                ValueFloatInterface::getValueFloatRange(
+                            channel, RenderTime(end(), time.thread()),
+                            t1 - end(), &vmi, &vma);
+                mi = std::min(mi, vmi);
+                ma = std::max(ma, vma);
+            }
+            *minValue = mi;
+            *maxValue = ma;
+            return;
+        }
+    }
+
+    // memo of last random sampling, per thread
 #if 1
     bool docalc = false;
 
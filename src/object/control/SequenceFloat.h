@@ -12,6 +12,7 @@
 #define MOSRC_OBJECT_SEQUENCEFLOAT_H
 
 #include <mutex>
+#include <atomic>
 
 #include <QStringList>
 
@@ -19,6 +20,7 @@
 #include "object/interface/ValueFloatInterface.h"
 #include "audio/tool/Waveform.h"
 #include "audio/audio_fwd.h"
+#include "math/MinMaxPyramid.h"
 
 namespace PPP_NAMESPACE { class Parser; }
 namespace MO {
@@ -101,7 +103,9 @@ public:
     SequenceType sequenceType() const
         { return (SequenceType)p_mode_->baseValue(); }
 
-    AUDIO::SoundFile* soundFile() const { return soundFile_; }
+    /** The sound file as used by the gui thread */
+    AUDIO::SoundFile* soundFile() const
+        { return soundFile_.size() > MO_GUI_THREAD ? soundFile_[MO_GUI_THREAD].load() : 0; }
 
     AUDIO::Waveform::Type oscillatorMode() const
     { return (AUDIO::Waveform::Type)p_oscMode_->baseValue(); }
@@ -205,7 +209,16 @@ public:
     // ------- ValueFloatInterface --------
 
     Double valueFloat(uint channel, const RenderTime& time) const Q_DECL_OVERRIDE;
-    /** Returns the minimum and maximum values across the time range (local) */
+    /** Block path for unmodulated oscillators, wavetables, soundfiles and timelines,
+        falls back to valueFloat() per sample otherwise */
+    void getValuesBlock(uint channel, const RenderTime& time,
+                        F32* out, uint number) const override;
+    /** Returns the minimum and maximum values across the time range.
+        For unmodulated timelines and in-memory soundfiles, the range is exact
+        and taken from their MATH::MinMaxPyramid.
+        For other unmodulated sequences, the output between start() and end()
+        is sampled into a pyramid on demand, which is invalidated on changes.
+        Modulated sequences are randomly sampled. */
     void getValueFloatRange(
                 uint channel, const RenderTime& time, Double length,
                 Double* minimum, Double* maximum) const override;
@@ -217,6 +230,12 @@ public slots:
 private:
 
     void updateValueObjects_();
+    /** Opens the sound file for each thread if the filename changed
+        and retires the previous handles. */
+    void updateSoundFile_();
+    /** Releases the retired sound files that no thread is reading,
+        or all of them with @p all */
+    void releaseSoundFiles_(bool all);
     /** Updates the internal wavetable from the WavetableGenerator settings.
         @note mode() must be ST_SPECTRAL_WT */
     void updateWavetable_();
@@ -225,9 +244,32 @@ private:
     Double value_(const RenderTime& time) const;
     Double fade_(const RenderTime& time) const;
 
+    /** True if no parameter is modulated and the sequence is not on a clip,
+        e.g. the output only depends on the time. */
+    bool isStatic_() const;
+    /** Invalidates all cached value ranges */
+    void invalidateValueRange_();
+    /** Range for timeline and soundfile sequences from their pyramids.
+        Returns false if not applicable. cacheMutex_ must be locked. */
+    bool getValueRangeExact_(const AUDIO::SoundFile * sf,
+                             Double gStart, Double gEnd, Double& mi, Double& ma) const;
+    /** Range from the sampled output between start() and end().
+        Returns false if the range does not overlap. cacheMutex_ must be locked. */
+    bool getValueRangeSampled_(uint thread, Double gStart, Double gEnd,
+                               Double& mi, Double& ma) const;
+
     MATH::Timeline1d * timeline_;
     AUDIO::Wavetable<Double> * wavetable_;
-    AUDIO::SoundFile * soundFile_;
+
+    /** One handle per thread, so every thread reads its own stream */
+    std::vector<std::atomic<AUDIO::SoundFile*>> soundFile_;
+    /** The handle each thread is currently reading, see SoundFileUse */
+    mutable std::vector<std::atomic<AUDIO::SoundFile*>> soundFileInUse_;
+    /** Replaced handles, released by releaseSoundFiles_() */
+    std::vector<AUDIO::SoundFile*> retiredSoundFiles_;
+    QString soundFileName_;
+    bool soundFileMem_;
+    class SoundFileUse;
 
     class SeqEquation;
     std::vector<SeqEquation*> equation_;
@@ -244,6 +286,13 @@ private:
         lastMinMaxStart_, lastMinMaxLength_,
         lastMinValue_, lastMaxValue_;
 
+    // sampled output for getValueFloatRange(), guarded by cacheMutex_
+    mutable bool rangeDirty_;
+    mutable Double rangeStart_, rangeStep_;
+    mutable size_t rangeSize_;
+    mutable std::vector<Double> rangeSamples_;
+    mutable MATH::MinMaxPyramid<Double> rangePyramid_;
+
     ParameterFloat
         * p_offset_,
         * p_amplitude_,
@@ -285,6 +334,7 @@ private:
         * p_loopOverlapMode_,
         * p_useFreq_,
         * p_doPhaseDegree_,
+        * p_soundFileMem_,
         * p_fadeMode_;
 
     ParameterText
@@ -14,6 +14,13 @@
 
 namespace MO {
 
+void ValueFloatInterface::getValuesBlock(
+        uint channel, const RenderTime &time, F32 *out, uint number) const
+{
+    for (uint i=0; i<number; ++i)
+        out[i] = valueFloat(channel, time + SamplePos(i));
+}
+
 void ValueFloatInterface::getValueFloatRange(
                     uint channel, const RenderTime &time, Double length,
                     Double *minimum, Double *maximum) const
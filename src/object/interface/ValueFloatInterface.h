@@ -23,6 +23,12 @@ public:
 
     virtual Double valueFloat(uint channel, const RenderTime& time) const = 0;
 
+    /** Writes @p number consecutive sample values starting at @p time into @p out.
+        The time is advanced by one sample (RenderTime::sampleRateInv()) per value.
+        Default implementation calls valueFloat() for each sample. */
+    virtual void getValuesBlock(uint channel, const RenderTime& time,
+                                F32* out, uint number) const;
+
     /** Default implementation uses brute-force approach */
     virtual void getValueFloatRange(uint channel, const RenderTime& time, Double length,
                             Double* minimum, Double* maximum) const;
@@ -114,6 +114,7 @@ HEADERS += \
     $$PWD/util/AlphaBlendSetting.h \
     $$PWD/util/AudioObjectConnections.h \
     $$PWD/util/ColorPostProcessingSetting.h \
+    $$PWD/util/DspScheduler.h \
     $$PWD/util/ObjectConnectionGraph.h \
     $$PWD/util/ObjectDspPath.h \
     $$PWD/util/ObjectEditor.h \
@@ -266,6 +267,7 @@ SOURCES += \
     $$PWD/util/AlphaBlendSetting.cpp \
     $$PWD/util/AudioObjectConnections.cpp \
     $$PWD/util/ColorPostProcessingSetting.cpp \
+    $$PWD/util/DspScheduler.cpp \
     $$PWD/util/ObjectConnectionGraph.cpp \
     $$PWD/util/ObjectDspPath.cpp \
     $$PWD/util/ObjectEditor.cpp \
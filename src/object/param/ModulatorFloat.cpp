@@ -153,5 +153,80 @@ Double ModulatorFloat::value(const RenderTime& rtime) const
     return 0.0;
 }
 
+void ModulatorFloat::getValuesBlock(const RenderTime& rtime, F32* out, uint number) const
+{
+    if (number == 0)
+        return;
+
+    RenderTime time(rtime);
+    time += timeOffset_;
+
+    if (!modulator() || sourceType_ == ST_NONE)
+    {
+        for (uint i=0; i<number; ++i)
+            out[i] = 0.f;
+        return;
+    }
+
+    // activity is assumed constant if it's equal at both ends of the block,
+    // otherwise take the exact per-sample path
+    const bool
+            act0 = modulator()->active(time),
+            act1 = modulator()->active(time + SamplePos(number - 1));
+    if (act0 != act1)
+    {
+        for (uint i=0; i<number; ++i)
+            out[i] = value(rtime + SamplePos(i));
+        return;
+    }
+    if (!act0)
+    {
+        for (uint i=0; i<number; ++i)
+            out[i] = 0.f;
+        return;
+    }
+
+    switch (sourceType_)
+    {
+        case ST_NONE: break;
+
+        case ST_INTERFACE_FLOAT:
+        {
+            if (modulator()->isSequence())
+            {
+                auto seq = static_cast<SequenceFloat*>(modulator());
+                // sequences in clips need a playing clip
+                if (seq->parentClip() && !seq->parentClip()->isPlaying())
+                {
+                    for (uint i=0; i<number; ++i)
+                        out[i] = 0.f;
+                    return;
+                }
+            }
+            interface_->getValuesBlock(outputChannel(), time, out, number);
+            if (amplitude_ != 1.)
+            {
+                const F32 amp = amplitude_;
+                for (uint i=0; i<number; ++i)
+                    out[i] *= amp;
+            }
+            return;
+        }
+
+        case ST_AUDIO_OBJECT:
+        {
+            time.setThread(MO_AUDIO_THREAD);
+            auto ao = static_cast<AudioObject*>(modulator());
+            for (uint i=0; i<number; ++i)
+                out[i] = amplitude_ * ao->getAudioOutputAsFloat(
+                                            outputChannel(), time + SamplePos(i));
+            return;
+        }
+    }
+
+    for (uint i=0; i<number; ++i)
+        out[i] = 0.f;
+}
+
 
 } // namespace MO
@@ -60,6 +60,12 @@ public:
     /** Returns the modulation-value at given time */
     Double value(const RenderTime& time) const;
 
+    /** Writes @p number consecutive modulation-values (one per sample)
+        starting at @p time into @p out.
+        Uses the block path of the modulating object if possible and
+        falls back to value() per sample otherwise. */
+    void getValuesBlock(const RenderTime& time, F32* out, uint number) const;
+
     /** Returns the amplitude of the modulation value */
     Double amplitude() const { return amplitude_; }
 
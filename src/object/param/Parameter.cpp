@@ -12,6 +12,7 @@
 
 #include "Parameter.h"
 #include "Modulator.h"
+#include "Parameters.h"
 #include "object/Scene.h"
 #include "object/util/ObjectConnectionGraph.h"
 #include "types/Properties.h"
@@ -34,6 +35,7 @@ Parameter::Parameter(Object * object, const QString& id, const QString& name)
     , isZombie_         (false)
     , isEvolve_         (true)
     , p_specFlag_       (SF_NONE)
+    , handle_           (-1)
     //iProps_     (new Properties)
 {
 }
@@ -222,6 +224,9 @@ bool Parameter::setVisible(bool visible)
 void Parameter::addSynonymId(const QString &id)
 {
     synonymIds_.insert(id);
+    // update lookup
+    if (handle_ >= 0 && object_)
+        object_->params()->p_addSynonymId_(this, id);
 }
 
 bool Parameter::hasSynonymId(const QString &id) const
@@ -26,7 +26,7 @@ class Properties;
 
 class Parameter
 {
-
+    friend class Parameters;
 public:
 
     enum SpecificFlag
@@ -74,6 +74,9 @@ public:
     Object * object() const { return object_; }
 
     const QString& idName() const { return idName_; }
+    /** Dense index of this parameter in Parameters::parameters(),
+        or -1 if not installed. See Parameters::findParameterHandle() */
+    int handle() const { return handle_; }
     const QString& name() const { return name_; }
     /** Can be, and is by default, empty */
     const QString& userName() const { return userName_; }
@@ -245,6 +248,7 @@ private:
          isZombie_, isEvolve_;
     SpecificFlag
         p_specFlag_;
+    int handle_;
     //QList<QString> modulatorIds_;
 
     QList<Modulator*> modulators_;
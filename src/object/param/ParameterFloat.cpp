@@ -194,5 +194,42 @@ void ParameterFloat::getValues(
     }
 }
 
+void ParameterFloat::getValuesBlock(
+        const RenderTime & time, F32 *out, uint number) const
+{
+    if (!isModulated())
+    {
+        const F32 v = std::max(minValue_, std::min(maxValue_, value_));
+        for (uint i=0; i<number; ++i)
+            out[i] = v;
+        return;
+    }
+
+    // modulators are summed in chunks on the stack
+    // to stay allocation-free in the audio thread
+    const uint chunkSize = 64;
+    F32 mod[chunkSize];
+
+    for (uint pos=0; pos<number; pos += chunkSize)
+    {
+        const uint num = std::min(chunkSize, number - pos);
+        const RenderTime ctime(time + SamplePos(pos));
+        F32 * ptr = out + pos;
+
+        for (uint i=0; i<num; ++i)
+            ptr[i] = value_;
+
+        for (auto m : modulators())
+        {
+            static_cast<ModulatorFloat*>(m)->getValuesBlock(ctime, mod, num);
+            for (uint i=0; i<num; ++i)
+                ptr[i] += mod[i];
+        }
+
+        for (uint i=0; i<num; ++i)
+            ptr[i] = std::max(minValue_, std::min(maxValue_, Double(ptr[i])));
+    }
+}
+
 
 } // namespace MO
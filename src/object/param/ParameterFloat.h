@@ -72,6 +72,11 @@ public:
     void getValues(const RenderTime& time, Double timeIncrement,
                    uint number, F32 * ptr) const;
 
+    /** Writes @p number values, one per sample, starting at @p time into @p out.
+        Each modulator is evaluated once per block through
+        ModulatorFloat::getValuesBlock() instead of once per sample. */
+    void getValuesBlock(const RenderTime& time, F32 * out, uint number) const;
+
     // ---------------- setter -----------------
 
     void setDefaultValue(Double v) { defaultValue_ = v; isDefaultFractional_ = false; }
@@ -139,16 +139,30 @@ QList<Parameter*> Parameters::getVisibleGraphParameters() const
 
 Parameter * Parameters::findParameter(const QString &id)
 {
-    for (auto p : parameters_)
-        if (p->idName() == id)
-            return p;
+    return idMap_.value(id, 0);
+}
 
-    // check synonyms
-    for (auto p : parameters_)
-        if (p->hasSynonymId(id))
-            return p;
+int Parameters::findParameterHandle(const QString &id) const
+{
+    auto p = idMap_.value(id, 0);
+    return p ? p->handle() : -1;
+}
 
-    return 0;
+void Parameters::p_addParameter_(Parameter * p)
+{
+    p->handle_ = parameters_.size();
+    parameters_.append(p);
+
+    // ids take precedence over synonyms
+    idMap_.insert(p->idName(), p);
+    for (const auto& s : p->synonymIds_)
+        p_addSynonymId_(p, s);
+}
+
+void Parameters::p_addSynonymId_(Parameter * p, const QString &id)
+{
+    if (!idMap_.contains(id))
+        idMap_.insert(id, p);
 }
 
 Parameter * Parameters::findParameterName(const QString &name)
@@ -360,7 +374,7 @@ ParameterFloat * Parameters::createFloatParameter(
     if (!param)
     {
         param = new ParameterFloat(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -406,7 +420,7 @@ ParameterFloatMatrix * Parameters::createFloatMatrixParameter(const QString& id,
     if (!param)
     {
         param = new ParameterFloatMatrix(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -472,7 +486,7 @@ ParameterInt * Parameters::createIntParameter(
     if (!param)
     {
         param = new ParameterInt(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -558,7 +572,7 @@ ParameterSelect * Parameters::createSelectParameter(
     if (!param)
     {
         param = new ParameterSelect(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValueList(valueList);
@@ -620,7 +634,7 @@ ParameterText * Parameters::createTextParameter(
     if (!param)
     {
         param = new ParameterText(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -666,7 +680,7 @@ ParameterFilename * Parameters::createFilenameParameter(
     if (!param)
     {
         param = new ParameterFilename(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -713,7 +727,7 @@ ParameterImageList* Parameters::createImageListParameter(
     if (!param)
     {
         param = new ParameterImageList(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -758,7 +772,7 @@ ParameterCallback * Parameters::createCallbackParameter(
     if (!param)
     {
         param = new ParameterCallback(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         // ... none
@@ -801,7 +815,7 @@ ParameterTexture * Parameters::createTextureParameter(
     if (!param)
     {
         param = new ParameterTexture(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         // ... none
@@ -843,7 +857,7 @@ ParameterGeometry * Parameters::createGeometryParameter(
     if (!param)
     {
         param = new ParameterGeometry(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         // ... none
@@ -918,7 +932,7 @@ ParameterTimeline1D * Parameters::createTimeline1DParameter(
     if (!param)
     {
         param = new ParameterTimeline1D(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         if (defaultValue)
@@ -1073,7 +1087,7 @@ ParameterTransformation * Parameters::createTransformationParameter(
     if (!param)
     {
         param = new ParameterTransformation(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
         param->setValue(defaultValue);
@@ -1117,7 +1131,7 @@ ParameterFont * Parameters::createFontParameter(
     if (!param)
     {
         param = new ParameterFont(object_, id, name);
-        parameters_.append(param);
+        p_addParameter_(param);
 
         // first time init
     }
@@ -16,6 +16,7 @@
 #include <QList>
 #include <QMap>
 #include <QSet>
+#include <QHash>
 
 #include "object/Object_fwd.h"
 #include "types/vector.h"
@@ -25,9 +26,16 @@
 namespace MO {
 namespace MATH { class Timeline1d; }
 
-/** Container for all Parameters (modulatable or not) of an MO::Object */
+/** Container for all Parameters (modulatable or not) of an MO::Object.
+
+    Parameters are looked up by id or synonym id through a hash.
+    Each installed Parameter also gets a dense integer handle,
+    which is its index in parameters(). Parameters are never removed,
+    so handles stay valid for the lifetime of the object and can be used
+    to address a parameter without string comparisons. */
 class Parameters
 {
+    friend class Parameter;
 public:
     Parameters(Object * parent);
     ~Parameters();
@@ -59,9 +67,18 @@ public:
     /** Returns a list of parameters that are visible in the ObjectGraphView */
     QList<Parameter*> getVisibleGraphParameters() const;
 
-    /** Returns the parameter with the given id, or NULL. */
+    /** Returns the parameter with the given id or synonym id, or NULL. */
     Parameter * findParameter(const QString& id);
 
+    /** Returns the Parameter::handle() of the parameter with the given
+        id or synonym id, or -1. */
+    int findParameterHandle(const QString& id) const;
+
+    /** Returns the parameter for the given Parameter::handle(), or NULL. */
+    Parameter * parameter(int handle) const
+        { return handle >= 0 && handle < parameters_.size()
+                    ? parameters_[handle] : 0; }
+
     /** Returns the parameter with the given name, or NULL. */
     Parameter * findParameterName(const QString& name);
 
@@ -235,9 +252,15 @@ public:
 private:
 
     void p_finishParam_(Parameter*) const;
+    /** Appends a new parameter, assigns the handle and updates the lookup */
+    void p_addParameter_(Parameter*);
+    /** Adds a synonym to the lookup, called by Parameter::addSynonymId() */
+    void p_addSynonymId_(Parameter*, const QString& id);
 
     Object * object_;
     QList<Parameter*> parameters_;
+    /** id and synonym ids to parameter */
+    QHash<QString, Parameter*> idMap_;
     QString curGroupId_,
             curGroupName_;
     bool isEvolve_, isEvolveGroup_;
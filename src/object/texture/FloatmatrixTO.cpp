@@ -59,6 +59,8 @@ struct FloatMatrixTO::Private
 
     ParameterFloatMatrix* p_matrix;
     std::vector<gl::GLfloat> buffer;
+    /** Shares the storage of the last uploaded matrix */
+    FloatMatrix lastMatrix;
 };
 
 
@@ -68,7 +70,7 @@ FloatMatrixTO::FloatMatrixTO()
 {
     setName("FloatMatrix");
     initMaximumTextureInputs(0);
-    /** @todo implement change-check to ParameterFloatMatrix */
+    // matrix changes are detected in renderGl() by FloatMatrix::isSameData()
     initDefaultUpdateMode(UM_ALWAYS);
     initInternalFbo(false);
 }
@@ -301,6 +303,7 @@ void FloatMatrixTO::Private::releaseGl()
         tex->release();
     delete tex;
     tex = nullptr;
+    lastMatrix.clear();
 }
 
 
@@ -309,12 +312,17 @@ void FloatMatrixTO::Private::renderGl(
 {
     if (tex && !p_matrix->hasChanged(time) && !doReUpload)
         return;
+
+    const FloatMatrix matrix = p_matrix->value(time);
+
+    // same storage as last upload, nothing has changed
+    if (tex && !doReUpload && matrix.isSameData(lastMatrix))
+        return;
     doReUpload = false;
+    lastMatrix = matrix;
 
     to->clearError();
 
-    auto matrix = p_matrix->value(time);
-
     MO_DEBUG_FM("FloatMatrixTO(" << to->idName()
                 << "): update texture from matrix "
                 << matrix.layoutString());
@@ -8,7 +8,10 @@
     <p>created 9/27/2015</p>
 */
 
+#include <QImage>
+
 #include "ImagesTO.h"
+#include "object/Scene.h"
 #include "object/param/Parameters.h"
 #include "object/param/ParameterInt.h"
 #include "object/param/ParameterImageList.h"
@@ -26,6 +29,8 @@ MO_REGISTER_OBJECT(ImagesTO)
 ImagesTO::ImagesTO()
     : TextureObjectBase ()
     , pFilenames_       (0)
+    , placeholder_      (0)
+    , isLoading_        (false)
 {
     setName("Images");
     initMaximumTextureInputs(0);
@@ -34,8 +39,9 @@ ImagesTO::ImagesTO()
 
 ImagesTO::~ImagesTO()
 {
-    for (auto t : tex_)
-        delete t;
+    for (auto i : images_)
+        GL::TextureLoader::release(i);
+    delete placeholder_;
 }
 
 void ImagesTO::serialize(IO::DataStream & io) const
@@ -122,43 +128,78 @@ void ImagesTO::initGl(uint thread)
 {
     TextureObjectBase::initGl(thread);
 
+    // shown until the selected image is uploaded
+    QImage black(1, 1, QImage::Format_ARGB32);
+    black.fill(Qt::black);
+    placeholder_ = GL::Texture::createFromImage(black, getDesiredTextureFormat());
+
     for (const QString& fn : pFilenames_->baseValue())
     {
         QString fnl = IO::fileManager().localFilename(fn);
 
+        images_ << GL::TextureLoader::load(fnl, getDesiredTextureFormat(),
+                                           pMipmaps_->baseValue());
+    }
+
+    // load everything now, when resources are expected to be ready
+    isLoading_ = true;
+    updateImages_(sceneObject() && sceneObject()->lazyFlag());
+}
+
+void ImagesTO::updateImages_(bool wait) const
+{
+    bool finished = true;
+    for (auto i : images_)
+    {
         try
         {
-            auto tex = GL::Texture::createFromImage(fnl, getDesiredTextureFormat(),
-                                                    pMipmaps_->baseValue());
-            tex_ << tex;
+            i->upload(wait);
         }
-        catch (const Exception& e)
+        catch (const Exception&)
         {
-            setErrorMessage(e.what());
+            // error is reported below
         }
+
+        if (!i->isReady() && !i->hasError())
+            finished = false;
     }
+
+    if (!finished)
+        return;
+
+    isLoading_ = false;
+    for (auto i : images_)
+        if (i->hasError())
+            setErrorMessage(i->errorString());
 }
 
 void ImagesTO::releaseGl(uint thread)
 {
-    for (auto t : tex_)
-    {
-        if (t->isAllocated())
-            t->release();
-        delete t;
-    }
-    tex_.clear();
+    for (auto i : images_)
+        GL::TextureLoader::release(i);
+    images_.clear();
+    isLoading_ = false;
+
+    if (placeholder_ && placeholder_->isAllocated())
+        placeholder_->release();
+    delete placeholder_;
+    placeholder_ = 0;
 
     TextureObjectBase::releaseGl(thread);
 }
 
 const GL::Texture * ImagesTO::valueTexture(uint chan, const RenderTime& time) const
 {
-    if (tex_.isEmpty() || chan != 0)
+    if (images_.isEmpty() || chan != 0)
         return 0;
 
-    int index = std::min(pIndex_->value(time), tex_.count() - 1);
-    return tex_[index];
+    if (isLoading_)
+        updateImages_(false);
+
+    int index = std::min(pIndex_->value(time), images_.count() - 1);
+    if (auto tex = images_[index]->texture())
+        return tex;
+    return placeholder_;
 }
 
 
@@ -12,6 +12,7 @@
 #define MOSRC_OBJECT_TEXTURE_IMAGESTO_H
 
 #include "TextureObjectBase.h"
+#include "gl/TextureLoader.h"
 
 namespace MO {
 
@@ -42,10 +43,15 @@ public:
 
 private:
 
+    /** Continues uploading the images */
+    void updateImages_(bool wait) const;
+
     QStringList filenames_, initFilenames_;
     ParameterImageList * pFilenames_;
     ParameterInt * pIndex_, *pMipmaps_;
-    QList<GL::Texture*> tex_;
+    QList<GL::TextureLoader::Image*> images_;
+    GL::Texture * placeholder_;
+    mutable bool isLoading_;
 };
 
 } // namespace MO
@@ -0,0 +1,197 @@
+/** @file dspscheduler.cpp
+
+    @brief Parallel-for helper for processing independent dsp objects
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "DspScheduler.h"
+#include "math/denormals.h"
+#include "io/CurrentThread.h"
+#include "io/log_audio.h"
+
+namespace MO {
+
+class DspScheduler::Private
+{
+public:
+
+    /** Value of next while no work is published */
+    static const uint noWork = 0x7fffffff;
+
+    Private()
+        : numItems      (0),
+          next          (noWork),
+          done          (0),
+          active        (0),
+          func          (0),
+          generation    (0),
+          doStop        (false)
+    { }
+
+    void startThreads(uint num);
+    void stopThreads();
+    void workerLoop(uint index);
+    /** Claims and processes items until none are left */
+    void work();
+
+    std::vector<std::thread> threads;
+
+    std::atomic<uint> numItems, next, done, active;
+    std::atomic<const std::function<void(uint)>*> func;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    // guarded by mutex
+    uint64_t generation;
+    bool doStop;
+};
+
+
+DspScheduler::DspScheduler()
+    : p_    (new Private())
+{
+}
+
+DspScheduler::~DspScheduler()
+{
+    p_->stopThreads();
+    delete p_;
+}
+
+uint DspScheduler::numberThreads() const
+{
+    return p_->threads.size() + 1;
+}
+
+void DspScheduler::setNumberThreads(uint num)
+{
+    if (num == 0)
+        num = std::max(1u, std::thread::hardware_concurrency());
+
+    if (num == numberThreads())
+        return;
+
+    p_->stopThreads();
+    p_->startThreads(num - 1);
+}
+
+void DspScheduler::Private::startThreads(uint num)
+{
+    MO_DEBUG_AUDIO("DspScheduler::startThreads(" << num << ")");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        doStop = false;
+    }
+
+    for (uint i=0; i<num; ++i)
+        threads.push_back(std::thread([this, i](){ workerLoop(i); }));
+}
+
+void DspScheduler::Private::stopThreads()
+{
+    if (threads.empty())
+        return;
+
+    MO_DEBUG_AUDIO("DspScheduler::stopThreads()");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        doStop = true;
+    }
+    cond.notify_all();
+
+    for (auto& t : threads)
+        t.join();
+    threads.clear();
+}
+
+void DspScheduler::Private::workerLoop(uint index)
+{
+    setCurrentThreadName(QString("DSP%1").arg(index));
+    // same as audio thread
+    MATH::setDenormals(false);
+
+    uint64_t lastGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&](){ return doStop || generation != lastGeneration; });
+            if (doStop)
+                return;
+            lastGeneration = generation;
+        }
+
+        // run() does not return while a worker is active,
+        // so a late worker never sees the items of the next run
+        ++active;
+        work();
+        --active;
+    }
+}
+
+void DspScheduler::Private::work()
+{
+    while (true)
+    {
+        const uint i = next.fetch_add(1);
+        // outside of run() next is >= noWork
+        if (i >= numItems)
+            return;
+
+        (*func)(i);
+
+        ++done;
+    }
+}
+
+void DspScheduler::run(uint numItems, const std::function<void(uint)>& func)
+{
+    if (numItems == 0)
+        return;
+
+    // serial
+    if (p_->threads.empty() || numItems < 2)
+    {
+        for (uint i=0; i<numItems; ++i)
+            func(i);
+        return;
+    }
+
+    // publish work
+    p_->func = &func;
+    p_->numItems = numItems;
+    p_->done = 0;
+    p_->next = 0;
+    {
+        std::lock_guard<std::mutex> lock(p_->mutex);
+        ++p_->generation;
+    }
+    p_->cond.notify_all();
+
+    // help out
+    p_->work();
+
+    // wait for the last items
+    while (p_->done < numItems)
+        std::this_thread::yield();
+
+    // close this run and wait for workers to leave work()
+    p_->next = Private::noWork;
+    while (p_->active > 0)
+        std::this_thread::yield();
+}
+
+
+} // namespace MO
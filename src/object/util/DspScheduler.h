@@ -0,0 +1,63 @@
+/** @file dspscheduler.h
+
+    @brief Parallel-for helper for processing independent dsp objects
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_OBJECT_UTIL_DSPSCHEDULER_H
+#define MOSRC_OBJECT_UTIL_DSPSCHEDULER_H
+
+#include <functional>
+
+#include "types/int.h"
+
+namespace MO {
+
+/** A small pool of worker threads for the audio thread.
+
+    run() distributes a number of independent work items across
+    the workers and the calling thread and returns when all items are finished.
+    Items are claimed through a shared atomic counter, so idle threads
+    take over the remaining items of busy ones.
+
+    The workers sleep between calls to run() and never allocate memory
+    while processing. */
+class DspScheduler
+{
+public:
+    DspScheduler();
+    ~DspScheduler();
+
+    // ------------ getter ---------------
+
+    /** Number of threads that process items, including the calling thread.
+        A value of 1 means serial processing in run(). */
+    uint numberThreads() const;
+
+    // ------------ setter ---------------
+
+    /** Sets the number of threads including the calling thread.
+        Starts or stops the workers as needed.
+        If @p num == 0, it will be set to the number of processors. */
+    void setNumberThreads(uint num);
+
+    // ------------ processing -----------
+
+    /** Calls @p func for each index in [0, @p numItems) and returns
+        when all calls are finished.
+        @p func must be safe to call concurrently for different indices. */
+    void run(uint numItems, const std::function<void(uint)>& func);
+
+private:
+
+    class Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_OBJECT_UTIL_DSPSCHEDULER_H
@@ -14,6 +14,7 @@
   */
 
 #include <map>
+#include <algorithm>
 #include <memory>
 #include <functional>
 
@@ -27,6 +28,7 @@
 #include "object/util/objecttree.h"
 #include "object/util/AudioObjectConnections.h"
 #include "object/util/ObjectModulatorGraph.h"
+#include "object/util/DspScheduler.h"
 #include "audio/Configuration.h"
 #include "audio/tool/AudioBuffer.h"
 #include "audio/tool/Delay.h"
@@ -155,16 +157,50 @@ public:
 #endif
     };
 
+    /** Consecutive objects of a level that are either processed
+        in parallel or one after another in the audio thread.
+        Objects that are modulated by non-audio objects might share
+        state in the modulating object and are never run in parallel. */
+    struct AudioStep
+    {
+        AudioStep(bool parallel) : parallel(parallel) { }
+        bool parallel;
+        QList<ObjectBuffer*> objects;
+    };
+
+    /** A group of audio objects that do not depend on each other.
+        All levels are processed in order, the steps of a level
+        keep the serial order of their objects. */
+    struct AudioLevel
+    {
+        std::vector<AudioStep> steps;
+    };
+
     Private(ObjectDspPath * path)
         : path          (path),
-          scene         (0)
+          scene         (0),
+          isBuffersAssigned(false),
+          transformDecimation(1),
+          curStep       (0)
 #ifndef MO_DISABLE_SERVER
           , udpOutput   (0)
 #endif
 #ifndef MO_DISABLE_CLIENT
           , udpInput    (0)
 #endif
-    { }
+    {
+        processLevelFunc = [this](uint i)
+        {
+            processAudioObject(curStep->objects[i], curTime);
+        };
+#ifndef MO_DISABLE_SPATIAL
+        spatializeFunc = [this](uint i)
+        {
+            allMicrophones[i].second->spatialize(
+                        allMicrophones[i].first->microphoneInputSoundSources);
+        };
+#endif
+    }
 
     ~Private()
     {
@@ -206,11 +242,42 @@ public:
         Must be called sequentially in dsp order */
     void prepareAudioInputBuffers(ObjectBuffer * o);
     void prepareAudioOutputBuffers(ObjectBuffer * o);
-    /** Separate setup of udp buffers to create them from within the audio thread */
+    /** Separate setup of udp buffers, called by preparePath() */
     void prepareUdpOutputs(ObjectBuffer * o);
 
     void prepareSoundSourceBuffer(ObjectBuffer * o);
 
+    /** Sorts the audioObjects into audioLevels.
+        Must be called after audioObjects is complete. */
+    void createAudioLevels(const QList<Modulator*>& modulators);
+
+    /** Tells all AudioObjects about their buffers in this path,
+        and the system io objects about their number of channels. */
+    void assignAudioBuffers();
+
+    /** Number of channels of the object within this path.
+        The system io objects are not changed before assignAudioBuffers(),
+        so their channels are taken from the configuration. */
+    int numAudioInputs(AudioObject * o) const
+    {
+        if (dynamic_cast<AudioInAO*>(o))
+            return audioIns.size();
+        if (dynamic_cast<AudioOutAO*>(o))
+            return audioOuts.size();
+        return o->numAudioInputs();
+    }
+    uint numAudioOutputs(AudioObject * o) const
+    {
+        if (dynamic_cast<AudioInAO*>(o))
+            return audioIns.size();
+        if (dynamic_cast<AudioOutAO*>(o))
+            return audioOuts.size();
+        return o->numAudioOutputs();
+    }
+
+    /** Mixes inputs, processes the AudioObject and forwards it's output buffers */
+    void processAudioObject(ObjectBuffer * b, const RenderTime& time);
+
 #ifndef MO_DISABLE_SERVER
     /** Creates and/or returns the single associated to-client output stream */
     UdpAudioConnection * getUdpOutput();
@@ -224,6 +291,7 @@ public:
     Scene * scene;
     AUDIO::Configuration conf;
     uint thread;
+    bool isBuffersAssigned;
 
     // all relevant objects
     std::map<Object *, std::shared_ptr<ObjectBuffer>> objects;
@@ -237,6 +305,21 @@ public:
         audioObjects,
         audioOutObjects;
 
+    /// Key distance of the transformation buffers in samples
+    uint transformDecimation;
+
+    std::vector<AudioLevel> audioLevels;
+    DspScheduler scheduler;
+    // created once to avoid allocation in audio thread
+    std::function<void(uint)> processLevelFunc;
+    const AudioStep * curStep;
+    RenderTime curTime;
+#ifndef MO_DISABLE_SPATIAL
+    /// All microphones of all microphoneObjects
+    std::vector<std::pair<ObjectBuffer*, AUDIO::SpatialMicrophone*>> allMicrophones;
+    std::function<void(uint)> spatializeFunc;
+#endif
+
     QList<AUDIO::AudioBuffer*>
         audioIns,
         audioOuts;
@@ -264,6 +347,28 @@ const AUDIO::Configuration & ObjectDspPath::config() const
     return p_->conf;
 }
 
+uint ObjectDspPath::numberDspThreads() const
+{
+    return p_->scheduler.numberThreads();
+}
+
+void ObjectDspPath::setNumberDspThreads(uint num)
+{
+    p_->scheduler.setNumberThreads(num);
+}
+
+uint ObjectDspPath::transformationDecimation() const
+{
+    return p_->transformDecimation;
+}
+
+void ObjectDspPath::setTransformationDecimation(uint samples)
+{
+    p_->transformDecimation = std::max(1u, samples);
+    for (Private::ObjectBuffer * b : p_->transformationObjects)
+        b->calcMatrix.setDecimation(p_->transformDecimation);
+}
+
 const QList<AUDIO::AudioBuffer*> & ObjectDspPath::audioInputs()
 {
     return p_->audioIns;
@@ -274,17 +379,23 @@ const QList<AUDIO::AudioBuffer*> & ObjectDspPath::audioOutputs()
     return p_->audioOuts;
 }
 
-void ObjectDspPath::createPath(Scene *scene, const AUDIO::Configuration& conf, uint thread)
+void ObjectDspPath::createPath(Scene *scene, const AUDIO::Configuration& conf, uint thread,
+                               bool assignBuffers)
 {
     p_->thread = thread;
     p_->conf = conf;
     p_->createPath(scene);
+    if (assignBuffers)
+        p_->assignAudioBuffers();
 }
 
 void ObjectDspPath::preparePath()
 {
     MO_DEBUG("ObjectDspPath::preparePath()");
 
+    if (!p_->isBuffersAssigned)
+        p_->assignAudioBuffers();
+
     for (Private::ObjectBuffer * b : p_->audioObjects)
         p_->prepareUdpOutputs(b);
 }
@@ -295,14 +406,20 @@ void ObjectDspPath::calcTransformations(SamplePos pos)
     {
         if (b->parentMatrix)
         {
-            // copy from parent
-            TransformationBuffer::copy(b->parentMatrix, &b->calcMatrix);
-            // apply transform for one sample block
-            for (SamplePos i = 0; i < p_->conf.bufferSize(); ++i)
-                b->object->calculateTransformation(b->calcMatrix.transformation(i),
+            TransformationBuffer& m = b->calcMatrix;
+            // apply transform for each key of the sample block
+            // (every sample for full-rate buffers)
+            for (uint i = 0; i < m.numKeys(); ++i)
+            {
+                const SamplePos s = m.keySample(i);
+                // copy from parent
+                m.key(i) = b->parentMatrix->transformation(s);
+                b->object->calculateTransformation(m.key(i),
                                                    RenderTime(
-                                                       p_->conf.sampleRateInv() * (pos + i),
+                                                       p_->conf.sampleRateInv() * (pos + s),
                                                         p_->thread));
+            }
+            m.updateKeys();
         }
     }
 }
@@ -336,47 +453,45 @@ void ObjectDspPath::calcAudio(SamplePos pos)
                 p_->thread);
 
     // process audio objects
-    for (Private::ObjectBuffer * b : p_->audioObjects)
+    if (p_->scheduler.numberThreads() > 1)
     {
-#ifndef MO_DISABLE_CLIENT
-        // unless they are sent from server
-        if (!b->udpInput)
+        p_->curTime = rtime;
+        for (const Private::AudioLevel& level : p_->audioLevels)
+        for (const Private::AudioStep& step : level.steps)
         {
-#endif
-            auto ao = static_cast<AudioObject*>(b->object);
-
-            // mix input-inbetweens
-            // (multiple ins on one audio input)
-            for (const Private::InputMixStep & mix : b->audioInputMix)
+            if (step.parallel)
             {
-                mix.buf->writeNullBlock();
-                AUDIO::AudioBuffer::mix(mix.inputs, mix.buf);
-                mix.buf->nextBlock();
+                p_->curStep = &step;
+                p_->scheduler.run(step.objects.size(), p_->processLevelFunc);
             }
+            else
+                for (Private::ObjectBuffer * b : step.objects)
+                    p_->processAudioObject(b, rtime);
+        }
+    }
+    else
+    {
+        for (Private::ObjectBuffer * b : p_->audioObjects)
+            p_->processAudioObject(b, rtime);
+    }
 
-            // process AudioObject
-            ao->processAudioBase(rtime);
-
-            // forward buffers
-            for (AUDIO::AudioBuffer * buf : b->audioOutputs)
-                if (buf)
-                    buf->nextBlock();
-
-            // stream to udp clients
+    // stream to udp clients
 #ifndef MO_DISABLE_SERVER
-            if (serv && b->udpOutput)
-                for (AUDIO::AudioBuffer * ab : b->udpOutputBuffers)
-                    b->udpOutput->sendAudioBuffer(ab, pos);
-#endif
+    if (serv)
+    for (Private::ObjectBuffer * b : p_->audioObjects)
+    {
 #ifndef MO_DISABLE_CLIENT
-        }
-        // get module output from udp streams
-        else
-        {
-            // xxx right now it's done by UdpAudioConnection on receive of packets
-        }
+        if (b->udpInput)
+            continue;
 #endif
+        if (b->udpOutput)
+            for (AUDIO::AudioBuffer * ab : b->udpOutputBuffers)
+                b->udpOutput->sendAudioBuffer(ab, pos);
     }
+    // send all channels of this block
+    if (serv && p_->udpOutput)
+        p_->udpOutput->flush();
+#endif
 
     // clear system audio outputs
     for (AUDIO::AudioBuffer * buf : p_->audioOuts)
@@ -403,6 +518,8 @@ void ObjectDspPath::calcAudio(SamplePos pos)
                     b->matrix,
                     b->soundSources,
                     time);
+        for (AUDIO::SpatialSoundSource * s : b->soundSources)
+            s->updatePositions();
         // get audio signal per soundsource
         b->object->calculateSoundSourceBuffer(
                     b->soundSources,
@@ -427,23 +544,23 @@ void ObjectDspPath::calcAudio(SamplePos pos)
 
     // ------- process virtual microphones -------------
 
+    // get transformation-per-microphone
     for (Private::ObjectBuffer * b : p_->microphoneObjects)
-    {
-        // get transformation-per-microphone
         b->object->calculateMicrophoneTransformation(
                     b->matrix,
                     b->microphones,
                     time);
-        // process each mic
+
+    // sample soundsources for all microphones in parallel
+    p_->scheduler.run(p_->allMicrophones.size(), p_->spatializeFunc);
+
+    for (Private::ObjectBuffer * b : p_->microphoneObjects)
+    {
+        // virtual interface
+        b->object->processMicrophoneBuffers(b->microphones, time);
+        // forward buffers
         for (AUDIO::SpatialMicrophone * m : b->microphones)
-        {
-            // sample soundsources
-            m->spatialize(b->microphoneInputSoundSources);
-            // virtual interface
-            b->object->processMicrophoneBuffers(b->microphones, time);
-            // forward buffer
             m->signal()->nextBlock();
-        }
     }
 
     // mix into system audio outputs
@@ -464,6 +581,36 @@ void ObjectDspPath::calcAudio(SamplePos pos)
 }
 
 
+void ObjectDspPath::Private::processAudioObject(ObjectBuffer * b, const RenderTime& rtime)
+{
+#ifndef MO_DISABLE_CLIENT
+    // unless they are sent from server
+    // xxx right now it's done by UdpAudioConnection on receive of packets
+    if (b->udpInput)
+        return;
+#endif
+
+    auto ao = static_cast<AudioObject*>(b->object);
+
+    // mix input-inbetweens
+    // (multiple ins on one audio input)
+    for (const InputMixStep & mix : b->audioInputMix)
+    {
+        mix.buf->writeNullBlock();
+        AUDIO::AudioBuffer::mix(mix.inputs, mix.buf);
+        mix.buf->nextBlock();
+    }
+
+    // process AudioObject
+    ao->processAudioBase(rtime);
+
+    // forward buffers
+    for (AUDIO::AudioBuffer * buf : b->audioOutputs)
+        if (buf)
+            buf->nextBlock();
+}
+
+
 std::ostream& ObjectDspPath::dump(std::ostream & out) const
 {
     out << "dsp-graph (" << p_->conf << ")\n"
@@ -502,6 +649,16 @@ std::ostream& ObjectDspPath::dump(std::ostream & out) const
         out << " " << o->object->name();
     }
 
+    out << "\naudio object levels (" << p_->scheduler.numberThreads() << " threads):";
+    for (const Private::AudioLevel& level : p_->audioLevels)
+    {
+        out << " [";
+        for (const Private::AudioStep& step : level.steps)
+            for (auto o : step.objects)
+                out << " " << o->object->name() << (step.parallel ? "" : "(serial)");
+        out << " ]";
+    }
+
     out << "\naudio-out objects:";
     for (auto o : p_->audioOutObjects)
     {
@@ -552,11 +709,16 @@ void ObjectDspPath::Private::clear()
         delete b;
 
     scene = 0;
+    isBuffersAssigned = false;
     objects.clear();
     transformationObjects.clear();
     microphoneObjects.clear();
     soundsourceObjects.clear();
     audioObjects.clear();
+    audioLevels.clear();
+#ifndef MO_DISABLE_SPATIAL
+    allMicrophones.clear();
+#endif
     audioIns.clear();
     audioOuts.clear();
     audioOutObjects.clear();
@@ -631,6 +793,7 @@ void ObjectDspPath::Private::createPath(Scene * s)
         }
         // only audio-relevant objects with transformations
         // and the scene object get this matrix resized
+        b->calcMatrix.setDecimation(transformDecimation);
         b->calcMatrix.resize(conf.bufferSize());
 
         transformationObjects.append(b);
@@ -667,14 +830,6 @@ void ObjectDspPath::Private::createPath(Scene * s)
         // for clients, init only the audio -> modulator objects
         if (!isClient() || hasAudioToModulator(o))
         {
-            /** @todo this is a problem.
-                Changing the number of channels touches through to the gui */
-            // update sys io objects' channels
-            if (auto ao = dynamic_cast<AudioInAO*>(o))
-                ao->setNumberAudioInputsOutputs(audioIns.size());
-            if (auto ao = dynamic_cast<AudioOutAO*>(o))
-                ao->setNumberAudioInputsOutputs(audioOuts.size());
-
             // ObjectBuffer for each audio object
             auto b = getObjectBuffer(o);
             audioObjects.append( b );
@@ -699,12 +854,11 @@ void ObjectDspPath::Private::createPath(Scene * s)
             // create and link buffers
             prepareAudioInputBuffers(b);
             prepareAudioOutputBuffers(b);
-
-            // tell object
-            o->setAudioBuffersBase(thread, conf.bufferSize(), b->audioInputs, b->audioOutputs);
         }
     }
 
+    createAudioLevels(all_modulators);
+
 
     // ----------- get all soundsource objects ------------------
 
@@ -776,6 +930,9 @@ void ObjectDspPath::Private::createPath(Scene * s)
 
             b->microphoneInputSoundSources.append( sbuf->soundSources );
         }
+
+        for (auto m : b->microphones)
+            allMicrophones.push_back(std::make_pair(b, m));
     }
 #endif
 
@@ -784,6 +941,115 @@ void ObjectDspPath::Private::createPath(Scene * s)
 
 
 
+void ObjectDspPath::Private::assignAudioBuffers()
+{
+    for (ObjectBuffer * b : audioObjects)
+    {
+        auto o = static_cast<AudioObject*>(b->object);
+
+        // update sys io objects' channels
+        if (auto ao = dynamic_cast<AudioInAO*>(o))
+            ao->setNumberAudioInputsOutputs(audioIns.size());
+        if (auto ao = dynamic_cast<AudioOutAO*>(o))
+            ao->setNumberAudioInputsOutputs(audioOuts.size());
+
+        o->setAudioBuffersBase(thread, conf.bufferSize(),
+                               b->audioInputs, b->audioOutputs);
+    }
+    isBuffersAssigned = true;
+}
+
+
+void ObjectDspPath::Private::createAudioLevels(const QList<Modulator*>& modulators)
+{
+    // Two objects that are connected through audio, through
+    // an audio-to-modulator link or through a chain of non-audio
+    // modulators (audio -> sequence parameter -> sequence -> audio)
+    // must never run concurrently.
+    // The later one in the serial order gets a higher level than
+    // the earlier one, regardless of the direction of the connection,
+    // so parallel processing gives the same result as serial processing
+    // (including feedback connections that read the previous block).
+    std::map<Object*, QSet<Object*>> linked;
+    for (auto c : *scene->audioConnections())
+    {
+        linked[c->from()].insert(c->to());
+        linked[c->to()].insert(c->from());
+    }
+
+    // the objects modulating each object's parameters
+    std::map<Object*, QSet<Object*>> sources;
+    for (Modulator * m : modulators)
+        if (m->parent() && m->modulator())
+            sources[m->parent()].insert(m->modulator());
+
+    QSet<Object*> inPath;
+    for (ObjectBuffer * b : audioObjects)
+        inPath.insert(b->object);
+
+    // follow the modulator graph of each audio object
+    // through non-audio objects up to the next audio objects
+    QSet<Object*> serialObjects;
+    for (ObjectBuffer * b : audioObjects)
+    {
+        QSet<Object*> visited;
+        QList<Object*> stack;
+        stack << b->object;
+        while (!stack.isEmpty())
+        {
+            auto s = sources.find(stack.takeLast());
+            if (s == sources.end())
+                continue;
+            for (Object * src : s->second)
+            {
+                if (visited.contains(src))
+                    continue;
+                visited.insert(src);
+
+                if (src->isAudioObject())
+                {
+                    if (src != b->object && inPath.contains(src))
+                    {
+                        linked[src].insert(b->object);
+                        linked[b->object].insert(src);
+                    }
+                }
+                else
+                {
+                    serialObjects.insert(b->object);
+                    stack << src;
+                }
+            }
+        }
+    }
+
+    std::map<Object*, int> levelOf;
+    for (ObjectBuffer * b : audioObjects)
+    {
+        int level = 0;
+        auto i = linked.find(b->object);
+        if (i != linked.end())
+            for (Object * o : i->second)
+            {
+                auto l = levelOf.find(o);
+                if (l != levelOf.end())
+                    level = std::max(level, l->second + 1);
+            }
+        levelOf[b->object] = level;
+
+        if (level >= (int)audioLevels.size())
+            audioLevels.resize(level + 1);
+
+        // consecutive objects of the same kind share one step
+        auto& steps = audioLevels[level].steps;
+        const bool parallel = !serialObjects.contains(b->object);
+        if (steps.empty() || steps.back().parallel != parallel)
+            steps.push_back(AudioStep(parallel));
+        steps.back().objects << b;
+    }
+}
+
+
 void ObjectDspPath::Private::prepareAudioInputBuffers(ObjectBuffer * buf)
 {
     MO_ASSERT(dynamic_cast<AudioObject*>(buf->object),
@@ -809,7 +1075,7 @@ void ObjectDspPath::Private::prepareAudioInputBuffers(ObjectBuffer * buf)
     // get input connections
     auto ins = scene->audioConnections()->getInputs(o);
 
-    int numChannels = o->numAudioInputs();
+    int numChannels = numAudioInputs(o);
 
     // determine from inputs
     if (numChannels < 0)
@@ -877,7 +1143,7 @@ void ObjectDspPath::Private::prepareAudioOutputBuffers(ObjectBuffer * buf)
     if (!oout)
     {
         auto outs = scene->audioConnections()->getOutputs(ao);
-        for (uint i = 0; i < ao->numAudioOutputs(); ++i)
+        for (uint i = 0; i < numAudioOutputs(ao); ++i)
         {
             // links (also) to a modulator?
             const bool isModOut = hasAudioToModulator(ao, i);
@@ -33,13 +33,38 @@ public:
 
     std::ostream& dump(std::ostream &) const;
 
-    // --------------- creation ---------------
+    /** Number of threads used to process independent audio objects */
+    uint numberDspThreads() const;
+
+    /** Distance in samples at which transformations are calculated */
+    uint transformationDecimation() const;
+
+    // --------------- setter -----------------
 
-    /** Completely creates the whole dsp path, with all buffers */
-    void createPath(Scene * scene, const AUDIO::Configuration& conf, uint thread);
+    /** Sets the number of threads (including the audio thread) that
+        process independent AudioObjects in parallel.
+        1 means serial processing, 0 uses the number of processors.
+        The output is the same as in serial processing. */
+    void setNumberDspThreads(uint num);
+
+    /** Sets the distance in samples at which object transformations
+        are calculated. The transformations in between are interpolated.
+        1 calculates every sample. */
+    void setTransformationDecimation(uint samples);
+
+    // --------------- creation ---------------
 
-    /** Final creation of dsp stuff
-        - to be called from the thread that will call calcAudio() */
+    /** Completely creates the whole dsp path, with all buffers.
+        If @p assignBuffers is false, the buffers and the channel count
+        of the system io objects are not assigned to the AudioObjects
+        until preparePath(). The scene is then only read, so the path
+        can be created while another path is still processing. */
+    void createPath(Scene * scene, const AUDIO::Configuration& conf, uint thread,
+                    bool assignBuffers = true);
+
+    /** Final creation of dsp stuff, assigns deferred buffers and creates
+        the udp streams. Must not run while another path of the same
+        scene is processing. */
     void preparePath();
 
     // ---------------- calc ------------------
@@ -8,6 +8,8 @@
     <p>created 9/29/2015</p>
 */
 
+#include <QImage>
+
 #include "ImageGallery.h"
 #include "object/Scene.h"
 #include "gl/Shader.h"
@@ -17,6 +19,7 @@
 #include "gl/VertexArrayObject.h"
 #include "gl/compatibility.h"
 #include "gl/Texture.h"
+#include "gl/TextureLoader.h"
 #include "math/vector.h"
 #include "math/constants.h"
 #include "math/random.h"
@@ -46,15 +49,17 @@ MO_REGISTER_OBJECT(ImageGallery)
 
 struct ImageGallery::Entity_
 {
-    Entity_() : tex(0), index(0), indexT(0.f), aspect(1.f) { }
+    Entity_() : image(0), index(0), indexT(0.f), aspect(1.f), isSized(false) { }
     ~Entity_()
     {
-        delete tex;
+        GL::TextureLoader::release(image);
     }
 
-    GL::Texture * tex;
+    GL::TextureLoader::Image * image;
     int index;
     Float indexT, aspect, heightM;
+    /** aspect is set from decoded image */
+    bool isSized;
     Mat4 transformFrame,
          transformImage,
          transformCurrent,
@@ -71,7 +76,9 @@ ImageGallery::ImageGallery()
       u_light_amt_  (0),
       doRecompile_  (true),
       doCalcBaseTransform_(true),
-      doCreateVaos_ (true)
+      doCreateVaos_ (true),
+      isLoading_    (false),
+      placeholder_  (0)
 {
     setName("ImageGallery");
     initDefaultUpdateMode(UM_ALWAYS, false);
@@ -507,40 +514,32 @@ void ImageGallery::initGl(uint /*thread*/)
 
     releaseAll_();
 
-    // load image textures
+    // shown until each image is uploaded
+    QImage black(1, 1, QImage::Format_ARGB32);
+    black.fill(Qt::black);
+    placeholder_ = GL::Texture::createFromImage(black, gl::GL_RGBA);
 
+    // request image textures
     int k = 0;
     for (const QString& fn : imageList_->baseValue())
     {
         QString fnl = IO::fileManager().localFilename(fn);
 
-        try
-        {
-            // get texture
-            auto tex = GL::Texture::createFromImage(
-                        fnl, gl::GL_RGBA, mipmaps_->baseValue());
-
-            // interpolation modes
-            tex->setTexParameter(gl::GL_TEXTURE_MIN_FILTER, paramMin_->baseValue());
-            tex->setTexParameter(gl::GL_TEXTURE_MAG_FILTER, paramMag_->baseValue());
-
-            // add an entry in vao entity list
-            auto v = new Entity_();
-            v->tex = tex;
-            v->index = k++;
-            v->aspect = std::max(0.0001f, float(v->tex->width()) / v->tex->height());
-            entities_ << v;
-        }
-        catch (const Exception& e)
-        {
-            setErrorMessage(e.what());
-        }
+        // add an entry in vao entity list
+        auto v = new Entity_();
+        v->image = GL::TextureLoader::load(fnl, gl::GL_RGBA, mipmaps_->baseValue());
+        v->index = k++;
+        entities_ << v;
     }
 
     // set indexT field [0,1)
     for (auto v : entities_)
         v->indexT = Float(v->index) / entities_.size();
 
+    // load everything now, when resources are expected to be ready
+    isLoading_ = true;
+    updateImages_(sceneObject() && sceneObject()->lazyFlag());
+
     doCalcBaseTransform_ = doRecompile_ = doCreateVaos_ = true;
 }
 
@@ -745,12 +744,14 @@ void ImageGallery::releaseAll_()
     MO_DEBUG_IG("releaseAll_()");
 
     for (auto v : entities_)
-    {
-        if (v->tex && v->tex->isAllocated())
-            v->tex->release();
-        delete v->tex;
-    }
+        delete v;
     entities_.clear();
+    isLoading_ = false;
+
+    if (placeholder_ && placeholder_->isAllocated())
+        placeholder_->release();
+    delete placeholder_;
+    placeholder_ = 0;
 
     frameTexSet_->releaseGl();
 
@@ -778,6 +779,11 @@ void ImageGallery::renderGl(const GL::RenderSettings& rs, const RenderTime& time
         doCreateVaos_ = true;
     }
 
+    if (isLoading_)
+    {
+        updateImages_(false);
+    }
+
     if (doRecompile_)
     {
         setupShader_();
@@ -938,10 +944,13 @@ void ImageGallery::renderGl(const GL::RenderSettings& rs, const RenderTime& time
                                             &(trans * v->transformImage)[0][0]) );
 
         // bind the image texture
-        v->tex->bind();
+        GL::Texture * tex = v->image->texture();
+        if (!tex)
+            tex = placeholder_;
+        tex->bind();
         // set interpolation mode
-        v->tex->setTexParameter(gl::GL_TEXTURE_MIN_FILTER, paramMin_->baseValue());
-        v->tex->setTexParameter(gl::GL_TEXTURE_MAG_FILTER, paramMag_->baseValue());
+        tex->setTexParameter(gl::GL_TEXTURE_MIN_FILTER, paramMin_->baseValue());
+        tex->setTexParameter(gl::GL_TEXTURE_MAG_FILTER, paramMag_->baseValue());
 
         // render image
         vaoImage_->drawElements();
@@ -952,6 +961,42 @@ void ImageGallery::renderGl(const GL::RenderSettings& rs, const RenderTime& time
 }
 
 
+void ImageGallery::updateImages_(bool wait)
+{
+    bool finished = true;
+    for (auto v : entities_)
+    {
+        try
+        {
+            v->image->upload(wait);
+        }
+        catch (const Exception&)
+        {
+            // error is reported below
+        }
+
+        // image size known
+        if (!v->isSized && v->image->isDecoded())
+        {
+            v->aspect = std::max(0.0001f,
+                        float(v->image->width()) / v->image->height());
+            v->isSized = true;
+            doCalcBaseTransform_ = true;
+        }
+
+        if (!v->image->isReady() && !v->image->hasError())
+            finished = false;
+    }
+
+    if (!finished)
+        return;
+
+    isLoading_ = false;
+    for (auto v : entities_)
+        if (v->image->hasError())
+            setErrorMessage(v->image->errorString());
+}
+
 void ImageGallery::calcEntityBaseTransform_()
 {
     MATH::Random<> rnd(randomSeed_->baseValue());
@@ -66,6 +66,8 @@ private:
     void setupVaos_();
     void releaseVaos_();
     void releaseAll_();
+    /** Continues loading the images, updates the aspect ratios */
+    void updateImages_(bool wait);
 
     void calcEntityBaseTransform_();
     void calcEntityTransform_(const RenderTime& time);
@@ -116,7 +118,9 @@ private:
 
     bool doRecompile_,
          doCalcBaseTransform_,
-         doCreateVaos_;
+         doCreateVaos_,
+         isLoading_;
+    GL::Texture * placeholder_;
 };
 
 } // namespace MO
@@ -62,7 +62,8 @@ Model3d::Model3d()
       u_bump_scale_ (0),
       u_vertex_extrude_(0),
       doRecompile_  (false),
-      loadedVersion_(0)
+      loadedVersion_(0),
+      hasExtent_    (false)
     , xxx_2d        (0)
     , xxx_cube      (0)
     , xxx_u_2d        (0)
@@ -685,6 +686,21 @@ const GEOM::Geometry* Model3d::geometry() const
     return draw_ ? draw_->geometry() : 0;
 }
 
+bool Model3d::getLocalExtent(Vec3 *minimum, Vec3 *maximum) const
+{
+    if (!hasExtent_ || nextGeometry_
+        || fixPosition_->baseValue() != 0
+        || vertexFx_->baseValue() != 0
+        || glslDoOverride_->baseValue() != 0
+        || paramNumInstance_->baseValue() > 1
+        || paramNumInstance_->isModulated())
+        return false;
+
+    *minimum = extentMin_;
+    *maximum = extentMax_;
+    return true;
+}
+
 Vec4 Model3d::modelColor(const RenderTime& time) const
 {
     const auto b = cbright_->value(time);
@@ -752,6 +768,7 @@ void Model3d::releaseGl(uint /*thread*/)
 
     delete draw_;
     draw_ = 0;
+    hasExtent_ = false;
 
     resetCreator_();
 }
@@ -1063,6 +1080,10 @@ void Model3d::renderGl(const GL::RenderSettings& rs, const RenderTime& time)
         nextGeometry_ = 0;
         draw_->setGeometry(g);
         setupDrawable_();
+
+        hasExtent_ = g->numVertices() > 0;
+        if (hasExtent_)
+            g->getExtent(&extentMin_, &extentMax_);
     }
 
     if (doRecompile_)
@@ -60,6 +60,11 @@ public:
             uint channel, const RenderTime& time) const Q_DECL_OVERRIDE
     { Q_UNUSED(time); return channel == 0 ? geometry() : 0; }
 
+    /** Extent of the current geometry, unless the shader
+        moves the vertices (vertex effects, glsl override, instancing)
+        or the model is fixed to the camera */
+    virtual bool getLocalExtent(Vec3 * minimum, Vec3 * maximum) const Q_DECL_OVERRIDE;
+
 protected:
 
     virtual void initGl(uint thread) Q_DECL_OVERRIDE;
@@ -119,6 +124,9 @@ private:
     bool doRecompile_;
     int loadedVersion_;
 
+    Vec3 extentMin_, extentMax_;
+    bool hasExtent_;
+
     GL::Texture * xxx_2d, * xxx_cube;
     GL::Uniform * xxx_u_2d, * xxx_u_cube;
 };
@@ -18,6 +18,7 @@
 #include "io/log_tree.h"
 #include "gl/Context.h"
 #include "io/DataStream.h"
+#include "math/Frustum.h"
 #include "object/Scene.h"
 #include "object/TextObject.h"
 #include "object/param/Parameters.h"
@@ -39,6 +40,8 @@ ObjectGl::ObjectGl()
       p_alphaBlend_             (this),
       p_numberLightSources_     (0),
       p_renderCount_            (0),
+      p_hasBounds_              (false),
+      p_isCulled_               (false),
       p_defaultDepthTestMode_   (DTM_PARENT),
       p_defaultDepthWriteMode_  (DWM_PARENT),
       p_defaultAlphaBlendMode_  (AlphaBlendSetting::M_PARENT),
@@ -296,6 +299,35 @@ void ObjectGl::p_renderGl_(const GL::RenderSettings &rs, const RenderTime & time
 
 }
 
+void ObjectGl::p_updateBoundingVolume_()
+{
+    Vec3 mi, ma;
+    if (!getLocalExtent(&mi, &ma))
+    {
+        p_hasBounds_ = false;
+        p_isCulled_ = false;
+        return;
+    }
+
+    const Mat4& trans = transformation();
+    if (p_hasBounds_
+        && mi == p_localMin_ && ma == p_localMax_
+        && trans == p_boundsTrans_)
+        return;
+
+    p_localMin_ = mi;
+    p_localMax_ = ma;
+    p_boundsTrans_ = trans;
+    MATH::transform_box(trans, mi, ma, &p_boundsMin_, &p_boundsMax_);
+    p_hasBounds_ = true;
+}
+
+bool ObjectGl::p_isInFrustum_(const MATH::Frustum& f)
+{
+    p_isCulled_ = p_hasBounds_ && !f.intersectsBox(p_boundsMin_, p_boundsMax_);
+    return !p_isCulled_;
+}
+
 void ObjectGl::requestRender()
 {
     p_updateRequest_ = true;
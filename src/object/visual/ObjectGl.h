@@ -19,6 +19,7 @@
 
 namespace MO {
 namespace GL { class Context; class Drawable; }
+namespace MATH { class Frustum; }
 
 /** Base of all OpenGL objects. */
 class ObjectGl : public Object
@@ -109,6 +110,24 @@ public:
     /** Number of times p_renderGl_() was called */
     unsigned long renderCount() const { return p_renderCount_; }
 
+    // ---------------- bounding volume -----------------
+
+    /** Override to return the object-space extent of everything
+        that renderGl() will draw.
+        Objects that return false are never culled by the Scene. */
+    virtual bool getLocalExtent(Vec3 * minimum, Vec3 * maximum) const
+        { Q_UNUSED(minimum); Q_UNUSED(maximum); return false; }
+
+    /** Returns true when the world-space bounding box is known,
+        as updated by the Scene on each frame */
+    bool hasBoundingVolume() const { return p_hasBounds_; }
+    /** World-space axis-aligned bounding box */
+    const Vec3& boundingMinimum() const { return p_boundsMin_; }
+    const Vec3& boundingMaximum() const { return p_boundsMax_; }
+
+    /** True when the bounding box was outside the last tested frustum */
+    bool isCulled() const { return p_isCulled_; }
+
     // ------------- opengl virtual interface -----------
 
     /** Override to initialize opengl resources.
@@ -164,6 +183,12 @@ private:
     void p_releaseGl_(uint thread);
     void p_renderGl_(const GL::RenderSettings& rs, const RenderTime& time);
 
+    /** Recalculates the world-space bounding box when
+        transformation or local extent have changed */
+    void p_updateBoundingVolume_();
+    /** Tests the bounding box against the frustum and sets p_isCulled_ */
+    bool p_isInFrustum_(const MATH::Frustum&);
+
     std::vector<GL::Context*> p_glContext_;
     std::vector<int> p_needsInitGl_, p_isGlInitialized_;
 
@@ -174,6 +199,13 @@ private:
 
     unsigned long p_renderCount_;
 
+    // --- bounding volume ---
+
+    Mat4 p_boundsTrans_;
+    Vec3 p_localMin_, p_localMax_,
+         p_boundsMin_, p_boundsMax_;
+    bool p_hasBounds_, p_isCulled_;
+
     // --- render state ---
 
     DepthTestMode p_defaultDepthTestMode_, p_curDepthTestMode_;
@@ -205,6 +205,7 @@ void ProjectorMapper::mapToDome(GEOM::Geometry * g) const
         v[1] = d[1];
         v[2] = d[2];
     }
+    g->setChanged();
 }
 
 void ProjectorMapper::mapToDome(const QVector<Vec2> &slice_coords, QVector<Vec3> &dome_coords) const
@@ -240,6 +241,7 @@ void ProjectorMapper::mapFromDome(GEOM::Geometry * g) const
         v[1] = slice[1];
         v[2] = 0.f;
     }
+    g->setChanged();
 }
 
 void ProjectorMapper::mapFromDome(const QVector<Vec3> &dome_coords, QVector<Vec2> &slice_coords) const
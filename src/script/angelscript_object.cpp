@@ -169,6 +169,7 @@ public:
     uint parameterCount() { return o->params()->parameters().size(); }
     ParameterAS * parameter(uint index);
     ParameterAS * findParameter(const StringAS&);
+    int parameterIndex(const StringAS& id) { return o->params()->findParameterHandle(MO::toString(id)); }
 
     Mat4 transformation() const { return o->transformation(); }
     Double time() const { auto s = o->sceneObject(); return s ? s->sceneTime() : 0.; }
@@ -498,10 +499,9 @@ bool ObjectAS::addObject_(Object * newChild, int index)
 
 ParameterAS * ObjectAS::parameter(uint index)
 {
-    if ((int)index >= o->params()->parameters().count())
-        return 0;
+    auto p = o->params()->parameter(index);
 
-    return ParameterAS::wrap_(o->params()->parameters()[index]);
+    return p ? ParameterAS::wrap_(p) : 0;
 }
 
 ParameterAS * ObjectAS::findParameter(const StringAS& as)
@@ -654,6 +654,7 @@ static void register_object_base(asIScriptEngine *engine, const char * typ)
     MO__REG_METHOD("uint parameterCount() const", parameterCount);
     MO__REG_METHOD("Parameter@ parameter(uint index) const", parameter);
     MO__REG_METHOD("Parameter@ parameter(const string &in id) const", findParameter);
+    MO__REG_METHOD("int parameterIndex(const string &in id) const", parameterIndex);
 
     MO__REG_METHOD("double time() const", time);
     MO__REG_METHOD("mat4 transformation() const", transformation);
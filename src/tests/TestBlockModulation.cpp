@@ -0,0 +1,175 @@
+/** @file testblockmodulation.cpp
+
+    @brief Compares block-wise and per-sample modulation values
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <cmath>
+#include <vector>
+
+#include "TestBlockModulation.h"
+#include "object/Scene.h"
+#include "object/control/SequenceFloat.h"
+#include "object/param/Parameters.h"
+#include "object/param/ParameterFloat.h"
+#include "object/util/ObjectFactory.h"
+#include "io/log.h"
+
+namespace MO {
+
+struct TestBlockModulation::Private
+{
+    Private()
+        : scene     (ObjectFactory::createSceneObject())
+    { }
+
+    ~Private() { scene->releaseRef("TestBlockModulation"); }
+
+    SequenceFloat * createSequence(SequenceFloat::SequenceType type,
+                                   bool addToScene = true);
+
+    bool testSequence(SequenceFloat::SequenceType type);
+    bool testModulatedParameter();
+    bool testSequenceEnd();
+
+    /** Compares getValuesBlock() with valueFloat() for a few blocks */
+    bool compareSequence(const SequenceFloat * seq, Double startSecond);
+
+    Scene * scene;
+};
+
+TestBlockModulation::TestBlockModulation()
+    : p_        (new Private())
+{
+}
+
+TestBlockModulation::~TestBlockModulation()
+{
+    delete p_;
+}
+
+int TestBlockModulation::run()
+{
+    int errors = 0;
+    errors += !p_->testSequence(SequenceFloat::ST_CONSTANT);
+    errors += !p_->testSequence(SequenceFloat::ST_OSCILLATOR);
+    errors += !p_->testModulatedParameter();
+    errors += !p_->testSequenceEnd();
+    return errors;
+}
+
+namespace {
+
+    const uint sampleRate = 44100,
+               blockSize = 256;
+    const F32 tolerance = 0.00001f;
+
+    RenderTime blockTime(Double second)
+    {
+        return RenderTime(second, 0., SamplePos(second * sampleRate),
+                          sampleRate, blockSize, MO_AUDIO_THREAD);
+    }
+
+} // namespace
+
+SequenceFloat * TestBlockModulation::Private::createSequence(
+        SequenceFloat::SequenceType type, bool addToScene)
+{
+    auto seq = ObjectFactory::createSequenceFloat();
+    seq->setSequenceType(type);
+    seq->setFrequency(3.7);
+    seq->setLength(10.);
+    if (addToScene)
+        scene->addObject(scene, seq);
+    return seq;
+}
+
+bool TestBlockModulation::Private::compareSequence(
+        const SequenceFloat * seq, Double startSecond)
+{
+    std::vector<F32> block(blockSize);
+
+    for (int b=0; b<4; ++b)
+    {
+        const RenderTime time = blockTime(startSecond) + SamplePos(b * blockSize);
+        seq->getValuesBlock(0, time, &block[0], blockSize);
+
+        for (uint i=0; i<blockSize; ++i)
+        {
+            const F32 v = seq->valueFloat(0, time + SamplePos(i));
+            if (std::abs(block[i] - v) > tolerance)
+            {
+                MO_PRINT("FAILED: sequence type " << seq->sequenceType()
+                         << " sample " << (b * blockSize + i)
+                         << ": block " << block[i] << ", per-sample " << v);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TestBlockModulation::Private::testSequence(SequenceFloat::SequenceType type)
+{
+    return compareSequence(createSequence(type), 1.25);
+}
+
+bool TestBlockModulation::Private::testSequenceEnd()
+{
+    // the blocks cross the end of the sequence,
+    // where the modulator becomes inactive
+    auto seq = createSequence(SequenceFloat::ST_OSCILLATOR);
+    seq->setLength(1.);
+    return compareSequence(seq, 1. - Double(blockSize * 2) / sampleRate);
+}
+
+bool TestBlockModulation::Private::testModulatedParameter()
+{
+    auto mod1 = createSequence(SequenceFloat::ST_OSCILLATOR),
+         mod2 = createSequence(SequenceFloat::ST_OSCILLATOR),
+         target = createSequence(SequenceFloat::ST_CONSTANT, false);
+    mod2->setFrequency(11.);
+    mod2->setLength(1.5);
+
+    auto param = dynamic_cast<ParameterFloat*>(target->params()->findParameter("amp"));
+    if (!param)
+    {
+        MO_PRINT("FAILED: no amplitude parameter in SequenceFloat");
+        return false;
+    }
+    param->addModulator(mod1->idName(), "");
+    param->addModulator(mod2->idName(), "");
+    // modulators are resolved on insertion
+    scene->addObject(scene, target);
+
+    if (param->modulators().size() != 2 || !param->modulators()[1]->modulator())
+    {
+        MO_PRINT("FAILED: modulators not resolved");
+        return false;
+    }
+
+    std::vector<F32> block(blockSize);
+    for (int b=0; b<8; ++b)
+    {
+        const RenderTime time = blockTime(1.48) + SamplePos(b * blockSize);
+        param->getValuesBlock(time, &block[0], blockSize);
+
+        for (uint i=0; i<blockSize; ++i)
+        {
+            const F32 v = param->value(time + SamplePos(i));
+            if (std::abs(block[i] - v) > tolerance)
+            {
+                MO_PRINT("FAILED: modulated parameter sample " << (b * blockSize + i)
+                         << ": block " << block[i] << ", per-sample " << v);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace MO
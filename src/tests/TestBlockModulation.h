@@ -0,0 +1,31 @@
+/** @file testblockmodulation.h
+
+    @brief Compares block-wise and per-sample modulation values
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTBLOCKMODULATION_H
+#define MOSRC_TESTS_TESTBLOCKMODULATION_H
+
+namespace MO {
+
+class TestBlockModulation
+{
+public:
+    TestBlockModulation();
+    ~TestBlockModulation();
+
+    int run();
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTBLOCKMODULATION_H
@@ -0,0 +1,227 @@
+/** @file testclocksync.cpp
+
+    @brief Tests for ClockSync
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <iostream>
+#include <cmath>
+
+#include "TestClockSync.h"
+#include "network/ClockSync.h"
+
+namespace MO {
+
+namespace {
+
+    /** A simulated server clock and network link */
+    struct Link
+    {
+        Link(Double offset, Double drift = 0.)
+            : offset(offset), drift(drift)
+        { }
+
+        Double server(Double local) const
+            { return local + offset + drift * local; }
+
+        /** Feeds one round-trip starting at local time @p t0,
+            with network delays @p up and @p down and
+            the server's processing time @p proc */
+        void roundTrip(ClockSync& cs, Double t0,
+                       Double up, Double down, Double proc) const
+        {
+            const Double
+                    t1 = server(t0 + up),
+                    t2 = server(t0 + up + proc),
+                    t3 = t0 + up + proc + down;
+            cs.addRoundTrip(t0, t1, t2, t3);
+        }
+
+        Double offset, drift;
+    };
+
+    bool near(Double a, Double b, Double eps)
+    {
+        return std::abs(a - b) <= eps;
+    }
+
+    int testOffset()
+    {
+        std::cout << "offset with symmetric delays\n";
+
+        const Link link(1234.5);
+        ClockSync cs;
+        if (cs.isSynchronized())
+        {
+            std::cout << "[synchronized without measurement]\n";
+            return 1;
+        }
+
+        for (int i=0; i<8; ++i)
+            link.roundTrip(cs, 10. + i * 0.1, 0.005, 0.005, 0.001);
+
+        if (!cs.isSynchronized() || cs.numSamples() != 8)
+        {
+            std::cout << "[expected 8 samples, got " << cs.numSamples() << "]\n";
+            return 1;
+        }
+        if (!near(cs.offset(), link.offset, 1e-6))
+        {
+            std::cout << "[offset " << cs.offset()
+                      << ", expected " << link.offset << "]\n";
+            return 1;
+        }
+        if (!near(cs.serverTime(20.), link.server(20.), 1e-6))
+        {
+            std::cout << "[server time " << cs.serverTime(20.)
+                      << ", expected " << link.server(20.) << "]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+    int testRoundTrip()
+    {
+        std::cout << "round-trip time without server processing time\n";
+
+        const Link link(-3.);
+        ClockSync cs;
+
+        // the server's processing time must not count as latency
+        link.roundTrip(cs, 1., 0.004, 0.006, 0.5);
+        if (!near(cs.roundTrip(), 0.01, 1e-9))
+        {
+            std::cout << "[round-trip " << cs.roundTrip() << ", expected 0.01]\n";
+            return 1;
+        }
+        // asymmetric delays shift the offset by half the difference
+        if (!near(cs.offset(), link.offset - 0.001, 1e-9))
+        {
+            std::cout << "[offset " << cs.offset()
+                      << ", expected " << (link.offset - 0.001) << "]\n";
+            return 1;
+        }
+
+        // the lowest round-trip is reported
+        link.roundTrip(cs, 2., 0.002, 0.002, 0.);
+        link.roundTrip(cs, 3., 0.05, 0.01, 0.);
+        if (!near(cs.roundTrip(), 0.004, 1e-9))
+        {
+            std::cout << "[round-trip " << cs.roundTrip() << ", expected 0.004]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+    int testQueuedSamples()
+    {
+        std::cout << "offset with queued round-trips\n";
+
+        const Link link(42.);
+        ClockSync cs;
+
+        // every third request is held up on the way to the server,
+        // which would bias the offset by 25ms
+        for (int i=0; i<30; ++i)
+            link.roundTrip(cs, i * 0.5,
+                           i % 3 == 0 ? 0.055 : 0.005, 0.005, 0.001);
+
+        if (!near(cs.offset(), link.offset, 1e-6))
+        {
+            std::cout << "[offset " << cs.offset()
+                      << ", expected " << link.offset << "]\n";
+            return 1;
+        }
+        if (!near(cs.roundTrip(), 0.01, 1e-9))
+        {
+            std::cout << "[round-trip " << cs.roundTrip() << ", expected 0.01]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+    int testDrift()
+    {
+        std::cout << "drift of the server clock\n";
+
+        // 100 ppm faster than the local clock
+        const Link link(7., 1e-4);
+        ClockSync cs;
+
+        for (int i=0; i<40; ++i)
+            link.roundTrip(cs, i, 0.003, 0.003, 0.001);
+
+        if (cs.numSamples() != 32)
+        {
+            std::cout << "[expected 32 samples in window, got "
+                      << cs.numSamples() << "]\n";
+            return 1;
+        }
+        if (!near(cs.drift(), link.drift, 1e-7))
+        {
+            std::cout << "[drift " << cs.drift()
+                      << ", expected " << link.drift << "]\n";
+            return 1;
+        }
+        // extrapolate a minute ahead
+        if (!near(cs.serverTime(100.), link.server(100.), 1e-5))
+        {
+            std::cout << "[server time " << cs.serverTime(100.)
+                      << ", expected " << link.server(100.) << "]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+    int testReset()
+    {
+        std::cout << "reset\n";
+
+        const Link link(1.);
+        ClockSync cs;
+        link.roundTrip(cs, 0., 0.01, 0.01, 0.);
+        cs.addSceneTime(5., link.server(0.), true, 0.);
+        cs.reset();
+
+        if (cs.isSynchronized() || cs.hasSceneTime() || cs.isPlaying()
+                || cs.numSamples() != 0 || cs.offset() != 0.)
+        {
+            std::cout << "[state left after reset]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+} // namespace
+
+
+TestClockSync::TestClockSync()
+{
+}
+
+int TestClockSync::run()
+{
+    int errors =
+            + testOffset()
+            + testRoundTrip()
+            + testQueuedSamples()
+            + testDrift()
+            + testReset()
+            ;
+
+    if (errors)
+        std::cout << errors << " clock sync tests failed\n";
+
+    return errors;
+}
+
+} // namespace MO
@@ -0,0 +1,26 @@
+/** @file testclocksync.h
+
+    @brief Tests for ClockSync
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTCLOCKSYNC_H
+#define MOSRC_TESTS_TESTCLOCKSYNC_H
+
+namespace MO {
+
+class TestClockSync
+{
+public:
+    TestClockSync();
+
+    int run();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTCLOCKSYNC_H
@@ -0,0 +1,148 @@
+/** @file testconvolver.cpp
+
+    @brief Tests AUDIO::PartitionedConvolver against direct convolution
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cmath>
+
+#include "TestConvolver.h"
+#include "audio/tool/PartitionedConvolver.h"
+
+namespace MO {
+
+namespace {
+
+    /** Deterministic noise in [-1,1] */
+    F32 noise(size_t i)
+    {
+        size_t x = (i + 1) * 2654435761u;
+        x ^= x >> 13;
+        x *= 1274126177u;
+        x ^= x >> 16;
+        return F32(x % 20001) / 10000.f - 1.f;
+    }
+
+    std::vector<F32> createKernel(size_t num)
+    {
+        std::vector<F32> k(num);
+        for (size_t i=0; i<num; ++i)
+            k[i] = 0.1f * noise(i + 7777) * std::exp(-F32(i) / 2000.f);
+        return k;
+    }
+
+    std::vector<F32> directConvolution(const std::vector<F32>& input,
+                                       const std::vector<F32>& kernel)
+    {
+        std::vector<F32> out(input.size(), 0.f);
+        for (size_t n=0; n<input.size(); ++n)
+        {
+            double sum = 0.;
+            for (size_t k=0; k<kernel.size() && k<=n; ++k)
+                sum += double(kernel[k]) * input[n-k];
+            out[n] = sum;
+        }
+        return out;
+    }
+
+    /** Convolves with @p numChannels convolvers at once,
+        so the tails share the worker threads.
+        @p chunk is the number of samples per process() call,
+        0 for varying sizes. */
+    int testConvolution(size_t kernelSize, size_t blockSize,
+                        size_t tailBlockSize, size_t chunk,
+                        size_t numChannels = 3)
+    {
+        const size_t num = 6 * std::max(tailBlockSize, size_t(4096)) + 17;
+
+        std::cout << "kernel " << kernelSize << ", block " << blockSize
+                  << ", tail " << tailBlockSize << ", chunk " << chunk
+                  << ", channels " << numChannels << ": ";
+
+        const auto kernel = createKernel(kernelSize);
+
+        std::vector<std::vector<F32>> inputs, outputs;
+        std::vector<std::unique_ptr<AUDIO::PartitionedConvolver>> convs;
+        for (size_t c=0; c<numChannels; ++c)
+        {
+            std::vector<F32> in(num);
+            for (size_t i=0; i<num; ++i)
+                in[i] = noise(i + c * num);
+            inputs.push_back(in);
+            outputs.push_back(std::vector<F32>(num, 0.f));
+
+            convs.push_back(std::unique_ptr<AUDIO::PartitionedConvolver>(
+                                new AUDIO::PartitionedConvolver));
+            convs.back()->init(blockSize, kernel.data(), kernel.size(),
+                               tailBlockSize);
+        }
+
+        // process all channels block-wise
+        size_t pos = 0, step = 0;
+        while (pos < num)
+        {
+            size_t n = chunk ? chunk : 1 + (step * 37) % (2 * blockSize);
+            n = std::min(n, num - pos);
+            for (size_t c=0; c<numChannels; ++c)
+                convs[c]->process(&inputs[c][pos], &outputs[c][pos], n);
+            pos += n;
+            ++step;
+        }
+
+        F32 maxDiff = 0.f;
+        for (size_t c=0; c<numChannels; ++c)
+        {
+            const auto ref = directConvolution(inputs[c], kernel);
+            for (size_t i=0; i<num; ++i)
+                maxDiff = std::max(maxDiff, std::abs(ref[i] - outputs[c][i]));
+        }
+
+        if (maxDiff > 0.0001f)
+        {
+            std::cout << "[differs by " << maxDiff << "]\n";
+            return 1;
+        }
+        std::cout << "OK\n";
+        return 0;
+    }
+
+} // namespace
+
+
+TestConvolver::TestConvolver()
+{
+}
+
+int TestConvolver::run()
+{
+    int errors = 0;
+
+    // head only
+    errors += testConvolution(300, 128, 512, 128);
+    // head and first tail part
+    errors += testConvolution(700, 128, 512, 128);
+    // head and both tail parts
+    errors += testConvolution(5000, 128, 512, 128);
+    errors += testConvolution(5000, 64, 1024, 64);
+    // default tail size
+    errors += testConvolution(20000, 256, 0, 256);
+    // block sizes that differ from the head partition size
+    errors += testConvolution(5000, 100, 512, 100);
+    errors += testConvolution(5000, 128, 512, 0);
+    // many convolvers sharing the worker threads
+    errors += testConvolution(3000, 64, 256, 64, 16);
+
+    if (errors)
+        std::cout << errors << " convolution tests failed\n";
+
+    return errors;
+}
+
+} // namespace MO
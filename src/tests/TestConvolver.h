@@ -0,0 +1,26 @@
+/** @file testconvolver.h
+
+    @brief Tests AUDIO::PartitionedConvolver against direct convolution
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTCONVOLVER_H
+#define MOSRC_TESTS_TESTCONVOLVER_H
+
+namespace MO {
+
+class TestConvolver
+{
+public:
+    TestConvolver();
+
+    int run();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTCONVOLVER_H
@@ -0,0 +1,163 @@
+/** @file testdsppath.cpp
+
+    @brief Compares parallel and serial processing of ObjectDspPath
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <vector>
+
+#include "TestDspPath.h"
+#include "object/Scene.h"
+#include "object/audio/OscillatorAO.h"
+#include "object/audio/FilterAO.h"
+#include "object/audio/AudioOutAO.h"
+#include "object/control/SequenceFloat.h"
+#include "object/param/Parameters.h"
+#include "object/param/ParameterFloat.h"
+#include "object/util/ObjectFactory.h"
+#include "object/util/ObjectDspPath.h"
+#include "object/util/AudioObjectConnections.h"
+#include "audio/Configuration.h"
+#include "audio/tool/AudioBuffer.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    void setParam(Object * o, const QString& id, Double value)
+    {
+        if (auto p = dynamic_cast<ParameterFloat*>(o->params()->findParameter(id)))
+            p->setValue(value);
+    }
+
+    void modulate(Object * o, const QString& id, Object * source,
+                  const QString& outputId = QString())
+    {
+        if (auto p = o->params()->findParameter(id))
+            p->addModulator(source->idName(), outputId);
+    }
+
+    template <class OBJ>
+    OBJ * create(const QString& id, QList<Object*>& objects)
+    {
+        auto o = create_object<OBJ>(id);
+        ObjectPrivate::setObjectId(o, id);
+        objects << o;
+        return o;
+    }
+
+    /** Builds the same scene for each call:
+        - independent oscillators and filters (parallel)
+        - an oscillator modulating a filter by audio
+        - an oscillator modulating a sequence which modulates
+          another oscillator, the latter is processed serially */
+    Scene * createScene()
+    {
+        QList<Object*> objects;
+
+        QList<OscillatorAO*> osc;
+        for (int i=0; i<6; ++i)
+        {
+            auto o = create<OscillatorAO>(QString("osc%1").arg(i), objects);
+            setParam(o, "osc_freq", 100. + 37. * i);
+            osc << o;
+        }
+
+        QList<FilterAO*> filter;
+        for (int i=0; i<3; ++i)
+            filter << create<FilterAO>(QString("filter%1").arg(i), objects);
+
+        auto out = create<AudioOutAO>("out", objects);
+
+        // sequence whose amplitude follows osc0
+        auto seq = create<SequenceFloat>("seq", objects);
+        seq->setSequenceType(SequenceFloat::ST_OSCILLATOR);
+        seq->setLength(100.);
+        modulate(seq, "amp", osc[0], "_audio_0");
+
+        // osc5 depends on osc0 through the sequence
+        modulate(osc[5], "osc_freq", seq);
+        // filter2 depends on osc1 through an audio modulator
+        modulate(filter[2], "_filter_freq", osc[1], "_audio_0");
+
+        // modulators are resolved on insertion
+        auto scene = ObjectFactory::createSceneObject();
+        scene->addObjects(scene, objects);
+
+        auto con = scene->audioConnections();
+        for (int i=0; i<3; ++i)
+            con->connect(osc[i + 2], filter[i]);
+        for (int i=0; i<3; ++i)
+            con->connect(filter[i], out, 0, i % 2);
+        con->connect(osc[5], out, 0, 1);
+        con->connect(osc[0], out, 0, 0);
+
+        return scene;
+    }
+
+    /** Renders @p numBlocks with the given number of threads
+        and returns all output samples */
+    std::vector<F32> render(uint numThreads, uint numBlocks)
+    {
+        const AUDIO::Configuration conf(44100, 128, 0, 2);
+
+        auto scene = createScene();
+
+        ObjectDspPath path;
+        path.setNumberDspThreads(numThreads);
+        path.createPath(scene, conf, MO_AUDIO_THREAD);
+        path.preparePath();
+
+        std::vector<F32> result;
+        for (uint b=0; b<numBlocks; ++b)
+        {
+            const SamplePos pos = b * conf.bufferSize();
+            path.calcTransformations(pos);
+            path.calcAudio(pos);
+            for (auto buf : path.audioOutputs())
+                for (uint i=0; i<conf.bufferSize(); ++i)
+                    result.push_back(buf ? buf->read(i) : 0.f);
+        }
+
+        path.sendCloseThread();
+        scene->releaseRef("TestDspPath");
+        return result;
+    }
+
+} // namespace
+
+
+int TestDspPath::run()
+{
+    const uint numBlocks = 64;
+    const auto serial = render(1, numBlocks);
+
+    int errors = 0;
+    for (uint threads : { 2, 4, 8 })
+    {
+        const auto parallel = render(threads, numBlocks);
+        if (parallel.size() != serial.size())
+        {
+            MO_PRINT("FAILED: " << threads << " threads produced "
+                     << parallel.size() << " samples instead of " << serial.size());
+            ++errors;
+            continue;
+        }
+        for (size_t i=0; i<serial.size(); ++i)
+            if (parallel[i] != serial[i])
+            {
+                MO_PRINT("FAILED: " << threads << " threads differ at sample " << i
+                         << ": " << parallel[i] << " instead of " << serial[i]);
+                ++errors;
+                break;
+            }
+    }
+    return errors;
+}
+
+} // namespace MO
@@ -0,0 +1,26 @@
+/** @file testdsppath.h
+
+    @brief Compares parallel and serial processing of ObjectDspPath
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTDSPPATH_H
+#define MOSRC_TESTS_TESTDSPPATH_H
+
+namespace MO {
+
+class TestDspPath
+{
+public:
+    TestDspPath() { }
+
+    int run();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTDSPPATH_H
@@ -8,13 +8,17 @@
     <p>created 09.09.2014</p>
 */
 
+#include <cstdlib>
 #include <iostream>
+#include <vector>
+#include <cmath>
 
 #include <QString>
 
 #include "TestEquation.h"
 #include "math/funcparser/parser.h"
 #include "math/constants.h"
+#include "io/time.h"
 
 namespace MO {
 
@@ -24,7 +28,7 @@ TestEquation::TestEquation()
 
 int TestEquation::run()
 {
-    return compareTests_();
+    return compareTests_() + batchTests_();
 }
 
 int TestEquation::compareTests_()
@@ -115,4 +119,147 @@ int TestEquation::compareTests_()
     return errors;
 }
 
+namespace {
+
+    const char * batchEquations[] =
+    {
+        "x*x + y*y",
+        "x = x + sin(y*3) * 0.5; y = y * 2 + x; mix(x, y, 0.3)",
+        "a = x + 1; b = a * 2; a + b + noise(x)",
+        "x = floor(x*3)/3 + mag(x,y) + clamp(x, 0, 1) + pow(abs(y), 1.5)",
+        "frac(x*7) + (x < y) + (x >= y) * mod(y, 0.3) - sqrt(abs(x)) / exp(y)",
+        "x > y ? x : y",
+        "foo(a) { a*a }; foo(x) + y",
+        "x * rnd() + y * rnd()",
+        0
+    };
+
+    void fillBatchInput(std::vector<PPP_NAMESPACE::Float>& xs,
+                        std::vector<PPP_NAMESPACE::Float>& ys)
+    {
+        for (size_t i=0; i<xs.size(); ++i)
+        {
+            xs[i] = std::sin(i * 0.1);
+            ys[i] = std::cos(i * 0.37);
+        }
+    }
+
+} // namespace
+
+int TestEquation::batchTests_()
+{
+    using namespace PPP_NAMESPACE;
+
+    int errors = 0;
+    // not a multiple of the chunk size
+    const size_t num = 10000 + 17;
+
+    for (const char ** equ = batchEquations; *equ; ++equ)
+    {
+        Float x = 0, y = 0;
+        Parser p;
+        p.variables().add("x", &x, "");
+        p.variables().add("y", &y, "");
+        if (!p.parse(*equ))
+        {
+            std::cout << *equ << "\n[parsing failed]\n\n";
+            ++errors;
+            continue;
+        }
+
+        std::vector<Float> xs(num), ys(num), xb, yb,
+                resScalar(num), resBatch(num);
+        fillBatchInput(xs, ys);
+        xb = xs;
+        yb = ys;
+
+        // same random sequence for both runs
+        std::srand(23);
+        for (size_t i=0; i<num; ++i)
+        {
+            x = xs[i];
+            y = ys[i];
+            resScalar[i] = p.eval();
+            xs[i] = x;
+            ys[i] = y;
+        }
+
+        p.setBatchVariable("x", &xb[0]);
+        p.setBatchVariable("y", &yb[0]);
+        std::srand(23);
+        p.evalBatch(&resBatch[0], num);
+
+        // the bytecode runs the same operations as eval(),
+        // so the results must be bit-identical
+        size_t numDiff = 0;
+        for (size_t i=0; i<num; ++i)
+            if (resScalar[i] != resBatch[i]
+                || xs[i] != xb[i] || ys[i] != yb[i])
+            {
+                if (!numDiff)
+                    std::cout << *equ << "\n[set " << i << " differs: "
+                              << resScalar[i] << " / " << resBatch[i] << "]\n";
+                ++numDiff;
+            }
+
+        if (numDiff)
+        {
+            std::cout << "[" << numDiff << " of " << num << " sets differ"
+                      << (p.isBatchCompiled() ? "" : ", scalar fallback")
+                      << "]\n\n";
+            ++errors;
+        }
+    }
+
+    if (errors)
+        std::cout << errors << " batch tests failed\n";
+    else
+        std::cout << "batch evaluation matches eval()\n";
+
+    return errors;
+}
+
+void TestEquation::benchmarkBatch()
+{
+    using namespace PPP_NAMESPACE;
+
+    const size_t num = 1000000;
+
+    for (const char ** equ = batchEquations; *equ; ++equ)
+    {
+        Float x = 0, y = 0;
+        Parser p;
+        p.variables().add("x", &x, "");
+        p.variables().add("y", &y, "");
+        if (!p.parse(*equ))
+            continue;
+
+        std::vector<Float> xs(num), ys(num), xb, yb, res(num);
+        fillBatchInput(xs, ys);
+        xb = xs;
+        yb = ys;
+
+        TimeMessure tm;
+        for (size_t i=0; i<num; ++i)
+        {
+            x = xs[i];
+            y = ys[i];
+            res[i] = p.eval();
+        }
+        const double timeScalar = tm.time();
+
+        p.setBatchVariable("x", &xb[0]);
+        p.setBatchVariable("y", &yb[0]);
+        tm.start();
+        p.evalBatch(&res[0], num);
+        const double timeBatch = tm.time();
+
+        std::cout << *equ << "\n"
+                  << (p.isBatchCompiled() ? "[bytecode]" : "[scalar fallback]")
+                  << " eval: " << timeScalar << "s, evalBatch: " << timeBatch
+                  << "s, speedup " << (timeScalar / std::max(1e-9, timeBatch))
+                  << "\n" << std::endl;
+    }
+}
+
 } // namespace MO
@@ -20,9 +20,13 @@ public:
 
     int run();
 
+    /** Prints the speed of Parser::evalBatch() compared to Parser::eval() */
+    static void benchmarkBatch();
+
 private:
 
     int compareTests_();
+    int batchTests_();
 };
 
 } // namespace MO
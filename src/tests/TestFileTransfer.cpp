@@ -0,0 +1,370 @@
+/** @file testfiletransfer.cpp
+
+    @brief Tests the chunked file transfer helpers
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <random>
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+
+#include "TestFileTransfer.h"
+#include "network/FileManifest.h"
+#include "network/FileServer.h"
+#include "network/FileTransfer.h"
+#include "io/DataStream.h"
+#include "io/error.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    QByteArray randomData(int size, unsigned seed)
+    {
+        std::mt19937 rnd(seed);
+        QByteArray a(size, 0);
+        for (int i=0; i<size; ++i)
+            a[i] = char(rnd() & 0xff);
+        return a;
+    }
+
+    QString listString(const QList<int>& l)
+    {
+        QString s;
+        for (auto i : l)
+            s += QString::number(i) + " ";
+        return s;
+    }
+
+} // namespace
+
+
+TestFileTransfer::TestFileTransfer()
+    : path_         (QDir::tempPath() + QDir::separator() + "mo-test-filetransfer-")
+    , chunkSize_    (1000)
+{
+}
+
+int TestFileTransfer::run()
+{
+    int errors = 0;
+    try
+    {
+        errors += testManifest_();
+        errors += testProtocol_();
+        errors += testServerManifest_();
+        errors += testDownload_();
+        errors += testResume_();
+        errors += testDedup_();
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("EXCEPTION: " << e.what());
+        ++errors;
+    }
+    if (errors)
+        MO_PRINT(errors << " file transfer errors");
+    return errors;
+}
+
+QString TestFileTransfer::writeFile_(const QString &name, const QByteArray &data)
+{
+    const QString fn = path_ + name;
+    QFile f(fn);
+    if (!f.open(QFile::WriteOnly))
+        MO_IO_ERROR(WRITE, "Could not create '" << fn << "'");
+    f.write(data);
+    return fn;
+}
+
+QByteArray TestFileTransfer::readFile_(const QString &fn)
+{
+    QFile f(fn);
+    if (!f.open(QFile::ReadOnly))
+        MO_IO_ERROR(READ, "Could not open '" << fn << "'");
+    return f.readAll();
+}
+
+void TestFileTransfer::receiveChunks_(const FileManifest &m, const QByteArray &data,
+                                      const QString &partFilename,
+                                      const QList<int> &chunks)
+{
+    QFile f(partFilename);
+    if (!f.open(QFile::ReadWrite))
+        MO_IO_ERROR(WRITE, "Could not open '" << partFilename << "'");
+    for (auto i : chunks)
+    {
+        f.seek(m.chunkOffset(i));
+        f.write(data.mid(m.chunkOffset(i), m.chunkBytes(i)));
+    }
+}
+
+int TestFileTransfer::testManifest_()
+{
+    int errors = 0;
+
+    const QByteArray data = randomData(chunkSize_ * 3 + chunkSize_ / 2, 1);
+    const QString fn = writeFile_("manifest", data);
+
+    FileManifest m;
+    if (!m.create(fn, chunkSize_))
+    {
+        MO_PRINT("COULD NOT create manifest");
+        return 1;
+    }
+
+    if (m.size() != data.size() || m.numChunks() != 4
+        || m.chunkBytes(3) != chunkSize_ / 2
+        || m.hash() != FileManifest::hashData(data)
+        || m.chunkHash(1) != FileManifest::hashData(data.mid(chunkSize_, chunkSize_))
+        || m.findChunk(m.chunkHash(2)) != 2)
+    {
+        MO_PRINT("MISMATCH in manifest, size " << m.size() << ", chunks "
+                 << m.numChunks() << ", last chunk " << m.chunkBytes(3));
+        ++errors;
+    }
+
+    QByteArray buf;
+    {
+        IO::DataStream io(&buf, QIODevice::WriteOnly);
+        m.serialize(io);
+    }
+    FileManifest m2;
+    IO::DataStream io(buf);
+    m2.deserialize(io);
+    if (m2 != m || m2.numChunks() != m.numChunks() || m2.chunkSize() != m.chunkSize()
+        || m2.chunkHash(3) != m.chunkHash(3))
+    {
+        MO_PRINT("MISMATCH in serialized manifest");
+        ++errors;
+    }
+
+    // empty files are valid too
+    const QString efn = writeFile_("empty", QByteArray());
+    if (!m.create(efn, chunkSize_) || !m.isValid() || m.numChunks() != 0)
+    {
+        MO_PRINT("MISMATCH in manifest of empty file");
+        ++errors;
+    }
+
+    QFile::remove(fn);
+    QFile::remove(efn);
+    return errors;
+}
+
+int TestFileTransfer::testProtocol_()
+{
+    int errors = 0;
+
+    const QByteArray hash = FileManifest::hashData("hello");
+
+    QByteArray req = FileServer::createRequest(hash, 7, 3);
+    QByteArray h;
+    quint32 a = 0, b = 0;
+    if (req.size() != FileServer::requestSize
+        || !FileServer::parseRequest(req.constData(), h, a, b)
+        || h != hash || a != 7 || b != 3)
+    {
+        MO_PRINT("MISMATCH in chunk request");
+        ++errors;
+    }
+
+    QByteArray head = FileServer::createChunkHeader(hash, 123456, FileServer::unavailable);
+    if (head.size() != FileServer::chunkHeaderSize
+        || !FileServer::parseChunkHeader(head.constData(), h, a, b)
+        || h != hash || a != 123456 || b != FileServer::unavailable)
+    {
+        MO_PRINT("MISMATCH in chunk header");
+        ++errors;
+    }
+
+    if (FileServer::parseChunkHeader(req.constData(), h, a, b))
+    {
+        MO_PRINT("ACCEPTED request as chunk header");
+        ++errors;
+    }
+
+    return errors;
+}
+
+int TestFileTransfer::testServerManifest_()
+{
+    int errors = 0;
+
+    const QByteArray data = randomData(FileManifest::defaultChunkSize * 3 + 5, 7);
+    const QString fn = writeFile_("served", data);
+
+    FileServer server;
+
+    // hashed in the background
+    FileManifest m = server.manifest(fn);
+    if (m.isValid() || !server.isHashing(fn))
+    {
+        MO_PRINT("EXPECTED '" << fn << "' to be hashed on the thread");
+        ++errors;
+    }
+
+    for (int i = 0; i < 1000 && !m.isValid(); ++i)
+    {
+        QThread::msleep(10);
+        m = server.manifest(fn);
+    }
+
+    if (m.hash() != FileManifest::hashData(data) || server.isHashing(fn))
+    {
+        MO_PRINT("MISMATCH in manifest of FileServer");
+        ++errors;
+    }
+
+    if (server.manifest(path_ + "missing").isValid()
+        || server.isHashing(path_ + "missing"))
+    {
+        MO_PRINT("MANIFEST for missing file");
+        ++errors;
+    }
+
+    QFile::remove(fn);
+    return errors;
+}
+
+int TestFileTransfer::testDownload_()
+{
+    int errors = 0;
+
+    const QByteArray data = randomData(chunkSize_ * 5 + 17, 2);
+    const QString src = writeFile_("source", data),
+                  dst = path_ + "download",
+                  part = FileTransfer::partFilename(dst);
+    QFile::remove(dst);
+    QFile::remove(part);
+
+    FileManifest m;
+    m.create(src, chunkSize_);
+
+    QList<int> missing;
+    qint64 reused = -1;
+    if (!FileTransfer::prepareFile(m, part, QString(), missing, &reused))
+    {
+        MO_PRINT("COULD NOT prepare '" << part << "'");
+        return 1;
+    }
+    if (missing.size() != m.numChunks() || reused != 0)
+    {
+        MO_PRINT("EXPECTED all chunks missing, got " << listString(missing)
+                 << ", reused " << reused);
+        ++errors;
+    }
+
+    // a corrupt file is not accepted
+    receiveChunks_(m, randomData(data.size(), 3), part, missing);
+    if (FileTransfer::finishFile(m, part, dst) || QFile::exists(dst))
+    {
+        MO_PRINT("ACCEPTED corrupt file");
+        ++errors;
+    }
+
+    FileTransfer::prepareFile(m, part, QString(), missing, &reused);
+    receiveChunks_(m, data, part, missing);
+    if (!FileTransfer::finishFile(m, part, dst) || readFile_(dst) != data
+        || QFile::exists(part))
+    {
+        MO_PRINT("MISMATCH in downloaded file");
+        ++errors;
+    }
+
+    QFile::remove(src);
+    QFile::remove(dst);
+    return errors;
+}
+
+int TestFileTransfer::testResume_()
+{
+    int errors = 0;
+
+    const QByteArray data = randomData(chunkSize_ * 8, 4);
+    const QString src = writeFile_("source", data),
+                  dst = path_ + "resume",
+                  part = FileTransfer::partFilename(dst);
+    QFile::remove(dst);
+
+    FileManifest m;
+    m.create(src, chunkSize_);
+
+    // interrupted after three chunks and half of the fourth
+    writeFile_("resume.part", data.left(chunkSize_ * 3 + chunkSize_ / 2));
+
+    QList<int> missing;
+    qint64 reused = 0;
+    FileTransfer::prepareFile(m, part, QString(), missing, &reused);
+    if (missing != (QList<int>() << 3 << 4 << 5 << 6 << 7)
+        || reused != chunkSize_ * 3)
+    {
+        MO_PRINT("EXPECTED chunks 3-7 missing, got " << listString(missing)
+                 << ", reused " << reused);
+        ++errors;
+    }
+
+    receiveChunks_(m, data, part, missing);
+    if (!FileTransfer::finishFile(m, part, dst) || readFile_(dst) != data)
+    {
+        MO_PRINT("MISMATCH in resumed file");
+        ++errors;
+    }
+
+    QFile::remove(src);
+    QFile::remove(dst);
+    return errors;
+}
+
+int TestFileTransfer::testDedup_()
+{
+    int errors = 0;
+
+    const QByteArray prevData = randomData(chunkSize_ * 10, 5);
+    QByteArray data = prevData;
+    // change one chunk, swap two and append some
+    data.replace(chunkSize_ * 2 + 10, 5, "xxxxx");
+    data.replace(chunkSize_ * 5, chunkSize_, prevData.mid(chunkSize_ * 7, chunkSize_));
+    data.replace(chunkSize_ * 7, chunkSize_, prevData.mid(chunkSize_ * 5, chunkSize_));
+    data.append(randomData(chunkSize_ + 100, 6));
+
+    const QString src = writeFile_("source", data),
+                  dst = writeFile_("dedup", prevData),
+                  part = FileTransfer::partFilename(dst);
+    QFile::remove(part);
+
+    FileManifest m;
+    m.create(src, chunkSize_);
+
+    QList<int> missing;
+    qint64 reused = 0;
+    FileTransfer::prepareFile(m, part, dst, missing, &reused);
+    if (missing != (QList<int>() << 2 << 10 << 11)
+        || reused != chunkSize_ * 9)
+    {
+        MO_PRINT("EXPECTED chunks 2, 10, 11 missing, got " << listString(missing)
+                 << ", reused " << reused);
+        ++errors;
+    }
+
+    receiveChunks_(m, data, part, missing);
+    if (!FileTransfer::finishFile(m, part, dst) || readFile_(dst) != data)
+    {
+        MO_PRINT("MISMATCH in deduplicated file");
+        ++errors;
+    }
+
+    QFile::remove(src);
+    QFile::remove(dst);
+    return errors;
+}
+
+
+} // namespace MO
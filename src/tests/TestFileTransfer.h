@@ -0,0 +1,54 @@
+/** @file testfiletransfer.h
+
+    @brief Tests the chunked file transfer helpers
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTFILETRANSFER_H
+#define MOSRC_TESTS_TESTFILETRANSFER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+
+namespace MO {
+
+class FileManifest;
+
+/** Checks manifests, the chunk protocol, hashing in the FileServer,
+    resume of part files and reuse of chunks from a previous version,
+    without sockets. */
+class TestFileTransfer
+{
+public:
+    TestFileTransfer();
+
+    int run();
+
+private:
+
+    /** Writes @p data to a file in the temp directory, returns the filename */
+    QString writeFile_(const QString& name, const QByteArray& data);
+    QByteArray readFile_(const QString& filename);
+    /** Writes the chunks of @p data into the part file like a transfer */
+    void receiveChunks_(const FileManifest& m, const QByteArray& data,
+                        const QString& partFilename, const QList<int>& chunks);
+
+    int testManifest_();
+    int testProtocol_();
+    int testServerManifest_();
+    int testDownload_();
+    int testResume_();
+    int testDedup_();
+
+    QString path_;
+    int chunkSize_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTFILETRANSFER_H
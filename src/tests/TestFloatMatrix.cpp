@@ -26,6 +26,9 @@ struct TestFloatMatrix::Private
 
     bool testMapping2();
     bool testMapping3();
+    bool testCopyOnWrite();
+    bool testViews();
+    bool testSameData();
 
     TestFloatMatrix* p;
 };
@@ -43,9 +46,17 @@ TestFloatMatrix::~TestFloatMatrix()
 
 int TestFloatMatrix::run()
 {
-    p_->testMapping2();
-    p_->testMapping3();
-    return 0;
+    int errors = 0;
+    errors += !p_->testMapping2();
+    errors += !p_->testMapping3();
+    errors += !p_->testCopyOnWrite();
+    errors += !p_->testViews();
+    errors += !p_->testSameData();
+
+    if (errors)
+        MO_PRINT(errors << " float matrix tests failed");
+
+    return errors;
 }
 
 #define ASSERT(cond_) \
@@ -97,4 +108,105 @@ bool TestFloatMatrix::Private::testMapping3()
     return true;
 }
 
+bool TestFloatMatrix::Private::testCopyOnWrite()
+{
+    FloatMatrix a({4});
+    for (size_t i=0; i<a.size(); ++i)
+        a(i) = i;
+    ASSERT(a.useCount() == 1);
+
+    FloatMatrix b = a;
+    ASSERT(a.useCount() == 2);
+    ASSERT(b.isSameData(a));
+
+    // write to the original detaches it, the copy keeps the values
+    a(1) = 10.;
+    ASSERT(a.useCount() == 1);
+    ASSERT(b.useCount() == 1);
+    ASSERT(!b.isSameData(a));
+    const FloatMatrix& cb = b;
+    ASSERT(cb(1) == 1.);
+    ASSERT(cb(2) == 2.);
+
+    // once detached, writes don't copy again
+    const Double* ptr = a.data();
+    a(2) = 20.;
+    ASSERT(a.data() == ptr);
+
+    // write to the copy
+    FloatMatrix c = b;
+    c(0) = 5.;
+    ASSERT(cb(0) == 0.);
+
+    return true;
+}
+
+bool TestFloatMatrix::Private::testViews()
+{
+    FloatMatrix m({3,2});
+    for (size_t i=0; i<m.size(); ++i)
+        m(i) = i;
+    const FloatMatrix& cm = m;
+
+    FloatMatrix s = m.slice(1);
+    ASSERT(s.numDimensions() == 1);
+    ASSERT(s.size() == 2);
+    ASSERT(m.useCount() == 2);
+    const FloatMatrix& cs = s;
+    ASSERT(cs(0) == 2.);
+    ASSERT(cs(1) == 3.);
+
+    FloatMatrix r = m.subRange(1, 2);
+    ASSERT(r.numDimensions() == 2);
+    ASSERT(r.size(0) == 2);
+    ASSERT(m.useCount() == 3);
+    const FloatMatrix& cr = r;
+    ASSERT(cr(0, 0) == 2.);
+    ASSERT(cr(1, 1) == 5.);
+
+    // write to a view detaches only the view
+    s(0) = 100.;
+    ASSERT(s.useCount() == 1);
+    ASSERT(m.useCount() == 2);
+    ASSERT(cm(1, 0) == 2.);
+    ASSERT(cr(0, 0) == 2.);
+
+    // write to the source leaves the view unchanged
+    m(2, 1) = 50.;
+    ASSERT(cm(2, 1) == 50.);
+    ASSERT(cr(1, 1) == 5.);
+
+    return true;
+}
+
+bool TestFloatMatrix::Private::testSameData()
+{
+    FloatMatrix a({2,2});
+    for (size_t i=0; i<a.size(); ++i)
+        a(i) = i;
+
+    FloatMatrix b = a;
+    ASSERT(a.isSameData(b));
+    ASSERT(a == b);
+
+    // same storage but different range or layout
+    ASSERT(!a.isSameData(a.slice(0)));
+    ASSERT(!a.slice(0).isSameData(a.slice(1)));
+    ASSERT(a.slice(1).isSameData(a.slice(1)));
+    ASSERT(!a.isSameData(a.subRange(0, 1)));
+
+    // equal values in separate storage
+    FloatMatrix c = a;
+    c.detach();
+    ASSERT(!a.isSameData(c));
+    ASSERT(a == c);
+
+    // modified copy
+    b(0) = 7.;
+    ASSERT(!a.isSameData(b));
+    ASSERT(a != b);
+
+    return true;
+}
+
 } // namespace MO
@@ -0,0 +1,160 @@
+/** @file testfrustum.cpp
+
+    @brief Tests for MATH::Frustum
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <cmath>
+
+#include "TestFrustum.h"
+#include "math/Frustum.h"
+#include "math/vector.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    /** 90 degree field of view, looking down negative z */
+    Mat4 testProjection()
+    {
+        return MATH::perspective(90.f, 1.f, 0.1f, 100.f);
+    }
+
+    int expectBox(const MATH::Frustum& f, const Vec3& center, Float size,
+                  bool expected, const char * name)
+    {
+        const Vec3 e(size * Float(0.5));
+        if (f.intersectsBox(center - e, center + e) == expected)
+            return 0;
+        MO_PRINT("FAILED box '" << name << "' at " << center
+                 << ", expected " << (expected ? "inside" : "outside"));
+        return 1;
+    }
+
+    int expectSphere(const MATH::Frustum& f, const Vec3& center, Float radius,
+                     bool expected, const char * name)
+    {
+        if (f.intersectsSphere(center, radius) == expected)
+            return 0;
+        MO_PRINT("FAILED sphere '" << name << "' at " << center
+                 << ", expected " << (expected ? "inside" : "outside"));
+        return 1;
+    }
+
+    bool equal(const Vec3& a, const Vec3& b)
+    {
+        return glm::length(a - b) < 0.0001;
+    }
+
+    int testPerspective()
+    {
+        int errors = 0;
+
+        MATH::Frustum f(testProjection());
+
+        errors += expectBox(f, Vec3(0, 0, -5),   1, true,  "center");
+        errors += expectBox(f, Vec3(0, 0, 5),    1, false, "behind");
+        errors += expectBox(f, Vec3(20, 0, -5),  1, false, "right");
+        errors += expectBox(f, Vec3(0, -20, -5), 1, false, "below");
+        errors += expectBox(f, Vec3(0, 0, -200), 1, false, "beyond far");
+        errors += expectBox(f, Vec3(-5, 0, -5),  1, true,  "on left plane");
+        errors += expectBox(f, Vec3(0, 0, 0),  100, true,  "containing frustum");
+
+        // distance to right plane is sqrt(2)
+        errors += expectSphere(f, Vec3(7, 0, -5), 1, false, "right");
+        errors += expectSphere(f, Vec3(7, 0, -5), 2, true,  "touching right");
+        errors += expectSphere(f, Vec3(0, 0, -50), 1, true, "far center");
+
+        if (!f.contains(Vec3(0, 0, -1)) || f.contains(Vec3(0, 0, 1)))
+        {
+            MO_PRINT("FAILED point containment");
+            ++errors;
+        }
+
+        // default frustum accepts everything
+        MATH::Frustum all;
+        errors += expectBox(all, Vec3(1000, 0, 1000), 1, true, "default");
+
+        return errors;
+    }
+
+    int testView()
+    {
+        int errors = 0;
+
+        // camera at z=10
+        Mat4 view = glm::inverse(glm::translate(Mat4(1.), Vec3(0, 0, 10)));
+        MATH::Frustum f(testProjection() * view);
+
+        errors += expectBox(f, Vec3(0, 0, 0),  1, true,  "moved camera origin");
+        errors += expectBox(f, Vec3(0, 0, 20), 1, false, "moved camera behind");
+
+        // camera turned around, looking down positive z
+        view = glm::inverse(MATH::rotate(Mat4(1.), Float(180), Vec3(0, 1, 0)));
+        f.set(testProjection() * view);
+
+        errors += expectBox(f, Vec3(0, 0, 5),  1, true,  "turned front");
+        errors += expectBox(f, Vec3(0, 0, -5), 1, false, "turned behind");
+
+        // side face of a cube map
+        view = glm::inverse(MATH::rotate(Mat4(1.), Float(-90), Vec3(0, 1, 0)));
+        f.set(testProjection() * view);
+
+        errors += expectBox(f, Vec3(5, 0, 0),  1, true,  "cube side");
+        errors += expectBox(f, Vec3(0, 0, -5), 1, false, "cube side front");
+
+        return errors;
+    }
+
+    int testTransformBox()
+    {
+        int errors = 0;
+
+        Vec3 mi, ma;
+
+        // translation only
+        MATH::transform_box(glm::translate(Mat4(1.), Vec3(3, 0, 0)),
+                            Vec3(-1), Vec3(1), &mi, &ma);
+        if (!equal(mi, Vec3(2, -1, -1)) || !equal(ma, Vec3(4, 1, 1)))
+        {
+            MO_PRINT("FAILED translated box " << mi << " - " << ma);
+            ++errors;
+        }
+
+        // scaled and rotated by 45 degree around y
+        const Mat4 m = glm::scale(
+                    MATH::rotate(Mat4(1.), Float(45), Vec3(0, 1, 0)),
+                    Vec3(2, 1, 1));
+        MATH::transform_box(m, Vec3(-1), Vec3(1), &mi, &ma);
+        const Float e = 3.f / std::sqrt(2.f);
+        if (!equal(mi, Vec3(-e, -1, -e)) || !equal(ma, Vec3(e, 1, e)))
+        {
+            MO_PRINT("FAILED rotated box " << mi << " - " << ma);
+            ++errors;
+        }
+
+        return errors;
+    }
+
+} // namespace
+
+
+int TestFrustum::run()
+{
+    int errors =
+            + testPerspective()
+            + testView()
+            + testTransformBox()
+            ;
+
+    if (errors)
+        MO_PRINT(errors << " frustum tests failed");
+    return errors;
+}
+
+} // namespace MO
@@ -0,0 +1,28 @@
+/** @file testfrustum.h
+
+    @brief Tests for MATH::Frustum
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTFRUSTUM_H
+#define MOSRC_TESTS_TESTFRUSTUM_H
+
+namespace MO {
+
+/** Checks the frustum plane extraction and the
+    box and sphere tests against known configurations */
+class TestFrustum
+{
+public:
+    TestFrustum() { }
+
+    int run();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTFRUSTUM_H
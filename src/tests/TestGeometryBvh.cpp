@@ -0,0 +1,206 @@
+/** @file testgeometrybvh.cpp
+
+    @brief Tests and benchmarks Geometry ray queries
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <random>
+#include <vector>
+
+#include "TestGeometryBvh.h"
+#include "geom/Geometry.h"
+#include "geom/GeometryFactory.h"
+#include "io/time.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    /** Sphere plus random triangles and an axis-aligned quad */
+    GEOM::Geometry * createTestGeometry(uint seg, uint numRandom)
+    {
+        auto g = new GEOM::Geometry();
+        GEOM::GeometryFactory::createUVSphere(g, 1.f, seg, seg);
+
+        std::mt19937 rnd(1);
+        std::uniform_real_distribution<Float> u(-2, 2);
+        for (uint i=0; i<numRandom; ++i)
+        {
+            const Vec3 p1(u(rnd), u(rnd), u(rnd)),
+                       p2(u(rnd), u(rnd), u(rnd)),
+                       p3(u(rnd), u(rnd), u(rnd));
+            g->addTriangle(p1, p2, p3);
+        }
+
+        GEOM::GeometryFactory::createQuad(g, 6.f, 6.f);
+        return g;
+    }
+
+    void createRays(std::vector<Vec3>& ro, std::vector<Vec3>& rd, size_t num)
+    {
+        std::mt19937 rnd(2);
+        std::uniform_real_distribution<Float> u(-1, 1);
+        for (size_t i=0; i<num; ++i)
+        {
+            ro.push_back(Vec3(u(rnd), u(rnd), u(rnd)) * 4.f);
+            // include axis-aligned directions
+            if (i % 7 == 0)
+                rd.push_back(Vec3(0, 0, -1));
+            else
+                rd.push_back(Vec3(u(rnd), u(rnd), u(rnd)));
+        }
+    }
+
+} // namespace
+
+
+struct TestGeometryBvh::Private
+{
+    Private()
+        : g     (createTestGeometry(100, 1000))
+    {
+        createRays(ro, rd, 2000);
+    }
+
+    ~Private()
+    {
+        g->releaseRef("TestGeometryBvh finish");
+    }
+
+    bool testSingleRays();
+    bool testBatch();
+    bool testInvalidation();
+
+    GEOM::Geometry * g;
+    std::vector<Vec3> ro, rd;
+};
+
+TestGeometryBvh::TestGeometryBvh()
+    : p_        (new Private())
+{
+}
+
+TestGeometryBvh::~TestGeometryBvh()
+{
+    delete p_;
+}
+
+int TestGeometryBvh::run()
+{
+    int errors = 0;
+    errors += !p_->testSingleRays();
+    errors += !p_->testBatch();
+    // last, changes the geometry
+    errors += !p_->testInvalidation();
+
+    if (errors)
+        MO_PRINT(errors << " geometry bvh tests failed");
+
+    return errors;
+}
+
+bool TestGeometryBvh::Private::testSingleRays()
+{
+    bool ok = true;
+    for (size_t i=0; i<ro.size(); ++i)
+    {
+        Vec3 p1, p2;
+        GEOM::Geometry::IndexType t1 = 0, t2 = 0;
+        const bool
+            h1 = g->intersects_linear(ro[i], rd[i], &p1, &t1),
+            h2 = g->intersects(ro[i], rd[i], &p2, &t2),
+            h3 = g->intersects_any(ro[i], rd[i]);
+
+        if (h1 != h2 || h1 != h3 || (h1 && (t1 != t2 || p1 != p2)))
+        {
+            MO_PRINT("MISMATCH ray " << i << " " << ro[i] << " " << rd[i]
+                     << "\nlinear: " << h1 << " " << t1 << " " << p1
+                     << "\nbvh:    " << h2 << " " << t2 << " " << p2
+                     << "\nany:    " << h3);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool TestGeometryBvh::Private::testBatch()
+{
+    bool ok = true;
+    std::vector<GEOM::Geometry::IndexType> tris(ro.size());
+    bool * hits = new bool[ro.size()];
+    g->intersects_many(ro.size(), &ro[0], &rd[0], hits, nullptr, &tris[0]);
+    for (size_t i=0; i<ro.size(); ++i)
+    {
+        GEOM::Geometry::IndexType t1 = 0;
+        const bool h1 = g->intersects(ro[i], rd[i], nullptr, &t1);
+        if (h1 != hits[i] || (h1 && t1 != tris[i]))
+        {
+            MO_PRINT("MISMATCH batch ray " << i);
+            ok = false;
+        }
+    }
+    delete [] hits;
+    return ok;
+}
+
+bool TestGeometryBvh::Private::testInvalidation()
+{
+    // build the tree, then add triangles outside of it
+    Vec3 p;
+    g->intersects(ro[0], rd[0], &p);
+    GEOM::GeometryFactory::createQuad(g, 10.f, 10.f);
+
+    if (g->intersects(Vec3(4.5, 4.5, 1), Vec3(0, 0, -1), &p)
+            != g->intersects_linear(Vec3(4.5, 4.5, 1), Vec3(0, 0, -1), &p))
+    {
+        MO_PRINT("MISMATCH after change");
+        return false;
+    }
+    return true;
+}
+
+void TestGeometryBvh::benchmark()
+{
+    auto g = createTestGeometry(500, 10000);
+    MO_PRINT(g->infoString());
+
+    std::vector<Vec3> ro, rd;
+    createRays(ro, rd, 10000);
+    const size_t numLinear = 100;
+
+    TimeMessure tm;
+    Vec3 p;
+    for (size_t i=0; i<numLinear; ++i)
+        g->intersects_linear(ro[i], rd[i], &p);
+    const double linear = tm.time() / numLinear;
+
+    tm.start();
+    g->intersects(ro[0], rd[0], &p);
+    const double build = tm.time();
+
+    tm.start();
+    for (size_t i=0; i<ro.size(); ++i)
+        g->intersects(ro[i], rd[i], &p);
+    const double bvh = tm.time() / ro.size();
+
+    bool * hits = new bool[ro.size()];
+    tm.start();
+    g->intersects_many(ro.size(), &ro[0], &rd[0], hits, nullptr);
+    const double batch = tm.time() / ro.size();
+    delete [] hits;
+
+    MO_PRINT("per ray: linear " << linear * 1000. << "ms"
+             << ", bvh " << bvh * 1000. << "ms (" << linear / bvh << "x)"
+             << ", threaded " << batch * 1000. << "ms (" << linear / batch << "x)"
+             << "\nbvh build " << build * 1000. << "ms");
+
+    g->releaseRef("TestGeometryBvh benchmark");
+}
+
+
+} // namespace MO
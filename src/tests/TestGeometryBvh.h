@@ -0,0 +1,36 @@
+/** @file testgeometrybvh.h
+
+    @brief Tests and benchmarks Geometry ray queries
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTGEOMETRYBVH_H
+#define MOSRC_TESTS_TESTGEOMETRYBVH_H
+
+namespace MO {
+
+/** Compares Geometry::intersects() with the linear search */
+class TestGeometryBvh
+{
+public:
+    TestGeometryBvh();
+    ~TestGeometryBvh();
+
+    int run();
+
+    /** Prints the speed of the bvh and the threaded batch query
+        compared to the linear search */
+    static void benchmark();
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTGEOMETRYBVH_H
@@ -0,0 +1,344 @@
+/** @file testobjloader.cpp
+
+    @brief Tests and benchmarks the .obj parser and binary cache
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <random>
+#include <cstring>
+
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+
+#include "TestObjLoader.h"
+#include "geom/ObjLoader.h"
+#include "geom/Geometry.h"
+#include "io/error.h"
+#include "io/time.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    /** Returns true if both geometries are equal */
+    bool compare(const GEOM::Geometry* a, const GEOM::Geometry* b)
+    {
+        if (a->numVertices() != b->numVertices()
+         || a->numTriangles() != b->numTriangles()
+         || a->numLines() != b->numLines())
+            return false;
+        if (!a->numVertices())
+            return true;
+        return !memcmp(a->vertices(), b->vertices(), a->numVertexBytes())
+            && !memcmp(a->normals(), b->normals(), a->numNormalBytes())
+            && !memcmp(a->colors(), b->colors(), a->numColorBytes())
+            && !memcmp(a->textureCoords(), b->textureCoords(), a->numTextureCoordBytes())
+            && (!a->numTriangles() || !memcmp(a->triangleIndices(), b->triangleIndices(),
+                                              a->numTriangleIndexBytes()))
+            && (!a->numLines() || !memcmp(a->lineIndices(), b->lineIndices(),
+                                          a->numLineIndexBytes()));
+    }
+
+    /** Loads the file with current settings */
+    GEOM::Geometry * load(const QString& fn, bool * fromCache = 0)
+    {
+        GEOM::ObjLoader obj;
+        obj.loadFile(fn);
+        if (fromCache)
+            *fromCache = obj.isLoadedFromCache();
+        auto g = new GEOM::Geometry();
+        obj.getGeometry(g);
+        return g;
+    }
+
+} // namespace
+
+
+QString TestObjLoader::createObjFile_(const QString& name, size_t num)
+{
+    const QString path = QDir::tempPath() + QDir::separator() + name;
+
+    QFile mtl(path + ".mtl");
+    if (!mtl.open(QIODevice::WriteOnly))
+        MO_IO_ERROR(WRITE, "Could not create '" << mtl.fileName() << "'");
+    mtl.write("newmtl red\nKa 1 0 0\nnewmtl blue\nKa 0 0 1\nd 0.5\n");
+    mtl.close();
+
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        MO_IO_ERROR(WRITE, "Could not create '" << path << "'");
+    QTextStream s(&f);
+    s << "# generated by TestObjLoader\nmtllib " << name << ".mtl\n";
+
+    std::mt19937 rnd(23);
+    std::uniform_real_distribution<float> u(-1, 1);
+    size_t numV = 0, numT = 0, numN = 0;
+    for (size_t i=0; i<num; ++i)
+    {
+        const int r = rnd() % 100;
+        if (r < 30 || numV < 4)
+        {
+            s << "v " << u(rnd) << " " << u(rnd) << " " << u(rnd) << "\n";
+            ++numV;
+        }
+        else if (r < 40)
+        {
+            s << "vt " << u(rnd) << " " << u(rnd) << "\n";
+            ++numT;
+        }
+        else if (r < 50)
+        {
+            s << "vn\t" << u(rnd) << " " << u(rnd) << " " << u(rnd) << "\r\n";
+            ++numN;
+        }
+        else if (r < 52)
+            s << "usemtl " << (rnd() % 2 ? "red" : "blue") << "\n";
+        else
+        {
+            // line, triangle, quad or polygon, with some relative indices
+            const int k = 2 + rnd() % 5;
+            s << "f";
+            for (int j=0; j<k; ++j)
+            {
+                const bool rel = rnd() % 5 == 0;
+                const long
+                        v = rnd() % numV,
+                        t = numT ? long(rnd() % numT) : -1,
+                        n = numN ? long(rnd() % numN) : -1;
+                s << " " << (rel ? v - long(numV) : v + 1);
+                if (t >= 0)
+                    s << "/" << (rel ? t - long(numT) : t + 1);
+                if (n >= 0)
+                    s << (t >= 0 ? "/" : "//") << (rel ? n - long(numN) : n + 1);
+            }
+            s << "\n";
+        }
+    }
+
+    return path;
+}
+
+int TestObjLoader::run()
+{
+    int errors = 0;
+    GEOM::Geometry * ref = 0;
+    QString fn;
+    try
+    {
+        fn = createObjFile_("mo_testobjloader.obj", 400000);
+        QFile::remove(GEOM::ObjLoader::cacheFilename(fn));
+        GEOM::ObjLoader::setCacheMinimumSize(0);
+
+        // single thread reference
+        GEOM::ObjLoader::setCacheEnabled(false);
+        GEOM::ObjLoader::setNumberThreads(1);
+        ref = load(fn);
+
+        errors += threadTest_(fn, ref);
+        errors += cacheTest_(fn, ref);
+        errors += parseErrorTest_();
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("EXCEPTION: " << e.what());
+        ++errors;
+    }
+
+    if (ref)
+        ref->releaseRef("TestObjLoader");
+    if (!fn.isEmpty())
+    {
+        QFile::remove(fn);
+        QFile::remove(fn + ".mtl");
+        QFile::remove(GEOM::ObjLoader::cacheFilename(fn));
+    }
+
+    if (errors)
+        MO_PRINT(errors << " obj loader tests failed");
+    return errors;
+}
+
+int TestObjLoader::threadTest_(const QString& fn, const GEOM::Geometry* ref)
+{
+    GEOM::ObjLoader::setCacheEnabled(false);
+    GEOM::ObjLoader::setNumberThreads(7);
+
+    auto g = load(fn);
+    const bool ok = compare(ref, g);
+    g->releaseRef("TestObjLoader");
+
+    if (!ok)
+    {
+        MO_PRINT("MISMATCH multi-threaded parsing");
+        return 1;
+    }
+    return 0;
+}
+
+int TestObjLoader::cacheTest_(const QString& fn, const GEOM::Geometry* ref)
+{
+    int errors = 0;
+
+    // write and read cache
+    GEOM::ObjLoader::setNumberThreads(0);
+    GEOM::ObjLoader::setCacheEnabled(true);
+    for (int i=0; i<2; ++i)
+    {
+        bool cached;
+        auto g = load(fn, &cached);
+        if (cached != (i == 1) || !compare(ref, g))
+        {
+            MO_PRINT("MISMATCH with binary cache, pass " << i << ", cached " << cached);
+            ++errors;
+        }
+        g->releaseRef("TestObjLoader");
+    }
+
+    // corrupted cache is rejected
+    if (!corruptCacheTest_(fn, ref))
+        ++errors;
+
+    // file change invalidates cache
+    {
+        QFile f(fn);
+        f.open(QIODevice::Append);
+        f.write("f 1 2 3\n");
+    }
+    bool cached;
+    auto g = load(fn, &cached);
+    if (cached || g->numTriangles() != ref->numTriangles() + 1)
+    {
+        MO_PRINT("MISMATCH cache not invalidated");
+        ++errors;
+    }
+    g->releaseRef("TestObjLoader");
+
+    return errors;
+}
+
+int TestObjLoader::parseErrorTest_()
+{
+    int errors = 0;
+
+    GEOM::ObjLoader obj;
+    try
+    {
+        obj.loadFromMemory(QByteArray("v 1 2 3\nv 1 2 x\n"));
+        MO_PRINT("MISSING parse error");
+        ++errors;
+    }
+    catch (const IoException&) { }
+    try
+    {
+        obj.loadFromMemory(QByteArray("v 1 2 3\nf 1 2 3\n"));
+        MO_PRINT("MISSING index error");
+        ++errors;
+    }
+    catch (const IoException&) { }
+
+    return errors;
+}
+
+bool TestObjLoader::corruptCacheTest_(const QString& fn, const GEOM::Geometry* ref)
+{
+    const QString cacheName = GEOM::ObjLoader::cacheFilename(fn);
+    QFile f(cacheName);
+    if (!f.open(QIODevice::ReadOnly))
+    {
+        MO_PRINT("MISSING binary cache");
+        return false;
+    }
+    const QByteArray original = f.readAll();
+    f.close();
+
+    // offsets in ObjLoader's CacheHeader
+    const int offsetNumVertex = 40, offsetOffsetTriangle = 104;
+
+    // writes a modified copy of the cache, loads the .obj
+    // and expects it to be parsed again
+    auto check = [&](const char * what, int offset, const void * data, int bytes)
+    {
+        QByteArray bad(original);
+        memcpy(bad.data() + offset, data, bytes);
+        QFile f(cacheName);
+        if (!f.open(QIODevice::WriteOnly))
+            return false;
+        f.write(bad);
+        f.close();
+
+        bool cached;
+        auto g = load(fn, &cached);
+        const bool ok = !cached && compare(ref, g);
+        g->releaseRef("TestObjLoader");
+        if (!ok)
+            MO_PRINT("MISMATCH cache with " << what << " not rejected");
+        return ok;
+    };
+
+    uint64_t triOffset;
+    memcpy(&triOffset, original.constData() + offsetOffsetTriangle, sizeof(triOffset));
+
+    // first index of first triangle
+    const uint32_t badIndex = 0xffffffff, zeroIndex = 0;
+    // number of floats that overflows the byte size
+    const uint64_t hugeCount = uint64_t(1) << 62;
+
+    return check("vertex index out of range", triOffset, &badIndex, 4)
+         & check("zero vertex index", triOffset, &zeroIndex, 4)
+         & check("texcoord index out of range", triOffset + 4, &badIndex, 4)
+         & check("normal index out of range", triOffset + 8, &badIndex, 4)
+         & check("material index out of range", triOffset + 12, &badIndex, 4)
+         & check("overflowing vertex count", offsetNumVertex, &hugeCount, 8);
+}
+
+void TestObjLoader::benchmark()
+{
+    const QString fn = createObjFile_("mo_testobjloader_bench.obj", 4000000);
+    QFile::remove(GEOM::ObjLoader::cacheFilename(fn));
+    GEOM::ObjLoader::setCacheMinimumSize(0);
+
+    GEOM::ObjLoader obj;
+    TimeMessure tm;
+
+    GEOM::ObjLoader::setCacheEnabled(false);
+    GEOM::ObjLoader::setNumberThreads(1);
+    tm.start();
+    obj.loadFile(fn);
+    const double single = tm.time();
+
+    GEOM::ObjLoader::setNumberThreads(0);
+    tm.start();
+    obj.loadFile(fn);
+    const double multi = tm.time();
+
+    GEOM::ObjLoader::setCacheEnabled(true);
+    tm.start();
+    obj.loadFile(fn);
+    const double write = tm.time();
+
+    tm.start();
+    obj.loadFile(fn);
+    const double cached = tm.time();
+
+    MO_PRINT(QFile(fn).size() / (1 << 20) << "mb, "
+             << obj.numTriangles() << " triangles"
+             << "\nparse 1 thread " << single * 1000. << "ms"
+             << ", " << GEOM::ObjLoader::numberThreads() << " threads "
+             << multi * 1000. << "ms"
+             << "\nparse + write cache " << write * 1000. << "ms"
+             << ", load from cache " << cached * 1000. << "ms"
+             << " (" << multi / cached << "x)");
+
+    QFile::remove(fn);
+    QFile::remove(fn + ".mtl");
+    QFile::remove(GEOM::ObjLoader::cacheFilename(fn));
+}
+
+
+} // namespace MO
@@ -0,0 +1,48 @@
+/** @file testobjloader.h
+
+    @brief Tests and benchmarks the .obj parser and binary cache
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTOBJLOADER_H
+#define MOSRC_TESTS_TESTOBJLOADER_H
+
+#include <QString>
+
+namespace MO {
+namespace GEOM { class Geometry; }
+
+/** Compares single-threaded, multi-threaded and cached loading
+    of a generated .obj file */
+class TestObjLoader
+{
+public:
+    TestObjLoader() { }
+
+    int run();
+
+    /** Prints parse and cache load times of a large generated file */
+    static void benchmark();
+
+private:
+
+    /** Compares multi-threaded parsing of @p fn with @p ref */
+    int threadTest_(const QString& fn, const GEOM::Geometry* ref);
+    /** Writes, reads and invalidates the binary cache of @p fn */
+    int cacheTest_(const QString& fn, const GEOM::Geometry* ref);
+    /** Changes indices and sizes in the binary cache of @p fn
+        and checks that it's not used */
+    bool corruptCacheTest_(const QString& fn, const GEOM::Geometry* ref);
+    int parseErrorTest_();
+
+    /** Writes a random .obj file with about @p numStatements lines */
+    static QString createObjFile_(const QString& name, size_t numStatements);
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTOBJLOADER_H
@@ -0,0 +1,336 @@
+/** @file testscenedelta.cpp
+
+    @brief Tests the incremental Scene replication
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include "TestSceneDelta.h"
+#include "object/Scene.h"
+#include "object/control/SequenceFloat.h"
+#include "object/param/Parameters.h"
+#include "object/param/ParameterFloat.h"
+#include "object/param/Modulator.h"
+#include "object/util/ObjectFactory.h"
+#include "object/util/ObjectEditor.h"
+#include "network/SceneDelta.h"
+#include "network/SceneDeltaRecorder.h"
+#include "network/NetEvent.h"
+#include "io/DataStream.h"
+#include "io/error.h"
+#include "io/time.h"
+#include "io/log.h"
+#include "tool/stringmanip.h"
+
+namespace MO {
+
+namespace {
+
+    /** Creates a scene with @p numGroups groups of @p perGroup sequences */
+    Scene * createScene(int numGroups, int perGroup)
+    {
+        QList<Object*> groups;
+        for (int i = 0; i < numGroups; ++i)
+        {
+            auto group = ObjectFactory::createDummy();
+            ObjectPrivate::setObjectId(group, QString("group%1").arg(i));
+            for (int j = 0; j < perGroup; ++j)
+            {
+                auto seq = ObjectFactory::createSequenceFloat();
+                ObjectPrivate::setObjectId(seq, QString("seq%1").arg(i * perGroup + j));
+                ObjectPrivate::addObject(group, seq);
+            }
+            groups << group;
+        }
+
+        auto scene = ObjectFactory::createSceneObject();
+        scene->addObjects(scene, groups);
+        return scene;
+    }
+
+    /** Returns a copy through serialization */
+    Scene * copyScene(const Scene * scene)
+    {
+        QByteArray data;
+        {
+            IO::DataStream io(&data, QIODevice::WriteOnly);
+            ObjectFactory::saveScene(io, scene);
+        }
+        IO::DataStream io(data);
+        return ObjectFactory::loadScene(io);
+    }
+
+    /** Returns a description of the tree, names and parameters */
+    QString dump(const Object * root)
+    {
+        QString s = root->idName() + " '" + root->name() + "'";
+        for (auto p : root->params()->parameters())
+        {
+            s += " " + p->idName() + "=" + p->baseValueString(false);
+            for (auto m : p->modulators())
+                s += "<" + m->modulatorId() + (m->modulator() ? "" : "(unresolved)");
+        }
+        s += "\n";
+        for (auto c : root->childObjects())
+            s += dump(c);
+        return s;
+    }
+
+    /** Some typical edits through @p editor,
+        @p scene needs at least 4 groups with 2 sequences each */
+    void editScene(ObjectEditor& editor, Scene * scene)
+    {
+        const auto groups = scene->childObjects();
+        auto seq = groups[0]->childObjects()[0];
+        auto amp = static_cast<ParameterFloat*>(seq->params()->findParameter("amp"));
+        MO_ASSERT(amp, "no amplitude parameter in SequenceFloat");
+
+        // dragging a slider
+        for (int i = 1; i <= 100; ++i)
+            editor.setParameterValue(amp, Double(i) / 100.);
+
+        auto news = ObjectFactory::createSequenceFloat("new");
+        editor.addObject(groups[1], news, 0);
+        editor.setObjectName(news, "renamed");
+        editor.setParameterValue(
+                    static_cast<ParameterFloat*>(news->params()->findParameter("amp")), 0.25);
+        editor.addModulator(amp, news->idName(), "");
+        editor.moveObject(groups[0]->childObjects()[1], groups[2], 1);
+        editor.setObjectIndex(groups[2]->childObjects()[0], 3);
+        editor.deleteObject(groups[3]->childObjects()[0]);
+    }
+
+} // namespace
+
+
+int TestSceneDelta::run()
+{
+    int errors = 0;
+    try
+    {
+        errors += testEdits_();
+        errors += testUnmoved_();
+        errors += testFailedApply_();
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("EXCEPTION: " << e.what());
+        ++errors;
+    }
+
+    if (errors)
+        MO_PRINT(errors << " scene delta errors");
+    return errors;
+}
+
+int TestSceneDelta::testEdits_()
+{
+    int errors = 0;
+
+    auto server = createScene(4, 10);
+    auto client = copyScene(server);
+
+    ObjectEditor editor;
+    server->setObjectEditor(&editor);
+    SceneDeltaRecorder recorder;
+    recorder.setObjectEditor(&editor);
+    const quint32 version0 = recorder.beginSnapshot(server);
+
+    if (dump(server) != dump(client))
+    {
+        MO_PRINT("MISMATCH in scene copy");
+        ++errors;
+    }
+
+    editScene(editor, server);
+
+    SceneDelta delta;
+    quint32 baseVersion = 0, version = 0;
+    if (!recorder.takeDelta(delta, &baseVersion, &version))
+    {
+        MO_PRINT("NO edits recorded");
+        ++errors;
+    }
+    if (baseVersion != version0 || version != version0 + 1)
+    {
+        MO_PRINT("VERSION mismatch, expected " << version0 << "->" << (version0 + 1)
+                 << ", got " << baseVersion << "->" << version);
+        ++errors;
+    }
+    if (recorder.hasDelta())
+    {
+        MO_PRINT("EDITS left after takeDelta()");
+        ++errors;
+    }
+
+    // -- transmit and apply --
+
+    NetEventSceneDelta event;
+    event.setVersions(baseVersion, version);
+    event.setDelta(delta);
+    SceneDelta received;
+    if (!event.getDelta(received)
+        || received.numOperations() != delta.numOperations())
+    {
+        MO_PRINT("MISMATCH in serialized delta");
+        ++errors;
+    }
+
+    QString error;
+    if (!received.apply(client, &error))
+    {
+        MO_PRINT("APPLY failed: " << error);
+        ++errors;
+    }
+
+    if (dump(server) != dump(client))
+    {
+        MO_PRINT("MISMATCH after applying delta\n-- server --\n" << dump(server)
+                 << "\n-- client --\n" << dump(client));
+        ++errors;
+    }
+
+    // the same edits don't fit the new state
+    if (received.apply(client, &error))
+    {
+        MO_PRINT("APPLIED delta twice");
+        ++errors;
+    }
+
+    server->releaseRef("TestSceneDelta");
+    client->releaseRef("TestSceneDelta");
+    return errors;
+}
+
+int TestSceneDelta::testUnmoved_()
+{
+    int errors = 0;
+
+    auto scene = createScene(3, 4);
+    ObjectEditor editor;
+    scene->setObjectEditor(&editor);
+    SceneDeltaRecorder recorder;
+    recorder.setObjectEditor(&editor);
+    recorder.beginSnapshot(scene);
+
+    auto groups = scene->childObjects();
+    for (auto c : groups[1]->childObjects())
+        editor.emitObjectChanged(c);
+    if (recorder.hasDelta())
+    {
+        MO_PRINT("MOVE recorded for unchanged objects");
+        ++errors;
+    }
+
+    // siblings shift after a deletion, but the remote side does the same
+    editor.deleteObject(groups[1]->childObjects()[0]);
+    for (auto c : groups[1]->childObjects())
+        editor.emitObjectChanged(c);
+    SceneDelta delta;
+    recorder.takeDelta(delta, 0, 0);
+    if (delta.numOperations() != 1)
+    {
+        MO_PRINT("EXPECTED 1 edit after deletion, got " << delta.numOperations());
+        ++errors;
+    }
+
+    scene->releaseRef("TestSceneDelta");
+    return errors;
+}
+
+int TestSceneDelta::testFailedApply_()
+{
+    int errors = 0;
+
+    auto server = createScene(3, 4);
+    auto client = copyScene(server);
+
+    ObjectEditor editor;
+    server->setObjectEditor(&editor);
+    SceneDeltaRecorder recorder;
+    recorder.setObjectEditor(&editor);
+    recorder.beginSnapshot(server);
+
+    // valid edits, followed by one the client can not apply
+    auto groups = server->childObjects();
+    auto seq = groups[0]->childObjects()[0];
+    editor.setParameterValue(
+                static_cast<ParameterFloat*>(seq->params()->findParameter("amp")), 0.5);
+    editor.setObjectName(seq, "changed");
+    editor.addObject(groups[1], ObjectFactory::createSequenceFloat("new"), 0);
+    editor.setObjectName(groups[2]->childObjects()[0], "missing");
+
+    ObjectEditor clientEditor;
+    client->setObjectEditor(&clientEditor);
+    clientEditor.deleteObject(client->findObjectById(
+                                  groups[2]->childObjects()[0]->idName()));
+    const QString before = dump(client);
+
+    SceneDelta delta;
+    recorder.takeDelta(delta, 0, 0);
+
+    QString error;
+    if (delta.apply(client, &error))
+    {
+        MO_PRINT("APPLIED delta to a scene in another state");
+        ++errors;
+    }
+    else if (dump(client) != before)
+    {
+        MO_PRINT("SCENE changed by failed delta (" << error << ")\n-- before --\n"
+                 << before << "\n-- after --\n" << dump(client));
+        ++errors;
+    }
+
+    server->releaseRef("TestSceneDelta");
+    client->releaseRef("TestSceneDelta");
+    return errors;
+}
+
+void TestSceneDelta::benchmark(int numGroups, int perGroup)
+{
+    auto server = createScene(numGroups, perGroup);
+    auto client = copyScene(server);
+
+    ObjectEditor editor;
+    server->setObjectEditor(&editor);
+    SceneDeltaRecorder recorder;
+    recorder.setObjectEditor(&editor);
+    recorder.beginSnapshot(server);
+
+    editScene(editor, server);
+
+    SceneDelta delta;
+    recorder.takeDelta(delta, 0, 0);
+
+    TimeMessure tm;
+    QString error;
+    if (!delta.apply(client, &error))
+        MO_PRINT("APPLY failed: " << error);
+    const double applyTime = tm.time();
+
+    tm.start();
+    QByteArray full;
+    {
+        IO::DataStream io(&full, QIODevice::WriteOnly);
+        ObjectFactory::saveScene(io, server);
+    }
+    auto copy = copyScene(server);
+    const double fullTime = tm.time();
+    copy->releaseRef("TestSceneDelta");
+
+    MO_PRINT(server->findChildObjects<Object>(QString(), true).size() << " objects: "
+             << delta.numOperations() << " edits in "
+             << byte_to_string(delta.numBytes()) << ", applied in "
+             << applyTime * 1000. << "ms; full scene "
+             << byte_to_string(full.size()) << ", copied in "
+             << fullTime * 1000. << "ms");
+
+    server->releaseRef("TestSceneDelta");
+    client->releaseRef("TestSceneDelta");
+}
+
+} // namespace MO
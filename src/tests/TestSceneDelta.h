@@ -0,0 +1,41 @@
+/** @file testscenedelta.h
+
+    @brief Tests the incremental Scene replication
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTSCENEDELTA_H
+#define MOSRC_TESTS_TESTSCENEDELTA_H
+
+namespace MO {
+
+/** Edits a scene through the ObjectEditor, applies the recorded
+    SceneDelta to a copy and compares both scenes. */
+class TestSceneDelta
+{
+public:
+    TestSceneDelta() { }
+
+    int run();
+
+    /** Prints size and apply time of the delta against a full scene copy,
+        for @p numGroups groups of @p perGroup sequences */
+    static void benchmark(int numGroups, int perGroup);
+
+private:
+
+    /** Edits, transmits and applies a delta to a copy of the scene */
+    int testEdits_();
+    /** objectChanged() without a new position must not record a move */
+    int testUnmoved_();
+    /** A failing operation must leave the scene untouched */
+    int testFailedApply_();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTSCENEDELTA_H
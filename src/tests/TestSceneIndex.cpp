@@ -0,0 +1,241 @@
+/** @file testsceneindex.cpp
+
+    @brief Tests and benchmarks the Scene's object id index
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <random>
+#include <algorithm>
+
+#include "TestSceneIndex.h"
+#include "object/Scene.h"
+#include "object/control/SequenceFloat.h"
+#include "object/param/Parameters.h"
+#include "object/param/ParameterFloat.h"
+#include "object/param/Modulator.h"
+#include "object/util/ObjectFactory.h"
+#include "io/error.h"
+#include "io/time.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    /** Creates a scene with @p numGroups groups of @p perGroup sequences.
+        Each sequence's amplitude is modulated by a random other sequence. */
+    Scene * createScene(int numGroups, int perGroup)
+    {
+        std::mt19937 rnd(23);
+        const int num = numGroups * perGroup;
+
+        QList<Object*> groups;
+        for (int i = 0; i < numGroups; ++i)
+        {
+            auto group = ObjectFactory::createDummy();
+            ObjectPrivate::setObjectId(group, QString("group%1").arg(i));
+            for (int j = 0; j < perGroup; ++j)
+            {
+                auto seq = ObjectFactory::createSequenceFloat();
+                ObjectPrivate::setObjectId(seq, QString("seq%1").arg(i * perGroup + j));
+                auto p = seq->params()->findParameter("amp");
+                MO_ASSERT(p, "no amplitude parameter in SequenceFloat");
+                p->addModulator(QString("seq%1").arg(rnd() % num), "");
+                ObjectPrivate::addObject(group, seq);
+            }
+            groups << group;
+        }
+
+        auto scene = ObjectFactory::createSceneObject();
+        scene->addObjects(scene, groups);
+        return scene;
+    }
+
+    /** Returns number of errors */
+    int checkLookup(Scene * scene, const QList<Object*>& objects)
+    {
+        int errors = 0;
+        for (auto o : objects)
+        {
+            if (scene->findChildObject(o->idName(), true) != o)
+            {
+                MO_PRINT("MISMATCH in index lookup of '" << o->idName() << "'");
+                ++errors;
+            }
+            auto p = o->params()->findParameter("amp");
+            if (p && !p->modulators().isEmpty()
+                  && (!p->modulators()[0]->modulator()
+                      || p->modulators()[0]->modulator()->idName()
+                            != p->modulators()[0]->modulatorId()))
+            {
+                MO_PRINT("UNRESOLVED modulator in '" << o->idName() << "'");
+                ++errors;
+            }
+        }
+        if (scene->findChildObject("nonexisting", true))
+        {
+            MO_PRINT("FOUND non-existing id");
+            ++errors;
+        }
+        return errors;
+    }
+
+    /** Looks up ids of deleted, destroyed and renamed objects */
+    int testDeletion()
+    {
+        int errors = 0;
+        auto scene = createScene(4, 10);
+        const auto groups = scene->childObjects();
+
+        auto expect = [&](const QString& id, const Object * o, const char * what)
+        {
+            if (scene->findChildObject(id, true) != o)
+            {
+                MO_PRINT("MISMATCH lookup of '" << id << "' after " << what);
+                ++errors;
+            }
+        };
+
+        // deleted through the scene, object is kept until next render
+        QString id = groups[0]->childObjects()[3]->idName();
+        scene->deleteObject(groups[0]->childObjects()[3]);
+        expect(id, 0, "Scene::deleteObject()");
+
+        // deleted directly, object is destroyed
+        id = groups[1]->childObjects()[3]->idName();
+        ObjectPrivate::deleteObject(groups[1]->childObjects()[3]);
+        expect(id, 0, "destruction");
+
+        // whole branch destroyed
+        QStringList ids;
+        for (auto c : groups[2]->childObjects())
+            ids << c->idName();
+        ids << groups[2]->idName();
+        ObjectPrivate::deleteObject(groups[2]);
+        for (const auto& i : ids)
+            expect(i, 0, "destruction of parent");
+
+        // id of a deleted object is reused
+        auto seq = ObjectFactory::createSequenceFloat();
+        ObjectPrivate::setObjectId(seq, id);
+        scene->addObject(groups[3], seq);
+        expect(id, seq, "reuse of id");
+
+        // renamed in place
+        ObjectPrivate::setObjectId(seq, "renamed");
+        expect(id, 0, "renaming");
+        expect("renamed", seq, "renaming");
+
+        // remaining objects
+        for (auto o : scene->findChildObjects<Object>(QString(), true))
+            expect(o->idName(), o, "all changes");
+
+        scene->releaseRef("TestSceneIndex");
+        return errors;
+    }
+
+    /** Compares indexed and linear lookup, also after moves */
+    int testLookup()
+    {
+        int errors = 0;
+        auto scene = createScene(10, 100);
+        auto objects = scene->findChildObjects<Object>(QString(), true);
+        const auto groups = scene->childObjects();
+
+        errors += checkLookup(scene, objects);
+
+        // the linear search is used when an object to ignore is given
+        for (auto o : objects)
+            if (scene->findChildObject(o->idName(), true, scene) != o)
+            {
+                MO_PRINT("MISMATCH in linear lookup of '" << o->idName() << "'");
+                ++errors;
+            }
+
+        // move objects between groups and check again
+        for (int i = 0; i < 10; ++i)
+        {
+            auto o = groups.last()->childObjects().last();
+            scene->moveObject(o, groups.first(), 0);
+        }
+        errors += checkLookup(scene, objects);
+
+        scene->releaseRef("TestSceneIndex");
+        return errors;
+    }
+
+} // namespace
+
+
+int TestSceneIndex::run()
+{
+    int errors = 0;
+    try
+    {
+        errors += testDeletion();
+        errors += testLookup();
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("EXCEPTION: " << e.what());
+        ++errors;
+    }
+
+    if (errors)
+        MO_PRINT(errors << " scene index tests failed");
+    return errors;
+}
+
+void TestSceneIndex::benchmark(int numGroups, int perGroup)
+{
+    TimeMessure tm;
+
+    tm.start();
+    auto scene = createScene(numGroups, perGroup);
+    const double create = tm.time();
+
+    auto objects = scene->findChildObjects<Object>(QString(), true);
+    const auto groups = scene->childObjects();
+    MO_PRINT(objects.size() << " objects, created in " << create * 1000. << "ms");
+
+    // lookup through index
+    tm.start();
+    size_t found = 0;
+    for (auto o : objects)
+        found += scene->findChildObject(o->idName(), true) != 0;
+    const double indexed = tm.time();
+
+    // the linear search is used when an object to ignore is given
+    tm.start();
+    for (auto o : objects)
+        found += scene->findChildObject(o->idName(), true, scene) != 0;
+    const double linear = tm.time();
+
+    if (found != size_t(objects.size()) * 2)
+        MO_PRINT("MISMATCH found " << found << " of " << objects.size() * 2);
+
+    // tree updates
+    const int numUpdates = 10;
+    tm.start();
+    for (int i = 0; i < numUpdates; ++i)
+    {
+        auto seq = ObjectFactory::createSequenceFloat();
+        scene->addObject(groups[i % groups.size()], seq);
+        scene->deleteObject(seq);
+    }
+    const double update = tm.time() / (numUpdates * 2);
+
+    MO_PRINT("lookup of all ids: index " << indexed * 1000. << "ms"
+             << ", linear " << linear * 1000. << "ms"
+             << " (" << linear / std::max(0.000001, indexed) << "x)"
+             << "\ntree update " << update * 1000. << "ms");
+
+    scene->releaseRef("TestSceneIndex");
+}
+
+
+} // namespace MO
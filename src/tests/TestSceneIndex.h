@@ -0,0 +1,33 @@
+/** @file testsceneindex.h
+
+    @brief Tests and benchmarks the Scene's object id index
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTSCENEINDEX_H
+#define MOSRC_TESTS_TESTSCENEINDEX_H
+
+namespace MO {
+
+/** Builds a large scene of modulated sequences and compares
+    indexed and linear id lookup, as well as tree update times. */
+class TestSceneIndex
+{
+public:
+    TestSceneIndex() { }
+
+    int run();
+
+    /** Prints the time of indexed and linear lookup of all ids
+        and of tree updates in a scene of
+        @p numGroups x @p perGroup sequences */
+    static void benchmark(int numGroups, int perGroup);
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTSCENEINDEX_H
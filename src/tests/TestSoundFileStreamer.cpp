@@ -0,0 +1,349 @@
+/** @file testsoundfilestreamer.cpp
+
+    @brief Tests for SoundFileStreamer and streamed SoundFiles
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <QDir>
+#include <QFile>
+#include <QList>
+
+#include "TestSoundFileStreamer.h"
+#include "audio/tool/SoundFileStreamer.h"
+#include "audio/tool/SoundFileManager.h"
+#include "audio/tool/SoundFile.h"
+#include "audio/tool/AudioBuffer.h"
+#include "io/error.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    const uint
+        sampleRate = 44100,
+        numChannels = 2,
+        numFrames = 3 * 44100;
+
+    /** Content of the test file */
+    F32 signal(long frame, uint channel)
+    {
+        if (frame < 0 || frame >= long(numFrames))
+            return 0.f;
+        return F32(frame % 10007) * 0.0001f + channel;
+    }
+
+} // namespace
+
+
+struct TestSoundFileStreamer::Private
+{
+    Private()
+        : filename  (QDir::tempPath() + "/mo_test_soundfilestreamer.wav")
+    { }
+
+    bool createFile();
+
+    /** Reads until the prefetch thread has caught up */
+    bool readWait(AUDIO::SoundFileStreamer::Stream * s,
+                  F32 * buf, size_t frame, size_t num);
+    /** Calls getResampled() until it causes no underrun */
+    bool resampleWait(AUDIO::SoundFile * sf, const QList<AUDIO::AudioBuffer*>& bufs,
+                      SamplePos frame, F32 pitch);
+
+    bool compare(const F32 * buf, size_t frame, size_t num);
+
+    bool testSequential();
+    bool testSeek();
+    bool testConsumers();
+    bool testPitch(SamplePos frame, F32 pitch, uint bufferSize);
+    bool testOpenClose();
+
+    QString filename;
+};
+
+TestSoundFileStreamer::TestSoundFileStreamer()
+    : p_        (new Private())
+{
+}
+
+TestSoundFileStreamer::~TestSoundFileStreamer()
+{
+    delete p_;
+}
+
+#define ASSERT(cond_) \
+    if (!(cond_)) { MO_PRINT("FAILED: " << #cond_); return false; }
+
+int TestSoundFileStreamer::run()
+{
+    if (!p_->createFile())
+        return 1;
+
+    int errors = 0;
+    errors += !p_->testSequential();
+    errors += !p_->testSeek();
+    errors += !p_->testConsumers();
+    errors += !p_->testPitch(0, 1.f, 256);
+    errors += !p_->testPitch(1000, 2.5f, 1024);
+    // more than one chunk of SoundFile's stream buffer
+    errors += !p_->testPitch(1000, 10.25f, 1024);
+    errors += !p_->testPitch(50000, -3.f, 512);
+    // one chunk per sample
+    errors += !p_->testPitch(1000, 4100.25f, 4);
+    errors += !p_->testOpenClose();
+
+    QFile::remove(p_->filename);
+
+    if (errors)
+        MO_PRINT(errors << " sound file streamer tests failed");
+
+    return errors;
+}
+
+bool TestSoundFileStreamer::Private::createFile()
+{
+    auto sf = AUDIO::SoundFileManager::createSoundFile(numChannels, sampleRate);
+
+    std::vector<F32> data(numFrames * numChannels);
+    for (uint i=0; i<numFrames; ++i)
+        for (uint c=0; c<numChannels; ++c)
+            data[i * numChannels + c] = signal(i, c);
+    sf->appendDeviceData(&data[0], numFrames);
+
+    try
+    {
+        sf->saveFile(filename);
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("FAILED: " << e.what());
+        sf->release();
+        return false;
+    }
+
+    sf->release();
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::readWait(
+        AUDIO::SoundFileStreamer::Stream * s, F32 *buf, size_t frame, size_t num)
+{
+    const size_t expect = frame < numFrames
+            ? std::min(num, size_t(numFrames) - frame) : 0;
+
+    for (int i=0; i<2000; ++i)
+    {
+        if (s->read(buf, frame, num) == expect)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+bool TestSoundFileStreamer::Private::resampleWait(
+        AUDIO::SoundFile * sf, const QList<AUDIO::AudioBuffer*>& bufs,
+        SamplePos frame, F32 pitch)
+{
+    for (int i=0; i<2000; ++i)
+    {
+        const uint64_t n = sf->numUnderruns();
+        sf->getResampled(bufs, frame, sampleRate, 1.f, pitch);
+        if (sf->numUnderruns() == n)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+bool TestSoundFileStreamer::Private::compare(const F32 *buf, size_t frame, size_t num)
+{
+    for (size_t i=0; i<num; ++i)
+        for (uint c=0; c<numChannels; ++c)
+            if (buf[i * numChannels + c] != signal(frame + i, c))
+            {
+                MO_PRINT("FAILED: frame " << (frame + i) << " channel " << c
+                         << ", expected " << signal(frame + i, c)
+                         << ", got " << buf[i * numChannels + c]);
+                return false;
+            }
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::testSequential()
+{
+    MO_PRINT("sequential reading");
+
+    auto s = AUDIO::SoundFileStreamer::openStream(filename);
+    ASSERT(s->numChannels() == numChannels);
+    ASSERT(s->sampleRate() == sampleRate);
+    ASSERT(s->lengthSamples() == numFrames);
+
+    const size_t num = 256;
+    std::vector<F32> buf(num * numChannels);
+
+    bool ok = true;
+    // read over the end of file
+    for (size_t frame = 0; ok && frame < numFrames + num; frame += num)
+    {
+        ok &= readWait(s, &buf[0], frame, num);
+        ok &= compare(&buf[0], frame, num);
+    }
+    // never seeked backwards
+    ok &= s->numSeeks() == 0;
+
+    AUDIO::SoundFileStreamer::closeStream(s);
+    ASSERT(ok);
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::testSeek()
+{
+    MO_PRINT("seeking");
+
+    auto s = AUDIO::SoundFileStreamer::openStream(filename);
+
+    const size_t num = 100;
+    std::vector<F32> buf(num * numChannels);
+
+    bool ok = readWait(s, &buf[0], numFrames - num, num)
+           && compare(&buf[0], numFrames - num, num)
+           && readWait(s, &buf[0], 10, num)
+           && compare(&buf[0], 10, num)
+           && s->numSeeks() > 0;
+
+    // explicit prefetch
+    s->prefetch(70000);
+    ok &= readWait(s, &buf[0], 70000, num)
+       && compare(&buf[0], 70000, num);
+
+    AUDIO::SoundFileStreamer::closeStream(s);
+    ASSERT(ok);
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::testConsumers()
+{
+    MO_PRINT("two consumers of one file");
+
+    auto sf1 = AUDIO::SoundFileManager::getSoundFile(filename, false),
+         sf2 = AUDIO::SoundFileManager::getSoundFile(filename, false);
+
+    bool ok = sf1 != sf2 && sf1->isStream() && sf2->isStream();
+
+    const uint bsize = 128;
+    QList<AUDIO::AudioBuffer*> b1, b2;
+    for (uint c=0; c<numChannels; ++c)
+    {
+        b1 << new AUDIO::AudioBuffer(bsize);
+        b2 << new AUDIO::AudioBuffer(bsize);
+    }
+
+    // two read positions, far apart
+    for (SamplePos frame = 0; ok && frame < 20000; frame += bsize)
+    {
+        const SamplePos frame2 = frame + 100000;
+        ok &= resampleWait(sf1, b1, frame, 1.f)
+           && resampleWait(sf2, b2, frame2, 1.f);
+
+        for (uint c=0; ok && c<numChannels; ++c)
+            for (uint i=0; ok && i<bsize; ++i)
+            {
+                ok &= b1[c]->read(i) == signal(frame + i, c)
+                   && b2[c]->read(i) == signal(frame2 + i, c);
+            }
+    }
+    // the manager keeps separate reference counts
+    sf1->addRef();
+    sf1->release();
+    ok &= sf1->isStream();
+
+    for (auto b : b1)
+        delete b;
+    for (auto b : b2)
+        delete b;
+    sf1->release();
+    sf2->release();
+
+    ASSERT(ok);
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::testPitch(
+        SamplePos frame, F32 pitch, uint bsize)
+{
+    MO_PRINT("resampling with pitch " << pitch << ", buffer size " << bsize);
+
+    auto sf = AUDIO::SoundFileManager::getSoundFile(filename, false);
+
+    QList<AUDIO::AudioBuffer*> bufs;
+    for (uint c=0; c<numChannels; ++c)
+        bufs << new AUDIO::AudioBuffer(bsize);
+
+    bool ok = resampleWait(sf, bufs, frame, pitch);
+
+    F32 maxDiff = 0.f;
+    for (uint c=0; c<numChannels; ++c)
+        for (uint i=0; i<bsize; ++i)
+        {
+            const Double t = Double(frame) + Double(i) * pitch;
+            const long k = std::floor(t);
+            const F32 f = t - k,
+                      v0 = signal(k, c),
+                      expect = v0 + f * (signal(k + 1, c) - v0);
+            maxDiff = std::max(maxDiff, std::abs(bufs[c]->read(i) - expect));
+        }
+
+    for (auto b : bufs)
+        delete b;
+    sf->release();
+
+    if (maxDiff > 0.00001f)
+        MO_PRINT("FAILED: output differs by " << maxDiff);
+    ASSERT(ok && maxDiff <= 0.00001f);
+    return true;
+}
+
+bool TestSoundFileStreamer::Private::testOpenClose()
+{
+    MO_PRINT("opening and closing while the I/O thread is busy");
+
+    const size_t num = 64;
+    std::vector<F32> buf(num * numChannels);
+    std::vector<AUDIO::SoundFileStreamer::Stream*> streams;
+
+    const size_t numStart = AUDIO::SoundFileStreamer::numStreams();
+    for (int i=0; i<200; ++i)
+    {
+        streams.push_back(AUDIO::SoundFileStreamer::openStream(filename));
+        // random seeks to keep the thread busy
+        for (auto s : streams)
+            s->read(&buf[0], (i * 7919) % numFrames, num);
+        if (streams.size() > 8)
+        {
+            AUDIO::SoundFileStreamer::closeStream(streams.front());
+            streams.erase(streams.begin());
+        }
+    }
+
+    bool ok = AUDIO::SoundFileStreamer::numStreams() == numStart + streams.size();
+    for (auto s : streams)
+        AUDIO::SoundFileStreamer::closeStream(s);
+    ok &= AUDIO::SoundFileStreamer::numStreams() == numStart;
+
+    ASSERT(ok);
+    return true;
+}
+
+
+} // namespace MO
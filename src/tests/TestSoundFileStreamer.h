@@ -0,0 +1,31 @@
+/** @file testsoundfilestreamer.h
+
+    @brief Tests for SoundFileStreamer and streamed SoundFiles
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTSOUNDFILESTREAMER_H
+#define MOSRC_TESTS_TESTSOUNDFILESTREAMER_H
+
+namespace MO {
+
+class TestSoundFileStreamer
+{
+public:
+    TestSoundFileStreamer();
+    ~TestSoundFileStreamer();
+
+    int run();
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTSOUNDFILESTREAMER_H
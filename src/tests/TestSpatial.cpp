@@ -0,0 +1,304 @@
+/** @file testspatial.cpp
+
+    @brief Tests for SpatialMicrophone and SpatialSoundSource
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <QList>
+
+#include "TestSpatial.h"
+#include "audio/spatial/SpatialMicrophone.h"
+#include "audio/spatial/SpatialSoundSource.h"
+#include "audio/tool/AudioBuffer.h"
+#include "audio/tool/Delay.h"
+#include "math/TransformationBuffer.h"
+
+namespace MO {
+
+namespace {
+
+    const uint
+        bufferSize = 128,
+        sampleRate = 44100,
+        numBlocks = 32;
+    const F32
+        micAmp = 0.7f,
+        micDirExp = 3.f,
+        micDistFade = 0.1f,
+        micMinDist = 5.f,
+        micMaxDist = 50.f;
+
+    // circling sound sources, the last one is fixed at the first microphone
+    Mat4 soundTransformation(int idx, Double time)
+    {
+        Mat4 m(1);
+        if (idx == 3)
+            m[3] = Vec4(0, 1, 0, 1);
+        else
+        {
+            const Double a = time * (1. + idx) + idx;
+            m[3] = Vec4(10. * std::cos(a), idx - 1., 10. * std::sin(a), 1.);
+        }
+        return m;
+    }
+
+    // microphones turning around the y axis
+    Mat4 micTransformation(int idx, Double time)
+    {
+        const Float a = time * .5 + idx * 1.3;
+        Mat4 m(1);
+        m[0] = Vec4(std::cos(a), 0, -std::sin(a), 0);
+        m[2] = Vec4(std::sin(a), 0, std::cos(a), 0);
+        m[3] = Vec4(0, 1, idx, 1);
+        return m;
+    }
+
+    template <class F>
+    void fillTransformation(TransformationBuffer * t, uint decimation,
+                            SamplePos pos, F func)
+    {
+        t->setDecimation(decimation);
+        for (uint k = 0; k < t->numKeys(); ++k)
+            t->key(k) = func(Double(pos + t->keySample(k)) / sampleRate);
+        t->updateKeys();
+    }
+
+    /** Some sound sources and microphones with their buffers */
+    struct Rig
+    {
+        Rig(uint decimation)
+            : decimation(decimation)
+        {
+            for (int i=0; i<4; ++i)
+            {
+                auto snd = new AUDIO::SpatialSoundSource(
+                            new AUDIO::AudioBuffer(bufferSize),
+                            new AUDIO::AudioDelay(4096));
+                // every other source with distance sound
+                snd->setDistanceSound(i & 1);
+                sources << snd;
+            }
+            for (int i=0; i<3; ++i)
+            {
+                auto mic = new AUDIO::SpatialMicrophone(
+                            new AUDIO::AudioBuffer(bufferSize), sampleRate);
+                mic->setAmplitude(micAmp);
+                mic->setDirectionExponent(micDirExp);
+                mic->setDistanceFadeout(micDistFade);
+                mic->setDistanceSound(true, micMinDist, micMaxDist);
+                mics << mic;
+            }
+        }
+
+        ~Rig()
+        {
+            for (auto snd : sources)
+            {
+                snd->setDistanceSound(false);
+                delete snd->signal();
+                delete snd->delay();
+                delete snd;
+            }
+            for (auto mic : mics)
+            {
+                delete mic->signal();
+                delete mic;
+            }
+        }
+
+        /** Writes signals and transformations of block @p block */
+        void prepareBlock(uint block)
+        {
+            const SamplePos pos = SamplePos(block) * bufferSize;
+
+            for (int i=0; i<sources.size(); ++i)
+            {
+                auto snd = sources[i];
+
+                F32 * w = snd->signal()->writePointer();
+                for (uint j=0; j<bufferSize; ++j)
+                    w[j] = std::sin(Double(pos + j) * (0.01 + 0.003 * i));
+                snd->delay()->writeBlock(snd->signal()->readPointer(), bufferSize);
+
+                if (snd->isDistanceSound())
+                {
+                    w = snd->signalDist()->writePointer();
+                    for (uint j=0; j<bufferSize; ++j)
+                        w[j] = std::cos(Double(pos + j) * 0.002 * i);
+                    snd->delayDist()->writeBlock(
+                                snd->signalDist()->readPointer(), bufferSize);
+                }
+
+                fillTransformation(snd->transformationBuffer(), decimation, pos,
+                                   [=](Double t) { return soundTransformation(i, t); });
+                snd->updatePositions();
+            }
+
+            for (int i=0; i<mics.size(); ++i)
+                fillTransformation(mics[i]->transformationBuffer(), decimation, pos,
+                                   [=](Double t) { return micTransformation(i, t); });
+        }
+
+        uint decimation;
+        QList<AUDIO::SpatialSoundSource*> sources;
+        QList<AUDIO::SpatialMicrophone*> mics;
+    };
+
+    /** The former per-sample spatialization, used as reference */
+    void spatializeReference(const AUDIO::SpatialMicrophone * mic,
+                             const QList<AUDIO::SpatialSoundSource*>& sources,
+                             std::vector<F32>& out)
+    {
+        const F32 EPSILON = 1e-20,
+                dist_fac = 1.f / std::max(0.00001f, micMaxDist - micMinDist);
+
+        out.assign(bufferSize, 0.f);
+
+        for (auto snd : sources)
+        {
+            F32 delayReadPos = bufferSize;
+            for (uint i=0; i<bufferSize; ++i, --delayReadPos)
+            {
+                const Mat4&
+                        matrixMic = mic->transformationBuffer()->transformation(i),
+                        matrixSnd = snd->transformationBuffer()->transformation(i);
+                const Vec4
+                        posMic = matrixMic * Vec4(0,0,0,1),
+                        posSnd = matrixSnd * Vec4(0,0,0,1);
+
+                F32 dx = posSnd.x - posMic.x,
+                    dy = posSnd.y - posMic.y,
+                    dz = posSnd.z - posMic.z;
+                const F32 dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+                if (dist < EPSILON)
+                {
+                    out[i] += snd->signal()->read(i);
+                    continue;
+                }
+
+                const F32 ampDist = 1.f / (1.f + micDistFade * dist),
+                          delaySam = dist / 330.f * sampleRate;
+
+                F32 sam = snd->delay()->read(delayReadPos + delaySam);
+                if (snd->isDistanceSound())
+                {
+                    F32 dmix = std::max(0.f, std::min(1.f,
+                                    (dist - micMinDist) * dist_fac ));
+                    sam += dmix * (snd->delayDist()->read(delayReadPos + delaySam) - sam);
+                }
+
+                dx /= dist;
+                dy /= dist;
+                dz /= dist;
+
+                Vec4 micDir = matrixMic * Vec4(0,0,-1, 0);
+                F32 mx = micDir[0], my = micDir[1], mz = micDir[2];
+                const F32 micDirMag = std::sqrt(mx*mx + my*my + mz*mz);
+                mx /= micDirMag;
+                my /= micDirMag;
+                mz /= micDirMag;
+
+                const F32 micDot = 0.5f + 0.5f * (dx * mx + dy * my + dz * mz),
+                          ampDir = std::pow(micDot, micDirExp);
+
+                out[i] += sam * ampDist * ampDir * micAmp;
+            }
+        }
+    }
+
+    int testReference()
+    {
+        std::cout << "block-wise spatialization vs. per-sample reference\n";
+
+        Rig rig(1);
+        std::vector<F32> ref;
+        F32 maxDiff = 0;
+
+        for (uint b=0; b<numBlocks; ++b)
+        {
+            rig.prepareBlock(b);
+            for (auto mic : rig.mics)
+            {
+                mic->spatialize(rig.sources);
+                spatializeReference(mic, rig.sources, ref);
+
+                const F32 * sig = mic->signal()->readPointer();
+                for (uint i=0; i<bufferSize; ++i)
+                    maxDiff = std::max(maxDiff, std::abs(sig[i] - ref[i]));
+            }
+        }
+
+        if (maxDiff > 0.0001f)
+        {
+            std::cout << "[output differs by " << maxDiff << "]\n";
+            return 1;
+        }
+        std::cout << "OK (max difference " << maxDiff << ")\n";
+        return 0;
+    }
+
+    int testDecimation(uint decimation)
+    {
+        std::cout << "decimation " << decimation << " vs. full-rate transformations\n";
+
+        Rig rigFull(1), rigDec(decimation);
+        F32 maxDiff = 0;
+
+        for (uint b=0; b<numBlocks; ++b)
+        {
+            rigFull.prepareBlock(b);
+            rigDec.prepareBlock(b);
+            for (int m=0; m<rigFull.mics.size(); ++m)
+            {
+                rigFull.mics[m]->spatialize(rigFull.sources);
+                rigDec.mics[m]->spatialize(rigDec.sources);
+
+                const F32
+                        * full = rigFull.mics[m]->signal()->readPointer(),
+                        * dec = rigDec.mics[m]->signal()->readPointer();
+                for (uint i=0; i<bufferSize; ++i)
+                    maxDiff = std::max(maxDiff, std::abs(full[i] - dec[i]));
+            }
+        }
+
+        if (maxDiff > 0.001f)
+        {
+            std::cout << "[output differs by " << maxDiff << "]\n";
+            return 1;
+        }
+        std::cout << "OK (max difference " << maxDiff << ")\n";
+        return 0;
+    }
+
+} // namespace
+
+
+TestSpatial::TestSpatial()
+{
+}
+
+int TestSpatial::run()
+{
+    int errors =
+            + testReference()
+            + testDecimation(4)
+            + testDecimation(16)
+            + testDecimation(bufferSize)
+            ;
+
+    if (errors)
+        std::cout << errors << " spatial tests failed\n";
+
+    return errors;
+}
+
+} // namespace MO
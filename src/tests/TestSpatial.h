@@ -0,0 +1,26 @@
+/** @file testspatial.h
+
+    @brief Tests for SpatialMicrophone and SpatialSoundSource
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTSPATIAL_H
+#define MOSRC_TESTS_TESTSPATIAL_H
+
+namespace MO {
+
+class TestSpatial
+{
+public:
+    TestSpatial();
+
+    int run();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTSPATIAL_H
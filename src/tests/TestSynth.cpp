@@ -0,0 +1,285 @@
+/** @file testsynth.cpp
+
+    @brief Tests and benchmarks AUDIO::Synth
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#include <vector>
+
+#include "TestSynth.h"
+#include "audio/tool/Synth.h"
+#include "io/time.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    const uint bufferLength = 256;
+
+    void initSynth(AUDIO::Synth& synth, uint numVoices)
+    {
+        synth.setSampleRate(44100);
+        synth.setNumberVoices(numVoices);
+        synth.setWaveform(AUDIO::Waveform::T_SAW_RISE);
+        synth.setAttack(0.);
+        synth.setDecay(0.5);
+        synth.setSustain(0.5);
+        synth.setRelease(0.5);
+    }
+
+    /** Returns the index of the first non-zero sample, or @p num */
+    uint firstNonZero(const F32 * buf, uint num)
+    {
+        for (uint i=0; i<num; ++i)
+            if (buf[i] != 0.f)
+                return i;
+        return num;
+    }
+
+    // first sample is attack-from-zero, so sound starts one sample later
+
+    int testMonoStart()
+    {
+        int errors = 0;
+        for (uint start = 0; start < bufferLength; start += 17)
+        {
+            std::vector<F32> mono(bufferLength);
+
+            AUDIO::Synth s;
+            initSynth(s, 2);
+            s.noteOn(60, 1., start);
+            s.process(&mono[0], bufferLength);
+
+            const uint m = firstNonZero(&mono[0], bufferLength);
+            if (m != start + 1)
+            {
+                MO_PRINT("MISMATCH mono note-on at " << start
+                         << " starts at " << m);
+                ++errors;
+            }
+        }
+        return errors;
+    }
+
+    int testMultiChannelStart()
+    {
+        int errors = 0;
+        for (uint start = 0; start < bufferLength; start += 17)
+        {
+            std::vector<F32> multi(bufferLength * 2);
+            F32 * outputs[2] = { &multi[0], &multi[bufferLength] };
+
+            AUDIO::Synth s;
+            initSynth(s, 2);
+            s.noteOn(60, 1., start);
+            s.process(outputs, bufferLength);
+
+            const uint c = firstNonZero(outputs[0], bufferLength);
+            if (c != start + 1)
+            {
+                MO_PRINT("MISMATCH multi-channel note-on at " << start
+                         << " starts at " << c);
+                ++errors;
+            }
+
+            // the unused voice should be silent
+            if (firstNonZero(outputs[1], bufferLength) != bufferLength)
+            {
+                MO_PRINT("MISMATCH unused voice not silent");
+                ++errors;
+            }
+        }
+        return errors;
+    }
+
+    /** A note-on or note-off at an absolute sample position */
+    struct NoteEvent
+    {
+        uint pos;
+        int note;
+        bool on;
+    };
+
+    /** Note-offs are only at block boundaries, noteOff() has no start sample.
+        No voice is stolen, a stolen voice drops the tail of its previous
+        note before the start sample in the block path. */
+    const NoteEvent noteEvents[] =
+    {
+        {  10, 60, true },
+        { 300, 64, true },
+        { 512, 60, false },
+        { 700, 67, true },
+        { 1024, 64, false },
+        { 1280, 67, false }
+    };
+    const uint numNoteEvents = sizeof(noteEvents) / sizeof(NoteEvent);
+
+    void initCompareSynth(AUDIO::Synth& s, bool filtered)
+    {
+        initSynth(s, 4);
+        // let the voices end within the test
+        s.setRelease(0.005);
+        if (filtered)
+        {
+            s.setFilterType(AUDIO::MultiFilter::T_24_LOW);
+            s.setFilterFrequency(2000.);
+            s.setFilterResonance(0.3);
+        }
+    }
+
+    /** Renders the events block-wise and once per sample
+        and requires identical output.
+        The block path updates a filter envelope every few samples,
+        so it is not used here. */
+    int testBlockMatchesPerSample(bool mono, bool filtered)
+    {
+        const uint numBlocks = 8,
+                   length = numBlocks * bufferLength,
+                   numVoices = 4,
+                   numChannels = mono ? 1 : numVoices;
+
+        std::vector<F32> block(length * numChannels),
+                         single(length * numChannels);
+
+        // block-wise
+        AUDIO::Synth s;
+        initCompareSynth(s, filtered);
+        for (uint b = 0; b < numBlocks; ++b)
+        {
+            const uint pos = b * bufferLength;
+            for (uint e = 0; e < numNoteEvents; ++e)
+            {
+                const NoteEvent& n = noteEvents[e];
+                if (!n.on && n.pos == pos)
+                    s.noteOff(n.note);
+                else if (n.on && n.pos >= pos && n.pos < pos + bufferLength)
+                    s.noteOn(n.note, 1., n.pos - pos);
+            }
+
+            if (mono)
+                s.process(&block[pos], bufferLength);
+            else
+            {
+                F32 * outputs[numVoices];
+                for (uint c = 0; c < numVoices; ++c)
+                    outputs[c] = &block[c * length + pos];
+                s.process(outputs, bufferLength);
+            }
+        }
+
+        // per sample
+        AUDIO::Synth r;
+        initCompareSynth(r, filtered);
+        for (uint pos = 0; pos < length; ++pos)
+        {
+            for (uint e = 0; e < numNoteEvents; ++e)
+            {
+                const NoteEvent& n = noteEvents[e];
+                if (n.pos != pos)
+                    continue;
+                if (n.on)
+                    r.noteOn(n.note, 1.);
+                else
+                    r.noteOff(n.note);
+            }
+
+            if (mono)
+                r.process(&single[pos], 1);
+            else
+            {
+                F32 * outputs[numVoices];
+                for (uint c = 0; c < numVoices; ++c)
+                    outputs[c] = &single[c * length + pos];
+                r.process(outputs, 1);
+            }
+        }
+
+        int errors = 0;
+        for (uint i = 0; i < length * numChannels; ++i)
+            if (block[i] != single[i])
+            {
+                if (errors < 10)
+                    MO_PRINT("MISMATCH " << (mono ? "mono" : "multi-channel")
+                             << (filtered ? " filtered" : "")
+                             << " channel " << (i / length) << " sample "
+                             << (i % length) << ": block " << block[i]
+                             << ", per sample " << single[i]);
+                ++errors;
+            }
+
+        if (firstNonZero(&block[0], length * numChannels) == length * numChannels)
+        {
+            MO_PRINT("MISMATCH no output to compare");
+            ++errors;
+        }
+
+        return errors;
+    }
+
+} // namespace
+
+
+int TestSynth::run()
+{
+    int errors =
+            + testMonoStart()
+            + testMultiChannelStart()
+            + testBlockMatchesPerSample(true, false)
+            + testBlockMatchesPerSample(true, true)
+            + testBlockMatchesPerSample(false, false)
+            + testBlockMatchesPerSample(false, true)
+            ;
+
+    if (errors)
+        MO_PRINT(errors << " synth tests failed");
+
+    return errors;
+}
+
+void TestSynth::benchmark()
+{
+    const uint
+            numVoices = 64,
+            numBuffers = 2000;
+
+    for (int filtered = 0; filtered < 2; ++filtered)
+    {
+        AUDIO::Synth synth;
+        initSynth(synth, numVoices);
+        synth.setUnisonVoices(4);
+        synth.setUnisonDetune(12.);
+        synth.setCombinedUnison(true);
+        if (filtered)
+        {
+            synth.setFilterType(AUDIO::MultiFilter::T_24_LOW);
+            synth.setFilterFrequency(800.);
+            synth.setFilterResonance(0.3);
+        }
+
+        // unison pad
+        for (uint i=0; i<numVoices; ++i)
+            synth.noteOn(36 + i, 0.5);
+
+        std::vector<F32> buffer(bufferLength);
+
+        TimeMessure tm;
+        for (uint i=0; i<numBuffers; ++i)
+            synth.process(&buffer[0], bufferLength);
+        const double
+                cpu = tm.time(),
+                audio = double(numBuffers * bufferLength) / synth.sampleRate();
+
+        MO_PRINT((filtered ? "filtered: " : "unfiltered: ")
+                 << numVoices << " voices x 4 unison, "
+                 << audio << "s audio in " << cpu << "s, "
+                 << (numVoices * audio / cpu) << " voices per core");
+    }
+}
+
+
+} // namespace MO
@@ -0,0 +1,32 @@
+/** @file testsynth.h
+
+    @brief Tests and benchmarks AUDIO::Synth
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/16/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTSYNTH_H
+#define MOSRC_TESTS_TESTSYNTH_H
+
+namespace MO {
+
+/** Checks note-on timing, compares block-wise against per-sample
+    rendering and measures voices per core */
+class TestSynth
+{
+public:
+    TestSynth() { }
+
+    int run();
+
+    /** Prints the voices per core of a unison pad,
+        with and without filter */
+    static void benchmark();
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTSYNTH_H
@@ -8,26 +8,40 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
 
 #include <QTime>
 
 #include "TestTimeline.h"
+#include "math/Timeline1dCompiled.h"
 
 namespace MO {
 
 
-bool TestTimeline::run()
+void TestTimeline::createData()
 {
+    if (!values.empty())
+        return;
+
     for (int i=0; i<500000; ++i)
     {
         writepos.push_back( (double)rand()/RAND_MAX * 1000.);
         readpos.push_back(  (double)rand()/RAND_MAX * 1000.);
         values.push_back(   (double)rand()/RAND_MAX * 2. - 1.);
     }
+}
+
+bool TestTimeline::run()
+{
+    createData();
 
     bool r = true;
     for (int i=1; i<MATH::TimelinePoint::MAX; ++i)
         r |= test((MATH::TimelinePoint::Type)i);
+    r &= testMinMax();
+    for (int i=1; i<MATH::TimelinePoint::MAX; ++i)
+        r &= testCompiled((MATH::TimelinePoint::Type)i);
     return r;
 }
 
@@ -80,6 +94,163 @@ bool TestTimeline::test(MATH::TimelinePoint::Type pointType)
     return true;
 }
 
+bool TestTimeline::testMinMax()
+{
+    auto tl = new MATH::Timeline1d();
+    ScopedRefCounted tldel(tl, "TestTimeline");
+
+    const int num = values.size();
+    for (int i=0; i<num; ++i)
+        tl->add(writepos[i], values[i], MATH::TimelinePoint::LINEAR);
+
+    const int numQueries = 2000;
+    std::vector<double> qstart, qend;
+    for (int i=0; i<numQueries; ++i)
+    {
+        double a = readpos[i], b = readpos[i] + (double)rand()/RAND_MAX * 100.;
+        qstart.push_back(a);
+        qend.push_back(b);
+    }
+
+    // compares all queries with a scan of the points,
+    // through a const reference, getData() would invalidate the cache
+    const MATH::Timeline1d& ctl = *tl;
+    auto check = [&]()
+    {
+        int errors = 0;
+        for (int i=0; i<numQueries; ++i)
+        {
+            double rmi = ctl.get(qstart[i]), rma = rmi;
+            rmi = std::min(rmi, ctl.get(qend[i]));
+            rma = std::max(rma, ctl.get(qend[i]));
+            for (auto it = ctl.getData().lower_bound(MATH::Timeline1d::hash(qstart[i]));
+                 it != ctl.getData().end() && it->second.t <= qend[i]; ++it)
+            {
+                if (it->second.t < qstart[i])
+                    continue;
+                rmi = std::min(rmi, it->second.val);
+                rma = std::max(rma, it->second.val);
+            }
+
+            double mi, ma;
+            ctl.getMinMax(qstart[i], qend[i], mi, ma);
+            if (mi != rmi || ma != rma)
+                ++errors;
+        }
+        return errors;
+    };
+
+    int errors = check();
+
+    // change one point in place
+    auto it = tl->getData().lower_bound(MATH::Timeline1d::hash(500.));
+    it->second.val = 10.;
+    tl->setChanged();
+    double mi, ma;
+    tl->getMinMax(0., 1000., mi, ma);
+    if (ma != 10.)
+        ++errors;
+    errors += check();
+
+    // insert in the middle, shifting the following points
+    for (int i=0; i<100; ++i)
+        tl->add(300. + i * 0.001234, -5. + i * 0.01, MATH::TimelinePoint::LINEAR);
+    errors += check();
+
+    // remove a range and points at the end
+    tl->remove(600., 650.);
+    tl->remove(990., 1001.);
+    errors += check();
+
+    if (errors)
+        std::cout << "min/max: " << errors << " errors" << std::endl;
+
+    return errors == 0;
+}
+
+bool TestTimeline::testCompiled(MATH::TimelinePoint::Type pointType)
+{
+    auto tl = new MATH::Timeline1d();
+    ScopedRefCounted tldel(tl, "TestTimeline");
+
+    for (int i=0; i<1000; ++i)
+        tl->add(writepos[i], values[i], pointType);
+
+    double maxError = 0.;
+    MATH::Timeline1dCompiled::Cursor cursor;
+
+    // sequential
+    auto ctl = tl->compiled();
+    for (int i=0; i<100000; ++i)
+    {
+        const double t = -10. + i * 0.0102;
+        maxError = std::max(maxError, std::abs(tl->get(t) - ctl->get(t, cursor)));
+    }
+
+    // random access after a change
+    tl->setLimit(-.5, .5);
+    ctl = tl->compiled();
+    for (int i=0; i<100000; ++i)
+    {
+        const double t = readpos[i];
+        maxError = std::max(maxError, std::abs(tl->get(t) - ctl->get(t, cursor)));
+        maxError = std::max(maxError, std::abs(tl->get(t) - ctl->get(t)));
+    }
+
+    const bool ok = maxError < 1e-9;
+    if (!ok)
+        std::cout << "compiled " << MATH::TimelinePoint::getName(pointType)
+                  << ": max error " << maxError << std::endl;
+    return ok;
+}
+
+void TestTimeline::benchmarkCompiled()
+{
+    createData();
+
+    auto tl = new MATH::Timeline1d();
+    ScopedRefCounted tldel(tl, "TestTimeline");
+
+    for (int i=0; i<10000; ++i)
+        tl->add(writepos[i] * 3.6, values[i], MATH::TimelinePoint::SYMMETRIC);
+
+    const int num = 10000000, blockSize = 512;
+    const double step = 3600. / num;
+
+    QTime m;
+    m.start();
+
+    double v = 0.;
+    for (int i=0; i<num; ++i)
+        v += tl->get(i * step);
+
+    int e1 = m.elapsed();
+    m.start();
+
+    auto ctl = tl->compiled();
+    MATH::Timeline1dCompiled::Cursor cursor;
+    for (int i=0; i<num; ++i)
+        v += ctl->get(i * step, cursor);
+
+    int e2 = m.elapsed();
+    m.start();
+
+    std::vector<double> block(blockSize);
+    for (int i=0; i<num; i+=blockSize)
+    {
+        ctl->get(i * step, step, &block[0], blockSize);
+        v += block[0];
+    }
+
+    int e3 = m.elapsed();
+
+    std::cout << "sequential reading of " << num << " values (" << v << ")"
+              << "\nmap:      " << std::setw(8) << ((double)e1/1000) << "sec"
+              << "\ncursor:   " << std::setw(8) << ((double)e2/1000) << "sec"
+              << "\nblock:    " << std::setw(8) << ((double)e3/1000) << "sec"
+              << std::endl;
+}
+
 
 
 } // namespace MO
@@ -21,9 +21,18 @@ public:
 
     bool run();
 
+    /** Speed of sequential reading, map vs. compiled */
+    void benchmarkCompiled();
+
 private:
 
+    void createData();
+
     bool test(MATH::TimelinePoint::Type type);
+    /** Compares getMinMax() against a scan of all points */
+    bool testMinMax();
+    /** Compares Timeline1dCompiled against Timeline1d::get() */
+    bool testCompiled(MATH::TimelinePoint::Type type);
 
     std::vector<double> writepos, values, readpos;
 };
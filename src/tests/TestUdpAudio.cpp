@@ -0,0 +1,325 @@
+/** @file testudpaudio.cpp
+
+    @brief Tests the udp audio frame format and jitter buffer
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+#include <QList>
+
+#include "TestUdpAudio.h"
+#include "network/UdpAudioFrame.h"
+#include "network/UdpAudioJitterBuffer.h"
+#include "io/error.h"
+#include "io/time.h"
+#include "io/log.h"
+
+namespace MO {
+
+namespace {
+
+    /** Some mix of sine, silence and constant channels */
+    F32 testSample(int channel, SamplePos pos)
+    {
+        switch (channel % 3)
+        {
+            case 0: return std::sin(F32(pos) * 0.01f * (channel + 1)) * 0.5f;
+            case 1: return 0.f;
+            default: return F32(channel) / 64.f;
+        }
+    }
+
+    /** Returns the datagrams for @p numBlocks blocks of test samples */
+    QList<QByteArray> encode(UdpAudioFrame::Compression comp,
+                             int numChannels, int blockSize, int numBlocks)
+    {
+        QList<QByteArray> datagrams;
+        UdpAudioFrame frame(1400, comp);
+        uint32_t seq = 0;
+        std::vector<F32> block(blockSize);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const SamplePos pos = SamplePos(b) * blockSize;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                    block[i] = testSample(ch, pos + i);
+
+                size_t offset = 0;
+                while (offset < size_t(blockSize))
+                {
+                    offset += frame.addPart(ch, pos, blockSize, offset,
+                                            &block[offset], blockSize - offset);
+                    if (offset < size_t(blockSize))
+                    {
+                        datagrams << frame.data();
+                        frame.clear(++seq);
+                    }
+                }
+            }
+            // flush per block
+            datagrams << frame.data();
+            frame.clear(++seq);
+        }
+        return datagrams;
+    }
+
+} // namespace
+
+
+struct TestUdpAudio::Private
+{
+    Private(TestUdpAudio* p)
+        : p         (p)
+    { }
+
+    bool testFrames(int compression, int numChannels, int blockSize);
+    bool testJitter(int blockSize, double lossRate);
+    bool testInvalid();
+
+    TestUdpAudio* p;
+};
+
+TestUdpAudio::TestUdpAudio()
+    : p_        (new Private(this))
+{
+}
+
+TestUdpAudio::~TestUdpAudio()
+{
+    delete p_;
+}
+
+int TestUdpAudio::run()
+{
+    int errors = 0;
+    try
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            errors += !p_->testFrames(c, 32, 64);
+            errors += !p_->testFrames(c, 2, 1024);
+        }
+        errors += !p_->testJitter(64, 0.);
+        errors += !p_->testJitter(64, 0.05);
+        errors += !p_->testInvalid();
+    }
+    catch (const Exception& e)
+    {
+        MO_PRINT("EXCEPTION: " << e.what());
+        ++errors;
+    }
+
+    if (errors)
+        MO_PRINT(errors << " udp audio tests failed");
+    return errors;
+}
+
+bool TestUdpAudio::Private::testFrames(int compression, int numChannels, int blockSize)
+{
+    const int numBlocks = 100;
+    const auto comp = UdpAudioFrame::Compression(compression);
+    const F32 maxError = comp == UdpAudioFrame::C_INT16 ? 1.f / 32000.f : 0.f;
+
+    const auto datagrams = encode(comp, numChannels, blockSize, numBlocks);
+
+    int errors = 0;
+    std::vector<int> received(numChannels);
+    for (const auto& d : datagrams)
+    {
+        uint32_t s;
+        bool valid = UdpAudioFrame::read(d, &s,
+            // subscribe to every second channel
+            [](uint32_t stream) { return stream % 2 == 0; },
+            [&](const UdpAudioFrame::Part& part)
+        {
+            if (part.stream % 2 != 0 || part.stream >= uint32_t(numChannels))
+            {
+                MO_PRINT("unexpected stream " << part.stream);
+                ++errors;
+                return;
+            }
+            for (uint i = 0; i < part.count; ++i)
+            {
+                const F32 v = testSample(part.stream, part.pos + part.offset + i);
+                if (std::abs(part.samples[i] - v) > maxError)
+                {
+                    if (errors < 10)
+                        MO_PRINT("MISMATCH stream " << part.stream << " pos "
+                                 << (part.pos + part.offset + i) << ": "
+                                 << part.samples[i] << ", expected " << v);
+                    ++errors;
+                }
+            }
+            received[part.stream] += part.count;
+        });
+        if (!valid)
+        {
+            MO_PRINT("invalid frame " << s);
+            ++errors;
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ch += 2)
+    if (received[ch] != numBlocks * blockSize)
+    {
+        MO_PRINT("channel " << ch << " received " << received[ch]
+                 << " samples, expected " << (numBlocks * blockSize));
+        ++errors;
+    }
+
+    if (errors)
+        MO_PRINT("FAILED frames: compression " << compression << ", "
+                 << numChannels << " channels, blocksize " << blockSize);
+    return !errors;
+}
+
+bool TestUdpAudio::Private::testJitter(int blockSize, double lossRate)
+{
+    const int numBlocks = 1000;
+    std::mt19937 rnd(42);
+
+    // half blocks, shuffled within a window of 3 blocks, some lost
+    struct Part { SamplePos pos; size_t offset; };
+    std::vector<Part> parts;
+    int numLost = 0;
+    for (int b = 0; b < numBlocks; ++b)
+    for (int h = 0; h < 2; ++h)
+    {
+        if (std::uniform_real_distribution<double>(0., 1.)(rnd) < lossRate)
+        {
+            ++numLost;
+            continue;
+        }
+        Part p;
+        p.pos = SamplePos(b) * blockSize;
+        p.offset = h * blockSize / 2;
+        parts.push_back(p);
+    }
+    for (size_t i = 0; i + 6 < parts.size(); i += 6)
+        std::shuffle(parts.begin() + i, parts.begin() + i + 6, rnd);
+
+    UdpAudioJitterBuffer jitter(blockSize, 4);
+    std::vector<F32> samples(blockSize), out(blockSize);
+    int errors = 0;
+    SamplePos expected = 0;
+    for (const Part& p : parts)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            samples[i] = testSample(0, p.pos + i);
+        jitter.addPart(p.pos, p.offset, &samples[p.offset], blockSize / 2);
+
+        SamplePos pos;
+        while (jitter.pull(&out[0], &pos))
+        {
+            if (pos != expected)
+            {
+                MO_PRINT("OUT OF ORDER block " << pos << ", expected " << expected);
+                ++errors;
+            }
+            expected = pos + blockSize;
+        }
+    }
+
+    if (lossRate == 0. && jitter.numConcealed())
+    {
+        MO_PRINT("concealed blocks without loss");
+        ++errors;
+    }
+    if (jitter.numConcealed() > uint64_t(numLost))
+    {
+        MO_PRINT("more blocks concealed than parts lost");
+        ++errors;
+    }
+
+    if (errors)
+        MO_PRINT("FAILED jitter: blocksize " << blockSize << ", loss " << lossRate
+                 << "; lost parts " << numLost
+                 << ", delivered " << jitter.numDelivered()
+                 << ", concealed " << jitter.numConcealed()
+                 << ", late " << jitter.numLate());
+    return !errors;
+}
+
+bool TestUdpAudio::Private::testInvalid()
+{
+    int errors = 0;
+    auto onPart = [&](const UdpAudioFrame::Part&) { ++errors; };
+
+    UdpAudioFrame frame(1400, UdpAudioFrame::C_LOSSLESS);
+    std::vector<F32> block(64, .5f);
+    frame.addPart(1, 0, 64, 0, &block[0], 64);
+
+    if (UdpAudioFrame::read(QByteArray("_audio_"), 0, nullptr, onPart))
+    {
+        MO_PRINT("garbage read as frame");
+        ++errors;
+    }
+    // truncated
+    if (UdpAudioFrame::read(frame.data().left(frame.data().size() - 1),
+                            0, nullptr, onPart))
+    {
+        MO_PRINT("truncated frame read");
+        ++errors;
+    }
+    if (!UdpAudioFrame::read(frame.data(), 0, nullptr,
+                             [](const UdpAudioFrame::Part&) { }))
+    {
+        MO_PRINT("valid frame not read");
+        ++errors;
+    }
+
+    return !errors;
+}
+
+void TestUdpAudio::benchmark()
+{
+    const int numBlocks = 100;
+
+    for (int c = 0; c < 3; ++c)
+    for (int layout = 0; layout < 2; ++layout)
+    {
+        const int numChannels = layout ? 2 : 32,
+                  blockSize = layout ? 1024 : 64;
+        const auto comp = UdpAudioFrame::Compression(c);
+
+        TimeMessure tm;
+        const auto datagrams = encode(comp, numChannels, blockSize, numBlocks);
+        const double encodeTime = tm.time();
+
+        size_t bytes = 0, samples = 0;
+        tm.start();
+        for (const auto& d : datagrams)
+        {
+            bytes += d.size();
+            UdpAudioFrame::read(d, 0, nullptr,
+                                [&](const UdpAudioFrame::Part& part)
+            {
+                samples += part.count;
+            });
+        }
+        const double decodeTime = tm.time();
+
+        // string header, channel, pos, blocksize and raw floats per channel
+        const size_t oldBytes = size_t(numBlocks) * numChannels
+                                * (40 + blockSize * sizeof(F32));
+
+        MO_PRINT("compression " << c << ", " << numChannels << " channels, blocksize "
+                 << blockSize << ": datagrams " << datagrams.size() << " (was "
+                 << numBlocks * numChannels << "), bytes " << bytes
+                 << " (was approx. " << oldBytes << "), encode "
+                 << (encodeTime * 1000.) << "ms, decode "
+                 << (decodeTime * 1000.) << "ms for " << samples << " samples");
+    }
+}
+
+
+} // namespace MO
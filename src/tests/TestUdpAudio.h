@@ -0,0 +1,38 @@
+/** @file testudpaudio.h
+
+    @brief Tests the udp audio frame format and jitter buffer
+
+    <p>(c) 2026, stefan.berke@modular-audio-graphics.com</p>
+    <p>All rights reserved</p>
+
+    <p>created 10/17/2026</p>
+*/
+
+#ifndef MOSRC_TESTS_TESTUDPAUDIO_H
+#define MOSRC_TESTS_TESTUDPAUDIO_H
+
+namespace MO {
+
+/** Packs multichannel blocks into UdpAudioFrame datagrams,
+    reads them back through lossy, reordering delivery
+    and compares with the per-channel datagrams of the old format. */
+class TestUdpAudio
+{
+public:
+    TestUdpAudio();
+    ~TestUdpAudio();
+
+    int run();
+
+    /** Prints datagram count, size and coding time
+        compared to the per-channel datagrams */
+    static void benchmark();
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace MO
+
+#endif // MOSRC_TESTS_TESTUDPAUDIO_H
@@ -1,29 +1,57 @@
 HEADERS += \
     $$PWD/TestAngelscript.h \
+    $$PWD/TestBlockModulation.h \
+    $$PWD/TestClockSync.h \
     $$PWD/TestCommandLineParser.h \
+    $$PWD/TestConvolver.h \
     $$PWD/TestCsg.h \
     $$PWD/TestDirectedGraph.h \
+    $$PWD/TestDspPath.h \
     $$PWD/TestEquation.h \
+    $$PWD/TestFileTransfer.h \
     $$PWD/TestFft.h \
     $$PWD/TestFloatMatrix.h \
+    $$PWD/TestFrustum.h \
+    $$PWD/TestGeometryBvh.h \
     $$PWD/TestGlWindow.h \
     $$PWD/TestHelpSystem.h \
+    $$PWD/TestObjLoader.h \
     $$PWD/TestPython.h \
+    $$PWD/TestSceneDelta.h \
+    $$PWD/TestSceneIndex.h \
+    $$PWD/TestSpatial.h \
+    $$PWD/TestSoundFileStreamer.h \
+    $$PWD/TestSynth.h \
     $$PWD/TestTesselator.h \
     $$PWD/TestTimeline.h \
+    $$PWD/TestUdpAudio.h \
     $$PWD/TestXmlStream.h
 
 SOURCES += \
     $$PWD/TestAngelscript.cpp \
+    $$PWD/TestBlockModulation.cpp \
+    $$PWD/TestClockSync.cpp \
     $$PWD/TestCommandLineParser.cpp \
+    $$PWD/TestConvolver.cpp \
     $$PWD/TestCsg.cpp \
     $$PWD/TestDirectedGraph.cpp \
+    $$PWD/TestDspPath.cpp \
     $$PWD/TestEquation.cpp \
+    $$PWD/TestFileTransfer.cpp \
     $$PWD/TestFft.cpp \
     $$PWD/TestFloatMatrix.cpp \
+    $$PWD/TestFrustum.cpp \
+    $$PWD/TestGeometryBvh.cpp \
     $$PWD/TestGlWindow.cpp \
     $$PWD/TestHelpSystem.cpp \
+    $$PWD/TestObjLoader.cpp \
     $$PWD/TestPython.cpp \
+    $$PWD/TestSceneDelta.cpp \
+    $$PWD/TestSceneIndex.cpp \
+    $$PWD/TestSpatial.cpp \
+    $$PWD/TestSoundFileStreamer.cpp \
+    $$PWD/TestSynth.cpp \
     $$PWD/TestTesselator.cpp \
     $$PWD/TestTimeline.cpp \
+    $$PWD/TestUdpAudio.cpp \
     $$PWD/TestXmlStream.cpp
@@ -0,0 +1,534 @@
+#ifdef MO_ENABLE_FFMPEG
+
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#include "VideoEncoder.h"
+#include "ffmpeg.h"
+#include "io/error.h"
+#include "io/log.h"
+
+namespace FFM {
+
+struct VideoEncoder::Private
+{
+    Private(VideoEncoder * p)
+        : p             (p)
+        , width         (0)
+        , height        (0)
+        , fps           (30)
+        , videoBitRate  (0)
+        , threadCount   (0)
+        , isAudioEnabled_(false)
+        , sampleRate    (44100)
+        , numChannels   (2)
+        , audioBitRate  (0)
+        , formatCtx     (0)
+        , videoCodecCtx (0)
+        , audioCodecCtx (0)
+        , videoStream   (0)
+        , audioStream   (0)
+        , swsContext    (0)
+        , videoFrame    (0)
+        , audioFrame    (0)
+        , videoFramesEncoded(0)
+        , audioSamplesEncoded(0)
+        , audioFrameSize(0)
+    { }
+
+    void openFile(const std::string& fn);
+    void close();
+    /** Releases everything without writing */
+    void release();
+    void openVideo();
+    void openAudio();
+    void encodeAudioFrame(size_t numFrames);
+    /** Sends @p frame to the encoder and writes all available packets.
+        @p frame NULL flushes the encoder. */
+    void encode(AVCodecContext * ctx, AVStream * stream, AVFrame * frame);
+    void copyParameters(AVCodecContext * ctx, AVStream * stream);
+
+    VideoEncoder * p;
+
+    std::string url,
+                videoCodecName,
+                audioCodecName;
+    int width, height, fps;
+    int64_t videoBitRate;
+    int threadCount;
+    bool isAudioEnabled_;
+    int sampleRate, numChannels;
+    int64_t audioBitRate;
+
+    AVFormatContext* formatCtx;
+    AVCodecContext* videoCodecCtx, *audioCodecCtx;
+    AVStream* videoStream, *audioStream;
+    SwsContext* swsContext;
+    AVFrame* videoFrame, *audioFrame;
+
+    int64_t videoFramesEncoded,
+            audioSamplesEncoded;
+    int audioFrameSize;
+    /** Interleaved samples waiting for a complete audio frame */
+    std::vector<float> audioQue;
+};
+
+VideoEncoder::VideoEncoder()
+    : p_        (new Private(this))
+{
+}
+
+VideoEncoder::~VideoEncoder()
+{
+    try { p_->close(); }
+    catch (const MO::Exception& e)
+    {
+        MO_WARNING("VideoEncoder::~VideoEncoder() " << e.what());
+    }
+    delete p_;
+}
+
+bool VideoEncoder::isReady() const { return p_->formatCtx != nullptr; }
+const std::string& VideoEncoder::currentFilename() const { return p_->url; }
+int VideoEncoder::width() const { return p_->width; }
+int VideoEncoder::height() const { return p_->height; }
+int VideoEncoder::framesPerSecond() const { return p_->fps; }
+int64_t VideoEncoder::numEncodedFrames() const { return p_->videoFramesEncoded; }
+
+void VideoEncoder::setVideoFormat(int width, int height, int fps)
+    { p_->width = width; p_->height = height; p_->fps = std::max(1, fps); }
+void VideoEncoder::setVideoCodec(const std::string& name) { p_->videoCodecName = name; }
+void VideoEncoder::setVideoBitRate(int64_t b) { p_->videoBitRate = std::max(int64_t(0), b); }
+void VideoEncoder::setThreadCount(int num) { p_->threadCount = std::max(0, num); }
+void VideoEncoder::setAudioFormat(int sampleRate, int numChannels)
+    { p_->sampleRate = sampleRate; p_->numChannels = numChannels; p_->isAudioEnabled_ = true; }
+void VideoEncoder::setAudioEnabled(bool e) { p_->isAudioEnabled_ = e; }
+void VideoEncoder::setAudioCodec(const std::string& name) { p_->audioCodecName = name; }
+void VideoEncoder::setAudioBitRate(int64_t b) { p_->audioBitRate = std::max(int64_t(0), b); }
+
+void VideoEncoder::openFile(const std::string& url) { p_->openFile(url); }
+void VideoEncoder::close() { p_->close(); }
+
+std::string VideoEncoder::toString() const
+{
+    std::stringstream s;
+    s << "[" << p_->url << "]";
+    if (p_->formatCtx)
+        s << "\nformat " << p_->formatCtx->oformat->long_name;
+    if (p_->videoCodecCtx)
+        s << "\nvideo codec " << p_->videoCodecCtx->codec->long_name
+          << "\nvideo size " << p_->width << "x" << p_->height
+                             << " @ " << p_->fps << " fps"
+          << "\npixel format " << av_get_pix_fmt_name(p_->videoCodecCtx->pix_fmt)
+          << "\nthreads " << p_->videoCodecCtx->thread_count
+        ;
+    if (p_->audioCodecCtx)
+        s << "\naudio codec " << p_->audioCodecCtx->codec->long_name
+          << "\nsample format " << av_get_sample_fmt_name(p_->audioCodecCtx->sample_fmt)
+          << "\nchannels " << p_->numChannels << " @ " << p_->sampleRate << " hz"
+        ;
+    return s.str();
+}
+
+
+void VideoEncoder::Private::openFile(const std::string& fn)
+{
+    initFfmpeg();
+
+    if (p->isReady())
+        close();
+
+    if (width <= 0 || height <= 0)
+        MO_ERROR("Invalid video size " << width << "x" << height
+                 << " for '" << fn << "'");
+
+    videoFramesEncoded = 0;
+    audioSamplesEncoded = 0;
+    audioQue.clear();
+
+    try
+    {
+        avformat_alloc_output_context2(&formatCtx, NULL, NULL, fn.c_str());
+        if (!formatCtx)
+            MO_ERROR("Could not determine container format for '" << fn << "'");
+
+        openVideo();
+        if (isAudioEnabled_)
+            openAudio();
+
+        if (!(formatCtx->oformat->flags & AVFMT_NOFILE))
+            CHECK_FFM_THROW( avio_open(&formatCtx->pb, fn.c_str(), AVIO_FLAG_WRITE) );
+
+        CHECK_FFM_THROW( avformat_write_header(formatCtx, NULL) );
+
+        url = fn;
+
+        MO_DEBUG( p->toString() );
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+void VideoEncoder::Private::openVideo()
+{
+    AVCodec * codec = videoCodecName.empty()
+            ? avcodec_find_encoder(formatCtx->oformat->video_codec)
+            : avcodec_find_encoder_by_name(videoCodecName.c_str());
+    if (!codec)
+        MO_ERROR("Unsupported video codec '" << videoCodecName << "'");
+
+    videoStream = avformat_new_stream(formatCtx, codec);
+    if (!videoStream)
+        MO_ERROR("Can not allocate video stream");
+
+    videoCodecCtx = avcodec_alloc_context3(codec);
+    if (!videoCodecCtx)
+        MO_ERROR("Can not allocate video codec context");
+
+    videoCodecCtx->width = width;
+    videoCodecCtx->height = height;
+    videoCodecCtx->time_base.num = 1;
+    videoCodecCtx->time_base.den = fps;
+    videoCodecCtx->gop_size = fps;
+    videoCodecCtx->thread_count = threadCount;
+    if (videoBitRate > 0)
+        videoCodecCtx->bit_rate = videoBitRate;
+
+    // prefer yuv420p for compatibility with players
+    videoCodecCtx->pix_fmt = AV_PIX_FMT_YUV420P;
+    if (codec->pix_fmts)
+    {
+        const AVPixelFormat * f = codec->pix_fmts;
+        while (*f != AV_PIX_FMT_NONE && *f != AV_PIX_FMT_YUV420P)
+            ++f;
+        if (*f == AV_PIX_FMT_NONE)
+            videoCodecCtx->pix_fmt = codec->pix_fmts[0];
+    }
+
+    if (formatCtx->oformat->flags & AVFMT_GLOBALHEADER)
+        videoCodecCtx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    CHECK_FFM_THROW( avcodec_open2(videoCodecCtx, codec, NULL) );
+
+    copyParameters(videoCodecCtx, videoStream);
+    videoStream->time_base = videoCodecCtx->time_base;
+
+    // frame in codec format
+    videoFrame = av_frame_alloc();
+    if (!videoFrame)
+        MO_ERROR("Failed to alloc video frame");
+    videoFrame->format = videoCodecCtx->pix_fmt;
+    videoFrame->width = width;
+    videoFrame->height = height;
+    CHECK_FFM_THROW( av_frame_get_buffer(videoFrame, 32) );
+
+    // conversion from bgra
+    swsContext = sws_getContext(
+                width, height, AV_PIX_FMT_BGRA,
+                width, height, videoCodecCtx->pix_fmt,
+                SWS_POINT, NULL, NULL, NULL);
+    if (!swsContext)
+        MO_ERROR("Can not create pixel format conversion to "
+                 << av_get_pix_fmt_name(videoCodecCtx->pix_fmt));
+}
+
+void VideoEncoder::Private::openAudio()
+{
+    AVCodec * codec = audioCodecName.empty()
+            ? avcodec_find_encoder(formatCtx->oformat->audio_codec)
+            : avcodec_find_encoder_by_name(audioCodecName.c_str());
+    if (!codec)
+        MO_ERROR("Unsupported audio codec '" << audioCodecName << "'");
+
+    audioStream = avformat_new_stream(formatCtx, codec);
+    if (!audioStream)
+        MO_ERROR("Can not allocate audio stream");
+
+    audioCodecCtx = avcodec_alloc_context3(codec);
+    if (!audioCodecCtx)
+        MO_ERROR("Can not allocate audio codec context");
+
+    // select a sample format that we can convert to
+    audioCodecCtx->sample_fmt = AV_SAMPLE_FMT_NONE;
+    if (!codec->sample_fmts)
+        audioCodecCtx->sample_fmt = AV_SAMPLE_FMT_FLT;
+    else
+    {
+        const AVSampleFormat prefered[] = {
+            AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_FLT,
+            AV_SAMPLE_FMT_S32P, AV_SAMPLE_FMT_S32,
+            AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S16 };
+        for (auto fmt : prefered)
+        {
+            for (auto f = codec->sample_fmts; *f != AV_SAMPLE_FMT_NONE; ++f)
+                if (*f == fmt)
+                    { audioCodecCtx->sample_fmt = fmt; break; }
+            if (audioCodecCtx->sample_fmt != AV_SAMPLE_FMT_NONE)
+                break;
+        }
+    }
+    if (audioCodecCtx->sample_fmt == AV_SAMPLE_FMT_NONE)
+        MO_ERROR("Audio codec '" << codec->name << "' has no supported sample format");
+
+    audioCodecCtx->sample_rate = sampleRate;
+    audioCodecCtx->channels = numChannels;
+    audioCodecCtx->channel_layout = av_get_default_channel_layout(numChannels);
+    audioCodecCtx->time_base.num = 1;
+    audioCodecCtx->time_base.den = sampleRate;
+    if (audioBitRate > 0)
+        audioCodecCtx->bit_rate = audioBitRate;
+
+    if (formatCtx->oformat->flags & AVFMT_GLOBALHEADER)
+        audioCodecCtx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    CHECK_FFM_THROW( avcodec_open2(audioCodecCtx, codec, NULL) );
+
+    copyParameters(audioCodecCtx, audioStream);
+    audioStream->time_base = audioCodecCtx->time_base;
+
+    audioFrameSize = audioCodecCtx->frame_size;
+    if (audioFrameSize <= 0
+        || (codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
+        audioFrameSize = 1024;
+
+    audioFrame = av_frame_alloc();
+    if (!audioFrame)
+        MO_ERROR("Failed to alloc audio frame");
+    audioFrame->format = audioCodecCtx->sample_fmt;
+    audioFrame->channel_layout = audioCodecCtx->channel_layout;
+    audioFrame->channels = numChannels;
+    audioFrame->sample_rate = sampleRate;
+    audioFrame->nb_samples = audioFrameSize;
+    CHECK_FFM_THROW( av_frame_get_buffer(audioFrame, 0) );
+}
+
+void VideoEncoder::Private::copyParameters(AVCodecContext * ctx, AVStream * stream)
+{
+#ifndef MO_FFM_NEW_VERSION
+    CHECK_FFM_THROW( avcodec_copy_context(stream->codec, ctx) );
+#else
+    CHECK_FFM_THROW( avcodec_parameters_from_context(stream->codecpar, ctx) );
+#endif
+}
+
+void VideoEncoder::Private::close()
+{
+    if (!formatCtx)
+        return;
+
+    try
+    {
+        // remaining audio, padded with silence if needed
+        if (audioCodecCtx && !audioQue.empty())
+        {
+            const size_t num = audioQue.size() / numChannels;
+            if (!(audioCodecCtx->codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
+                audioQue.resize(audioFrameSize * numChannels, 0.f);
+            encodeAudioFrame(std::min(num, size_t(audioFrameSize)));
+        }
+
+        if (videoCodecCtx)
+            encode(videoCodecCtx, videoStream, 0);
+        if (audioCodecCtx)
+            encode(audioCodecCtx, audioStream, 0);
+
+        CHECK_FFM_THROW( av_write_trailer(formatCtx) );
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+
+    release();
+}
+
+void VideoEncoder::Private::release()
+{
+    if (swsContext)
+        sws_freeContext(swsContext);
+    swsContext = 0;
+
+    if (videoFrame)
+        av_frame_free(&videoFrame); // sets NULL
+    if (audioFrame)
+        av_frame_free(&audioFrame); // sets NULL
+
+    if (videoCodecCtx)
+    {
+        avcodec_close(videoCodecCtx);
+        avcodec_free_context(&videoCodecCtx); // sets NULL
+    }
+    if (audioCodecCtx)
+    {
+        avcodec_close(audioCodecCtx);
+        avcodec_free_context(&audioCodecCtx); // sets NULL
+    }
+
+    if (formatCtx)
+    {
+        if (!(formatCtx->oformat->flags & AVFMT_NOFILE))
+            avio_closep(&formatCtx->pb);
+        avformat_free_context(formatCtx);
+    }
+    formatCtx = 0;
+    videoStream = 0;
+    audioStream = 0;
+    audioQue.clear();
+}
+
+void VideoEncoder::Private::encode(
+        AVCodecContext * ctx, AVStream * stream, AVFrame * frame)
+{
+    AVPacket packet;
+
+#ifdef MO_FFM_NEW_VERSION
+    CHECK_FFM_THROW( avcodec_send_frame(ctx, frame) );
+    while (true)
+    {
+        av_init_packet(&packet);
+        packet.data = 0;
+        packet.size = 0;
+        const int r = avcodec_receive_packet(ctx, &packet);
+        if (r == AVERROR(EAGAIN) || r == AVERROR_EOF)
+            break;
+        CHECK_FFM_THROW( r );
+#else
+    // when flushing, repeat until the encoder is empty
+    int gotPacket;
+    do
+    {
+        av_init_packet(&packet);
+        packet.data = 0;
+        packet.size = 0;
+        if (ctx->codec_type == AVMEDIA_TYPE_VIDEO)
+            CHECK_FFM_THROW( avcodec_encode_video2(ctx, &packet, frame, &gotPacket) )
+        else
+            CHECK_FFM_THROW( avcodec_encode_audio2(ctx, &packet, frame, &gotPacket) )
+        if (!gotPacket)
+            break;
+#endif
+        av_packet_rescale_ts(&packet, ctx->time_base, stream->time_base);
+        packet.stream_index = stream->index;
+        // takes ownership of packet data
+        CHECK_FFM_THROW( av_interleaved_write_frame(formatCtx, &packet) );
+    }
+#ifndef MO_FFM_NEW_VERSION
+    while (!frame);
+#endif
+}
+
+void VideoEncoder::addVideoFrame(const uint8_t * bgra, bool bottomUp)
+{
+    if (!p_->videoCodecCtx)
+        MO_ERROR("VideoEncoder::addVideoFrame() on closed encoder");
+
+    CHECK_FFM_THROW( av_frame_make_writable(p_->videoFrame) );
+
+    // flip with negative stride
+    const int stride = p_->width * 4;
+    const uint8_t * src[1] = { bottomUp ? bgra + (p_->height - 1) * stride : bgra };
+    const int srcStride[1] = { bottomUp ? -stride : stride };
+
+    sws_scale(p_->swsContext, src, srcStride, 0, p_->height,
+              p_->videoFrame->data, p_->videoFrame->linesize);
+
+    p_->videoFrame->pts = p_->videoFramesEncoded++;
+    p_->encode(p_->videoCodecCtx, p_->videoStream, p_->videoFrame);
+}
+
+void VideoEncoder::addAudio(const float * samples, size_t numFrames)
+{
+    if (!p_->audioCodecCtx)
+        return;
+
+    p_->audioQue.insert(p_->audioQue.end(),
+                        samples, samples + numFrames * p_->numChannels);
+
+    // encode all complete frames
+    const size_t frameLen = size_t(p_->audioFrameSize) * p_->numChannels;
+    size_t pos = 0;
+    while (p_->audioQue.size() - pos >= frameLen)
+    {
+        if (pos)
+            std::copy(p_->audioQue.begin() + pos,
+                      p_->audioQue.begin() + pos + frameLen,
+                      p_->audioQue.begin());
+        p_->encodeAudioFrame(p_->audioFrameSize);
+        pos += frameLen;
+    }
+    p_->audioQue.erase(p_->audioQue.begin(), p_->audioQue.begin() + pos);
+}
+
+void VideoEncoder::Private::encodeAudioFrame(size_t num)
+{
+    CHECK_FFM_THROW( av_frame_make_writable(audioFrame) );
+    audioFrame->nb_samples = num;
+
+    // convert from interleaved float
+    const float * src = &audioQue[0];
+    const int numChan = numChannels;
+    switch (audioCodecCtx->sample_fmt)
+    {
+        case AV_SAMPLE_FMT_FLT:
+            memcpy(audioFrame->data[0], src, num * numChan * sizeof(float));
+        break;
+
+        case AV_SAMPLE_FMT_FLTP:
+            for (int c = 0; c < numChan; ++c)
+            {
+                auto dst = reinterpret_cast<float*>(audioFrame->extended_data[c]);
+                for (size_t i = 0; i < num; ++i)
+                    dst[i] = src[i * numChan + c];
+            }
+        break;
+
+        case AV_SAMPLE_FMT_S32:
+        case AV_SAMPLE_FMT_S32P:
+        {
+            const bool planar = audioCodecCtx->sample_fmt == AV_SAMPLE_FMT_S32P;
+            for (int c = 0; c < numChan; ++c)
+            {
+                auto dst = reinterpret_cast<int32_t*>(
+                            audioFrame->extended_data[planar ? c : 0]);
+                for (size_t i = 0; i < num; ++i)
+                    dst[planar ? i : i * numChan + c] = int32_t(
+                        double(std::max(-1.f, std::min(1.f, src[i * numChan + c])))
+                            * 2147483647.);
+            }
+        }
+        break;
+
+        case AV_SAMPLE_FMT_S16:
+        case AV_SAMPLE_FMT_S16P:
+        {
+            const bool planar = audioCodecCtx->sample_fmt == AV_SAMPLE_FMT_S16P;
+            for (int c = 0; c < numChan; ++c)
+            {
+                auto dst = reinterpret_cast<int16_t*>(
+                            audioFrame->extended_data[planar ? c : 0]);
+                for (size_t i = 0; i < num; ++i)
+                    dst[planar ? i : i * numChan + c] = int16_t(
+                        std::max(-1.f, std::min(1.f, src[i * numChan + c])) * 32767.f);
+            }
+        }
+        break;
+
+        default:
+            MO_ERROR("Unhandled audio sample format "
+                     << av_get_sample_fmt_name(audioCodecCtx->sample_fmt));
+    }
+
+    audioFrame->pts = audioSamplesEncoded;
+    audioSamplesEncoded += num;
+    encode(audioCodecCtx, audioStream, audioFrame);
+}
+
+} // namespace FFM
+
+#endif // #ifdef MO_ENABLE_FFMPEG
@@ -0,0 +1,108 @@
+#ifdef MO_ENABLE_FFMPEG
+
+
+#ifndef MCWSRC_VIDEOENCODER_H
+#define MCWSRC_VIDEOENCODER_H
+
+#include <string>
+#include <cinttypes>
+#include <cstddef>
+
+namespace FFM {
+
+/** Encodes video frames and audio into a single container file.
+
+    The container format is derived from the filename extension.
+    Video frames are expected in BGRA byte order and are
+    converted to the codec's pixel format.
+    Audio is expected as interleaved float samples and is
+    converted to the codec's sample format.
+
+    Not thread-safe, all calls must come from the same thread.
+    */
+class VideoEncoder
+{
+public:
+    VideoEncoder();
+    ~VideoEncoder();
+
+    // ---------- getter ------------
+
+    /** Is the file opened for encoding */
+    bool isReady() const;
+
+    /** Returns the currently open filename */
+    const std::string& currentFilename() const;
+
+    int width() const;
+    int height() const;
+    int framesPerSecond() const;
+
+    /** Returns the number of encoded frames since openFile() */
+    int64_t numEncodedFrames() const;
+
+    /** Informational string */
+    std::string toString() const;
+
+    // ------ setter --------
+    // @note All settings must be applied before openFile()
+
+    /** Sets the size and frame-rate of the video */
+    void setVideoFormat(int width, int height, int fps);
+
+    /** Sets the video codec by ffmpeg name, e.g. "libx264" or "mpeg4".
+        An empty string selects the default codec of the container. */
+    void setVideoCodec(const std::string& name);
+
+    /** Bits per second of the video stream, 0 for codec default */
+    void setVideoBitRate(int64_t bitsPerSecond);
+
+    /** Sets the number of threads to use for encoding.
+        0 for auto/max, which is the default. */
+    void setThreadCount(int num);
+
+    /** Enables an audio stream. Default is disabled. */
+    void setAudioFormat(int sampleRate, int numChannels);
+    void setAudioEnabled(bool e);
+
+    /** Sets the audio codec by ffmpeg name, e.g. "aac".
+        An empty string selects the default codec of the container. */
+    void setAudioCodec(const std::string& name);
+
+    /** Bits per second of the audio stream, 0 for codec default */
+    void setAudioBitRate(int64_t bitsPerSecond);
+
+    // --------- io ---------
+
+    /** Creates the file and writes the header.
+        @throws Exception on any error */
+    void openFile(const std::string& url);
+
+    /** Flushes the encoders, writes the trailer and closes the file.
+        @throws Exception on any error */
+    void close();
+
+    // ------- encoding --------
+
+    /** Encodes the next video frame.
+        @p bgra points to width() * height() pixels with 4 bytes each.
+        If @p bottomUp is true, the first row is the bottom of the image,
+        as read from OpenGL.
+        @throws Exception on any error */
+    void addVideoFrame(const uint8_t * bgra, bool bottomUp = false);
+
+    /** Adds @p numFrames frames of interleaved float samples
+        to the audio stream.
+        @throws Exception on any error */
+    void addAudio(const float * samples, size_t numFrames);
+
+private:
+    struct Private;
+    Private * p_;
+};
+
+} // namespace FFM
+
+#endif // MCWSRC_VIDEOENCODER_H
+
+#endif // #ifdef MO_ENABLE_FFMPEG